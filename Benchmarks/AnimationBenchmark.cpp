@@ -0,0 +1,153 @@
+#include <cmath>
+#include <vector>
+
+#include "BenchGLContext.h"
+#include "Benchmark.h"
+#include "Runtime/Animation/AnimationSystem.h"
+#include "Runtime/Core/Async/JobSystem.h"
+#include "Runtime/Rendering/DepthConvention.h"
+#include "Runtime/Rendering/UploadRing.h"
+
+namespace Volante::Bench {
+
+namespace {
+
+constexpr uint32_t JointCount = 64;
+
+JobSystem& GetJobs() {
+    static JobSystem Jobs;
+    return Jobs;
+}
+
+// Two seconds of every joint of a chain swaying about Z, each a little out of phase, so no
+// curve is constant and key reduction has real work to keep.
+RawAnimationClip CreateSwayClip() {
+    RawAnimationClip Raw;
+    Raw.SampleRate = 30.0f;
+    Raw.JointCount = JointCount;
+    Raw.FrameCount = 61;
+    Raw.Frames.resize(static_cast<size_t>(Raw.FrameCount) * JointCount);
+    const float BoneLength = 2.0f / JointCount;
+    for (uint32_t Frame = 0; Frame < Raw.FrameCount; ++Frame) {
+        const float Time = static_cast<float>(Frame) / Raw.SampleRate;
+        for (uint32_t Joint = 0; Joint < JointCount; ++Joint) {
+            JointTransform& Transform = Raw.Frames[Frame * JointCount + Joint];
+            const float Angle = 0.1f * std::sin(Time * PI + static_cast<float>(Joint) * 0.2f);
+            Transform.Rotation = glm::angleAxis(Angle, Vec3(0.0f, 0.0f, 1.0f));
+            Transform.Translation = Vec3(0.0f, Joint == 0 ? 0.0f : BoneLength, 0.0f);
+        }
+    }
+    return Raw;
+}
+
+struct CharacterScene {
+    AnimationSystem System;
+    std::vector<SkinnedInstanceId> Characters;
+
+    CharacterScene(uint32_t Count, JobSystem* Jobs) : System({}, Jobs) {
+        System.Initialize();
+        const SkeletonId Chain = System.AddSkeleton(GenerateChainSkeleton(2.0f, JointCount));
+        const AnimationClipId Sway = System.AddClip(AnimationClip::Compress(CreateSwayClip()));
+        const SkinnedMeshId Body = System.AddMesh(GenerateSkinnedCylinder(0.2f, 2.0f, 12, JointCount, JointCount), Chain);
+        const auto Side = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<float>(Count))));
+        for (uint32_t i = 0; i < Count; ++i) {
+            const Vec3 Position(static_cast<float>(i % Side) - Side * 0.5f, 0.0f, -static_cast<float>(i / Side));
+            const SkinnedInstanceId Character = System.CreateInstance(Body, glm::translate(Mat4(1.0f), Position));
+            System.Play(Character, Sway);
+            // Desynchronized, so every character samples different keys
+            System.SetTime(Character, static_cast<float>(i) * 0.037f);
+            Characters.push_back(Character);
+        }
+    }
+
+    ~CharacterScene() { System.Shutdown(); }
+};
+
+void BenchSampleClip(BenchContext& Context) {
+    const AnimationClip Clip = AnimationClip::Compress(CreateSwayClip());
+    AnimationPose Pose(JointCount);
+    float Time = 0.0f;
+    Context.Measure(1, [&] {
+        Time += 1.0f / 60.0f;
+        Clip.Sample(Time, true, Pose);
+    });
+    Context.SetCounter("keys", static_cast<double>(Clip.GetKeyCount()));
+    if (Clip.GetKeyCount() == 0) { Context.Fail("clip compressed to nothing"); }
+    Context.SetCounter("bytes", static_cast<double>(Clip.GetMemorySize()));
+}
+
+// Sampling, a cross-fade and the skinning palette of a thousand characters on the job system,
+// without the draw.
+void BenchEvaluateCharacters(BenchContext& Context) {
+    if (!BenchGLContext::Get()) {
+        Context.Skip("no GL context");
+        return;
+    }
+    constexpr uint32_t Count = 1000;
+    CharacterScene Scene(Count, &GetJobs());
+    for (const SkinnedInstanceId Character : Scene.Characters) {
+        Scene.System.Play(Character, 0, 1.2f, true, 10.0f);
+    }
+    std::vector<std::vector<AffineTransform>> Palettes(Count);
+    Context.Measure(Count, [&] {
+        Scene.System.Update(1.0f / 60.0f);
+        GetJobs().ParallelFor(Count, 16, [&](uint32_t Begin, uint32_t End) {
+            for (uint32_t i = Begin; i < End; ++i) { Scene.System.EvaluatePalette(Scene.Characters[i], Palettes[i]); }
+        });
+    });
+    Context.SetCounter("joints", static_cast<double>(Count) * JointCount);
+    for (const std::vector<AffineTransform>& Palette : Palettes) {
+        if (Palette.size() != JointCount) {
+            Context.Fail("palette not evaluated");
+            break;
+        }
+    }
+}
+
+// Cull, evaluate, upload and draw a thousand skinned characters, waited on.
+void BenchRenderCharacters(BenchContext& Context) {
+    const BenchGLContext* GL = BenchGLContext::Get();
+    if (!GL) {
+        Context.Skip("no GL context");
+        return;
+    }
+    constexpr uint32_t Count = 1000;
+    CharacterScene Scene(Count, &GetJobs());
+    UploadRing Uploads;
+    if (!Uploads.Initialize()) {
+        Context.Fail("upload ring unavailable");
+        return;
+    }
+
+    const Mat4 View = glm::lookAt(Vec3(0.0f, 12.0f, 20.0f), Vec3(0.0f, 0.0f, -15.0f), Vec3(0.0f, 1.0f, 0.0f));
+    const Mat4 Projection = MakeReverseZPerspective(glm::radians(60.0f), static_cast<float>(BenchGLContext::Width) / BenchGLContext::Height,
+                                                    0.1f, 200.0f);
+    const RenderView CameraView = RenderView::Create(View, Projection);
+    Context.Measure(Count, [&] {
+        GL->BeginFrame();
+        Uploads.BeginFrame();
+        Scene.System.Update(1.0f / 60.0f);
+        Scene.System.Evaluate({&CameraView, 1}, Uploads);
+        Scene.System.Render(CameraView, Uploads, Vec3(0.4f, 1.0f, 0.3f));
+        Uploads.EndFrame();
+        BenchGLContext::Finish();
+    });
+
+    const AnimationStats& Stats = Scene.System.GetStats();
+    Context.SetCounter("visible", Stats.VisibleCount);
+    Context.SetCounter("draws", Stats.DrawCount);
+    Context.SetCounter("palette_kb", static_cast<double>(Stats.PaletteBytes) / 1024.0);
+    if (Stats.VisibleCount == 0 || Stats.DrawCount == 0) { Context.Fail("no characters drawn"); }
+    Uploads.Shutdown();
+}
+
+const bool Registered = [] {
+    BenchRegistration("Animation/SampleClip64Joints", BenchSampleClip);
+    BenchRegistration("Animation/Evaluate1kCharacters", BenchEvaluateCharacters);
+    BenchRegistration("Animation/Render1kCharacters", BenchRenderCharacters);
+    return true;
+}();
+
+} // namespace
+
+} // namespace Volante::Bench
@@ -0,0 +1,95 @@
+#include "BenchGLContext.h"
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <iostream>
+#include <memory>
+
+#include "Runtime/Rendering/DepthConvention.h"
+
+namespace Volante::Bench {
+
+BenchGLContext* BenchGLContext::Get() {
+    static const std::unique_ptr<BenchGLContext> Instance = [] {
+        std::unique_ptr<BenchGLContext> Context(new BenchGLContext());
+        if (!Context->Create()) { Context.reset(); }
+        return Context;
+    }();
+    return Instance.get();
+}
+
+BenchGLContext::~BenchGLContext() {
+    if (Loaded) {
+        glDeleteFramebuffers(1, &Framebuffer);
+        glDeleteRenderbuffers(1, &ColorTarget);
+        glDeleteRenderbuffers(1, &DepthTarget);
+    }
+    if (Window) { glfwDestroyWindow(Window); }
+    glfwTerminate();
+}
+
+bool BenchGLContext::Create() {
+    if (!glfwInit()) {
+        std::cerr << "ERROR::BENCH::GLFW_INIT_FAILED" << std::endl;
+        return false;
+    }
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+#ifdef __APPLE__
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+#endif
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+    Window = glfwCreateWindow(static_cast<int>(Width), static_cast<int>(Height), "VolanteBench", nullptr, nullptr);
+    if (!Window) {
+        std::cerr << "ERROR::BENCH::WINDOW_CREATION_FAILED" << std::endl;
+        return false;
+    }
+    glfwMakeContextCurrent(Window);
+    // Measure the work, not the display's refresh rate
+    glfwSwapInterval(0);
+    if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress))) {
+        std::cerr << "ERROR::BENCH::GLAD_INITIALIZATION_FAILED" << std::endl;
+        return false;
+    }
+    Loaded = true;
+
+    // A hidden window's default framebuffer may not be backed; render offscreen instead
+    glGenRenderbuffers(1, &ColorTarget);
+    glBindRenderbuffer(GL_RENDERBUFFER, ColorTarget);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, static_cast<GLsizei>(Width), static_cast<GLsizei>(Height));
+    glGenRenderbuffers(1, &DepthTarget);
+    glBindRenderbuffer(GL_RENDERBUFFER, DepthTarget);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT32F, static_cast<GLsizei>(Width), static_cast<GLsizei>(Height));
+    glGenFramebuffers(1, &Framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, Framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, ColorTarget);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, DepthTarget);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "ERROR::BENCH::FRAMEBUFFER_INCOMPLETE" << std::endl;
+        return false;
+    }
+
+    std::cout << "GL: " << glGetString(GL_RENDERER) << " (" << glGetString(GL_VERSION) << ")" << std::endl;
+    return true;
+}
+
+void BenchGLContext::BeginFrame() const {
+    glBindFramebuffer(GL_FRAMEBUFFER, Framebuffer);
+    glViewport(0, 0, static_cast<GLsizei>(Width), static_cast<GLsizei>(Height));
+    glEnable(GL_DEPTH_TEST);
+    glEnable(GL_CULL_FACE);
+    glCullFace(GL_BACK);
+    glFrontFace(GL_CCW);
+    ApplyReverseZ();
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+}
+
+void BenchGLContext::Finish() {
+    glFinish();
+}
+
+} // namespace Volante::Bench
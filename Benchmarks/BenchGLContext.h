@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+
+struct GLFWwindow;
+
+namespace Volante::Bench {
+
+// Hidden GLFW window with a 3.3 core context and an offscreen framebuffer, shared by every
+// benchmark that needs GL. Created on first use; Get returns null where no display or driver
+// is available, and those benchmarks skip.
+class BenchGLContext {
+public:
+    static constexpr uint32_t Width = 1280;
+    static constexpr uint32_t Height = 720;
+
+    static BenchGLContext* Get();
+
+    ~BenchGLContext();
+
+    BenchGLContext(const BenchGLContext&) = delete;
+    BenchGLContext& operator=(const BenchGLContext&) = delete;
+
+    // Binds the offscreen framebuffer and viewport, and restores the default depth/cull state.
+    void BeginFrame() const;
+
+    // Waits for the GPU, so the measured time includes the work just submitted.
+    static void Finish();
+
+private:
+    BenchGLContext() = default;
+
+    bool Create();
+
+    GLFWwindow* Window = nullptr;
+    bool Loaded = false;
+    unsigned int Framebuffer = 0;
+    unsigned int ColorTarget = 0;
+    unsigned int DepthTarget = 0;
+};
+
+} // namespace Volante::Bench
@@ -0,0 +1,106 @@
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string_view>
+
+namespace Volante::Bench {
+
+namespace {
+
+struct RegisteredBench {
+    std::string Name;
+    BenchFunction Function;
+};
+
+std::vector<RegisteredBench>& GetRegistry() {
+    static std::vector<RegisteredBench> Registry;
+    return Registry;
+}
+
+void WriteJson(const std::string& Path, const std::vector<BenchResult>& Results) {
+    std::ofstream Out(Path);
+    if (!Out) {
+        std::cerr << "Failed to open " << Path << std::endl;
+        return;
+    }
+
+    Out << "{\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < Results.size(); ++i) {
+        const BenchResult& Result = Results[i];
+        Out << "    {\"name\": \"" << Result.Name << "\", \"iterations\": " << Result.Iterations
+            << ", \"ns_per_iteration\": " << Result.NanosecondsPerIteration
+            << ", \"items_per_second\": " << Result.ItemsPerSecond;
+        for (const auto& [Name, Value] : Result.Counters) {
+            Out << ", \"" << Name << "\": " << Value;
+        }
+        Out << "}" << (i + 1 < Results.size() ? "," : "") << "\n";
+    }
+    Out << "  ]\n}\n";
+}
+
+} // namespace
+
+BenchRegistration::BenchRegistration(const char* Name, BenchFunction Function) {
+    GetRegistry().push_back({Name, std::move(Function)});
+}
+
+} // namespace Volante::Bench
+
+// Usage: VolanteBench [--filter=<substring>] [--min-time=<seconds>] [--json=<path>]
+int main(int argc, char** argv) {
+    using namespace Volante::Bench;
+
+    std::string Filter;
+    std::string JsonPath;
+    double MinTime = 0.5;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view Arg = argv[i];
+        if (Arg.starts_with("--filter=")) {
+            Filter = Arg.substr(9);
+        } else if (Arg.starts_with("--min-time=")) {
+            MinTime = std::atof(argv[i] + 11);
+        } else if (Arg.starts_with("--json=")) {
+            JsonPath = Arg.substr(7);
+        } else {
+            std::cerr << "Unknown argument: " << Arg << std::endl;
+            return -1;
+        }
+    }
+
+    std::vector<BenchResult> Results;
+    int FailedCount = 0;
+    for (const auto& Bench : GetRegistry()) {
+        if (!Filter.empty() && Bench.Name.find(Filter) == std::string::npos) { continue; }
+
+        BenchContext Context(Bench.Name, MinTime);
+        Bench.Function(Context);
+        const BenchResult& Result = Context.GetResult();
+        if (!Result.SkipReason.empty()) {
+            std::printf("%-48s skipped: %s\n", Result.Name.c_str(), Result.SkipReason.c_str());
+            continue;
+        }
+        if (!Result.FailReason.empty()) {
+            std::printf("%-48s FAILED: %s\n", Result.Name.c_str(), Result.FailReason.c_str());
+            std::fflush(stdout);
+            ++FailedCount;
+            continue;
+        }
+
+        std::printf("%-48s %12.0f ns/iter %14.0f items/s", Result.Name.c_str(),
+                    Result.NanosecondsPerIteration, Result.ItemsPerSecond);
+        for (const auto& [Name, Value] : Result.Counters) {
+            std::printf("  %s=%g", Name.c_str(), Value);
+        }
+        std::printf("\n");
+        std::fflush(stdout);
+
+        Results.push_back(Result);
+    }
+
+    if (!JsonPath.empty()) { WriteJson(JsonPath, Results); }
+    return FailedCount > 0 ? 1 : 0;
+}
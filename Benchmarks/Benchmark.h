@@ -0,0 +1,95 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Volante::Bench {
+
+struct BenchResult {
+    std::string Name;
+    uint64_t Iterations = 0;
+    // Set when the benchmark could not run here (e.g. no GL context); not written to JSON
+    std::string SkipReason;
+    // Set when the work measured did not produce the right result; such a time means nothing,
+    // so it is not written to JSON either, and the run exits with an error
+    std::string FailReason;
+    double NanosecondsPerIteration = 0.0;
+    double ItemsPerSecond = 0.0;
+    std::vector<std::pair<std::string, double>> Counters;
+};
+
+// Handed to every benchmark. Setup runs outside Measure; only the body passed to Measure is
+// timed, repeatedly, until MinTime has elapsed.
+class BenchContext {
+public:
+    explicit BenchContext(std::string Name, double MinTime) : MinTime(MinTime) { Result.Name = std::move(Name); }
+
+    template <typename Fn>
+    void Measure(uint64_t ItemsPerIteration, Fn&& Body) {
+        using Clock = std::chrono::steady_clock;
+
+        Body();
+        if (HasFailed()) { return; }
+
+        uint64_t Iterations = 0;
+        const auto Start = Clock::now();
+        double Elapsed = 0.0;
+        do {
+            Body();
+            ++Iterations;
+            Elapsed = std::chrono::duration<double>(Clock::now() - Start).count();
+        } while (Elapsed < MinTime && !HasFailed());
+
+        Result.Iterations = Iterations;
+        Result.NanosecondsPerIteration = Elapsed * 1e9 / static_cast<double>(Iterations);
+        Result.ItemsPerSecond = static_cast<double>(ItemsPerIteration * Iterations) / Elapsed;
+    }
+
+    void SetCounter(const std::string& Name, double Value) { Result.Counters.emplace_back(Name, Value); }
+
+    void Skip(std::string Reason) { Result.SkipReason = std::move(Reason); }
+
+    // From setup, the measured body or the checks after it. Keeps the first reason; Measure
+    // stops repeating the body once it is set.
+    void Fail(std::string Reason) {
+        if (Result.FailReason.empty()) { Result.FailReason = std::move(Reason); }
+    }
+
+    [[nodiscard]] bool HasFailed() const { return !Result.FailReason.empty(); }
+
+    [[nodiscard]] const BenchResult& GetResult() const { return Result; }
+
+private:
+    double MinTime;
+    BenchResult Result;
+};
+
+using BenchFunction = std::function<void(BenchContext&)>;
+
+struct BenchRegistration {
+    BenchRegistration(const char* Name, BenchFunction Function);
+};
+
+// Keeps the optimizer from discarding results that are only computed to be timed.
+template <typename T>
+inline void DoNotOptimize(const T& Value) {
+#if defined(_MSC_VER)
+    const volatile auto* Sink = &Value;
+    (void)Sink;
+#else
+    asm volatile("" : : "r,m"(Value) : "memory");
+#endif
+}
+
+} // namespace Volante::Bench
+
+#define VOLANTE_BENCH_CONCAT_INNER(A, B) A##B
+#define VOLANTE_BENCH_CONCAT(A, B) VOLANTE_BENCH_CONCAT_INNER(A, B)
+
+#define VOLANTE_BENCHMARK(Name, Function)                                                          \
+    static ::Volante::Bench::BenchRegistration VOLANTE_BENCH_CONCAT(BenchRegistration_, __LINE__)( \
+        Name, Function)
@@ -0,0 +1,119 @@
+#include <glad/glad.h>
+
+#include <cmath>
+#include <vector>
+
+#include "BenchGLContext.h"
+#include "Benchmark.h"
+#include "Runtime/Core/IO/PngWriter.h"
+#include "Runtime/Rendering/GPUReadback.h"
+
+namespace Volante::Bench {
+
+namespace {
+
+constexpr size_t FrameBytes = static_cast<size_t>(BenchGLContext::Width) * BenchGLContext::Height * 4;
+
+// A frame's worth of GPU work to read back behind: a few full-target clears
+void DrawFrame(uint32_t Frame) {
+    for (int Pass = 0; Pass < 4; ++Pass) {
+        glClearColor(static_cast<float>(Frame % 256) / 255.0f, 0.25f * static_cast<float>(Pass), 0.5f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    }
+}
+
+// Every frame read straight into client memory: the CPU waits for the frame to finish and
+// for the copy.
+void BenchReadPixels(BenchContext& Context) {
+    const BenchGLContext* GL = BenchGLContext::Get();
+    if (!GL) {
+        Context.Skip("no GL context");
+        return;
+    }
+    std::vector<uint8_t> Pixels(FrameBytes);
+    uint32_t Frame = 0;
+    Context.Measure(1, [&] {
+        GL->BeginFrame();
+        DrawFrame(Frame++);
+        glReadPixels(0, 0, BenchGLContext::Width, BenchGLContext::Height, GL_RGBA, GL_UNSIGNED_BYTE, Pixels.data());
+        DoNotOptimize(Pixels[0]);
+    });
+    Context.SetCounter("mb_per_frame", static_cast<double>(FrameBytes) / (1024.0 * 1024.0));
+    // The last clear's blue is 0.5
+    if (Pixels[2] < 127 || Pixels[2] > 128 || Pixels[3] != 255) { Context.Fail("wrong pixels read"); }
+}
+
+// Every frame through the PBO ring, as a capture reads them: the read is queued and earlier
+// ones are collected once finished. Not waited on, so stalls count the times the ring was full.
+void BenchReadbackRing(BenchContext& Context) {
+    const BenchGLContext* GL = BenchGLContext::Get();
+    if (!GL) {
+        Context.Skip("no GL context");
+        return;
+    }
+    GPUReadback Readback;
+    if (!Readback.Initialize()) {
+        Context.Skip("readback buffers unavailable");
+        return;
+    }
+    uint32_t Frame = 0;
+    uint64_t Latency = 0;
+    uint64_t Delivered = 0;
+    Context.Measure(1, [&] {
+        GL->BeginFrame();
+        DrawFrame(Frame);
+        const uint32_t Issued = Frame++;
+        Readback.Read(0, 0, BenchGLContext::Width, BenchGLContext::Height, GL_RGBA, GL_UNSIGNED_BYTE,
+                      [&, Issued](std::vector<uint8_t>& Pixels) {
+                          if (Pixels.size() != FrameBytes) {
+                              Context.Fail("read failed");
+                              return;
+                          }
+                          DoNotOptimize(Pixels[0]);
+                          Latency += Frame - Issued;
+                          ++Delivered;
+                      });
+        Readback.Poll();
+    });
+    Readback.Flush();
+    if (Delivered != Frame) { Context.Fail("reads lost"); }
+    Context.SetCounter("stalls", Readback.GetStats().Stalls);
+    Context.SetCounter("latency_frames", Delivered > 0 ? static_cast<double>(Latency) / static_cast<double>(Delivered) : 0.0);
+    Readback.Shutdown();
+}
+
+// PNG encoding of one 720p frame, as the capture worker does it, on a lit-looking image:
+// smooth gradients with some noise.
+void BenchEncodePng(BenchContext& Context) {
+    std::vector<uint8_t> Pixels(FrameBytes);
+    uint32_t Seed = 1;
+    for (uint32_t y = 0; y < BenchGLContext::Height; ++y) {
+        for (uint32_t x = 0; x < BenchGLContext::Width; ++x) {
+            Seed = Seed * 1664525u + 1013904223u;
+            uint8_t* Pixel = &Pixels[(static_cast<size_t>(y) * BenchGLContext::Width + x) * 4];
+            const float Shade = 0.5f + 0.5f * std::sin(static_cast<float>(x) * 0.01f) * std::cos(static_cast<float>(y) * 0.013f);
+            Pixel[0] = static_cast<uint8_t>(Shade * 200.0f + static_cast<float>((Seed >> 28) & 3));
+            Pixel[1] = static_cast<uint8_t>(Shade * 160.0f);
+            Pixel[2] = static_cast<uint8_t>(static_cast<float>(y) * 255.0f / BenchGLContext::Height);
+            Pixel[3] = 255;
+        }
+    }
+    std::vector<uint8_t> Encoded;
+    Context.Measure(1, [&] {
+        EncodePng(Encoded, Pixels.data(), BenchGLContext::Width, BenchGLContext::Height, 4, true);
+        DoNotOptimize(Encoded.data());
+    });
+    Context.SetCounter("ratio", static_cast<double>(Encoded.size()) / static_cast<double>(FrameBytes));
+    if (Encoded.empty()) { Context.Fail("encoding failed"); }
+}
+
+const bool Registered = [] {
+    BenchRegistration("Capture/ReadPixels720p", BenchReadPixels);
+    BenchRegistration("Capture/ReadbackRing720p", BenchReadbackRing);
+    BenchRegistration("Capture/EncodePng720p", BenchEncodePng);
+    return true;
+}();
+
+} // namespace
+
+} // namespace Volante::Bench
@@ -0,0 +1,133 @@
+#include <random>
+#include <vector>
+
+#include "BenchGLContext.h"
+#include "Benchmark.h"
+#include "Runtime/Core/Async/JobSystem.h"
+#include "Runtime/Rendering/ClusteredLighting.h"
+#include "Runtime/Rendering/DepthConvention.h"
+#include "Runtime/Rendering/ProceduralMesh.h"
+#include "Runtime/Rendering/SceneRenderer.h"
+
+namespace Volante::Bench {
+
+namespace {
+
+JobSystem& GetJobs() {
+    static JobSystem Jobs;
+    return Jobs;
+}
+
+struct FrameSceneDesc {
+    // Cubes on a square grid, 3 m apart
+    uint32_t GridSize = 100;
+    uint32_t LightCount = 0;
+    bool AllowGPUCulling = true;
+    bool CastShadows = true;
+};
+
+// Stress scene rendered headless into the offscreen target, one full SceneRenderer frame
+// (culling, shadows, lighting, draws) per iteration, waited on so GPU time is included.
+void RegisterFrameBenchmark(const char* Name, const FrameSceneDesc& Scene) {
+    BenchRegistration(Name, [Scene](BenchContext& Context) {
+        const BenchGLContext* GL = BenchGLContext::Get();
+        if (!GL) {
+            Context.Skip("no GL context");
+            return;
+        }
+
+        SceneRendererDesc Desc;
+        Desc.AllowGPUCulling = Scene.AllowGPUCulling;
+        Desc.CastShadows = Scene.CastShadows;
+        SceneRenderer Renderer(Desc, &GetJobs());
+        Renderer.Initialize();
+
+        const RenderMeshId CubeMesh = Renderer.GetScene().AddMesh(GenerateCube(1.0f));
+        const float HalfSize = static_cast<float>(Scene.GridSize) * 1.5f;
+        for (uint32_t z = 0; z < Scene.GridSize; ++z) {
+            for (uint32_t x = 0; x < Scene.GridSize; ++x) {
+                const Vec3 Position(static_cast<float>(x) * 3.0f - HalfSize, 0.5f, static_cast<float>(z) * 3.0f - HalfSize);
+                Renderer.GetScene().AddInstance(CubeMesh, glm::translate(Mat4(1.0f), Position));
+            }
+        }
+
+        std::mt19937 Rng(99);
+        std::uniform_real_distribution<float> Horizontal(-HalfSize, HalfSize);
+        for (uint32_t i = 0; i < Scene.LightCount; ++i) {
+            PointLight Light;
+            Light.Position = Vec3(Horizontal(Rng), 2.0f, Horizontal(Rng));
+            Light.Radius = 8.0f;
+            Renderer.GetLighting().AddLight(Light);
+        }
+
+        const Mat4 View = glm::lookAt(Vec3(0.0f, 40.0f, HalfSize), Vec3(0.0f), Vec3(0.0f, 1.0f, 0.0f));
+        const Mat4 Projection = MakeReverseZPerspective(glm::radians(60.0f), static_cast<float>(BenchGLContext::Width) / BenchGLContext::Height,
+                                                        0.1f, 1000.0f);
+        Context.Measure(1, [&] {
+            GL->BeginFrame();
+            Renderer.SetView(View, Projection);
+            Renderer.Render();
+            BenchGLContext::Finish();
+        });
+
+        const SceneRenderStats& Stats = Renderer.GetStats();
+        Context.SetCounter("instances", Stats.InstanceCount);
+        Context.SetCounter("visible", Stats.VisibleCount);
+        Context.SetCounter("draws", Stats.DrawCount + Stats.ShadowDrawCount);
+        Context.SetCounter("gpu_driven", Stats.GPUDriven ? 1.0 : 0.0);
+        if (Stats.InstanceCount != Scene.GridSize * Scene.GridSize || Stats.VisibleCount == 0 || Stats.DrawCount == 0) {
+            Context.Fail("scene not drawn");
+        }
+        Renderer.Shutdown();
+    });
+}
+
+// Moving every instance once per frame, the per-entity write path gameplay drives. Component
+// iteration itself is World/Iterate1M.
+void BenchInstanceUpdate(BenchContext& Context) {
+    if (!BenchGLContext::Get()) {
+        Context.Skip("no GL context");
+        return;
+    }
+    constexpr uint32_t InstanceCount = 10'000;
+    GPUScene Scene;
+    const RenderMeshId CubeMesh = Scene.AddMesh(GenerateCube(1.0f));
+    std::vector<RenderInstanceId> Instances;
+    Instances.reserve(InstanceCount);
+    for (uint32_t i = 0; i < InstanceCount; ++i) {
+        Instances.push_back(Scene.AddInstance(CubeMesh, Mat4(1.0f)));
+    }
+    float Time = 0.0f;
+    Context.Measure(InstanceCount, [&] {
+        Time += 1.0f / 60.0f;
+        for (uint32_t i = 0; i < InstanceCount; ++i) {
+            Scene.SetTransform(Instances[i], glm::translate(Mat4(1.0f), Vec3(static_cast<float>(i % 100), Time, static_cast<float>(i / 100))));
+        }
+        Scene.Sync(false);
+    });
+    Scene.Release();
+}
+
+const bool Registered = [] {
+    RegisterFrameBenchmark("Frame/Cubes10k", FrameSceneDesc{});
+
+    FrameSceneDesc CPUCulled;
+    CPUCulled.AllowGPUCulling = false;
+    RegisterFrameBenchmark("Frame/Cubes10kCPUCulled", CPUCulled);
+
+    FrameSceneDesc Lit;
+    Lit.LightCount = 1000;
+    RegisterFrameBenchmark("Frame/Cubes10kLights1k", Lit);
+
+    FrameSceneDesc Dense;
+    Dense.GridSize = 316;
+    Dense.CastShadows = false;
+    RegisterFrameBenchmark("Frame/Cubes100kNoShadows", Dense);
+
+    BenchRegistration("Scene/InstanceUpdate10k", BenchInstanceUpdate);
+    return true;
+}();
+
+} // namespace
+
+} // namespace Volante::Bench
@@ -0,0 +1,63 @@
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+#include "Runtime/Core/Async/JobSystem.h"
+#include "Runtime/Rendering/DepthConvention.h"
+#include "Runtime/Rendering/LightClusters.h"
+
+namespace Volante::Bench {
+
+namespace {
+
+JobSystem& GetJobs() {
+    static JobSystem Jobs;
+    return Jobs;
+}
+
+// Lights scattered over a 400 m square at street level, seen from a 1080p camera standing in
+// it; roughly the light density of a night-time city block.
+std::vector<PointLight> MakeLights(uint32_t Count) {
+    std::mt19937 Rng(42);
+    std::uniform_real_distribution<float> Horizontal(-200.0f, 200.0f);
+    std::uniform_real_distribution<float> Height(0.5f, 20.0f);
+    std::uniform_real_distribution<float> Radius(4.0f, 15.0f);
+
+    std::vector<PointLight> Lights(Count);
+    for (PointLight& Light : Lights) {
+        Light.Position = Vec3(Horizontal(Rng), Height(Rng), Horizontal(Rng));
+        Light.Radius = Radius(Rng);
+    }
+    return Lights;
+}
+
+void RegisterAssignBenchmark(uint32_t LightCount) {
+    const std::string Name = "Lighting/ClusterAssign" + std::to_string(LightCount / 1000) + "k";
+    BenchRegistration(Name.c_str(), [LightCount](BenchContext& Context) {
+        const std::vector<PointLight> Lights = MakeLights(LightCount);
+        const Mat4 View = glm::lookAt(Vec3(0.0f, 10.0f, 150.0f), Vec3(0.0f, 0.0f, 0.0f), Vec3(0.0f, 1.0f, 0.0f));
+        const Mat4 Projection = MakeReverseZPerspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 1000.0f);
+
+        LightClusters Clusters;
+        Context.Measure(LightCount, [&] { Clusters.Build(Lights, View, Projection, &GetJobs()); });
+
+        const LightClusterStats& Stats = Clusters.GetStats();
+        Context.SetCounter("visible_lights", Stats.VisibleLightCount);
+        Context.SetCounter("indices", Stats.IndexCount);
+        Context.SetCounter("max_cluster_lights", Stats.MaxClusterLightCount);
+        Context.SetCounter("overflow", Stats.OverflowCount);
+        Context.SetCounter("workers", GetJobs().GetWorkerCount() + 1);
+        if (Stats.VisibleLightCount == 0 || Stats.IndexCount < Stats.VisibleLightCount) { Context.Fail("lights not assigned"); }
+    });
+}
+
+const bool Registered = [] {
+    RegisterAssignBenchmark(1000);
+    RegisterAssignBenchmark(10000);
+    return true;
+}();
+
+} // namespace
+
+} // namespace Volante::Bench
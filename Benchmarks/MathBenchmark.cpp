@@ -0,0 +1,133 @@
+#include <bit>
+#include <random>
+#include <vector>
+
+#include "Benchmark.h"
+#include "Runtime/Core/Math/Bounds.h"
+#include "Runtime/Core/Math/Simd.h"
+#include "Runtime/Rendering/DepthConvention.h"
+
+namespace Volante::Bench {
+
+namespace {
+
+constexpr uint32_t ElementCount = 10'000;
+
+std::vector<Mat4> MakeTransforms(uint32_t Seed) {
+    std::mt19937 Rng(Seed);
+    std::uniform_real_distribution<float> Position(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> Angle(0.0f, 6.2831853f);
+    std::vector<Mat4> Transforms(ElementCount);
+    for (Mat4& Transform : Transforms) {
+        Transform = glm::translate(Mat4(1.0f), Vec3(Position(Rng), Position(Rng), Position(Rng)));
+        Transform = glm::rotate(Transform, Angle(Rng), glm::normalize(Vec3(0.3f, 1.0f, 0.2f)));
+    }
+    return Transforms;
+}
+
+std::vector<Vec3> MakePoints(uint32_t Seed) {
+    std::mt19937 Rng(Seed);
+    std::uniform_real_distribution<float> Position(-100.0f, 100.0f);
+    std::vector<Vec3> Points(ElementCount);
+    for (Vec3& Point : Points) {
+        Point = Vec3(Position(Rng), Position(Rng), Position(Rng));
+    }
+    return Points;
+}
+
+// Parent-times-local, the core of a transform hierarchy update.
+void BenchMat4Multiply(BenchContext& Context) {
+    const std::vector<Mat4> Parents = MakeTransforms(1);
+    const std::vector<Mat4> Locals = MakeTransforms(2);
+    std::vector<Mat4> Worlds(ElementCount);
+    Context.Measure(ElementCount, [&] {
+        for (uint32_t i = 0; i < ElementCount; ++i) {
+            Worlds[i] = Parents[i] * Locals[i];
+        }
+        DoNotOptimize(Worlds.data());
+    });
+}
+
+void BenchTransformPoints(BenchContext& Context) {
+    const Mat4 Transform = MakeTransforms(3)[0];
+    const std::vector<Vec3> Points = MakePoints(4);
+    std::vector<Vec3> Transformed(ElementCount);
+    Context.Measure(ElementCount, [&] {
+        for (uint32_t i = 0; i < ElementCount; ++i) {
+            Transformed[i] = Vec3(Transform * Vec4(Points[i], 1.0f));
+        }
+        DoNotOptimize(Transformed.data());
+    });
+}
+
+void BenchFrustumClassify(BenchContext& Context) {
+    const Mat4 ViewProjection = MakeReverseZPerspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 500.0f) *
+                                glm::lookAt(Vec3(0.0f, 10.0f, 150.0f), Vec3(0.0f), Vec3(0.0f, 1.0f, 0.0f));
+    const Frustum View = Frustum::FromMatrix(ViewProjection);
+    std::vector<AABB> Boxes;
+    Boxes.reserve(ElementCount);
+    for (const Vec3& Center : MakePoints(5)) {
+        Boxes.push_back(AABB::FromCenterExtent(Center, Vec3(1.0f)));
+    }
+    uint32_t Visible = 0;
+    Context.Measure(ElementCount, [&] {
+        Visible = 0;
+        for (const AABB& Box : Boxes) {
+            Visible += View.Intersects(Box) ? 1 : 0;
+        }
+        DoNotOptimize(Visible);
+    });
+    Context.SetCounter("visible", Visible);
+}
+
+// Same test four boxes at a time on SoA data, the layout the CPU culling path uses.
+void BenchFrustumClassifySimd(BenchContext& Context) {
+    const Mat4 ViewProjection = MakeReverseZPerspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 500.0f) *
+                                glm::lookAt(Vec3(0.0f, 10.0f, 150.0f), Vec3(0.0f), Vec3(0.0f, 1.0f, 0.0f));
+    const Frustum View = Frustum::FromMatrix(ViewProjection);
+    const std::vector<Vec3> Centers = MakePoints(5);
+    std::vector<float> X(ElementCount), Y(ElementCount), Z(ElementCount);
+    for (uint32_t i = 0; i < ElementCount; ++i) {
+        X[i] = Centers[i].x;
+        Y[i] = Centers[i].y;
+        Z[i] = Centers[i].z;
+    }
+    const Vec3 Extent(1.0f);
+    uint32_t Visible = 0;
+    Context.Measure(ElementCount, [&] {
+        Visible = 0;
+        for (uint32_t i = 0; i < ElementCount; i += 4) {
+            const Float4 CX = Float4::Load(&X[i]);
+            const Float4 CY = Float4::Load(&Y[i]);
+            const Float4 CZ = Float4::Load(&Z[i]);
+            Float4 Outside = Float4::Zero();
+            for (const Plane& P : View.Planes) {
+                const float Radius = dot(Extent, glm::abs(P.Normal));
+                const Float4 D = CX * Float4::Splat(P.Normal.x) + CY * Float4::Splat(P.Normal.y) +
+                                 CZ * Float4::Splat(P.Normal.z) + Float4::Splat(P.Distance);
+                Outside = Outside | (D < Float4::Splat(-Radius));
+            }
+            Visible += 4 - std::popcount(static_cast<unsigned>(MoveMask(Outside)));
+        }
+        DoNotOptimize(Visible);
+    });
+    Context.SetCounter("visible", Visible);
+
+    uint32_t Expected = 0;
+    for (const Vec3& Center : Centers) {
+        Expected += View.Intersects(AABB::FromCenterExtent(Center, Extent)) ? 1 : 0;
+    }
+    if (Visible != Expected) { Context.Fail("disagrees with the scalar test"); }
+}
+
+const bool Registered = [] {
+    BenchRegistration("Math/Mat4Multiply10k", BenchMat4Multiply);
+    BenchRegistration("Math/TransformPoints10k", BenchTransformPoints);
+    BenchRegistration("Math/FrustumClassify10k", BenchFrustumClassify);
+    BenchRegistration("Math/FrustumClassifySimd10k", BenchFrustumClassifySimd);
+    return true;
+}();
+
+} // namespace
+
+} // namespace Volante::Bench
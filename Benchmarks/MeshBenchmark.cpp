@@ -0,0 +1,89 @@
+#include <string>
+
+#include "BenchGLContext.h"
+#include "Benchmark.h"
+#include "Mesh.h"
+#include "Runtime/Core/Async/JobSystem.h"
+#include "Runtime/Rendering/ProceduralMesh.h"
+
+namespace Volante::Bench {
+
+namespace {
+
+JobSystem& GetJobs() {
+    static JobSystem Jobs;
+    return Jobs;
+}
+
+// CPU generation only, no GL.
+void RegisterGenerateBenchmark(const std::string& Name, MeshData (*Generate)(JobSystem*), bool Parallel) {
+    BenchRegistration(Name.c_str(), [Generate, Parallel](BenchContext& Context) {
+        size_t VertexCount = 0;
+        Context.Measure(1, [&] {
+            const MeshData Data = Generate(Parallel ? &GetJobs() : nullptr);
+            VertexCount = Data.Vertices.size();
+            DoNotOptimize(Data.Vertices.data());
+        });
+        Context.SetCounter("vertices", static_cast<double>(VertexCount));
+        if (VertexCount == 0) { Context.Fail("no vertices generated"); }
+        if (Parallel) { Context.SetCounter("workers", GetJobs().GetWorkerCount() + 1); }
+    });
+}
+
+// Generation and upload together, as a ProceduralMeshCache miss does them.
+void RegisterCreateSphereBenchmark(unsigned int Sectors, unsigned int Stacks) {
+    const std::string Name = "Mesh/CreateSphere" + std::to_string(Sectors) + "x" + std::to_string(Stacks);
+    BenchRegistration(Name.c_str(), [Sectors, Stacks](BenchContext& Context) {
+        if (!BenchGLContext::Get()) {
+            Context.Skip("no GL context");
+            return;
+        }
+        size_t VertexCount = 0;
+        Context.Measure(1, [&] {
+            const Mesh Sphere(GenerateUVSphere(1.0f, Sectors, Stacks));
+            VertexCount = Sphere.vertices.size();
+            BenchGLContext::Finish();
+        });
+        Context.SetCounter("vertices", static_cast<double>(VertexCount));
+        if (VertexCount != static_cast<size_t>(Sectors + 1) * (Stacks + 1)) { Context.Fail("wrong vertex count"); }
+    });
+}
+
+// Upload alone: buffers and vertex array for geometry that already exists on the CPU.
+void RegisterUploadBenchmark(unsigned int Sectors, unsigned int Stacks) {
+    const std::string Name = "Mesh/Upload" + std::to_string(Sectors) + "x" + std::to_string(Stacks);
+    BenchRegistration(Name.c_str(), [Sectors, Stacks](BenchContext& Context) {
+        if (!BenchGLContext::Get()) {
+            Context.Skip("no GL context");
+            return;
+        }
+        const MeshData Source = GenerateUVSphere(1.0f, Sectors, Stacks);
+        const size_t Bytes = Source.Vertices.size() * sizeof(Vertex) + Source.Indices.size() * sizeof(unsigned int);
+        Context.Measure(1, [&] {
+            const Mesh Uploaded(Source.Vertices, Source.Indices);
+            BenchGLContext::Finish();
+        });
+        Context.SetCounter("bytes", static_cast<double>(Bytes));
+    });
+}
+
+const bool Registered = [] {
+    const auto UVSphere = [](JobSystem* Jobs) { return GenerateUVSphere(1.0f, 256, 128, Jobs); };
+    const auto Icosphere = [](JobSystem*) { return GenerateIcosphere(1.0f, 5); };
+    const auto CubeSphere = [](JobSystem* Jobs) { return GenerateCubeSphere(1.0f, 64, Jobs); };
+    RegisterGenerateBenchmark("Mesh/GenerateUVSphere256x128", UVSphere, false);
+    RegisterGenerateBenchmark("Mesh/GenerateUVSphere256x128Parallel", UVSphere, true);
+    RegisterGenerateBenchmark("Mesh/GenerateIcosphere5", Icosphere, false);
+    RegisterGenerateBenchmark("Mesh/GenerateCubeSphere64", CubeSphere, false);
+    RegisterGenerateBenchmark("Mesh/GenerateCubeSphere64Parallel", CubeSphere, true);
+    RegisterCreateSphereBenchmark(16, 8);
+    RegisterCreateSphereBenchmark(64, 32);
+    RegisterCreateSphereBenchmark(256, 128);
+    RegisterUploadBenchmark(64, 32);
+    RegisterUploadBenchmark(256, 128);
+    return true;
+}();
+
+} // namespace
+
+} // namespace Volante::Bench
@@ -0,0 +1,144 @@
+#include "BenchGLContext.h"
+#include "Benchmark.h"
+#include "Runtime/Core/Async/JobSystem.h"
+#include "Runtime/Particles/ParticleSystem.h"
+#include "Runtime/Rendering/DepthConvention.h"
+#include "Runtime/Rendering/GLCapabilities.h"
+#include "Runtime/Rendering/UploadRing.h"
+
+namespace Volante::Bench {
+
+namespace {
+
+constexpr uint32_t ParticleCount = 1024 * 1024;
+
+JobSystem& GetJobs() {
+    static JobSystem Jobs;
+    return Jobs;
+}
+
+// A million particles that outlive the run, spread by one burst, so every measured step
+// integrates and compacts the full count.
+struct ParticleScene {
+    ParticleSystem System;
+
+    ParticleScene(bool AllowCompute, bool Sort) : System(MakeDesc(AllowCompute, Sort), &GetJobs()) {
+        System.Initialize();
+        ParticleEmitterDesc Fountain;
+        Fountain.Rate = 0.0f;
+        Fountain.Spread = 1.2f;
+        Fountain.SpawnRadius = 4.0f;
+        Fountain.SpeedMin = 0.5f;
+        Fountain.SpeedMax = 1.5f;
+        Fountain.LifetimeMin = 1000.0f;
+        Fountain.LifetimeMax = 2000.0f;
+        Fountain.SizeStart = 0.02f;
+        Fountain.SizeEnd = 0.02f;
+        Fountain.Gravity = Vec3(0.0f, -0.5f, 0.0f);
+        Fountain.Drag = 0.1f;
+        System.Burst(System.CreateEmitter(Fountain), ParticleCount);
+        System.Update(1.0f / 60.0f);
+    }
+
+    ~ParticleScene() { System.Shutdown(); }
+
+    static ParticleSystemDesc MakeDesc(bool AllowCompute, bool Sort) {
+        ParticleSystemDesc Desc;
+        Desc.MaxParticles = ParticleCount;
+        Desc.AllowCompute = AllowCompute;
+        Desc.SortForTransparency = Sort;
+        return Desc;
+    }
+};
+
+// None of the particles may have died or been dropped along the way
+void CheckParticles(BenchContext& Context, ParticleScene& Scene) {
+    Context.SetCounter("particles", Scene.System.GetStats().ParticleCount);
+    if (Scene.System.GetStats().ParticleCount != ParticleCount) { Context.Fail("particles lost"); }
+}
+
+bool HasCompute(BenchContext& Context) {
+    if (!BenchGLContext::Get()) {
+        Context.Skip("no GL context");
+        return false;
+    }
+    if (!GLCapabilities::Get().ComputeShaders) {
+        Context.Skip("no compute shaders");
+        return false;
+    }
+    return true;
+}
+
+void BenchSimulateCPU(BenchContext& Context) {
+    if (!BenchGLContext::Get()) {
+        Context.Skip("no GL context");
+        return;
+    }
+    ParticleScene Scene(false, false);
+    Context.Measure(ParticleCount, [&] { Scene.System.Update(1.0f / 60.0f); });
+    CheckParticles(Context, Scene);
+}
+
+// Simulate, compact and finalize on the GPU, waited on.
+void BenchSimulateGPU(BenchContext& Context) {
+    if (!HasCompute(Context)) { return; }
+    ParticleScene Scene(true, false);
+    Context.Measure(ParticleCount, [&] {
+        Scene.System.Update(1.0f / 60.0f);
+        BenchGLContext::Finish();
+    });
+    CheckParticles(Context, Scene);
+}
+
+void RenderParticles(BenchContext& Context, ParticleScene& Scene) {
+    const BenchGLContext* GL = BenchGLContext::Get();
+    UploadRing Uploads;
+    if (!Uploads.Initialize()) {
+        Context.Fail("upload ring unavailable");
+        return;
+    }
+    const Mat4 View = glm::lookAt(Vec3(0.0f, 3.0f, 12.0f), Vec3(0.0f, 1.0f, 0.0f), Vec3(0.0f, 1.0f, 0.0f));
+    const Mat4 Projection = MakeReverseZPerspective(glm::radians(60.0f), static_cast<float>(BenchGLContext::Width) / BenchGLContext::Height,
+                                                    0.1f, 100.0f);
+    const RenderView CameraView = RenderView::Create(View, Projection);
+    Context.Measure(ParticleCount, [&] {
+        GL->BeginFrame();
+        Uploads.BeginFrame();
+        Scene.System.Update(1.0f / 60.0f);
+        Scene.System.Render(CameraView, Uploads);
+        Uploads.EndFrame();
+        BenchGLContext::Finish();
+    });
+    Context.SetCounter("sorted", Scene.System.GetStats().SortedCount);
+    CheckParticles(Context, Scene);
+    Uploads.Shutdown();
+}
+
+// SIMD simulation, stream upload through the ring and the instanced draw.
+void BenchRenderCPU(BenchContext& Context) {
+    if (!BenchGLContext::Get()) {
+        Context.Skip("no GL context");
+        return;
+    }
+    ParticleScene Scene(false, false);
+    RenderParticles(Context, Scene);
+}
+
+// Compute simulation, a back-to-front bitonic sort of every particle and the indirect draw.
+void BenchRenderSortedGPU(BenchContext& Context) {
+    if (!HasCompute(Context)) { return; }
+    ParticleScene Scene(true, true);
+    RenderParticles(Context, Scene);
+}
+
+const bool Registered = [] {
+    BenchRegistration("Particles/SimulateCPU1M", BenchSimulateCPU);
+    BenchRegistration("Particles/SimulateGPU1M", BenchSimulateGPU);
+    BenchRegistration("Particles/RenderCPU1M", BenchRenderCPU);
+    BenchRegistration("Particles/RenderSortedGPU1M", BenchRenderSortedGPU);
+    return true;
+}();
+
+} // namespace
+
+} // namespace Volante::Bench
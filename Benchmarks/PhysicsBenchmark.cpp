@@ -0,0 +1,67 @@
+#include <algorithm>
+
+#include "Benchmark.h"
+#include "Runtime/Core/Async/JobSystem.h"
+#include "Runtime/Physics/PhysicsScenes.h"
+#include "Runtime/Physics/PhysicsSystem.h"
+
+namespace Volante::Bench {
+
+namespace {
+
+constexpr uint32_t StepsPerIteration = 60;
+constexpr float StepTime = 1.0f / 60.0f;
+
+JobSystem& GetJobs() {
+    static JobSystem Jobs;
+    return Jobs;
+}
+
+// Each iteration rebuilds the scene and simulates one second, so every sample covers the same
+// stretch of the settle (impact, stacking, nothing asleep yet) instead of timing a sleeping world.
+void RegisterSceneBenchmark(const char* Name, const BoxStackSceneDesc& Scene) {
+    BenchRegistration(Name, [Scene](BenchContext& Context) {
+        PhysicsSystem Physics(PhysicsDesc{}, &GetJobs());
+        Physics.Initialize();
+
+        uint64_t Hash = 0;
+        uint32_t Contacts = 0;
+        uint32_t Islands = 0;
+        Context.Measure(StepsPerIteration, [&] {
+            Physics.Clear();
+            CreateBoxStackScene(Physics, Scene);
+            for (uint32_t i = 0; i < StepsPerIteration; ++i) {
+                Physics.Step(StepTime);
+                Contacts = std::max(Contacts, Physics.GetStats().ContactCount);
+                Islands = std::max(Islands, Physics.GetStats().IslandCount);
+            }
+            Hash = Physics.ComputeStateHash();
+        });
+
+        Context.SetCounter("bodies", Physics.GetStats().BodyCount);
+        Context.SetCounter("max_contacts", Contacts);
+        Context.SetCounter("max_islands", Islands);
+        Context.SetCounter("workers", GetJobs().GetWorkerCount() + 1);
+        // Identical across runs and worker counts; a change means the simulation is no longer
+        // deterministic (or the solver changed)
+        Context.SetCounter("state_hash_low32", static_cast<double>(Hash & 0xFFFFFFFFu));
+        if (Physics.GetStats().BodyCount == 0 || Contacts == 0) { Context.Fail("nothing simulated"); }
+
+        Physics.Shutdown();
+    });
+}
+
+const bool Registered = [] {
+    RegisterSceneBenchmark("Physics/BoxStacks2400/Step", BoxStackSceneDesc{});
+
+    BoxStackSceneDesc Mixed;
+    Mixed.StacksX = 10;
+    Mixed.StacksZ = 10;
+    Mixed.SphereCount = 500;
+    RegisterSceneBenchmark("Physics/BoxStacks600Spheres500/Step", Mixed);
+    return true;
+}();
+
+} // namespace
+
+} // namespace Volante::Bench
@@ -0,0 +1,88 @@
+#include <glad/glad.h>
+
+#include <vector>
+
+#include "BenchGLContext.h"
+#include "Benchmark.h"
+#include "Runtime/Rendering/FrameGraph.h"
+#include "Runtime/Rendering/PostProcessStack.h"
+
+namespace Volante::Bench {
+
+namespace {
+
+// The whole post stack at the bench resolution, into an imported texture, waited on. The scene
+// pass only clears to an HDR colour bright enough to bloom, so the timing is the post passes'.
+// With Dynamic set, the scale sweeps between half and full size every frame, as dynamic
+// resolution would move it, within targets reserved for full size.
+void BenchStack(BenchContext& Context, AntiAliasingMode Mode, float RenderScale, bool Dynamic = false) {
+    const BenchGLContext* GL = BenchGLContext::Get();
+    if (!GL) {
+        Context.Skip("no GL context");
+        return;
+    }
+    PostProcessDesc Desc;
+    Desc.AntiAliasing = Mode;
+    Desc.RenderScale = RenderScale;
+    Desc.ReservedScale = Dynamic ? 1.0f : 0.0f;
+    PostProcessStack Post(Desc);
+    if (!Post.Initialize()) {
+        Context.Skip("post-process shaders unavailable");
+        return;
+    }
+    const FrameGraphTextureDesc OutputDesc{BenchGLContext::Width, BenchGLContext::Height, GL_RGBA8};
+    unsigned int Output = 0;
+    glGenTextures(1, &Output);
+    glBindTexture(GL_TEXTURE_2D, Output);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, OutputDesc.Width, OutputDesc.Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    FrameGraph Graph;
+    uint32_t Frame = 0;
+    const auto DrawScene = [] {
+        glClearColor(2.0f, 1.5f, 0.5f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    };
+    Context.Measure(1, [&] {
+        GL->BeginFrame();
+        if (Dynamic) { Post.SetRenderScale(0.5f + 0.025f * static_cast<float>(Frame++ % 21)); }
+        Post.SetMainView(RenderView{}, 1);
+        Graph.Reset();
+        Post.AddPasses(Graph, Graph.Import("Output", Output, OutputDesc), DrawScene);
+        Graph.Compile();
+        Graph.Execute();
+        BenchGLContext::Finish();
+    });
+
+    const FrameGraphStats& Stats = Graph.GetStats();
+    Context.SetCounter("passes", Stats.PassCount - Stats.CulledPassCount);
+    Context.SetCounter("culled", Stats.CulledPassCount);
+    Context.SetCounter("textures", Stats.TextureCount);
+    Context.SetCounter("texture_mb", static_cast<double>(Stats.TextureBytes) / (1024.0 * 1024.0));
+
+    // The scene is a bright, warm colour, so whatever the mode, the output must be too
+    std::vector<uint8_t> Pixels(static_cast<size_t>(OutputDesc.Width) * OutputDesc.Height * 4);
+    glBindTexture(GL_TEXTURE_2D, Output);
+    glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, Pixels.data());
+    glBindTexture(GL_TEXTURE_2D, 0);
+    const uint8_t* Centre = &Pixels[(static_cast<size_t>(OutputDesc.Height / 2) * OutputDesc.Width + OutputDesc.Width / 2) * 4];
+    if (Centre[0] < 128 || Centre[0] < Centre[2]) { Context.Fail("output not written"); }
+    Graph.ForgetTexture(Output);
+    Graph.Shutdown();
+    glDeleteTextures(1, &Output);
+    Post.Shutdown();
+}
+
+const bool Registered = [] {
+    BenchRegistration("PostProcess/None", [](BenchContext& Context) { BenchStack(Context, AntiAliasingMode::None, 1.0f); });
+    BenchRegistration("PostProcess/MSAA4x", [](BenchContext& Context) { BenchStack(Context, AntiAliasingMode::MSAA, 1.0f); });
+    BenchRegistration("PostProcess/FXAA", [](BenchContext& Context) { BenchStack(Context, AntiAliasingMode::FXAA, 1.0f); });
+    BenchRegistration("PostProcess/TAA", [](BenchContext& Context) { BenchStack(Context, AntiAliasingMode::TAA, 1.0f); });
+    BenchRegistration("PostProcess/FXAAHalfScale", [](BenchContext& Context) { BenchStack(Context, AntiAliasingMode::FXAA, 0.5f); });
+    BenchRegistration("PostProcess/TAADynamicScale", [](BenchContext& Context) { BenchStack(Context, AntiAliasingMode::TAA, 1.0f, true); });
+    return true;
+}();
+
+} // namespace
+
+} // namespace Volante::Bench
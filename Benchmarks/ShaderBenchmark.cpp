@@ -0,0 +1,111 @@
+#include <glad/glad.h>
+
+#include <random>
+#include <vector>
+
+#include "BenchGLContext.h"
+#include "Benchmark.h"
+#include "Shader.h"
+
+namespace Volante::Bench {
+
+namespace {
+
+constexpr uint32_t ObjectCount = 1000;
+
+const char* VertexSource = R"(
+#version 330 core
+layout(location = 0) in vec3 aPosition;
+uniform mat4 uModel;
+uniform mat4 uViewProjection;
+void main() { gl_Position = uViewProjection * uModel * vec4(aPosition, 1.0); }
+)";
+
+const char* FragmentSource = R"(
+#version 330 core
+uniform vec3 uColor;
+uniform float uAlpha;
+out vec4 FragColor;
+void main() { FragColor = vec4(uColor, uAlpha); }
+)";
+
+std::vector<Mat4> MakeModels() {
+    std::mt19937 Rng(7);
+    std::uniform_real_distribution<float> Position(-50.0f, 50.0f);
+    std::vector<Mat4> Models(ObjectCount);
+    for (Mat4& Model : Models) {
+        Model = glm::translate(Mat4(1.0f), Vec3(Position(Rng), Position(Rng), Position(Rng)));
+    }
+    return Models;
+}
+
+bool IsLinked(const Shader& Program) {
+    GLint Linked = GL_FALSE;
+    glGetProgramiv(Program.id, GL_LINK_STATUS, &Linked);
+    return Linked == GL_TRUE;
+}
+
+// The per-object uniform pattern of forward rendering: a location lookup by name on every set.
+void BenchUniformsByName(BenchContext& Context) {
+    if (!BenchGLContext::Get()) {
+        Context.Skip("no GL context");
+        return;
+    }
+    const Shader Program(VertexSource, FragmentSource);
+    if (!IsLinked(Program)) {
+        Context.Fail("shader does not link");
+        return;
+    }
+    const std::vector<Mat4> Models = MakeModels();
+    const Mat4 ViewProjection(1.0f);
+    Program.use();
+    Context.Measure(ObjectCount, [&] {
+        for (const Mat4& Model : Models) {
+            Program.setMat4("uViewProjection", ViewProjection);
+            Program.setMat4("uModel", Model);
+            Program.setVec3("uColor", Vec3(1.0f, 0.5f, 0.25f));
+            Program.setFloat("uAlpha", 1.0f);
+        }
+        BenchGLContext::Finish();
+    });
+}
+
+// Same uniforms with the locations looked up once, to show what the name lookup costs.
+void BenchUniformsByLocation(BenchContext& Context) {
+    if (!BenchGLContext::Get()) {
+        Context.Skip("no GL context");
+        return;
+    }
+    const Shader Program(VertexSource, FragmentSource);
+    if (!IsLinked(Program)) {
+        Context.Fail("shader does not link");
+        return;
+    }
+    const std::vector<Mat4> Models = MakeModels();
+    const Mat4 ViewProjection(1.0f);
+    const Vec3 Color(1.0f, 0.5f, 0.25f);
+    const GLint ViewProjectionLocation = glGetUniformLocation(Program.id, "uViewProjection");
+    const GLint ModelLocation = glGetUniformLocation(Program.id, "uModel");
+    const GLint ColorLocation = glGetUniformLocation(Program.id, "uColor");
+    const GLint AlphaLocation = glGetUniformLocation(Program.id, "uAlpha");
+    Program.use();
+    Context.Measure(ObjectCount, [&] {
+        for (const Mat4& Model : Models) {
+            glUniformMatrix4fv(ViewProjectionLocation, 1, GL_FALSE, &ViewProjection[0][0]);
+            glUniformMatrix4fv(ModelLocation, 1, GL_FALSE, &Model[0][0]);
+            glUniform3fv(ColorLocation, 1, &Color[0]);
+            glUniform1f(AlphaLocation, 1.0f);
+        }
+        BenchGLContext::Finish();
+    });
+}
+
+const bool Registered = [] {
+    BenchRegistration("Shader/UniformsByName1k", BenchUniformsByName);
+    BenchRegistration("Shader/UniformsByLocation1k", BenchUniformsByLocation);
+    return true;
+}();
+
+} // namespace
+
+} // namespace Volante::Bench
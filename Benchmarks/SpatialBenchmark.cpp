@@ -0,0 +1,217 @@
+#include <limits>
+#include <memory>
+#include <random>
+#include <string>
+
+#include "Benchmark.h"
+#include "Runtime/Core/Async/JobSystem.h"
+#include "Runtime/Rendering/DepthConvention.h"
+#include "Runtime/Spatial/LooseOctree.h"
+#include "Runtime/Spatial/SpatialHashGrid.h"
+
+namespace Volante::Bench {
+
+namespace {
+
+constexpr uint32_t EntityCount = 1'000'000;
+constexpr float WorldHalfSize = 2048.0f;
+constexpr uint32_t QueriesPerIteration = 1024;
+
+// 1M small boxes spread over a 4 km cube, roughly one per 34 m cell; the density of a large
+// open-world level.
+const std::vector<SpatialItem>& GetEntities() {
+    static const std::vector<SpatialItem> Items = [] {
+        std::mt19937 Rng(1234);
+        std::uniform_real_distribution<float> Position(-WorldHalfSize, WorldHalfSize);
+        std::uniform_real_distribution<float> Size(0.25f, 2.0f);
+
+        std::vector<SpatialItem> Result(EntityCount);
+        for (uint32_t i = 0; i < EntityCount; ++i) {
+            const Vec3 Center(Position(Rng), Position(Rng), Position(Rng));
+            Result[i] = {i, AABB::FromCenterExtent(Center, Vec3(Size(Rng), Size(Rng), Size(Rng)))};
+        }
+        return Result;
+    }();
+    return Items;
+}
+
+JobSystem& GetJobs() {
+    static JobSystem Jobs;
+    return Jobs;
+}
+
+std::unique_ptr<ISpatialPartition> MakeOctree() {
+    return std::make_unique<LooseOctree>(AABB(Vec3(-WorldHalfSize), Vec3(WorldHalfSize)), 7);
+}
+
+std::unique_ptr<ISpatialPartition> MakeHashGrid() {
+    return std::make_unique<SpatialHashGrid>(32.0f);
+}
+
+std::vector<Vec3> MakeQueryPoints(uint32_t Seed) {
+    std::mt19937 Rng(Seed);
+    std::uniform_real_distribution<float> Position(-WorldHalfSize, WorldHalfSize);
+    std::vector<Vec3> Points(QueriesPerIteration);
+    for (Vec3& Point : Points) {
+        Point = Vec3(Position(Rng), Position(Rng), Position(Rng));
+    }
+    return Points;
+}
+
+// Queries checked against a scan of every entity after timing; a partition that misses or
+// invents hits would otherwise just look fast
+constexpr uint32_t CheckedQueries = 8;
+
+template <typename Fn>
+size_t CountScanned(Fn&& Overlaps) {
+    size_t Count = 0;
+    for (const SpatialItem& Item : GetEntities()) { Count += Overlaps(Item.Bounds) ? 1 : 0; }
+    return Count;
+}
+
+using PartitionFactory = std::unique_ptr<ISpatialPartition> (*)();
+
+void RegisterPartitionBenchmarks(const char* Prefix, PartitionFactory Factory) {
+    const std::string Name = std::string("Spatial/") + Prefix;
+
+    BenchRegistration(std::string(Name + "/Build1M").c_str(), [Factory](BenchContext& Context) {
+        auto Partition = Factory();
+        Context.Measure(EntityCount, [&] { Partition->Build(GetEntities(), &GetJobs()); });
+        Context.SetCounter("workers", GetJobs().GetWorkerCount() + 1);
+        if (Partition->GetCount() != EntityCount) { Context.Fail("entities missing after the build"); }
+    });
+
+    BenchRegistration(std::string(Name + "/Update100k").c_str(), [Factory](BenchContext& Context) {
+        auto Partition = Factory();
+        Partition->Build(GetEntities(), &GetJobs());
+
+        // Small per-frame motion: most moves stay in their cell and take the O(1) path.
+        std::vector<SpatialItem> Moving(GetEntities().begin(), GetEntities().begin() + 100'000);
+        float Offset = 0.0f;
+        Context.Measure(Moving.size(), [&] {
+            Offset = Offset > 0.0f ? -0.5f : 0.5f;
+            for (SpatialItem& Item : Moving) {
+                Item.Bounds = {Item.Bounds.Min + Vec3(Offset, 0.0f, 0.0f), Item.Bounds.Max + Vec3(Offset, 0.0f, 0.0f)};
+                Partition->Update(Item.Id, Item.Bounds);
+            }
+        });
+    });
+
+    BenchRegistration(std::string(Name + "/Sphere20m").c_str(), [Factory](BenchContext& Context) {
+        auto Partition = Factory();
+        Partition->Build(GetEntities(), &GetJobs());
+        const std::vector<Vec3> Points = MakeQueryPoints(1);
+
+        std::vector<SpatialId> Ids;
+        size_t Found = 0;
+        Context.Measure(QueriesPerIteration, [&] {
+            Found = 0;
+            for (const Vec3& Point : Points) {
+                Ids.clear();
+                Partition->QuerySphere(Point, 20.0f, Ids);
+                Found += Ids.size();
+            }
+            DoNotOptimize(Found);
+        });
+        Context.SetCounter("hits_per_query", static_cast<double>(Found) / QueriesPerIteration);
+
+        for (uint32_t i = 0; i < CheckedQueries; ++i) {
+            Ids.clear();
+            Partition->QuerySphere(Points[i], 20.0f, Ids);
+            if (Ids.size() != CountScanned([&](const AABB& Bounds) { return Bounds.DistanceSquared(Points[i]) <= 400.0f; })) {
+                Context.Fail("sphere query disagrees with a scan");
+                break;
+            }
+        }
+    });
+
+    BenchRegistration(std::string(Name + "/AABB64m").c_str(), [Factory](BenchContext& Context) {
+        auto Partition = Factory();
+        Partition->Build(GetEntities(), &GetJobs());
+        const std::vector<Vec3> Points = MakeQueryPoints(2);
+
+        std::vector<SpatialId> Ids;
+        size_t Found = 0;
+        Context.Measure(QueriesPerIteration, [&] {
+            Found = 0;
+            for (const Vec3& Point : Points) {
+                Ids.clear();
+                Partition->QueryAABB(AABB::FromCenterExtent(Point, Vec3(32.0f)), Ids);
+                Found += Ids.size();
+            }
+            DoNotOptimize(Found);
+        });
+        Context.SetCounter("hits_per_query", static_cast<double>(Found) / QueriesPerIteration);
+
+        for (uint32_t i = 0; i < CheckedQueries; ++i) {
+            const AABB Box = AABB::FromCenterExtent(Points[i], Vec3(32.0f));
+            Ids.clear();
+            Partition->QueryAABB(Box, Ids);
+            if (Ids.size() != CountScanned([&](const AABB& Bounds) { return Bounds.Intersects(Box); })) {
+                Context.Fail("box query disagrees with a scan");
+                break;
+            }
+        }
+    });
+
+    BenchRegistration(std::string(Name + "/Raycast500m").c_str(), [Factory](BenchContext& Context) {
+        auto Partition = Factory();
+        Partition->Build(GetEntities(), &GetJobs());
+        const std::vector<Vec3> Points = MakeQueryPoints(3);
+        const std::vector<Vec3> Targets = MakeQueryPoints(4);
+
+        size_t Hits = 0;
+        Context.Measure(QueriesPerIteration, [&] {
+            Hits = 0;
+            for (uint32_t i = 0; i < QueriesPerIteration; ++i) {
+                SpatialHit Hit;
+                Hits += Partition->Raycast(Ray(Points[i], normalize(Targets[i] - Points[i])), 500.0f, Hit);
+            }
+            DoNotOptimize(Hits);
+        });
+        Context.SetCounter("hit_ratio", static_cast<double>(Hits) / QueriesPerIteration);
+    });
+
+    BenchRegistration(std::string(Name + "/Nearest8").c_str(), [Factory](BenchContext& Context) {
+        auto Partition = Factory();
+        Partition->Build(GetEntities(), &GetJobs());
+        const std::vector<Vec3> Points = MakeQueryPoints(5);
+
+        std::vector<SpatialHit> Hits;
+        Context.Measure(QueriesPerIteration, [&] {
+            for (const Vec3& Point : Points) {
+                Partition->QueryNearest(Point, 8, std::numeric_limits<float>::max(), Hits);
+                DoNotOptimize(Hits.data());
+            }
+        });
+    });
+
+    BenchRegistration(std::string(Name + "/Frustum").c_str(), [Factory](BenchContext& Context) {
+        auto Partition = Factory();
+        Partition->Build(GetEntities(), &GetJobs());
+
+        const Mat4 Projection = MakeReverseZPerspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 1000.0f);
+        const Mat4 View = glm::lookAt(Vec3(0.0f), Vec3(1.0f, 0.0f, 0.0f), Vec3(0.0f, 1.0f, 0.0f));
+        const Frustum ViewFrustum = Frustum::FromMatrix(Projection * View);
+
+        std::vector<SpatialId> Visible;
+        Context.Measure(1, [&] {
+            Visible.clear();
+            Partition->QueryFrustum(ViewFrustum, Visible);
+        });
+        Context.SetCounter("visible", static_cast<double>(Visible.size()));
+        if (Visible.size() != CountScanned([&](const AABB& Bounds) { return ViewFrustum.Intersects(Bounds); })) {
+            Context.Fail("frustum query disagrees with a scan");
+        }
+    });
+}
+
+const bool Registered = [] {
+    RegisterPartitionBenchmarks("LooseOctree", MakeOctree);
+    RegisterPartitionBenchmarks("HashGrid", MakeHashGrid);
+    return true;
+}();
+
+} // namespace
+
+} // namespace Volante::Bench
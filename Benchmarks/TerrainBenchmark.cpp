@@ -0,0 +1,107 @@
+#include <cmath>
+#include <vector>
+
+#include "BenchGLContext.h"
+#include "Benchmark.h"
+#include "Runtime/Core/Async/JobSystem.h"
+#include "Runtime/Rendering/DepthConvention.h"
+#include "Runtime/Rendering/UploadRing.h"
+#include "Runtime/Terrain/TerrainSystem.h"
+
+namespace Volante::Bench {
+
+namespace {
+
+JobSystem& GetJobs() {
+    static JobSystem Jobs;
+    return Jobs;
+}
+
+// A camera 30 m above the ground, flying across the terrain and slowly turning, so every
+// frame selects a different set of nodes.
+RenderView CreateFlyoverView(const ProceduralTerrainSource& Source, uint32_t Frame) {
+    const float X = static_cast<float>(Frame) * 10.0f;
+    const float Z = static_cast<float>(Frame) * 7.0f;
+    const Vec3 Eye(X, Source.GetHeight(X, Z) + 30.0f, Z);
+    const float Heading = static_cast<float>(Frame) * 0.05f;
+    const Mat4 View = glm::lookAt(Eye, Eye + Vec3(std::cos(Heading), -0.2f, std::sin(Heading)), Vec3(0.0f, 1.0f, 0.0f));
+    const Mat4 Projection = MakeReverseZPerspective(glm::radians(60.0f), static_cast<float>(BenchGLContext::Width) / BenchGLContext::Height,
+                                                    1.0f, 40000.0f);
+    return RenderView::Create(View, Projection);
+}
+
+// CDLOD selection alone, over a 64 km world.
+void BenchSelect(BenchContext& Context) {
+    ProceduralTerrainDesc SourceDesc;
+    SourceDesc.Octaves = 6;
+    const ProceduralTerrainSource Source(SourceDesc);
+    constexpr uint32_t Resolution = 257;
+    constexpr float WorldSize = 65536.0f;
+    std::vector<float> Heights(Resolution * Resolution);
+    const float Spacing = WorldSize / (Resolution - 1);
+    for (uint32_t Z = 0; Z < Resolution; ++Z) {
+        for (uint32_t X = 0; X < Resolution; ++X) {
+            Heights[Z * Resolution + X] = Source.GetHeight(X * Spacing - WorldSize * 0.5f, Z * Spacing - WorldSize * 0.5f);
+        }
+    }
+    TerrainQuadtreeDesc Desc;
+    Desc.Origin = Vec2(-WorldSize * 0.5f);
+    Desc.WorldSize = WorldSize;
+    TerrainQuadtree Quadtree;
+    Quadtree.Build(Desc, Heights.data(), Resolution, 1.0f);
+
+    std::vector<TerrainNode> Selection;
+    uint32_t Frame = 0;
+    Context.Measure(1, [&] { Quadtree.Select(CreateFlyoverView(Source, Frame++ % 1024), Selection); });
+    Context.SetCounter("nodes", static_cast<double>(Selection.size()));
+    if (Selection.empty()) { Context.Fail("no nodes selected"); }
+}
+
+// Streaming, selection and the four instanced draws of a 16 km world, waited on.
+void BenchRender(BenchContext& Context) {
+    const BenchGLContext* GL = BenchGLContext::Get();
+    if (!GL) {
+        Context.Skip("no GL context");
+        return;
+    }
+    ProceduralTerrainDesc SourceDesc;
+    SourceDesc.Octaves = 6;
+    const auto Source = std::make_shared<ProceduralTerrainSource>(SourceDesc);
+    TerrainSystem Terrain({}, &GetJobs());
+    Terrain.Initialize();
+    Terrain.SetHeightSource(Source);
+    UploadRing Uploads;
+    if (!Uploads.Initialize()) {
+        Context.Fail("upload ring unavailable");
+        Terrain.Shutdown();
+        return;
+    }
+
+    uint32_t Frame = 0;
+    Context.Measure(1, [&] {
+        GL->BeginFrame();
+        Uploads.BeginFrame();
+        Terrain.Update(1.0f / 60.0f);
+        Terrain.Render(CreateFlyoverView(*Source, Frame++ % 1024), Uploads, Vec3(0.4f, 1.0f, 0.3f));
+        Uploads.EndFrame();
+        BenchGLContext::Finish();
+    });
+
+    const TerrainStats& Stats = Terrain.GetStats();
+    Context.SetCounter("nodes", Stats.NodeCount);
+    Context.SetCounter("triangles", static_cast<double>(Stats.TriangleCount));
+    Context.SetCounter("resident_tiles", Stats.ResidentTiles);
+    if (Stats.NodeCount == 0 || Stats.TriangleCount == 0) { Context.Fail("no terrain drawn"); }
+    Uploads.Shutdown();
+    Terrain.Shutdown();
+}
+
+const bool Registered = [] {
+    BenchRegistration("Terrain/Select64km", BenchSelect);
+    BenchRegistration("Terrain/Render16km", BenchRender);
+    return true;
+}();
+
+} // namespace
+
+} // namespace Volante::Bench
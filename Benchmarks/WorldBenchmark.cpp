@@ -0,0 +1,144 @@
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+#include "Runtime/Core/Async/JobSystem.h"
+#include "Runtime/World/World.h"
+#include "Runtime/World/WorldSerializer.h"
+#include "Volante.h"
+
+namespace Volante::Bench {
+
+namespace {
+
+constexpr uint32_t EntityCount = 1'000'000;
+
+struct Transform {
+    Vec3 Position;
+    Quat Rotation;
+    float Scale;
+};
+
+struct Velocity {
+    Vec3 Linear;
+    Vec3 Angular;
+};
+
+struct Attachment {
+    Entity Parent;
+    uint32_t Socket;
+};
+
+JobSystem& GetJobs() {
+    static JobSystem Jobs;
+    return Jobs;
+}
+
+void RegisterComponents(World& Target) {
+    Target.RegisterComponent<Transform>("Transform");
+    Target.RegisterComponent<Velocity>("Velocity");
+    Target.RegisterComponent<Attachment>("Attachment", 1, {offsetof(Attachment, Parent)});
+}
+
+// 1M entities in three archetypes: a quarter static, the rest moving, one in eight of those
+// attached to a static one.
+World& GetWorld() {
+    static World Scene;
+    static const bool Populated = [] {
+        RegisterComponents(Scene);
+        std::vector<Entity> Static;
+        for (uint32_t i = 0; i < EntityCount; ++i) {
+            const Transform Placed{Vec3(static_cast<float>(i % 1024), 0.0f, static_cast<float>(i / 1024)), Quat(1.0f, 0.0f, 0.0f, 0.0f), 1.0f};
+            if (i % 4 == 0) {
+                Static.push_back(Scene.CreateEntity(Placed));
+            } else if (i % 8 == 1) {
+                Scene.CreateEntity(Placed, Velocity{Vec3(1.0f, 0.0f, 0.0f), Vec3(0.0f)}, Attachment{Static.back(), i % 4});
+            } else {
+                Scene.CreateEntity(Placed, Velocity{Vec3(0.0f, 0.0f, 1.0f), Vec3(0.0f)});
+            }
+        }
+        return true;
+    }();
+    (void)Populated;
+    return Scene;
+}
+
+void BenchSave(BenchContext& Context, bool Compress) {
+    const World& Scene = GetWorld();
+    std::vector<uint8_t> Snapshot;
+    WorldSaveOptions Options;
+    Options.Compress = Compress;
+    Context.Measure(EntityCount, [&] { WorldSerializer::Save(Scene, Snapshot, Options, &GetJobs()); });
+    Context.SetCounter("megabytes", static_cast<double>(Snapshot.size()) / (1024.0 * 1024.0));
+
+    World Loaded;
+    RegisterComponents(Loaded);
+    if (!WorldSerializer::Load(Loaded, Snapshot.data(), Snapshot.size()) || Loaded.GetEntityCount() != EntityCount) {
+        Context.Fail("snapshot does not load back");
+    }
+}
+
+void BenchSave1M(BenchContext& Context) {
+    BenchSave(Context, false);
+}
+
+void BenchSaveCompressed1M(BenchContext& Context) {
+    BenchSave(Context, true);
+}
+
+// Replace from a mapped file: schema checks, parallel column copies and the record rebuild.
+void BenchLoad(BenchContext& Context, bool Compress) {
+    const std::string Path = Compress ? "VolanteBenchWorldCompressed.vwld" : "VolanteBenchWorld.vwld";
+    WorldSaveOptions Options;
+    Options.Compress = Compress;
+    if (!WorldSerializer::SaveToFile(GetWorld(), Path, Options, &GetJobs())) {
+        Context.Skip("cannot write snapshot");
+        return;
+    }
+    World Loaded;
+    RegisterComponents(Loaded);
+    Context.Measure(EntityCount, [&] {
+        if (!WorldSerializer::LoadFromFile(Loaded, Path, WorldLoadMode::Replace, &GetJobs())) { Context.Fail("load failed"); }
+    });
+    Context.SetCounter("entities", Loaded.GetEntityCount());
+    if (Loaded.GetEntityCount() != EntityCount) { Context.Fail("entities lost in the round trip"); }
+    std::remove(Path.c_str());
+}
+
+void BenchLoad1M(BenchContext& Context) {
+    BenchLoad(Context, false);
+}
+
+void BenchLoadCompressed1M(BenchContext& Context) {
+    BenchLoad(Context, true);
+}
+
+// Integrating every moving transform, chunk by chunk.
+void BenchIterate1M(BenchContext& Context) {
+    World& Scene = GetWorld();
+    Context.Measure(EntityCount, [&] {
+        Scene.ParallelForEachChunk<Transform, Velocity>(&GetJobs(), [](uint32_t Count, const Entity*, Transform* Transforms,
+                                                                       Velocity* Velocities) {
+            for (uint32_t i = 0; i < Count; ++i) { Transforms[i].Position += Velocities[i].Linear * (1.0f / 60.0f); }
+        });
+    });
+
+    uint32_t Visited = 0;
+    Scene.ForEach<Transform, Velocity>([&Visited](Entity, Transform&, Velocity&) { ++Visited; });
+    if (Visited != EntityCount - EntityCount / 4) { Context.Fail("moving entities missed"); }
+}
+
+const bool Registered = [] {
+    BenchRegistration("World/Save1M", BenchSave1M);
+    BenchRegistration("World/SaveCompressed1M", BenchSaveCompressed1M);
+    BenchRegistration("World/Load1M", BenchLoad1M);
+    BenchRegistration("World/LoadCompressed1M", BenchLoadCompressed1M);
+    BenchRegistration("World/Iterate1M", BenchIterate1M);
+    return true;
+}();
+
+} // namespace
+
+} // namespace Volante::Bench
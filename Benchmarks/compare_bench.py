@@ -0,0 +1,63 @@
+#!/usr/bin/env python3
+"""Compare two VolanteBench --json runs.
+
+Usage: compare_bench.py <baseline.json> <current.json> [--threshold=0.10]
+
+Prints ns/iter for every benchmark present in either run and exits with 1 when any
+benchmark got slower than the threshold (a fraction of the baseline time), so it can
+gate an upgrade or a CI job. Run both sides with the same --min-time on the same machine.
+"""
+
+import json
+import sys
+
+
+def load(path):
+    with open(path, encoding="utf-8") as f:
+        return {b["name"]: b for b in json.load(f)["benchmarks"]}
+
+
+def main(argv):
+    threshold = 0.10
+    paths = []
+    for arg in argv[1:]:
+        if arg.startswith("--threshold="):
+            threshold = float(arg[len("--threshold="):])
+        else:
+            paths.append(arg)
+    if len(paths) != 2:
+        print(__doc__.strip(), file=sys.stderr)
+        return 2
+
+    baseline, current = load(paths[0]), load(paths[1])
+    names = list(baseline) + [name for name in current if name not in baseline]
+    width = max((len(name) for name in names), default=4)
+
+    regressions = []
+    print(f"{'Benchmark':<{width}}  {'Baseline':>14}  {'Current':>14}  {'Change':>8}")
+    for name in names:
+        if name not in current:
+            print(f"{name:<{width}}  {baseline[name]['ns_per_iteration']:>11.0f} ns  {'missing':>14}")
+            continue
+        if name not in baseline:
+            print(f"{name:<{width}}  {'new':>14}  {current[name]['ns_per_iteration']:>11.0f} ns")
+            continue
+        before = baseline[name]["ns_per_iteration"]
+        after = current[name]["ns_per_iteration"]
+        change = after / before - 1.0 if before > 0 else 0.0
+        marker = ""
+        if change > threshold:
+            marker = "  REGRESSION"
+            regressions.append(name)
+        elif change < -threshold:
+            marker = "  improved"
+        print(f"{name:<{width}}  {before:>11.0f} ns  {after:>11.0f} ns  {change * 100:>+7.1f}%{marker}")
+
+    if regressions:
+        print(f"\n{len(regressions)} regression(s) over {threshold * 100:.0f}%: {', '.join(regressions)}")
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
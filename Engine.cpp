@@ -3,27 +3,86 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
 #include <iostream>
 #include <ranges>
+#include <string>
 
+#include "Source/Platform/GLFW/GLFWImGuiLayer.h"
 #include "Source/Platform/GLFW/GLFWKeyMapper.h"
+#include "Source/Runtime/Animation/AnimationSystem.h"
+#include "Source/Runtime/Core/Async/JobSystem.h"
+#include "Source/Runtime/Core/Stats/StatsOverlay.h"
+#include "Source/Runtime/Particles/ParticleSystem.h"
+#include "Source/Runtime/Physics/PhysicsSystem.h"
+#include "Source/Runtime/Rendering/CameraSystem.h"
+#include "Source/Runtime/Rendering/ClusteredLighting.h"
+#include "Source/Runtime/Rendering/DepthConvention.h"
+#include "Source/Runtime/Rendering/DepthPicker.h"
+#include "Source/Runtime/Rendering/DynamicResolution.h"
+#include "Source/Runtime/Rendering/FrameCapture.h"
+#include "Source/Runtime/Rendering/FrameGraph.h"
+#include "Source/Runtime/Rendering/GLCapabilities.h"
+#include "Source/Runtime/Rendering/GPUReadback.h"
+#include "Source/Runtime/Rendering/GPUTimers.h"
+#include "Source/Runtime/Rendering/MeshLibrary.h"
+#include "Source/Runtime/Rendering/PostProcessStack.h"
+#include "Source/Runtime/Rendering/ProceduralMesh.h"
+#include "Source/Runtime/Rendering/ResourceManager.h"
+#include "Source/Runtime/Rendering/SceneRenderer.h"
+#include "Source/Runtime/Rendering/ShaderLibrary.h"
+#include "Source/Runtime/Rendering/UploadContext.h"
+#include "Source/Runtime/Rendering/UploadRing.h"
+#include "Source/Runtime/Rendering/WindowPresenter.h"
+#include "Source/Runtime/Spatial/SpatialIndex.h"
+#include "Source/Runtime/Terrain/TerrainSystem.h"
+#include "Source/Runtime/World/World.h"
 
 namespace Volante {
 
-Engine* Engine::Instance = nullptr;
-
-Engine::Engine() {
-    Instance = this;
-}
+Engine::Engine() = default;
 
 Engine::~Engine() {
     Shutdown();
-    Instance = nullptr;
 }
 
 bool Engine::Initialize(const WindowDesc& WindowDesc) {
     try {
-        Window = Window::Create(WindowDesc);
+        // Hidden and unthrottled, so playback runs as fast as frames can be made
+        const bool Headless = std::getenv("VOLANTE_HEADLESS") != nullptr;
+        auto Desc = WindowDesc;
+        if (Headless) {
+            Desc.visible = false;
+            Desc.vsync = false;
+        }
+        // The window only receives the post-processed image; the samples asked of it go to
+        // the scene target. VOLANTE_AA is none, msaa, fxaa or taa.
+        PostProcessDesc PostDesc;
+        PostDesc.MSAASamples = std::max(Desc.samples, 1);
+        PostDesc.AntiAliasing = PostDesc.MSAASamples > 1 ? AntiAliasingMode::MSAA : AntiAliasingMode::None;
+        if (const char* AntiAliasing = std::getenv("VOLANTE_AA")) {
+            const std::string Mode = AntiAliasing;
+            if (Mode == "none") {
+                PostDesc.AntiAliasing = AntiAliasingMode::None;
+            } else if (Mode == "msaa") {
+                PostDesc.AntiAliasing = AntiAliasingMode::MSAA;
+                PostDesc.MSAASamples = std::max(PostDesc.MSAASamples, 4);
+            } else if (Mode == "fxaa") {
+                PostDesc.AntiAliasing = AntiAliasingMode::FXAA;
+            } else if (Mode == "taa") {
+                PostDesc.AntiAliasing = AntiAliasingMode::TAA;
+            } else {
+                std::cerr << "ERROR::ENGINE::UNKNOWN_AA_MODE: " << Mode << std::endl;
+            }
+        }
+        if (const char* RenderScale = std::getenv("VOLANTE_RENDER_SCALE")) {
+            PostDesc.RenderScale = std::strtof(RenderScale, nullptr);
+        }
+        Desc.samples = 1;
+        Window = Window::Create(Desc);
         if (!Window) {
             throw std::runtime_error("Failed to create window");
         }
@@ -35,22 +94,125 @@ bool Engine::Initialize(const WindowDesc& WindowDesc) {
         std::cout << "OpenGL Version: " << glGetString(GL_VERSION) << std::endl;
         std::cout << "GLSL Version: " << glGetString(GL_SHADING_LANGUAGE_VERSION) << std::endl;
 
+        JobSystem = std::make_unique<class JobSystem>();
         World = std::make_unique<class World>();
-        Renderer = std::make_unique<class Renderer>(Window.get());
+        ShaderLibrary = std::make_unique<class ShaderLibrary>(JobSystem.get());
+        Renderer = std::make_unique<class Renderer>(Window.get(), PostDesc, ShaderLibrary.get());
+        // Milliseconds of GPU time per frame to hold, by scaling the render resolution
+        if (const char* Budget = std::getenv("VOLANTE_DYNAMIC_RESOLUTION")) {
+            DynamicResolutionDesc ResolutionDesc;
+            ResolutionDesc.Enabled = true;
+            if (const float BudgetMs = std::strtof(Budget, nullptr); BudgetMs > 0.0f) { ResolutionDesc.BudgetMs = BudgetMs; }
+            Renderer->SetDynamicResolution(ResolutionDesc);
+        }
         InputManager = std::make_unique<class InputManager>(Window.get());
-
+        SpatialIndex = std::make_unique<class SpatialIndex>(SpatialIndexDesc{}, JobSystem.get());
+        World->SetSpatialIndex(SpatialIndex.get());
+        PhysicsSystem = std::make_unique<class PhysicsSystem>(PhysicsDesc{}, JobSystem.get());
+        SceneRenderer = std::make_unique<class SceneRenderer>(SceneRendererDesc{}, JobSystem.get(), Renderer->GetUploads(),
+                                                              Renderer->GetResources(), ShaderLibrary.get());
+        MeshLibrary = std::make_unique<class MeshLibrary>(JobSystem.get());
+        ProceduralMeshes = std::make_unique<ProceduralMeshCache>(*Renderer->GetResources(), JobSystem.get());
+        AnimationSystem = std::make_unique<class AnimationSystem>(AnimationSystemDesc{}, JobSystem.get(), ShaderLibrary.get());
+        ParticleSystem = std::make_unique<class ParticleSystem>(ParticleSystemDesc{}, JobSystem.get(), ShaderLibrary.get());
+        TerrainSystem = std::make_unique<class TerrainSystem>(TerrainDesc{}, JobSystem.get(), ShaderLibrary.get());
+        CameraSystem = std::make_unique<class CameraSystem>(SceneRenderer.get());
+
+        StatsOverlayDesc OverlayDesc;
+        if (const char* ExportPath = std::getenv("VOLANTE_STATS_EXPORT")) { OverlayDesc.ExportPath = ExportPath; }
+        StatsOverlay = std::make_unique<class StatsOverlay>(OverlayDesc);
+        ImGuiLayer = std::make_unique<GLFWImGuiLayer>(Window.get());
+
+        Subsystems.push_back(StatsOverlay.get());
+        // Reloads swap in here, before anything of this frame is drawn. Ahead of the renderer, so
+        // the post stack's programs are unloaded before the library shuts down
+        Subsystems.push_back(ShaderLibrary.get());
         Subsystems.push_back(Renderer.get());
+        Subsystems.push_back(MeshLibrary.get());
+        Subsystems.push_back(SceneRenderer.get());
+        Subsystems.push_back(CameraSystem.get());
+        Subsystems.push_back(AnimationSystem.get());
+        Subsystems.push_back(ParticleSystem.get());
+        Subsystems.push_back(TerrainSystem.get());
         Subsystems.push_back(InputManager.get());
+        Subsystems.push_back(PhysicsSystem.get());
+        Subsystems.push_back(SpatialIndex.get());
+
+        int FramebufferWidth = 0;
+        int FramebufferHeight = 0;
+        Window->GetFramebufferSize(FramebufferWidth, FramebufferHeight);
+        CameraSystem->SetFramebufferSize(FramebufferWidth, FramebufferHeight);
 
         for (auto& Subsystem : Subsystems) {
             Subsystem->Initialize();
         }
+        // The overlay is optional; the engine runs without it
+        ImGuiLayer->Initialize();
+        // Texture levels upload, and shader reloads compile, off the main thread where a shared
+        // context could be made
+        SceneRenderer->GetTextures().SetUploadContext(Renderer->GetUploadContext());
+        ShaderLibrary->SetUploadContext(Renderer->GetUploadContext());
+        StatsOverlay->SetInfo(std::string("Culling: ") + (SceneRenderer->IsGPUDriven() ? "GPU (compute)" : "CPU") + " on " +
+                              GLCapabilities::Get().Renderer);
+
+        // More windows showing the scene, each from a camera that starts as a copy of the main
+        // one; fullscreen ones open on the following monitors
+        if (const char* WindowCount = std::getenv("VOLANTE_WINDOWS")) {
+            for (int Index = 1; Index < std::atoi(WindowCount); ++Index) {
+                auto ExtraDesc = Desc;
+                ExtraDesc.title = Desc.title + " " + std::to_string(Index + 1);
+                ExtraDesc.monitor = Index;
+                AddWindow(ExtraDesc, CameraSystem->GetMainCamera());
+            }
+        }
 
-        Window->SetResizeCallback([this](int Width, int Height) {
+        // Every frame as <path>_000000.png, ... or, for a .raw or .rgba path, one raw RGBA stream
+        // for a video encoder; with VOLANTE_HEADLESS and a replay, a capture of the whole run
+        if (const char* CapturePath = std::getenv("VOLANTE_CAPTURE")) {
+            FrameCaptureDesc CaptureDesc;
+            CaptureDesc.Path = CapturePath;
+            CaptureDesc.Format = FrameCapture::GetFormatForPath(CapturePath);
+            Renderer->GetFrameCapture()->Open(CaptureDesc);
+        }
+
+        // A .vmesh asset drawn at the origin and swapped whenever the file is rewritten, e.g. by
+        // an exporter
+        if (const char* MeshPath = std::getenv("VOLANTE_MESH")) { PreviewMesh = MeshLibrary->Load(MeshPath); }
+
+        // "procedural", or a square 16-bit RAW heightmap covering the default terrain
+        if (const char* TerrainSource = std::getenv("VOLANTE_TERRAIN")) {
+            const TerrainDesc Defaults;
+            std::error_code Error;
+            if (std::string(TerrainSource) == "procedural") {
+                TerrainSystem->SetHeightSource(std::make_shared<ProceduralTerrainSource>());
+            } else if (const uintmax_t Size = std::filesystem::file_size(TerrainSource, Error); !Error) {
+                const auto Samples = static_cast<uint32_t>(std::sqrt(static_cast<double>(Size / 2)));
+                TerrainSystem->SetHeightSource(std::make_shared<RawHeightmapSource>(
+                    TerrainSource, Samples, Defaults.Origin, Defaults.WorldSize, Defaults.MinHeight, Defaults.MaxHeight));
+            } else {
+                std::cerr << "ERROR::ENGINE::TERRAIN_NOT_FOUND: " << TerrainSource << std::endl;
+            }
+        }
+
+        InputManager->SetResizeHandler([this](int Width, int Height) {
             HandleWindowResize(Width, Height);
         });
 
-        Window->Show();
+        // Reproducible sessions: record input and frame times, then replay them, headless for
+        // captures. VOLANTE_STATS_EXPORT writes the replay's frame timings for comparison.
+        const char* FixedTimestep = std::getenv("VOLANTE_FIXED_TIMESTEP");
+        if (FixedTimestep) { InputManager->SetFixedTimestep(std::strtof(FixedTimestep, nullptr)); }
+        if (const char* ReplayPath = std::getenv("VOLANTE_INPUT_REPLAY")) {
+            if (!InputManager->StartPlayback(ReplayPath)) {
+                throw std::runtime_error("Failed to open input recording");
+            }
+            if (Headless && !FixedTimestep) { InputManager->SetFixedTimestep(1.0f / 60.0f); }
+        } else if (const char* RecordPath = std::getenv("VOLANTE_INPUT_RECORD")) {
+            InputManager->StartRecording(RecordPath);
+        }
+
+        if (!Headless) { Window->Show(); }
+        Initialized = true;
         Running = true;
         LastFrameTime = std::chrono::steady_clock::now();
 
@@ -62,69 +224,203 @@ bool Engine::Initialize(const WindowDesc& WindowDesc) {
 }
 
 void Engine::Run() {
+    const auto StartTime = std::chrono::steady_clock::now();
     while (Running && !Window->ShouldClose()) {
         const auto CurrentTime = std::chrono::steady_clock::now();
-        const float DeltaTime = std::chrono::duration<float>(CurrentTime - LastFrameTime).count();
+        const float Elapsed = std::chrono::duration<float>(CurrentTime - LastFrameTime).count();
         LastFrameTime = CurrentTime;
 
         Window->PollEvents();
+        // Events for every window arrive through the main one's PollEvents
+        WindowPresenter& Presenter = *Renderer->GetPresenter();
+        while (const uint32_t Closing = Presenter.FindClosingWindow()) {
+            const auto It = std::ranges::find(ExtraWindows, Closing, &ExtraWindow::Surface);
+            if (It == ExtraWindows.end()) { break; }
+            RemoveWindow(It->CameraId);
+        }
+        if (Presenter.UpdateLayout()) { ApplyWindowLayout(); }
+
+        const float DeltaTime = InputManager->BeginFrame(Elapsed);
+        if (InputManager->IsPlaybackFinished()) {
+            const float Seconds = std::chrono::duration<float>(CurrentTime - StartTime).count();
+            std::cout << "Input playback finished: " << InputManager->GetFrameIndex() - 1 << " frames in " << Seconds << " s"
+                      << std::endl;
+            RequestExit();
+            break;
+        }
         Update(DeltaTime);
         Render();
     }
 }
 
 void Engine::Shutdown() {
-    if (!Running) { return; }
+    // RequestExit() only stops the loop; everything that initialized still shuts down once
+    if (!Initialized) { return; }
 
+    Initialized = false;
     Running = false;
 
+    // Their cameras go with CameraSystem, the windows with the renderer
+    ExtraWindows.clear();
+    // Before SpatialIndex shuts down and drops the world's proxies
+    World->SetSpatialIndex(nullptr);
     for (const auto& Subsystem : std::ranges::reverse_view(Subsystems)) {
         Subsystem->Shutdown();
     }
 
+    ImGuiLayer.reset();
     Subsystems.clear();
+    StatsOverlay.reset();
+    CameraSystem.reset();
+    TerrainSystem.reset();
+    ParticleSystem.reset();
+    AnimationSystem.reset();
+    ProceduralMeshes.reset();
+    MeshLibrary.reset();
+    SceneRenderer.reset();
+    PhysicsSystem.reset();
+    SpatialIndex.reset();
     InputManager.reset();
     Renderer.reset();
+    // After everything that loaded programs through it
+    ShaderLibrary.reset();
     World.reset();
+    JobSystem.reset();
     Window.reset();
 }
 
 void Engine::Update(float DeltaTime) {
+    // The overlay captures the previous frame first, so this scope lands in the next capture
+    StatScope Scope(StatTimer::Update);
+
     InputManager->Update(DeltaTime);
 
     if (InputManager->IsKeyPressed(GLFW_KEY_ESCAPE)) {
         RequestExit();
     }
 
+    const bool StatsToggle = InputManager->IsKeyPressed(GLFW_KEY_F1);
+    if (StatsToggle && !StatsToggleHeld) { StatsOverlay->SetVisible(!StatsOverlay->IsVisible()); }
+    StatsToggleHeld = StatsToggle;
+
+    // Named after the frame, so a replay's screenshots match the session's
+    const bool ScreenshotKey = InputManager->IsKeyPressed(GLFW_KEY_F12);
+    if (ScreenshotKey && !ScreenshotKeyHeld) {
+        Renderer->GetFrameCapture()->RequestScreenshot("Screenshot_" + std::to_string(InputManager->GetFrameIndex()) + ".png");
+    }
+    ScreenshotKeyHeld = ScreenshotKey;
+
     for (const auto& Subsystem : Subsystems) {
         Subsystem->Update(DeltaTime);
     }
 
     World->Update(DeltaTime);
+
+    // A reload goes in as a new scene mesh, which the preview instance is moved to. GPUScene
+    // only appends geometry, so every reload grows its buffers; fine for previewing an asset.
+    const Mesh* Preview = MeshLibrary->Get(PreviewMesh);
+    if (Preview && MeshLibrary->GetVersion(PreviewMesh) != PreviewMeshVersion) {
+        GPUScene& Scene = SceneRenderer->GetScene();
+        if (PreviewInstance != ~0u) { Scene.RemoveInstance(PreviewInstance); }
+        PreviewInstance = Scene.AddInstance(Scene.AddMesh(*Preview), Mat4(1.0f));
+        PreviewMeshVersion = MeshLibrary->GetVersion(PreviewMesh);
+    }
+
+    // Make this frame's moves visible to rendering and next frame's gameplay queries
+    SpatialIndex->Flush();
 }
 
 void Engine::Render() {
     Renderer->BeginFrame();
-    Renderer->Clear();
 
-    World->Render(Renderer.get());
+    PostProcessStack& Post = *Renderer->GetPostProcess();
+    CameraSystem->Apply(Post.GetJitter());
+    Post.SetMainView(SceneRenderer->GetView(), SceneRenderer->GetViewCount());
+    Renderer->RenderFrame([&] {
+        Renderer->Clear();
+        SceneRenderer->Render();
+        const Vec3 LightDirection = SceneRenderer->GetLighting().GetDirectionalLightDirection();
+        // Characters seen by several views are posed once
+        SceneRenderer->GetViews(FrameViews);
+        AnimationSystem->Evaluate(FrameViews, *Renderer->GetUploads());
+        SceneRenderer->ForEachView([&](const RenderView& View) {
+            TerrainSystem->Render(View, *Renderer->GetUploads(), LightDirection);
+            AnimationSystem->Render(View, *Renderer->GetUploads(), LightDirection);
+            // Blended, so after everything opaque
+            ParticleSystem->Render(View, *Renderer->GetUploads());
+        });
+        World->Render(Renderer.get());
+    });
+
+    ImGuiLayer->BeginFrame();
+    StatsOverlay->Draw();
+    ImGuiLayer->EndFrame();
 
     Renderer->EndFrame();
 }
 
 void Engine::HandleWindowResize(int Width, int Height) {
+    Renderer->GetPresenter()->SetMainSize(Width, Height);
+    ApplyWindowLayout();
     Renderer->SetViewport(0, 0, Width, Height);
 }
 
-void World::Update(float DeltaTime) {
-    // Update all entities/actors
+uint32_t Engine::AddWindow(const WindowDesc& Desc, const Camera& View) {
+    WindowDesc SharedDesc = Desc;
+    SharedDesc.share = Window.get();
+    // Windows only receive the finished image
+    SharedDesc.samples = 1;
+    std::unique_ptr<IWindow> NewWindow;
+    try {
+        NewWindow = Window::Create(SharedDesc);
+    } catch (const std::exception& e) {
+        std::cerr << "ERROR::ENGINE::WINDOW_CREATION_FAILED: " << e.what() << std::endl;
+    }
+    if (NewWindow) {
+        // Creating it made its context current here; its present thread takes it over
+        NewWindow->GetGraphicsContext()->ReleaseCurrent();
+    }
+    Window->GetGraphicsContext()->MakeCurrent();
+    if (!NewWindow) { return MainSceneView; }
+
+    const uint32_t Surface = Renderer->GetPresenter()->AddWindow(std::move(NewWindow));
+    const SceneViewId CameraId = CameraSystem->AddCamera(View, Vec4(0.0f, 0.0f, 1.0f, 1.0f), Surface);
+    ExtraWindows.push_back({Surface, CameraId});
+    ApplyWindowLayout();
+    return CameraId;
 }
 
-void World::Render(Renderer* Renderer) {
-    // Render all entities/actors
+void Engine::RemoveWindow(uint32_t CameraId) {
+    const auto It = std::ranges::find(ExtraWindows, CameraId, &ExtraWindow::CameraId);
+    if (It == ExtraWindows.end()) { return; }
+    CameraSystem->RemoveCamera(CameraId);
+    Renderer->GetPresenter()->RemoveWindow(It->Surface);
+    ExtraWindows.erase(It);
+    ApplyWindowLayout();
 }
 
-Renderer::Renderer(IWindow* Window) : Window(Window), Context(Window->GetGraphicsContext()) {}
+void Engine::ApplyWindowLayout() {
+    const WindowPresenter& Presenter = *Renderer->GetPresenter();
+    int Width = 0;
+    int Height = 0;
+    Presenter.GetCanvasSize(Width, Height);
+    // Nothing to lay out until the main window has a size
+    if (Width <= 0 || Height <= 0) { return; }
+    Renderer->Resize(Width, Height);
+    CameraSystem->SetFramebufferSize(Width, Height);
+    for (uint32_t Surface = 0; Surface < Presenter.GetSurfaceCount(); ++Surface) {
+        CameraSystem->SetSurfaceRect(Surface, Presenter.GetSurfaceRect(Surface));
+    }
+}
+
+Renderer::Renderer(IWindow* Window, const PostProcessDesc& PostDesc, ShaderLibrary* Shaders)
+    : Window(Window), Context(Window->GetGraphicsContext()), Uploads(std::make_unique<UploadRing>()),
+      Resources(std::make_unique<ResourceManager>()), Readback(std::make_unique<GPUReadback>()), Graph(std::make_unique<FrameGraph>()),
+      Post(std::make_unique<PostProcessStack>(PostDesc, Shaders)), Presenter(std::make_unique<WindowPresenter>(*Graph)),
+      Capture(std::make_unique<FrameCapture>(*Readback, *Graph)), Picker(std::make_unique<DepthPicker>(*Readback)),
+      FrameTimers(std::make_unique<GPUTimers>()), Resolution(std::make_unique<DynamicResolution>()) {}
+
+Renderer::~Renderer() = default;
 
 void Renderer::Initialize() {
     Context->MakeCurrent();
@@ -133,10 +429,39 @@ void Renderer::Initialize() {
     glEnable(GL_CULL_FACE);
     glCullFace(GL_BACK);
     glFrontFace(GL_CCW);
+    ApplyReverseZ();
+
+    Window->GetFramebufferSize(OutputWidth, OutputHeight);
+    Presenter->SetMainSize(OutputWidth, OutputHeight);
+    if (!Post->Initialize()) { std::cerr << "ERROR::RENDERER::POST_PROCESS_UNAVAILABLE" << std::endl; }
+    FrameTimers->Initialize();
+
+    Uploads->Initialize();
+    Readback->Initialize();
+
+    // Uploads stay on this context where no second one can be made
+    try {
+        UploadWorker = std::make_unique<UploadContext>(Window->CreateSharedContext());
+        if (!UploadWorker->Initialize()) { UploadWorker.reset(); }
+    } catch (const std::exception& e) {
+        std::cerr << "ERROR::RENDERER::UPLOAD_CONTEXT_UNAVAILABLE: " << e.what() << std::endl;
+        UploadWorker.reset();
+    }
 }
 
 void Renderer::Shutdown() {
-    // Cleanup rendering resources
+    // Kept until destruction: the texture streamer holds it and flushes it when torn down
+    if (UploadWorker) { UploadWorker->Shutdown(); }
+    // Writes out the frames still in flight
+    Capture->Shutdown();
+    Picker->Shutdown();
+    Readback->Shutdown();
+    Presenter->Shutdown();
+    FrameTimers->Shutdown();
+    Post->Shutdown();
+    Graph->Shutdown();
+    Resources->Shutdown();
+    Uploads->Shutdown();
 }
 
 void Renderer::Update(float DeltaTime) {
@@ -145,12 +470,77 @@ void Renderer::Update(float DeltaTime) {
 
 void Renderer::BeginFrame() {
     Context->MakeCurrent();
+    if (UploadWorker) { UploadWorker->Poll(); }
+    Readback->Poll();
+    Uploads->BeginFrame();
+    Resources->BeginFrame();
+}
+
+void Renderer::RenderFrame(const std::function<void()>& DrawScene) {
+    if (!Post->IsValid() || OutputWidth <= 0 || OutputHeight <= 0) {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glViewport(0, 0, std::max(OutputWidth, 1), std::max(OutputHeight, 1));
+        DrawScene();
+        return;
+    }
+    StatScope Scope(StatTimer::Frame);
+    FrameTimers->BeginFrame();
+    if (Resolution->GetDesc().Enabled) { Post->SetRenderScale(Resolution->Update(FrameTimers->GetMs(StatTimer::Frame))); }
+
+    Graph->Reset();
+    // With more windows the frame goes to the presenter's canvas, which all of them show from.
+    // A captured frame needs a texture to be read from, so it goes to one too.
+    const bool Canvas = Presenter->HasWindows();
+    const bool Capturing = Capture->IsCapturing();
+    const FrameGraphTextureDesc OutputDesc{OutputWidth, OutputHeight, GL_RGBA8};
+    unsigned int OutputTexture = 0;
+    if (Canvas) {
+        OutputTexture = Presenter->BeginFrame();
+    } else if (Capturing) {
+        OutputTexture = Capture->BeginFrame(OutputWidth, OutputHeight);
+    }
+    const FrameGraphResource Output = OutputTexture != 0 ? Graph->Import("Output", OutputTexture, OutputDesc)
+                                                         : Graph->ImportBackbuffer(OutputWidth, OutputHeight);
+    Post->AddPasses(*Graph, Output, DrawScene);
+    Picker->AddPasses(*Graph, *Post, OutputWidth, OutputHeight);
+    Graph->Compile();
+    FrameTimers->Begin(StatTimer::Frame);
+    Graph->Execute();
+    FrameTimers->End(StatTimer::Frame);
+    if (Canvas) {
+        if (Capturing) { Capture->Capture(OutputTexture, OutputWidth, OutputHeight); }
+        Presenter->EndFrame();
+    } else if (Capturing) {
+        Capture->EndFrame();
+    }
+    // Post passes leave these off; the UI sets its own state
+    glEnable(GL_DEPTH_TEST);
+    glEnable(GL_CULL_FACE);
 }
 
 void Renderer::EndFrame() {
+    Uploads->EndFrame();
+    Resources->EndFrame();
     Window->SwapBuffers();
 }
 
+void Renderer::Resize(int Width, int Height) {
+    // Minimized. Otherwise the post stack's targets absorb the new size, growing in steps
+    if (Width <= 0 || Height <= 0 || (Width == OutputWidth && Height == OutputHeight)) { return; }
+    OutputWidth = Width;
+    OutputHeight = Height;
+    // Each scale costs something else now
+    Resolution->Invalidate();
+}
+
+void Renderer::SetDynamicResolution(const DynamicResolutionDesc& Desc) {
+    Resolution->SetDesc(Desc);
+    PostProcessDesc PostDesc = Post->GetDesc();
+    PostDesc.ReservedScale = Desc.Enabled ? Desc.MaxScale : 0.0f;
+    PostDesc.RenderScale = Desc.Enabled ? Resolution->GetScale() : PostDesc.RenderScale;
+    Post->SetDesc(PostDesc);
+}
+
 void Renderer::SetViewport(int X, int Y, int Width, int Height) {
     glViewport(X, Y, Width, Height);
 }
@@ -162,24 +552,137 @@ void Renderer::Clear(float R, float G, float B, float A) {
 
 InputManager::InputManager(IWindow* Window) : Window(Window) {}
 
+InputManager::~InputManager() = default;
+
 void InputManager::Initialize() {
-    // Set up input callbacks if needed
+    Window->GetCursorPos(CursorX, CursorY);
+    Window->SetKeyCallback([this](KeyCode Key, InputAction Action) {
+        InputEvent& Event = PendingEvents.emplace_back();
+        Event.Type = InputEventType::Key;
+        Event.Code = static_cast<int32_t>(Key);
+        Event.Action = Action;
+    });
+    Window->SetMouseButtonCallback([this](MouseButton Button, InputAction Action) {
+        InputEvent& Event = PendingEvents.emplace_back();
+        Event.Type = InputEventType::MouseButton;
+        Event.Code = static_cast<int32_t>(Button);
+        Event.Action = Action;
+    });
+    Window->SetCursorPosCallback([this](double X, double Y) {
+        InputEvent& Event = PendingEvents.emplace_back();
+        Event.Type = InputEventType::CursorPos;
+        Event.X = X;
+        Event.Y = Y;
+    });
+    Window->SetResizeCallback([this](int Width, int Height) {
+        InputEvent& Event = PendingEvents.emplace_back();
+        Event.Type = InputEventType::Resize;
+        Event.Width = Width;
+        Event.Height = Height;
+    });
 }
 
 void InputManager::Shutdown() {
-    // Cleanup input resources
+    StopRecording();
+    Window->SetKeyCallback({});
+    Window->SetMouseButtonCallback({});
+    Window->SetCursorPosCallback({});
+    Window->SetResizeCallback({});
 }
 
 void InputManager::Update(float DeltaTime) {
-    // Process input state
+    // State changes in BeginFrame, before any subsystem updates
+}
+
+float InputManager::BeginFrame(float DeltaTime) {
+    float FrameTime = FixedTimestep > 0.0f ? FixedTimestep : DeltaTime;
+    if (PlayingBack) {
+        // Dropped so nothing live leaks into the replay
+        PendingEvents.clear();
+        float Recorded = 0.0f;
+        if (!Playback.ReadFrame(Recorded, FrameEvents)) {
+            PlayingBack = false;
+            PlaybackFinished = true;
+        } else if (FixedTimestep <= 0.0f) {
+            FrameTime = Recorded;
+        }
+    } else {
+        FrameEvents.swap(PendingEvents);
+        PendingEvents.clear();
+        // The time actually simulated, so a replay without a fixed timestep repeats it
+        Recorder.WriteFrame(FrameTime, FrameEvents);
+    }
+    for (const InputEvent& Event : FrameEvents) { ApplyEvent(Event); }
+    ++FrameIndex;
+    return FrameTime;
+}
+
+void InputManager::ApplyEvent(const InputEvent& Event) {
+    switch (Event.Type) {
+    case InputEventType::Key:
+        if (Event.Code >= 0 && Event.Code < static_cast<int>(KeyCode::Count)) { Keys[Event.Code] = Event.Action != InputAction::Release; }
+        break;
+    case InputEventType::MouseButton:
+        if (Event.Code >= 0 && Event.Code < static_cast<int>(MouseButton::Count)) {
+            Buttons[Event.Code] = Event.Action != InputAction::Release;
+        }
+        break;
+    case InputEventType::CursorPos:
+        CursorX = Event.X;
+        CursorY = Event.Y;
+        break;
+    case InputEventType::Resize:
+        // Window size stands in for framebuffer size; they differ only on scaled displays
+        if (PlayingBack) { Window->SetSize(Event.Width, Event.Height); }
+        if (ResizeHandler) { ResizeHandler(Event.Width, Event.Height); }
+        break;
+    }
+}
+
+bool InputManager::StartRecording(const std::string& Path) {
+    InputRecordingHeader Header;
+    Window->GetFramebufferSize(Header.FramebufferWidth, Header.FramebufferHeight);
+    Header.CursorX = CursorX;
+    Header.CursorY = CursorY;
+    return Recorder.Open(Path, Header);
+}
+
+void InputManager::StopRecording() {
+    if (!Recorder.IsOpen()) { return; }
+    Recorder.Close();
+    std::cout << "Input recording saved: " << Recorder.GetFrameCount() << " frames" << std::endl;
+}
+
+bool InputManager::StartPlayback(const std::string& Path) {
+    StopRecording();
+    if (!Playback.Open(Path)) { return false; }
+    PlayingBack = true;
+    PlaybackFinished = false;
+    std::fill(std::begin(Keys), std::end(Keys), false);
+    std::fill(std::begin(Buttons), std::end(Buttons), false);
+    const InputRecordingHeader& Header = Playback.GetHeader();
+    CursorX = Header.CursorX;
+    CursorY = Header.CursorY;
+    InputEvent Resize;
+    Resize.Type = InputEventType::Resize;
+    Resize.Width = Header.FramebufferWidth;
+    Resize.Height = Header.FramebufferHeight;
+    ApplyEvent(Resize);
+    return true;
 }
 
 bool InputManager::IsKeyPressed(int Key) const {
-    return Window->IsKeyPressed(GLFWKeyMapper::FromGLFWKey(Key));
+    const KeyCode Code = GLFWKeyMapper::FromGLFWKey(Key);
+    return Code != KeyCode::None && Keys[static_cast<int>(Code)];
+}
+
+bool InputManager::IsMouseButtonPressed(MouseButton Button) const {
+    return Button != MouseButton::None && Buttons[static_cast<int>(Button)];
 }
 
 void InputManager::GetMousePosition(double& X, double& Y) const {
-    Window->GetCursorPos(X, Y);
+    X = CursorX;
+    Y = CursorY;
 }
 
 }
\ No newline at end of file
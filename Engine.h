@@ -1,14 +1,46 @@
 #pragma once
 
 #include <chrono>
+#include <functional>
+#include <memory>
+#include <vector>
 
 #include "Runtime/Core/HAL/IWindow.h"
+#include "Runtime/Core/Input/InputRecording.h"
 
 namespace Volante {
 
 class World;
 class Renderer;
 class InputManager;
+class JobSystem;
+class SpatialIndex;
+class PhysicsSystem;
+class SceneRenderer;
+class UploadRing;
+class ResourceManager;
+class StatsOverlay;
+class ShaderLibrary;
+class MeshLibrary;
+class ProceduralMeshCache;
+class AnimationSystem;
+class ParticleSystem;
+class TerrainSystem;
+class CameraSystem;
+class FrameGraph;
+class PostProcessStack;
+struct PostProcessDesc;
+class GPUTimers;
+class DynamicResolution;
+struct DynamicResolutionDesc;
+class WindowPresenter;
+class UploadContext;
+class GPUReadback;
+class FrameCapture;
+class DepthPicker;
+class Camera;
+struct RenderView;
+class GLFWImGuiLayer;
 
 class IEngineSubsystem {
 public:
@@ -38,72 +70,229 @@ public:
 
     [[nodiscard]] InputManager* GetInputManager() const { return InputManager.get(); }
 
-    static Engine* Get() { return Instance; }
+    [[nodiscard]] JobSystem* GetJobSystem() const { return JobSystem.get(); }
+
+    [[nodiscard]] SpatialIndex* GetSpatialIndex() const { return SpatialIndex.get(); }
+
+    [[nodiscard]] PhysicsSystem* GetPhysicsSystem() const { return PhysicsSystem.get(); }
+
+    [[nodiscard]] SceneRenderer* GetSceneRenderer() const { return SceneRenderer.get(); }
+
+    [[nodiscard]] StatsOverlay* GetStatsOverlay() const { return StatsOverlay.get(); }
+
+    // File-backed shaders and meshes, reloaded between frames when their files change.
+    [[nodiscard]] ShaderLibrary* GetShaderLibrary() const { return ShaderLibrary.get(); }
+
+    [[nodiscard]] MeshLibrary* GetMeshLibrary() const { return MeshLibrary.get(); }
+
+    // Cubes and spheres, shared through the renderer's ResourceManager.
+    [[nodiscard]] ProceduralMeshCache* GetProceduralMeshes() const { return ProceduralMeshes.get(); }
+
+    [[nodiscard]] AnimationSystem* GetAnimationSystem() const { return AnimationSystem.get(); }
+
+    [[nodiscard]] ParticleSystem* GetParticleSystem() const { return ParticleSystem.get(); }
+
+    [[nodiscard]] TerrainSystem* GetTerrainSystem() const { return TerrainSystem.get(); }
+
+    // The main camera and any split-screen cameras the scene is drawn from.
+    [[nodiscard]] CameraSystem* GetCameraSystem() const { return CameraSystem.get(); }
+
+    // Another window, e.g. fullscreen on a second monitor (Desc.monitor), showing the scene from
+    // View. The scene still renders once for every window; each presents on a thread of its own
+    // at its own swap interval (Desc.vsync). Returns the window's camera, a SceneViewId the
+    // CameraSystem moves like any other, or 0 if the window could not be created.
+    uint32_t AddWindow(const WindowDesc& Desc, const Camera& View);
+    // Closing the window does the same.
+    void RemoveWindow(uint32_t CameraId);
 
 private:
+    struct ExtraWindow {
+        uint32_t Surface = 0;
+        uint32_t CameraId = 0;
+    };
+
     void Update(float DeltaTime);
     void Render();
     void HandleWindowResize(int Width, int Height);
-
-    static Engine* Instance;
+    // Hands the presenter's canvas size and window regions to the renderer and cameras
+    void ApplyWindowLayout();
 
     std::unique_ptr<IWindow> Window;
     std::unique_ptr<World> World;
     std::unique_ptr<Renderer> Renderer;
     std::unique_ptr<InputManager> InputManager;
+    std::unique_ptr<JobSystem> JobSystem;
+    std::unique_ptr<SpatialIndex> SpatialIndex;
+    std::unique_ptr<PhysicsSystem> PhysicsSystem;
+    std::unique_ptr<SceneRenderer> SceneRenderer;
+    std::unique_ptr<StatsOverlay> StatsOverlay;
+    std::unique_ptr<ShaderLibrary> ShaderLibrary;
+    std::unique_ptr<MeshLibrary> MeshLibrary;
+    std::unique_ptr<ProceduralMeshCache> ProceduralMeshes;
+    std::unique_ptr<AnimationSystem> AnimationSystem;
+    std::unique_ptr<ParticleSystem> ParticleSystem;
+    std::unique_ptr<TerrainSystem> TerrainSystem;
+    std::unique_ptr<CameraSystem> CameraSystem;
+    std::unique_ptr<GLFWImGuiLayer> ImGuiLayer;
 
     std::vector<IEngineSubsystem*> Subsystems;
+    std::vector<ExtraWindow> ExtraWindows;
 
-    bool Running = false;
-    std::chrono::steady_clock::time_point LastFrameTime;
-};
+    // The scene's views this frame, for per-frame work shared between them
+    std::vector<RenderView> FrameViews;
 
-class World {
-public:
-    World() = default;
-    ~World() = default;
+    // VOLANTE_MESH: the asset shown at the origin, the version of it in the scene and its instance
+    uint32_t PreviewMesh = ~0u;
+    uint32_t PreviewMeshVersion = 0;
+    uint32_t PreviewInstance = ~0u;
 
-    void Update(float DeltaTime);
-    void Render(Renderer* Renderer);
-
-    // Entity management would go here
-    // void SpawnActor(...);
-    // void DestroyActor(...);
+    bool Initialized = false;
+    bool Running = false;
+    bool StatsToggleHeld = false;
+    bool ScreenshotKeyHeld = false;
+    std::chrono::steady_clock::time_point LastFrameTime;
 };
 
 class Renderer : public IEngineSubsystem {
 public:
-    explicit Renderer(IWindow* Window);
-    ~Renderer() override = default;
+    // The post stack loads its programs through Shaders, or through a library of its own when
+    // it is null.
+    Renderer(IWindow* Window, const PostProcessDesc& PostDesc, ShaderLibrary* Shaders = nullptr);
+    ~Renderer() override;
 
     void Initialize() override;
     void Shutdown() override;
     void Update(float DeltaTime) override;
 
     void BeginFrame();
+    // Runs the frame graph: DrawScene renders into the HDR scene target, which the post stack
+    // turns into the window's image. Whatever is drawn after it, like the UI, goes straight to
+    // the window.
+    void RenderFrame(const std::function<void()>& DrawScene);
     void EndFrame();
     void SetViewport(int X, int Y, int Width, int Height);
     void Clear(float R = 0.0f, float G = 0.0f, float B = 0.0f, float A = 1.0f);
 
+    // The size post-processing outputs: the window's framebuffer, or with more windows the
+    // presenter's canvas.
+    void Resize(int Width, int Height);
+
+    // Enabled, the render scale follows the GPU time of each frame's graph toward Desc's budget.
+    void SetDynamicResolution(const DynamicResolutionDesc& Desc);
+
+    // Per-frame streaming memory; BeginFrame/EndFrame advance and fence it.
+    [[nodiscard]] UploadRing* GetUploads() const { return Uploads.get(); }
+
+    // Shared meshes, shaders and buffers; released ones are destroyed once their frames finish.
+    [[nodiscard]] ResourceManager* GetResources() const { return Resources.get(); }
+
+    // Anti-aliasing, tonemapping, bloom and render scale; changes apply from the next frame.
+    [[nodiscard]] PostProcessStack* GetPostProcess() const { return Post.get(); }
+
+    [[nodiscard]] const FrameGraph* GetFrameGraph() const { return Graph.get(); }
+
+    [[nodiscard]] const DynamicResolution* GetDynamicResolution() const { return Resolution.get(); }
+
+    // Extra windows, which frames render for together with this one's.
+    [[nodiscard]] WindowPresenter* GetPresenter() const { return Presenter.get(); }
+
+    // Background uploads on a context shared with the window's; polled by BeginFrame. Null if
+    // no shared context could be made.
+    [[nodiscard]] UploadContext* GetUploadContext() const { return UploadWorker.get(); }
+
+    // Reads pixels back without stalling; polled by BeginFrame, where the callbacks run.
+    [[nodiscard]] GPUReadback* GetReadback() const { return Readback.get(); }
+
+    // Screenshots and every-frame captures of the post-processed image, without the UI.
+    [[nodiscard]] FrameCapture* GetFrameCapture() const { return Capture.get(); }
+
+    // Scene depth and world position under a pixel, read with the next frame.
+    [[nodiscard]] DepthPicker* GetDepthPicker() const { return Picker.get(); }
+
 private:
     IWindow* Window;
     IGraphicsContext* Context;
+    std::unique_ptr<UploadRing> Uploads;
+    std::unique_ptr<ResourceManager> Resources;
+    std::unique_ptr<UploadContext> UploadWorker;
+    std::unique_ptr<GPUReadback> Readback;
+
+    // Rendering is reverse-Z, which needs a float depth buffer to pay off, and a window's is
+    // usually 24-bit fixed point; so the scene renders into the graph's targets with 32-bit
+    // float depth. If the post stack could not be created, frames go straight to the window.
+    std::unique_ptr<FrameGraph> Graph;
+    std::unique_ptr<PostProcessStack> Post;
+    std::unique_ptr<WindowPresenter> Presenter;
+    std::unique_ptr<FrameCapture> Capture;
+    std::unique_ptr<DepthPicker> Picker;
+    // Times the graph for the resolution controller (StatTimer::Frame)
+    std::unique_ptr<GPUTimers> FrameTimers;
+    std::unique_ptr<DynamicResolution> Resolution;
+    int OutputWidth = 0;
+    int OutputHeight = 0;
 };
 
+// Input state built from the window's callbacks, which can be recorded to a file together
+// with each frame's DeltaTime and played back in their place. Events are applied once per
+// frame by BeginFrame, live or recorded alike, so a replay sees the same state on the same
+// frame as the session it came from.
 class InputManager : public IEngineSubsystem {
 public:
     explicit InputManager(IWindow* Window);
-    ~InputManager() override = default;
+    ~InputManager() override;
 
     void Initialize() override;
     void Shutdown() override;
     void Update(float DeltaTime) override;
 
+    // Applies this frame's events and returns the DeltaTime to simulate: the recorded one when
+    // playing back, the fixed timestep if one is set, DeltaTime otherwise.
+    float BeginFrame(float DeltaTime);
+
+    bool StartRecording(const std::string& Path);
+    void StopRecording();
+    // Live input is ignored until the recording runs out.
+    bool StartPlayback(const std::string& Path);
+
+    // 0 uses the measured or recorded DeltaTime.
+    void SetFixedTimestep(float Seconds) { FixedTimestep = Seconds; }
+
+    // Called from BeginFrame with the framebuffer size, including recorded resizes.
+    void SetResizeHandler(const IWindow::ResizeCallback& Handler) { ResizeHandler = Handler; }
+
     [[nodiscard]] bool IsKeyPressed(int kKey) const;
+    [[nodiscard]] bool IsMouseButtonPressed(MouseButton Button) const;
     void GetMousePosition(double& X, double& Y) const;
 
+    [[nodiscard]] bool IsRecording() const { return Recorder.IsOpen(); }
+
+    [[nodiscard]] bool IsPlayingBack() const { return PlayingBack; }
+
+    // Set by the BeginFrame that found the recording exhausted.
+    [[nodiscard]] bool IsPlaybackFinished() const { return PlaybackFinished; }
+
+    [[nodiscard]] uint64_t GetFrameIndex() const { return FrameIndex; }
+
 private:
+    void ApplyEvent(const InputEvent& Event);
+
     IWindow* Window;
+    bool Keys[static_cast<int>(KeyCode::Count)] = {};
+    bool Buttons[static_cast<int>(MouseButton::Count)] = {};
+    double CursorX = 0.0;
+    double CursorY = 0.0;
+
+    // Gathered by the window callbacks since the last BeginFrame
+    std::vector<InputEvent> PendingEvents;
+    std::vector<InputEvent> FrameEvents;
+    IWindow::ResizeCallback ResizeHandler;
+
+    InputRecorder Recorder;
+    InputPlayback Playback;
+    bool PlayingBack = false;
+    bool PlaybackFinished = false;
+    float FixedTimestep = 0.0f;
+    uint64_t FrameIndex = 0;
 };
 
 } // namespace Volante
\ No newline at end of file
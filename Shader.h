@@ -33,10 +33,17 @@ public:
         glDeleteShader(fragment);
     }
 
+    // リンク済みのプログラムを引き取る
+    explicit Shader(unsigned int program) : id(program) {}
+
     ~Shader() {
         glDeleteProgram(id);
     }
 
+    // プログラムは一つの Shader だけが所有する
+    Shader(const Shader&) = delete;
+    Shader& operator=(const Shader&) = delete;
+
     void use() const {
         glUseProgram(id);
     }
@@ -53,6 +60,10 @@ public:
         glUniform1f(glGetUniformLocation(id, name.c_str()), value);
     }
 
+    void setVec2(const std::string& name, const Vec2& value) const {
+        glUniform2fv(glGetUniformLocation(id, name.c_str()), 1, &value[0]);
+    }
+
     void setVec3(const std::string& name, const Vec3& value) const {
         glUniform3fv(glGetUniformLocation(id, name.c_str()), 1, &value[0]);
     }
@@ -61,6 +72,10 @@ public:
         glUniform3f(glGetUniformLocation(id, name.c_str()), x, y, z);
     }
 
+    void setVec4(const std::string& name, const Vec4& value) const {
+        glUniform4fv(glGetUniformLocation(id, name.c_str()), 1, &value[0]);
+    }
+
     void setMat4(const std::string& name, const Mat4& value) const {
         glUniformMatrix4fv(glGetUniformLocation(id, name.c_str()), 1, GL_FALSE, &value[0][0]);
     }
@@ -0,0 +1,31 @@
+#version 330 core
+// 13-tap downsample (Jimenez, "Next Generation Post Processing in Call of Duty"); the first
+// level also keeps only the light above the threshold, with a soft knee.
+in vec2 vUV;
+
+uniform sampler2D uSource;
+uniform vec4 uSourceRect;
+uniform vec2 uTexelSize;
+uniform bool uPrefilter;
+uniform float uThreshold;
+
+out vec4 FragColor;
+
+vec3 Sample(float x, float y) {
+    return texture(uSource, min(vUV * uSourceRect.xy + vec2(x, y) * uTexelSize, uSourceRect.zw)).rgb;
+}
+
+void main() {
+    vec3 color = Sample(0.0, 0.0) * 0.125;
+    color += (Sample(-2.0, 2.0) + Sample(2.0, 2.0) + Sample(-2.0, -2.0) + Sample(2.0, -2.0)) * 0.03125;
+    color += (Sample(0.0, 2.0) + Sample(-2.0, 0.0) + Sample(2.0, 0.0) + Sample(0.0, -2.0)) * 0.0625;
+    color += (Sample(-1.0, 1.0) + Sample(1.0, 1.0) + Sample(-1.0, -1.0) + Sample(1.0, -1.0)) * 0.125;
+    if (uPrefilter) {
+        float brightness = max(color.r, max(color.g, color.b));
+        float knee = uThreshold * 0.5;
+        float soft = clamp(brightness - uThreshold + knee, 0.0, 2.0 * knee);
+        soft = soft * soft / (4.0 * knee + 1e-4);
+        color *= max(soft, brightness - uThreshold) / max(brightness, 1e-4);
+    }
+    FragColor = vec4(color, 1.0);
+}
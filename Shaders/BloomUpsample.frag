@@ -0,0 +1,22 @@
+#version 330 core
+// 3x3 tent upsample of the smaller level, added to this level's downsample.
+in vec2 vUV;
+
+uniform sampler2D uSource;
+uniform vec4 uSourceRect;
+uniform sampler2D uBase;
+uniform vec4 uBaseRect;
+uniform vec2 uTexelSize;
+
+out vec4 FragColor;
+
+vec3 Sample(float x, float y) {
+    return texture(uSource, min(vUV * uSourceRect.xy + vec2(x, y) * uTexelSize, uSourceRect.zw)).rgb;
+}
+
+void main() {
+    vec3 color = Sample(0.0, 0.0) * 4.0;
+    color += (Sample(-1.0, 0.0) + Sample(1.0, 0.0) + Sample(0.0, -1.0) + Sample(0.0, 1.0)) * 2.0;
+    color += Sample(-1.0, -1.0) + Sample(1.0, -1.0) + Sample(-1.0, 1.0) + Sample(1.0, 1.0);
+    FragColor = vec4(texture(uBase, min(vUV * uBaseRect.xy, uBaseRect.zw)).rgb + color / 16.0, 1.0);
+}
@@ -0,0 +1,31 @@
+// GLSL 330 compatible; CascadedShadows::Bind sets the uniforms. Declares
+//   float ComputeShadow(vec3 worldPosition, vec3 normal, float viewDepth)
+// returning 0 (shadowed) .. 1 (lit), 3x3 PCF.
+
+uniform sampler2DArrayShadow uShadowMap;
+uniform mat4 uShadowMatrices[4];
+// x: far split distance, y: depth bias, z: normal offset (world units)
+uniform vec4 uShadowParams[4];
+uniform int uShadowCascadeCount;
+uniform float uShadowTexelSize;
+
+float ComputeShadow(vec3 worldPosition, vec3 normal, float viewDepth) {
+    int cascade = 0;
+    while (cascade < uShadowCascadeCount && viewDepth > uShadowParams[cascade].x) {
+        ++cascade;
+    }
+    if (cascade >= uShadowCascadeCount) {
+        return 1.0;
+    }
+
+    vec4 coord = uShadowMatrices[cascade] * vec4(worldPosition + normalize(normal) * uShadowParams[cascade].z, 1.0);
+    // Reverse-Z: nearer the light is larger
+    float reference = coord.z + uShadowParams[cascade].y;
+    float lit = 0.0;
+    for (int y = -1; y <= 1; ++y) {
+        for (int x = -1; x <= 1; ++x) {
+            lit += texture(uShadowMap, vec4(coord.xy + vec2(x, y) * uShadowTexelSize, float(cascade), reference));
+        }
+    }
+    return lit / 9.0;
+}
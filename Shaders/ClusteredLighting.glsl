@@ -0,0 +1,54 @@
+// GLSL 330 compatible; ClusteredLighting::Bind sets the uniforms. Declares
+//   vec3 ComputeLighting(vec3 albedo, vec3 worldPosition, vec3 normal, float viewDepth,
+//                        float sunVisibility)
+// where viewDepth is the positive view-space distance along the camera axis and
+// sunVisibility scales the directional light (e.g. ComputeShadow()).
+
+uniform samplerBuffer uLightData;
+uniform usamplerBuffer uClusterRanges;
+uniform usamplerBuffer uLightIndices;
+uniform vec3 uClusterGrid;
+uniform vec2 uClusterSlices;
+uniform vec4 uViewport;
+uniform vec3 uCameraPosition;
+uniform vec3 uAmbientColor;
+uniform vec3 uSunDirection;
+uniform vec3 uSunColor;
+
+float LightFalloff(float distanceSquared, float radius) {
+    // Inverse square, windowed to reach exactly zero at the radius
+    float ratio = distanceSquared / (radius * radius);
+    float window = clamp(1.0 - ratio * ratio, 0.0, 1.0);
+    return window * window / (distanceSquared + 1.0);
+}
+
+vec3 ShadeLight(vec3 albedo, vec3 normal, vec3 viewDirection, vec3 lightDirection, vec3 radiance) {
+    float diffuse = max(dot(normal, lightDirection), 0.0);
+    float specular = pow(max(dot(normal, normalize(lightDirection + viewDirection)), 0.0), 32.0) * 0.25;
+    return (albedo * diffuse + vec3(specular * step(0.0, diffuse))) * radiance;
+}
+
+vec3 ComputeLighting(vec3 albedo, vec3 worldPosition, vec3 normal, float viewDepth, float sunVisibility) {
+    normal = normalize(normal);
+    vec3 viewDirection = normalize(uCameraPosition - worldPosition);
+    vec3 color = albedo * uAmbientColor;
+    color += albedo * max(dot(normal, uSunDirection), 0.0) * uSunColor * sunVisibility;
+
+    vec2 tile = clamp((gl_FragCoord.xy - uViewport.xy) / uViewport.zw * uClusterGrid.xy, vec2(0.0), uClusterGrid.xy - 1.0);
+    float slice = clamp(floor(log(max(viewDepth, 1e-4)) * uClusterSlices.x - uClusterSlices.y), 0.0, uClusterGrid.z - 1.0);
+    int cluster = int((slice * uClusterGrid.y + floor(tile.y)) * uClusterGrid.x + floor(tile.x));
+    uvec2 range = texelFetch(uClusterRanges, cluster).xy;
+
+    for (uint i = 0u; i < range.y; ++i) {
+        int light = int(texelFetch(uLightIndices, int(range.x + i)).x);
+        vec4 positionRadius = texelFetch(uLightData, light * 2);
+        vec3 toLight = positionRadius.xyz - worldPosition;
+        float distanceSquared = dot(toLight, toLight);
+        if (distanceSquared >= positionRadius.w * positionRadius.w) {
+            continue;
+        }
+        vec3 radiance = texelFetch(uLightData, light * 2 + 1).rgb * LightFalloff(distanceSquared, positionRadius.w);
+        color += ShadeLight(albedo, normal, viewDirection, toLight * inversesqrt(max(distanceSquared, 1e-8)), radiance);
+    }
+    return color;
+}
@@ -0,0 +1,8 @@
+// Shared by the culling kernels; must match GPUInstance, GPUMeshInfo, GPUDrawBucket,
+// DrawElementsIndirectCommand and GPUCounters in GPUCulling.cpp.
+struct Instance { mat4 Model; vec4 BoundsCenter; vec4 BoundsExtent; uint MeshIndex; uint Flags; uint MaterialIndex; uint Pad0; };
+struct MeshInfo { uint FirstBucket; uint LODCount; uint Pad0; uint Pad1; vec4 LODDistances; };
+struct DrawBucket { uint IndexCount; uint FirstIndex; int BaseVertex; uint Pad; };
+struct DrawCommand { uint Count; uint InstanceCount; uint FirstIndex; int BaseVertex; uint BaseInstance; };
+struct VisibleRef { uint Instance; uint Bucket; uint Slot; };
+layout(std430, binding = 5) buffer Counters { uint visibleCount; uint drawCount; uint dispatchX; uint dispatchY; uint dispatchZ; uint frustumCulled; uint occlusionCulled; };
@@ -0,0 +1,14 @@
+#version 330 core
+// Lines relative to the view origin, like the scene.
+layout(location = 0) in vec3 aPosition;
+layout(location = 1) in vec4 aColor;
+
+uniform mat4 uViewProjection;
+uniform vec3 uViewOrigin;
+
+out vec4 vColor;
+
+void main() {
+    vColor = aColor;
+    gl_Position = uViewProjection * vec4(aPosition - uViewOrigin, 1.0);
+}
@@ -0,0 +1,22 @@
+#version 330 core
+// Glyph quads: each vertex is its anchor projected, then offset in pixels.
+layout(location = 0) in vec3 aAnchor;
+layout(location = 1) in vec4 aColor;
+layout(location = 2) in vec2 aOffset;
+
+uniform mat4 uViewProjection;
+uniform vec3 uViewOrigin;
+uniform vec2 uPixelToClip;
+
+out vec4 vColor;
+
+void main() {
+    vColor = aColor;
+    vec4 clip = uViewProjection * vec4(aAnchor - uViewOrigin, 1.0);
+    // Anchors behind the camera would mirror onto the screen
+    if (clip.w <= 0.0) {
+        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+        return;
+    }
+    gl_Position = vec4(clip.xy + aOffset * uPixelToClip * clip.w, clip.zw);
+}
@@ -0,0 +1,4 @@
+#version 330 core
+// Shadow maps only need depth.
+void main() {
+}
@@ -0,0 +1,44 @@
+#version 330 core
+// FXAA in its compact form: blur along the local edge direction found from the luma of the
+// four diagonal neighbours, keeping the wider blur only if it stays within their range.
+in vec2 vUV;
+
+uniform sampler2D uSource;
+uniform vec4 uSourceRect;
+uniform vec2 uTexelSize;
+
+out vec4 FragColor;
+
+const float ReduceMin = 1.0 / 128.0;
+const float ReduceMultiplier = 1.0 / 8.0;
+const float SpanMax = 8.0;
+
+vec3 Sample(vec2 uv) {
+    return texture(uSource, min(uv, uSourceRect.zw)).rgb;
+}
+
+float Luma(vec3 color) {
+    return dot(color, vec3(0.299, 0.587, 0.114));
+}
+
+void main() {
+    vec2 uv = vUV * uSourceRect.xy;
+    vec3 center = Sample(uv);
+    float lumaNW = Luma(Sample(uv + vec2(-1.0, -1.0) * uTexelSize));
+    float lumaNE = Luma(Sample(uv + vec2(1.0, -1.0) * uTexelSize));
+    float lumaSW = Luma(Sample(uv + vec2(-1.0, 1.0) * uTexelSize));
+    float lumaSE = Luma(Sample(uv + vec2(1.0, 1.0) * uTexelSize));
+    float lumaM = Luma(center);
+    float lumaMin = min(lumaM, min(min(lumaNW, lumaNE), min(lumaSW, lumaSE)));
+    float lumaMax = max(lumaM, max(max(lumaNW, lumaNE), max(lumaSW, lumaSE)));
+
+    vec2 direction = vec2(-((lumaNW + lumaNE) - (lumaSW + lumaSE)), (lumaNW + lumaSW) - (lumaNE + lumaSE));
+    float reduce = max((lumaNW + lumaNE + lumaSW + lumaSE) * 0.25 * ReduceMultiplier, ReduceMin);
+    float scale = 1.0 / (min(abs(direction.x), abs(direction.y)) + reduce);
+    direction = clamp(direction * scale, vec2(-SpanMax), vec2(SpanMax)) * uTexelSize;
+
+    vec3 near = 0.5 * (Sample(uv + direction * (1.0 / 3.0 - 0.5)) + Sample(uv + direction * (2.0 / 3.0 - 0.5)));
+    vec3 wide = near * 0.5 + 0.25 * (Sample(uv - direction * 0.5) + Sample(uv + direction * 0.5));
+    float lumaWide = Luma(wide);
+    FragColor = vec4(lumaWide < lumaMin || lumaWide > lumaMax ? near : wide, 1.0);
+}
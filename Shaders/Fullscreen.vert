@@ -0,0 +1,9 @@
+#version 330 core
+// One triangle covering the target, generated from gl_VertexID.
+out vec2 vUV;
+
+void main() {
+    vec2 position = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    vUV = position;
+    gl_Position = vec4(position * 2.0 - 1.0, 0.0, 1.0);
+}
@@ -0,0 +1,20 @@
+#version 330 core
+// Weights samples by 1 / (1 + brightest channel) so one very bright sample cannot dominate an
+// edge pixel once tonemapped.
+uniform sampler2DMS uSource;
+uniform int uSamples;
+
+out vec4 FragColor;
+
+void main() {
+    ivec2 texel = ivec2(gl_FragCoord.xy);
+    vec3 sum = vec3(0.0);
+    float weight = 0.0;
+    for (int i = 0; i < uSamples; ++i) {
+        vec3 color = texelFetch(uSource, texel, i).rgb;
+        float w = 1.0 / (1.0 + max(color.r, max(color.g, color.b)));
+        sum += color * w;
+        weight += w;
+    }
+    FragColor = vec4(sum / weight, 1.0);
+}
@@ -0,0 +1,7 @@
+#version 330 core
+// Depth-only pass into the Hi-Z target: same vertex stage as the scene, depth written as colour.
+out float Depth;
+
+void main() {
+    Depth = gl_FragCoord.z;
+}
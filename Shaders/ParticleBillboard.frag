@@ -0,0 +1,13 @@
+#version 330 core
+in vec4 vColor;
+in vec2 vCorner;
+
+out vec4 FragColor;
+
+void main() {
+    float Falloff = 1.0 - dot(vCorner, vCorner);
+    if (Falloff <= 0.0) {
+        discard;
+    }
+    FragColor = vec4(vColor.rgb, vColor.a * Falloff);
+}
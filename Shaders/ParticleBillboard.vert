@@ -0,0 +1,29 @@
+#version 330 core
+// The quad's corner comes from gl_VertexID; everything per particle is an instance attribute.
+// Position and age are four float attributes so the CPU path can feed them from separate
+// streams and the compute path from one vec4 stream.
+layout(location = 0) in float aPositionX;
+layout(location = 1) in float aPositionY;
+layout(location = 2) in float aPositionZ;
+layout(location = 3) in float aAge;
+layout(location = 4) in uint aEmitter;
+
+uniform mat4 uViewProjection;
+uniform vec3 uViewOrigin;
+uniform vec3 uCameraRight;
+uniform vec3 uCameraUp;
+uniform samplerBuffer uEmitters;
+
+out vec4 vColor;
+out vec2 vCorner;
+
+void main() {
+    int Row = int(aEmitter) * 4;
+    vColor = mix(texelFetch(uEmitters, Row), texelFetch(uEmitters, Row + 1), aAge);
+    vec4 Size = texelFetch(uEmitters, Row + 2);
+    float Radius = mix(Size.x, Size.y, aAge) * 0.5;
+
+    vCorner = vec2(float(gl_VertexID & 1), float(gl_VertexID >> 1)) * 2.0 - 1.0;
+    vec3 World = vec3(aPositionX, aPositionY, aPositionZ) + (uCameraRight * vCorner.x + uCameraUp * vCorner.y) * Radius;
+    gl_Position = uViewProjection * vec4(World - uViewOrigin, 1.0);
+}
@@ -0,0 +1,4 @@
+// Declarations every particle kernel shares: the spawn batch layout and the counters of the
+// set being written.
+struct SpawnBatch { vec4 PositionCosSpread; vec4 DirectionSpeedMin; vec4 SpeedLifetimeRadius; uint Emitter; uint FirstParticle; uint Count; uint Seed; };
+layout(std430, binding = 7) buffer Counters { uint vertexCount; uint count; uint firstVertex; uint baseInstance; uint dispatchX; uint dispatchY; uint dispatchZ; };
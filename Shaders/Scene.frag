@@ -0,0 +1,18 @@
+// No #version: the renderer puts it first, followed by MaterialSystem's extensions and
+// generated material declarations (GetMaterial, SampleBaseColorTexture).
+#include "ClusteredLighting.glsl"
+#include "CascadedShadows.glsl"
+
+in vec3 vNormal;
+in vec3 vWorldPosition;
+in float vViewDepth;
+in vec2 vTexCoord;
+flat in uint vMaterial;
+out vec4 FragColor;
+
+void main() {
+    MaterialData material = GetMaterial(vMaterial);
+    vec3 albedo = material.BaseColor.rgb * SampleBaseColorTexture(material, vTexCoord).rgb;
+    float shadow = ComputeShadow(vWorldPosition, vNormal, vViewDepth);
+    FragColor = vec4(ComputeLighting(albedo, vWorldPosition, vNormal, vViewDepth, shadow), material.BaseColor.a);
+}
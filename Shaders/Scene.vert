@@ -0,0 +1,47 @@
+// No #version: the renderer puts it first, 430 with GPU_DRIVEN defined and 330 without.
+layout(location = 0) in vec3 aPosition;
+layout(location = 1) in vec3 aNormal;
+layout(location = 7) in vec2 aTexCoord;
+
+#ifdef GPU_DRIVEN
+// Instances are fetched from the same SSBO the culling kernels read (binding 0), indexed by
+// the per-instance id attribute that the compacted commands offset with BaseInstance.
+layout(location = 2) in uint aInstance;
+
+struct Instance { mat4 Model; vec4 BoundsCenter; vec4 BoundsExtent; uint MeshIndex; uint Flags; uint MaterialIndex; uint Pad0; };
+layout(std430, binding = 0) readonly buffer Instances { Instance instances[]; };
+#else
+layout(location = 3) in mat4 aModel;
+layout(location = 8) in uint aMaterial;
+#endif
+
+// Camera-relative: world positions are taken relative to uViewOrigin before either matrix
+layout(std140) uniform ViewBlock {
+    mat4 uViewProjection;
+    mat4 uView;
+    vec4 uViewOrigin;
+};
+
+out vec3 vNormal;
+out vec3 vWorldPosition;
+out float vViewDepth;
+out vec2 vTexCoord;
+flat out uint vMaterial;
+
+void main() {
+#ifdef GPU_DRIVEN
+    mat4 model = instances[aInstance].Model;
+    uint material = instances[aInstance].MaterialIndex;
+#else
+    mat4 model = aModel;
+    uint material = aMaterial;
+#endif
+    vec4 worldPosition = model * vec4(aPosition, 1.0);
+    vNormal = mat3(model) * aNormal;
+    vec4 relativePosition = vec4(worldPosition.xyz - uViewOrigin.xyz, 1.0);
+    vWorldPosition = worldPosition.xyz;
+    vViewDepth = -(uView * relativePosition).z;
+    vTexCoord = aTexCoord;
+    vMaterial = material;
+    gl_Position = uViewProjection * relativePosition;
+}
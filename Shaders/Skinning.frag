@@ -0,0 +1,12 @@
+#version 330 core
+in vec3 vNormal;
+
+uniform vec4 uColor;
+uniform vec3 uLightDirection;
+
+out vec4 FragColor;
+
+void main() {
+    float Diffuse = max(dot(normalize(vNormal), uLightDirection), 0.0);
+    FragColor = vec4(uColor.rgb * (0.25 + 0.75 * Diffuse), uColor.a);
+}
@@ -0,0 +1,34 @@
+#version 330 core
+// Each joint is a row-major 3x4 matrix in three texels. The weighted rows are blended first,
+// so a vertex costs one blend and three dot products however many joints it has.
+layout(location = 0) in vec3 aPosition;
+layout(location = 1) in vec3 aNormal;
+layout(location = 3) in uvec4 aJoints;
+layout(location = 4) in vec4 aWeights;
+
+uniform mat4 uViewProjection;
+uniform vec3 uViewOrigin;
+uniform samplerBuffer uPalette;
+uniform int uPaletteBase;
+// Each drawn instance's palette offset in joints; the view's list starts at uViewPaletteBase
+uniform usamplerBuffer uViewInstances;
+uniform int uViewPaletteBase;
+
+out vec3 vNormal;
+
+void main() {
+    int Base = uPaletteBase + int(texelFetch(uViewInstances, uViewPaletteBase + gl_InstanceID).r) * 3;
+    vec4 Row0 = vec4(0.0);
+    vec4 Row1 = vec4(0.0);
+    vec4 Row2 = vec4(0.0);
+    for (int i = 0; i < 4; ++i) {
+        int Texel = Base + int(aJoints[i]) * 3;
+        Row0 += texelFetch(uPalette, Texel) * aWeights[i];
+        Row1 += texelFetch(uPalette, Texel + 1) * aWeights[i];
+        Row2 += texelFetch(uPalette, Texel + 2) * aWeights[i];
+    }
+    vec4 Position = vec4(aPosition, 1.0);
+    vec3 World = vec3(dot(Row0, Position), dot(Row1, Position), dot(Row2, Position));
+    vNormal = vec3(dot(Row0.xyz, aNormal), dot(Row1.xyz, aNormal), dot(Row2.xyz, aNormal));
+    gl_Position = uViewProjection * vec4(World - uViewOrigin, 1.0);
+}
@@ -0,0 +1,54 @@
+#version 330 core
+// Reprojects the history with the camera motion (the scene has no motion vectors, so moving
+// objects rely on the neighbourhood clamp), clamps it to this frame's 3x3 neighbourhood and
+// blends in the new frame, weighted by inverse luminance against flicker. The history may have
+// been rendered at another scale; its rect accounts for that.
+in vec2 vUV;
+
+uniform sampler2D uCurrent;
+// Shared by the scene depth, which has the same size
+uniform vec4 uCurrentRect;
+uniform sampler2D uHistory;
+uniform vec4 uHistoryRect;
+uniform sampler2D uDepth;
+// (uv, depth) this frame to (uv, depth) last frame, homogeneous
+uniform mat4 uReprojection;
+uniform vec2 uTexelSize;
+uniform float uBlend;
+uniform bool uHistoryValid;
+
+out vec4 FragColor;
+
+float Luminance(vec3 color) {
+    return dot(color, vec3(0.2126, 0.7152, 0.0722));
+}
+
+void main() {
+    vec2 currentUV = vUV * uCurrentRect.xy;
+    vec3 current = texture(uCurrent, currentUV).rgb;
+    vec3 low = current;
+    vec3 high = current;
+    // Nearest depth around the pixel (reverse-Z: largest), so edges reproject with the
+    // foreground
+    float depth = 0.0;
+    for (int y = -1; y <= 1; ++y) {
+        for (int x = -1; x <= 1; ++x) {
+            vec2 uv = min(currentUV + vec2(x, y) * uTexelSize, uCurrentRect.zw);
+            vec3 neighbour = texture(uCurrent, uv).rgb;
+            low = min(low, neighbour);
+            high = max(high, neighbour);
+            depth = max(depth, texture(uDepth, uv).r);
+        }
+    }
+
+    vec4 previous = uReprojection * vec4(vUV, depth, 1.0);
+    vec2 historyUV = previous.xy / previous.w;
+    if (!uHistoryValid || previous.w <= 0.0 || any(lessThan(historyUV, vec2(0.0))) || any(greaterThan(historyUV, vec2(1.0)))) {
+        FragColor = vec4(current, 1.0);
+        return;
+    }
+    vec3 history = clamp(texture(uHistory, min(historyUV * uHistoryRect.xy, uHistoryRect.zw)).rgb, low, high);
+    float currentWeight = uBlend / (1.0 + Luminance(current));
+    float historyWeight = (1.0 - uBlend) / (1.0 + Luminance(history));
+    FragColor = vec4((current * currentWeight + history * historyWeight) / (currentWeight + historyWeight), 1.0);
+}
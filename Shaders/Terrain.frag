@@ -0,0 +1,18 @@
+#version 330 core
+in vec3 vPosition;
+in vec3 vNormal;
+
+uniform vec3 uLightDirection;
+uniform vec2 uHeightRange;
+
+out vec4 FragColor;
+
+void main() {
+    vec3 Normal = normalize(vNormal);
+    float Slope = 1.0 - Normal.y;
+    float Altitude = clamp((vPosition.y - uHeightRange.x) / uHeightRange.y, 0.0, 1.0);
+    vec3 Color = mix(vec3(0.30, 0.42, 0.20), vec3(0.42, 0.38, 0.34), smoothstep(0.15, 0.35, Slope));
+    Color = mix(Color, vec3(0.92), smoothstep(0.7, 0.8, Altitude) * (1.0 - smoothstep(0.3, 0.5, Slope)));
+    float Diffuse = max(dot(Normal, uLightDirection), 0.0);
+    FragColor = vec4(Color * (0.25 + 0.75 * Diffuse), 1.0);
+}
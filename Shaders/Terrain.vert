@@ -0,0 +1,61 @@
+#version 330 core
+// aGrid is the vertex's cell position in the node, 0..uGridResolution. Odd vertices slide onto
+// their even neighbours as Morph goes to 1, turning the grid into its parent's at half the
+// resolution, so a node matches a coarser neighbour exactly where they meet.
+layout(location = 0) in vec2 aGrid;
+
+uniform mat4 uViewProjection;
+uniform vec3 uViewOrigin;
+uniform vec3 uCameraPosition;
+uniform samplerBuffer uNodes;
+uniform int uNodeBase;
+uniform float uGridResolution;
+// Per level: distance the morph starts at, and 1 / the distance it takes
+uniform vec2 uMorph[16];
+
+uniform vec2 uOrigin;
+uniform float uWorldSize;
+uniform vec2 uHeightRange;
+uniform sampler2D uOverview;
+uniform float uOverviewResolution;
+uniform sampler2DArray uTiles;
+uniform isampler2D uTileTable;
+uniform float uTileSize;
+uniform float uTileResolution;
+uniform int uTilesPerSide;
+
+out vec3 vPosition;
+out vec3 vNormal;
+
+float SampleHeight(vec2 Position) {
+    vec2 Local = Position - uOrigin;
+    ivec2 Tile = clamp(ivec2(floor(Local / uTileSize)), ivec2(0), ivec2(uTilesPerSide - 1));
+    int Layer = texelFetch(uTileTable, Tile, 0).r;
+    float Value;
+    if (Layer >= 0) {
+        vec2 Texel = (Local - vec2(Tile) * uTileSize) / uTileSize * uTileResolution;
+        Value = texture(uTiles, vec3((Texel + 0.5) / (uTileResolution + 1.0), float(Layer))).r;
+    } else {
+        vec2 Texel = Local / uWorldSize * (uOverviewResolution - 1.0);
+        Value = texture(uOverview, (Texel + 0.5) / uOverviewResolution).r;
+    }
+    return uHeightRange.x + Value * uHeightRange.y;
+}
+
+void main() {
+    vec4 Node = texelFetch(uNodes, uNodeBase + gl_InstanceID);
+    int Level = int(Node.w);
+    float CellSize = Node.z / uGridResolution;
+    vec2 Position = Node.xy + aGrid * CellSize;
+
+    float Distance = distance(vec3(Position.x, SampleHeight(Position), Position.y), uCameraPosition);
+    float Morph = clamp((Distance - uMorph[Level].x) * uMorph[Level].y, 0.0, 1.0);
+    Position -= fract(aGrid * 0.5) * 2.0 * Morph * CellSize;
+
+    float Height = SampleHeight(Position);
+    float DeltaX = SampleHeight(Position + vec2(CellSize, 0.0)) - SampleHeight(Position - vec2(CellSize, 0.0));
+    float DeltaZ = SampleHeight(Position + vec2(0.0, CellSize)) - SampleHeight(Position - vec2(0.0, CellSize));
+    vNormal = vec3(-DeltaX, 2.0 * CellSize, -DeltaZ);
+    vPosition = vec3(Position.x, Height, Position.y);
+    gl_Position = uViewProjection * vec4(vPosition - uViewOrigin, 1.0);
+}
@@ -0,0 +1,35 @@
+#version 330 core
+in vec2 vUV;
+
+uniform sampler2D uScene;
+uniform vec4 uSceneRect;
+uniform sampler2D uBloom;
+uniform vec4 uBloomRect;
+uniform float uBloomIntensity;
+uniform float uExposure;
+// 0: clamp, 1: Reinhard, 2: ACES
+uniform int uOperator;
+
+out vec4 FragColor;
+
+vec3 Tonemap(vec3 color) {
+    if (uOperator == 1) {
+        return color / (1.0 + color);
+    }
+    if (uOperator == 2) {
+        return clamp(color * (2.51 * color + 0.03) / (color * (2.43 * color + 0.59) + 0.14), 0.0, 1.0);
+    }
+    return clamp(color, 0.0, 1.0);
+}
+
+vec3 EncodeSrgb(vec3 color) {
+    return mix(color * 12.92, 1.055 * pow(color, vec3(1.0 / 2.4)) - 0.055, step(vec3(0.0031308), color));
+}
+
+void main() {
+    vec3 color = texture(uScene, min(vUV * uSceneRect.xy, uSceneRect.zw)).rgb;
+    if (uBloomIntensity > 0.0) {
+        color += texture(uBloom, min(vUV * uBloomRect.xy, uBloomRect.zw)).rgb * uBloomIntensity;
+    }
+    FragColor = vec4(EncodeSrgb(Tonemap(color * uExposure)), 1.0);
+}
@@ -0,0 +1,33 @@
+#version 330 core
+// Bilinear upscale to the output, sharpened to win back some of the detail the lower
+// resolution lost: an unsharp mask over the source's four neighbours, clamped to their range
+// so edges do not ring.
+in vec2 vUV;
+
+uniform sampler2D uSource;
+uniform vec4 uSourceRect;
+uniform vec2 uTexelSize;
+uniform float uSharpness;
+
+out vec4 FragColor;
+
+vec3 Sample(vec2 uv) {
+    return texture(uSource, min(uv, uSourceRect.zw)).rgb;
+}
+
+void main() {
+    vec2 uv = vUV * uSourceRect.xy;
+    vec3 center = Sample(uv);
+    if (uSharpness <= 0.0) {
+        FragColor = vec4(center, 1.0);
+        return;
+    }
+    vec3 north = Sample(uv + vec2(0.0, uTexelSize.y));
+    vec3 south = Sample(uv - vec2(0.0, uTexelSize.y));
+    vec3 east = Sample(uv + vec2(uTexelSize.x, 0.0));
+    vec3 west = Sample(uv - vec2(uTexelSize.x, 0.0));
+    vec3 low = min(center, min(min(north, south), min(east, west)));
+    vec3 high = max(center, max(max(north, south), max(east, west)));
+    vec3 sharpened = center + (center * 4.0 - north - south - east - west) * (uSharpness * 0.25);
+    FragColor = vec4(clamp(sharpened, low, high), 1.0);
+}
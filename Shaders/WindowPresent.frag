@@ -0,0 +1,9 @@
+#version 330 core
+// One canvas texel per window pixel; the region is exactly the window's framebuffer size
+uniform sampler2D uCanvas;
+uniform vec2 uOrigin;
+out vec4 FragColor;
+
+void main() {
+    FragColor = texelFetch(uCanvas, ivec2(gl_FragCoord.xy + uOrigin), 0);
+}
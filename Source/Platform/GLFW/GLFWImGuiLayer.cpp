@@ -0,0 +1,75 @@
+#include "GLFWImGuiLayer.h"
+
+#include <GLFW/glfw3.h>
+#include <imgui.h>
+#include <imgui_impl_glfw.h>
+#include <imgui_impl_opengl3.h>
+
+#include <iostream>
+
+namespace Volante
+{
+
+GLFWImGuiLayer::GLFWImGuiLayer(IWindow* window) : Window(window)
+{
+}
+
+GLFWImGuiLayer::~GLFWImGuiLayer()
+{
+    Shutdown();
+}
+
+bool GLFWImGuiLayer::Initialize()
+{
+    IMGUI_CHECKVERSION();
+    ImGui::CreateContext();
+    // Overlay placement is not worth an imgui.ini next to the executable
+    ImGui::GetIO().IniFilename = nullptr;
+    ImGui::StyleColorsDark();
+
+    // Installed after GLFWWindow's callbacks, so ImGui chains to them
+    auto* Handle = static_cast<GLFWwindow*>(Window->GetNativeHandle());
+    if (!ImGui_ImplGlfw_InitForOpenGL(Handle, true) || !ImGui_ImplOpenGL3_Init("#version 330 core"))
+    {
+        std::cerr << "ERROR::IMGUI::INITIALIZATION_FAILED" << std::endl;
+        ImGui::DestroyContext();
+        return false;
+    }
+    Initialized = true;
+    return true;
+}
+
+void GLFWImGuiLayer::Shutdown()
+{
+    if (!Initialized)
+    {
+        return;
+    }
+    ImGui_ImplOpenGL3_Shutdown();
+    ImGui_ImplGlfw_Shutdown();
+    ImGui::DestroyContext();
+    Initialized = false;
+}
+
+void GLFWImGuiLayer::BeginFrame()
+{
+    if (!Initialized)
+    {
+        return;
+    }
+    ImGui_ImplOpenGL3_NewFrame();
+    ImGui_ImplGlfw_NewFrame();
+    ImGui::NewFrame();
+}
+
+void GLFWImGuiLayer::EndFrame()
+{
+    if (!Initialized)
+    {
+        return;
+    }
+    ImGui::Render();
+    ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+}
+
+} // namespace Volante
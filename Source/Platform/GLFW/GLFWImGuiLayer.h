@@ -0,0 +1,32 @@
+#pragma once
+
+#include "Runtime/Core/HAL/IWindow.h"
+
+namespace Volante
+{
+
+// Dear ImGui on a GLFW window with the OpenGL 3 renderer. Owns the ImGui context; widgets are
+// built between BeginFrame and EndFrame, on the thread that owns the GL context.
+class GLFWImGuiLayer
+{
+public:
+    explicit GLFWImGuiLayer(IWindow* window);
+    ~GLFWImGuiLayer();
+
+    GLFWImGuiLayer(const GLFWImGuiLayer&) = delete;
+    GLFWImGuiLayer& operator=(const GLFWImGuiLayer&) = delete;
+
+    // The window's context must be current.
+    bool Initialize();
+    void Shutdown();
+
+    void BeginFrame();
+    // Draws into the bound framebuffer
+    void EndFrame();
+
+private:
+    IWindow* Window;
+    bool Initialized = false;
+};
+
+} // namespace Volante
@@ -2,7 +2,6 @@
 
 #include <memory>
 #include <stdexcept>
-#include <unordered_map>
 
 #include "GLFWKeyMapper.h"
 
@@ -41,16 +40,50 @@ private:
     bool Initialized = false;
 };
 
+// Hints persist between windows, so each starts from the defaults
+static void setContextHints()
+{
+    glfwDefaultWindowHints();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+#ifdef __APPLE__
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+#endif
+}
+
 //================================================================
 // GLFWContext
 //================================================================
-GLFWContext::GLFWContext(GLFWwindow* window) : window_(window)
+GLFWContext::GLFWContext(GLFWwindow* window, bool ownsWindow) : window_(window), ownsWindow_(ownsWindow)
+{
+}
+
+GLFWContext::~GLFWContext()
 {
+    if (ownsWindow_)
+    {
+        glfwDestroyWindow(window_);
+    }
 }
 
 void GLFWContext::MakeCurrent()
 {
     glfwMakeContextCurrent(window_);
+    if (pendingInterval_ >= 0)
+    {
+        glfwSwapInterval(pendingInterval_);
+        pendingInterval_ = -1;
+    }
+}
+
+void GLFWContext::ReleaseCurrent()
+{
+    if (glfwGetCurrentContext() == window_)
+    {
+        glfwMakeContextCurrent(nullptr);
+    }
 }
 
 void GLFWContext::SwapBuffers()
@@ -60,41 +93,54 @@ void GLFWContext::SwapBuffers()
 
 void GLFWContext::SetVSync(bool enabled)
 {
-    glfwSwapInterval(enabled ? 1 : 0);
+    SetSwapInterval(enabled ? 1 : 0);
+}
+
+void GLFWContext::SetSwapInterval(int interval)
+{
+    if (glfwGetCurrentContext() == window_)
+    {
+        glfwSwapInterval(interval);
+    }
+    else
+    {
+        pendingInterval_ = interval;
+    }
 }
 
 //================================================================
 // GLFWWindow
 //================================================================
-std::unordered_map<GLFWwindow*, GLFWWindow*> GLFWWindow::Registry;
-
 GLFWWindow::GLFWWindow(const WindowDesc& windowDesc)
 {
     GLFWInitializer::Initialize();
 
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-#ifdef __APPLE__
-    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-#endif
+    setContextHints();
+    glfwWindowHint(GLFW_VISIBLE, windowDesc.visible ? GLFW_TRUE : GLFW_FALSE);
 
     if (windowDesc.samples > 1)
     {
         glfwWindowHint(GLFW_SAMPLES, windowDesc.samples);
     }
 
-    GLFWmonitor* monitor = windowDesc.fullscreen ? glfwGetPrimaryMonitor() : nullptr;
+    GLFWmonitor* monitor = nullptr;
+    if (windowDesc.fullscreen)
+    {
+        int monitorCount = 0;
+        GLFWmonitor** monitors = glfwGetMonitors(&monitorCount);
+        monitor = windowDesc.monitor > 0 && windowDesc.monitor < monitorCount ? monitors[windowDesc.monitor]
+                                                                                : glfwGetPrimaryMonitor();
+    }
+    GLFWwindow* share = windowDesc.share ? static_cast<GLFWwindow*>(windowDesc.share->GetNativeHandle()) : nullptr;
     Window = glfwCreateWindow(windowDesc.width, windowDesc.height,
-                              windowDesc.title.c_str(), monitor, nullptr);
+                              windowDesc.title.c_str(), monitor, share);
 
     if (!Window)
     {
         throw std::runtime_error("Failed to create GLFW window");
     }
 
-    Registry[Window] = this;
+    glfwSetWindowUserPointer(Window, this);
 
     Context = std::make_unique<GLFWContext>(Window);
     Context->MakeCurrent();
@@ -125,7 +171,6 @@ GLFWWindow::~GLFWWindow()
 {
     if (Window)
     {
-        Registry.erase(Window);
         glfwDestroyWindow(Window);
     }
 }
@@ -180,6 +225,19 @@ IGraphicsContext* GLFWWindow::GetGraphicsContext() const
     return Context.get();
 }
 
+std::unique_ptr<IGraphicsContext> GLFWWindow::CreateSharedContext() const
+{
+    // GLFW contexts come with a window; this one is never shown
+    setContextHints();
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    GLFWwindow* hidden = glfwCreateWindow(1, 1, "", nullptr, Window);
+    if (!hidden)
+    {
+        throw std::runtime_error("Failed to create shared GLFW context");
+    }
+    return std::make_unique<GLFWContext>(hidden, true);
+}
+
 void GLFWWindow::SwapBuffers()
 {
     Context->SwapBuffers();
@@ -220,37 +278,40 @@ void GLFWWindow::SetCursorPosCallback(const CursorPosCallback& callback)
     cursorPosCallback_ = callback;
 }
 
+GLFWWindow* GLFWWindow::fromHandle(GLFWwindow* window)
+{
+    return static_cast<GLFWWindow*>(glfwGetWindowUserPointer(window));
+}
+
 void GLFWWindow::GLFWResizeCallback(GLFWwindow* window, int width, int height)
 {
-    if (const auto It = Registry.find(window); It != Registry.end() && It->second->resizeCallback_)
+    if (const GLFWWindow* self = fromHandle(window); self && self->resizeCallback_)
     {
-        It->second->resizeCallback_(width, height);
+        self->resizeCallback_(width, height);
     }
 }
 
 void GLFWWindow::GLFWKeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods)
 {
-    if (const auto It = Registry.find(window); It != Registry.end() && It->second->keyCallback_)
+    if (const GLFWWindow* self = fromHandle(window); self && self->keyCallback_)
     {
-        It->second->keyCallback_(GLFWKeyMapper::FromGLFWKey(key), GLFWKeyMapper::FromGLFWAction(action));
+        self->keyCallback_(GLFWKeyMapper::FromGLFWKey(key), GLFWKeyMapper::FromGLFWAction(action));
     }
 }
 
 void GLFWWindow::GLFWMouseButtonCallback(GLFWwindow* window, int button, int action, int mods)
 {
-    if (const auto It = Registry.find(window);
-        It != Registry.end() && It->second->mouseButtonCallback_)
+    if (const GLFWWindow* self = fromHandle(window); self && self->mouseButtonCallback_)
     {
-        It->second->mouseButtonCallback_(GLFWKeyMapper::FromGLFWButton(button), GLFWKeyMapper::FromGLFWAction(action));
+        self->mouseButtonCallback_(GLFWKeyMapper::FromGLFWButton(button), GLFWKeyMapper::FromGLFWAction(action));
     }
 }
 
 void GLFWWindow::GLFWCursorPosCallback(GLFWwindow* window, double xpos, double ypos)
 {
-    if (const auto It = Registry.find(window);
-        It != Registry.end() && It->second->cursorPosCallback_)
+    if (const GLFWWindow* self = fromHandle(window); self && self->cursorPosCallback_)
     {
-        It->second->cursorPosCallback_(xpos, ypos);
+        self->cursorPosCallback_(xpos, ypos);
     }
 }
 
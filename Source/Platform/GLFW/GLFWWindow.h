@@ -4,7 +4,6 @@
 #include <GLFW/glfw3.h>
 
 #include <memory>
-#include <unordered_map>
 
 #include "Runtime/Core/HAL/IWindow.h"
 
@@ -14,15 +13,23 @@ namespace Volante
 class GLFWContext final : public IGraphicsContext
 {
 public:
-    explicit GLFWContext(GLFWwindow* window);
-    ~GLFWContext() override = default;
+    // With ownsWindow, the window is destroyed with the context: the hidden window behind a
+    // shared context.
+    explicit GLFWContext(GLFWwindow* window, bool ownsWindow = false);
+    ~GLFWContext() override;
 
     void MakeCurrent() override;
+    void ReleaseCurrent() override;
     void SwapBuffers() override;
     void SetVSync(bool enabled) override;
+    void SetSwapInterval(int interval) override;
 
 private:
     GLFWwindow* window_;
+    bool ownsWindow_;
+    // glfwSwapInterval sets the calling thread's current context; an interval set while
+    // another context is current waits for MakeCurrent
+    int pendingInterval_ = -1;
 };
 
 class GLFWWindow final : public IWindow
@@ -43,6 +50,7 @@ public:
 
     [[nodiscard]] void* GetNativeHandle() const override;
     [[nodiscard]] IGraphicsContext* GetGraphicsContext() const override;
+    [[nodiscard]] std::unique_ptr<IGraphicsContext> CreateSharedContext() const override;
     void SwapBuffers() override;
 
     void PollEvents() override;
@@ -55,13 +63,14 @@ public:
     void SetCursorPosCallback(const CursorPosCallback& Callback) override;
 
 private:
+    // Callbacks find their window through the GLFW user pointer
+    static GLFWWindow* fromHandle(GLFWwindow* window);
+
     static void GLFWResizeCallback(GLFWwindow* Window, int Width, int Height);
     static void GLFWKeyCallback(GLFWwindow* Window, int Key, int Scancode, int action, int Mods);
     static void GLFWMouseButtonCallback(GLFWwindow* Window, int Button, int action, int Mods);
     static void GLFWCursorPosCallback(GLFWwindow* Window, double XPos, double YPos);
 
-    static std::unordered_map<GLFWwindow*, GLFWWindow*> Registry;
-
     GLFWwindow* Window;
     std::unique_ptr<GLFWContext> Context;
 
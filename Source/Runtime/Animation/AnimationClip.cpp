@@ -0,0 +1,288 @@
+#include "AnimationClip.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Volante {
+
+namespace {
+
+constexpr float Sqrt2 = 1.41421356f;
+constexpr float InvSqrt2 = 0.70710678f;
+constexpr float RotationQuantum = 32767.0f;
+constexpr float VectorQuantum = 65535.0f;
+constexpr uint32_t Lanes = 4;
+
+// Smallest three: the largest component is dropped (and made positive, since q and -q are
+// the same rotation) and rebuilt from the unit length. The other three lie within
+// +-1/sqrt(2) and get 15 bits each; the dropped component's index rides in the top bits of the
+// first two values.
+void EncodeRotation(const float* Q, uint16_t (&Out)[3]) {
+    uint32_t Largest = 0;
+    for (uint32_t c = 1; c < 4; ++c) {
+        if (std::fabs(Q[c]) > std::fabs(Q[Largest])) { Largest = c; }
+    }
+    const float Sign = Q[Largest] < 0.0f ? -1.0f : 1.0f;
+    uint32_t Slot = 0;
+    for (uint32_t c = 0; c < 4; ++c) {
+        if (c == Largest) { continue; }
+        const float Normalized = (Q[c] * Sign * Sqrt2 + 1.0f) * 0.5f;
+        Out[Slot++] = static_cast<uint16_t>(std::lround(std::clamp(Normalized, 0.0f, 1.0f) * RotationQuantum));
+    }
+    Out[0] = static_cast<uint16_t>(Out[0] | (Largest & 1u) << 15);
+    Out[1] = static_cast<uint16_t>(Out[1] | (Largest >> 1) << 15);
+}
+
+void DecodeRotation(const uint16_t (&In)[3], float (&Q)[4]) {
+    const uint32_t Largest = (In[0] >> 15) | (In[1] >> 15) << 1;
+    float Sum = 0.0f;
+    uint32_t Slot = 0;
+    for (uint32_t c = 0; c < 4; ++c) {
+        if (c == Largest) { continue; }
+        Q[c] = (static_cast<float>(In[Slot++] & 0x7FFF) * (2.0f / RotationQuantum) - 1.0f) * InvSqrt2;
+        Sum += Q[c] * Q[c];
+    }
+    Q[Largest] = std::sqrt(std::max(0.0f, 1.0f - Sum));
+}
+
+float GetMaxError(const float* A, const float* B, uint32_t Dimensions) {
+    float Error = 0.0f;
+    for (uint32_t c = 0; c < Dimensions; ++c) {
+        Error = std::max(Error, std::fabs(A[c] - B[c]));
+    }
+    return Error;
+}
+
+// Frames a curve keeps: the first, the last and every frame that interpolating between the
+// kept keys around it would miss by more than Tolerance. Values holds Dimensions floats per
+// frame; rotations (Normalize) are compared after the nlerp sampling uses.
+std::vector<uint32_t> ReduceKeys(const std::vector<float>& Values, uint32_t Dimensions, uint32_t FrameCount,
+                                 float Tolerance, bool Normalize) {
+    const auto Value = [&](uint32_t Frame) { return &Values[Frame * Dimensions]; };
+
+    bool Constant = true;
+    for (uint32_t Frame = 1; Frame < FrameCount && Constant; ++Frame) {
+        Constant = GetMaxError(Value(0), Value(Frame), Dimensions) <= Tolerance;
+    }
+    if (Constant) { return {0}; }
+
+    const auto Fits = [&](uint32_t Start, uint32_t End) {
+        for (uint32_t Frame = Start + 1; Frame < End; ++Frame) {
+            const float Alpha = static_cast<float>(Frame - Start) / static_cast<float>(End - Start);
+            float Interpolated[4];
+            float LengthSquared = 0.0f;
+            for (uint32_t c = 0; c < Dimensions; ++c) {
+                Interpolated[c] = Value(Start)[c] + (Value(End)[c] - Value(Start)[c]) * Alpha;
+                LengthSquared += Interpolated[c] * Interpolated[c];
+            }
+            if (Normalize) {
+                const float InvLength = 1.0f / std::sqrt(LengthSquared);
+                for (uint32_t c = 0; c < Dimensions; ++c) { Interpolated[c] *= InvLength; }
+            }
+            if (GetMaxError(Interpolated, Value(Frame), Dimensions) > Tolerance) { return false; }
+        }
+        return true;
+    };
+
+    std::vector<uint32_t> Kept = {0};
+    uint32_t Start = 0;
+    for (uint32_t End = 2; End < FrameCount; ++End) {
+        if (!Fits(Start, End)) {
+            Start = End - 1;
+            Kept.push_back(Start);
+        }
+    }
+    Kept.push_back(FrameCount - 1);
+    return Kept;
+}
+
+} // namespace
+
+AnimationClip AnimationClip::Compress(const RawAnimationClip& Raw, const AnimationCompressionDesc& Desc) {
+    AnimationClip Clip;
+    Clip.SampleRate = Raw.SampleRate;
+    Clip.JointCount = Raw.JointCount;
+    Clip.FrameCount = std::min(Raw.FrameCount, MaxFrameCount);
+    Clip.Duration = Clip.FrameCount > 1 ? static_cast<float>(Clip.FrameCount - 1) / Clip.SampleRate : 0.0f;
+    Clip.Curves.resize(static_cast<size_t>(Clip.JointCount) * ChannelCount);
+    if (Clip.FrameCount == 0) { return Clip; }
+
+    std::vector<float> Values;
+    for (uint32_t Joint = 0; Joint < Clip.JointCount; ++Joint) {
+        const auto Transform = [&](uint32_t Frame) -> const JointTransform& { return Raw.Frames[static_cast<size_t>(Frame) * Raw.JointCount + Joint]; };
+
+        // Rotations, kept on one hemisphere so neighbouring keys interpolate the short way
+        Values.assign(static_cast<size_t>(Clip.FrameCount) * 4, 0.0f);
+        for (uint32_t Frame = 0; Frame < Clip.FrameCount; ++Frame) {
+            const Quat& Q = Transform(Frame).Rotation;
+            float* Out = &Values[Frame * 4];
+            const float InvLength = 1.0f / std::sqrt(Q.x * Q.x + Q.y * Q.y + Q.z * Q.z + Q.w * Q.w);
+            Out[0] = Q.x * InvLength;
+            Out[1] = Q.y * InvLength;
+            Out[2] = Q.z * InvLength;
+            Out[3] = Q.w * InvLength;
+            if (Frame > 0) {
+                const float* Previous = Out - 4;
+                if (Out[0] * Previous[0] + Out[1] * Previous[1] + Out[2] * Previous[2] + Out[3] * Previous[3] < 0.0f) {
+                    for (int c = 0; c < 4; ++c) { Out[c] = -Out[c]; }
+                }
+            }
+        }
+        Curve& Rotation = Clip.Curves[Joint * ChannelCount + RotationChannel];
+        Rotation.FirstKey = static_cast<uint32_t>(Clip.KeyFrames.size());
+        for (const uint32_t Frame : ReduceKeys(Values, 4, Clip.FrameCount, Desc.RotationTolerance, true)) {
+            QuantizedKey Key;
+            EncodeRotation(&Values[Frame * 4], Key.Values);
+            Clip.KeyFrames.push_back(static_cast<uint16_t>(Frame));
+            Clip.Keys.push_back(Key);
+        }
+        Rotation.KeyCount = static_cast<uint32_t>(Clip.KeyFrames.size()) - Rotation.FirstKey;
+
+        // Translations and scales, quantized across each curve's own range
+        for (const Channel VectorChannel : {TranslationChannel, ScaleChannel}) {
+            const bool IsTranslation = VectorChannel == TranslationChannel;
+            Values.assign(static_cast<size_t>(Clip.FrameCount) * 3, 0.0f);
+            for (uint32_t Frame = 0; Frame < Clip.FrameCount; ++Frame) {
+                const Vec3& Value = IsTranslation ? Transform(Frame).Translation : Transform(Frame).Scale;
+                for (int Axis = 0; Axis < 3; ++Axis) { Values[Frame * 3 + Axis] = Value[Axis]; }
+            }
+
+            Curve& Target = Clip.Curves[Joint * ChannelCount + VectorChannel];
+            for (int Axis = 0; Axis < 3; ++Axis) {
+                float Min = Values[Axis];
+                float Max = Values[Axis];
+                for (uint32_t Frame = 1; Frame < Clip.FrameCount; ++Frame) {
+                    Min = std::min(Min, Values[Frame * 3 + Axis]);
+                    Max = std::max(Max, Values[Frame * 3 + Axis]);
+                }
+                Target.Min[Axis] = Min;
+                Target.Extent[Axis] = Max - Min;
+            }
+
+            const float Tolerance = IsTranslation ? Desc.TranslationTolerance : Desc.ScaleTolerance;
+            Target.FirstKey = static_cast<uint32_t>(Clip.KeyFrames.size());
+            for (const uint32_t Frame : ReduceKeys(Values, 3, Clip.FrameCount, Tolerance, false)) {
+                QuantizedKey Key;
+                for (int Axis = 0; Axis < 3; ++Axis) {
+                    const float Range = Target.Extent[Axis];
+                    const float Normalized = Range > 0.0f ? (Values[Frame * 3 + Axis] - Target.Min[Axis]) / Range : 0.0f;
+                    Key.Values[Axis] = static_cast<uint16_t>(std::lround(std::clamp(Normalized, 0.0f, 1.0f) * VectorQuantum));
+                }
+                Clip.KeyFrames.push_back(static_cast<uint16_t>(Frame));
+                Clip.Keys.push_back(Key);
+            }
+            Target.KeyCount = static_cast<uint32_t>(Clip.KeyFrames.size()) - Target.FirstKey;
+        }
+    }
+    return Clip;
+}
+
+void AnimationClip::FindKeys(const Curve& Target, float Frame, uint32_t& KeyA, uint32_t& KeyB, float& Alpha) const {
+    const uint16_t* Frames = KeyFrames.data() + Target.FirstKey;
+    const uint16_t* Upper = std::upper_bound(Frames, Frames + Target.KeyCount, Frame,
+                                             [](float Value, uint16_t Key) { return Value < static_cast<float>(Key); });
+    const auto Index = static_cast<uint32_t>(Upper - Frames);
+    if (Index == 0 || Index == Target.KeyCount) {
+        KeyA = KeyB = Target.FirstKey + (Index == 0 ? 0 : Target.KeyCount - 1);
+        Alpha = 0.0f;
+        return;
+    }
+    KeyA = Target.FirstKey + Index - 1;
+    KeyB = Target.FirstKey + Index;
+    Alpha = (Frame - static_cast<float>(KeyFrames[KeyA])) / static_cast<float>(KeyFrames[KeyB] - KeyFrames[KeyA]);
+}
+
+void AnimationClip::Sample(float Time, bool Loop, AnimationPose& Pose) const {
+    if (Pose.GetJointCount() != JointCount) { Pose.Resize(JointCount); }
+    if (FrameCount == 0) { return; }
+
+    if (Loop && Duration > 0.0f) {
+        Time = std::fmod(Time, Duration);
+        if (Time < 0.0f) { Time += Duration; }
+    } else {
+        Time = std::clamp(Time, 0.0f, Duration);
+    }
+    const float Frame = Time * SampleRate;
+
+    const Float4 Zero = Float4::Zero();
+    const Float4 One = Float4::Splat(1.0f);
+    const Float4 VectorScale = Float4::Splat(1.0f / VectorQuantum);
+    SoaJointTransforms* Groups = Pose.GetGroups();
+    for (uint32_t g = 0; g < Pose.GetGroupCount(); ++g) {
+        SoaJointTransforms& Group = Groups[g];
+        const uint32_t First = g * Lanes;
+        const uint32_t Count = std::min(Lanes, JointCount - First);
+
+        // Rotations: decode both keys of every lane, then interpolate the four lanes together.
+        // Unused lanes decode to the identity.
+        alignas(16) float RotationA[4][4] = {{0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}, {1, 1, 1, 1}};
+        alignas(16) float RotationB[4][4] = {{0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}, {1, 1, 1, 1}};
+        alignas(16) float Alpha[Channel::ChannelCount][4] = {};
+        // Translation and scale: the raw 16-bit keys of both ends, and each curve's range
+        alignas(16) float QuantizedA[2][3][4] = {};
+        alignas(16) float QuantizedB[2][3][4] = {};
+        alignas(16) float Min[2][3][4] = {{{0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}}, {{1, 1, 1, 1}, {1, 1, 1, 1}, {1, 1, 1, 1}}};
+        alignas(16) float Extent[2][3][4] = {};
+
+        for (uint32_t Lane = 0; Lane < Count; ++Lane) {
+            const Curve* JointCurves = &Curves[(First + Lane) * ChannelCount];
+            uint32_t KeyA = 0;
+            uint32_t KeyB = 0;
+
+            FindKeys(JointCurves[RotationChannel], Frame, KeyA, KeyB, Alpha[RotationChannel][Lane]);
+            float Q[4];
+            DecodeRotation(Keys[KeyA].Values, Q);
+            for (int c = 0; c < 4; ++c) { RotationA[c][Lane] = Q[c]; }
+            DecodeRotation(Keys[KeyB].Values, Q);
+            for (int c = 0; c < 4; ++c) { RotationB[c][Lane] = Q[c]; }
+
+            for (uint32_t v = 0; v < 2; ++v) {
+                const Curve& Target = JointCurves[TranslationChannel + v];
+                FindKeys(Target, Frame, KeyA, KeyB, Alpha[TranslationChannel + v][Lane]);
+                for (int Axis = 0; Axis < 3; ++Axis) {
+                    QuantizedA[v][Axis][Lane] = Keys[KeyA].Values[Axis];
+                    QuantizedB[v][Axis][Lane] = Keys[KeyB].Values[Axis];
+                    Min[v][Axis][Lane] = Target.Min[Axis];
+                    Extent[v][Axis][Lane] = Target.Extent[Axis];
+                }
+            }
+        }
+
+        // Keys are stored on whichever hemisphere keeps their largest component positive, so
+        // neighbours may disagree in sign; blend towards A's side
+        Float4 A[4];
+        Float4 B[4];
+        for (int c = 0; c < 4; ++c) {
+            A[c] = Float4::Load(RotationA[c]);
+            B[c] = Float4::Load(RotationB[c]);
+        }
+        const Float4 RotationAlpha = Float4::Load(Alpha[RotationChannel]);
+        const Float4 Cosine = A[0] * B[0] + A[1] * B[1] + A[2] * B[2] + A[3] * B[3];
+        const Float4 WeightB = Select(Cosine < Zero, -RotationAlpha, RotationAlpha);
+        const Float4 WeightA = One - RotationAlpha;
+        Float4 Rotation[4];
+        for (int c = 0; c < 4; ++c) { Rotation[c] = A[c] * WeightA + B[c] * WeightB; }
+        const Float4 InvLength = One / Sqrt(Rotation[0] * Rotation[0] + Rotation[1] * Rotation[1] +
+                                            Rotation[2] * Rotation[2] + Rotation[3] * Rotation[3]);
+        for (int c = 0; c < 4; ++c) { (Rotation[c] * InvLength).Store(Group.Rotation[c]); }
+
+        for (uint32_t v = 0; v < 2; ++v) {
+            const Float4 VectorAlpha = Float4::Load(Alpha[TranslationChannel + v]);
+            float(*Out)[4] = v == 0 ? Group.Translation : Group.Scale;
+            for (int Axis = 0; Axis < 3; ++Axis) {
+                const Float4 Range = Float4::Load(Extent[v][Axis]) * VectorScale;
+                const Float4 Base = Float4::Load(Min[v][Axis]);
+                const Float4 ValueA = Base + Float4::Load(QuantizedA[v][Axis]) * Range;
+                const Float4 ValueB = Base + Float4::Load(QuantizedB[v][Axis]) * Range;
+                (ValueA + (ValueB - ValueA) * VectorAlpha).Store(Out[Axis]);
+            }
+        }
+    }
+}
+
+size_t AnimationClip::GetMemorySize() const {
+    return sizeof(AnimationClip) + Curves.size() * sizeof(Curve) + KeyFrames.size() * sizeof(uint16_t) +
+           Keys.size() * sizeof(QuantizedKey);
+}
+
+} // namespace Volante
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "AnimationPose.h"
+
+namespace Volante {
+
+// An uncompressed clip: every joint's local transform at FrameCount evenly spaced frames.
+struct RawAnimationClip {
+    float SampleRate = 30.0f;
+    uint32_t JointCount = 0;
+    uint32_t FrameCount = 0;
+    // Frame-major: Frames[Frame * JointCount + Joint]
+    std::vector<JointTransform> Frames;
+
+    [[nodiscard]] float GetDuration() const { return FrameCount > 1 ? static_cast<float>(FrameCount - 1) / SampleRate : 0.0f; }
+};
+
+struct AnimationCompressionDesc {
+    // A key is dropped when interpolating its neighbours reproduces it within these. Rotation
+    // error is per quaternion component, translation in scene units, scale as a factor.
+    float RotationTolerance = 0.0005f;
+    float TranslationTolerance = 0.0005f;
+    float ScaleTolerance = 0.0005f;
+};
+
+// A compressed clip. Each joint has a rotation, a translation and a scale curve holding only
+// the keys that interpolation cannot reproduce, so a curve that never changes is one key.
+// Rotations are stored smallest-three in 48 bits; translations and scales as 16 bits per
+// component across the curve's range.
+//
+// Sample() decodes the keys around the requested time and interpolates four joints at a
+// time; it is const and allocation free, so any number of threads may sample one clip.
+class AnimationClip {
+public:
+    static constexpr uint32_t MaxFrameCount = 65536;
+
+    // Frames past MaxFrameCount are dropped.
+    static AnimationClip Compress(const RawAnimationClip& Raw, const AnimationCompressionDesc& Desc = {});
+
+    // Pose at Time seconds. Loop wraps Time into the clip, otherwise it is clamped. Resizes Pose
+    // to the clip's joint count if needed.
+    void Sample(float Time, bool Loop, AnimationPose& Pose) const;
+
+    [[nodiscard]] float GetDuration() const { return Duration; }
+
+    [[nodiscard]] uint32_t GetJointCount() const { return JointCount; }
+
+    // Keys across all curves, against JointCount * 3 * FrameCount uncompressed
+    [[nodiscard]] size_t GetKeyCount() const { return KeyFrames.size(); }
+
+    [[nodiscard]] size_t GetMemorySize() const;
+
+private:
+    struct Curve {
+        uint32_t FirstKey = 0;
+        uint32_t KeyCount = 0;
+        // Translation and scale: Value = Min + Quantized * Extent / 65535
+        float Min[3] = {};
+        float Extent[3] = {};
+    };
+
+    // Three 16-bit values; see EncodeRotation
+    struct QuantizedKey {
+        uint16_t Values[3];
+    };
+
+    // Curve index for a joint's channel
+    enum Channel : uint32_t { RotationChannel, TranslationChannel, ScaleChannel, ChannelCount };
+
+    // The keys around Frame and how far between them it lies
+    void FindKeys(const Curve& Curve, float Frame, uint32_t& KeyA, uint32_t& KeyB, float& Alpha) const;
+
+    float Duration = 0.0f;
+    float SampleRate = 30.0f;
+    uint32_t JointCount = 0;
+    uint32_t FrameCount = 0;
+    // Joint * ChannelCount + Channel
+    std::vector<Curve> Curves;
+    // Frame number of every key, each curve's contiguous and ascending
+    std::vector<uint16_t> KeyFrames;
+    std::vector<QuantizedKey> Keys;
+};
+
+} // namespace Volante
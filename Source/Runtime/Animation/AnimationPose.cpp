@@ -0,0 +1,160 @@
+#include "AnimationPose.h"
+
+#include <cassert>
+
+namespace Volante {
+
+namespace {
+
+constexpr uint32_t Lanes = 4;
+
+} // namespace
+
+void AnimationPose::Resize(uint32_t InJointCount) {
+    JointCount = InJointCount;
+    Groups.resize((JointCount + Lanes - 1) / Lanes);
+    for (SoaJointTransforms& Group : Groups) {
+        for (uint32_t Lane = 0; Lane < Lanes; ++Lane) {
+            Group.Rotation[0][Lane] = Group.Rotation[1][Lane] = Group.Rotation[2][Lane] = 0.0f;
+            Group.Rotation[3][Lane] = 1.0f;
+            Group.Translation[0][Lane] = Group.Translation[1][Lane] = Group.Translation[2][Lane] = 0.0f;
+            Group.Scale[0][Lane] = Group.Scale[1][Lane] = Group.Scale[2][Lane] = 1.0f;
+        }
+    }
+}
+
+void AnimationPose::SetJoint(uint32_t Joint, const JointTransform& Transform) {
+    SoaJointTransforms& Group = Groups[Joint / Lanes];
+    const uint32_t Lane = Joint % Lanes;
+    Group.Rotation[0][Lane] = Transform.Rotation.x;
+    Group.Rotation[1][Lane] = Transform.Rotation.y;
+    Group.Rotation[2][Lane] = Transform.Rotation.z;
+    Group.Rotation[3][Lane] = Transform.Rotation.w;
+    for (int Axis = 0; Axis < 3; ++Axis) {
+        Group.Translation[Axis][Lane] = Transform.Translation[Axis];
+        Group.Scale[Axis][Lane] = Transform.Scale[Axis];
+    }
+}
+
+JointTransform AnimationPose::GetJoint(uint32_t Joint) const {
+    const SoaJointTransforms& Group = Groups[Joint / Lanes];
+    const uint32_t Lane = Joint % Lanes;
+    JointTransform Result;
+    Result.Rotation = Quat(Group.Rotation[3][Lane], Group.Rotation[0][Lane], Group.Rotation[1][Lane], Group.Rotation[2][Lane]);
+    for (int Axis = 0; Axis < 3; ++Axis) {
+        Result.Translation[Axis] = Group.Translation[Axis][Lane];
+        Result.Scale[Axis] = Group.Scale[Axis][Lane];
+    }
+    return Result;
+}
+
+void AnimationPose::SetBindPose(const Skeleton& Skeleton) {
+    Resize(Skeleton.GetJointCount());
+    for (uint32_t Joint = 0; Joint < JointCount; ++Joint) {
+        SetJoint(Joint, Skeleton.GetBindPose()[Joint]);
+    }
+}
+
+void BlendPoses(const AnimationPose& A, const AnimationPose& B, float Weight, AnimationPose& Out) {
+    assert(A.GetJointCount() == B.GetJointCount());
+    if (Out.GetJointCount() != A.GetJointCount()) { Out.Resize(A.GetJointCount()); }
+
+    const Float4 WeightB = Float4::Splat(Weight);
+    const Float4 WeightA = Float4::Splat(1.0f - Weight);
+    const Float4 Zero = Float4::Zero();
+    const SoaJointTransforms* GroupsA = A.GetGroups();
+    const SoaJointTransforms* GroupsB = B.GetGroups();
+    SoaJointTransforms* GroupsOut = Out.GetGroups();
+    for (uint32_t g = 0; g < A.GetGroupCount(); ++g) {
+        const SoaJointTransforms& GA = GroupsA[g];
+        const SoaJointTransforms& GB = GroupsB[g];
+        SoaJointTransforms& GOut = GroupsOut[g];
+
+        Float4 RotationA[4];
+        Float4 RotationB[4];
+        for (int c = 0; c < 4; ++c) {
+            RotationA[c] = Float4::Load(GA.Rotation[c]);
+            RotationB[c] = Float4::Load(GB.Rotation[c]);
+        }
+        // q and -q are the same rotation; flip B onto A's hemisphere to take the shorter arc
+        const Float4 Cosine = RotationA[0] * RotationB[0] + RotationA[1] * RotationB[1] +
+                              RotationA[2] * RotationB[2] + RotationA[3] * RotationB[3];
+        const Float4 SignedWeightB = Select(Cosine < Zero, -WeightB, WeightB);
+        Float4 Rotation[4];
+        for (int c = 0; c < 4; ++c) {
+            Rotation[c] = RotationA[c] * WeightA + RotationB[c] * SignedWeightB;
+        }
+        const Float4 Length = Sqrt(Rotation[0] * Rotation[0] + Rotation[1] * Rotation[1] +
+                                   Rotation[2] * Rotation[2] + Rotation[3] * Rotation[3]);
+        const Float4 InvLength = Float4::Splat(1.0f) / Length;
+        for (int c = 0; c < 4; ++c) {
+            (Rotation[c] * InvLength).Store(GOut.Rotation[c]);
+        }
+
+        for (int Axis = 0; Axis < 3; ++Axis) {
+            (Float4::Load(GA.Translation[Axis]) * WeightA + Float4::Load(GB.Translation[Axis]) * WeightB).Store(GOut.Translation[Axis]);
+            (Float4::Load(GA.Scale[Axis]) * WeightA + Float4::Load(GB.Scale[Axis]) * WeightB).Store(GOut.Scale[Axis]);
+        }
+    }
+}
+
+void ComputeSkinningPalette(const Skeleton& Skeleton, const AnimationPose& Pose, const AffineTransform& World,
+                            std::vector<AffineTransform>& Model, AffineTransform* Palette) {
+    const uint32_t JointCount = Skeleton.GetJointCount();
+    assert(Pose.GetJointCount() == JointCount);
+    Model.resize(JointCount);
+
+    // Local matrices, four joints at a time: the same expansion as AffineTransform::FromJoint
+    const Float4 One = Float4::Splat(1.0f);
+    const Float4 Two = Float4::Splat(2.0f);
+    const SoaJointTransforms* Groups = Pose.GetGroups();
+    for (uint32_t g = 0; g < Pose.GetGroupCount(); ++g) {
+        const SoaJointTransforms& Group = Groups[g];
+        const Float4 X = Float4::Load(Group.Rotation[0]);
+        const Float4 Y = Float4::Load(Group.Rotation[1]);
+        const Float4 Z = Float4::Load(Group.Rotation[2]);
+        const Float4 W = Float4::Load(Group.Rotation[3]);
+        const Float4 SX = Float4::Load(Group.Scale[0]);
+        const Float4 SY = Float4::Load(Group.Scale[1]);
+        const Float4 SZ = Float4::Load(Group.Scale[2]);
+        const Float4 XX = X * X, YY = Y * Y, ZZ = Z * Z;
+        const Float4 XY = X * Y, XZ = X * Z, YZ = Y * Z;
+        const Float4 WX = W * X, WY = W * Y, WZ = W * Z;
+
+        alignas(16) float Entries[3][4][4];
+        ((One - Two * (YY + ZZ)) * SX).Store(Entries[0][0]);
+        (Two * (XY - WZ) * SY).Store(Entries[0][1]);
+        (Two * (XZ + WY) * SZ).Store(Entries[0][2]);
+        (Two * (XY + WZ) * SX).Store(Entries[1][0]);
+        ((One - Two * (XX + ZZ)) * SY).Store(Entries[1][1]);
+        (Two * (YZ - WX) * SZ).Store(Entries[1][2]);
+        (Two * (XZ - WY) * SX).Store(Entries[2][0]);
+        (Two * (YZ + WX) * SY).Store(Entries[2][1]);
+        ((One - Two * (XX + YY)) * SZ).Store(Entries[2][2]);
+        for (int Row = 0; Row < 3; ++Row) {
+            Float4::Load(Group.Translation[Row]).Store(Entries[Row][3]);
+        }
+
+        const uint32_t First = g * Lanes;
+        const uint32_t Count = JointCount - First < Lanes ? JointCount - First : Lanes;
+        for (uint32_t Lane = 0; Lane < Count; ++Lane) {
+            AffineTransform& Local = Model[First + Lane];
+            for (int Row = 0; Row < 3; ++Row) {
+                for (int Column = 0; Column < 4; ++Column) {
+                    Local.Rows[Row][Column] = Entries[Row][Column][Lane];
+                }
+            }
+        }
+    }
+
+    // Parents precede children, so one pass in index order concatenates the hierarchy
+    const std::vector<int32_t>& Parents = Skeleton.GetParents();
+    const std::vector<AffineTransform>& InverseBind = Skeleton.GetInverseBindMatrices();
+    for (uint32_t Joint = 0; Joint < JointCount; ++Joint) {
+        const int32_t Parent = Parents[Joint];
+        Model[Joint] = (Parent == NoParentJoint ? World : Model[Parent]) * Model[Joint];
+        Palette[Joint] = Model[Joint] * InverseBind[Joint];
+    }
+}
+
+} // namespace Volante
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Skeleton.h"
+
+namespace Volante {
+
+// Local transforms of four joints, one lane each, laid out for Float4: Rotation[c][Lane] is
+// component c (x, y, z, w) of joint Lane's rotation.
+struct alignas(16) SoaJointTransforms {
+    float Rotation[4][4];
+    float Translation[3][4];
+    float Scale[3][4];
+};
+
+// A skeleton's local joint transforms, four joints to a SoaJointTransforms so sampling,
+// blending and matrix conversion run four joints per instruction. Lanes past the last joint
+// hold the identity.
+class AnimationPose {
+public:
+    AnimationPose() = default;
+    explicit AnimationPose(uint32_t JointCount) { Resize(JointCount); }
+
+    // Resets every joint to the identity.
+    void Resize(uint32_t JointCount);
+
+    void SetJoint(uint32_t Joint, const JointTransform& Transform);
+    [[nodiscard]] JointTransform GetJoint(uint32_t Joint) const;
+
+    // Copies the skeleton's bind pose.
+    void SetBindPose(const Skeleton& Skeleton);
+
+    [[nodiscard]] uint32_t GetJointCount() const { return JointCount; }
+
+    [[nodiscard]] uint32_t GetGroupCount() const { return static_cast<uint32_t>(Groups.size()); }
+
+    [[nodiscard]] SoaJointTransforms* GetGroups() { return Groups.data(); }
+
+    [[nodiscard]] const SoaJointTransforms* GetGroups() const { return Groups.data(); }
+
+private:
+    std::vector<SoaJointTransforms> Groups;
+    uint32_t JointCount = 0;
+};
+
+// Out = A * (1 - Weight) + B * Weight: translations and scales are lerped, rotations take the
+// normalized lerp along the shorter arc. The poses must have the same joint count; Out may be
+// either input.
+void BlendPoses(const AnimationPose& A, const AnimationPose& B, float Weight, AnimationPose& Out);
+
+// Skinning matrices for every joint of Pose: World * ModelSpace(Joint) * InverseBind(Joint).
+// Model is scratch sized by the call; keep it around to avoid allocating per character.
+void ComputeSkinningPalette(const Skeleton& Skeleton, const AnimationPose& Pose, const AffineTransform& World,
+                            std::vector<AffineTransform>& Model, AffineTransform* Palette);
+
+} // namespace Volante
@@ -0,0 +1,313 @@
+#include "AnimationSystem.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+
+#include "Runtime/Core/Async/JobSystem.h"
+#include "Runtime/Core/Stats/StatCounters.h"
+#include "Runtime/Rendering/UploadRing.h"
+#include "Shader.h"
+
+namespace Volante {
+
+namespace {
+
+constexpr int PaletteUnit = 0;
+constexpr int ViewPaletteUnit = 1;
+constexpr size_t TexelSize = 16;
+
+// Poses and model-space matrices reused by each thread across instances
+struct EvaluationScratch {
+    AnimationPose Current;
+    AnimationPose Previous;
+    std::vector<AffineTransform> Model;
+};
+
+EvaluationScratch& GetScratch() {
+    thread_local EvaluationScratch Scratch;
+    return Scratch;
+}
+
+} // namespace
+
+AnimationSystem::AnimationSystem(const AnimationSystemDesc& Desc, JobSystem* Jobs, ShaderLibrary* Shaders)
+    : Desc(Desc), Jobs(Jobs), Shaders(Shaders) {}
+
+AnimationSystem::~AnimationSystem() {
+    Shutdown();
+}
+
+void AnimationSystem::Initialize() {
+    if (!Shaders) {
+        OwnedShaders = std::make_unique<ShaderLibrary>(Jobs);
+        OwnedShaders->Initialize();
+        Shaders = OwnedShaders.get();
+    }
+    const std::string& Directory = ShaderLibrary::GetShaderDirectory();
+    SkinningProgram.Id = Shaders->Load({Directory + "/Skinning.vert", Directory + "/Skinning.frag"});
+    if (!Shaders->Get(SkinningProgram.Id)) {
+        Shaders->Unload(SkinningProgram.Id);
+        SkinningProgram = {};
+    }
+    glGenTextures(1, &PaletteTexture);
+    glGenTextures(1, &ViewPaletteTexture);
+}
+
+void AnimationSystem::Shutdown() {
+    Instances.clear();
+    FreeIds.clear();
+    Meshes.clear();
+    Clips.clear();
+    Skeletons.clear();
+    if (Shaders) { Shaders->Unload(SkinningProgram.Id); }
+    SkinningProgram = {};
+    glDeleteTextures(1, &PaletteTexture);
+    glDeleteTextures(1, &ViewPaletteTexture);
+    PaletteTexture = 0;
+    ViewPaletteTexture = 0;
+    Visible.clear();
+    PaletteBuffer = 0;
+    Stats = {};
+    if (OwnedShaders) {
+        OwnedShaders->Shutdown();
+        OwnedShaders.reset();
+        Shaders = nullptr;
+    }
+}
+
+void AnimationSystem::Update(float DeltaTime) {
+    if (OwnedShaders) { OwnedShaders->Update(DeltaTime); }
+    for (Instance& Target : Instances) {
+        if (!Target.Alive) { continue; }
+        if (Target.Current.Clip != InvalidAnimationId) {
+            AdvanceLayer(Target.Current, Clips[Target.Current.Clip].GetDuration(), DeltaTime);
+        }
+        if (Target.Previous.Clip == InvalidAnimationId) { continue; }
+        Target.FadeElapsed += DeltaTime;
+        if (Target.FadeElapsed >= Target.FadeTime) {
+            Target.Previous.Clip = InvalidAnimationId;
+        } else {
+            AdvanceLayer(Target.Previous, Clips[Target.Previous.Clip].GetDuration(), DeltaTime);
+        }
+    }
+}
+
+void AnimationSystem::AdvanceLayer(PlaybackLayer& Layer, float Duration, float DeltaTime) {
+    Layer.Time += DeltaTime * Layer.Speed;
+    // Wrapped here rather than only when sampling, so long-running clocks keep their precision
+    if (Layer.Loop && Duration > 0.0f) {
+        Layer.Time = std::fmod(Layer.Time, Duration);
+        if (Layer.Time < 0.0f) { Layer.Time += Duration; }
+    } else {
+        Layer.Time = std::clamp(Layer.Time, 0.0f, Duration);
+    }
+}
+
+SkeletonId AnimationSystem::AddSkeleton(Skeleton InSkeleton) {
+    Skeletons.push_back(std::move(InSkeleton));
+    return static_cast<SkeletonId>(Skeletons.size() - 1);
+}
+
+AnimationClipId AnimationSystem::AddClip(AnimationClip Clip) {
+    Clips.push_back(std::move(Clip));
+    return static_cast<AnimationClipId>(Clips.size() - 1);
+}
+
+SkinnedMeshId AnimationSystem::AddMesh(const SkinnedMeshData& Data, SkeletonId Skeleton, const Vec4& Color) {
+    MeshAsset& Asset = Meshes.emplace_back();
+    Asset.Mesh = std::make_unique<SkinnedMesh>(Data);
+    Asset.Skeleton = Skeleton;
+    Asset.Color = Color;
+    const AABB& Bind = Asset.Mesh->GetBounds();
+    const Vec3 Extent = Bind.GetExtent();
+    Asset.Bounds = AABB::FromCenterExtent(Bind.GetCenter(), Extent + Extent * (2.0f * Desc.BoundsPadding));
+    return static_cast<SkinnedMeshId>(Meshes.size() - 1);
+}
+
+SkinnedInstanceId AnimationSystem::CreateInstance(SkinnedMeshId Mesh, const Mat4& Transform) {
+    SkinnedInstanceId Id;
+    if (!FreeIds.empty()) {
+        Id = FreeIds.back();
+        FreeIds.pop_back();
+    } else {
+        Id = static_cast<SkinnedInstanceId>(Instances.size());
+        Instances.emplace_back();
+    }
+    Instance& Target = Instances[Id];
+    Target = {};
+    Target.Mesh = Mesh;
+    Target.Alive = true;
+    SetTransform(Id, Transform);
+    return Id;
+}
+
+void AnimationSystem::DestroyInstance(SkinnedInstanceId Id) {
+    if (Id >= Instances.size() || !Instances[Id].Alive) { return; }
+    Instances[Id].Alive = false;
+    FreeIds.push_back(Id);
+}
+
+void AnimationSystem::SetTransform(SkinnedInstanceId Id, const Mat4& Transform) {
+    Instance& Target = Instances[Id];
+    Target.Transform = Transform;
+    Target.WorldBounds = Meshes[Target.Mesh].Bounds.Transform(Transform);
+}
+
+void AnimationSystem::Play(SkinnedInstanceId Id, AnimationClipId Clip, float Speed, bool Loop, float FadeTime) {
+    Instance& Target = Instances[Id];
+    const Skeleton& TargetSkeleton = Skeletons[Meshes[Target.Mesh].Skeleton];
+    if (Clip >= Clips.size() || Clips[Clip].GetJointCount() != TargetSkeleton.GetJointCount()) {
+        std::cerr << "ERROR::ANIMATION_SYSTEM::CLIP_MISMATCH: clip " << Clip << " does not fit the skeleton of instance " << Id << std::endl;
+        return;
+    }
+    if (FadeTime > 0.0f && Target.Current.Clip != InvalidAnimationId) {
+        Target.Previous = Target.Current;
+        Target.FadeElapsed = 0.0f;
+        Target.FadeTime = FadeTime;
+    } else {
+        Target.Previous.Clip = InvalidAnimationId;
+    }
+    Target.Current = {Clip, 0.0f, Speed, Loop};
+}
+
+void AnimationSystem::SetTime(SkinnedInstanceId Id, float Time) {
+    PlaybackLayer& Layer = Instances[Id].Current;
+    Layer.Time = Time;
+    if (Layer.Clip != InvalidAnimationId) { AdvanceLayer(Layer, Clips[Layer.Clip].GetDuration(), 0.0f); }
+}
+
+void AnimationSystem::EvaluateInstance(const Instance& Target, AffineTransform* Palette) const {
+    EvaluationScratch& Scratch = GetScratch();
+    const Skeleton& TargetSkeleton = Skeletons[Meshes[Target.Mesh].Skeleton];
+
+    if (Target.Current.Clip == InvalidAnimationId) {
+        Scratch.Current.SetBindPose(TargetSkeleton);
+    } else {
+        Clips[Target.Current.Clip].Sample(Target.Current.Time, Target.Current.Loop, Scratch.Current);
+    }
+    if (Target.Previous.Clip != InvalidAnimationId) {
+        Clips[Target.Previous.Clip].Sample(Target.Previous.Time, Target.Previous.Loop, Scratch.Previous);
+        BlendPoses(Scratch.Previous, Scratch.Current, Target.FadeElapsed / Target.FadeTime, Scratch.Current);
+    }
+    ComputeSkinningPalette(TargetSkeleton, Scratch.Current, AffineTransform::FromMatrix(Target.Transform), Scratch.Model, Palette);
+}
+
+void AnimationSystem::EvaluatePalette(SkinnedInstanceId Id, std::vector<AffineTransform>& Palette) const {
+    const Instance& Target = Instances[Id];
+    Palette.resize(Skeletons[Meshes[Target.Mesh].Skeleton].GetJointCount());
+    EvaluateInstance(Target, Palette.data());
+}
+
+void AnimationSystem::Evaluate(std::span<const RenderView> Views, UploadRing& Uploads) {
+    StatScope Scope(StatTimer::Animation);
+    Stats = {};
+
+    Visible.clear();
+    for (uint32_t Id = 0; Id < Instances.size(); ++Id) {
+        const Instance& Target = Instances[Id];
+        if (!Target.Alive) { continue; }
+        ++Stats.InstanceCount;
+        const bool InView =
+            std::ranges::any_of(Views, [&](const RenderView& View) { return View.ViewFrustum.Intersects(Target.WorldBounds); });
+        if (InView) { Visible.push_back(static_cast<uint64_t>(Target.Mesh) << 32 | Id); }
+    }
+    Stats.VisibleCount = static_cast<uint32_t>(Visible.size());
+    if (Visible.empty() || SkinningProgram.Id == InvalidShaderProgramId) {
+        Visible.clear();
+        return;
+    }
+    std::sort(Visible.begin(), Visible.end());
+
+    PaletteOffsets.resize(Visible.size());
+    uint32_t JointTotal = 0;
+    for (size_t i = 0; i < Visible.size(); ++i) {
+        PaletteOffsets[i] = JointTotal;
+        JointTotal += Skeletons[Meshes[Visible[i] >> 32].Skeleton].GetJointCount();
+    }
+
+    const UploadAllocation Palette = Uploads.Allocate(JointTotal * sizeof(AffineTransform), TexelSize);
+    if (!Palette) {
+        Visible.clear();
+        return;
+    }
+    Stats.JointCount = JointTotal;
+    Stats.PaletteBytes = JointTotal * sizeof(AffineTransform);
+    PaletteBuffer = Palette.Buffer;
+    PaletteOffset = Palette.Offset;
+
+    auto* PaletteData = static_cast<AffineTransform*>(Palette.Data);
+    ParallelFor(Jobs, static_cast<uint32_t>(Visible.size()), Desc.EvaluationGrain, [&](uint32_t Begin, uint32_t End) {
+        for (uint32_t i = Begin; i < End; ++i) {
+            EvaluateInstance(Instances[static_cast<uint32_t>(Visible[i])], PaletteData + PaletteOffsets[i]);
+        }
+    });
+    Uploads.Flush();
+}
+
+void AnimationSystem::Render(const RenderView& View, UploadRing& Uploads, const Vec3& LightDirection) {
+    StatScope Scope(StatTimer::Animation);
+    if (Visible.empty()) { return; }
+
+    // Visible stays sorted by mesh, so each mesh's instances stay contiguous in the view's list
+    ViewInstances.clear();
+    for (size_t i = 0; i < Visible.size(); ++i) {
+        if (View.ViewFrustum.Intersects(Instances[static_cast<uint32_t>(Visible[i])].WorldBounds)) {
+            ViewInstances.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    if (ViewInstances.empty()) { return; }
+    const UploadAllocation List = Uploads.Allocate(ViewInstances.size() * sizeof(uint32_t), sizeof(uint32_t));
+    if (!List) { return; }
+    auto* ListData = static_cast<uint32_t*>(List.Data);
+    for (size_t i = 0; i < ViewInstances.size(); ++i) {
+        ListData[i] = PaletteOffsets[ViewInstances[i]];
+    }
+    Uploads.Flush();
+
+    // A failed reload keeps the previous program, so there is one once Initialize loaded it
+    const Shader& Program = *Shaders->Get(SkinningProgram.Id);
+    Program.use();
+    if (Shaders->Refresh(SkinningProgram)) {
+        Program.setInt("uPalette", PaletteUnit);
+        Program.setInt("uViewInstances", ViewPaletteUnit);
+    }
+    Program.setMat4("uViewProjection", View.RelativeViewProjection);
+    Program.setVec3("uViewOrigin", View.Origin);
+    Program.setVec3("uLightDirection", normalize(LightDirection));
+    Program.setInt("uPaletteBase", static_cast<int>(PaletteOffset / TexelSize));
+    glActiveTexture(GL_TEXTURE0 + PaletteUnit);
+    glBindTexture(GL_TEXTURE_BUFFER, PaletteTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, PaletteBuffer);
+    glActiveTexture(GL_TEXTURE0 + ViewPaletteUnit);
+    glBindTexture(GL_TEXTURE_BUFFER, ViewPaletteTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_R32UI, List.Buffer);
+    const auto FirstEntry = static_cast<int>(List.Offset / sizeof(uint32_t));
+
+    uint32_t DrawCount = 0;
+    for (size_t First = 0; First < ViewInstances.size();) {
+        const auto MeshId = static_cast<SkinnedMeshId>(Visible[ViewInstances[First]] >> 32);
+        size_t Last = First + 1;
+        while (Last < ViewInstances.size() && (Visible[ViewInstances[Last]] >> 32) == MeshId) { ++Last; }
+
+        const MeshAsset& Asset = Meshes[MeshId];
+        Program.setInt("uViewPaletteBase", FirstEntry + static_cast<int>(First));
+        Program.setVec4("uColor", Asset.Color);
+        Asset.Mesh->Bind();
+        glDrawElementsInstanced(GL_TRIANGLES, static_cast<GLsizei>(Asset.Mesh->GetIndexCount()), GL_UNSIGNED_INT, nullptr,
+                                static_cast<GLsizei>(Last - First));
+        ++DrawCount;
+        First = Last;
+    }
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    glActiveTexture(GL_TEXTURE0 + PaletteUnit);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    Stats.DrawCount += DrawCount;
+    StatCounters::Add(StatCounter::DrawCalls, DrawCount);
+}
+
+} // namespace Volante
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "Engine.h"
+#include "AnimationClip.h"
+#include "SkinnedMesh.h"
+#include "Runtime/Rendering/RenderView.h"
+#include "Runtime/Rendering/ShaderLibrary.h"
+
+namespace Volante {
+
+class JobSystem;
+class Shader;
+class UploadRing;
+
+using SkeletonId = uint32_t;
+using AnimationClipId = uint32_t;
+using SkinnedMeshId = uint32_t;
+using SkinnedInstanceId = uint32_t;
+constexpr uint32_t InvalidAnimationId = ~0u;
+
+struct AnimationSystemDesc {
+    // Visible characters evaluated per job
+    uint32_t EvaluationGrain = 16;
+
+    // Bind-pose bounds grow by this fraction of their size on every side before culling, so
+    // poses that reach outside them are not culled early.
+    float BoundsPadding = 0.25f;
+};
+
+// Describes the last frame: Evaluate's counts cover every view, DrawCount sums their Renders.
+struct AnimationStats {
+    uint32_t InstanceCount = 0;
+    uint32_t VisibleCount = 0;
+    uint32_t JointCount = 0;
+    uint32_t DrawCount = 0;
+    size_t PaletteBytes = 0;
+};
+
+// Plays animation clips on skinned meshes and draws them.
+//
+// Update() only advances each instance's playback clocks. Evaluate() culls instances against
+// the frame's views and evaluates poses for those visible in any of them, once however many
+// views see them: clips are sampled, cross-fades blended and skinning matrices built on the job
+// system, written straight into one upload allocation that the vertex shader reads as a texture
+// buffer (three RGBA32F texels per joint). Render() then draws one view: the instances of a mesh
+// visible in it are drawn with one instanced draw, each finding its palette through a short
+// per-view list indexed by gl_InstanceID.
+//
+// The program is loaded from Skinning.vert and Skinning.frag through Shaders, or through a
+// library of the system's own, updated in Update(), when none is given.
+class AnimationSystem : public IEngineSubsystem {
+public:
+    explicit AnimationSystem(const AnimationSystemDesc& Desc = {}, JobSystem* Jobs = nullptr,
+                             ShaderLibrary* Shaders = nullptr);
+    ~AnimationSystem() override;
+
+    AnimationSystem(const AnimationSystem&) = delete;
+    AnimationSystem& operator=(const AnimationSystem&) = delete;
+
+    void Initialize() override;
+    void Shutdown() override;
+    void Update(float DeltaTime) override;
+
+    SkeletonId AddSkeleton(Skeleton InSkeleton);
+    AnimationClipId AddClip(AnimationClip Clip);
+    // The skin's joint indices refer to Skeleton's joints.
+    SkinnedMeshId AddMesh(const SkinnedMeshData& Data, SkeletonId Skeleton, const Vec4& Color = Vec4(1.0f));
+
+    SkinnedInstanceId CreateInstance(SkinnedMeshId Mesh, const Mat4& Transform);
+    void DestroyInstance(SkinnedInstanceId Id);
+    void SetTransform(SkinnedInstanceId Id, const Mat4& Transform);
+
+    // Starts Clip from Time 0, cross-fading from what was playing over FadeTime seconds. The
+    // clip must have as many joints as the mesh's skeleton.
+    void Play(SkinnedInstanceId Id, AnimationClipId Clip, float Speed = 1.0f, bool Loop = true, float FadeTime = 0.0f);
+    // Jumps the playing clip to Time seconds.
+    void SetTime(SkinnedInstanceId Id, float Time);
+
+    // Once per frame, before any Render: evaluates the instances visible in at least one of
+    // Views into an allocation from Uploads, which must stay valid until the last Render.
+    void Evaluate(std::span<const RenderView> Views, UploadRing& Uploads);
+
+    // Draws the evaluated instances visible in View, one of those passed to Evaluate, into the
+    // bound framebuffer. LightDirection points towards the light.
+    void Render(const RenderView& View, UploadRing& Uploads, const Vec3& LightDirection);
+
+    // The instance's current skinning matrices, evaluated on the calling thread.
+    void EvaluatePalette(SkinnedInstanceId Id, std::vector<AffineTransform>& Palette) const;
+
+    [[nodiscard]] const Skeleton& GetSkeleton(SkeletonId Id) const { return Skeletons[Id]; }
+
+    [[nodiscard]] const AnimationClip& GetClip(AnimationClipId Id) const { return Clips[Id]; }
+
+    [[nodiscard]] const AnimationStats& GetStats() const { return Stats; }
+
+private:
+    struct MeshAsset {
+        std::unique_ptr<SkinnedMesh> Mesh;
+        SkeletonId Skeleton = InvalidAnimationId;
+        Vec4 Color = Vec4(1.0f);
+        AABB Bounds;
+    };
+
+    struct PlaybackLayer {
+        AnimationClipId Clip = InvalidAnimationId;
+        float Time = 0.0f;
+        float Speed = 1.0f;
+        bool Loop = true;
+    };
+
+    struct Instance {
+        SkinnedMeshId Mesh = InvalidAnimationId;
+        Mat4 Transform = Mat4(1.0f);
+        AABB WorldBounds;
+        PlaybackLayer Current;
+        // Fading out while FadeElapsed < FadeTime
+        PlaybackLayer Previous;
+        float FadeElapsed = 0.0f;
+        float FadeTime = 0.0f;
+        bool Alive = false;
+    };
+
+    void EvaluateInstance(const Instance& Target, AffineTransform* Palette) const;
+    static void AdvanceLayer(PlaybackLayer& Layer, float Duration, float DeltaTime);
+
+    AnimationSystemDesc Desc;
+    JobSystem* Jobs;
+    ShaderLibrary* Shaders;
+    std::unique_ptr<ShaderLibrary> OwnedShaders;
+    std::vector<Skeleton> Skeletons;
+    std::vector<AnimationClip> Clips;
+    std::vector<MeshAsset> Meshes;
+    std::vector<Instance> Instances;
+    std::vector<SkinnedInstanceId> FreeIds;
+    AnimationStats Stats;
+
+    // This frame's evaluation: instances visible in any view sorted by mesh (mesh in the high
+    // bits), where each one's palette starts, in joints, and the upload holding the palettes
+    std::vector<uint64_t> Visible;
+    std::vector<uint32_t> PaletteOffsets;
+    unsigned int PaletteBuffer = 0;
+    size_t PaletteOffset = 0;
+    // Render scratch: indices into Visible of the instances in the view
+    std::vector<uint32_t> ViewInstances;
+
+    ShaderProgramHandle SkinningProgram;
+    unsigned int PaletteTexture = 0;
+    unsigned int ViewPaletteTexture = 0;
+};
+
+} // namespace Volante
@@ -0,0 +1,96 @@
+#include "Skeleton.h"
+
+#include <cassert>
+
+namespace Volante {
+
+AffineTransform AffineTransform::FromMatrix(const Mat4& Matrix) {
+    AffineTransform Result;
+    for (int Row = 0; Row < 3; ++Row) {
+        for (int Column = 0; Column < 4; ++Column) {
+            Result.Rows[Row][Column] = Matrix[Column][Row];
+        }
+    }
+    return Result;
+}
+
+AffineTransform AffineTransform::FromJoint(const JointTransform& Joint) {
+    const Quat& Q = Joint.Rotation;
+    const float XX = Q.x * Q.x, YY = Q.y * Q.y, ZZ = Q.z * Q.z;
+    const float XY = Q.x * Q.y, XZ = Q.x * Q.z, YZ = Q.y * Q.z;
+    const float WX = Q.w * Q.x, WY = Q.w * Q.y, WZ = Q.w * Q.z;
+    const Vec3& S = Joint.Scale;
+    const Vec3& T = Joint.Translation;
+
+    AffineTransform Result;
+    Result.Rows[0][0] = (1.0f - 2.0f * (YY + ZZ)) * S.x;
+    Result.Rows[0][1] = 2.0f * (XY - WZ) * S.y;
+    Result.Rows[0][2] = 2.0f * (XZ + WY) * S.z;
+    Result.Rows[0][3] = T.x;
+    Result.Rows[1][0] = 2.0f * (XY + WZ) * S.x;
+    Result.Rows[1][1] = (1.0f - 2.0f * (XX + ZZ)) * S.y;
+    Result.Rows[1][2] = 2.0f * (YZ - WX) * S.z;
+    Result.Rows[1][3] = T.y;
+    Result.Rows[2][0] = 2.0f * (XZ - WY) * S.x;
+    Result.Rows[2][1] = 2.0f * (YZ + WX) * S.y;
+    Result.Rows[2][2] = (1.0f - 2.0f * (XX + YY)) * S.z;
+    Result.Rows[2][3] = T.z;
+    return Result;
+}
+
+Mat4 AffineTransform::ToMatrix() const {
+    Mat4 Result(1.0f);
+    for (int Row = 0; Row < 3; ++Row) {
+        for (int Column = 0; Column < 4; ++Column) {
+            Result[Column][Row] = Rows[Row][Column];
+        }
+    }
+    return Result;
+}
+
+AffineTransform AffineTransform::Inverse() const {
+    const float (&M)[3][4] = Rows;
+    // Cofactors of the upper 3x3; its inverse is their transpose over the determinant
+    const float C00 = M[1][1] * M[2][2] - M[1][2] * M[2][1];
+    const float C01 = M[1][2] * M[2][0] - M[1][0] * M[2][2];
+    const float C02 = M[1][0] * M[2][1] - M[1][1] * M[2][0];
+    const float InvDet = 1.0f / (M[0][0] * C00 + M[0][1] * C01 + M[0][2] * C02);
+
+    AffineTransform Result;
+    Result.Rows[0][0] = C00 * InvDet;
+    Result.Rows[0][1] = (M[0][2] * M[2][1] - M[0][1] * M[2][2]) * InvDet;
+    Result.Rows[0][2] = (M[0][1] * M[1][2] - M[0][2] * M[1][1]) * InvDet;
+    Result.Rows[1][0] = C01 * InvDet;
+    Result.Rows[1][1] = (M[0][0] * M[2][2] - M[0][2] * M[2][0]) * InvDet;
+    Result.Rows[1][2] = (M[0][2] * M[1][0] - M[0][0] * M[1][2]) * InvDet;
+    Result.Rows[2][0] = C02 * InvDet;
+    Result.Rows[2][1] = (M[0][1] * M[2][0] - M[0][0] * M[2][1]) * InvDet;
+    Result.Rows[2][2] = (M[0][0] * M[1][1] - M[0][1] * M[1][0]) * InvDet;
+    for (int Row = 0; Row < 3; ++Row) {
+        Result.Rows[Row][3] = -(Result.Rows[Row][0] * M[0][3] + Result.Rows[Row][1] * M[1][3] + Result.Rows[Row][2] * M[2][3]);
+    }
+    return Result;
+}
+
+uint32_t Skeleton::AddJoint(const std::string& Name, int32_t Parent, const JointTransform& Bind) {
+    const auto Joint = static_cast<uint32_t>(Parents.size());
+    assert(Parent < static_cast<int32_t>(Joint) && Joint < MaxSkeletonJoints);
+
+    const AffineTransform Local = AffineTransform::FromJoint(Bind);
+    const AffineTransform Model = Parent == NoParentJoint ? Local : BindModel[Parent] * Local;
+    Names.push_back(Name);
+    Parents.push_back(Parent);
+    BindPose.push_back(Bind);
+    BindModel.push_back(Model);
+    InverseBind.push_back(Model.Inverse());
+    return Joint;
+}
+
+int32_t Skeleton::FindJoint(const std::string& Name) const {
+    for (size_t i = 0; i < Names.size(); ++i) {
+        if (Names[i] == Name) { return static_cast<int32_t>(i); }
+    }
+    return NoParentJoint;
+}
+
+} // namespace Volante
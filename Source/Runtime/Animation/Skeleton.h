@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Volante.h"
+#include "Runtime/Core/Math/Simd.h"
+
+namespace Volante {
+
+// A joint's transform relative to its parent: scale, then rotation, then translation.
+struct JointTransform {
+    Quat Rotation = Quat(1.0f, 0.0f, 0.0f, 0.0f);
+    Vec3 Translation = Vec3(0.0f);
+    Vec3 Scale = Vec3(1.0f);
+};
+
+// The top three rows of an affine matrix (the fourth is 0, 0, 0, 1), row-major. Skinning
+// palettes hold one per joint, as three vec4 texels.
+struct alignas(16) AffineTransform {
+    float Rows[3][4] = {{1.0f, 0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f, 0.0f}};
+
+    static AffineTransform FromMatrix(const Mat4& Matrix);
+    static AffineTransform FromJoint(const JointTransform& Joint);
+
+    [[nodiscard]] Mat4 ToMatrix() const;
+
+    // Assumes the upper 3x3 is invertible.
+    [[nodiscard]] AffineTransform Inverse() const;
+
+    [[nodiscard]] Vec3 TransformPoint(const Vec3& Point) const {
+        return {Rows[0][0] * Point.x + Rows[0][1] * Point.y + Rows[0][2] * Point.z + Rows[0][3],
+                Rows[1][0] * Point.x + Rows[1][1] * Point.y + Rows[1][2] * Point.z + Rows[1][3],
+                Rows[2][0] * Point.x + Rows[2][1] * Point.y + Rows[2][2] * Point.z + Rows[2][3]};
+    }
+
+    friend AffineTransform operator*(const AffineTransform& A, const AffineTransform& B) {
+        const Float4 B0 = Float4::Load(B.Rows[0]);
+        const Float4 B1 = Float4::Load(B.Rows[1]);
+        const Float4 B2 = Float4::Load(B.Rows[2]);
+        const Float4 B3 = Float4::Set(0.0f, 0.0f, 0.0f, 1.0f);
+        AffineTransform Result;
+        for (int i = 0; i < 3; ++i) {
+            const Float4 Row = Float4::Splat(A.Rows[i][0]) * B0 + Float4::Splat(A.Rows[i][1]) * B1 +
+                               Float4::Splat(A.Rows[i][2]) * B2 + Float4::Splat(A.Rows[i][3]) * B3;
+            Row.Store(Result.Rows[i]);
+        }
+        return Result;
+    }
+};
+
+constexpr int32_t NoParentJoint = -1;
+
+// Skinned vertices address joints with one byte.
+constexpr uint32_t MaxSkeletonJoints = 256;
+
+// Joint hierarchy and bind pose. Joints are added parents first, so walking them in index
+// order always visits a parent before its children.
+class Skeleton {
+public:
+    // Parent is an existing joint or NoParentJoint. Returns the new joint's index.
+    uint32_t AddJoint(const std::string& Name, int32_t Parent, const JointTransform& BindPose);
+
+    [[nodiscard]] uint32_t GetJointCount() const { return static_cast<uint32_t>(Parents.size()); }
+
+    [[nodiscard]] int32_t GetParent(uint32_t Joint) const { return Parents[Joint]; }
+
+    [[nodiscard]] const std::string& GetName(uint32_t Joint) const { return Names[Joint]; }
+
+    // NoParentJoint if there is no joint called Name.
+    [[nodiscard]] int32_t FindJoint(const std::string& Name) const;
+
+    [[nodiscard]] const std::vector<int32_t>& GetParents() const { return Parents; }
+
+    [[nodiscard]] const std::vector<JointTransform>& GetBindPose() const { return BindPose; }
+
+    // Model space to each joint's bind space
+    [[nodiscard]] const std::vector<AffineTransform>& GetInverseBindMatrices() const { return InverseBind; }
+
+private:
+    std::vector<std::string> Names;
+    std::vector<int32_t> Parents;
+    std::vector<JointTransform> BindPose;
+    std::vector<AffineTransform> BindModel;
+    std::vector<AffineTransform> InverseBind;
+};
+
+} // namespace Volante
@@ -0,0 +1,131 @@
+#include "SkinnedMesh.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+namespace Volante {
+
+SkinWeights SkinWeights::Pack(const uint32_t* Joints, const float* Weights, uint32_t Count) {
+    uint32_t Order[MaxSkeletonJoints];
+    Count = std::min(Count, MaxSkeletonJoints);
+    for (uint32_t i = 0; i < Count; ++i) { Order[i] = i; }
+    const uint32_t Kept = std::min(Count, 4u);
+    std::partial_sort(Order, Order + Kept, Order + Count, [Weights](uint32_t A, uint32_t B) { return Weights[A] > Weights[B]; });
+
+    float Total = 0.0f;
+    for (uint32_t i = 0; i < Kept; ++i) { Total += std::max(Weights[Order[i]], 0.0f); }
+
+    SkinWeights Result;
+    if (Total <= 0.0f) { return Result; }
+    uint32_t Remaining = 65535;
+    for (uint32_t i = 0; i < Kept; ++i) {
+        Result.Joints[i] = static_cast<uint8_t>(Joints[Order[i]]);
+        // The heaviest influence takes the rounding error, so the sum is exact
+        const auto Weight = static_cast<uint32_t>(std::lround(std::max(Weights[Order[i]], 0.0f) / Total * 65535.0f));
+        Result.Weights[i] = static_cast<uint16_t>(i == 0 ? 0 : std::min(Weight, Remaining));
+        Remaining -= Result.Weights[i];
+    }
+    Result.Weights[0] = static_cast<uint16_t>(Remaining);
+    return Result;
+}
+
+SkinnedMesh::SkinnedMesh(const SkinnedMeshData& Data) : IndexCount(static_cast<uint32_t>(Data.Mesh.Indices.size())) {
+    for (const Vertex& Point : Data.Mesh.Vertices) { Bounds.Expand(Point.position); }
+
+    glGenVertexArrays(1, &VertexArray);
+    glGenBuffers(1, &VertexBuffer);
+    glGenBuffers(1, &SkinBuffer);
+    glGenBuffers(1, &IndexBuffer);
+    glBindVertexArray(VertexArray);
+
+    glBindBuffer(GL_ARRAY_BUFFER, VertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(sizeof(Vertex) * Data.Mesh.Vertices.size()), Data.Mesh.Vertices.data(), GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<void*>(offsetof(Vertex, position)));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<void*>(offsetof(Vertex, normal)));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<void*>(offsetof(Vertex, texCoord)));
+
+    glBindBuffer(GL_ARRAY_BUFFER, SkinBuffer);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(sizeof(SkinWeights) * Data.Skin.size()), Data.Skin.data(), GL_STATIC_DRAW);
+    glEnableVertexAttribArray(JointsLocation);
+    glVertexAttribIPointer(JointsLocation, 4, GL_UNSIGNED_BYTE, sizeof(SkinWeights), reinterpret_cast<void*>(offsetof(SkinWeights, Joints)));
+    glEnableVertexAttribArray(WeightsLocation);
+    glVertexAttribPointer(WeightsLocation, 4, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(SkinWeights), reinterpret_cast<void*>(offsetof(SkinWeights, Weights)));
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IndexBuffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(sizeof(uint32_t) * Data.Mesh.Indices.size()), Data.Mesh.Indices.data(), GL_STATIC_DRAW);
+
+    glBindVertexArray(0);
+}
+
+SkinnedMesh::~SkinnedMesh() {
+    glDeleteVertexArrays(1, &VertexArray);
+    glDeleteBuffers(1, &VertexBuffer);
+    glDeleteBuffers(1, &SkinBuffer);
+    glDeleteBuffers(1, &IndexBuffer);
+}
+
+void SkinnedMesh::Bind() const {
+    glBindVertexArray(VertexArray);
+}
+
+Skeleton GenerateChainSkeleton(float Height, uint32_t JointCount) {
+    Skeleton Result;
+    JointCount = std::clamp(JointCount, 1u, MaxSkeletonJoints);
+    const float BoneLength = Height / static_cast<float>(JointCount);
+    for (uint32_t Joint = 0; Joint < JointCount; ++Joint) {
+        JointTransform Bind;
+        Bind.Translation = Vec3(0.0f, Joint == 0 ? 0.0f : BoneLength, 0.0f);
+        Result.AddJoint("Joint" + std::to_string(Joint), static_cast<int32_t>(Joint) - 1, Bind);
+    }
+    return Result;
+}
+
+SkinnedMeshData GenerateSkinnedCylinder(float Radius, float Height, uint32_t Sectors, uint32_t Rings, uint32_t JointCount) {
+    Sectors = std::max(Sectors, 3u);
+    Rings = std::max(Rings, 1u);
+    JointCount = std::clamp(JointCount, 1u, MaxSkeletonJoints);
+    const float BoneLength = Height / static_cast<float>(JointCount);
+
+    SkinnedMeshData Data;
+    const size_t VertexCount = static_cast<size_t>(Rings + 1) * (Sectors + 1);
+    Data.Mesh.Vertices.reserve(VertexCount);
+    Data.Skin.reserve(VertexCount);
+    Data.Mesh.Indices.reserve(static_cast<size_t>(Rings) * Sectors * 6);
+
+    for (uint32_t Ring = 0; Ring <= Rings; ++Ring) {
+        const float V = static_cast<float>(Ring) / static_cast<float>(Rings);
+        const float Y = V * Height;
+
+        // Blend between the two joints whose bone midpoints bracket Y
+        const float Bone = std::clamp(Y / BoneLength - 0.5f, 0.0f, static_cast<float>(JointCount - 1));
+        const uint32_t Joints[2] = {static_cast<uint32_t>(Bone), std::min(static_cast<uint32_t>(Bone) + 1, JointCount - 1)};
+        const float Fraction = Bone - std::floor(Bone);
+        const float Weights[2] = {1.0f - Fraction, Fraction};
+        const SkinWeights Skin = SkinWeights::Pack(Joints, Weights, 2);
+
+        for (uint32_t Sector = 0; Sector <= Sectors; ++Sector) {
+            const float U = static_cast<float>(Sector) / static_cast<float>(Sectors);
+            const float Angle = U * TWO_PI;
+            const Vec3 Normal(std::cos(Angle), 0.0f, -std::sin(Angle));
+            Data.Mesh.Vertices.push_back({Vec3(Normal.x * Radius, Y, Normal.z * Radius), Normal, Vec2(U, V)});
+            Data.Skin.push_back(Skin);
+        }
+    }
+
+    for (uint32_t Ring = 0; Ring < Rings; ++Ring) {
+        for (uint32_t Sector = 0; Sector < Sectors; ++Sector) {
+            const uint32_t A = Ring * (Sectors + 1) + Sector;
+            const uint32_t B = A + Sectors + 1;
+            Data.Mesh.Indices.insert(Data.Mesh.Indices.end(), {A, A + 1, B, B, A + 1, B + 1});
+        }
+    }
+    return Data;
+}
+
+} // namespace Volante
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Skeleton.h"
+#include "Runtime/Core/Math/Bounds.h"
+#include "Runtime/Rendering/ProceduralMesh.h"
+
+namespace Volante {
+
+// Up to four joint influences of one vertex, streamed beside its Vertex. Weights are
+// normalized 16-bit and sum to 65535.
+struct SkinWeights {
+    uint8_t Joints[4] = {0, 0, 0, 0};
+    uint16_t Weights[4] = {65535, 0, 0, 0};
+
+    // Keeps the four heaviest of Count influences and renormalizes them.
+    static SkinWeights Pack(const uint32_t* Joints, const float* Weights, uint32_t Count);
+};
+
+static_assert(sizeof(SkinWeights) == 12);
+
+// A mesh and its skin stream, one SkinWeights per vertex.
+struct SkinnedMeshData {
+    MeshData Mesh;
+    std::vector<SkinWeights> Skin;
+};
+
+// GPU copy of a SkinnedMeshData: the Vertex stream at attributes 0-2 as for Mesh, joint
+// indices (uvec4) at JointsLocation and weights (vec4) at WeightsLocation.
+class SkinnedMesh {
+public:
+    static constexpr unsigned int JointsLocation = 3;
+    static constexpr unsigned int WeightsLocation = 4;
+
+    explicit SkinnedMesh(const SkinnedMeshData& Data);
+    ~SkinnedMesh();
+
+    SkinnedMesh(const SkinnedMesh&) = delete;
+    SkinnedMesh& operator=(const SkinnedMesh&) = delete;
+
+    void Bind() const;
+
+    [[nodiscard]] uint32_t GetIndexCount() const { return IndexCount; }
+
+    // Bind pose, model space
+    [[nodiscard]] const AABB& GetBounds() const { return Bounds; }
+
+private:
+    unsigned int VertexArray = 0;
+    unsigned int VertexBuffer = 0;
+    unsigned int SkinBuffer = 0;
+    unsigned int IndexBuffer = 0;
+    uint32_t IndexCount = 0;
+    AABB Bounds;
+};
+
+// JointCount joints stacked along +Y, each Height / JointCount above its parent.
+Skeleton GenerateChainSkeleton(float Height, uint32_t JointCount);
+
+// An open cylinder along +Y from 0 to Height, skinned to GenerateChainSkeleton's joints:
+// every vertex blends the two joints nearest its height.
+SkinnedMeshData GenerateSkinnedCylinder(float Radius, float Height, uint32_t Sectors, uint32_t Rings, uint32_t JointCount);
+
+} // namespace Volante
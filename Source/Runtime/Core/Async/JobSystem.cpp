@@ -0,0 +1,116 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <atomic>
+
+namespace Volante {
+
+JobSystem::JobSystem(uint32_t WorkerCount) {
+    if (WorkerCount == 0) {
+        WorkerCount = std::max(1u, std::thread::hardware_concurrency()) - 1;
+    }
+
+    Workers.reserve(WorkerCount);
+    for (uint32_t i = 0; i < WorkerCount; ++i) {
+        Workers.emplace_back([this] { WorkerLoop(); });
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard Lock(QueueMutex);
+        Stopping = true;
+    }
+    QueueCondition.notify_all();
+
+    for (auto& Worker : Workers) {
+        Worker.join();
+    }
+}
+
+void JobSystem::Submit(Job InJob) {
+    if (Workers.empty()) {
+        InJob();
+        return;
+    }
+
+    {
+        std::lock_guard Lock(QueueMutex);
+        Queue.push_back(std::move(InJob));
+        ++ActiveJobs;
+    }
+    QueueCondition.notify_one();
+}
+
+void JobSystem::WaitIdle() {
+    std::unique_lock Lock(QueueMutex);
+    IdleCondition.wait(Lock, [this] { return ActiveJobs == 0; });
+}
+
+void JobSystem::ParallelFor(uint32_t Count, uint32_t Grain, const RangeJob& Body) {
+    if (Count == 0) { return; }
+
+    Grain = std::max(1u, Grain);
+    const uint32_t ChunkCount = (Count + Grain - 1) / Grain;
+    if (ChunkCount == 1 || Workers.empty()) {
+        Body(0, Count);
+        return;
+    }
+
+    struct SharedState {
+        std::atomic<uint32_t> NextChunk{0};
+        std::atomic<uint32_t> DoneChunks{0};
+        std::mutex Mutex;
+        std::condition_variable Done;
+    };
+
+    // Helpers may still be draining NextChunk after the last chunk finished, so the state is
+    // kept alive by the helpers themselves rather than by this stack frame.
+    auto State = std::make_shared<SharedState>();
+
+    auto RunChunks = [State, ChunkCount, Count, Grain, &Body] {
+        uint32_t Completed = 0;
+        for (uint32_t Chunk = State->NextChunk.fetch_add(1); Chunk < ChunkCount;
+             Chunk = State->NextChunk.fetch_add(1)) {
+            const uint32_t Begin = Chunk * Grain;
+            Body(Begin, std::min(Begin + Grain, Count));
+            ++Completed;
+        }
+        if (Completed > 0 && State->DoneChunks.fetch_add(Completed) + Completed == ChunkCount) {
+            std::lock_guard Lock(State->Mutex);
+            State->Done.notify_all();
+        }
+    };
+
+    const uint32_t HelperCount = std::min(GetWorkerCount(), ChunkCount - 1);
+    for (uint32_t i = 0; i < HelperCount; ++i) {
+        Submit(RunChunks);
+    }
+
+    RunChunks();
+
+    std::unique_lock Lock(State->Mutex);
+    State->Done.wait(Lock, [&] { return State->DoneChunks.load() == ChunkCount; });
+}
+
+void JobSystem::WorkerLoop() {
+    for (;;) {
+        Job Current;
+        {
+            std::unique_lock Lock(QueueMutex);
+            QueueCondition.wait(Lock, [this] { return Stopping || !Queue.empty(); });
+            if (Stopping && Queue.empty()) { return; }
+            Current = std::move(Queue.front());
+            Queue.pop_front();
+        }
+
+        Current();
+
+        {
+            std::lock_guard Lock(QueueMutex);
+            if (--ActiveJobs == 0) { IdleCondition.notify_all(); }
+        }
+    }
+}
+
+} // namespace Volante
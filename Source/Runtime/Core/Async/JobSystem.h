@@ -0,0 +1,57 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Volante {
+
+// Fixed pool of worker threads. The calling thread always takes part in ParallelFor, so a
+// JobSystem with zero workers degrades to a plain loop.
+class JobSystem {
+public:
+    using Job = std::function<void()>;
+    using RangeJob = std::function<void(uint32_t Begin, uint32_t End)>;
+
+    // 0 picks hardware_concurrency - 1 workers.
+    explicit JobSystem(uint32_t WorkerCount = 0);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    void Submit(Job InJob);
+    void WaitIdle();
+
+    // Splits [0, Count) into chunks of at most Grain items and blocks until all of them ran.
+    void ParallelFor(uint32_t Count, uint32_t Grain, const RangeJob& Body);
+
+    [[nodiscard]] uint32_t GetWorkerCount() const { return static_cast<uint32_t>(Workers.size()); }
+
+private:
+    void WorkerLoop();
+
+    std::vector<std::thread> Workers;
+    std::deque<Job> Queue;
+    std::mutex QueueMutex;
+    std::condition_variable QueueCondition;
+    std::condition_variable IdleCondition;
+    uint32_t ActiveJobs = 0;
+    bool Stopping = false;
+};
+
+// Runs Body serially when no job system is available.
+inline void ParallelFor(JobSystem* Jobs, uint32_t Count, uint32_t Grain,
+                        const JobSystem::RangeJob& Body) {
+    if (Jobs) {
+        Jobs->ParallelFor(Count, Grain, Body);
+    } else if (Count > 0) {
+        Body(0, Count);
+    }
+}
+
+} // namespace Volante
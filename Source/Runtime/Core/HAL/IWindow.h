@@ -2,10 +2,13 @@
 
 #include "PlatformTypes.h"
 #include <functional>
+#include <memory>
 #include <string>
 
 namespace Volante {
 
+class IWindow;
+
 struct WindowDesc {
     int width = 800;
     int height = 600;
@@ -13,6 +16,13 @@ struct WindowDesc {
     bool fullscreen = false;
     bool vsync = true;
     int samples = 1;
+    // Hidden windows still render, for headless runs
+    bool visible = true;
+    // Fullscreen on this monitor; 0 is the primary, as is one that is not connected
+    int monitor = 0;
+    // Shares textures, buffers, programs and sync objects with this window's context. Vertex
+    // arrays and framebuffers are never shared between contexts.
+    const IWindow* share = nullptr;
 };
 
 class IGraphicsContext {
@@ -20,8 +30,13 @@ public:
     virtual ~IGraphicsContext() = default;
 
     virtual void MakeCurrent() = 0;
+    // Leaves the calling thread without a current context, so another thread can take this one.
+    virtual void ReleaseCurrent() = 0;
     virtual void SwapBuffers() = 0;
     virtual void SetVSync(bool Enabled) = 0;
+    // Vertical blanks each swap waits for: 0 does not wait, 2 presents at half the refresh
+    // rate. Belongs to this context, and takes effect whether or not it is current.
+    virtual void SetSwapInterval(int Interval) = 0;
 };
 
 class IWindow {
@@ -40,6 +55,10 @@ public:
 
     [[nodiscard]] virtual void* GetNativeHandle() const = 0;
     [[nodiscard]] virtual IGraphicsContext* GetGraphicsContext() const = 0;
+    // A context without a visible window that shares this window's objects (see
+    // WindowDesc::share), for another thread to make current, e.g. to upload on. Created on the
+    // thread that owns the windows; not current anywhere yet.
+    [[nodiscard]] virtual std::unique_ptr<IGraphicsContext> CreateSharedContext() const = 0;
     virtual void SwapBuffers() = 0;
 
     virtual void PollEvents() = 0;
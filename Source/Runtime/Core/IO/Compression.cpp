@@ -0,0 +1,335 @@
+#include "Compression.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <iterator>
+#include <vector>
+
+namespace Volante {
+
+namespace {
+
+constexpr uint32_t HashBits = 12;
+constexpr size_t MinMatch = 4;
+// The format ends every block with at least this many literals...
+constexpr size_t LastLiterals = 5;
+// ...and starts no match closer than this to the end
+constexpr size_t MatchSearchLimit = 12;
+constexpr size_t MaxOffset = 65535;
+
+uint32_t Read32(const uint8_t* Data) {
+    uint32_t Value;
+    std::memcpy(&Value, Data, sizeof(Value));
+    return Value;
+}
+
+uint64_t Read64(const uint8_t* Data) {
+    uint64_t Value;
+    std::memcpy(&Value, Data, sizeof(Value));
+    return Value;
+}
+
+uint32_t Hash(uint32_t Sequence) {
+    return (Sequence * 2654435761u) >> (32 - HashBits);
+}
+
+void WriteLength(uint8_t*& Out, size_t Length) {
+    for (; Length >= 255; Length -= 255) { *Out++ = 255; }
+    *Out++ = static_cast<uint8_t>(Length);
+}
+
+bool ReadLength(const uint8_t*& In, const uint8_t* InEnd, size_t& Length) {
+    uint8_t Byte;
+    do {
+        if (In == InEnd) { return false; }
+        Byte = *In++;
+        Length += Byte;
+    } while (Byte == 255);
+    return true;
+}
+
+// Token, extended literal length and the literals; the match part follows if Length > 0.
+bool WriteSequence(uint8_t*& Out, const uint8_t* OutEnd, const uint8_t* Literals, size_t LiteralLength, size_t Offset,
+                   size_t Length) {
+    const size_t Worst = 1 + LiteralLength / 255 + 1 + LiteralLength + 2 + Length / 255 + 1;
+    if (Worst > static_cast<size_t>(OutEnd - Out)) { return false; }
+    uint8_t* Token = Out++;
+    *Token = static_cast<uint8_t>(std::min<size_t>(LiteralLength, 15) << 4);
+    if (LiteralLength >= 15) { WriteLength(Out, LiteralLength - 15); }
+    if (LiteralLength > 0) { std::memcpy(Out, Literals, LiteralLength); }
+    Out += LiteralLength;
+    if (Length == 0) { return true; }
+    *Out++ = static_cast<uint8_t>(Offset);
+    *Out++ = static_cast<uint8_t>(Offset >> 8);
+    const size_t Extra = Length - MinMatch;
+    *Token |= static_cast<uint8_t>(std::min<size_t>(Extra, 15));
+    if (Extra >= 15) { WriteLength(Out, Extra - 15); }
+    return true;
+}
+
+// Deflate: matches of 3 to 258 bytes, up to 32 KB back
+constexpr uint32_t DeflateHashBits = 15;
+constexpr size_t DeflateMinMatch = 4;
+constexpr size_t DeflateMaxMatch = 258;
+constexpr size_t DeflateWindow = 32768;
+
+constexpr uint16_t LengthBase[] = {3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+                                   31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+constexpr uint8_t LengthExtra[] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+
+// Huffman codes go out most significant bit first, everything else least significant first
+uint32_t ReverseBits(uint32_t Value, uint32_t Length) {
+    uint32_t Result = 0;
+    for (uint32_t i = 0; i < Length; ++i) {
+        Result = (Result << 1) | ((Value >> i) & 1);
+    }
+    return Result;
+}
+
+// The fixed literal/length codes (RFC 1951, 3.2.6), bit-reversed, and the length symbol of
+// each match length
+struct FixedCodes {
+    uint16_t Codes[288] = {};
+    uint8_t Lengths[288] = {};
+    uint8_t LengthSymbols[DeflateMaxMatch + 1] = {};
+
+    FixedCodes() {
+        for (uint32_t Symbol = 0; Symbol < 288; ++Symbol) {
+            uint32_t Code = 0;
+            uint32_t Length = 0;
+            if (Symbol < 144) {
+                Code = 0x30 + Symbol;
+                Length = 8;
+            } else if (Symbol < 256) {
+                Code = 0x190 + Symbol - 144;
+                Length = 9;
+            } else if (Symbol < 280) {
+                Code = Symbol - 256;
+                Length = 7;
+            } else {
+                Code = 0xC0 + Symbol - 280;
+                Length = 8;
+            }
+            Codes[Symbol] = static_cast<uint16_t>(ReverseBits(Code, Length));
+            Lengths[Symbol] = static_cast<uint8_t>(Length);
+        }
+        for (size_t Index = 0; Index < std::size(LengthBase); ++Index) {
+            const size_t End = Index + 1 < std::size(LengthBase) ? LengthBase[Index + 1] : DeflateMaxMatch + 1;
+            for (size_t Length = LengthBase[Index]; Length < End; ++Length) { LengthSymbols[Length] = static_cast<uint8_t>(Index); }
+        }
+    }
+};
+
+class BitWriter {
+public:
+    BitWriter(uint8_t* Out, const uint8_t* OutEnd) : Out(Out), OutEnd(OutEnd) {}
+
+    void Put(uint32_t Value, uint32_t Length) {
+        Bits |= static_cast<uint64_t>(Value) << Count;
+        Count += Length;
+        while (Count >= 8) {
+            if (Out == OutEnd) {
+                Overflow = true;
+                Count = 0;
+                return;
+            }
+            *Out++ = static_cast<uint8_t>(Bits);
+            Bits >>= 8;
+            Count -= 8;
+        }
+    }
+
+    // Pads to a byte
+    void Finish() {
+        if (Count > 0) { Put(0, 8 - Count); }
+    }
+
+    [[nodiscard]] uint8_t* GetOut() const { return Out; }
+
+    [[nodiscard]] bool HasOverflowed() const { return Overflow; }
+
+private:
+    uint8_t* Out;
+    const uint8_t* OutEnd;
+    uint64_t Bits = 0;
+    uint32_t Count = 0;
+    bool Overflow = false;
+};
+
+void PutMatch(BitWriter& Writer, const FixedCodes& Fixed, size_t Length, size_t Distance) {
+    const uint32_t Index = Fixed.LengthSymbols[Length];
+    const uint32_t Symbol = 257 + Index;
+    Writer.Put(Fixed.Codes[Symbol], Fixed.Lengths[Symbol]);
+    if (LengthExtra[Index] > 0) { Writer.Put(static_cast<uint32_t>(Length - LengthBase[Index]), LengthExtra[Index]); }
+
+    // Distance codes pair up per power of two above 4; the fixed ones are all 5 bits
+    const auto Value = static_cast<uint32_t>(Distance - 1);
+    uint32_t Code = Value;
+    uint32_t ExtraBits = 0;
+    if (Value >= 4) {
+        const auto Top = static_cast<uint32_t>(std::bit_width(Value)) - 1;
+        ExtraBits = Top - 1;
+        Code = 2 * Top + ((Value >> ExtraBits) & 1);
+    }
+    Writer.Put(ReverseBits(Code, 5), 5);
+    if (ExtraBits > 0) { Writer.Put(Value & ((1u << ExtraBits) - 1), ExtraBits); }
+}
+
+uint32_t Adler32(const uint8_t* Data, size_t Size) {
+    uint32_t A = 1;
+    uint32_t B = 0;
+    while (Size > 0) {
+        // The largest run whose sums cannot overflow before the modulo
+        const size_t Run = std::min<size_t>(Size, 5552);
+        for (size_t i = 0; i < Run; ++i) {
+            A += Data[i];
+            B += A;
+        }
+        A %= 65521;
+        B %= 65521;
+        Data += Run;
+        Size -= Run;
+    }
+    return (B << 16) | A;
+}
+
+} // namespace
+
+size_t GetMaxCompressedSize(size_t SrcSize) {
+    return SrcSize + SrcSize / 255 + 16;
+}
+
+size_t CompressBlock(const uint8_t* Src, size_t SrcSize, uint8_t* Dst, size_t DstCapacity) {
+    uint8_t* Out = Dst;
+    const uint8_t* OutEnd = Dst + DstCapacity;
+    size_t Anchor = 0;
+    if (SrcSize > MatchSearchLimit) {
+        // Positions of the last sequence seen with each hash
+        thread_local std::vector<uint32_t> Table;
+        Table.assign(size_t(1) << HashBits, 0);
+        const size_t SearchEnd = SrcSize - MatchSearchLimit;
+        const size_t MatchEnd = SrcSize - LastLiterals;
+        size_t Position = 1;
+        while (Position < SearchEnd) {
+            const uint32_t Sequence = Read32(Src + Position);
+            uint32_t& Slot = Table[Hash(Sequence)];
+            size_t Candidate = Slot;
+            Slot = static_cast<uint32_t>(Position);
+            if (Position - Candidate > MaxOffset || Read32(Src + Candidate) != Sequence) {
+                // Step further through data that keeps missing
+                Position += 1 + ((Position - Anchor) >> 6);
+                continue;
+            }
+            while (Position > Anchor && Candidate > 0 && Src[Position - 1] == Src[Candidate - 1]) {
+                --Position;
+                --Candidate;
+            }
+            size_t Length = MinMatch;
+            while (Position + Length + 8 <= MatchEnd) {
+                const uint64_t Difference = Read64(Src + Position + Length) ^ Read64(Src + Candidate + Length);
+                if (Difference != 0) {
+                    // Little-endian: the lowest set bit is the first differing byte
+                    Length += std::countr_zero(Difference) / 8;
+                    break;
+                }
+                Length += 8;
+            }
+            while (Position + Length < MatchEnd && Src[Position + Length] == Src[Candidate + Length]) { ++Length; }
+            if (!WriteSequence(Out, OutEnd, Src + Anchor, Position - Anchor, Position - Candidate, Length)) { return 0; }
+            Position += Length;
+            Anchor = Position;
+        }
+    }
+    if (!WriteSequence(Out, OutEnd, Src + Anchor, SrcSize - Anchor, 0, 0)) { return 0; }
+    return static_cast<size_t>(Out - Dst);
+}
+
+bool DecompressBlock(const uint8_t* Src, size_t SrcSize, uint8_t* Dst, size_t DstSize) {
+    const uint8_t* In = Src;
+    const uint8_t* InEnd = Src + SrcSize;
+    uint8_t* Out = Dst;
+    uint8_t* OutEnd = Dst + DstSize;
+    while (In < InEnd) {
+        const uint8_t Token = *In++;
+        size_t LiteralLength = Token >> 4;
+        if (LiteralLength == 15 && !ReadLength(In, InEnd, LiteralLength)) { return false; }
+        if (LiteralLength > static_cast<size_t>(InEnd - In) || LiteralLength > static_cast<size_t>(OutEnd - Out)) { return false; }
+        if (LiteralLength > 0) { std::memcpy(Out, In, LiteralLength); }
+        In += LiteralLength;
+        Out += LiteralLength;
+        // The last sequence has no match
+        if (In == InEnd) { break; }
+
+        if (InEnd - In < 2) { return false; }
+        const size_t Offset = In[0] | (size_t(In[1]) << 8);
+        In += 2;
+        if (Offset == 0 || Offset > static_cast<size_t>(Out - Dst)) { return false; }
+        size_t Length = Token & 15;
+        if (Length == 15 && !ReadLength(In, InEnd, Length)) { return false; }
+        Length += MinMatch;
+        if (Length > static_cast<size_t>(OutEnd - Out)) { return false; }
+        const uint8_t* Match = Out - Offset;
+        if (Offset >= Length) {
+            std::memcpy(Out, Match, Length);
+            Out += Length;
+        } else {
+            // Overlapping: the match repeats bytes it is writing
+            for (size_t i = 0; i < Length; ++i) { *Out++ = Match[i]; }
+        }
+    }
+    return Out == OutEnd;
+}
+
+size_t GetMaxZlibSize(size_t SrcSize) {
+    // Literals take at most 9 bits and matches fewer bits than the bytes they replace
+    return SrcSize + SrcSize / 8 + 16;
+}
+
+size_t CompressZlib(const uint8_t* Src, size_t SrcSize, uint8_t* Dst, size_t DstCapacity) {
+    static const FixedCodes Fixed;
+    if (DstCapacity < 6) { return 0; }
+    // Deflate, 32 KB window, default level; the check bits make the pair a multiple of 31
+    Dst[0] = 0x78;
+    Dst[1] = 0x01;
+    BitWriter Writer(Dst + 2, Dst + DstCapacity - 4);
+    // The only block, with the fixed codes
+    Writer.Put(1, 1);
+    Writer.Put(1, 2);
+
+    size_t Position = 0;
+    if (SrcSize > DeflateMinMatch) {
+        thread_local std::vector<uint32_t> Table;
+        // Positions plus one, so zero means none
+        Table.assign(size_t(1) << DeflateHashBits, 0);
+        const size_t SearchEnd = SrcSize - DeflateMinMatch;
+        while (Position <= SearchEnd && !Writer.HasOverflowed()) {
+            const uint32_t Sequence = Read32(Src + Position);
+            uint32_t& Slot = Table[(Sequence * 2654435761u) >> (32 - DeflateHashBits)];
+            const size_t Candidate = Slot;
+            Slot = static_cast<uint32_t>(Position + 1);
+            if (Candidate == 0 || Position + 1 - Candidate > DeflateWindow || Read32(Src + Candidate - 1) != Sequence) {
+                Writer.Put(Fixed.Codes[Src[Position]], Fixed.Lengths[Src[Position]]);
+                ++Position;
+                continue;
+            }
+            const uint8_t* Match = Src + Candidate - 1;
+            const size_t Limit = std::min(DeflateMaxMatch, SrcSize - Position);
+            size_t Length = DeflateMinMatch;
+            while (Length < Limit && Src[Position + Length] == Match[Length]) { ++Length; }
+            PutMatch(Writer, Fixed, Length, static_cast<size_t>(Src + Position - Match));
+            Position += Length;
+        }
+    }
+    for (; Position < SrcSize; ++Position) { Writer.Put(Fixed.Codes[Src[Position]], Fixed.Lengths[Src[Position]]); }
+    Writer.Put(Fixed.Codes[256], Fixed.Lengths[256]);
+    Writer.Finish();
+    if (Writer.HasOverflowed()) { return 0; }
+
+    uint8_t* Out = Writer.GetOut();
+    const uint32_t Checksum = Adler32(Src, SrcSize);
+    for (int Shift = 24; Shift >= 0; Shift -= 8) { *Out++ = static_cast<uint8_t>(Checksum >> Shift); }
+    return static_cast<size_t>(Out - Dst);
+}
+
+} // namespace Volante
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Volante {
+
+// LZ4 block format: a greedy single-probe matcher that trades ratio for speed, meant for
+// snapshots that are written and read back within a session. Blocks carry no header; the
+// caller stores both sizes.
+
+// Worst case output for SrcSize input bytes.
+[[nodiscard]] size_t GetMaxCompressedSize(size_t SrcSize);
+
+// Returns the compressed size, or 0 if it would not fit in DstCapacity. Blocks must be
+// smaller than 4 GB.
+size_t CompressBlock(const uint8_t* Src, size_t SrcSize, uint8_t* Dst, size_t DstCapacity);
+
+// Returns false unless Src decodes to exactly DstSize bytes. Never reads or writes out of
+// bounds, whatever Src holds.
+bool DecompressBlock(const uint8_t* Src, size_t SrcSize, uint8_t* Dst, size_t DstSize);
+
+// zlib stream (RFC 1950) holding one deflate block with the fixed Huffman codes, from a greedy
+// matcher like the one above: for formats other tools read, such as PNG. Built for speed over
+// ratio, like the LZ4 blocks. There is no decoder here.
+
+// Worst case output for SrcSize input bytes.
+[[nodiscard]] size_t GetMaxZlibSize(size_t SrcSize);
+
+// Returns the stream's size, or 0 if it would not fit in DstCapacity.
+size_t CompressZlib(const uint8_t* Src, size_t SrcSize, uint8_t* Dst, size_t DstCapacity);
+
+} // namespace Volante
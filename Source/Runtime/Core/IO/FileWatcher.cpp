@@ -0,0 +1,152 @@
+#include "FileWatcher.h"
+
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+
+#if defined(__linux__)
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace Volante {
+
+namespace {
+
+constexpr auto PollInterval = std::chrono::milliseconds(250);
+
+int64_t GetWriteTime(const std::string& Path) {
+    std::error_code Error;
+    const auto Time = std::filesystem::last_write_time(Path, Error);
+    return Error ? 0 : static_cast<int64_t>(Time.time_since_epoch().count());
+}
+
+} // namespace
+
+FileWatcher::FileWatcher() {
+#if defined(__linux__)
+    Inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    WakeEvent = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (Inotify < 0 || WakeEvent < 0) { std::cerr << "ERROR::FILE_WATCHER::INOTIFY_UNAVAILABLE: polling instead" << std::endl; }
+#endif
+    Thread = std::thread([this] { ThreadMain(); });
+}
+
+FileWatcher::~FileWatcher() {
+    Stopping = true;
+#if defined(__linux__)
+    if (WakeEvent >= 0) {
+        const uint64_t One = 1;
+        [[maybe_unused]] const ssize_t Written = write(WakeEvent, &One, sizeof(One));
+    }
+#endif
+    Thread.join();
+#if defined(__linux__)
+    if (Inotify >= 0) { close(Inotify); }
+    if (WakeEvent >= 0) { close(WakeEvent); }
+#endif
+}
+
+std::string FileWatcher::Normalize(const std::string& Path) {
+    std::error_code Error;
+    const std::filesystem::path Absolute = std::filesystem::absolute(Path, Error);
+    return (Error ? std::filesystem::path(Path) : Absolute).lexically_normal().generic_string();
+}
+
+void FileWatcher::Watch(const std::string& Path) {
+    const std::string File = Normalize(Path);
+    std::lock_guard Lock(Mutex);
+    if (!Files.insert(File).second) { return; }
+    WriteTimes[File] = GetWriteTime(File);
+#if defined(__linux__)
+    AddDirectoryWatch(std::filesystem::path(File).parent_path().generic_string());
+#endif
+}
+
+void FileWatcher::Unwatch(const std::string& Path) {
+    const std::string File = Normalize(Path);
+    std::lock_guard Lock(Mutex);
+    Files.erase(File);
+    WriteTimes.erase(File);
+    Changes.erase(File);
+    // Directory watches stay; events for files no longer watched are ignored
+}
+
+std::vector<std::string> FileWatcher::PollChanges() {
+    std::lock_guard Lock(Mutex);
+    std::vector<std::string> Result(Changes.begin(), Changes.end());
+    Changes.clear();
+    return Result;
+}
+
+void FileWatcher::AddChange(const std::string& Path) {
+    if (Files.count(Path) != 0) { Changes.insert(Path); }
+}
+
+void FileWatcher::PollModificationTimes() {
+    std::lock_guard Lock(Mutex);
+    for (auto& [File, WriteTime] : WriteTimes) {
+        const int64_t Current = GetWriteTime(File);
+        // A file that is mid-rename can briefly not exist; wait for it to come back
+        if (Current != 0 && Current != WriteTime) {
+            WriteTime = Current;
+            AddChange(File);
+        }
+    }
+}
+
+#if defined(__linux__)
+
+void FileWatcher::AddDirectoryWatch(const std::string& Directory) {
+    if (Inotify < 0 || DirectoryWatches.count(Directory) != 0) { return; }
+    const int Watch = inotify_add_watch(Inotify, Directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (Watch < 0) {
+        std::cerr << "ERROR::FILE_WATCHER::WATCH_FAILED: " << Directory << std::endl;
+        return;
+    }
+    Directories[Watch] = Directory;
+    DirectoryWatches[Directory] = Watch;
+}
+
+void FileWatcher::ThreadMain() {
+    if (Inotify < 0 || WakeEvent < 0) {
+        while (!Stopping) {
+            PollModificationTimes();
+            std::this_thread::sleep_for(PollInterval);
+        }
+        return;
+    }
+
+    alignas(inotify_event) char Buffer[16 * 1024];
+    pollfd Descriptors[2] = {{Inotify, POLLIN, 0}, {WakeEvent, POLLIN, 0}};
+    while (!Stopping) {
+        if (poll(Descriptors, 2, -1) <= 0 || Stopping) { continue; }
+        for (;;) {
+            const ssize_t Length = read(Inotify, Buffer, sizeof(Buffer));
+            if (Length <= 0) { break; }
+            std::lock_guard Lock(Mutex);
+            for (ssize_t Offset = 0; Offset < Length;) {
+                const auto* Event = reinterpret_cast<const inotify_event*>(Buffer + Offset);
+                Offset += static_cast<ssize_t>(sizeof(inotify_event) + Event->len);
+                const auto It = Directories.find(Event->wd);
+                if (It == Directories.end() || Event->len == 0) { continue; }
+                AddChange(It->second + "/" + Event->name);
+            }
+        }
+    }
+}
+
+#else
+
+void FileWatcher::ThreadMain() {
+    while (!Stopping) {
+        PollModificationTimes();
+        std::this_thread::sleep_for(PollInterval);
+    }
+}
+
+#endif
+
+} // namespace Volante
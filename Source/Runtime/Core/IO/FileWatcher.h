@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace Volante {
+
+// Reports when watched files are rewritten. On Linux a background thread blocks on inotify,
+// watching each file's directory so editors that save by writing a temporary file and renaming
+// it over the original are still seen. Elsewhere the thread polls modification times.
+//
+// Changes are collected on the watcher thread and handed over by PollChanges, which never
+// blocks; a file saved several times between polls is reported once.
+class FileWatcher {
+public:
+    FileWatcher();
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    // Paths are compared after normalization, so any spelling of the same file works.
+    void Watch(const std::string& Path);
+    void Unwatch(const std::string& Path);
+
+    // Normalized paths of watched files that changed since the last call.
+    std::vector<std::string> PollChanges();
+
+    [[nodiscard]] static std::string Normalize(const std::string& Path);
+
+private:
+    void ThreadMain();
+    void PollModificationTimes();
+    void AddChange(const std::string& Path);
+
+    std::mutex Mutex;
+    std::unordered_set<std::string> Files;
+    std::unordered_set<std::string> Changes;
+    // Last seen modification time, for the polling fallback
+    std::unordered_map<std::string, int64_t> WriteTimes;
+
+#if defined(__linux__)
+    void AddDirectoryWatch(const std::string& Directory);
+
+    int Inotify = -1;
+    // Wakes the thread for shutdown
+    int WakeEvent = -1;
+    std::unordered_map<int, std::string> Directories;
+    std::unordered_map<std::string, int> DirectoryWatches;
+#endif
+
+    std::atomic<bool> Stopping{false};
+    std::thread Thread;
+};
+
+} // namespace Volante
@@ -0,0 +1,86 @@
+#include "MappedFile.h"
+
+#include <iostream>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Volante {
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+bool MappedFile::Open(const std::string& Path) {
+    Close();
+#if defined(_WIN32)
+    File = CreateFileA(Path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (File == INVALID_HANDLE_VALUE) {
+        File = nullptr;
+        std::cerr << "ERROR::MAPPED_FILE::OPEN_FAILED: " << Path << std::endl;
+        return false;
+    }
+    LARGE_INTEGER FileSize;
+    GetFileSizeEx(File, &FileSize);
+    Size = static_cast<size_t>(FileSize.QuadPart);
+    if (Size > 0) {
+        Mapping = CreateFileMappingA(File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        Data = Mapping ? static_cast<const uint8_t*>(MapViewOfFile(Mapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+        if (!Data) {
+            std::cerr << "ERROR::MAPPED_FILE::MAP_FAILED: " << Path << std::endl;
+            Close();
+            return false;
+        }
+    }
+#else
+    const int Descriptor = open(Path.c_str(), O_RDONLY);
+    if (Descriptor < 0) {
+        std::cerr << "ERROR::MAPPED_FILE::OPEN_FAILED: " << Path << std::endl;
+        return false;
+    }
+    struct stat Info {};
+    fstat(Descriptor, &Info);
+    Size = static_cast<size_t>(Info.st_size);
+    if (Size > 0) {
+        void* Mapped = mmap(nullptr, Size, PROT_READ, MAP_PRIVATE, Descriptor, 0);
+        if (Mapped == MAP_FAILED) {
+            close(Descriptor);
+            Size = 0;
+            std::cerr << "ERROR::MAPPED_FILE::MAP_FAILED: " << Path << std::endl;
+            return false;
+        }
+        // Loaders read front to back
+        madvise(Mapped, Size, MADV_SEQUENTIAL);
+        Data = static_cast<const uint8_t*>(Mapped);
+    }
+    // The mapping keeps the file alive
+    close(Descriptor);
+#endif
+    Opened = true;
+    return true;
+}
+
+void MappedFile::Close() {
+#if defined(_WIN32)
+    if (Data) { UnmapViewOfFile(Data); }
+    if (Mapping) { CloseHandle(Mapping); }
+    if (File) { CloseHandle(File); }
+    Mapping = nullptr;
+    File = nullptr;
+#else
+    if (Data) { munmap(const_cast<uint8_t*>(Data), Size); }
+#endif
+    Data = nullptr;
+    Size = 0;
+    Opened = false;
+}
+
+} // namespace Volante
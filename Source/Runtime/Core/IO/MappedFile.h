@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Volante {
+
+// A whole file mapped read-only into memory, so a loader reads it in place without copying
+// it into a buffer first. Pages are faulted in as they are touched.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Unmaps anything mapped before. Returns false if the file cannot be opened or mapped.
+    bool Open(const std::string& Path);
+    void Close();
+
+    [[nodiscard]] const uint8_t* GetData() const { return Data; }
+
+    [[nodiscard]] size_t GetSize() const { return Size; }
+
+    [[nodiscard]] bool IsOpen() const { return Opened; }
+
+private:
+    const uint8_t* Data = nullptr;
+    size_t Size = 0;
+    bool Opened = false;
+#if defined(_WIN32)
+    void* File = nullptr;
+    void* Mapping = nullptr;
+#endif
+};
+
+} // namespace Volante
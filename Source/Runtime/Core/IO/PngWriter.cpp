@@ -0,0 +1,102 @@
+#include "PngWriter.h"
+
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include "Compression.h"
+
+namespace Volante {
+
+namespace {
+
+constexpr uint8_t Signature[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+constexpr uint8_t SubFilter = 1;
+
+const std::array<uint32_t, 256>& GetCrcTable() {
+    static const std::array<uint32_t, 256> Table = [] {
+        std::array<uint32_t, 256> Result = {};
+        for (uint32_t Index = 0; Index < 256; ++Index) {
+            uint32_t Value = Index;
+            for (int Bit = 0; Bit < 8; ++Bit) { Value = (Value & 1) ? 0xEDB88320u ^ (Value >> 1) : Value >> 1; }
+            Result[Index] = Value;
+        }
+        return Result;
+    }();
+    return Table;
+}
+
+void Put32(std::vector<uint8_t>& Out, uint32_t Value) {
+    for (int Shift = 24; Shift >= 0; Shift -= 8) { Out.push_back(static_cast<uint8_t>(Value >> Shift)); }
+}
+
+// Length, type, data and the CRC of type and data
+void PutChunk(std::vector<uint8_t>& Out, const char* Type, const uint8_t* Data, size_t Size) {
+    Put32(Out, static_cast<uint32_t>(Size));
+    const size_t Begin = Out.size();
+    Out.insert(Out.end(), Type, Type + 4);
+    if (Size > 0) { Out.insert(Out.end(), Data, Data + Size); }
+    const std::array<uint32_t, 256>& Table = GetCrcTable();
+    uint32_t Crc = 0xFFFFFFFFu;
+    for (size_t i = Begin; i < Out.size(); ++i) { Crc = Table[(Crc ^ Out[i]) & 0xFF] ^ (Crc >> 8); }
+    Put32(Out, Crc ^ 0xFFFFFFFFu);
+}
+
+} // namespace
+
+bool EncodePng(std::vector<uint8_t>& Out, const uint8_t* Pixels, uint32_t Width, uint32_t Height, uint32_t Channels,
+               bool BottomUp) {
+    Out.clear();
+    if (Width == 0 || Height == 0 || (Channels != 3 && Channels != 4)) { return false; }
+
+    // Each row: its filter type, then every byte minus the one a pixel to its left
+    const size_t RowSize = static_cast<size_t>(Width) * Channels;
+    thread_local std::vector<uint8_t> Filtered;
+    thread_local std::vector<uint8_t> Compressed;
+    Filtered.resize((RowSize + 1) * Height);
+    uint8_t* Row = Filtered.data();
+    for (uint32_t y = 0; y < Height; ++y) {
+        const uint8_t* Source = Pixels + RowSize * (BottomUp ? Height - 1 - y : y);
+        *Row++ = SubFilter;
+        std::memcpy(Row, Source, Channels);
+        for (size_t x = Channels; x < RowSize; ++x) { Row[x] = static_cast<uint8_t>(Source[x] - Source[x - Channels]); }
+        Row += RowSize;
+    }
+    Compressed.resize(GetMaxZlibSize(Filtered.size()));
+    const size_t CompressedSize = CompressZlib(Filtered.data(), Filtered.size(), Compressed.data(), Compressed.size());
+    if (CompressedSize == 0) { return false; }
+
+    // Size, 8 bits per channel, RGB or RGBA, deflate, adaptive filtering, no interlace
+    uint8_t Header[13] = {};
+    for (int i = 0; i < 4; ++i) {
+        Header[i] = static_cast<uint8_t>(Width >> (24 - 8 * i));
+        Header[4 + i] = static_cast<uint8_t>(Height >> (24 - 8 * i));
+    }
+    Header[8] = 8;
+    Header[9] = Channels == 4 ? 6 : 2;
+
+    Out.reserve(sizeof(Signature) + 3 * 12 + sizeof(Header) + CompressedSize);
+    Out.insert(Out.end(), std::begin(Signature), std::end(Signature));
+    PutChunk(Out, "IHDR", Header, sizeof(Header));
+    PutChunk(Out, "IDAT", Compressed.data(), CompressedSize);
+    PutChunk(Out, "IEND", nullptr, 0);
+    return true;
+}
+
+bool WritePng(const std::string& Path, const uint8_t* Pixels, uint32_t Width, uint32_t Height, uint32_t Channels,
+              bool BottomUp) {
+    thread_local std::vector<uint8_t> Encoded;
+    if (!EncodePng(Encoded, Pixels, Width, Height, Channels, BottomUp)) {
+        std::cerr << "ERROR::PNG_WRITER::ENCODE_FAILED: " << Path << std::endl;
+        return false;
+    }
+    std::ofstream File(Path, std::ios::binary | std::ios::trunc);
+    if (!File.write(reinterpret_cast<const char*>(Encoded.data()), static_cast<std::streamsize>(Encoded.size()))) {
+        std::cerr << "ERROR::PNG_WRITER::WRITE_FAILED: " << Path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace Volante
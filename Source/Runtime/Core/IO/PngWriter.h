@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Volante {
+
+// 8-bit RGB or RGBA PNG encoding for screenshots and captured frames. Rows are filtered with
+// the Sub predictor and deflated by CompressZlib, which favours speed over size.
+
+// Replaces Out with the file's bytes. Channels is 3 or 4. Rows run top to bottom unless
+// BottomUp is set, which is the order GL reads them back in.
+bool EncodePng(std::vector<uint8_t>& Out, const uint8_t* Pixels, uint32_t Width, uint32_t Height, uint32_t Channels,
+               bool BottomUp = false);
+
+bool WritePng(const std::string& Path, const uint8_t* Pixels, uint32_t Width, uint32_t Height, uint32_t Channels,
+              bool BottomUp = false);
+
+} // namespace Volante
@@ -0,0 +1,172 @@
+#include "InputRecording.h"
+
+#include <cstring>
+#include <iostream>
+
+namespace Volante {
+
+namespace {
+
+// "VINP", little-endian
+constexpr uint32_t InputMagic = 0x504E4956;
+constexpr uint32_t InputFormatVersion = 1;
+
+template <typename T>
+void Append(std::vector<uint8_t>& Out, const T& Value) {
+    const auto* Bytes = reinterpret_cast<const uint8_t*>(&Value);
+    Out.insert(Out.end(), Bytes, Bytes + sizeof(T));
+}
+
+void AppendVarint(std::vector<uint8_t>& Out, uint32_t Value) {
+    for (; Value >= 0x80; Value >>= 7) { Out.push_back(static_cast<uint8_t>(Value | 0x80)); }
+    Out.push_back(static_cast<uint8_t>(Value));
+}
+
+class Reader {
+public:
+    Reader(const uint8_t* InData, size_t InSize, size_t& InPosition) : Data(InData), Size(InSize), Position(InPosition) {}
+
+    template <typename T>
+    bool Read(T& Value) {
+        if (sizeof(T) > Size - Position) { return false; }
+        std::memcpy(&Value, Data + Position, sizeof(T));
+        Position += sizeof(T);
+        return true;
+    }
+
+    bool ReadVarint(uint32_t& Value) {
+        Value = 0;
+        for (uint32_t Shift = 0; Shift < 35; Shift += 7) {
+            uint8_t Byte;
+            if (!Read(Byte)) { return false; }
+            Value |= static_cast<uint32_t>(Byte & 0x7F) << Shift;
+            if ((Byte & 0x80) == 0) { return true; }
+        }
+        return false;
+    }
+
+private:
+    const uint8_t* Data;
+    size_t Size;
+    size_t& Position;
+};
+
+} // namespace
+
+InputRecorder::~InputRecorder() {
+    Close();
+}
+
+bool InputRecorder::Open(const std::string& Path, const InputRecordingHeader& Header) {
+    File.open(Path, std::ios::binary | std::ios::trunc);
+    if (!File) {
+        std::cerr << "ERROR::INPUT_RECORDER::OPEN_FAILED: " << Path << std::endl;
+        return false;
+    }
+    Buffer.clear();
+    Append(Buffer, InputMagic);
+    Append(Buffer, InputFormatVersion);
+    Append(Buffer, Header);
+    FrameCount = 0;
+    return true;
+}
+
+void InputRecorder::WriteFrame(float DeltaTime, const std::vector<InputEvent>& Events) {
+    if (!File.is_open()) { return; }
+    Append(Buffer, DeltaTime);
+    AppendVarint(Buffer, static_cast<uint32_t>(Events.size()));
+    for (const InputEvent& Event : Events) {
+        Buffer.push_back(static_cast<uint8_t>(Event.Type));
+        switch (Event.Type) {
+        case InputEventType::Key:
+        case InputEventType::MouseButton:
+            // Offset so None (-1) fits a byte
+            Buffer.push_back(static_cast<uint8_t>(Event.Code + 1));
+            Buffer.push_back(static_cast<uint8_t>(Event.Action));
+            break;
+        case InputEventType::CursorPos:
+            // Doubles, so playback sees exactly what the session did
+            Append(Buffer, Event.X);
+            Append(Buffer, Event.Y);
+            break;
+        case InputEventType::Resize:
+            AppendVarint(Buffer, static_cast<uint32_t>(Event.Width));
+            AppendVarint(Buffer, static_cast<uint32_t>(Event.Height));
+            break;
+        }
+    }
+    ++FrameCount;
+    // Written in batches; the stream buffers again underneath
+    if (Buffer.size() >= 64 * 1024) {
+        File.write(reinterpret_cast<const char*>(Buffer.data()), static_cast<std::streamsize>(Buffer.size()));
+        Buffer.clear();
+    }
+}
+
+void InputRecorder::Close() {
+    if (!File.is_open()) { return; }
+    File.write(reinterpret_cast<const char*>(Buffer.data()), static_cast<std::streamsize>(Buffer.size()));
+    Buffer.clear();
+    File.close();
+}
+
+bool InputPlayback::Open(const std::string& Path) {
+    Position = 0;
+    FrameCount = 0;
+    if (!File.Open(Path)) { return false; }
+    Reader Header(File.GetData(), File.GetSize(), Position);
+    uint32_t Magic = 0;
+    uint32_t Version = 0;
+    if (!Header.Read(Magic) || Magic != InputMagic || !Header.Read(Version) || Version != InputFormatVersion ||
+        !Header.Read(this->Header)) {
+        std::cerr << "ERROR::INPUT_PLAYBACK::NOT_A_RECORDING: " << Path << std::endl;
+        File.Close();
+        return false;
+    }
+    return true;
+}
+
+bool InputPlayback::ReadFrame(float& DeltaTime, std::vector<InputEvent>& Events) {
+    Events.clear();
+    if (!File.IsOpen()) { return false; }
+    // Commit the position only once the whole frame has been read
+    size_t Cursor = Position;
+    Reader Frame(File.GetData(), File.GetSize(), Cursor);
+    uint32_t Count = 0;
+    if (!Frame.Read(DeltaTime) || !Frame.ReadVarint(Count)) { return false; }
+    for (uint32_t i = 0; i < Count; ++i) {
+        InputEvent& Event = Events.emplace_back();
+        uint8_t Type = 0;
+        if (!Frame.Read(Type)) { return false; }
+        Event.Type = static_cast<InputEventType>(Type);
+        switch (Event.Type) {
+        case InputEventType::Key:
+        case InputEventType::MouseButton: {
+            uint8_t Code = 0;
+            int8_t Action = 0;
+            if (!Frame.Read(Code) || !Frame.Read(Action)) { return false; }
+            Event.Code = static_cast<int32_t>(Code) - 1;
+            Event.Action = static_cast<InputAction>(Action);
+            break;
+        }
+        case InputEventType::CursorPos:
+            if (!Frame.Read(Event.X) || !Frame.Read(Event.Y)) { return false; }
+            break;
+        case InputEventType::Resize: {
+            uint32_t Width = 0;
+            uint32_t Height = 0;
+            if (!Frame.ReadVarint(Width) || !Frame.ReadVarint(Height)) { return false; }
+            Event.Width = static_cast<int32_t>(Width);
+            Event.Height = static_cast<int32_t>(Height);
+            break;
+        }
+        default:
+            return false;
+        }
+    }
+    Position = Cursor;
+    ++FrameCount;
+    return true;
+}
+
+} // namespace Volante
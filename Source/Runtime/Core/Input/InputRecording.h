@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "Runtime/Core/HAL/PlatformTypes.h"
+#include "Runtime/Core/IO/MappedFile.h"
+
+namespace Volante {
+
+enum class InputEventType : uint8_t {
+    Key,
+    MouseButton,
+    CursorPos,
+    // Framebuffer size
+    Resize,
+};
+
+// One IWindow callback.
+struct InputEvent {
+    InputEventType Type = InputEventType::Key;
+    // KeyCode or MouseButton
+    int32_t Code = 0;
+    InputAction Action = InputAction::None;
+    double X = 0.0;
+    double Y = 0.0;
+    int32_t Width = 0;
+    int32_t Height = 0;
+};
+
+// What a recorded session started from.
+struct InputRecordingHeader {
+    int32_t FramebufferWidth = 0;
+    int32_t FramebufferHeight = 0;
+    double CursorX = 0.0;
+    double CursorY = 0.0;
+};
+
+// Writes one record per frame: the frame's DeltaTime bits, then its events. A frame without
+// input costs five bytes, so hours of play stay a few megabytes. Buffered frames are written on
+// Close(), which destruction also does.
+class InputRecorder {
+public:
+    InputRecorder() = default;
+    ~InputRecorder();
+
+    InputRecorder(const InputRecorder&) = delete;
+    InputRecorder& operator=(const InputRecorder&) = delete;
+
+    bool Open(const std::string& Path, const InputRecordingHeader& Header);
+    void WriteFrame(float DeltaTime, const std::vector<InputEvent>& Events);
+    void Close();
+
+    [[nodiscard]] bool IsOpen() const { return File.is_open(); }
+
+    [[nodiscard]] uint64_t GetFrameCount() const { return FrameCount; }
+
+private:
+    std::ofstream File;
+    std::vector<uint8_t> Buffer;
+    uint64_t FrameCount = 0;
+};
+
+// Reads a recording back frame by frame. A frame cut short by a crash ends the playback.
+class InputPlayback {
+public:
+    bool Open(const std::string& Path);
+    // False once the recording is exhausted.
+    bool ReadFrame(float& DeltaTime, std::vector<InputEvent>& Events);
+
+    [[nodiscard]] const InputRecordingHeader& GetHeader() const { return Header; }
+
+    [[nodiscard]] uint64_t GetFrameCount() const { return FrameCount; }
+
+private:
+    MappedFile File;
+    InputRecordingHeader Header;
+    size_t Position = 0;
+    uint64_t FrameCount = 0;
+};
+
+} // namespace Volante
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <algorithm>
+#include <limits>
+
+#include "Volante.h"
+
+namespace Volante {
+
+struct AABB {
+    Vec3 Min = Vec3(std::numeric_limits<float>::max());
+    Vec3 Max = Vec3(-std::numeric_limits<float>::max());
+
+    AABB() = default;
+    AABB(const Vec3& InMin, const Vec3& InMax) : Min(InMin), Max(InMax) {}
+
+    static AABB FromCenterExtent(const Vec3& Center, const Vec3& Extent) {
+        return {Center - Extent, Center + Extent};
+    }
+
+    [[nodiscard]] bool IsValid() const { return Min.x <= Max.x && Min.y <= Max.y && Min.z <= Max.z; }
+
+    [[nodiscard]] Vec3 GetCenter() const { return (Min + Max) * 0.5f; }
+
+    [[nodiscard]] Vec3 GetExtent() const { return (Max - Min) * 0.5f; }
+
+    void Expand(const Vec3& Point) {
+        Min = glm::min(Min, Point);
+        Max = glm::max(Max, Point);
+    }
+
+    void Expand(const AABB& Other) {
+        Min = glm::min(Min, Other.Min);
+        Max = glm::max(Max, Other.Max);
+    }
+
+    [[nodiscard]] bool Contains(const Vec3& Point) const {
+        return Point.x >= Min.x && Point.x <= Max.x && Point.y >= Min.y && Point.y <= Max.y &&
+               Point.z >= Min.z && Point.z <= Max.z;
+    }
+
+    [[nodiscard]] bool Intersects(const AABB& Other) const {
+        return Min.x <= Other.Max.x && Max.x >= Other.Min.x && Min.y <= Other.Max.y &&
+               Max.y >= Other.Min.y && Min.z <= Other.Max.z && Max.z >= Other.Min.z;
+    }
+
+    [[nodiscard]] float DistanceSquared(const Vec3& Point) const {
+        const Vec3 D = glm::max(glm::max(Min - Point, Point - Max), Vec3(0.0f));
+        return dot(D, D);
+    }
+
+    [[nodiscard]] bool IntersectsSphere(const Vec3& Center, float Radius) const {
+        return DistanceSquared(Center) <= Radius * Radius;
+    }
+
+    // World-space bounds of this box after an affine transform.
+    [[nodiscard]] AABB Transform(const Mat4& M) const {
+        const Vec3 Center = Vec3(M * Vec4(GetCenter(), 1.0f));
+        const Vec3 Extent = GetExtent();
+        const Vec3 NewExtent = glm::abs(Vec3(M[0])) * Extent.x + glm::abs(Vec3(M[1])) * Extent.y +
+                               glm::abs(Vec3(M[2])) * Extent.z;
+        return FromCenterExtent(Center, NewExtent);
+    }
+};
+
+struct Ray {
+    Vec3 Origin = Vec3(0.0f);
+    Vec3 Direction = Vec3(0.0f, 0.0f, -1.0f);
+
+    Ray() = default;
+    Ray(const Vec3& InOrigin, const Vec3& InDirection) : Origin(InOrigin), Direction(InDirection) {}
+
+    [[nodiscard]] Vec3 GetInverseDirection() const { return Vec3(1.0f) / Direction; }
+
+    [[nodiscard]] Vec3 At(float T) const { return Origin + Direction * T; }
+};
+
+// Slab test. InvDir is precomputed so it can be shared across many boxes.
+inline bool IntersectRayAABB(const Vec3& Origin, const Vec3& InvDir, const AABB& Box, float MaxT,
+                             float& OutT) {
+    const Vec3 T0 = (Box.Min - Origin) * InvDir;
+    const Vec3 T1 = (Box.Max - Origin) * InvDir;
+    const Vec3 TMin = glm::min(T0, T1);
+    const Vec3 TMax = glm::max(T0, T1);
+    const float Enter = std::max(std::max(TMin.x, TMin.y), std::max(TMin.z, 0.0f));
+    const float Exit = std::min(std::min(TMax.x, TMax.y), std::min(TMax.z, MaxT));
+    if (Enter > Exit) { return false; }
+    OutT = Enter;
+    return true;
+}
+
+struct Plane {
+    Vec3 Normal = Vec3(0.0f, 1.0f, 0.0f);
+    float Distance = 0.0f;
+
+    [[nodiscard]] float SignedDistance(const Vec3& Point) const { return dot(Normal, Point) + Distance; }
+};
+
+enum class Containment { Outside, Intersects, Inside };
+
+struct Frustum {
+    enum { Left, Right, Bottom, Top, Near, Far, PlaneCount };
+
+    Plane Planes[PlaneCount];
+
+    // Gribb/Hartmann plane extraction from a combined view-projection matrix with reverse-Z
+    // clip depth (near at z = w, far at z = 0; see DepthConvention.h). An infinite projection
+    // has no far plane: it is left with a zero normal, which every box is inside.
+    static Frustum FromMatrix(const Mat4& ViewProjection) {
+        Frustum Result;
+        const Mat4 M = glm::transpose(ViewProjection);
+        const Vec4 Rows[PlaneCount] = {M[3] + M[0], M[3] - M[0], M[3] + M[1],
+                                       M[3] - M[1], M[3] - M[2], M[2]};
+        for (int i = 0; i < PlaneCount; ++i) {
+            const Vec3 N = Vec3(Rows[i]);
+            if (dot(N, N) < 1e-20f) {
+                Result.Planes[i] = {Vec3(0.0f), std::numeric_limits<float>::max()};
+                continue;
+            }
+            const float InvLength = 1.0f / length(N);
+            Result.Planes[i].Normal = N * InvLength;
+            Result.Planes[i].Distance = Rows[i].w * InvLength;
+        }
+        return Result;
+    }
+
+    [[nodiscard]] Containment Classify(const AABB& Box) const {
+        const Vec3 Center = Box.GetCenter();
+        const Vec3 Extent = Box.GetExtent();
+        Containment Result = Containment::Inside;
+        for (const Plane& P : Planes) {
+            const float Radius = dot(Extent, glm::abs(P.Normal));
+            const float D = P.SignedDistance(Center);
+            if (D < -Radius) { return Containment::Outside; }
+            if (D < Radius) { Result = Containment::Intersects; }
+        }
+        return Result;
+    }
+
+    [[nodiscard]] bool Intersects(const AABB& Box) const { return Classify(Box) != Containment::Outside; }
+
+    [[nodiscard]] bool HasFarPlane() const { return Planes[Far].Normal != Vec3(0.0f); }
+
+    // Box around the eight corners, each found as the meeting point of three planes. Only
+    // meaningful with a far plane.
+    [[nodiscard]] AABB GetBounds() const {
+        AABB Result;
+        for (int Corner = 0; Corner < 8; ++Corner) {
+            const Plane& A = Planes[(Corner & 1) ? Right : Left];
+            const Plane& B = Planes[(Corner & 2) ? Top : Bottom];
+            const Plane& C = Planes[(Corner & 4) ? Far : Near];
+            const Vec3 BC = cross(B.Normal, C.Normal);
+            const Vec3 CA = cross(C.Normal, A.Normal);
+            const Vec3 AB = cross(A.Normal, B.Normal);
+            Result.Expand((BC * -A.Distance + CA * -B.Distance + AB * -C.Distance) / dot(A.Normal, BC));
+        }
+        return Result;
+    }
+
+    [[nodiscard]] bool IntersectsSphere(const Vec3& Center, float Radius) const {
+        for (const Plane& P : Planes) {
+            if (P.SignedDistance(Center) < -Radius) { return false; }
+        }
+        return true;
+    }
+};
+
+} // namespace Volante
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <bit>
+#include <cmath>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VOLANTE_SIMD_SSE 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define VOLANTE_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace Volante {
+
+// Four-lane float vector over SSE2 or NEON, with a scalar fallback so kernels written against it
+// stay portable. Comparisons return lane masks (all bits set or clear) usable with Select.
+struct Float4 {
+#if defined(VOLANTE_SIMD_SSE)
+    __m128 V;
+
+    static Float4 Zero() { return {_mm_setzero_ps()}; }
+    static Float4 Splat(float S) { return {_mm_set1_ps(S)}; }
+    static Float4 Set(float A, float B, float C, float D) { return {_mm_setr_ps(A, B, C, D)}; }
+    static Float4 Load(const float* P) { return {_mm_loadu_ps(P)}; }
+    void Store(float* P) const { _mm_storeu_ps(P, V); }
+
+    friend Float4 operator+(Float4 A, Float4 B) { return {_mm_add_ps(A.V, B.V)}; }
+    friend Float4 operator-(Float4 A, Float4 B) { return {_mm_sub_ps(A.V, B.V)}; }
+    friend Float4 operator*(Float4 A, Float4 B) { return {_mm_mul_ps(A.V, B.V)}; }
+    friend Float4 operator/(Float4 A, Float4 B) { return {_mm_div_ps(A.V, B.V)}; }
+    friend Float4 operator<(Float4 A, Float4 B) { return {_mm_cmplt_ps(A.V, B.V)}; }
+    friend Float4 operator<=(Float4 A, Float4 B) { return {_mm_cmple_ps(A.V, B.V)}; }
+    friend Float4 operator>(Float4 A, Float4 B) { return {_mm_cmpgt_ps(A.V, B.V)}; }
+    friend Float4 operator>=(Float4 A, Float4 B) { return {_mm_cmpge_ps(A.V, B.V)}; }
+    friend Float4 operator&(Float4 A, Float4 B) { return {_mm_and_ps(A.V, B.V)}; }
+    friend Float4 operator|(Float4 A, Float4 B) { return {_mm_or_ps(A.V, B.V)}; }
+    friend Float4 Min(Float4 A, Float4 B) { return {_mm_min_ps(A.V, B.V)}; }
+    friend Float4 Max(Float4 A, Float4 B) { return {_mm_max_ps(A.V, B.V)}; }
+    friend Float4 Sqrt(Float4 A) { return {_mm_sqrt_ps(A.V)}; }
+    friend Float4 Abs(Float4 A) { return {_mm_andnot_ps(_mm_set1_ps(-0.0f), A.V)}; }
+    friend Float4 Select(Float4 Mask, Float4 A, Float4 B) {
+        return {_mm_or_ps(_mm_and_ps(Mask.V, A.V), _mm_andnot_ps(Mask.V, B.V))};
+    }
+    friend int MoveMask(Float4 Mask) { return _mm_movemask_ps(Mask.V); }
+#elif defined(VOLANTE_SIMD_NEON)
+    float32x4_t V;
+
+    static Float4 Zero() { return {vdupq_n_f32(0.0f)}; }
+    static Float4 Splat(float S) { return {vdupq_n_f32(S)}; }
+    static Float4 Set(float A, float B, float C, float D) {
+        const float Values[4] = {A, B, C, D};
+        return {vld1q_f32(Values)};
+    }
+    static Float4 Load(const float* P) { return {vld1q_f32(P)}; }
+    void Store(float* P) const { vst1q_f32(P, V); }
+
+    friend Float4 operator+(Float4 A, Float4 B) { return {vaddq_f32(A.V, B.V)}; }
+    friend Float4 operator-(Float4 A, Float4 B) { return {vsubq_f32(A.V, B.V)}; }
+    friend Float4 operator*(Float4 A, Float4 B) { return {vmulq_f32(A.V, B.V)}; }
+    friend Float4 operator/(Float4 A, Float4 B) { return {vdivq_f32(A.V, B.V)}; }
+    friend Float4 operator<(Float4 A, Float4 B) { return {vreinterpretq_f32_u32(vcltq_f32(A.V, B.V))}; }
+    friend Float4 operator<=(Float4 A, Float4 B) { return {vreinterpretq_f32_u32(vcleq_f32(A.V, B.V))}; }
+    friend Float4 operator>(Float4 A, Float4 B) { return {vreinterpretq_f32_u32(vcgtq_f32(A.V, B.V))}; }
+    friend Float4 operator>=(Float4 A, Float4 B) { return {vreinterpretq_f32_u32(vcgeq_f32(A.V, B.V))}; }
+    friend Float4 operator&(Float4 A, Float4 B) {
+        return {vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(A.V), vreinterpretq_u32_f32(B.V)))};
+    }
+    friend Float4 operator|(Float4 A, Float4 B) {
+        return {vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(A.V), vreinterpretq_u32_f32(B.V)))};
+    }
+    friend Float4 Min(Float4 A, Float4 B) { return {vminq_f32(A.V, B.V)}; }
+    friend Float4 Max(Float4 A, Float4 B) { return {vmaxq_f32(A.V, B.V)}; }
+    friend Float4 Sqrt(Float4 A) { return {vsqrtq_f32(A.V)}; }
+    friend Float4 Abs(Float4 A) { return {vabsq_f32(A.V)}; }
+    friend Float4 Select(Float4 Mask, Float4 A, Float4 B) {
+        return {vbslq_f32(vreinterpretq_u32_f32(Mask.V), A.V, B.V)};
+    }
+    friend int MoveMask(Float4 Mask) {
+        const uint32x4_t Bits = vshrq_n_u32(vreinterpretq_u32_f32(Mask.V), 31);
+        return static_cast<int>(vgetq_lane_u32(Bits, 0) | (vgetq_lane_u32(Bits, 1) << 1) |
+                                (vgetq_lane_u32(Bits, 2) << 2) | (vgetq_lane_u32(Bits, 3) << 3));
+    }
+#else
+    float V[4];
+
+    static Float4 Zero() { return {{0.0f, 0.0f, 0.0f, 0.0f}}; }
+    static Float4 Splat(float S) { return {{S, S, S, S}}; }
+    static Float4 Set(float A, float B, float C, float D) { return {{A, B, C, D}}; }
+    static Float4 Load(const float* P) { return {{P[0], P[1], P[2], P[3]}}; }
+    void Store(float* P) const {
+        for (int i = 0; i < 4; ++i) { P[i] = V[i]; }
+    }
+
+    template <typename Fn>
+    static Float4 Map(Float4 A, Float4 B, Fn Op) {
+        Float4 R;
+        for (int i = 0; i < 4; ++i) { R.V[i] = Op(A.V[i], B.V[i]); }
+        return R;
+    }
+
+    static float MaskOf(bool Value) { return std::bit_cast<float>(Value ? ~0u : 0u); }
+
+    friend Float4 operator+(Float4 A, Float4 B) { return Map(A, B, [](float X, float Y) { return X + Y; }); }
+    friend Float4 operator-(Float4 A, Float4 B) { return Map(A, B, [](float X, float Y) { return X - Y; }); }
+    friend Float4 operator*(Float4 A, Float4 B) { return Map(A, B, [](float X, float Y) { return X * Y; }); }
+    friend Float4 operator/(Float4 A, Float4 B) { return Map(A, B, [](float X, float Y) { return X / Y; }); }
+    friend Float4 operator<(Float4 A, Float4 B) { return Map(A, B, [](float X, float Y) { return MaskOf(X < Y); }); }
+    friend Float4 operator<=(Float4 A, Float4 B) { return Map(A, B, [](float X, float Y) { return MaskOf(X <= Y); }); }
+    friend Float4 operator>(Float4 A, Float4 B) { return Map(A, B, [](float X, float Y) { return MaskOf(X > Y); }); }
+    friend Float4 operator>=(Float4 A, Float4 B) { return Map(A, B, [](float X, float Y) { return MaskOf(X >= Y); }); }
+    friend Float4 operator&(Float4 A, Float4 B) {
+        return Map(A, B, [](float X, float Y) { return std::bit_cast<float>(std::bit_cast<uint32_t>(X) & std::bit_cast<uint32_t>(Y)); });
+    }
+    friend Float4 operator|(Float4 A, Float4 B) {
+        return Map(A, B, [](float X, float Y) { return std::bit_cast<float>(std::bit_cast<uint32_t>(X) | std::bit_cast<uint32_t>(Y)); });
+    }
+    friend Float4 Min(Float4 A, Float4 B) { return Map(A, B, [](float X, float Y) { return X < Y ? X : Y; }); }
+    friend Float4 Max(Float4 A, Float4 B) { return Map(A, B, [](float X, float Y) { return X > Y ? X : Y; }); }
+    friend Float4 Sqrt(Float4 A) { return Map(A, A, [](float X, float) { return std::sqrt(X); }); }
+    friend Float4 Abs(Float4 A) { return Map(A, A, [](float X, float) { return std::fabs(X); }); }
+    friend Float4 Select(Float4 Mask, Float4 A, Float4 B) {
+        Float4 R;
+        for (int i = 0; i < 4; ++i) { R.V[i] = std::bit_cast<uint32_t>(Mask.V[i]) ? A.V[i] : B.V[i]; }
+        return R;
+    }
+    friend int MoveMask(Float4 Mask) {
+        int Bits = 0;
+        for (int i = 0; i < 4; ++i) { Bits |= (std::bit_cast<uint32_t>(Mask.V[i]) >> 31) << i; }
+        return Bits;
+    }
+#endif
+
+    friend Float4 operator-(Float4 A) { return Zero() - A; }
+    friend Float4 Clamp(Float4 X, Float4 Lo, Float4 Hi) { return Min(Max(X, Lo), Hi); }
+    friend Float4 MultiplyAdd(Float4 A, Float4 B, Float4 C) { return A * B + C; }
+};
+
+// Three Float4s holding the x, y and z of four vectors (structure of arrays).
+struct Vec3x4 {
+    Float4 X, Y, Z;
+
+    friend Vec3x4 operator+(const Vec3x4& A, const Vec3x4& B) { return {A.X + B.X, A.Y + B.Y, A.Z + B.Z}; }
+    friend Vec3x4 operator-(const Vec3x4& A, const Vec3x4& B) { return {A.X - B.X, A.Y - B.Y, A.Z - B.Z}; }
+    friend Vec3x4 operator*(const Vec3x4& A, Float4 S) { return {A.X * S, A.Y * S, A.Z * S}; }
+    friend Float4 Dot(const Vec3x4& A, const Vec3x4& B) { return A.X * B.X + A.Y * B.Y + A.Z * B.Z; }
+};
+
+} // namespace Volante
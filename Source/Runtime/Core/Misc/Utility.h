@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace Volante {
+
+// Value rounded up to a multiple of Alignment, which need not be a power of two.
+template <typename T>
+constexpr T AlignUp(T Value, std::type_identity_t<T> Alignment) {
+    static_assert(std::is_unsigned_v<T>, "AlignUp takes unsigned values");
+    return (Value + Alignment - 1) / Alignment * Alignment;
+}
+
+// Nanoseconds a client wait on a GL fence may block: one second. A fence that takes longer than
+// that means the GPU is gone.
+constexpr uint64_t FenceTimeout = 1000000000ull;
+
+// 64-bit multiply-xorshift over 8-byte words; a content fingerprint, not a cryptographic hash.
+// Equal fingerprints are not proof of equal contents.
+class ContentHasher {
+public:
+    void Add(const void* Data, size_t Size) {
+        const auto* Bytes = static_cast<const unsigned char*>(Data);
+        size_t i = 0;
+        for (; i + sizeof(uint64_t) <= Size; i += sizeof(uint64_t)) {
+            uint64_t Word;
+            std::memcpy(&Word, Bytes + i, sizeof(Word));
+            Mix(Word);
+        }
+        uint64_t Tail = 0;
+        if (i < Size) { std::memcpy(&Tail, Bytes + i, Size - i); }
+        // Length goes in too, so "ab" + "c" and "a" + "bc" differ
+        Mix(Tail ^ (static_cast<uint64_t>(Size) << 56));
+    }
+
+    // Fields one at a time rather than a whole struct, so padding never leaks in
+    template <typename T>
+    void AddValue(const T& Value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        Add(&Value, sizeof(T));
+    }
+
+    [[nodiscard]] uint64_t Get() const { return Hash; }
+
+private:
+    void Mix(uint64_t Word) {
+        Hash = (Hash ^ Word) * 0x9E3779B97F4A7C15ull;
+        Hash ^= Hash >> 29;
+    }
+
+    uint64_t Hash = 14695981039346656037ull;
+};
+
+} // namespace Volante
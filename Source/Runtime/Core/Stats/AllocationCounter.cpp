@@ -0,0 +1,119 @@
+#include <cstdlib>
+#include <new>
+
+#include "StatCounters.h"
+#include "Runtime/Core/Misc/Utility.h"
+
+// Replaces the global allocation functions to count heap allocations into
+// StatCounter::Allocations, per thread (StatCounters::CountAllocation). Only the counting is added; memory still comes from malloc (or
+// the aligned allocator), which is what the default operator new uses.
+
+namespace {
+
+void* Allocate(std::size_t Size) {
+    Volante::StatCounters::CountAllocation();
+    return std::malloc(Size == 0 ? 1 : Size);
+}
+
+void* AllocateAligned(std::size_t Size, std::align_val_t Alignment) {
+    Volante::StatCounters::CountAllocation();
+    const auto Align = static_cast<std::size_t>(Alignment);
+#if defined(_MSC_VER)
+    return _aligned_malloc(Size == 0 ? 1 : Size, Align);
+#else
+    // aligned_alloc wants a size that is a nonzero multiple of the alignment
+    return std::aligned_alloc(Align, Size == 0 ? Align : Volante::AlignUp(Size, Align));
+#endif
+}
+
+void FreeAligned(void* Pointer) {
+#if defined(_MSC_VER)
+    _aligned_free(Pointer);
+#else
+    std::free(Pointer);
+#endif
+}
+
+} // namespace
+
+void* operator new(std::size_t Size) {
+    if (void* Pointer = Allocate(Size)) { return Pointer; }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t Size) {
+    return operator new(Size);
+}
+
+void* operator new(std::size_t Size, const std::nothrow_t&) noexcept {
+    return Allocate(Size);
+}
+
+void* operator new[](std::size_t Size, const std::nothrow_t&) noexcept {
+    return Allocate(Size);
+}
+
+void* operator new(std::size_t Size, std::align_val_t Alignment) {
+    if (void* Pointer = AllocateAligned(Size, Alignment)) { return Pointer; }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t Size, std::align_val_t Alignment) {
+    return operator new(Size, Alignment);
+}
+
+void* operator new(std::size_t Size, std::align_val_t Alignment, const std::nothrow_t&) noexcept {
+    return AllocateAligned(Size, Alignment);
+}
+
+void* operator new[](std::size_t Size, std::align_val_t Alignment, const std::nothrow_t&) noexcept {
+    return AllocateAligned(Size, Alignment);
+}
+
+void operator delete(void* Pointer) noexcept {
+    std::free(Pointer);
+}
+
+void operator delete[](void* Pointer) noexcept {
+    std::free(Pointer);
+}
+
+void operator delete(void* Pointer, std::size_t) noexcept {
+    std::free(Pointer);
+}
+
+void operator delete[](void* Pointer, std::size_t) noexcept {
+    std::free(Pointer);
+}
+
+void operator delete(void* Pointer, const std::nothrow_t&) noexcept {
+    std::free(Pointer);
+}
+
+void operator delete[](void* Pointer, const std::nothrow_t&) noexcept {
+    std::free(Pointer);
+}
+
+void operator delete(void* Pointer, std::align_val_t) noexcept {
+    FreeAligned(Pointer);
+}
+
+void operator delete[](void* Pointer, std::align_val_t) noexcept {
+    FreeAligned(Pointer);
+}
+
+void operator delete(void* Pointer, std::size_t, std::align_val_t) noexcept {
+    FreeAligned(Pointer);
+}
+
+void operator delete[](void* Pointer, std::size_t, std::align_val_t) noexcept {
+    FreeAligned(Pointer);
+}
+
+void operator delete(void* Pointer, std::align_val_t, const std::nothrow_t&) noexcept {
+    FreeAligned(Pointer);
+}
+
+void operator delete[](void* Pointer, std::align_val_t, const std::nothrow_t&) noexcept {
+    FreeAligned(Pointer);
+}
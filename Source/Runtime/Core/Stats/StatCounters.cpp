@@ -0,0 +1,119 @@
+#include "StatCounters.h"
+
+#include <iterator>
+#include <mutex>
+
+namespace Volante {
+
+namespace {
+
+constexpr float NanosecondsToMs = 1.0e-6f;
+
+// In enum order; also the export column names
+constexpr const char* CounterNames[] = {
+    "DrawCalls", "Triangles", "StateChanges", "UploadBytes", "ReadbackBytes", "Allocations", "RenderInstances", "PhysicsBodies",
+};
+constexpr const char* TimerNames[] = {"Update", "Physics", "Render", "Shadows", "Scene", "DebugDraw", "Animation", "Particles", "Terrain", "Frame"};
+
+static_assert(std::size(CounterNames) == StatCounterCount);
+static_assert(std::size(TimerNames) == StatTimerCount);
+
+// Per-thread allocation totals, linked into a list Capture walks. The list is intrusive and
+// the lock a plain mutex, because registering runs inside operator new and must not allocate.
+struct ThreadAllocations {
+    ThreadAllocations();
+    ~ThreadAllocations();
+
+    // Only the owning thread writes; Capture reads it from another
+    std::atomic<int64_t> Count{0};
+    ThreadAllocations* Next = nullptr;
+    ThreadAllocations* Previous = nullptr;
+};
+
+std::mutex AllocationMutex;
+ThreadAllocations* AllocationThreads = nullptr;
+// Totals of threads that have exited
+int64_t RetiredAllocations = 0;
+// What the previous Capture summed, so each frame reports the difference
+int64_t CapturedAllocations = 0;
+// Set once the thread's counter is destroyed; allocations made after that, while the thread
+// exits, go straight to RetiredAllocations
+thread_local bool AllocationsRetired = false;
+
+ThreadAllocations::ThreadAllocations() {
+    std::lock_guard Lock(AllocationMutex);
+    Next = AllocationThreads;
+    if (Next) { Next->Previous = this; }
+    AllocationThreads = this;
+}
+
+ThreadAllocations::~ThreadAllocations() {
+    std::lock_guard Lock(AllocationMutex);
+    RetiredAllocations += Count.load(std::memory_order_relaxed);
+    (Previous ? Previous->Next : AllocationThreads) = Next;
+    if (Next) { Next->Previous = Previous; }
+    AllocationsRetired = true;
+}
+
+thread_local ThreadAllocations LocalAllocations;
+
+// Sum over every thread that ever counted; only grows
+int64_t SumAllocations() {
+    std::lock_guard Lock(AllocationMutex);
+    int64_t Total = RetiredAllocations;
+    for (const ThreadAllocations* Thread = AllocationThreads; Thread; Thread = Thread->Next) {
+        Total += Thread->Count.load(std::memory_order_relaxed);
+    }
+    return Total;
+}
+
+} // namespace
+
+StatCounters::Slot StatCounters::Counters[StatCounterCount];
+StatCounters::Slot StatCounters::CpuTimes[StatTimerCount];
+StatCounters::Slot StatCounters::GpuTimes[StatTimerCount];
+uint64_t StatCounters::FrameIndex = 0;
+
+void StatCounters::CountAllocation() {
+    if (AllocationsRetired) {
+        std::lock_guard Lock(AllocationMutex);
+        ++RetiredAllocations;
+        return;
+    }
+    // A load and a store rather than fetch_add: no other thread writes this counter
+    std::atomic<int64_t>& Count = LocalAllocations.Count;
+    Count.store(Count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+StatFrame StatCounters::Capture(float FrameMs) {
+    StatFrame Frame;
+    Frame.FrameIndex = FrameIndex++;
+    Frame.FrameMs = FrameMs;
+    for (uint32_t i = 0; i < StatTimerCount; ++i) {
+        Frame.CpuMs[i] = static_cast<float>(CpuTimes[i].Value.exchange(0, std::memory_order_relaxed)) * NanosecondsToMs;
+        Frame.GpuMs[i] = static_cast<float>(GpuTimes[i].Value.load(std::memory_order_relaxed)) * NanosecondsToMs;
+    }
+    for (uint32_t i = 0; i < StatCounterCount; ++i) {
+        std::atomic<int64_t>& Value = Counters[i].Value;
+        Frame.Counters[i] = IsGauge(static_cast<StatCounter>(i)) ? Value.load(std::memory_order_relaxed)
+                                                                 : Value.exchange(0, std::memory_order_relaxed);
+    }
+    const int64_t Allocations = SumAllocations();
+    Frame.Counters[static_cast<uint32_t>(StatCounter::Allocations)] += Allocations - CapturedAllocations;
+    CapturedAllocations = Allocations;
+    return Frame;
+}
+
+bool StatCounters::IsGauge(StatCounter Counter) {
+    return Counter == StatCounter::Triangles || Counter == StatCounter::RenderInstances || Counter == StatCounter::PhysicsBodies;
+}
+
+const char* StatCounters::GetName(StatCounter Counter) {
+    return CounterNames[static_cast<uint32_t>(Counter)];
+}
+
+const char* StatCounters::GetName(StatTimer Timer) {
+    return TimerNames[static_cast<uint32_t>(Timer)];
+}
+
+} // namespace Volante
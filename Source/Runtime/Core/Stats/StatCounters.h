@@ -0,0 +1,120 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace Volante {
+
+enum class StatCounter : uint32_t {
+    DrawCalls,
+    // Primitives the main scene pass generated, from a query a few frames old
+    Triangles,
+    // Program, vertex array and texture binds issued by the renderer
+    StateChanges,
+    UploadBytes,
+    // Pixels read back from the GPU (GPUReadback)
+    ReadbackBytes,
+    // Heap allocations (operator new), counted per thread; see CountAllocation
+    Allocations,
+    RenderInstances,
+    PhysicsBodies,
+    Count
+};
+
+enum class StatTimer : uint32_t {
+    Update,
+    Physics,
+    Render,
+    Shadows,
+    Scene,
+    DebugDraw,
+    Animation,
+    Particles,
+    Terrain,
+    // The whole frame graph: scene and post-processing
+    Frame,
+    Count
+};
+
+constexpr uint32_t StatCounterCount = static_cast<uint32_t>(StatCounter::Count);
+constexpr uint32_t StatTimerCount = static_cast<uint32_t>(StatTimer::Count);
+
+// One frame of everything StatCounters holds.
+struct StatFrame {
+    uint64_t FrameIndex = 0;
+    float FrameMs = 0.0f;
+    float CpuMs[StatTimerCount] = {};
+    // Arrive a few frames late (GL timer queries are read without waiting); 0 if never measured
+    float GpuMs[StatTimerCount] = {};
+    int64_t Counters[StatCounterCount] = {};
+};
+
+// Process-wide counters and pass timers. Every write is one relaxed atomic on its own cache
+// line, so they can be bumped from any thread and left on in shipping builds; hot loops should
+// still add once per batch rather than once per item.
+//
+// Counters and CPU times accumulate until Capture, which reads and resets them. Gauges (counts
+// of things that exist, and the delayed GPU results) keep their last value instead.
+class StatCounters {
+public:
+    static void Add(StatCounter Counter, int64_t Value = 1) {
+        Counters[static_cast<uint32_t>(Counter)].Value.fetch_add(Value, std::memory_order_relaxed);
+    }
+
+    static void Set(StatCounter Counter, int64_t Value) {
+        Counters[static_cast<uint32_t>(Counter)].Value.store(Value, std::memory_order_relaxed);
+    }
+
+    static void AddCpuTime(StatTimer Timer, int64_t Nanoseconds) {
+        CpuTimes[static_cast<uint32_t>(Timer)].Value.fetch_add(Nanoseconds, std::memory_order_relaxed);
+    }
+
+    static void SetGpuTime(StatTimer Timer, int64_t Nanoseconds) {
+        GpuTimes[static_cast<uint32_t>(Timer)].Value.store(Nanoseconds, std::memory_order_relaxed);
+    }
+
+    // One heap allocation on the calling thread, for the replaced operator new. Every thread
+    // bumps a counter of its own, without a locked instruction or a shared cache line; Capture
+    // adds them up into StatCounter::Allocations.
+    static void CountAllocation();
+
+    // Snapshot for the frame that just ended. Call once per frame, from one thread.
+    static StatFrame Capture(float FrameMs);
+
+    [[nodiscard]] static bool IsGauge(StatCounter Counter);
+
+    [[nodiscard]] static const char* GetName(StatCounter Counter);
+
+    [[nodiscard]] static const char* GetName(StatTimer Timer);
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<int64_t> Value{0};
+    };
+
+    static Slot Counters[StatCounterCount];
+    static Slot CpuTimes[StatTimerCount];
+    static Slot GpuTimes[StatTimerCount];
+    static uint64_t FrameIndex;
+};
+
+// Adds the time until the end of the scope to a CPU pass timer.
+class StatScope {
+public:
+    explicit StatScope(StatTimer Timer) : Timer(Timer), Start(std::chrono::steady_clock::now()) {}
+
+    ~StatScope() {
+        const auto Elapsed = std::chrono::steady_clock::now() - Start;
+        StatCounters::AddCpuTime(Timer, std::chrono::duration_cast<std::chrono::nanoseconds>(Elapsed).count());
+    }
+
+    StatScope(const StatScope&) = delete;
+    StatScope& operator=(const StatScope&) = delete;
+
+private:
+    StatTimer Timer;
+    std::chrono::steady_clock::time_point Start;
+};
+
+} // namespace Volante
@@ -0,0 +1,87 @@
+#include "StatsExporter.h"
+
+#include <cctype>
+#include <iomanip>
+#include <iostream>
+
+namespace Volante {
+
+StatsExporter::~StatsExporter() {
+    Close();
+}
+
+bool StatsExporter::Open(const std::string& Path, StatsExportFormat InFormat) {
+    Close();
+    File.open(Path, std::ios::out | std::ios::trunc);
+    if (!File.is_open()) {
+        std::cerr << "ERROR::STATS_EXPORTER::OPEN_FAILED: " << Path << std::endl;
+        return false;
+    }
+    Format = InFormat;
+    File << std::fixed << std::setprecision(3);
+    if (Format == StatsExportFormat::Csv) {
+        File << "Frame,FrameMs";
+        for (uint32_t i = 0; i < StatTimerCount; ++i) {
+            File << ",Cpu." << StatCounters::GetName(static_cast<StatTimer>(i));
+        }
+        for (uint32_t i = 0; i < StatTimerCount; ++i) {
+            File << ",Gpu." << StatCounters::GetName(static_cast<StatTimer>(i));
+        }
+        for (uint32_t i = 0; i < StatCounterCount; ++i) {
+            File << ',' << StatCounters::GetName(static_cast<StatCounter>(i));
+        }
+        File << '\n';
+    }
+    return true;
+}
+
+void StatsExporter::Close() {
+    if (File.is_open()) { File.close(); }
+}
+
+void StatsExporter::Write(const StatFrame& Frame) {
+    if (!File.is_open()) { return; }
+    // Rows go through the stream's buffer; the file is flushed when it fills or on Close
+    if (Format == StatsExportFormat::Csv) {
+        File << Frame.FrameIndex << ',' << Frame.FrameMs;
+        for (const float Ms : Frame.CpuMs) {
+            File << ',' << Ms;
+        }
+        for (const float Ms : Frame.GpuMs) {
+            File << ',' << Ms;
+        }
+        for (const int64_t Value : Frame.Counters) {
+            File << ',' << Value;
+        }
+        File << '\n';
+        return;
+    }
+
+    File << "{\"Frame\":" << Frame.FrameIndex << ",\"FrameMs\":" << Frame.FrameMs;
+    const auto WriteTimers = [this](const char* Name, const float* Values) {
+        File << ",\"" << Name << "\":{";
+        for (uint32_t i = 0; i < StatTimerCount; ++i) {
+            File << (i > 0 ? "," : "") << '"' << StatCounters::GetName(static_cast<StatTimer>(i)) << "\":" << Values[i];
+        }
+        File << '}';
+    };
+    WriteTimers("Cpu", Frame.CpuMs);
+    WriteTimers("Gpu", Frame.GpuMs);
+    File << ",\"Counters\":{";
+    for (uint32_t i = 0; i < StatCounterCount; ++i) {
+        File << (i > 0 ? "," : "") << '"' << StatCounters::GetName(static_cast<StatCounter>(i)) << "\":" << Frame.Counters[i];
+    }
+    File << "}}\n";
+}
+
+StatsExportFormat StatsExporter::GetFormatForPath(const std::string& Path) {
+    const size_t Dot = Path.find_last_of('.');
+    if (Dot == std::string::npos) { return StatsExportFormat::JsonLines; }
+    std::string Extension = Path.substr(Dot + 1);
+    for (char& Character : Extension) {
+        Character = static_cast<char>(std::tolower(static_cast<unsigned char>(Character)));
+    }
+    return Extension == "csv" ? StatsExportFormat::Csv : StatsExportFormat::JsonLines;
+}
+
+} // namespace Volante
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+
+#include "StatCounters.h"
+
+namespace Volante {
+
+enum class StatsExportFormat {
+    // Header row, then one row per frame: Frame, FrameMs, Cpu.<Timer>, Gpu.<Timer>, <Counter>...
+    Csv,
+    // One object per line: {"Frame":..,"FrameMs":..,"Cpu":{..},"Gpu":{..},"Counters":{..}}
+    JsonLines,
+};
+
+// Appends captured frames to a file for offline regression analysis.
+class StatsExporter {
+public:
+    StatsExporter() = default;
+    ~StatsExporter();
+
+    StatsExporter(const StatsExporter&) = delete;
+    StatsExporter& operator=(const StatsExporter&) = delete;
+
+    // Truncates Path.
+    bool Open(const std::string& Path, StatsExportFormat Format);
+    void Close();
+
+    void Write(const StatFrame& Frame);
+
+    [[nodiscard]] bool IsOpen() const { return File.is_open(); }
+
+    // .csv selects Csv, anything else JsonLines
+    [[nodiscard]] static StatsExportFormat GetFormatForPath(const std::string& Path);
+
+private:
+    std::ofstream File;
+    StatsExportFormat Format = StatsExportFormat::JsonLines;
+};
+
+} // namespace Volante
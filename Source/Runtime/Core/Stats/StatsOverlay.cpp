@@ -0,0 +1,101 @@
+#include "StatsOverlay.h"
+
+#include <imgui.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <cstdio>
+#include <functional>
+
+namespace Volante {
+
+namespace {
+
+struct PlotSource {
+    const std::vector<StatFrame>* History;
+    uint32_t Head;
+    std::function<float(const StatFrame&)> Value;
+};
+
+float GetPlotValue(void* Data, int Index) {
+    const auto* Source = static_cast<const PlotSource*>(Data);
+    const size_t Count = Source->History->size();
+    return Source->Value((*Source->History)[(Source->Head + static_cast<size_t>(Index)) % Count]);
+}
+
+void PlotHistory(const char* Label, const PlotSource& Source, float Current, const char* Unit) {
+    char Overlay[64];
+    std::snprintf(Overlay, sizeof(Overlay), "%.2f %s", Current, Unit);
+    ImGui::PlotHistogram(Label, &GetPlotValue, const_cast<PlotSource*>(&Source), static_cast<int>(Source.History->size()), 0,
+                         Overlay, 0.0f, FLT_MAX, ImVec2(0.0f, 40.0f));
+}
+
+} // namespace
+
+StatsOverlay::StatsOverlay(const StatsOverlayDesc& Desc) : Desc(Desc), Visible(Desc.Visible) {}
+
+StatsOverlay::~StatsOverlay() {
+    Shutdown();
+}
+
+void StatsOverlay::Initialize() {
+    History.clear();
+    History.reserve(std::max(Desc.HistoryLength, 1u));
+    HistoryHead = 0;
+    if (!Desc.ExportPath.empty()) { Exporter.Open(Desc.ExportPath, StatsExporter::GetFormatForPath(Desc.ExportPath)); }
+}
+
+void StatsOverlay::Shutdown() {
+    Exporter.Close();
+}
+
+void StatsOverlay::Update(float DeltaTime) {
+    LastFrame = StatCounters::Capture(DeltaTime * 1000.0f);
+    if (History.size() < History.capacity()) {
+        History.push_back(LastFrame);
+    } else if (!History.empty()) {
+        History[HistoryHead] = LastFrame;
+        HistoryHead = (HistoryHead + 1) % static_cast<uint32_t>(History.size());
+    }
+    Exporter.Write(LastFrame);
+}
+
+void StatsOverlay::Draw() {
+    if (!Visible || History.empty()) { return; }
+
+    ImGui::SetNextWindowPos(ImVec2(10.0f, 10.0f), ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowSize(ImVec2(360.0f, 0.0f), ImGuiCond_FirstUseEver);
+    if (!ImGui::Begin("Stats", &Visible)) {
+        ImGui::End();
+        return;
+    }
+
+    const float Fps = LastFrame.FrameMs > 0.0f ? 1000.0f / LastFrame.FrameMs : 0.0f;
+    ImGui::Text("Frame %llu  %.1f fps", static_cast<unsigned long long>(LastFrame.FrameIndex), Fps);
+    if (!Info.empty()) { ImGui::TextUnformatted(Info.c_str()); }
+    PlotHistory("Frame", {&History, HistoryHead, [](const StatFrame& Frame) { return Frame.FrameMs; }}, LastFrame.FrameMs, "ms");
+
+    if (ImGui::CollapsingHeader("CPU", ImGuiTreeNodeFlags_DefaultOpen)) {
+        for (uint32_t i = 0; i < StatTimerCount; ++i) {
+            PlotHistory(StatCounters::GetName(static_cast<StatTimer>(i)),
+                        {&History, HistoryHead, [i](const StatFrame& Frame) { return Frame.CpuMs[i]; }}, LastFrame.CpuMs[i], "ms");
+        }
+    }
+    if (ImGui::CollapsingHeader("GPU", ImGuiTreeNodeFlags_DefaultOpen)) {
+        ImGui::PushID("GPU");
+        for (uint32_t i = 0; i < StatTimerCount; ++i) {
+            PlotHistory(StatCounters::GetName(static_cast<StatTimer>(i)),
+                        {&History, HistoryHead, [i](const StatFrame& Frame) { return Frame.GpuMs[i]; }}, LastFrame.GpuMs[i], "ms");
+        }
+        ImGui::PopID();
+    }
+    if (ImGui::CollapsingHeader("Counters", ImGuiTreeNodeFlags_DefaultOpen)) {
+        for (uint32_t i = 0; i < StatCounterCount; ++i) {
+            ImGui::Text("%-16s %lld", StatCounters::GetName(static_cast<StatCounter>(i)),
+                        static_cast<long long>(LastFrame.Counters[i]));
+        }
+    }
+    ImGui::End();
+}
+
+} // namespace Volante
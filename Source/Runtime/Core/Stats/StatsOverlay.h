@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Engine.h"
+#include "StatCounters.h"
+#include "StatsExporter.h"
+
+namespace Volante {
+
+struct StatsOverlayDesc {
+    bool Visible = true;
+
+    // Frames kept for the histograms
+    uint32_t HistoryLength = 240;
+
+    // Every captured frame is appended here when set; the extension picks CSV or JSON lines
+    std::string ExportPath;
+};
+
+// Captures StatCounters once per frame, keeps a short history and draws it as an ImGui window.
+// Capturing and exporting run whether or not the window is visible.
+class StatsOverlay : public IEngineSubsystem {
+public:
+    explicit StatsOverlay(const StatsOverlayDesc& Desc = {});
+    ~StatsOverlay() override;
+
+    void Initialize() override;
+    void Shutdown() override;
+    // Should run first, so the captured frame ends where the next one begins
+    void Update(float DeltaTime) override;
+
+    // Needs a current ImGui frame.
+    void Draw();
+
+    void SetVisible(bool InVisible) { Visible = InVisible; }
+
+    [[nodiscard]] bool IsVisible() const { return Visible; }
+
+    // A line shown under the frame rate, e.g. which culling path the renderer took.
+    void SetInfo(std::string InInfo) { Info = std::move(InInfo); }
+
+    [[nodiscard]] const StatFrame& GetLastFrame() const { return LastFrame; }
+
+private:
+    StatsOverlayDesc Desc;
+    bool Visible;
+    std::string Info;
+    StatsExporter Exporter;
+
+    std::vector<StatFrame> History;
+    // Oldest frame once History is full
+    uint32_t HistoryHead = 0;
+    StatFrame LastFrame;
+};
+
+} // namespace Volante
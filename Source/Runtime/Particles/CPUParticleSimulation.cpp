@@ -0,0 +1,213 @@
+#include "CPUParticleSimulation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "Runtime/Core/Async/JobSystem.h"
+#include "Runtime/Core/Math/Simd.h"
+#include "Runtime/Core/Misc/Utility.h"
+
+namespace Volante {
+
+namespace {
+
+// Gravity and drag of the four particles' emitters. Particles are spawned in runs per
+// emitter, so all four usually share one.
+void LoadForces(const ParticleEmitterParams* Emitters, const uint32_t* Emitter, Float4& GravityX, Float4& GravityY,
+                Float4& GravityZ, Float4& Drag) {
+    if (Emitter[0] == Emitter[1] && Emitter[0] == Emitter[2] && Emitter[0] == Emitter[3]) {
+        const Vec4& Forces = Emitters[Emitter[0]].GravityDrag;
+        GravityX = Float4::Splat(Forces.x);
+        GravityY = Float4::Splat(Forces.y);
+        GravityZ = Float4::Splat(Forces.z);
+        Drag = Float4::Splat(Forces.w);
+        return;
+    }
+    const Vec4& A = Emitters[Emitter[0]].GravityDrag;
+    const Vec4& B = Emitters[Emitter[1]].GravityDrag;
+    const Vec4& C = Emitters[Emitter[2]].GravityDrag;
+    const Vec4& D = Emitters[Emitter[3]].GravityDrag;
+    GravityX = Float4::Set(A.x, B.x, C.x, D.x);
+    GravityY = Float4::Set(A.y, B.y, C.y, D.y);
+    GravityZ = Float4::Set(A.z, B.z, C.z, D.z);
+    Drag = Float4::Set(A.w, B.w, C.w, D.w);
+}
+
+// Integrates [Begin, End) and packs its survivors at Begin. Writes never pass reads, so the
+// chunk compacts in place; a run of four survivors with nothing dead before it is stored
+// whole.
+uint32_t SimulateChunk(ParticleStreams& Streams, uint32_t Begin, uint32_t End, float DeltaTime,
+                       const ParticleEmitterParams* Emitters) {
+    float* const Floats[] = {Streams.PositionX.data(), Streams.PositionY.data(), Streams.PositionZ.data(),
+                             Streams.Age.data(),       Streams.VelocityX.data(), Streams.VelocityY.data(),
+                             Streams.VelocityZ.data(), Streams.InverseLifetime.data()};
+    constexpr uint32_t FloatCount = sizeof(Floats) / sizeof(Floats[0]);
+    uint32_t* const Emitter = Streams.Emitter.data();
+
+    const Float4 Step = Float4::Splat(DeltaTime);
+    const Float4 One = Float4::Splat(1.0f);
+    alignas(16) float Lanes[FloatCount][4];
+    uint32_t Write = Begin;
+
+    for (uint32_t i = Begin; i < End; i += 4) {
+        Float4 GravityX, GravityY, GravityZ, Drag;
+        LoadForces(Emitters, Emitter + i, GravityX, GravityY, GravityZ, Drag);
+
+        Float4 Values[FloatCount];
+        for (uint32_t Stream = 0; Stream < FloatCount; ++Stream) { Values[Stream] = Float4::Load(Floats[Stream] + i); }
+        Float4& PositionX = Values[0];
+        Float4& PositionY = Values[1];
+        Float4& PositionZ = Values[2];
+        Float4& Age = Values[3];
+        Float4& VelocityX = Values[4];
+        Float4& VelocityY = Values[5];
+        Float4& VelocityZ = Values[6];
+
+        VelocityX = VelocityX + (GravityX - VelocityX * Drag) * Step;
+        VelocityY = VelocityY + (GravityY - VelocityY * Drag) * Step;
+        VelocityZ = VelocityZ + (GravityZ - VelocityZ * Drag) * Step;
+        PositionX = PositionX + VelocityX * Step;
+        PositionY = PositionY + VelocityY * Step;
+        PositionZ = PositionZ + VelocityZ * Step;
+        Age = Age + Values[7] * Step;
+
+        // Lanes past End are padding
+        const int InRange = End - i >= 4 ? 0xF : (1 << (End - i)) - 1;
+        const int Alive = MoveMask(Age < One) & InRange;
+        if (Alive == 0xF && Write == i) {
+            for (uint32_t Stream = 0; Stream < FloatCount; ++Stream) { Values[Stream].Store(Floats[Stream] + i); }
+            Write += 4;
+            continue;
+        }
+        if (Alive == 0) { continue; }
+
+        for (uint32_t Stream = 0; Stream < FloatCount; ++Stream) { Values[Stream].Store(Lanes[Stream]); }
+        for (uint32_t Lane = 0; Lane < 4; ++Lane) {
+            if ((Alive & (1 << Lane)) == 0) { continue; }
+            for (uint32_t Stream = 0; Stream < FloatCount; ++Stream) { Floats[Stream][Write] = Lanes[Stream][Lane]; }
+            Emitter[Write] = Emitter[i + Lane];
+            ++Write;
+        }
+    }
+    return Write - Begin;
+}
+
+template <typename T>
+void CopyRange(const std::vector<T>& Source, std::vector<T>& Destination, uint32_t From, uint32_t To, uint32_t Count) {
+    std::memcpy(Destination.data() + To, Source.data() + From, Count * sizeof(T));
+}
+
+// Kept in step with SpawnSource in GPUParticleSimulation.cpp.
+void SpawnParticle(ParticleStreams& Streams, uint32_t Slot, const ParticleSpawnBatch& Batch, uint32_t Index) {
+    uint32_t State = Batch.Seed ^ HashParticle(Index);
+    const float CosTheta = 1.0f - NextParticleRandom(State) * (1.0f - Batch.PositionCosSpread.w);
+    const float SinTheta = std::sqrt(std::max(0.0f, 1.0f - CosTheta * CosTheta));
+    const float Phi = TWO_PI * NextParticleRandom(State);
+    const float Speed = glm::mix(Batch.DirectionSpeedMin.w, Batch.SpeedLifetimeRadius.x, NextParticleRandom(State));
+    const float Lifetime = glm::mix(Batch.SpeedLifetimeRadius.y, Batch.SpeedLifetimeRadius.z, NextParticleRandom(State));
+    const float Offset = Batch.SpeedLifetimeRadius.w * NextParticleRandom(State);
+
+    const Vec3 Axis(Batch.DirectionSpeedMin);
+    const Vec3 Helper = std::fabs(Axis.y) < 0.999f ? Vec3(0.0f, 1.0f, 0.0f) : Vec3(1.0f, 0.0f, 0.0f);
+    const Vec3 Tangent = glm::normalize(glm::cross(Helper, Axis));
+    const Vec3 Bitangent = glm::cross(Axis, Tangent);
+    const Vec3 Direction = Tangent * (std::cos(Phi) * SinTheta) + Bitangent * (std::sin(Phi) * SinTheta) + Axis * CosTheta;
+    const Vec3 Position = Vec3(Batch.PositionCosSpread) + Direction * Offset;
+
+    Streams.PositionX[Slot] = Position.x;
+    Streams.PositionY[Slot] = Position.y;
+    Streams.PositionZ[Slot] = Position.z;
+    Streams.Age[Slot] = 0.0f;
+    Streams.VelocityX[Slot] = Direction.x * Speed;
+    Streams.VelocityY[Slot] = Direction.y * Speed;
+    Streams.VelocityZ[Slot] = Direction.z * Speed;
+    Streams.InverseLifetime[Slot] = 1.0f / std::max(Lifetime, 1e-3f);
+    Streams.Emitter[Slot] = Batch.Emitter;
+}
+
+} // namespace
+
+void ParticleStreams::Resize(uint32_t Capacity) {
+    const size_t Padded = AlignUp<size_t>(Capacity, 4);
+    for (std::vector<float>* Stream : {&PositionX, &PositionY, &PositionZ, &Age, &VelocityX, &VelocityY, &VelocityZ, &InverseLifetime}) {
+        Stream->resize(Padded);
+    }
+    Emitter.resize(Padded);
+}
+
+CPUParticleSimulation::CPUParticleSimulation(uint32_t Capacity) {
+    Resize(Capacity);
+}
+
+void CPUParticleSimulation::Resize(uint32_t InCapacity) {
+    Capacity = InCapacity;
+    Streams[0].Resize(Capacity);
+    Streams[1].Resize(Capacity);
+    Count = std::min(Count, Capacity);
+}
+
+void CPUParticleSimulation::Simulate(float DeltaTime, const ParticleEmitterParams* Emitters, JobSystem* Jobs, uint32_t Grain) {
+    if (Count == 0) { return; }
+    Grain = (std::max(Grain, 4u) + 3u) & ~3u;
+    const uint32_t ChunkCount = (Count + Grain - 1) / Grain;
+    ChunkCounts.resize(ChunkCount);
+    ChunkOffsets.resize(ChunkCount);
+
+    ParticleStreams& Source = *Front;
+    ParallelFor(Jobs, ChunkCount, 1, [&](uint32_t First, uint32_t Last) {
+        for (uint32_t Chunk = First; Chunk < Last; ++Chunk) {
+            const uint32_t Begin = Chunk * Grain;
+            ChunkCounts[Chunk] = SimulateChunk(Source, Begin, std::min(Begin + Grain, Count), DeltaTime, Emitters);
+        }
+    });
+
+    uint32_t Total = 0;
+    for (uint32_t Chunk = 0; Chunk < ChunkCount; ++Chunk) {
+        ChunkOffsets[Chunk] = Total;
+        Total += ChunkCounts[Chunk];
+    }
+
+    ParticleStreams& Destination = *Back;
+    ParallelFor(Jobs, ChunkCount, 1, [&](uint32_t First, uint32_t Last) {
+        for (uint32_t Chunk = First; Chunk < Last; ++Chunk) {
+            const uint32_t From = Chunk * Grain;
+            const uint32_t To = ChunkOffsets[Chunk];
+            const uint32_t Survivors = ChunkCounts[Chunk];
+            CopyRange(Source.PositionX, Destination.PositionX, From, To, Survivors);
+            CopyRange(Source.PositionY, Destination.PositionY, From, To, Survivors);
+            CopyRange(Source.PositionZ, Destination.PositionZ, From, To, Survivors);
+            CopyRange(Source.Age, Destination.Age, From, To, Survivors);
+            CopyRange(Source.VelocityX, Destination.VelocityX, From, To, Survivors);
+            CopyRange(Source.VelocityY, Destination.VelocityY, From, To, Survivors);
+            CopyRange(Source.VelocityZ, Destination.VelocityZ, From, To, Survivors);
+            CopyRange(Source.InverseLifetime, Destination.InverseLifetime, From, To, Survivors);
+            CopyRange(Source.Emitter, Destination.Emitter, From, To, Survivors);
+        }
+    });
+    std::swap(Front, Back);
+    Count = Total;
+}
+
+uint32_t CPUParticleSimulation::Spawn(const ParticleSpawnBatch* Batches, uint32_t BatchCount, JobSystem* Jobs, uint32_t Grain) {
+    if (BatchCount == 0) { return 0; }
+    const uint32_t Requested = Batches[BatchCount - 1].FirstParticle + Batches[BatchCount - 1].Count;
+    const uint32_t Added = std::min(Requested, Capacity - Count);
+
+    ParticleStreams& Target = *Front;
+    const uint32_t Base = Count;
+    ParallelFor(Jobs, Added, Grain, [&](uint32_t Begin, uint32_t End) {
+        // Last batch starting at or before Begin; later ones are reached by walking forward
+        const ParticleSpawnBatch* Batch = std::upper_bound(Batches, Batches + BatchCount, Begin, [](uint32_t Index, const ParticleSpawnBatch& Candidate) {
+            return Index < Candidate.FirstParticle;
+        }) - 1;
+        for (uint32_t i = Begin; i < End; ++i) {
+            while (i >= Batch->FirstParticle + Batch->Count) { ++Batch; }
+            SpawnParticle(Target, Base + i, *Batch, i - Batch->FirstParticle);
+        }
+    });
+    Count += Added;
+    return Added;
+}
+
+} // namespace Volante
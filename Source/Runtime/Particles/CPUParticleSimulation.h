@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "ParticleTypes.h"
+
+namespace Volante {
+
+class JobSystem;
+
+// Live particles as one array per attribute, padded to a multiple of four so kernels always
+// load whole Float4s. Age runs from 0 at birth to 1 at death.
+struct ParticleStreams {
+    std::vector<float> PositionX;
+    std::vector<float> PositionY;
+    std::vector<float> PositionZ;
+    std::vector<float> Age;
+    std::vector<float> VelocityX;
+    std::vector<float> VelocityY;
+    std::vector<float> VelocityZ;
+    std::vector<float> InverseLifetime;
+    std::vector<uint32_t> Emitter;
+
+    void Resize(uint32_t Capacity);
+};
+
+// The fallback simulation for contexts without compute shaders. Simulate() integrates four
+// particles at a time with Float4 on the job system; each job compacts the survivors of its
+// chunk in place, then the chunks are copied down into the other set of streams, so the live
+// particles always stay dense at the front.
+class CPUParticleSimulation {
+public:
+    explicit CPUParticleSimulation(uint32_t Capacity = 0);
+
+    void Resize(uint32_t Capacity);
+    void Clear() { Count = 0; }
+
+    // Grain is rounded up to a multiple of four.
+    void Simulate(float DeltaTime, const ParticleEmitterParams* Emitters, JobSystem* Jobs, uint32_t Grain);
+
+    // Appends the batches' particles, in parallel. Spawns past capacity are dropped; returns
+    // how many were added.
+    uint32_t Spawn(const ParticleSpawnBatch* Batches, uint32_t BatchCount, JobSystem* Jobs, uint32_t Grain);
+
+    [[nodiscard]] uint32_t GetCount() const { return Count; }
+
+    [[nodiscard]] uint32_t GetCapacity() const { return Capacity; }
+
+    [[nodiscard]] const ParticleStreams& GetStreams() const { return *Front; }
+
+private:
+    ParticleStreams Streams[2];
+    ParticleStreams* Front = &Streams[0];
+    ParticleStreams* Back = &Streams[1];
+    // Survivors per chunk, then where each chunk's survivors go
+    std::vector<uint32_t> ChunkCounts;
+    std::vector<uint32_t> ChunkOffsets;
+    uint32_t Count = 0;
+    uint32_t Capacity = 0;
+};
+
+} // namespace Volante
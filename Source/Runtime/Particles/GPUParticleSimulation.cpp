@@ -0,0 +1,330 @@
+#include "GPUParticleSimulation.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <string>
+
+#include "Runtime/Rendering/ComputeProgram.h"
+#include "Runtime/Rendering/GLCapabilities.h"
+
+namespace Volante {
+
+namespace {
+
+constexpr uint32_t GroupSize = 256;
+constexpr uint32_t SortBlockSize = 1024;
+constexpr int EmitterUnit = 0;
+
+enum Binding : GLuint {
+    SourcePositionBinding = 0,
+    SourceVelocityBinding = 1,
+    SourceEmitterBinding = 2,
+    PositionBinding = 3,
+    VelocityBinding = 4,
+    EmitterBinding = 5,
+    SourceCounterBinding = 6,
+    CounterBinding = 7,
+    // Reuse slots the kernels using them leave free
+    BatchBinding = 6,
+    SortKeyBinding = 1,
+};
+
+// Layout of each set's counter buffer. The first four words are a DrawArraysIndirectCommand,
+// the next three the indirect dispatch over the live particles.
+struct GPUParticleCounters {
+    uint32_t VertexCount;
+    uint32_t Count;
+    uint32_t FirstVertex;
+    uint32_t BaseInstance;
+    uint32_t DispatchX;
+    uint32_t DispatchY;
+    uint32_t DispatchZ;
+    uint32_t Pad;
+};
+
+constexpr GLintptr CountOffset = offsetof(GPUParticleCounters, Count);
+constexpr GLintptr DispatchOffset = offsetof(GPUParticleCounters, DispatchX);
+
+void CreateStorage(unsigned int& Buffer, size_t Bytes, GLenum Usage = GL_DYNAMIC_COPY) {
+    if (Buffer != 0) { glDeleteBuffers(1, &Buffer); }
+    glGenBuffers(1, &Buffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, Buffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, static_cast<GLsizeiptr>(Bytes), nullptr, Usage);
+}
+
+void DeleteBuffer(unsigned int& Buffer) {
+    if (Buffer != 0) { glDeleteBuffers(1, &Buffer); }
+    Buffer = 0;
+}
+
+} // namespace
+
+GPUParticleSimulation::~GPUParticleSimulation() {
+    Shutdown();
+}
+
+bool GPUParticleSimulation::Initialize(uint32_t InCapacity, uint32_t InMaxBatches) {
+    if (!GLCapabilities::Get().ComputeShaders) { return false; }
+
+    const std::string& Directory = ShaderLibrary::GetShaderDirectory();
+    SimulateProgram = Shaders.LoadCompute(Directory + "/ParticleSimulate.comp");
+    SpawnProgram = Shaders.LoadCompute(Directory + "/ParticleSpawn.comp");
+    FinalizeProgram = Shaders.LoadCompute(Directory + "/ParticleFinalize.comp");
+    SortKeyProgram = Shaders.LoadCompute(Directory + "/ParticleSortKey.comp");
+    SortLocalProgram = Shaders.LoadCompute(Directory + "/ParticleSortLocal.comp");
+    SortGlobalProgram = Shaders.LoadCompute(Directory + "/ParticleSortGlobal.comp");
+    GatherProgram = Shaders.LoadCompute(Directory + "/ParticleGather.comp");
+    for (const ShaderProgramId Program : {SimulateProgram, SpawnProgram, FinalizeProgram, SortKeyProgram, SortLocalProgram,
+                                          SortGlobalProgram, GatherProgram}) {
+        if (!Shaders.GetCompute(Program)) {
+            Shutdown();
+            return false;
+        }
+    }
+
+    Capacity = std::max(InCapacity, 1u);
+    MaxBatches = std::max(InMaxBatches, 1u);
+    for (StreamSet& Set : Sets) {
+        CreateStorage(Set.PositionAge, Capacity * sizeof(Vec4));
+        CreateStorage(Set.VelocityLifetime, Capacity * sizeof(Vec4));
+        CreateStorage(Set.Emitter, Capacity * sizeof(uint32_t));
+        CreateStorage(Set.Counters, sizeof(GPUParticleCounters));
+    }
+    CreateStorage(BatchBuffer, MaxBatches * sizeof(ParticleSpawnBatch), GL_STREAM_DRAW);
+
+    glGenBuffers(ReadbackFrames, ReadbackBuffers);
+    for (unsigned int Buffer : ReadbackBuffers) {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, Buffer);
+        glBufferData(GL_COPY_WRITE_BUFFER, sizeof(uint32_t), nullptr, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    Clear();
+    return true;
+}
+
+void GPUParticleSimulation::Shutdown() {
+    for (ShaderProgramId* Program : {&SimulateProgram, &SpawnProgram, &FinalizeProgram, &SortKeyProgram, &SortLocalProgram,
+                                     &SortGlobalProgram, &GatherProgram}) {
+        Shaders.Unload(*Program);
+        *Program = InvalidShaderProgramId;
+    }
+
+    for (StreamSet& Set : Sets) {
+        DeleteBuffer(Set.PositionAge);
+        DeleteBuffer(Set.VelocityLifetime);
+        DeleteBuffer(Set.Emitter);
+        DeleteBuffer(Set.Counters);
+    }
+    DeleteBuffer(BatchBuffer);
+    DeleteBuffer(SortKeys);
+    DeleteBuffer(SortedPositionAge);
+    DeleteBuffer(SortedEmitter);
+
+    for (uint32_t i = 0; i < ReadbackFrames; ++i) {
+        if (ReadbackFences[i] != nullptr) { glDeleteSync(static_cast<GLsync>(ReadbackFences[i])); }
+        DeleteBuffer(ReadbackBuffers[i]);
+        ReadbackFences[i] = nullptr;
+    }
+    Capacity = 0;
+    SortCapacity = 0;
+    LastCount = 0;
+    UpperBound = 0;
+}
+
+void GPUParticleSimulation::Clear() {
+    ResetCounters(Sets[0].Counters);
+    ResetCounters(Sets[1].Counters);
+    Front = 0;
+    Sorted = false;
+    LastCount = 0;
+    UpperBound = 0;
+    for (uint32_t i = 0; i < ReadbackFrames; ++i) {
+        if (ReadbackFences[i] != nullptr) { glDeleteSync(static_cast<GLsync>(ReadbackFences[i])); }
+        ReadbackFences[i] = nullptr;
+    }
+}
+
+void GPUParticleSimulation::ResetCounters(unsigned int Buffer) const {
+    const GPUParticleCounters Empty = {4, 0, 0, 0, 0, 1, 1, 0};
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, Buffer);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(Empty), &Empty);
+}
+
+void GPUParticleSimulation::Simulate(float DeltaTime, unsigned int EmitterTable, const ParticleSpawnBatch* Batches, uint32_t BatchCount) {
+    const StreamSet& Source = Sets[Front];
+    const StreamSet& Target = Sets[1 - Front];
+    ResetCounters(Target.Counters);
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, SourcePositionBinding, Source.PositionAge);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, SourceVelocityBinding, Source.VelocityLifetime);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, SourceEmitterBinding, Source.Emitter);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, PositionBinding, Target.PositionAge);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, VelocityBinding, Target.VelocityLifetime);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, EmitterBinding, Target.Emitter);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, SourceCounterBinding, Source.Counters);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, CounterBinding, Target.Counters);
+
+    glActiveTexture(GL_TEXTURE0 + EmitterUnit);
+    glBindTexture(GL_TEXTURE_BUFFER, EmitterTable);
+    // A failed reload keeps the previous program, so each is there once Initialize succeeded
+    const ComputeProgram& SimulateKernel = *Shaders.GetCompute(SimulateProgram);
+    SimulateKernel.Use();
+    SimulateKernel.SetInt("uEmitters", EmitterUnit);
+    SimulateKernel.SetFloat("uDeltaTime", DeltaTime);
+    glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, Source.Counters);
+    glDispatchComputeIndirect(DispatchOffset);
+    glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, 0);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+    BatchCount = std::min(BatchCount, MaxBatches);
+    const uint32_t SpawnCount = BatchCount > 0 ? Batches[BatchCount - 1].FirstParticle + Batches[BatchCount - 1].Count : 0;
+    if (SpawnCount > 0) {
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, BatchBuffer);
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, static_cast<GLsizeiptr>(BatchCount * sizeof(ParticleSpawnBatch)), Batches);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, BatchBinding, BatchBuffer);
+        const ComputeProgram& SpawnKernel = *Shaders.GetCompute(SpawnProgram);
+        SpawnKernel.Use();
+        SpawnKernel.SetUInt("uBatchCount", BatchCount);
+        SpawnKernel.SetUInt("uSpawnCount", SpawnCount);
+        SpawnKernel.SetUInt("uCapacity", Capacity);
+        SpawnKernel.Dispatch(ComputeProgram::GetGroupCount(SpawnCount, GroupSize));
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+    }
+
+    const ComputeProgram& FinalizeKernel = *Shaders.GetCompute(FinalizeProgram);
+    FinalizeKernel.Use();
+    FinalizeKernel.SetUInt("uCapacity", Capacity);
+    FinalizeKernel.Dispatch(1);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_COMMAND_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT |
+                    GL_BUFFER_UPDATE_BARRIER_BIT);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+
+    Front = 1 - Front;
+    Sorted = false;
+    SpawnedTotal += SpawnCount;
+    UpperBound = std::min(Capacity, UpperBound + SpawnCount);
+    PollReadback();
+    QueueReadback();
+    ++FrameNumber;
+}
+
+void GPUParticleSimulation::Sort(const Vec3& CameraPosition) {
+    if (UpperBound == 0) { return; }
+    if (SortKeys == 0) {
+        SortCapacity = std::max(std::bit_ceil(Capacity), SortBlockSize);
+        CreateStorage(SortKeys, SortCapacity * sizeof(uint32_t) * 2);
+        CreateStorage(SortedPositionAge, Capacity * sizeof(Vec4));
+        CreateStorage(SortedEmitter, Capacity * sizeof(uint32_t));
+    }
+    const uint32_t SortCount = std::max(std::bit_ceil(UpperBound), SortBlockSize);
+    LastSortCount = SortCount;
+    const StreamSet& Source = Sets[Front];
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, SourcePositionBinding, Source.PositionAge);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, SortKeyBinding, SortKeys);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, SourceEmitterBinding, Source.Emitter);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, PositionBinding, SortedPositionAge);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, EmitterBinding, SortedEmitter);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, CounterBinding, Source.Counters);
+
+    const ComputeProgram& SortKeyKernel = *Shaders.GetCompute(SortKeyProgram);
+    SortKeyKernel.Use();
+    SortKeyKernel.SetUInt("uSortCount", SortCount);
+    SortKeyKernel.SetVec3("uCameraPosition", CameraPosition);
+    SortKeyKernel.Dispatch(ComputeProgram::GetGroupCount(SortCount, GroupSize));
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+    const uint32_t Blocks = SortCount / SortBlockSize;
+    const ComputeProgram& SortLocalKernel = *Shaders.GetCompute(SortLocalProgram);
+    SortLocalKernel.Use();
+    SortLocalKernel.SetUInt("uK", 0);
+    SortLocalKernel.Dispatch(Blocks);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+    const ComputeProgram& SortGlobalKernel = *Shaders.GetCompute(SortGlobalProgram);
+    for (uint32_t K = SortBlockSize * 2; K <= SortCount; K <<= 1) {
+        SortGlobalKernel.Use();
+        SortGlobalKernel.SetUInt("uSortCount", SortCount);
+        SortGlobalKernel.SetUInt("uK", K);
+        for (uint32_t J = K >> 1; J >= SortBlockSize; J >>= 1) {
+            SortGlobalKernel.SetUInt("uJ", J);
+            SortGlobalKernel.Dispatch(ComputeProgram::GetGroupCount(SortCount / 2, GroupSize));
+            glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+        }
+        SortLocalKernel.Use();
+        SortLocalKernel.SetUInt("uK", K);
+        SortLocalKernel.Dispatch(Blocks);
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+    }
+
+    const ComputeProgram& GatherKernel = *Shaders.GetCompute(GatherProgram);
+    GatherKernel.Use();
+    glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, Source.Counters);
+    glDispatchComputeIndirect(DispatchOffset);
+    glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, 0);
+    glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+    Sorted = true;
+}
+
+void GPUParticleSimulation::Draw(unsigned int PositionLocation, unsigned int EmitterLocation) const {
+    glBindBuffer(GL_ARRAY_BUFFER, Sorted ? SortedPositionAge : Sets[Front].PositionAge);
+    for (unsigned int Component = 0; Component < 4; ++Component) {
+        glEnableVertexAttribArray(PositionLocation + Component);
+        glVertexAttribPointer(PositionLocation + Component, 1, GL_FLOAT, GL_FALSE, sizeof(Vec4),
+                              reinterpret_cast<void*>(static_cast<uintptr_t>(Component * sizeof(float))));
+        glVertexAttribDivisor(PositionLocation + Component, 1);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, Sorted ? SortedEmitter : Sets[Front].Emitter);
+    glEnableVertexAttribArray(EmitterLocation);
+    glVertexAttribIPointer(EmitterLocation, 1, GL_UNSIGNED_INT, sizeof(uint32_t), nullptr);
+    glVertexAttribDivisor(EmitterLocation, 1);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, Sets[Front].Counters);
+    glDrawArraysIndirect(GL_TRIANGLE_STRIP, nullptr);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+void GPUParticleSimulation::QueueReadback() {
+    const uint32_t Slot = FrameNumber % ReadbackFrames;
+    // Still pending after a full ring: drop it rather than wait
+    if (ReadbackFences[Slot] != nullptr) { glDeleteSync(static_cast<GLsync>(ReadbackFences[Slot])); }
+
+    glBindBuffer(GL_COPY_READ_BUFFER, Sets[Front].Counters);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, ReadbackBuffers[Slot]);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, CountOffset, 0, sizeof(uint32_t));
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    ReadbackFences[Slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    ReadbackSpawned[Slot] = SpawnedTotal;
+}
+
+void GPUParticleSimulation::PollReadback() {
+    // Newest completed copy wins; older ones are simply released
+    for (uint32_t Age = ReadbackFrames; Age > 0; --Age) {
+        if (FrameNumber < Age) { continue; }
+        const uint32_t Slot = (FrameNumber - Age) % ReadbackFrames;
+        auto Fence = static_cast<GLsync>(ReadbackFences[Slot]);
+        if (Fence == nullptr) { continue; }
+
+        const GLenum Status = glClientWaitSync(Fence, 0, 0);
+        if (Status != GL_ALREADY_SIGNALED && Status != GL_CONDITION_SATISFIED) { continue; }
+
+        uint32_t Count = 0;
+        glBindBuffer(GL_COPY_READ_BUFFER, ReadbackBuffers[Slot]);
+        glGetBufferSubData(GL_COPY_READ_BUFFER, 0, sizeof(uint32_t), &Count);
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+        glDeleteSync(Fence);
+        ReadbackFences[Slot] = nullptr;
+
+        LastCount = Count;
+        UpperBound = static_cast<uint32_t>(std::min<uint64_t>(Capacity, Count + (SpawnedTotal - ReadbackSpawned[Slot])));
+    }
+}
+
+} // namespace Volante
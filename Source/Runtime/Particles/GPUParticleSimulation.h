@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstdint>
+
+#include "ParticleTypes.h"
+#include "Runtime/Rendering/ShaderLibrary.h"
+
+namespace Volante {
+
+// GL 4.3 compute path. Particles live in two sets of storage buffers, one vec4 stream each for
+// position + age and velocity + inverse lifetime and a uint stream for the emitter, and every
+// step reads one set and writes the other:
+//
+//   Simulate: one thread per live particle; survivors append to the other set, so dead
+//             particles are compacted away as a side effect
+//   Spawn:    one thread per new particle, appended after the survivors
+//   Finalize: one thread clamps the count and writes the next step's indirect dispatch and the
+//             billboard draw's instance count
+//
+// The live count never leaves the GPU: each step is dispatched indirectly from the counts the
+// previous one wrote, and the draw is glDrawArraysIndirect. A copy of it is read back a few
+// frames late, for stats and to bound the sort.
+//
+// Sort() orders the particles back to front with a bitonic sort of (distance, index) keys,
+// 1024-element blocks in shared memory and larger strides in global passes, then gathers the
+// drawn streams in that order.
+//
+// The kernels are the Particle*.comp files, loaded through Shaders.
+class GPUParticleSimulation {
+public:
+    explicit GPUParticleSimulation(ShaderLibrary& Shaders) : Shaders(Shaders) {}
+    ~GPUParticleSimulation();
+
+    GPUParticleSimulation(const GPUParticleSimulation&) = delete;
+    GPUParticleSimulation& operator=(const GPUParticleSimulation&) = delete;
+
+    // False when compute is unavailable or a kernel failed to compile; the caller then falls
+    // back to CPUParticleSimulation.
+    bool Initialize(uint32_t Capacity, uint32_t MaxBatches);
+    void Shutdown();
+    void Clear();
+
+    // EmitterTable is the RGBA32F buffer texture of ParticleEmitterParams rows. Batches are laid
+    // out as ParticleSpawnBatch describes; at most MaxBatches.
+    void Simulate(float DeltaTime, unsigned int EmitterTable, const ParticleSpawnBatch* Batches, uint32_t BatchCount);
+
+    void Sort(const Vec3& CameraPosition);
+
+    // Binds the drawn streams as instance attributes of the bound vertex array (floats at
+    // PositionLocation .. PositionLocation + 3, the emitter at EmitterLocation) and draws a
+    // four-vertex strip per particle, without reading the count back.
+    void Draw(unsigned int PositionLocation, unsigned int EmitterLocation) const;
+
+    // Lags the simulation by a few frames.
+    [[nodiscard]] uint32_t GetLastCount() const { return LastCount; }
+
+    // Never below the live count: the last count read back plus everything spawned since.
+    [[nodiscard]] uint32_t GetUpperBound() const { return UpperBound; }
+
+    [[nodiscard]] uint32_t GetCapacity() const { return Capacity; }
+
+    // Elements the last Sort() ordered (the upper bound rounded up to a power of two)
+    [[nodiscard]] uint32_t GetLastSortCount() const { return LastSortCount; }
+
+private:
+    static constexpr uint32_t ReadbackFrames = 3;
+
+    struct StreamSet {
+        unsigned int PositionAge = 0;
+        unsigned int VelocityLifetime = 0;
+        unsigned int Emitter = 0;
+        // Live count, dispatch and draw arguments
+        unsigned int Counters = 0;
+    };
+
+    void ResetCounters(unsigned int Buffer) const;
+    void QueueReadback();
+    void PollReadback();
+
+    ShaderLibrary& Shaders;
+    ShaderProgramId SimulateProgram = InvalidShaderProgramId;
+    ShaderProgramId SpawnProgram = InvalidShaderProgramId;
+    ShaderProgramId FinalizeProgram = InvalidShaderProgramId;
+    ShaderProgramId SortKeyProgram = InvalidShaderProgramId;
+    ShaderProgramId SortLocalProgram = InvalidShaderProgramId;
+    ShaderProgramId SortGlobalProgram = InvalidShaderProgramId;
+    ShaderProgramId GatherProgram = InvalidShaderProgramId;
+
+    StreamSet Sets[2];
+    uint32_t Front = 0;
+    unsigned int BatchBuffer = 0;
+    unsigned int SortKeys = 0;
+    // Drawn instead of the front set after Sort(), until the next Simulate
+    unsigned int SortedPositionAge = 0;
+    unsigned int SortedEmitter = 0;
+    bool Sorted = false;
+
+    uint32_t Capacity = 0;
+    uint32_t MaxBatches = 0;
+    uint32_t SortCapacity = 0;
+    uint32_t LastSortCount = 0;
+
+    unsigned int ReadbackBuffers[ReadbackFrames] = {};
+    void* ReadbackFences[ReadbackFrames] = {};
+    // Particles spawned in total when each copy was queued
+    uint64_t ReadbackSpawned[ReadbackFrames] = {};
+    uint64_t FrameNumber = 0;
+    uint64_t SpawnedTotal = 0;
+    uint32_t LastCount = 0;
+    uint32_t UpperBound = 0;
+};
+
+} // namespace Volante
@@ -0,0 +1,278 @@
+#include "ParticleSystem.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "CPUParticleSimulation.h"
+#include "GPUParticleSimulation.h"
+#include "Runtime/Core/Async/JobSystem.h"
+#include "Runtime/Core/Stats/StatCounters.h"
+#include "Runtime/Rendering/UploadRing.h"
+#include "Shader.h"
+
+namespace Volante {
+
+namespace {
+
+constexpr int EmitterUnit = 0;
+constexpr GLuint PositionLocation = 0;
+constexpr GLuint EmitterLocation = 4;
+
+ParticleEmitterParams MakeParams(const ParticleEmitterDesc& Desc) {
+    ParticleEmitterParams Params;
+    Params.ColorStart = Desc.ColorStart;
+    Params.ColorEnd = Desc.ColorEnd;
+    Params.Size = Vec4(Desc.SizeStart, Desc.SizeEnd, 0.0f, 0.0f);
+    Params.GravityDrag = Vec4(Desc.Gravity, Desc.Drag);
+    return Params;
+}
+
+void SetFloatAttribute(GLuint Location, size_t Offset) {
+    glEnableVertexAttribArray(Location);
+    glVertexAttribPointer(Location, 1, GL_FLOAT, GL_FALSE, sizeof(float), reinterpret_cast<void*>(Offset));
+    glVertexAttribDivisor(Location, 1);
+}
+
+} // namespace
+
+ParticleSystem::ParticleSystem(const ParticleSystemDesc& Desc, JobSystem* Jobs, ShaderLibrary* Shaders)
+    : Desc(Desc), Jobs(Jobs), Shaders(Shaders) {}
+
+ParticleSystem::~ParticleSystem() {
+    Shutdown();
+}
+
+void ParticleSystem::Initialize() {
+    Emitters.assign(Desc.MaxEmitters, {});
+    EmitterParams.assign(Desc.MaxEmitters, {});
+    FreeIds.clear();
+    for (uint32_t Id = Desc.MaxEmitters; Id > 0; --Id) { FreeIds.push_back(Id - 1); }
+
+    if (!Shaders) {
+        OwnedShaders = std::make_unique<ShaderLibrary>(Jobs);
+        OwnedShaders->Initialize();
+        Shaders = OwnedShaders.get();
+    }
+    if (Desc.AllowCompute) {
+        GPUSimulation = std::make_unique<GPUParticleSimulation>(*Shaders);
+        if (!GPUSimulation->Initialize(Desc.MaxParticles, Desc.MaxEmitters)) { GPUSimulation.reset(); }
+    }
+    if (!GPUSimulation) { CPUSimulation = std::make_unique<CPUParticleSimulation>(Desc.MaxParticles); }
+    Stats.GPUSimulation = GPUSimulation != nullptr;
+
+    const std::string& Directory = ShaderLibrary::GetShaderDirectory();
+    BillboardProgram.Id = Shaders->Load({Directory + "/ParticleBillboard.vert", Directory + "/ParticleBillboard.frag"});
+    if (!Shaders->Get(BillboardProgram.Id)) {
+        Shaders->Unload(BillboardProgram.Id);
+        BillboardProgram = {};
+    }
+
+    glGenVertexArrays(1, &VertexArray);
+    glGenBuffers(1, &EmitterBuffer);
+    glBindBuffer(GL_TEXTURE_BUFFER, EmitterBuffer);
+    glBufferData(GL_TEXTURE_BUFFER, static_cast<GLsizeiptr>(EmitterParams.size() * sizeof(ParticleEmitterParams)), EmitterParams.data(),
+                 GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    glGenTextures(1, &EmitterTexture);
+    glBindTexture(GL_TEXTURE_BUFFER, EmitterTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, EmitterBuffer);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+}
+
+void ParticleSystem::Shutdown() {
+    GPUSimulation.reset();
+    CPUSimulation.reset();
+    if (Shaders) { Shaders->Unload(BillboardProgram.Id); }
+    BillboardProgram = {};
+    if (VertexArray != 0) { glDeleteVertexArrays(1, &VertexArray); }
+    if (EmitterBuffer != 0) { glDeleteBuffers(1, &EmitterBuffer); }
+    if (EmitterTexture != 0) { glDeleteTextures(1, &EmitterTexture); }
+    VertexArray = EmitterBuffer = EmitterTexture = 0;
+    Emitters.clear();
+    EmitterParams.clear();
+    FreeIds.clear();
+    Batches.clear();
+    Stats = {};
+    if (OwnedShaders) {
+        OwnedShaders->Shutdown();
+        OwnedShaders.reset();
+        Shaders = nullptr;
+    }
+}
+
+ParticleEmitterId ParticleSystem::CreateEmitter(const ParticleEmitterDesc& EmitterDesc) {
+    if (FreeIds.empty()) {
+        std::cerr << "ERROR::PARTICLE_SYSTEM::EMITTER_POOL_EXHAUSTED: all " << Desc.MaxEmitters << " emitters are in use" << std::endl;
+        return InvalidParticleEmitterId;
+    }
+    const ParticleEmitterId Id = FreeIds.back();
+    FreeIds.pop_back();
+    Emitter& Target = Emitters[Id];
+    Target = {};
+    Target.Desc = EmitterDesc;
+    Target.State = EmitterState::Active;
+    EmitterParams[Id] = MakeParams(EmitterDesc);
+    EmitterParamsDirty = true;
+    return Id;
+}
+
+void ParticleSystem::DestroyEmitter(ParticleEmitterId Id) {
+    if (Id >= Emitters.size() || Emitters[Id].State != EmitterState::Active) { return; }
+    Emitter& Target = Emitters[Id];
+    Target.State = EmitterState::Draining;
+    Target.DrainTime = std::max(Target.Desc.LifetimeMin, Target.Desc.LifetimeMax);
+    Target.PendingBurst = 0;
+}
+
+void ParticleSystem::SetEmitterPosition(ParticleEmitterId Id, const Vec3& Position) {
+    if (Id >= Emitters.size()) { return; }
+    Emitters[Id].Desc.Position = Position;
+}
+
+void ParticleSystem::Burst(ParticleEmitterId Id, uint32_t Count) {
+    if (Id >= Emitters.size() || Emitters[Id].State != EmitterState::Active) { return; }
+    Emitters[Id].PendingBurst += Count;
+}
+
+void ParticleSystem::Clear() {
+    if (GPUSimulation) { GPUSimulation->Clear(); }
+    if (CPUSimulation) { CPUSimulation->Clear(); }
+    Stats.ParticleCount = 0;
+}
+
+void ParticleSystem::BuildSpawnBatches(float DeltaTime) {
+    Batches.clear();
+    uint32_t Total = 0;
+    for (ParticleEmitterId Id = 0; Id < Emitters.size(); ++Id) {
+        Emitter& Source = Emitters[Id];
+        if (Source.State == EmitterState::Draining) {
+            Source.DrainTime -= DeltaTime;
+            // One frame past the lifetime, so particles spawned the frame it was destroyed are gone too
+            if (Source.DrainTime < -DeltaTime) {
+                Source.State = EmitterState::Free;
+                FreeIds.push_back(Id);
+            }
+            continue;
+        }
+        if (Source.State != EmitterState::Active) { continue; }
+
+        Source.Accumulator += std::max(Source.Desc.Rate, 0.0f) * DeltaTime;
+        const float Whole = std::floor(Source.Accumulator);
+        Source.Accumulator -= Whole;
+        const uint32_t Count = static_cast<uint32_t>(Whole) + Source.PendingBurst;
+        Source.PendingBurst = 0;
+        if (Count == 0) { continue; }
+
+        const ParticleEmitterDesc& EmitterDesc = Source.Desc;
+        const float Length = glm::length(EmitterDesc.Direction);
+        const Vec3 Direction = Length > 1e-6f ? EmitterDesc.Direction / Length : Vec3(0.0f, 1.0f, 0.0f);
+        ParticleSpawnBatch& Batch = Batches.emplace_back();
+        Batch.PositionCosSpread = Vec4(EmitterDesc.Position, std::cos(std::clamp(EmitterDesc.Spread, 0.0f, PI)));
+        Batch.DirectionSpeedMin = Vec4(Direction, EmitterDesc.SpeedMin);
+        Batch.SpeedLifetimeRadius = Vec4(EmitterDesc.SpeedMax, EmitterDesc.LifetimeMin, EmitterDesc.LifetimeMax, EmitterDesc.SpawnRadius);
+        Batch.Emitter = Id;
+        Batch.FirstParticle = Total;
+        Batch.Count = std::min(Count, Desc.MaxParticles);
+        Batch.Seed = HashParticle(FrameIndex * Desc.MaxEmitters + Id);
+        Total += Batch.Count;
+    }
+    Stats.SpawnedCount = Total;
+}
+
+void ParticleSystem::Update(float DeltaTime) {
+    StatScope Scope(StatTimer::Particles);
+    if (OwnedShaders) { OwnedShaders->Update(DeltaTime); }
+    if (Emitters.empty()) { return; }
+
+    BuildSpawnBatches(DeltaTime);
+    ++FrameIndex;
+    Stats.EmitterCount = Desc.MaxEmitters - static_cast<uint32_t>(FreeIds.size());
+
+    if (EmitterParamsDirty) {
+        glBindBuffer(GL_TEXTURE_BUFFER, EmitterBuffer);
+        glBufferSubData(GL_TEXTURE_BUFFER, 0, static_cast<GLsizeiptr>(EmitterParams.size() * sizeof(ParticleEmitterParams)),
+                        EmitterParams.data());
+        glBindBuffer(GL_TEXTURE_BUFFER, 0);
+        EmitterParamsDirty = false;
+    }
+
+    const auto BatchCount = static_cast<uint32_t>(Batches.size());
+    if (GPUSimulation) {
+        GPUSimulation->Simulate(DeltaTime, EmitterTexture, Batches.data(), BatchCount);
+        Stats.ParticleCount = GPUSimulation->GetLastCount();
+        return;
+    }
+    CPUSimulation->Simulate(DeltaTime, EmitterParams.data(), Jobs, Desc.SimulationGrain);
+    CPUSimulation->Spawn(Batches.data(), BatchCount, Jobs, Desc.SimulationGrain);
+    Stats.ParticleCount = CPUSimulation->GetCount();
+}
+
+void ParticleSystem::Render(const RenderView& View, UploadRing& Uploads) {
+    StatScope Scope(StatTimer::Particles);
+    Stats.SortedCount = 0;
+    if (BillboardProgram.Id == InvalidShaderProgramId) { return; }
+    const uint32_t Count = GPUSimulation ? GPUSimulation->GetUpperBound() : CPUSimulation->GetCount();
+    if (Count == 0) { return; }
+
+    if (GPUSimulation && Desc.SortForTransparency) {
+        GPUSimulation->Sort(View.Position);
+        Stats.SortedCount = GPUSimulation->GetLastSortCount();
+    }
+
+    glBindVertexArray(VertexArray);
+    if (CPUSimulation) {
+        // Each stream is copied as is; the attributes point at their ranges of one allocation
+        const ParticleStreams& Streams = CPUSimulation->GetStreams();
+        const size_t StreamBytes = Count * sizeof(float);
+        const UploadAllocation Upload = Uploads.Allocate(StreamBytes * 5);
+        auto* Data = static_cast<uint8_t*>(Upload.Data);
+        const float* Sources[] = {Streams.PositionX.data(), Streams.PositionY.data(), Streams.PositionZ.data(), Streams.Age.data()};
+        ParallelFor(Jobs, Count, Desc.SimulationGrain, [&](uint32_t Begin, uint32_t End) {
+            const size_t Offset = Begin * sizeof(float);
+            const size_t Bytes = (End - Begin) * sizeof(float);
+            for (size_t Stream = 0; Stream < 4; ++Stream) { std::memcpy(Data + StreamBytes * Stream + Offset, Sources[Stream] + Begin, Bytes); }
+            std::memcpy(Data + StreamBytes * 4 + Offset, Streams.Emitter.data() + Begin, Bytes);
+        });
+        Uploads.Flush();
+
+        glBindBuffer(GL_ARRAY_BUFFER, Upload.Buffer);
+        for (GLuint Stream = 0; Stream < 4; ++Stream) { SetFloatAttribute(PositionLocation + Stream, Upload.Offset + StreamBytes * Stream); }
+        glEnableVertexAttribArray(EmitterLocation);
+        glVertexAttribIPointer(EmitterLocation, 1, GL_UNSIGNED_INT, sizeof(uint32_t), reinterpret_cast<void*>(Upload.Offset + StreamBytes * 4));
+        glVertexAttribDivisor(EmitterLocation, 1);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    // A failed reload keeps the previous program, so there is one once Initialize loaded it
+    const Shader& Program = *Shaders->Get(BillboardProgram.Id);
+    Program.use();
+    if (Shaders->Refresh(BillboardProgram)) { Program.setInt("uEmitters", EmitterUnit); }
+    Program.setMat4("uViewProjection", View.RelativeViewProjection);
+    Program.setVec3("uViewOrigin", View.Origin);
+    Program.setVec3("uCameraRight", Vec3(View.View[0][0], View.View[1][0], View.View[2][0]));
+    Program.setVec3("uCameraUp", Vec3(View.View[0][1], View.View[1][1], View.View[2][1]));
+    glActiveTexture(GL_TEXTURE0 + EmitterUnit);
+    glBindTexture(GL_TEXTURE_BUFFER, EmitterTexture);
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glDepthMask(GL_FALSE);
+    if (GPUSimulation) {
+        GPUSimulation->Draw(PositionLocation, EmitterLocation);
+    } else {
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(Count));
+    }
+    glDepthMask(GL_TRUE);
+    glDisable(GL_BLEND);
+
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    StatCounters::Add(StatCounter::DrawCalls);
+}
+
+} // namespace Volante
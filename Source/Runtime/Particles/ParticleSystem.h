@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Engine.h"
+#include "ParticleTypes.h"
+#include "Runtime/Rendering/RenderView.h"
+#include "Runtime/Rendering/ShaderLibrary.h"
+
+namespace Volante {
+
+class JobSystem;
+class Shader;
+class UploadRing;
+class CPUParticleSimulation;
+class GPUParticleSimulation;
+
+struct ParticleSystemDesc {
+    uint32_t MaxParticles = 256 * 1024;
+    // Size of the emitter pool
+    uint32_t MaxEmitters = 256;
+
+    // Turn off to simulate on the CPU even where compute shaders are available
+    bool AllowCompute = true;
+
+    // Draw back to front, for alpha blending that does not depend on spawn order. Compute
+    // path only: a bitonic sort of every live particle, each frame.
+    bool SortForTransparency = false;
+
+    // Particles per job on the CPU path
+    uint32_t SimulationGrain = 16 * 1024;
+};
+
+struct ParticleStats {
+    // Exact on the CPU path; on the compute path, the count of a few frames ago
+    uint32_t ParticleCount = 0;
+    // Started by the last Update
+    uint32_t SpawnedCount = 0;
+    uint32_t EmitterCount = 0;
+    // Keys the last sort ordered, padding included
+    uint32_t SortedCount = 0;
+    bool GPUSimulation = false;
+};
+
+// Emitters and the particles they spawn, drawn as camera-facing billboards.
+//
+// Particles are simulated in Update() by GPUParticleSimulation where compute shaders exist and
+// by CPUParticleSimulation's SIMD kernels on the job system otherwise; both keep the live
+// particles packed at the front of structure-of-arrays streams, and both start a particle from
+// the same spawn batch and hash, so the two paths look alike. Render() draws every particle
+// with one instanced draw of a four-vertex strip, colour and size coming from the emitter
+// table by the particle's age.
+//
+// Emitters come from a fixed pool. A destroyed emitter stops spawning at once, but its slot is
+// only handed out again after its longest lifetime has passed, so no live particle ever reads
+// another emitter's table row.
+//
+// The billboard program and the compute kernels are loaded through Shaders, or through a
+// library of the system's own, updated in Update(), when none is given.
+class ParticleSystem : public IEngineSubsystem {
+public:
+    explicit ParticleSystem(const ParticleSystemDesc& Desc = {}, JobSystem* Jobs = nullptr,
+                            ShaderLibrary* Shaders = nullptr);
+    ~ParticleSystem() override;
+
+    ParticleSystem(const ParticleSystem&) = delete;
+    ParticleSystem& operator=(const ParticleSystem&) = delete;
+
+    void Initialize() override;
+    void Shutdown() override;
+    // Emits and simulates. Call with the context current.
+    void Update(float DeltaTime) override;
+
+    // Returns InvalidParticleEmitterId when the pool is exhausted.
+    ParticleEmitterId CreateEmitter(const ParticleEmitterDesc& EmitterDesc);
+    void DestroyEmitter(ParticleEmitterId Id);
+    void SetEmitterPosition(ParticleEmitterId Id, const Vec3& Position);
+    // Emits Count particles on top of the rate at the next Update.
+    void Burst(ParticleEmitterId Id, uint32_t Count);
+
+    // Kills every particle; emitters keep emitting.
+    void Clear();
+
+    // Draws into the bound framebuffer, depth tested but not written, alpha blended.
+    void Render(const RenderView& View, UploadRing& Uploads);
+
+    [[nodiscard]] bool IsGPUSimulation() const { return GPUSimulation != nullptr; }
+
+    [[nodiscard]] const ParticleStats& GetStats() const { return Stats; }
+
+private:
+    enum class EmitterState : uint8_t {
+        Free,
+        Active,
+        // Destroyed, waiting for its particles to die
+        Draining,
+    };
+
+    struct Emitter {
+        ParticleEmitterDesc Desc;
+        EmitterState State = EmitterState::Free;
+        // Fraction of a particle carried to the next Update
+        float Accumulator = 0.0f;
+        uint32_t PendingBurst = 0;
+        float DrainTime = 0.0f;
+    };
+
+    void BuildSpawnBatches(float DeltaTime);
+
+    ParticleSystemDesc Desc;
+    JobSystem* Jobs;
+    ShaderLibrary* Shaders;
+    std::unique_ptr<ShaderLibrary> OwnedShaders;
+    std::vector<Emitter> Emitters;
+    std::vector<ParticleEmitterId> FreeIds;
+    std::vector<ParticleEmitterParams> EmitterParams;
+    bool EmitterParamsDirty = false;
+    std::vector<ParticleSpawnBatch> Batches;
+    uint32_t FrameIndex = 0;
+    ParticleStats Stats;
+
+    std::unique_ptr<GPUParticleSimulation> GPUSimulation;
+    std::unique_ptr<CPUParticleSimulation> CPUSimulation;
+
+    ShaderProgramHandle BillboardProgram;
+    unsigned int VertexArray = 0;
+    unsigned int EmitterBuffer = 0;
+    unsigned int EmitterTexture = 0;
+};
+
+} // namespace Volante
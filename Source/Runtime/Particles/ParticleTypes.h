@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Volante.h"
+
+namespace Volante {
+
+using ParticleEmitterId = uint32_t;
+constexpr ParticleEmitterId InvalidParticleEmitterId = ~0u;
+
+struct ParticleEmitterDesc {
+    Vec3 Position = Vec3(0.0f);
+    // Centre of the emission cone; need not be normalized
+    Vec3 Direction = Vec3(0.0f, 1.0f, 0.0f);
+    // Half-angle of the cone, radians
+    float Spread = 0.4f;
+    // Particles start up to this far along their direction, so a burst is not a single point
+    float SpawnRadius = 0.0f;
+
+    // Particles per second; bursts come on top
+    float Rate = 100.0f;
+    float SpeedMin = 1.0f;
+    float SpeedMax = 2.0f;
+    float LifetimeMin = 1.0f;
+    float LifetimeMax = 2.0f;
+
+    // Billboard size and colour at birth and death, interpolated over the particle's life
+    float SizeStart = 0.1f;
+    float SizeEnd = 0.05f;
+    Vec4 ColorStart = Vec4(1.0f);
+    Vec4 ColorEnd = Vec4(1.0f, 1.0f, 1.0f, 0.0f);
+
+    Vec3 Gravity = Vec3(0.0f, -9.81f, 0.0f);
+    // Fraction of velocity lost per second
+    float Drag = 0.0f;
+};
+
+// One emitter's row of the emitter table, as both simulations and the billboard shader read it
+// (four RGBA32F texels).
+struct ParticleEmitterParams {
+    Vec4 ColorStart = Vec4(1.0f);
+    Vec4 ColorEnd = Vec4(1.0f);
+    // Start size, end size
+    Vec4 Size = Vec4(0.0f);
+    // Gravity, drag
+    Vec4 GravityDrag = Vec4(0.0f);
+};
+
+// Particles one emitter starts this frame. Batches are laid out back to back: the batch's
+// particles are FirstParticle .. FirstParticle + Count of the frame's spawns. Matches the
+// std430 struct of the GPU spawn kernel.
+struct ParticleSpawnBatch {
+    // Origin, cosine of the cone half-angle
+    Vec4 PositionCosSpread = Vec4(0.0f);
+    // Normalized direction, minimum speed
+    Vec4 DirectionSpeedMin = Vec4(0.0f);
+    // Maximum speed, minimum and maximum lifetime, spawn radius
+    Vec4 SpeedLifetimeRadius = Vec4(0.0f);
+    uint32_t Emitter = 0;
+    uint32_t FirstParticle = 0;
+    uint32_t Count = 0;
+    uint32_t Seed = 0;
+};
+
+// PCG hash. The GPU spawn kernel carries the same function, so both simulations start a
+// given particle identically.
+inline uint32_t HashParticle(uint32_t Value) {
+    const uint32_t State = Value * 747796405u + 2891336453u;
+    const uint32_t Word = ((State >> ((State >> 28u) + 4u)) ^ State) * 277803737u;
+    return (Word >> 22u) ^ Word;
+}
+
+// Next value in [0, 1) from State, advancing it.
+inline float NextParticleRandom(uint32_t& State) {
+    State = HashParticle(State);
+    return static_cast<float>(State >> 8) * (1.0f / 16777216.0f);
+}
+
+} // namespace Volante
@@ -0,0 +1,121 @@
+#include "BroadPhase.h"
+
+#include <algorithm>
+
+#include "Collision.h"
+#include "Runtime/Core/Async/JobSystem.h"
+
+namespace Volante {
+
+namespace {
+
+bool CanInteract(const RigidBody& A, const RigidBody& B) {
+    return A.IsActive() || B.IsActive();
+}
+
+BodyPair MakePair(const std::vector<RigidBody>& Bodies, BodyId A, BodyId B) {
+    if (Bodies[A].Shape > Bodies[B].Shape || (Bodies[A].Shape == Bodies[B].Shape && A > B)) { std::swap(A, B); }
+    return {A, B};
+}
+
+} // namespace
+
+void SweepAndPrune::FindPairs(const std::vector<RigidBody>& Bodies, JobSystem* Jobs, std::vector<BodyPair>& OutPairs) {
+    OutPairs.clear();
+
+    const auto BodyCount = static_cast<uint32_t>(Bodies.size());
+    Bounds.resize(BodyCount);
+    ParallelFor(Jobs, BodyCount, 1024, [&](uint32_t Begin, uint32_t End) {
+        for (uint32_t i = Begin; i < End; ++i) {
+            if (!Bodies[i].Alive) { continue; }
+            const AABB Box = Bodies[i].GetBounds();
+            Bounds[i] = {Box.Min - Vec3(Collision::ContactMargin), Box.Max + Vec3(Collision::ContactMargin)};
+        }
+    });
+
+    // Switching axis costs a full sort, so only do it when the new axis is clearly better
+    const int BestAxis = ChooseAxis(Bodies);
+    if (!Valid || BestAxis != Axis) {
+        Axis = BestAxis;
+        Sorted.clear();
+        for (BodyId Id = 0; Id < BodyCount; ++Id) {
+            if (Bodies[Id].Alive) { Sorted.push_back({Bounds[Id].Min[Axis], Id}); }
+        }
+        std::sort(Sorted.begin(), Sorted.end(), [](const Entry& L, const Entry& R) {
+            return L.Min < R.Min || (L.Min == R.Min && L.Id < R.Id);
+        });
+        Valid = true;
+    } else {
+        for (Entry& Item : Sorted) {
+            Item.Min = Bounds[Item.Id].Min[Axis];
+        }
+        for (size_t i = 1; i < Sorted.size(); ++i) {
+            const Entry Item = Sorted[i];
+            size_t j = i;
+            while (j > 0 && (Sorted[j - 1].Min > Item.Min || (Sorted[j - 1].Min == Item.Min && Sorted[j - 1].Id > Item.Id))) {
+                Sorted[j] = Sorted[j - 1];
+                --j;
+            }
+            Sorted[j] = Item;
+        }
+    }
+
+    const auto EntryCount = static_cast<uint32_t>(Sorted.size());
+    const uint32_t ChunkCount = (EntryCount + SweepChunkSize - 1) / SweepChunkSize;
+    ChunkPairs.resize(ChunkCount);
+    ParallelFor(Jobs, ChunkCount, 1, [&](uint32_t ChunkBegin, uint32_t ChunkEnd) {
+        for (uint32_t Chunk = ChunkBegin; Chunk < ChunkEnd; ++Chunk) {
+            std::vector<BodyPair>& Pairs = ChunkPairs[Chunk];
+            Pairs.clear();
+
+            const uint32_t End = std::min(EntryCount, (Chunk + 1) * SweepChunkSize);
+            for (uint32_t i = Chunk * SweepChunkSize; i < End; ++i) {
+                const BodyId A = Sorted[i].Id;
+                const AABB& BoxA = Bounds[A];
+                const float MaxA = BoxA.Max[Axis];
+                for (uint32_t j = i + 1; j < EntryCount && Sorted[j].Min <= MaxA; ++j) {
+                    const BodyId B = Sorted[j].Id;
+                    if (!CanInteract(Bodies[A], Bodies[B]) || !BoxA.Intersects(Bounds[B])) { continue; }
+                    Pairs.push_back(MakePair(Bodies, A, B));
+                }
+            }
+        }
+    });
+
+    for (const std::vector<BodyPair>& Pairs : ChunkPairs) {
+        OutPairs.insert(OutPairs.end(), Pairs.begin(), Pairs.end());
+    }
+    std::sort(OutPairs.begin(), OutPairs.end(),
+              [](const BodyPair& L, const BodyPair& R) { return L.GetKey() < R.GetKey(); });
+}
+
+void SweepAndPrune::Clear() {
+    Sorted.clear();
+    Bounds.clear();
+    ChunkPairs.clear();
+    Valid = false;
+}
+
+int SweepAndPrune::ChooseAxis(const std::vector<RigidBody>& Bodies) const {
+    Vec3 Sum(0.0f);
+    Vec3 SumSquared(0.0f);
+    uint32_t Count = 0;
+    for (const RigidBody& Body : Bodies) {
+        if (!Body.Alive || Body.IsStatic()) { continue; }
+        Sum += Body.Position;
+        SumSquared += Body.Position * Body.Position;
+        ++Count;
+    }
+    if (Count == 0) { return Axis; }
+
+    const Vec3 Mean = Sum / static_cast<float>(Count);
+    const Vec3 Variance = SumSquared / static_cast<float>(Count) - Mean * Mean;
+
+    int Best = Axis;
+    for (int i = 0; i < 3; ++i) {
+        if (Variance[i] > Variance[Best] * 1.5f) { Best = i; }
+    }
+    return Best;
+}
+
+} // namespace Volante
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <vector>
+
+#include "PhysicsTypes.h"
+
+namespace Volante {
+
+class JobSystem;
+
+// Sweep and prune along the axis with the largest spread of body centers. The sorted order is
+// kept between steps and repaired with an insertion sort, which is close to linear because
+// bodies move little per step. Sweeping runs in fixed-size chunks so the pair list does not
+// depend on the number of workers.
+class SweepAndPrune {
+public:
+    // Emits canonical pairs (lower shape type first, then lower id) sorted by key. Pairs that
+    // cannot change anything (static-static, sleeping-static, sleeping-sleeping) are skipped.
+    void FindPairs(const std::vector<RigidBody>& Bodies, JobSystem* Jobs, std::vector<BodyPair>& OutPairs);
+
+    // Forces a full re-sort on the next step, after bodies were added or removed.
+    void Invalidate() { Valid = false; }
+
+    void Clear();
+
+private:
+    static constexpr uint32_t SweepChunkSize = 512;
+
+    struct Entry {
+        float Min;
+        BodyId Id;
+    };
+
+    [[nodiscard]] int ChooseAxis(const std::vector<RigidBody>& Bodies) const;
+
+    std::vector<Entry> Sorted;
+    std::vector<AABB> Bounds;
+    std::vector<std::vector<BodyPair>> ChunkPairs;
+    int Axis = 0;
+    bool Valid = false;
+};
+
+} // namespace Volante
@@ -0,0 +1,431 @@
+#include "Collision.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "Runtime/Core/Math/Simd.h"
+
+namespace Volante::Collision {
+
+namespace {
+
+constexpr float Epsilon = 1.0e-6f;
+
+struct BoxFrame {
+    Vec3 Center;
+    Vec3 Axis[3];
+    Vec3 Half;
+};
+
+BoxFrame MakeFrame(const RigidBody& Body) {
+    return {Body.Position, {Body.Rotation[0], Body.Rotation[1], Body.Rotation[2]}, Body.HalfExtents};
+}
+
+void SetSinglePoint(ContactManifold& Out, const Vec3& Normal, const Vec3& Position, float Penetration) {
+    Out.Normal = Normal;
+    Out.PointCount = 1;
+    Out.Points[0] = {};
+    Out.Points[0].Position = Position;
+    Out.Points[0].Penetration = Penetration;
+}
+
+// Sphere center inside the box: push out through the nearest face.
+void SphereInsideBox(const RigidBody& Sphere, const RigidBody& Box, ContactManifold& Out) {
+    const Vec3 Local = glm::transpose(Box.Rotation) * (Sphere.Position - Box.Position);
+    int Axis = 0;
+    float MinDepth = std::numeric_limits<float>::max();
+    for (int i = 0; i < 3; ++i) {
+        const float Depth = Box.HalfExtents[i] - std::fabs(Local[i]);
+        if (Depth < MinDepth) {
+            MinDepth = Depth;
+            Axis = i;
+        }
+    }
+    const float Side = Local[Axis] >= 0.0f ? 1.0f : -1.0f;
+    SetSinglePoint(Out, -Box.Rotation[Axis] * Side, Sphere.Position, Sphere.Radius + MinDepth);
+}
+
+// Sutherland-Hodgman against dot(Normal, P) <= Offset.
+uint32_t ClipPolygon(const Vec3* In, uint32_t InCount, const Vec3& Normal, float Offset, Vec3* Out) {
+    uint32_t OutCount = 0;
+    for (uint32_t i = 0; i < InCount; ++i) {
+        const Vec3& P = In[i];
+        const Vec3& Q = In[(i + 1) % InCount];
+        const float DP = dot(Normal, P) - Offset;
+        const float DQ = dot(Normal, Q) - Offset;
+        if (DP <= 0.0f) { Out[OutCount++] = P; }
+        if ((DP < 0.0f && DQ > 0.0f) || (DP > 0.0f && DQ < 0.0f)) { Out[OutCount++] = P + (Q - P) * (DP / (DP - DQ)); }
+    }
+    return OutCount;
+}
+
+// Keeps the deepest point and the three that span the largest area around it.
+uint32_t ReducePoints(ContactPoint* Points, uint32_t Count, const Vec3& Normal) {
+    if (Count <= MaxManifoldPoints) { return Count; }
+
+    uint32_t Chosen[MaxManifoldPoints] = {0, 0, 0, 0};
+    for (uint32_t i = 1; i < Count; ++i) {
+        if (Points[i].Penetration > Points[Chosen[0]].Penetration) { Chosen[0] = i; }
+    }
+
+    const Vec3 P0 = Points[Chosen[0]].Position;
+    float Best = -1.0f;
+    for (uint32_t i = 0; i < Count; ++i) {
+        const Vec3 D = Points[i].Position - P0;
+        if (dot(D, D) > Best) {
+            Best = dot(D, D);
+            Chosen[1] = i;
+        }
+    }
+
+    const Vec3 P1 = Points[Chosen[1]].Position;
+    float BestArea = 0.0f;
+    Chosen[2] = Chosen[0];
+    for (uint32_t i = 0; i < Count; ++i) {
+        const float Area = dot(cross(P1 - P0, Points[i].Position - P0), Normal);
+        if (std::fabs(Area) > std::fabs(BestArea)) {
+            BestArea = Area;
+            Chosen[2] = i;
+        }
+    }
+
+    // The fourth point goes on the other side of the P0-P1 edge
+    float BestOpposite = 0.0f;
+    Chosen[3] = Chosen[0];
+    for (uint32_t i = 0; i < Count; ++i) {
+        const float Area = dot(cross(P1 - P0, Points[i].Position - P0), Normal);
+        if (Area * BestArea < BestOpposite) {
+            BestOpposite = Area * BestArea;
+            Chosen[3] = i;
+        }
+    }
+
+    ContactPoint Reduced[MaxManifoldPoints];
+    uint32_t ReducedCount = 0;
+    for (uint32_t i = 0; i < MaxManifoldPoints; ++i) {
+        bool Duplicate = false;
+        for (uint32_t j = 0; j < i; ++j) {
+            Duplicate |= Chosen[j] == Chosen[i];
+        }
+        if (!Duplicate) { Reduced[ReducedCount++] = Points[Chosen[i]]; }
+    }
+    for (uint32_t i = 0; i < ReducedCount; ++i) {
+        Points[i] = Reduced[i];
+    }
+    return ReducedCount;
+}
+
+// Clips the incident box's face most opposed to RefNormal against the reference face.
+// RefNormal is the reference face's outward normal and points towards the incident box.
+uint32_t ClipFaces(const BoxFrame& Ref, int RefAxis, const Vec3& RefNormal, const BoxFrame& Inc,
+                   ContactPoint* OutPoints) {
+    int IncAxis = 0;
+    float BestAlignment = -1.0f;
+    for (int k = 0; k < 3; ++k) {
+        const float Alignment = std::fabs(dot(Inc.Axis[k], RefNormal));
+        if (Alignment > BestAlignment) {
+            BestAlignment = Alignment;
+            IncAxis = k;
+        }
+    }
+
+    const float IncSide = dot(Inc.Axis[IncAxis], RefNormal) > 0.0f ? -1.0f : 1.0f;
+    const Vec3 IncCenter = Inc.Center + Inc.Axis[IncAxis] * (IncSide * Inc.Half[IncAxis]);
+    const Vec3 IncU = Inc.Axis[(IncAxis + 1) % 3] * Inc.Half[(IncAxis + 1) % 3];
+    const Vec3 IncV = Inc.Axis[(IncAxis + 2) % 3] * Inc.Half[(IncAxis + 2) % 3];
+
+    Vec3 Polygon[8] = {IncCenter + IncU + IncV, IncCenter - IncU + IncV, IncCenter - IncU - IncV,
+                       IncCenter + IncU - IncV};
+    Vec3 Scratch[8];
+    uint32_t Count = 4;
+
+    for (int Side = 1; Side <= 2 && Count > 0; ++Side) {
+        const int Axis = (RefAxis + Side) % 3;
+        const Vec3& N = Ref.Axis[Axis];
+        const float CenterOffset = dot(N, Ref.Center);
+        Count = ClipPolygon(Polygon, Count, N, CenterOffset + Ref.Half[Axis], Scratch);
+        Count = ClipPolygon(Scratch, Count, -N, -CenterOffset + Ref.Half[Axis], Polygon);
+    }
+
+    const float FaceOffset = dot(RefNormal, Ref.Center) + Ref.Half[RefAxis];
+    ContactPoint Candidates[8];
+    uint32_t CandidateCount = 0;
+    for (uint32_t i = 0; i < Count; ++i) {
+        const float Depth = FaceOffset - dot(RefNormal, Polygon[i]);
+        if (Depth < -ContactMargin) { continue; }
+        ContactPoint& Point = Candidates[CandidateCount++];
+        Point.Position = Polygon[i] + RefNormal * (Depth * 0.5f);
+        Point.Penetration = Depth;
+    }
+
+    const uint32_t PointCount = ReducePoints(Candidates, CandidateCount, RefNormal);
+    for (uint32_t i = 0; i < PointCount; ++i) {
+        OutPoints[i] = Candidates[i];
+    }
+    return PointCount;
+}
+
+// Closest points between two segments given as center, unit direction and half length.
+void ClosestPointsOnEdges(const Vec3& CenterA, const Vec3& DirA, float HalfA, const Vec3& CenterB, const Vec3& DirB,
+                          float HalfB, Vec3& OutA, Vec3& OutB) {
+    const Vec3 R = CenterA - CenterB;
+    const float D = dot(DirA, DirB);
+    const float E = dot(DirA, R);
+    const float F = dot(DirB, R);
+    const float Denominator = 1.0f - D * D;
+
+    float S = Denominator > Epsilon ? (D * F - E) / Denominator : 0.0f;
+    S = std::clamp(S, -HalfA, HalfA);
+    float T = std::clamp(D * S + F, -HalfB, HalfB);
+    S = std::clamp(D * T - E, -HalfA, HalfA);
+
+    OutA = CenterA + DirA * S;
+    OutB = CenterB + DirB * T;
+}
+
+} // namespace
+
+void CollideSpheres(const RigidBody* Bodies, const BodyPair* Pairs, std::span<const uint32_t> Indices,
+                    ContactManifold* OutManifolds) {
+    const auto Count = static_cast<uint32_t>(Indices.size());
+    for (uint32_t Base = 0; Base < Count; Base += 4) {
+        alignas(16) float Lanes[8][4];
+        for (uint32_t Lane = 0; Lane < 4; ++Lane) {
+            const BodyPair& Pair = Pairs[Indices[std::min(Base + Lane, Count - 1)]];
+            const RigidBody& A = Bodies[Pair.A];
+            const RigidBody& B = Bodies[Pair.B];
+            Lanes[0][Lane] = A.Position.x;
+            Lanes[1][Lane] = A.Position.y;
+            Lanes[2][Lane] = A.Position.z;
+            Lanes[3][Lane] = A.Radius;
+            Lanes[4][Lane] = B.Position.x;
+            Lanes[5][Lane] = B.Position.y;
+            Lanes[6][Lane] = B.Position.z;
+            Lanes[7][Lane] = B.Radius;
+        }
+
+        const Vec3x4 CenterA = {Float4::Load(Lanes[0]), Float4::Load(Lanes[1]), Float4::Load(Lanes[2])};
+        const Vec3x4 CenterB = {Float4::Load(Lanes[4]), Float4::Load(Lanes[5]), Float4::Load(Lanes[6])};
+        const Float4 RadiusA = Float4::Load(Lanes[3]);
+        const Float4 RadiusSum = RadiusA + Float4::Load(Lanes[7]);
+
+        const Vec3x4 Delta = CenterB - CenterA;
+        const Float4 DistanceSquared = Dot(Delta, Delta);
+        const Float4 Reach = RadiusSum + Float4::Splat(ContactMargin);
+        const int HitMask = MoveMask(DistanceSquared < Reach * Reach);
+        if (HitMask == 0) {
+            for (uint32_t Lane = 0; Lane < 4 && Base + Lane < Count; ++Lane) {
+                OutManifolds[Indices[Base + Lane]].PointCount = 0;
+            }
+            continue;
+        }
+
+        // Coincident centers fall back to an arbitrary up normal
+        const Float4 Distance = Sqrt(DistanceSquared);
+        const Float4 Separated = Distance > Float4::Splat(Epsilon);
+        const Float4 InvDistance = Select(Separated, Float4::Splat(1.0f) / Max(Distance, Float4::Splat(Epsilon)), Float4::Zero());
+        const Vec3x4 Normal = {Delta.X * InvDistance, Select(Separated, Delta.Y * InvDistance, Float4::Splat(1.0f)),
+                               Delta.Z * InvDistance};
+        const Float4 Penetration = RadiusSum - Distance;
+        const Vec3x4 Position = CenterA + Normal * (RadiusA - Penetration * Float4::Splat(0.5f));
+
+        alignas(16) float Out[7][4];
+        Normal.X.Store(Out[0]);
+        Normal.Y.Store(Out[1]);
+        Normal.Z.Store(Out[2]);
+        Position.X.Store(Out[3]);
+        Position.Y.Store(Out[4]);
+        Position.Z.Store(Out[5]);
+        Penetration.Store(Out[6]);
+
+        for (uint32_t Lane = 0; Lane < 4 && Base + Lane < Count; ++Lane) {
+            ContactManifold& Manifold = OutManifolds[Indices[Base + Lane]];
+            if ((HitMask & (1 << Lane)) == 0) {
+                Manifold.PointCount = 0;
+                continue;
+            }
+            SetSinglePoint(Manifold, Vec3(Out[0][Lane], Out[1][Lane], Out[2][Lane]),
+                           Vec3(Out[3][Lane], Out[4][Lane], Out[5][Lane]), Out[6][Lane]);
+        }
+    }
+}
+
+void CollideSphereBoxes(const RigidBody* Bodies, const BodyPair* Pairs, std::span<const uint32_t> Indices,
+                        ContactManifold* OutManifolds) {
+    const auto Count = static_cast<uint32_t>(Indices.size());
+    for (uint32_t Base = 0; Base < Count; Base += 4) {
+        // Sphere center (3), radius, box center (3), box axes (9), half extents (3)
+        alignas(16) float Lanes[19][4];
+        for (uint32_t Lane = 0; Lane < 4; ++Lane) {
+            const BodyPair& Pair = Pairs[Indices[std::min(Base + Lane, Count - 1)]];
+            const RigidBody& Sphere = Bodies[Pair.A];
+            const RigidBody& Box = Bodies[Pair.B];
+            for (int k = 0; k < 3; ++k) {
+                Lanes[k][Lane] = Sphere.Position[k];
+                Lanes[4 + k][Lane] = Box.Position[k];
+                Lanes[7 + k][Lane] = Box.Rotation[0][k];
+                Lanes[10 + k][Lane] = Box.Rotation[1][k];
+                Lanes[13 + k][Lane] = Box.Rotation[2][k];
+                Lanes[16 + k][Lane] = Box.HalfExtents[k];
+            }
+            Lanes[3][Lane] = Sphere.Radius;
+        }
+
+        auto LoadVec = [&](int Row) {
+            return Vec3x4{Float4::Load(Lanes[Row]), Float4::Load(Lanes[Row + 1]), Float4::Load(Lanes[Row + 2])};
+        };
+        const Vec3x4 Center = LoadVec(0);
+        const Float4 Radius = Float4::Load(Lanes[3]);
+        const Vec3x4 BoxCenter = LoadVec(4);
+        const Vec3x4 Axis0 = LoadVec(7);
+        const Vec3x4 Axis1 = LoadVec(10);
+        const Vec3x4 Axis2 = LoadVec(13);
+        const Vec3x4 Half = LoadVec(16);
+
+        const Vec3x4 D = Center - BoxCenter;
+        const Float4 LocalX = Clamp(Dot(D, Axis0), -Half.X, Half.X);
+        const Float4 LocalY = Clamp(Dot(D, Axis1), -Half.Y, Half.Y);
+        const Float4 LocalZ = Clamp(Dot(D, Axis2), -Half.Z, Half.Z);
+        const Vec3x4 Closest = BoxCenter + Axis0 * LocalX + Axis1 * LocalY + Axis2 * LocalZ;
+
+        const Vec3x4 Delta = Closest - Center;
+        const Float4 DistanceSquared = Dot(Delta, Delta);
+        const Float4 Reach = Radius + Float4::Splat(ContactMargin);
+        const int HitMask = MoveMask(DistanceSquared <= Reach * Reach);
+        const int InsideMask = MoveMask(DistanceSquared <= Float4::Splat(Epsilon * Epsilon));
+
+        const Float4 Distance = Sqrt(DistanceSquared);
+        const Float4 InvDistance = Float4::Splat(1.0f) / Max(Distance, Float4::Splat(Epsilon));
+        const Vec3x4 Normal = Delta * InvDistance;
+        const Float4 Penetration = Radius - Distance;
+
+        alignas(16) float Out[7][4];
+        Normal.X.Store(Out[0]);
+        Normal.Y.Store(Out[1]);
+        Normal.Z.Store(Out[2]);
+        Closest.X.Store(Out[3]);
+        Closest.Y.Store(Out[4]);
+        Closest.Z.Store(Out[5]);
+        Penetration.Store(Out[6]);
+
+        for (uint32_t Lane = 0; Lane < 4 && Base + Lane < Count; ++Lane) {
+            const uint32_t Index = Indices[Base + Lane];
+            ContactManifold& Manifold = OutManifolds[Index];
+            if ((HitMask & (1 << Lane)) == 0) {
+                Manifold.PointCount = 0;
+            } else if (InsideMask & (1 << Lane)) {
+                SphereInsideBox(Bodies[Pairs[Index].A], Bodies[Pairs[Index].B], Manifold);
+            } else {
+                SetSinglePoint(Manifold, Vec3(Out[0][Lane], Out[1][Lane], Out[2][Lane]),
+                               Vec3(Out[3][Lane], Out[4][Lane], Out[5][Lane]), Out[6][Lane]);
+            }
+        }
+    }
+}
+
+void CollideBoxes(const RigidBody& BodyA, const RigidBody& BodyB, ContactManifold& OutManifold) {
+    OutManifold.PointCount = 0;
+
+    const BoxFrame A = MakeFrame(BodyA);
+    const BoxFrame B = MakeFrame(BodyB);
+    const Vec3 T = B.Center - A.Center;
+
+    // The epsilon keeps near-parallel edge axes from producing a false separation
+    float AbsC[3][3];
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            AbsC[i][j] = std::fabs(dot(A.Axis[i], B.Axis[j])) + 1.0e-5f;
+        }
+    }
+
+    float FaceSeparationA = -std::numeric_limits<float>::max();
+    int FaceA = 0;
+    for (int i = 0; i < 3; ++i) {
+        const float Separation = std::fabs(dot(T, A.Axis[i])) -
+                                 (A.Half[i] + B.Half.x * AbsC[i][0] + B.Half.y * AbsC[i][1] + B.Half.z * AbsC[i][2]);
+        if (Separation > ContactMargin) { return; }
+        if (Separation > FaceSeparationA) {
+            FaceSeparationA = Separation;
+            FaceA = i;
+        }
+    }
+
+    float FaceSeparationB = -std::numeric_limits<float>::max();
+    int FaceB = 0;
+    for (int j = 0; j < 3; ++j) {
+        const float Separation = std::fabs(dot(T, B.Axis[j])) -
+                                 (A.Half.x * AbsC[0][j] + A.Half.y * AbsC[1][j] + A.Half.z * AbsC[2][j] + B.Half[j]);
+        if (Separation > ContactMargin) { return; }
+        if (Separation > FaceSeparationB) {
+            FaceSeparationB = Separation;
+            FaceB = j;
+        }
+    }
+
+    float EdgeSeparation = -std::numeric_limits<float>::max();
+    int EdgeA = 0;
+    int EdgeB = 0;
+    Vec3 EdgeAxis(0.0f);
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            Vec3 L = cross(A.Axis[i], B.Axis[j]);
+            const float Length = length(L);
+            if (Length < 1.0e-4f) { continue; }
+            L /= Length;
+
+            float RadiusA = 0.0f;
+            float RadiusB = 0.0f;
+            for (int k = 0; k < 3; ++k) {
+                RadiusA += A.Half[k] * std::fabs(dot(A.Axis[k], L));
+                RadiusB += B.Half[k] * std::fabs(dot(B.Axis[k], L));
+            }
+            const float Separation = std::fabs(dot(T, L)) - (RadiusA + RadiusB);
+            if (Separation > ContactMargin) { return; }
+            if (Separation > EdgeSeparation) {
+                EdgeSeparation = Separation;
+                EdgeA = i;
+                EdgeB = j;
+                EdgeAxis = L;
+            }
+        }
+    }
+
+    // Prefer face contacts (and A over B) unless the alternative is clearly shallower; this
+    // keeps the chosen feature stable from step to step, which warm starting relies on
+    constexpr float RelativeTolerance = 0.95f;
+    constexpr float AbsoluteTolerance = 0.01f;
+    const bool UseFaceB = FaceSeparationB > RelativeTolerance * FaceSeparationA + AbsoluteTolerance;
+    const float FaceSeparation = UseFaceB ? FaceSeparationB : FaceSeparationA;
+
+    if (EdgeSeparation > RelativeTolerance * FaceSeparation + AbsoluteTolerance) {
+        const Vec3 Normal = dot(EdgeAxis, T) < 0.0f ? -EdgeAxis : EdgeAxis;
+
+        // Support edges: the edge of A furthest along Normal and of B furthest against it
+        Vec3 EdgeCenterA = A.Center;
+        Vec3 EdgeCenterB = B.Center;
+        for (int k = 0; k < 3; ++k) {
+            if (k != EdgeA) { EdgeCenterA += A.Axis[k] * (dot(A.Axis[k], Normal) > 0.0f ? A.Half[k] : -A.Half[k]); }
+            if (k != EdgeB) { EdgeCenterB += B.Axis[k] * (dot(B.Axis[k], Normal) < 0.0f ? B.Half[k] : -B.Half[k]); }
+        }
+
+        Vec3 PointA;
+        Vec3 PointB;
+        ClosestPointsOnEdges(EdgeCenterA, A.Axis[EdgeA], A.Half[EdgeA], EdgeCenterB, B.Axis[EdgeB], B.Half[EdgeB],
+                             PointA, PointB);
+        SetSinglePoint(OutManifold, Normal, (PointA + PointB) * 0.5f, -EdgeSeparation);
+        return;
+    }
+
+    if (UseFaceB) {
+        const Vec3 RefNormal = dot(T, B.Axis[FaceB]) > 0.0f ? -B.Axis[FaceB] : B.Axis[FaceB];
+        OutManifold.Normal = -RefNormal;
+        OutManifold.PointCount = ClipFaces(B, FaceB, RefNormal, A, OutManifold.Points);
+    } else {
+        const Vec3 RefNormal = dot(T, A.Axis[FaceA]) < 0.0f ? -A.Axis[FaceA] : A.Axis[FaceA];
+        OutManifold.Normal = RefNormal;
+        OutManifold.PointCount = ClipFaces(A, FaceA, RefNormal, B, OutManifold.Points);
+    }
+}
+
+} // namespace Volante::Collision
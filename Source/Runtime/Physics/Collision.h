@@ -0,0 +1,32 @@
+#pragma once
+
+#include <span>
+
+#include "PhysicsTypes.h"
+
+namespace Volante {
+
+// Narrow phase. Each function reads the pairs selected by Indices and writes the manifold at the
+// same index in OutManifolds; a manifold with PointCount == 0 means the pair is not touching.
+// Sphere kernels process four pairs per Float4 lane set; box-box is scalar because the clipping
+// is branchy and per-pair.
+namespace Collision {
+
+// Features closer than this are reported as speculative contacts with negative penetration, so
+// the solver sees a resting contact before it touches instead of one that flickers on and off.
+constexpr float ContactMargin = 0.02f;
+
+void CollideSpheres(const RigidBody* Bodies, const BodyPair* Pairs, std::span<const uint32_t> Indices,
+                    ContactManifold* OutManifolds);
+
+// Pair.A is the sphere and Pair.B the box.
+void CollideSphereBoxes(const RigidBody* Bodies, const BodyPair* Pairs, std::span<const uint32_t> Indices,
+                        ContactManifold* OutManifolds);
+
+// Separating axis test over the 15 candidate axes, then clipping of the incident face against
+// the reference face for up to four contact points (or a single point for edge-edge).
+void CollideBoxes(const RigidBody& A, const RigidBody& B, ContactManifold& OutManifold);
+
+} // namespace Collision
+
+} // namespace Volante
@@ -0,0 +1,195 @@
+#include "ContactSolver.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace Volante {
+
+namespace {
+
+struct ContactConstraint {
+    RigidBody* A;
+    RigidBody* B;
+    ContactPoint* Point;
+    Vec3 Normal;
+    Vec3 Tangents[2];
+    Vec3 RA;
+    Vec3 RB;
+    float NormalMass;
+    float TangentMass[2];
+    float Bias;
+    float PushBias;
+    float PushImpulse;
+    float Friction;
+};
+
+void BuildTangents(const Vec3& Normal, Vec3& OutT0, Vec3& OutT1) {
+    if (std::fabs(Normal.x) >= 0.57735f) {
+        OutT0 = normalize(Vec3(Normal.y, -Normal.x, 0.0f));
+    } else {
+        OutT0 = normalize(Vec3(0.0f, Normal.z, -Normal.y));
+    }
+    OutT1 = cross(Normal, OutT0);
+}
+
+float EffectiveMass(const RigidBody& A, const RigidBody& B, const Vec3& RA, const Vec3& RB, const Vec3& Axis) {
+    const Vec3 RAxA = cross(RA, Axis);
+    const Vec3 RBxA = cross(RB, Axis);
+    const float K = A.InvMass + B.InvMass + dot(RAxA, A.InvInertiaWorld * RAxA) + dot(RBxA, B.InvInertiaWorld * RBxA);
+    return K > 0.0f ? 1.0f / K : 0.0f;
+}
+
+Vec3 RelativeVelocity(const ContactConstraint& C) {
+    return C.B->LinearVelocity + cross(C.B->AngularVelocity, C.RB) - C.A->LinearVelocity -
+           cross(C.A->AngularVelocity, C.RA);
+}
+
+// Static bodies are shared between islands solved on different threads, so they are never
+// written; their velocities are zero anyway
+void ApplyImpulse(ContactConstraint& C, const Vec3& Impulse) {
+    if (C.A->InvMass > 0.0f) {
+        C.A->LinearVelocity -= Impulse * C.A->InvMass;
+        C.A->AngularVelocity -= C.A->InvInertiaWorld * cross(C.RA, Impulse);
+    }
+    if (C.B->InvMass > 0.0f) {
+        C.B->LinearVelocity += Impulse * C.B->InvMass;
+        C.B->AngularVelocity += C.B->InvInertiaWorld * cross(C.RB, Impulse);
+    }
+}
+
+Vec3 RelativePushVelocity(const ContactConstraint& C) {
+    return C.B->PushVelocity + cross(C.B->PushAngularVelocity, C.RB) - C.A->PushVelocity -
+           cross(C.A->PushAngularVelocity, C.RA);
+}
+
+void ApplyPushImpulse(ContactConstraint& C, const Vec3& Impulse) {
+    if (C.A->InvMass > 0.0f) {
+        C.A->PushVelocity -= Impulse * C.A->InvMass;
+        C.A->PushAngularVelocity -= C.A->InvInertiaWorld * cross(C.RA, Impulse);
+    }
+    if (C.B->InvMass > 0.0f) {
+        C.B->PushVelocity += Impulse * C.B->InvMass;
+        C.B->PushAngularVelocity += C.B->InvInertiaWorld * cross(C.RB, Impulse);
+    }
+}
+
+} // namespace
+
+void SolveIsland(RigidBody* Bodies, std::span<const BodyId> IslandBodies, ContactManifold* Manifolds,
+                 std::span<const uint32_t> IslandManifolds, float Dt, const SolverSettings& Settings) {
+    const float LinearDamping = 1.0f / (1.0f + Dt * Settings.LinearDamping);
+    const float AngularDamping = 1.0f / (1.0f + Dt * Settings.AngularDamping);
+    for (const BodyId Id : IslandBodies) {
+        RigidBody& Body = Bodies[Id];
+        Body.PreviousPosition = Body.Position;
+        Body.PreviousOrientation = Body.Orientation;
+        Body.LinearVelocity = (Body.LinearVelocity + Settings.Gravity * Dt) * LinearDamping;
+        Body.AngularVelocity *= AngularDamping;
+    }
+
+    // Reused across islands run on the same worker
+    thread_local std::vector<ContactConstraint> Constraints;
+    Constraints.clear();
+
+    const float InvDt = 1.0f / Dt;
+    for (const uint32_t ManifoldIndex : IslandManifolds) {
+        ContactManifold& Manifold = Manifolds[ManifoldIndex];
+        RigidBody& A = Bodies[Manifold.BodyA];
+        RigidBody& B = Bodies[Manifold.BodyB];
+        const float Friction = std::sqrt(A.Friction * B.Friction);
+        const float Restitution = std::max(A.Restitution, B.Restitution);
+
+        for (uint32_t i = 0; i < Manifold.PointCount; ++i) {
+            ContactConstraint& C = Constraints.emplace_back();
+            C.A = &A;
+            C.B = &B;
+            C.Point = &Manifold.Points[i];
+            C.Normal = Manifold.Normal;
+            BuildTangents(C.Normal, C.Tangents[0], C.Tangents[1]);
+            C.RA = C.Point->Position - A.Position;
+            C.RB = C.Point->Position - B.Position;
+            C.NormalMass = EffectiveMass(A, B, C.RA, C.RB, C.Normal);
+            C.TangentMass[0] = EffectiveMass(A, B, C.RA, C.RB, C.Tangents[0]);
+            C.TangentMass[1] = EffectiveMass(A, B, C.RA, C.RB, C.Tangents[1]);
+            C.Friction = Friction;
+
+            // A speculative contact (negative penetration) lets the bodies close the gap this
+            // step but no further; real penetration is left to the split-impulse pass
+            const float Penetration = C.Point->Penetration;
+            C.Bias = std::min(Penetration, 0.0f) * InvDt;
+            C.PushBias = std::min(Settings.Baumgarte * InvDt * std::max(Penetration - Settings.PenetrationSlop, 0.0f),
+                                  Settings.MaxCorrectionVelocity);
+            C.PushImpulse = 0.0f;
+            const float ApproachSpeed = dot(RelativeVelocity(C), C.Normal);
+            if (ApproachSpeed < -Settings.RestitutionThreshold) {
+                C.Bias = std::max(C.Bias, -Restitution * ApproachSpeed);
+            }
+
+            ApplyImpulse(C, C.Normal * C.Point->NormalImpulse + C.Tangents[0] * C.Point->TangentImpulse[0] +
+                                C.Tangents[1] * C.Point->TangentImpulse[1]);
+        }
+    }
+
+    for (uint32_t Iteration = 0; Iteration < Settings.VelocityIterations; ++Iteration) {
+        for (ContactConstraint& C : Constraints) {
+            ContactPoint& Point = *C.Point;
+
+            // Friction first, bounded by the normal impulse from the previous iteration
+            const float MaxFriction = C.Friction * Point.NormalImpulse;
+            for (int k = 0; k < 2; ++k) {
+                const float Lambda = -dot(RelativeVelocity(C), C.Tangents[k]) * C.TangentMass[k];
+                const float Previous = Point.TangentImpulse[k];
+                Point.TangentImpulse[k] = std::clamp(Previous + Lambda, -MaxFriction, MaxFriction);
+                ApplyImpulse(C, C.Tangents[k] * (Point.TangentImpulse[k] - Previous));
+            }
+
+            const float Lambda = (C.Bias - dot(RelativeVelocity(C), C.Normal)) * C.NormalMass;
+            const float Previous = Point.NormalImpulse;
+            Point.NormalImpulse = std::max(Previous + Lambda, 0.0f);
+            ApplyImpulse(C, C.Normal * (Point.NormalImpulse - Previous));
+        }
+    }
+
+    for (uint32_t Iteration = 0; Iteration < Settings.PositionIterations; ++Iteration) {
+        for (ContactConstraint& C : Constraints) {
+            if (C.PushBias <= 0.0f) { continue; }
+            const float Lambda = (C.PushBias - dot(RelativePushVelocity(C), C.Normal)) * C.NormalMass;
+            const float Previous = C.PushImpulse;
+            C.PushImpulse = std::max(Previous + Lambda, 0.0f);
+            ApplyPushImpulse(C, C.Normal * (C.PushImpulse - Previous));
+        }
+    }
+
+    const float LinearSleep = Settings.SleepLinearVelocity * Settings.SleepLinearVelocity;
+    const float AngularSleep = Settings.SleepAngularVelocity * Settings.SleepAngularVelocity;
+    float MinSleepTime = std::numeric_limits<float>::max();
+    for (const BodyId Id : IslandBodies) {
+        RigidBody& Body = Bodies[Id];
+        const Vec3 Angular = Body.AngularVelocity + Body.PushAngularVelocity;
+        Body.Position += (Body.LinearVelocity + Body.PushVelocity) * Dt;
+        Body.Orientation = glm::normalize(Body.Orientation + Quat(0.0f, Angular.x, Angular.y, Angular.z) * Body.Orientation * (0.5f * Dt));
+        Body.PushVelocity = Vec3(0.0f);
+        Body.PushAngularVelocity = Vec3(0.0f);
+        Body.UpdateDerived();
+
+        const bool Slow = dot(Body.LinearVelocity, Body.LinearVelocity) < LinearSleep &&
+                          dot(Body.AngularVelocity, Body.AngularVelocity) < AngularSleep;
+        Body.SleepTime = Slow ? Body.SleepTime + Dt : 0.0f;
+        MinSleepTime = std::min(MinSleepTime, Body.SleepTime);
+    }
+
+    if (!Settings.AllowSleep || MinSleepTime < Settings.TimeToSleep) { return; }
+
+    for (const BodyId Id : IslandBodies) {
+        RigidBody& Body = Bodies[Id];
+        Body.Awake = false;
+        Body.PreviousPosition = Body.Position;
+        Body.PreviousOrientation = Body.Orientation;
+        Body.LinearVelocity = Vec3(0.0f);
+        Body.AngularVelocity = Vec3(0.0f);
+    }
+}
+
+} // namespace Volante
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <span>
+
+#include "PhysicsTypes.h"
+
+namespace Volante {
+
+struct SolverSettings {
+    Vec3 Gravity = Vec3(0.0f, -GRAVITY, 0.0f);
+    uint32_t VelocityIterations = 10;
+    uint32_t PositionIterations = 4;
+
+    // Split-impulse position correction: fraction of the penetration beyond the slop removed per
+    // step. It only moves positions, so stacks do not gain energy from it
+    float Baumgarte = 0.2f;
+    float PenetrationSlop = 0.005f;
+    float MaxCorrectionVelocity = 3.0f;
+
+    // Approach speeds below this do not bounce, so resting contacts stay resting
+    float RestitutionThreshold = 1.0f;
+
+    float LinearDamping = 0.01f;
+    float AngularDamping = 0.05f;
+
+    bool AllowSleep = true;
+    float SleepLinearVelocity = 0.05f;
+    float SleepAngularVelocity = 0.05f;
+    float TimeToSleep = 0.5f;
+};
+
+// One connected group of awake dynamic bodies and the manifolds between them (or with static
+// bodies). Islands share no dynamic body, so they can be solved concurrently.
+struct Island {
+    uint32_t FirstBody = 0;
+    uint32_t BodyCount = 0;
+    uint32_t FirstManifold = 0;
+    uint32_t ManifoldCount = 0;
+};
+
+// Advances one island by Dt: applies gravity, solves contacts with sequential impulses (warm
+// started from the impulses already stored in the manifolds), resolves penetration with split
+// impulses, integrates positions and puts the island to sleep once every body in it has been
+// slow for TimeToSleep. Only bodies with a non-zero inverse mass are written.
+void SolveIsland(RigidBody* Bodies, std::span<const BodyId> IslandBodies, ContactManifold* Manifolds,
+                 std::span<const uint32_t> IslandManifolds, float Dt, const SolverSettings& Settings);
+
+} // namespace Volante
@@ -0,0 +1,56 @@
+#include "PhysicsScenes.h"
+
+#include "PhysicsSystem.h"
+
+namespace Volante {
+
+void CreateBoxStackScene(PhysicsSystem& Physics, const BoxStackSceneDesc& Desc) {
+    const float Width = static_cast<float>(Desc.StacksX) * Desc.StackSpacing;
+    const float Depth = static_cast<float>(Desc.StacksZ) * Desc.StackSpacing;
+
+    BodyDesc Ground;
+    Ground.Shape = ShapeType::Box;
+    Ground.HalfExtents = Vec3(Width * 0.5f + 10.0f, 1.0f, Depth * 0.5f + 10.0f);
+    Ground.Position = Vec3(0.0f, -1.0f, 0.0f);
+    Ground.Mass = 0.0f;
+    Physics.CreateBody(Ground);
+
+    const float Half = Desc.BoxSize * 0.5f;
+    const Vec3 Origin(-Width * 0.5f + Desc.StackSpacing * 0.5f, Half, -Depth * 0.5f + Desc.StackSpacing * 0.5f);
+
+    BodyDesc Box;
+    Box.Shape = ShapeType::Box;
+    Box.HalfExtents = Vec3(Half);
+    Box.Mass = 1.0f;
+    for (uint32_t X = 0; X < Desc.StacksX; ++X) {
+        for (uint32_t Z = 0; Z < Desc.StacksZ; ++Z) {
+            for (uint32_t Level = 0; Level < Desc.StackHeight; ++Level) {
+                // Alternate a small yaw so the stack is not perfectly aligned
+                const float Yaw = (Level & 1) ? 0.05f : -0.05f;
+                Box.Position = Origin + Vec3(static_cast<float>(X) * Desc.StackSpacing, static_cast<float>(Level) * Desc.BoxSize,
+                                             static_cast<float>(Z) * Desc.StackSpacing);
+                Box.Orientation = glm::angleAxis(Yaw, Vec3(0.0f, 1.0f, 0.0f));
+                Physics.CreateBody(Box);
+            }
+        }
+    }
+
+    // Linear congruential sequence: identical on every platform, unlike <random> distributions
+    uint32_t State = 12345u;
+    auto Next = [&State] {
+        State = State * 1664525u + 1013904223u;
+        return static_cast<float>(State >> 8) / static_cast<float>(1u << 24);
+    };
+
+    BodyDesc Sphere;
+    Sphere.Shape = ShapeType::Sphere;
+    Sphere.Radius = Half;
+    Sphere.Mass = 0.5f;
+    for (uint32_t i = 0; i < Desc.SphereCount; ++i) {
+        Sphere.Position = Vec3((Next() - 0.5f) * Width, static_cast<float>(Desc.StackHeight) * Desc.BoxSize + 2.0f + Next() * 10.0f,
+                               (Next() - 0.5f) * Depth);
+        Physics.CreateBody(Sphere);
+    }
+}
+
+} // namespace Volante
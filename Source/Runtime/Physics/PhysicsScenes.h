@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Volante {
+
+class PhysicsSystem;
+
+struct BoxStackSceneDesc {
+    // 20 x 20 stacks of 6 is 2400 boxes; at the default 10 velocity iterations stacks up to
+    // about 8 high settle and sleep, taller ones need more iterations
+    uint32_t StacksX = 20;
+    uint32_t StacksZ = 20;
+    uint32_t StackHeight = 6;
+    float BoxSize = 1.0f;
+    float StackSpacing = 3.0f;
+
+    // Spheres dropped over the stacks from a fixed pseudo-random sequence
+    uint32_t SphereCount = 0;
+};
+
+// Headless, fully deterministic scene: a static ground slab and a grid of box stacks. Used by
+// the physics benchmark and for checking that two runs produce the same state hash.
+void CreateBoxStackScene(PhysicsSystem& Physics, const BoxStackSceneDesc& Desc = {});
+
+} // namespace Volante
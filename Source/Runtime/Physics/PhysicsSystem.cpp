@@ -0,0 +1,366 @@
+#include "PhysicsSystem.h"
+
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+
+#include "Collision.h"
+#include "Runtime/Core/Async/JobSystem.h"
+#include "Runtime/Core/Misc/Utility.h"
+#include "Runtime/Core/Stats/StatCounters.h"
+
+namespace Volante {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+float MillisecondsSince(Clock::time_point Start) {
+    return std::chrono::duration<float, std::milli>(Clock::now() - Start).count();
+}
+
+uint32_t FindRoot(std::vector<uint32_t>& Parents, uint32_t Id) {
+    while (Parents[Id] != Id) {
+        Parents[Id] = Parents[Parents[Id]];
+        Id = Parents[Id];
+    }
+    return Id;
+}
+
+// Contacts closer than this to one from the previous step inherit its impulses
+constexpr float WarmStartDistanceSquared = 0.05f * 0.05f;
+
+constexpr uint32_t NoIsland = ~0u;
+
+} // namespace
+
+PhysicsSystem::PhysicsSystem(const PhysicsDesc& Desc, JobSystem* Jobs) : Desc(Desc), Jobs(Jobs) {}
+
+PhysicsSystem::~PhysicsSystem() = default;
+
+void PhysicsSystem::Initialize() {
+    // Nothing to set up; bodies are created by gameplay code
+}
+
+void PhysicsSystem::Shutdown() {
+    Clear();
+}
+
+void PhysicsSystem::Update(float DeltaTime) {
+    StatScope Scope(StatTimer::Physics);
+    Accumulator += DeltaTime;
+
+    uint32_t Steps = 0;
+    while (Accumulator >= Desc.FixedTimeStep && Steps < Desc.MaxSubSteps) {
+        Step(Desc.FixedTimeStep);
+        Accumulator -= Desc.FixedTimeStep;
+        ++Steps;
+    }
+
+    // Fell behind: drop the backlog rather than paying for it next frame
+    if (Steps == Desc.MaxSubSteps) { Accumulator = std::min(Accumulator, Desc.FixedTimeStep); }
+    StatCounters::Set(StatCounter::PhysicsBodies, static_cast<int64_t>(Bodies.size() - FreeIds.size()));
+}
+
+void PhysicsSystem::Step(float Dt) {
+    const auto StepStart = Clock::now();
+
+    BroadPhase.FindPairs(Bodies, Jobs, Pairs);
+    Stats.BroadPhaseMs = MillisecondsSince(StepStart);
+
+    const auto NarrowStart = Clock::now();
+    NarrowPhase();
+    WarmStart();
+    Stats.NarrowPhaseMs = MillisecondsSince(NarrowStart);
+
+    const auto SolverStart = Clock::now();
+    BuildIslands();
+    ParallelFor(Jobs, static_cast<uint32_t>(Islands.size()), 8, [&](uint32_t Begin, uint32_t End) {
+        for (uint32_t i = Begin; i < End; ++i) {
+            const Island& Group = Islands[i];
+            SolveIsland(Bodies.data(), std::span(IslandBodies).subspan(Group.FirstBody, Group.BodyCount),
+                        Manifolds.data(),
+                        std::span(IslandManifolds).subspan(Group.FirstManifold, Group.ManifoldCount), Dt,
+                        Desc.Solver);
+        }
+    });
+    Stats.SolverMs = MillisecondsSince(SolverStart);
+
+    Stats.BodyCount = static_cast<uint32_t>(Bodies.size() - FreeIds.size());
+    Stats.AwakeBodyCount = static_cast<uint32_t>(std::ranges::count_if(Bodies, [](const RigidBody& Body) {
+        return Body.Alive && Body.IsActive();
+    }));
+    Stats.PairCount = static_cast<uint32_t>(Pairs.size());
+    Stats.ManifoldCount = static_cast<uint32_t>(Manifolds.size());
+    Stats.ContactCount = 0;
+    for (const ContactManifold& Manifold : Manifolds) {
+        Stats.ContactCount += Manifold.PointCount;
+    }
+    Stats.IslandCount = static_cast<uint32_t>(Islands.size());
+    ++Stats.StepCount;
+    Stats.StepMs = MillisecondsSince(StepStart);
+}
+
+void PhysicsSystem::NarrowPhase() {
+    std::swap(Manifolds, PreviousManifolds);
+    Manifolds.resize(Pairs.size());
+
+    for (std::vector<uint32_t>& Indices : PairIndices) {
+        Indices.clear();
+    }
+    for (uint32_t i = 0; i < Pairs.size(); ++i) {
+        const BodyPair& Pair = Pairs[i];
+        Manifolds[i].BodyA = Pair.A;
+        Manifolds[i].BodyB = Pair.B;
+        // Canonical order puts spheres first: sphere-sphere, sphere-box, box-box
+        const uint32_t Kind = static_cast<uint32_t>(Bodies[Pair.A].Shape) + static_cast<uint32_t>(Bodies[Pair.B].Shape);
+        PairIndices[Kind].push_back(i);
+    }
+
+    const std::span<const uint32_t> Spheres = PairIndices[0];
+    ParallelFor(Jobs, static_cast<uint32_t>(Spheres.size()), 256, [&](uint32_t Begin, uint32_t End) {
+        Collision::CollideSpheres(Bodies.data(), Pairs.data(), Spheres.subspan(Begin, End - Begin), Manifolds.data());
+    });
+
+    const std::span<const uint32_t> SphereBoxes = PairIndices[1];
+    ParallelFor(Jobs, static_cast<uint32_t>(SphereBoxes.size()), 256, [&](uint32_t Begin, uint32_t End) {
+        Collision::CollideSphereBoxes(Bodies.data(), Pairs.data(), SphereBoxes.subspan(Begin, End - Begin),
+                                      Manifolds.data());
+    });
+
+    const std::span<const uint32_t> Boxes = PairIndices[2];
+    ParallelFor(Jobs, static_cast<uint32_t>(Boxes.size()), 64, [&](uint32_t Begin, uint32_t End) {
+        for (uint32_t i = Begin; i < End; ++i) {
+            ContactManifold& Manifold = Manifolds[Boxes[i]];
+            Collision::CollideBoxes(Bodies[Manifold.BodyA], Bodies[Manifold.BodyB], Manifold);
+        }
+    });
+
+    std::erase_if(Manifolds, [](const ContactManifold& Manifold) { return Manifold.PointCount == 0; });
+}
+
+void PhysicsSystem::WarmStart() {
+    // Both lists are sorted by pair key, so matching is a merge
+    size_t Previous = 0;
+    for (ContactManifold& Manifold : Manifolds) {
+        const uint64_t Key = Manifold.GetKey();
+        while (Previous < PreviousManifolds.size() && PreviousManifolds[Previous].GetKey() < Key) {
+            ++Previous;
+        }
+        if (Previous == PreviousManifolds.size()) { break; }
+
+        const ContactManifold& Old = PreviousManifolds[Previous];
+        if (Old.GetKey() != Key || dot(Old.Normal, Manifold.Normal) < 0.9f) { continue; }
+
+        for (uint32_t i = 0; i < Manifold.PointCount; ++i) {
+            ContactPoint& Point = Manifold.Points[i];
+            float BestDistance = WarmStartDistanceSquared;
+            for (uint32_t j = 0; j < Old.PointCount; ++j) {
+                const Vec3 Delta = Old.Points[j].Position - Point.Position;
+                const float DistanceSquared = dot(Delta, Delta);
+                if (DistanceSquared < BestDistance) {
+                    BestDistance = DistanceSquared;
+                    Point.NormalImpulse = Old.Points[j].NormalImpulse;
+                    Point.TangentImpulse[0] = Old.Points[j].TangentImpulse[0];
+                    Point.TangentImpulse[1] = Old.Points[j].TangentImpulse[1];
+                }
+            }
+        }
+    }
+}
+
+void PhysicsSystem::BuildIslands() {
+    const auto BodyCount = static_cast<uint32_t>(Bodies.size());
+    Parents.resize(BodyCount);
+    std::iota(Parents.begin(), Parents.end(), 0u);
+
+    // An awake body touching a sleeping one wakes it; the wake spreads one contact per step
+    for (const ContactManifold& Manifold : Manifolds) {
+        RigidBody& A = Bodies[Manifold.BodyA];
+        RigidBody& B = Bodies[Manifold.BodyB];
+        if (A.IsStatic() || B.IsStatic()) { continue; }
+
+        A.Awake = B.Awake = true;
+        const uint32_t RootA = FindRoot(Parents, Manifold.BodyA);
+        const uint32_t RootB = FindRoot(Parents, Manifold.BodyB);
+        if (RootA != RootB) { Parents[std::max(RootA, RootB)] = std::min(RootA, RootB); }
+    }
+
+    // Islands are numbered in order of their lowest body id, which keeps the layout identical
+    // from run to run
+    Islands.clear();
+    RootIslands.assign(BodyCount, NoIsland);
+    for (BodyId Id = 0; Id < BodyCount; ++Id) {
+        const RigidBody& Body = Bodies[Id];
+        if (!Body.Alive || !Body.IsActive()) { continue; }
+
+        const uint32_t Root = FindRoot(Parents, Id);
+        if (RootIslands[Root] == NoIsland) {
+            RootIslands[Root] = static_cast<uint32_t>(Islands.size());
+            Islands.emplace_back();
+        }
+        ++Islands[RootIslands[Root]].BodyCount;
+    }
+
+    for (const ContactManifold& Manifold : Manifolds) {
+        const BodyId Dynamic = Bodies[Manifold.BodyA].IsStatic() ? Manifold.BodyB : Manifold.BodyA;
+        ++Islands[RootIslands[FindRoot(Parents, Dynamic)]].ManifoldCount;
+    }
+
+    uint32_t BodyOffset = 0;
+    uint32_t ManifoldOffset = 0;
+    for (Island& Group : Islands) {
+        Group.FirstBody = BodyOffset;
+        Group.FirstManifold = ManifoldOffset;
+        BodyOffset += Group.BodyCount;
+        ManifoldOffset += Group.ManifoldCount;
+        Group.BodyCount = 0;
+        Group.ManifoldCount = 0;
+    }
+
+    IslandBodies.resize(BodyOffset);
+    IslandManifolds.resize(ManifoldOffset);
+    for (BodyId Id = 0; Id < BodyCount; ++Id) {
+        if (!Bodies[Id].Alive || !Bodies[Id].IsActive()) { continue; }
+        Island& Group = Islands[RootIslands[FindRoot(Parents, Id)]];
+        IslandBodies[Group.FirstBody + Group.BodyCount++] = Id;
+    }
+    for (uint32_t i = 0; i < Manifolds.size(); ++i) {
+        const BodyId Dynamic = Bodies[Manifolds[i].BodyA].IsStatic() ? Manifolds[i].BodyB : Manifolds[i].BodyA;
+        Island& Group = Islands[RootIslands[FindRoot(Parents, Dynamic)]];
+        IslandManifolds[Group.FirstManifold + Group.ManifoldCount++] = i;
+    }
+}
+
+BodyId PhysicsSystem::CreateBody(const BodyDesc& Desc) {
+    BodyId Id;
+    if (!FreeIds.empty()) {
+        Id = FreeIds.back();
+        FreeIds.pop_back();
+    } else {
+        Id = static_cast<BodyId>(Bodies.size());
+        Bodies.emplace_back();
+    }
+
+    RigidBody& Body = Bodies[Id];
+    Body = {};
+    Body.Position = Body.PreviousPosition = Desc.Position;
+    Body.Orientation = Body.PreviousOrientation = glm::normalize(Desc.Orientation);
+    Body.LinearVelocity = Desc.LinearVelocity;
+    Body.AngularVelocity = Desc.AngularVelocity;
+    Body.Shape = Desc.Shape;
+    Body.HalfExtents = Desc.HalfExtents;
+    Body.Radius = Desc.Radius;
+    Body.Friction = Desc.Friction;
+    Body.Restitution = Desc.Restitution;
+    Body.UserData = Desc.UserData;
+    Body.Alive = true;
+
+    if (Desc.Mass > 0.0f) {
+        Body.InvMass = 1.0f / Desc.Mass;
+        if (Desc.Shape == ShapeType::Sphere) {
+            Body.InvInertiaLocal = Vec3(1.0f / (0.4f * Desc.Mass * Desc.Radius * Desc.Radius));
+        } else {
+            const Vec3 S = Desc.HalfExtents * Desc.HalfExtents;
+            Body.InvInertiaLocal = Vec3(3.0f) / (Desc.Mass * Vec3(S.y + S.z, S.x + S.z, S.x + S.y));
+        }
+        Body.Awake = Desc.StartAwake;
+    } else {
+        Body.Awake = false;
+        Body.LinearVelocity = Vec3(0.0f);
+        Body.AngularVelocity = Vec3(0.0f);
+    }
+    Body.UpdateDerived();
+
+    BroadPhase.Invalidate();
+    return Id;
+}
+
+void PhysicsSystem::DestroyBody(BodyId Id) {
+    RigidBody& Body = Bodies[Id];
+    if (!Body.Alive) { return; }
+
+    // Whatever was resting on the body has to notice it is gone
+    const AABB Bounds = Body.GetBounds();
+    for (RigidBody& Other : Bodies) {
+        if (Other.Alive && !Other.IsStatic() && Other.GetBounds().Intersects(Bounds)) {
+            Other.Awake = true;
+            Other.SleepTime = 0.0f;
+        }
+    }
+
+    Body.Alive = false;
+    Body.Awake = false;
+    FreeIds.push_back(Id);
+    BroadPhase.Invalidate();
+}
+
+void PhysicsSystem::Clear() {
+    Bodies.clear();
+    FreeIds.clear();
+    BroadPhase.Clear();
+    Pairs.clear();
+    Manifolds.clear();
+    PreviousManifolds.clear();
+    Islands.clear();
+    Accumulator = 0.0f;
+    Stats = {};
+}
+
+void PhysicsSystem::WakeBody(BodyId Id) {
+    RigidBody& Body = Bodies[Id];
+    if (Body.IsStatic()) { return; }
+    Body.Awake = true;
+    Body.SleepTime = 0.0f;
+}
+
+void PhysicsSystem::SetTransform(BodyId Id, const Vec3& Position, const Quat& Orientation) {
+    RigidBody& Body = Bodies[Id];
+    Body.Position = Body.PreviousPosition = Position;
+    Body.Orientation = Body.PreviousOrientation = glm::normalize(Orientation);
+    Body.UpdateDerived();
+    WakeBody(Id);
+}
+
+void PhysicsSystem::SetLinearVelocity(BodyId Id, const Vec3& Velocity) {
+    if (Bodies[Id].IsStatic()) { return; }
+    Bodies[Id].LinearVelocity = Velocity;
+    WakeBody(Id);
+}
+
+void PhysicsSystem::ApplyImpulse(BodyId Id, const Vec3& Impulse, const Vec3& WorldPoint) {
+    RigidBody& Body = Bodies[Id];
+    if (Body.IsStatic()) { return; }
+    Body.LinearVelocity += Impulse * Body.InvMass;
+    Body.AngularVelocity += Body.InvInertiaWorld * cross(WorldPoint - Body.Position, Impulse);
+    WakeBody(Id);
+}
+
+Mat4 PhysicsSystem::GetTransform(BodyId Id) const {
+    const RigidBody& Body = Bodies[Id];
+    Mat4 Result = Mat4(Body.Rotation);
+    Result[3] = Vec4(Body.Position, 1.0f);
+    return Result;
+}
+
+Mat4 PhysicsSystem::GetInterpolatedTransform(BodyId Id) const {
+    const RigidBody& Body = Bodies[Id];
+    const float Alpha = GetInterpolationAlpha();
+    Mat4 Result = glm::mat4_cast(glm::slerp(Body.PreviousOrientation, Body.Orientation, Alpha));
+    Result[3] = Vec4(glm::mix(Body.PreviousPosition, Body.Position, Alpha), 1.0f);
+    return Result;
+}
+
+uint64_t PhysicsSystem::ComputeStateHash() const {
+    // Over the raw float bits
+    ContentHasher Hasher;
+    for (const RigidBody& Body : Bodies) {
+        if (!Body.Alive) { continue; }
+        const float State[] = {Body.Position.x, Body.Position.y, Body.Position.z,
+                               Body.Orientation.x, Body.Orientation.y, Body.Orientation.z, Body.Orientation.w};
+        Hasher.Add(State, sizeof(State));
+    }
+    return Hasher.Get();
+}
+
+} // namespace Volante
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "BroadPhase.h"
+#include "ContactSolver.h"
+#include "Engine.h"
+
+namespace Volante {
+
+struct PhysicsDesc {
+    float FixedTimeStep = 1.0f / 60.0f;
+
+    // Steps per Update before the accumulator is dropped, so a long frame cannot snowball
+    uint32_t MaxSubSteps = 4;
+
+    SolverSettings Solver;
+};
+
+struct PhysicsStats {
+    uint32_t BodyCount = 0;
+    uint32_t AwakeBodyCount = 0;
+    uint32_t PairCount = 0;
+    uint32_t ManifoldCount = 0;
+    uint32_t ContactCount = 0;
+    uint32_t IslandCount = 0;
+    uint64_t StepCount = 0;
+
+    float BroadPhaseMs = 0.0f;
+    float NarrowPhaseMs = 0.0f;
+    float SolverMs = 0.0f;
+    float StepMs = 0.0f;
+};
+
+// Rigid bodies (spheres and boxes) stepped on a fixed timestep. Each step runs sweep-and-prune,
+// the narrow phase, island building and a parallel per-island solve. Results only depend on the
+// scene and the number of steps taken, not on the worker count or frame rate.
+class PhysicsSystem : public IEngineSubsystem {
+public:
+    explicit PhysicsSystem(const PhysicsDesc& Desc = {}, JobSystem* Jobs = nullptr);
+    ~PhysicsSystem() override;
+
+    void Initialize() override;
+    void Shutdown() override;
+    void Update(float DeltaTime) override;
+
+    // Advances the simulation by exactly one step of Dt, independent of the accumulator.
+    void Step(float Dt);
+
+    BodyId CreateBody(const BodyDesc& Desc);
+    void DestroyBody(BodyId Id);
+    void Clear();
+
+    void WakeBody(BodyId Id);
+    void SetTransform(BodyId Id, const Vec3& Position, const Quat& Orientation);
+    void SetLinearVelocity(BodyId Id, const Vec3& Velocity);
+    void ApplyImpulse(BodyId Id, const Vec3& Impulse, const Vec3& WorldPoint);
+
+    [[nodiscard]] const RigidBody& GetBody(BodyId Id) const { return Bodies[Id]; }
+
+    [[nodiscard]] Mat4 GetTransform(BodyId Id) const;
+
+    // Blends the last two steps by the leftover accumulator time, for smooth rendering at any
+    // frame rate.
+    [[nodiscard]] Mat4 GetInterpolatedTransform(BodyId Id) const;
+
+    [[nodiscard]] float GetInterpolationAlpha() const { return Accumulator / Desc.FixedTimeStep; }
+
+    [[nodiscard]] const std::vector<ContactManifold>& GetManifolds() const { return Manifolds; }
+
+    [[nodiscard]] const PhysicsStats& GetStats() const { return Stats; }
+
+    // Hash of every body's position and orientation bits, for determinism checks.
+    [[nodiscard]] uint64_t ComputeStateHash() const;
+
+private:
+    void NarrowPhase();
+    void WarmStart();
+    void BuildIslands();
+
+    PhysicsDesc Desc;
+    JobSystem* Jobs;
+
+    std::vector<RigidBody> Bodies;
+    std::vector<BodyId> FreeIds;
+
+    SweepAndPrune BroadPhase;
+    std::vector<BodyPair> Pairs;
+    std::vector<uint32_t> PairIndices[3];
+    std::vector<ContactManifold> Manifolds;
+    std::vector<ContactManifold> PreviousManifolds;
+
+    std::vector<Island> Islands;
+    std::vector<BodyId> IslandBodies;
+    std::vector<uint32_t> IslandManifolds;
+    std::vector<uint32_t> Parents;
+    std::vector<uint32_t> RootIslands;
+
+    float Accumulator = 0.0f;
+    PhysicsStats Stats;
+};
+
+} // namespace Volante
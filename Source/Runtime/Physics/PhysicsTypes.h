@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Runtime/Core/Math/Bounds.h"
+
+namespace Volante {
+
+using BodyId = uint32_t;
+constexpr BodyId InvalidBodyId = ~0u;
+
+// Ordered so that a pair can be canonicalised with the lower shape first (sphere-box, never
+// box-sphere), which keeps the narrow phase to three kernels.
+enum class ShapeType : uint8_t {
+    Sphere,
+    Box,
+};
+
+struct BodyDesc {
+    ShapeType Shape = ShapeType::Box;
+    Vec3 HalfExtents = Vec3(0.5f);
+    float Radius = 0.5f;
+
+    Vec3 Position = Vec3(0.0f);
+    Quat Orientation = Quat(1.0f, 0.0f, 0.0f, 0.0f);
+    Vec3 LinearVelocity = Vec3(0.0f);
+    Vec3 AngularVelocity = Vec3(0.0f);
+
+    // Zero makes the body static: it collides but is never moved by the solver.
+    float Mass = 1.0f;
+    float Friction = 0.6f;
+    float Restitution = 0.0f;
+
+    bool StartAwake = true;
+    uint64_t UserData = 0;
+};
+
+struct RigidBody {
+    Vec3 Position = Vec3(0.0f);
+    Quat Orientation = Quat(1.0f, 0.0f, 0.0f, 0.0f);
+    Vec3 LinearVelocity = Vec3(0.0f);
+    Vec3 AngularVelocity = Vec3(0.0f);
+
+    // Split-impulse pseudo velocities: move the body out of penetration during integration
+    // without feeding energy back into the real velocities. Solver scratch, zero between steps.
+    Vec3 PushVelocity = Vec3(0.0f);
+    Vec3 PushAngularVelocity = Vec3(0.0f);
+
+    // State at the start of the last step, for interpolated rendering.
+    Vec3 PreviousPosition = Vec3(0.0f);
+    Quat PreviousOrientation = Quat(1.0f, 0.0f, 0.0f, 0.0f);
+
+    // Cached from Orientation after every integration.
+    Mat3 Rotation = Mat3(1.0f);
+    Mat3 InvInertiaWorld = Mat3(0.0f);
+    Vec3 InvInertiaLocal = Vec3(0.0f);
+    float InvMass = 0.0f;
+
+    ShapeType Shape = ShapeType::Box;
+    Vec3 HalfExtents = Vec3(0.5f);
+    float Radius = 0.5f;
+    float Friction = 0.6f;
+    float Restitution = 0.0f;
+
+    float SleepTime = 0.0f;
+    bool Awake = true;
+    bool Alive = false;
+    uint64_t UserData = 0;
+
+    [[nodiscard]] bool IsStatic() const { return InvMass == 0.0f; }
+
+    [[nodiscard]] bool IsActive() const { return Awake && InvMass > 0.0f; }
+
+    [[nodiscard]] AABB GetBounds() const {
+        if (Shape == ShapeType::Sphere) { return AABB::FromCenterExtent(Position, Vec3(Radius)); }
+        const Vec3 Extent = glm::abs(Rotation[0]) * HalfExtents.x + glm::abs(Rotation[1]) * HalfExtents.y +
+                            glm::abs(Rotation[2]) * HalfExtents.z;
+        return AABB::FromCenterExtent(Position, Extent);
+    }
+
+    void UpdateDerived() {
+        Rotation = glm::mat3_cast(Orientation);
+        // R * diag(InvInertiaLocal) * R^T, with the diagonal applied by scaling columns
+        Mat3 Scaled = Rotation;
+        Scaled[0] *= InvInertiaLocal.x;
+        Scaled[1] *= InvInertiaLocal.y;
+        Scaled[2] *= InvInertiaLocal.z;
+        InvInertiaWorld = Scaled * glm::transpose(Rotation);
+    }
+};
+
+struct BodyPair {
+    BodyId A;
+    BodyId B;
+
+    [[nodiscard]] uint64_t GetKey() const { return (static_cast<uint64_t>(A) << 32) | B; }
+};
+
+struct ContactPoint {
+    Vec3 Position = Vec3(0.0f);
+    float Penetration = 0.0f;
+
+    // Accumulated impulses, carried across steps for warm starting.
+    float NormalImpulse = 0.0f;
+    float TangentImpulse[2] = {0.0f, 0.0f};
+};
+
+constexpr uint32_t MaxManifoldPoints = 4;
+
+struct ContactManifold {
+    BodyId BodyA = InvalidBodyId;
+    BodyId BodyB = InvalidBodyId;
+
+    // Points from A towards B.
+    Vec3 Normal = Vec3(0.0f, 1.0f, 0.0f);
+    uint32_t PointCount = 0;
+    ContactPoint Points[MaxManifoldPoints];
+
+    [[nodiscard]] uint64_t GetKey() const { return (static_cast<uint64_t>(BodyA) << 32) | BodyB; }
+};
+
+} // namespace Volante
@@ -0,0 +1,27 @@
+#include "Camera.h"
+
+#include "DepthConvention.h"
+
+namespace Volante {
+
+void Camera::LookAt(const DVec3& Target, const Vec3& Up) {
+    const Vec3 Direction = Vec3(Target - Position);
+    if (dot(Direction, Direction) < 1e-12f) { return; }
+    Rotation = glm::quatLookAt(normalize(Direction), Up);
+}
+
+Mat4 Camera::GetProjection() const {
+    return MakeReverseZPerspective(FovY, AspectRatio, NearPlane, FarPlane);
+}
+
+RenderView Camera::CreateView(const Vec2& Jitter) const {
+    // The float origin is within half an ulp of the camera and the view matrix takes up the
+    // rest, so the matrices only ever hold small translations
+    const Vec3 Origin = Vec3(Position);
+    const Vec3 Residual = Vec3(Position - DVec3(Origin));
+    const Mat4 RelativeView = glm::translate(glm::mat4_cast(glm::conjugate(Rotation)), -Residual);
+    const Mat4 Projection = glm::translate(Mat4(1.0f), Vec3(Jitter, 0.0f)) * GetProjection();
+    return RenderView::CreateRelative(RelativeView, Projection, Origin, LODScale);
+}
+
+} // namespace Volante
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <limits>
+
+#include "RenderView.h"
+
+namespace Volante {
+
+// A perspective camera whose position is kept in double precision, so it can sit anywhere in a
+// large world. CreateView splits the position into a float Origin and the remainder the view
+// matrix carries (see RenderView) and projects with a reverse-Z perspective, infinite unless
+// FarPlane is set.
+struct Camera {
+    DVec3 Position = DVec3(0.0);
+    // Identity looks down -Z with +Y up
+    Quat Rotation = Quat(1.0f, 0.0f, 0.0f, 0.0f);
+    float FovY = glm::radians(60.0f);
+    float AspectRatio = 16.0f / 9.0f;
+    float NearPlane = 0.1f;
+    float FarPlane = std::numeric_limits<float>::infinity();
+    float LODScale = 1.0f;
+
+    // Turns to face Target. Up must not be parallel to the view direction.
+    void LookAt(const DVec3& Target, const Vec3& Up = Vec3(0.0f, 1.0f, 0.0f));
+
+    // Offset in the camera's own axes: x right, y up, -z forward.
+    void MoveLocal(const Vec3& Offset) { Position += DVec3(Rotation * Offset); }
+
+    [[nodiscard]] Vec3 GetForward() const { return Rotation * Vec3(0.0f, 0.0f, -1.0f); }
+
+    [[nodiscard]] Vec3 GetRight() const { return Rotation * Vec3(1.0f, 0.0f, 0.0f); }
+
+    [[nodiscard]] Vec3 GetUp() const { return Rotation * Vec3(0.0f, 1.0f, 0.0f); }
+
+    [[nodiscard]] Mat4 GetProjection() const;
+
+    // Jitter shifts the projection by that much in NDC, for temporal anti-aliasing.
+    [[nodiscard]] RenderView CreateView(const Vec2& Jitter = Vec2(0.0f)) const;
+};
+
+} // namespace Volante
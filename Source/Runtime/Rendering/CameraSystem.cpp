@@ -0,0 +1,88 @@
+#include "CameraSystem.h"
+
+#include <algorithm>
+
+namespace Volante {
+
+CameraSystem::CameraSystem(SceneRenderer* Scene) : Scene(Scene) {
+    Cameras.resize(1);
+    Cameras[MainSceneView].Active = true;
+}
+
+CameraSystem::~CameraSystem() = default;
+
+void CameraSystem::Initialize() {
+    Apply();
+}
+
+void CameraSystem::Shutdown() {
+    for (SceneViewId Id = 1; Id < Cameras.size(); ++Id) {
+        RemoveCamera(Id);
+    }
+    Cameras.resize(1);
+    Surfaces.clear();
+}
+
+void CameraSystem::Update(float DeltaTime) {
+    // Cameras are moved directly through GetCamera(); Apply hands them to the renderer
+}
+
+SceneViewId CameraSystem::AddCamera(const Camera& InCamera, const Vec4& Viewport, uint32_t Surface) {
+    const CameraSlot Slot{InCamera, Viewport, Surface, true};
+    const SceneViewId Id = Scene->AddView(GetFramebufferViewport(Slot));
+    if (Id >= Cameras.size()) { Cameras.resize(Id + 1); }
+    Cameras[Id] = Slot;
+    return Id;
+}
+
+void CameraSystem::RemoveCamera(SceneViewId Id) {
+    if (Id == MainSceneView || Id >= Cameras.size() || !Cameras[Id].Active) { return; }
+    Cameras[Id].Active = false;
+    Scene->RemoveView(Id);
+}
+
+Camera* CameraSystem::GetCamera(SceneViewId Id) {
+    return Id < Cameras.size() && Cameras[Id].Active ? &Cameras[Id].View : nullptr;
+}
+
+void CameraSystem::SetViewport(SceneViewId Id, const Vec4& Viewport) {
+    if (Id >= Cameras.size() || !Cameras[Id].Active) { return; }
+    Cameras[Id].Viewport = Viewport;
+    Scene->SetViewport(Id, GetFramebufferViewport(Cameras[Id]));
+}
+
+void CameraSystem::SetFramebufferSize(int Width, int Height) {
+    // A minimized window reports zero; keep the last aspect ratios until it comes back
+    if (Width <= 0 || Height <= 0) { return; }
+    FramebufferWidth = Width;
+    FramebufferHeight = Height;
+}
+
+void CameraSystem::SetSurfaceRect(uint32_t Surface, const Vec4& Rect) {
+    if (Surface >= Surfaces.size()) { Surfaces.resize(Surface + 1, Vec4(0.0f, 0.0f, 1.0f, 1.0f)); }
+    Surfaces[Surface] = Rect;
+    for (SceneViewId Id = 0; Id < Cameras.size(); ++Id) {
+        if (Cameras[Id].Active && Cameras[Id].Surface == Surface) { Scene->SetViewport(Id, GetFramebufferViewport(Cameras[Id])); }
+    }
+}
+
+void CameraSystem::Apply(const Vec2& Jitter) {
+    for (SceneViewId Id = 0; Id < Cameras.size(); ++Id) {
+        CameraSlot& Slot = Cameras[Id];
+        if (!Slot.Active) { continue; }
+        const Vec4 Viewport = GetFramebufferViewport(Slot);
+        const float Width = static_cast<float>(FramebufferWidth) * Viewport.z;
+        const float Height = static_cast<float>(FramebufferHeight) * Viewport.w;
+        Slot.View.AspectRatio = Width / std::max(Height, 1.0f);
+        Scene->SetView(Id, Slot.View.CreateView(Jitter / Vec2(Viewport.z, Viewport.w)));
+    }
+}
+
+Vec4 CameraSystem::GetFramebufferViewport(const CameraSlot& Slot) const {
+    if (Slot.Surface >= Surfaces.size()) { return Slot.Viewport; }
+    const Vec4& Rect = Surfaces[Slot.Surface];
+    return {Rect.x + Slot.Viewport.x * Rect.z, Rect.y + Slot.Viewport.y * Rect.w, Slot.Viewport.z * Rect.z,
+            Slot.Viewport.w * Rect.w};
+}
+
+} // namespace Volante
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <vector>
+
+#include "Camera.h"
+#include "Engine.h"
+#include "SceneRenderer.h"
+
+namespace Volante {
+
+// The cameras the scene is drawn from, one SceneRenderer view each. The main camera drives the
+// main view; more cameras split the screen (or picture-in-picture) by their viewports. Apply
+// pushes them all to the renderer with aspect ratios matching their share of the framebuffer.
+//
+// Viewports are relative to a surface: surface 0 is the main window, and with more windows
+// (see WindowPresenter) each shows its own region of the framebuffer, which SetSurfaceRect
+// places.
+class CameraSystem : public IEngineSubsystem {
+public:
+    explicit CameraSystem(SceneRenderer* Scene);
+    ~CameraSystem() override;
+
+    void Initialize() override;
+    void Shutdown() override;
+    void Update(float DeltaTime) override;
+
+    // Viewport is the camera's rectangle (x, y, width, height) as fractions of its surface.
+    SceneViewId AddCamera(const Camera& InCamera, const Vec4& Viewport, uint32_t Surface = 0);
+    void RemoveCamera(SceneViewId Id);
+
+    // Null for an id that has no camera.
+    [[nodiscard]] Camera* GetCamera(SceneViewId Id);
+
+    [[nodiscard]] Camera& GetMainCamera() { return Cameras[MainSceneView].View; }
+
+    void SetViewport(SceneViewId Id, const Vec4& Viewport);
+
+    void SetFramebufferSize(int Width, int Height);
+
+    // The surface's region of the framebuffer, as fractions; until set, a surface covers all of it.
+    void SetSurfaceRect(uint32_t Surface, const Vec4& Rect);
+
+    // Once per frame, after gameplay has moved the cameras and before the scene renders.
+    // Jitter is in NDC of the whole framebuffer and is scaled to each camera's viewport.
+    void Apply(const Vec2& Jitter = Vec2(0.0f));
+
+private:
+    struct CameraSlot {
+        Camera View;
+        Vec4 Viewport = Vec4(0.0f, 0.0f, 1.0f, 1.0f);
+        uint32_t Surface = 0;
+        bool Active = false;
+    };
+
+    // The slot's viewport as fractions of the framebuffer
+    [[nodiscard]] Vec4 GetFramebufferViewport(const CameraSlot& Slot) const;
+
+    SceneRenderer* Scene;
+    // Indexed by SceneViewId
+    std::vector<CameraSlot> Cameras;
+    std::vector<Vec4> Surfaces;
+    int FramebufferWidth = 1;
+    int FramebufferHeight = 1;
+};
+
+} // namespace Volante
@@ -0,0 +1,227 @@
+#include "CascadedShadows.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+
+#include "DepthConvention.h"
+#include "Shader.h"
+
+namespace Volante {
+
+CascadedShadows::CascadedShadows(const CascadedShadowDesc& InDesc) : Desc(InDesc) {
+    Desc.CascadeCount = std::clamp(Desc.CascadeCount, 1u, MaxShadowCascades);
+    Desc.Resolution = std::max(Desc.Resolution, 16u);
+}
+
+CascadedShadows::~CascadedShadows() {
+    Shutdown();
+}
+
+bool CascadedShadows::Initialize() {
+    Shutdown();
+
+    const auto Size = static_cast<GLsizei>(Desc.Resolution);
+    glGenTextures(1, &DepthTexture);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, DepthTexture);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT32F, Size, Size, static_cast<GLsizei>(Desc.CascadeCount), 0,
+                 GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+    // Linear filtering with compare mode gives 2x2 PCF per tap for free
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+    const float Border[4] = {FarDepth, FarDepth, FarDepth, FarDepth};
+    glTexParameterfv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BORDER_COLOR, Border);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_FUNC, GL_GEQUAL);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    GLint Previous = 0;
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &Previous);
+    glGenFramebuffers(1, &Framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, Framebuffer);
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, DepthTexture, 0, 0);
+    glDrawBuffer(GL_NONE);
+    glReadBuffer(GL_NONE);
+    const bool Complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(Previous));
+
+    if (!Complete) {
+        std::cerr << "ERROR::SHADOWS::FRAMEBUFFER_INCOMPLETE" << std::endl;
+        Shutdown();
+        return false;
+    }
+    return true;
+}
+
+void CascadedShadows::Shutdown() {
+    if (Framebuffer != 0) { glDeleteFramebuffers(1, &Framebuffer); }
+    if (DepthTexture != 0) { glDeleteTextures(1, &DepthTexture); }
+    Framebuffer = DepthTexture = 0;
+    for (Cascade& Target : Cascades) {
+        Target.Valid = false;
+    }
+    FittedProjection = Mat4(0.0f);
+}
+
+void CascadedShadows::MarkChanged(const std::vector<AABB>& Bounds) {
+    PendingChanges.insert(PendingChanges.end(), Bounds.begin(), Bounds.end());
+}
+
+uint32_t CascadedShadows::Update(const RenderView& Camera, const Vec3& InLightDirection) {
+    ++FrameNumber;
+    Stats = {};
+    Stats.ChangedBoundsTested = static_cast<uint32_t>(PendingChanges.size());
+
+    const Vec3 Direction = normalize(InLightDirection);
+    if (dot(Direction, LightDirection) < 0.99999f) {
+        LightDirection = Direction;
+        const Vec3 Up = std::abs(Direction.y) > 0.99f ? Vec3(0.0f, 0.0f, 1.0f) : Vec3(0.0f, 1.0f, 0.0f);
+        LightRotation = glm::lookAt(Vec3(0.0f), -Direction, Up);
+        for (Cascade& Target : Cascades) {
+            Target.Valid = false;
+        }
+    }
+
+    // Split distances and sphere radii depend only on the projection, so they are refitted (and
+    // the maps dropped) only when it changes
+    if (!(Camera.Projection == FittedProjection)) {
+        FittedProjection = Camera.Projection;
+        float Near = 0.0f;
+        float ProjectionFar = 0.0f;
+        GetProjectionDepthRange(Camera.Projection, Near, ProjectionFar);
+        const float Far = std::max(std::min(ProjectionFar, Desc.MaxDistance), Near * 2.0f);
+
+        // Squared tangent of the half-diagonal field of view
+        const float TanX = 1.0f / Camera.Projection[0][0];
+        const float TanY = 1.0f / Camera.Projection[1][1];
+        const float DiagonalSquared = TanX * TanX + TanY * TanY;
+
+        float SliceNear = Near;
+        for (uint32_t i = 0; i < Desc.CascadeCount; ++i) {
+            const float T = static_cast<float>(i + 1) / static_cast<float>(Desc.CascadeCount);
+            const float SliceFar = Desc.SplitLambda * Near * std::pow(Far / Near, T) + (1.0f - Desc.SplitLambda) * (Near + (Far - Near) * T);
+
+            // Smallest sphere through the slice's near and far corners, centred on the view axis
+            const float CenterDepth = std::min((SliceFar + SliceNear) * (1.0f + DiagonalSquared) * 0.5f, SliceFar);
+            const float Radius = std::sqrt((CenterDepth - SliceNear) * (CenterDepth - SliceNear) + SliceNear * SliceNear * DiagonalSquared);
+            const float FarRadius = std::sqrt((SliceFar - CenterDepth) * (SliceFar - CenterDepth) + SliceFar * SliceFar * DiagonalSquared);
+
+            Cascade& Target = Cascades[i];
+            Target.SplitFar = SliceFar;
+            Target.FitRadius = std::max(Radius, FarRadius);
+            Target.FitCenter = Vec3(0.0f, 0.0f, -CenterDepth);
+            Target.Radius = Target.FitRadius * (1.0f + Desc.CoverageMargin);
+            Target.Valid = false;
+            SliceNear = SliceFar;
+        }
+    }
+
+    const Mat4 CameraToWorld = glm::inverse(Camera.View);
+    uint32_t DueCount = 0;
+    for (uint32_t i = 0; i < Desc.CascadeCount; ++i) {
+        Cascade& Target = Cascades[i];
+        const Vec3 Center = Vec3(CameraToWorld * Vec4(Target.FitCenter, 1.0f));
+
+        bool Due = !Target.Valid;
+        if (!Due) {
+            // Re-centre once the fitted sphere would poke out of the cached map
+            const Vec3 Drift = glm::abs(Vec3(LightRotation * Vec4(Center, 1.0f)) - Target.LightSpaceCenter);
+            Due = std::max({Drift.x, Drift.y, Drift.z}) > Target.Radius - Target.FitRadius;
+        }
+        if (Due) {
+            Target.LightSpaceCenter = Vec3(LightRotation * Vec4(Center, 1.0f));
+            Recenter(Target);
+        } else {
+            for (const AABB& Bounds : PendingChanges) {
+                if (Target.CastersChanged) { break; }
+                Target.CastersChanged = Target.LightVolume.Intersects(Bounds);
+            }
+            const uint32_t Interval = std::max(Desc.UpdateInterval[i], 1u);
+            Due = Target.CastersChanged && (FrameNumber + i) % Interval == 0;
+        }
+
+        if (Due) {
+            Target.View.Position = Camera.Position;
+            Target.Valid = true;
+            Target.CastersChanged = false;
+            DueCascades[DueCount++] = i;
+        }
+    }
+    PendingChanges.clear();
+
+    Stats.CascadesRendered = DueCount;
+    Stats.CascadesCached = Desc.CascadeCount - DueCount;
+    return DueCount;
+}
+
+void CascadedShadows::Recenter(Cascade& Target) const {
+    // Snap to whole texels in light space so static geometry rasterizes identically every time
+    const float TexelSize = 2.0f * Target.Radius / static_cast<float>(Desc.Resolution);
+    Vec3 Center = Target.LightSpaceCenter;
+    Center.x = std::floor(Center.x / TexelSize) * TexelSize;
+    Center.y = std::floor(Center.y / TexelSize) * TexelSize;
+    Target.LightSpaceCenter = Center;
+
+    const float Depth = 2.0f * Target.Radius + Desc.CasterDistance;
+    const Vec3 Eye = Center + Vec3(0.0f, 0.0f, Target.Radius + Desc.CasterDistance);
+    const Mat4 View = glm::translate(Mat4(1.0f), -Eye) * LightRotation;
+    const Mat4 Projection = MakeReverseZOrthographic(-Target.Radius, Target.Radius, -Target.Radius, Target.Radius, 0.0f, Depth);
+
+    Target.View = RenderView::Create(View, Projection);
+    Target.ShadowMatrix = GetClipToTexture() * Target.View.ViewProjection;
+    Target.LightVolume = Target.View.ViewFrustum;
+}
+
+void CascadedShadows::BeginCascade(uint32_t Index) {
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &SavedFramebuffer);
+    glGetIntegerv(GL_VIEWPORT, SavedViewport);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, Framebuffer);
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, DepthTexture, 0, static_cast<GLint>(Index));
+    glViewport(0, 0, static_cast<GLsizei>(Desc.Resolution), static_cast<GLsizei>(Desc.Resolution));
+    glClearBufferfv(GL_DEPTH, 0, &FarDepth);
+
+    // Slope-scaled offset for grazing angles, away from the light (smaller with reverse-Z); the
+    // constant part is applied when sampling
+    glEnable(GL_POLYGON_OFFSET_FILL);
+    glPolygonOffset(-2.0f, 0.0f);
+}
+
+void CascadedShadows::EndCascade() {
+    glDisable(GL_POLYGON_OFFSET_FILL);
+    glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(SavedFramebuffer));
+    glViewport(SavedViewport[0], SavedViewport[1], SavedViewport[2], SavedViewport[3]);
+}
+
+void CascadedShadows::Bind(const Shader& Program, int Unit) const {
+    glActiveTexture(GL_TEXTURE0 + Unit);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, DepthTexture);
+    glActiveTexture(GL_TEXTURE0);
+    Program.setInt("uShadowMap", Unit);
+
+    // Only cascades that have been rendered at least once are sampled
+    int CascadeCount = 0;
+    while (CascadeCount < static_cast<int>(Desc.CascadeCount) && Cascades[CascadeCount].Valid) {
+        ++CascadeCount;
+    }
+    Program.setInt("uShadowCascadeCount", CascadeCount);
+    Program.setFloat("uShadowTexelSize", 1.0f / static_cast<float>(Desc.Resolution));
+
+    for (int i = 0; i < CascadeCount; ++i) {
+        const Cascade& Target = Cascades[i];
+        const float TexelSize = 2.0f * Target.Radius / static_cast<float>(Desc.Resolution);
+        // World units to stored depth, which is halved without clip control
+        const float DepthRange = (2.0f * Target.Radius + Desc.CasterDistance) / GetClipToTexture()[2][2];
+        const std::string Index = "[" + std::to_string(i) + "]";
+        Program.setMat4("uShadowMatrices" + Index, Target.ShadowMatrix);
+        Program.setVec4("uShadowParams" + Index, Vec4(Target.SplitFar, Desc.DepthBias * TexelSize / DepthRange,
+                                                      Desc.NormalOffset * TexelSize, 0.0f));
+    }
+}
+
+} // namespace Volante
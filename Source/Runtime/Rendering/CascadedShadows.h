@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "RenderView.h"
+
+namespace Volante {
+
+class Shader;
+
+constexpr uint32_t MaxShadowCascades = 4;
+
+struct CascadedShadowDesc {
+    uint32_t CascadeCount = 4;
+    uint32_t Resolution = 2048;
+
+    // Shadows end here (or at the projection's far plane if nearer).
+    float MaxDistance = 200.0f;
+
+    // Blend between logarithmic (1) and uniform (0) split distances.
+    float SplitLambda = 0.75f;
+
+    // Each cascade map covers its view slice plus this fraction of slack, so the camera can
+    // move that far before the cascade has to be re-centred and re-rendered.
+    float CoverageMargin = 0.25f;
+
+    // How far beyond a cascade, towards the light, casters are still captured.
+    float CasterDistance = 100.0f;
+
+    // A cascade whose casters changed is re-rendered at most every N frames. Re-centring and
+    // light changes always re-render immediately.
+    uint32_t UpdateInterval[MaxShadowCascades] = {1, 1, 2, 4};
+
+    // Depth bias in texels of each cascade, and the normal offset in the same unit.
+    float DepthBias = 1.5f;
+    float NormalOffset = 1.0f;
+};
+
+struct CascadedShadowStats {
+    uint32_t CascadesRendered = 0;
+    uint32_t CascadesCached = 0;
+    uint32_t ChangedBoundsTested = 0;
+};
+
+// Cascaded shadow maps for the directional light, in one depth texture array.
+//
+// Fitting is stable: each cascade is a sphere around its slice of the view frustum, so its size
+// does not change as the camera turns, and its centre is snapped to whole shadow texels, so
+// static shadows do not shimmer as the camera moves. Maps are cached: a cascade is re-rendered
+// only when the light turns, the camera leaves its coverage margin, or a caster inside its light
+// volume changed (reported through MarkChanged), and distant cascades pick up caster changes at
+// their lower UpdateInterval.
+//
+// The owner drives rendering: Update() decides which cascades are due; for each of them it calls
+// BeginCascade(), culls and draws casters with GetCascadeView(), then EndCascade().
+class CascadedShadows {
+public:
+    explicit CascadedShadows(const CascadedShadowDesc& Desc = {});
+    ~CascadedShadows();
+
+    CascadedShadows(const CascadedShadows&) = delete;
+    CascadedShadows& operator=(const CascadedShadows&) = delete;
+
+    bool Initialize();
+    void Shutdown();
+
+    // Bounds (old and new) of casters that were added, moved or removed since the last Update.
+    void MarkChanged(const std::vector<AABB>& Bounds);
+
+    // Refits the cascades for the camera and returns how many need rendering this frame;
+    // GetDueCascade(i) gives their indices. LightDirection points towards the light.
+    uint32_t Update(const RenderView& Camera, const Vec3& LightDirection);
+
+    [[nodiscard]] uint32_t GetDueCascade(uint32_t i) const { return DueCascades[i]; }
+
+    // The caster view of a cascade. Its Position is the camera's, so LOD selection in the
+    // shadow pass matches the main view.
+    [[nodiscard]] const RenderView& GetCascadeView(uint32_t Cascade) const { return Cascades[Cascade].View; }
+
+    // Binds the cascade layer as the depth target (saving framebuffer and viewport) and clears it.
+    void BeginCascade(uint32_t Cascade);
+    void EndCascade();
+
+    // Binds the map to texture unit Unit and sets the uniforms Shaders/CascadedShadows.glsl
+    // declares. The program must be in use.
+    void Bind(const Shader& Program, int Unit) const;
+
+    [[nodiscard]] const CascadedShadowStats& GetStats() const { return Stats; }
+
+    [[nodiscard]] uint32_t GetCascadeCount() const { return Desc.CascadeCount; }
+
+private:
+    struct Cascade {
+        // Fitted to the current camera
+        float SplitFar = 0.0f;
+        float FitRadius = 0.0f;
+        Vec3 FitCenter = Vec3(0.0f);
+
+        // What the cached map was rendered with
+        float Radius = 0.0f;
+        Vec3 LightSpaceCenter = Vec3(0.0f);
+        RenderView View;
+        Mat4 ShadowMatrix = Mat4(1.0f);
+        Frustum LightVolume;
+        bool Valid = false;
+        bool CastersChanged = false;
+    };
+
+    void Recenter(Cascade& Target) const;
+
+    CascadedShadowDesc Desc;
+    Cascade Cascades[MaxShadowCascades];
+    uint32_t DueCascades[MaxShadowCascades] = {};
+    Mat4 LightRotation = Mat4(1.0f);
+    Vec3 LightDirection = Vec3(0.0f);
+    Mat4 FittedProjection = Mat4(0.0f);
+    uint64_t FrameNumber = 0;
+    std::vector<AABB> PendingChanges;
+    CascadedShadowStats Stats;
+
+    unsigned int DepthTexture = 0;
+    unsigned int Framebuffer = 0;
+    int SavedFramebuffer = 0;
+    int SavedViewport[4] = {0, 0, 0, 0};
+};
+
+} // namespace Volante
@@ -0,0 +1,121 @@
+#include "ClusteredLighting.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+
+#include "Shader.h"
+
+namespace Volante {
+
+namespace {
+
+enum LightBuffer { LightDataBuffer, ClusterRangeBuffer, LightIndexBuffer };
+
+void Upload(unsigned int Buffer, const void* Data, size_t Bytes) {
+    // Orphan every frame: the previous contents may still be in use by the GPU
+    glBindBuffer(GL_TEXTURE_BUFFER, Buffer);
+    glBufferData(GL_TEXTURE_BUFFER, static_cast<GLsizeiptr>(std::max<size_t>(Bytes, 16)), nullptr, GL_STREAM_DRAW);
+    if (Bytes > 0) { glBufferSubData(GL_TEXTURE_BUFFER, 0, static_cast<GLsizeiptr>(Bytes), Data); }
+}
+
+} // namespace
+
+ClusteredLighting::ClusteredLighting(const LightClusterDesc& Desc) : Clusters(Desc) {}
+
+ClusteredLighting::~ClusteredLighting() {
+    Shutdown();
+}
+
+void ClusteredLighting::Initialize() {
+    Shutdown();
+    glGenBuffers(3, Buffers);
+    glGenTextures(3, Textures);
+
+    const GLenum Formats[3] = {GL_RGBA32F, GL_RG32UI, GL_R32UI};
+    for (int i = 0; i < 3; ++i) {
+        Upload(Buffers[i], nullptr, 0);
+        glBindTexture(GL_TEXTURE_BUFFER, Textures[i]);
+        glTexBuffer(GL_TEXTURE_BUFFER, Formats[i], Buffers[i]);
+    }
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void ClusteredLighting::Shutdown() {
+    if (Textures[0] != 0) { glDeleteTextures(3, Textures); }
+    if (Buffers[0] != 0) { glDeleteBuffers(3, Buffers); }
+    for (int i = 0; i < 3; ++i) {
+        Textures[i] = Buffers[i] = 0;
+    }
+}
+
+LightId ClusteredLighting::AddLight(const PointLight& Light) {
+    if (!FreeIds.empty()) {
+        const LightId Id = FreeIds.back();
+        FreeIds.pop_back();
+        Lights[Id] = Light;
+        return Id;
+    }
+    Lights.push_back(Light);
+    return static_cast<LightId>(Lights.size() - 1);
+}
+
+void ClusteredLighting::SetLight(LightId Id, const PointLight& Light) {
+    Lights[Id] = Light;
+}
+
+void ClusteredLighting::RemoveLight(LightId Id) {
+    // A zero radius keeps the slot out of every cluster until it is reused
+    Lights[Id].Radius = 0.0f;
+    FreeIds.push_back(Id);
+}
+
+void ClusteredLighting::SetDirectionalLight(const Vec3& Direction, const Vec3& Color) {
+    SunDirection = normalize(Direction);
+    SunColor = Color;
+}
+
+void ClusteredLighting::Update(const RenderView& View, JobSystem* Jobs) {
+    CameraPosition = View.Position;
+    Clusters.Build(Lights, View.View, View.Projection, Jobs);
+
+    LightData.resize(Lights.size() * 2);
+    for (size_t i = 0; i < Lights.size(); ++i) {
+        const PointLight& Light = Lights[i];
+        LightData[i * 2] = Vec4(Light.Position, Light.Radius);
+        LightData[i * 2 + 1] = Vec4(Light.Color * Light.Intensity, 0.0f);
+    }
+
+    const std::vector<uint32_t>& Ranges = Clusters.GetClusterRanges();
+    const std::vector<uint32_t>& Indices = Clusters.GetLightIndices();
+    Upload(Buffers[LightDataBuffer], LightData.data(), LightData.size() * sizeof(Vec4));
+    Upload(Buffers[ClusterRangeBuffer], Ranges.data(), Ranges.size() * sizeof(uint32_t));
+    Upload(Buffers[LightIndexBuffer], Indices.data(), Indices.size() * sizeof(uint32_t));
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void ClusteredLighting::Bind(const Shader& Program, int FirstUnit) const {
+    const char* Samplers[3] = {"uLightData", "uClusterRanges", "uLightIndices"};
+    for (int i = 0; i < 3; ++i) {
+        glActiveTexture(GL_TEXTURE0 + FirstUnit + i);
+        glBindTexture(GL_TEXTURE_BUFFER, Textures[i]);
+        Program.setInt(Samplers[i], FirstUnit + i);
+    }
+    glActiveTexture(GL_TEXTURE0);
+
+    GLint Viewport[4] = {0, 0, 1, 1};
+    glGetIntegerv(GL_VIEWPORT, Viewport);
+
+    const LightClusterDesc& Desc = Clusters.GetDesc();
+    Program.setVec3("uClusterGrid", Vec3(static_cast<float>(Desc.TilesX), static_cast<float>(Desc.TilesY), static_cast<float>(Desc.Slices)));
+    Program.setVec2("uClusterSlices", Vec2(Clusters.GetSliceScale(), Clusters.GetSliceBias()));
+    Program.setVec4("uViewport", Vec4(static_cast<float>(Viewport[0]), static_cast<float>(Viewport[1]),
+                                      static_cast<float>(Viewport[2]), static_cast<float>(Viewport[3])));
+    Program.setVec3("uCameraPosition", CameraPosition);
+    Program.setVec3("uAmbientColor", Ambient);
+    Program.setVec3("uSunDirection", SunDirection);
+    Program.setVec3("uSunColor", SunColor);
+}
+
+} // namespace Volante
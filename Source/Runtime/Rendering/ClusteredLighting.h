@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "LightClusters.h"
+#include "RenderView.h"
+
+namespace Volante {
+
+class JobSystem;
+class Shader;
+
+using LightId = uint32_t;
+
+// Clustered forward lighting: point lights are assigned to view-frustum clusters on the CPU
+// (LightClusters) and the light data, per-cluster ranges and light index list are uploaded as
+// texture buffers, which GL 3.3 fragment shaders can read. A fragment only walks the lights of
+// its own cluster, so shading cost follows local light density rather than the total count.
+//
+// Shaders #include "ClusteredLighting.glsl" (in Shaders/) and call ComputeLighting(); Bind() sets
+// everything it reads.
+class ClusteredLighting {
+public:
+    explicit ClusteredLighting(const LightClusterDesc& Desc = {});
+    ~ClusteredLighting();
+
+    ClusteredLighting(const ClusteredLighting&) = delete;
+    ClusteredLighting& operator=(const ClusteredLighting&) = delete;
+
+    void Initialize();
+    void Shutdown();
+
+    LightId AddLight(const PointLight& Light);
+    void SetLight(LightId Id, const PointLight& Light);
+    void RemoveLight(LightId Id);
+
+    // Scene-wide terms added to every fragment; the defaults match a plain lit look.
+    void SetAmbient(const Vec3& Color) { Ambient = Color; }
+    void SetDirectionalLight(const Vec3& Direction, const Vec3& Color);
+
+    // Assigns lights to the view's clusters and uploads the lists. Requires a current context.
+    void Update(const RenderView& View, JobSystem* Jobs);
+
+    // Binds the three buffers to texture units FirstUnit .. FirstUnit + 2 and sets the
+    // uniforms ClusteredLighting.glsl declares. The program must be in use.
+    void Bind(const Shader& Program, int FirstUnit) const;
+
+    [[nodiscard]] const PointLight& GetLight(LightId Id) const { return Lights[Id]; }
+
+    [[nodiscard]] uint32_t GetLightCount() const { return static_cast<uint32_t>(Lights.size() - FreeIds.size()); }
+
+    [[nodiscard]] const Vec3& GetDirectionalLightDirection() const { return SunDirection; }
+
+    [[nodiscard]] const LightClusterStats& GetStats() const { return Clusters.GetStats(); }
+
+private:
+    LightClusters Clusters;
+    std::vector<PointLight> Lights;
+    std::vector<LightId> FreeIds;
+    std::vector<Vec4> LightData;
+
+    Vec3 Ambient = Vec3(0.15f);
+    Vec3 SunDirection = normalize(Vec3(0.4f, 1.0f, 0.3f));
+    Vec3 SunColor = Vec3(0.85f);
+    Vec3 CameraPosition = Vec3(0.0f);
+
+    // Buffer objects and the texture buffers viewing them: light data, cluster ranges, indices
+    unsigned int Buffers[3] = {0, 0, 0};
+    unsigned int Textures[3] = {0, 0, 0};
+};
+
+} // namespace Volante
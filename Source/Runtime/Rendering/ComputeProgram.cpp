@@ -0,0 +1,83 @@
+#include "ComputeProgram.h"
+
+#include <glad/glad.h>
+
+#include <iostream>
+
+namespace Volante {
+
+ComputeProgram::ComputeProgram(const char* Source) {
+    const unsigned int Shader = glCreateShader(GL_COMPUTE_SHADER);
+    glShaderSource(Shader, 1, &Source, nullptr);
+    glCompileShader(Shader);
+
+    int Success = 0;
+    char Info[1024];
+    glGetShaderiv(Shader, GL_COMPILE_STATUS, &Success);
+    if (!Success) {
+        glGetShaderInfoLog(Shader, sizeof(Info), nullptr, Info);
+        std::cerr << "ERROR::SHADER::COMPUTE::COMPILATION_FAILED: " << Info << std::endl;
+        glDeleteShader(Shader);
+        return;
+    }
+
+    Program = glCreateProgram();
+    glAttachShader(Program, Shader);
+    glLinkProgram(Program);
+    glDeleteShader(Shader);
+
+    glGetProgramiv(Program, GL_LINK_STATUS, &Success);
+    if (!Success) {
+        glGetProgramInfoLog(Program, sizeof(Info), nullptr, Info);
+        std::cerr << "ERROR::SHADER::PROGRAM::LINKING_FAILED: " << Info << std::endl;
+        glDeleteProgram(Program);
+        Program = 0;
+    }
+}
+
+ComputeProgram::~ComputeProgram() {
+    if (Program != 0) { glDeleteProgram(Program); }
+}
+
+void ComputeProgram::Use() const {
+    glUseProgram(Program);
+}
+
+void ComputeProgram::Dispatch(uint32_t GroupsX, uint32_t GroupsY, uint32_t GroupsZ) const {
+    if (GroupsX == 0 || GroupsY == 0 || GroupsZ == 0) { return; }
+    glDispatchCompute(GroupsX, GroupsY, GroupsZ);
+}
+
+void ComputeProgram::SetUInt(const char* Name, uint32_t Value) const {
+    glUniform1ui(glGetUniformLocation(Program, Name), Value);
+}
+
+void ComputeProgram::SetInt(const char* Name, int Value) const {
+    glUniform1i(glGetUniformLocation(Program, Name), Value);
+}
+
+void ComputeProgram::SetFloat(const char* Name, float Value) const {
+    glUniform1f(glGetUniformLocation(Program, Name), Value);
+}
+
+void ComputeProgram::SetIVec2(const char* Name, int X, int Y) const {
+    glUniform2i(glGetUniformLocation(Program, Name), X, Y);
+}
+
+void ComputeProgram::SetVec2(const char* Name, const Vec2& Value) const {
+    glUniform2fv(glGetUniformLocation(Program, Name), 1, &Value[0]);
+}
+
+void ComputeProgram::SetVec3(const char* Name, const Vec3& Value) const {
+    glUniform3fv(glGetUniformLocation(Program, Name), 1, &Value[0]);
+}
+
+void ComputeProgram::SetVec4Array(const char* Name, const Vec4* Values, int Count) const {
+    glUniform4fv(glGetUniformLocation(Program, Name), Count, &Values[0][0]);
+}
+
+void ComputeProgram::SetMat4(const char* Name, const Mat4& Value) const {
+    glUniformMatrix4fv(glGetUniformLocation(Program, Name), 1, GL_FALSE, &Value[0][0]);
+}
+
+} // namespace Volante
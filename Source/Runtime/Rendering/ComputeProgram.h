@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Volante.h"
+
+namespace Volante {
+
+// A linked compute-only program (GL 4.3+). Compile and link errors are printed and leave the
+// program invalid, the same way Shader reports them.
+class ComputeProgram {
+public:
+    explicit ComputeProgram(const char* Source);
+    // Takes over an already linked program
+    explicit ComputeProgram(unsigned int InProgram) : Program(InProgram) {}
+    ~ComputeProgram();
+
+    ComputeProgram(const ComputeProgram&) = delete;
+    ComputeProgram& operator=(const ComputeProgram&) = delete;
+
+    [[nodiscard]] bool IsValid() const { return Program != 0; }
+
+    [[nodiscard]] unsigned int GetHandle() const { return Program; }
+
+    void Use() const;
+    void Dispatch(uint32_t GroupsX, uint32_t GroupsY = 1, uint32_t GroupsZ = 1) const;
+
+    void SetUInt(const char* Name, uint32_t Value) const;
+    void SetInt(const char* Name, int Value) const;
+    void SetFloat(const char* Name, float Value) const;
+    void SetIVec2(const char* Name, int X, int Y) const;
+    void SetVec2(const char* Name, const Vec2& Value) const;
+    void SetVec3(const char* Name, const Vec3& Value) const;
+    void SetVec4Array(const char* Name, const Vec4* Values, int Count) const;
+    void SetMat4(const char* Name, const Mat4& Value) const;
+
+    static uint32_t GetGroupCount(uint32_t Items, uint32_t GroupSize) { return (Items + GroupSize - 1) / GroupSize; }
+
+private:
+    unsigned int Program = 0;
+};
+
+} // namespace Volante
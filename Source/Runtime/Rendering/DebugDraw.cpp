@@ -0,0 +1,383 @@
+#include "DebugDraw.h"
+
+#if VOLANTE_DEBUG_DRAW
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+#include "DepthConvention.h"
+#include "RenderView.h"
+#include "Shader.h"
+#include "UploadRing.h"
+
+namespace Volante {
+
+namespace {
+
+struct LineVertex {
+    Vec3 Position;
+    uint32_t Color;
+};
+
+// Screen-aligned: Offset is in pixels from the projected anchor
+struct TextVertex {
+    Vec3 Anchor;
+    Vec2 Offset;
+    uint32_t Color;
+};
+
+constexpr size_t DepthModeCount = 2;
+
+struct DebugDrawBuffer {
+    std::mutex Mutex;
+    std::vector<LineVertex> Lines[DepthModeCount];
+    std::vector<TextVertex> Text[DepthModeCount];
+
+    [[nodiscard]] bool IsEmpty() const {
+        for (size_t Depth = 0; Depth < DepthModeCount; ++Depth) {
+            if (!Lines[Depth].empty() || !Text[Depth].empty()) { return false; }
+        }
+        return true;
+    }
+};
+
+// Every thread's buffer, plus the merged copy Render builds under the lock. A thread only
+// takes the registry lock once, to register; after that it contends with Render alone.
+struct DebugDrawRegistry {
+    std::mutex Mutex;
+    std::vector<std::shared_ptr<DebugDrawBuffer>> Buffers;
+    DebugDrawBuffer Merged;
+};
+
+DebugDrawRegistry& GetRegistry() {
+    static DebugDrawRegistry Registry;
+    return Registry;
+}
+
+DebugDrawBuffer& GetThreadBuffer() {
+    thread_local const std::shared_ptr<DebugDrawBuffer> Buffer = [] {
+        auto NewBuffer = std::make_shared<DebugDrawBuffer>();
+        DebugDrawRegistry& Registry = GetRegistry();
+        std::lock_guard Lock(Registry.Mutex);
+        Registry.Buffers.push_back(NewBuffer);
+        return NewBuffer;
+    }();
+    return *Buffer;
+}
+
+// RGBA8, read back as normalized unsigned bytes
+uint32_t PackColor(const Vec4& Color) {
+    const auto Channel = [](float Value) { return static_cast<uint32_t>(std::clamp(Value, 0.0f, 1.0f) * 255.0f + 0.5f); };
+    return Channel(Color.x) | Channel(Color.y) << 8 | Channel(Color.z) << 16 | Channel(Color.w) << 24;
+}
+
+// 3x5 glyphs for ' ' .. '_', row-major from the top-left corner in bits 14 .. 0
+constexpr uint16_t Glyphs[64] = {
+    0x0000, 0x2482, 0x5A00, 0x5F7D, 0x3C9E, 0x42A1, 0x2AAB, 0x2400,
+    0x1491, 0x4494, 0x0AA8, 0x05D0, 0x0014, 0x01C0, 0x0002, 0x12A4,
+    0x7B6F, 0x2C97, 0x73E7, 0x73CF, 0x5BC9, 0x79CF, 0x79EF, 0x7252,
+    0x7BEF, 0x7BCF, 0x0410, 0x0414, 0x1511, 0x0E38, 0x4454, 0x6282,
+    0x7B67, 0x2BED, 0x6BAE, 0x3923, 0x6B6E, 0x79A7, 0x79A4, 0x396B,
+    0x5BED, 0x7497, 0x126A, 0x5BAD, 0x4927, 0x5FED, 0x6B6D, 0x2B6A,
+    0x6BA4, 0x2B73, 0x6BAD, 0x388E, 0x7492, 0x5B6F, 0x5B6A, 0x5BFD,
+    0x5AAD, 0x5A92, 0x72A7, 0x6926, 0x4889, 0x324B, 0x2A00, 0x0007,
+};
+
+constexpr uint32_t GlyphWidth = 3;
+constexpr uint32_t GlyphHeight = 5;
+
+uint16_t GetGlyph(char Character) {
+    if (Character >= 'a' && Character <= 'z') { Character = static_cast<char>(Character - 'a' + 'A'); }
+    if (Character < ' ' || Character > '_') { Character = '?'; }
+    return Glyphs[Character - ' '];
+}
+
+} // namespace
+
+void DebugDraw::Line(const Vec3& From, const Vec3& To, const Vec4& Color, DebugDepth Depth) {
+    const uint32_t Packed = PackColor(Color);
+    DebugDrawBuffer& Buffer = GetThreadBuffer();
+    std::lock_guard Lock(Buffer.Mutex);
+    std::vector<LineVertex>& Lines = Buffer.Lines[static_cast<size_t>(Depth)];
+    Lines.push_back({From, Packed});
+    Lines.push_back({To, Packed});
+}
+
+void DebugDraw::Box(const AABB& Bounds, const Vec4& Color, DebugDepth Depth) {
+    const uint32_t Packed = PackColor(Color);
+    const auto Corner = [&Bounds](int Index) {
+        return Vec3(Index & 1 ? Bounds.Max.x : Bounds.Min.x, Index & 2 ? Bounds.Max.y : Bounds.Min.y,
+                    Index & 4 ? Bounds.Max.z : Bounds.Min.z);
+    };
+    DebugDrawBuffer& Buffer = GetThreadBuffer();
+    std::lock_guard Lock(Buffer.Mutex);
+    std::vector<LineVertex>& Lines = Buffer.Lines[static_cast<size_t>(Depth)];
+    // Each edge joins two corners that differ in one bit
+    for (int Index = 0; Index < 8; ++Index) {
+        for (int Axis = 1; Axis < 8; Axis <<= 1) {
+            if ((Index & Axis) != 0) { continue; }
+            Lines.push_back({Corner(Index), Packed});
+            Lines.push_back({Corner(Index | Axis), Packed});
+        }
+    }
+}
+
+void DebugDraw::Sphere(const Vec3& Center, float Radius, const Vec4& Color, DebugDepth Depth, uint32_t Segments) {
+    Segments = std::max(Segments, 3u);
+    const uint32_t Packed = PackColor(Color);
+    const float Step = glm::two_pi<float>() / static_cast<float>(Segments);
+    DebugDrawBuffer& Buffer = GetThreadBuffer();
+    std::lock_guard Lock(Buffer.Mutex);
+    std::vector<LineVertex>& Lines = Buffer.Lines[static_cast<size_t>(Depth)];
+    Lines.reserve(Lines.size() + Segments * 6);
+    float PreviousCos = Radius;
+    float PreviousSin = 0.0f;
+    for (uint32_t i = 1; i <= Segments; ++i) {
+        const float Cos = Radius * std::cos(Step * static_cast<float>(i));
+        const float Sin = Radius * std::sin(Step * static_cast<float>(i));
+        Lines.push_back({Center + Vec3(PreviousCos, PreviousSin, 0.0f), Packed});
+        Lines.push_back({Center + Vec3(Cos, Sin, 0.0f), Packed});
+        Lines.push_back({Center + Vec3(PreviousCos, 0.0f, PreviousSin), Packed});
+        Lines.push_back({Center + Vec3(Cos, 0.0f, Sin), Packed});
+        Lines.push_back({Center + Vec3(0.0f, PreviousCos, PreviousSin), Packed});
+        Lines.push_back({Center + Vec3(0.0f, Cos, Sin), Packed});
+        PreviousCos = Cos;
+        PreviousSin = Sin;
+    }
+}
+
+void DebugDraw::Frustum(const Mat4& ViewProjection, const Vec4& Color, DebugDepth Depth) {
+    const uint32_t Packed = PackColor(Color);
+    const Mat4 Inverse = glm::inverse(ViewProjection);
+    Vec3 Corners[8];
+    for (int Index = 0; Index < 8; ++Index) {
+        // Reverse-Z: near at depth 1, far at 0. An infinite projection's far corners are at
+        // infinity, so they are drawn at depth 1e-4, ten thousand near distances out.
+        Vec4 Clip(Index & 1 ? 1.0f : -1.0f, Index & 2 ? 1.0f : -1.0f, Index & 4 ? FarDepth : NearDepth, 1.0f);
+        Vec4 World = Inverse * Clip;
+        if (std::abs(World.w) < 1e-12f) {
+            Clip.z = 1e-4f;
+            World = Inverse * Clip;
+        }
+        Corners[Index] = Vec3(World) / World.w;
+    }
+    DebugDrawBuffer& Buffer = GetThreadBuffer();
+    std::lock_guard Lock(Buffer.Mutex);
+    std::vector<LineVertex>& Lines = Buffer.Lines[static_cast<size_t>(Depth)];
+    for (int Index = 0; Index < 8; ++Index) {
+        for (int Axis = 1; Axis < 8; Axis <<= 1) {
+            if ((Index & Axis) != 0) { continue; }
+            Lines.push_back({Corners[Index], Packed});
+            Lines.push_back({Corners[Index | Axis], Packed});
+        }
+    }
+}
+
+void DebugDraw::Text(const Vec3& Position, std::string_view String, const Vec4& Color, DebugDepth Depth, float Scale) {
+    const uint32_t Packed = PackColor(Color);
+    const float Pixel = 2.0f * Scale;
+    DebugDrawBuffer& Buffer = GetThreadBuffer();
+    std::lock_guard Lock(Buffer.Mutex);
+    std::vector<TextVertex>& Text = Buffer.Text[static_cast<size_t>(Depth)];
+    float PenX = 0.0f;
+    float PenY = 0.0f;
+    for (const char Character : String) {
+        if (Character == '\n') {
+            PenX = 0.0f;
+            PenY -= static_cast<float>(GlyphHeight + 1) * Pixel;
+            continue;
+        }
+        // One quad per horizontal run of set pixels
+        const uint16_t Glyph = GetGlyph(Character);
+        for (uint32_t Row = 0; Row < GlyphHeight; ++Row) {
+            const uint32_t Bits = (Glyph >> ((GlyphHeight - 1 - Row) * GlyphWidth)) & 0x7u;
+            uint32_t Column = 0;
+            while (Column < GlyphWidth) {
+                if ((Bits & (4u >> Column)) == 0) {
+                    ++Column;
+                    continue;
+                }
+                const uint32_t RunBegin = Column;
+                while (Column < GlyphWidth && (Bits & (4u >> Column)) != 0) {
+                    ++Column;
+                }
+                const float X0 = PenX + static_cast<float>(RunBegin) * Pixel;
+                const float X1 = PenX + static_cast<float>(Column) * Pixel;
+                const float Y1 = PenY - static_cast<float>(Row) * Pixel;
+                const float Y0 = Y1 - Pixel;
+                for (const Vec2 Corner : {Vec2(X0, Y0), Vec2(X1, Y0), Vec2(X1, Y1), Vec2(X0, Y0), Vec2(X1, Y1), Vec2(X0, Y1)}) {
+                    Text.push_back({Position, Corner, Packed});
+                }
+            }
+        }
+        PenX += static_cast<float>(GlyphWidth + 1) * Pixel;
+    }
+}
+
+DebugDrawRenderer::DebugDrawRenderer(ShaderLibrary& Shaders) : Shaders(Shaders) {}
+
+DebugDrawRenderer::~DebugDrawRenderer() {
+    Shutdown();
+}
+
+bool DebugDrawRenderer::Initialize() {
+    const std::string& Directory = ShaderLibrary::GetShaderDirectory();
+    LineShader = Shaders.Load({Directory + "/DebugLine.vert", Directory + "/DebugColor.frag"});
+    TextShader = Shaders.Load({Directory + "/DebugText.vert", Directory + "/DebugColor.frag"});
+    glGenVertexArrays(2, VertexArrays);
+    for (const GLuint VertexArray : VertexArrays) {
+        glBindVertexArray(VertexArray);
+        glEnableVertexAttribArray(0);
+        glEnableVertexAttribArray(1);
+    }
+    glEnableVertexAttribArray(2);
+    glBindVertexArray(0);
+    return true;
+}
+
+void DebugDrawRenderer::Shutdown() {
+    for (ShaderProgramId* Program : {&LineShader, &TextShader}) {
+        Shaders.Unload(*Program);
+        *Program = InvalidShaderProgramId;
+    }
+    if (VertexArrays[0] != 0) { glDeleteVertexArrays(2, VertexArrays); }
+    VertexArrays[0] = VertexArrays[1] = 0;
+}
+
+void DebugDrawRenderer::Render(const RenderView& View, UploadRing& Uploads) {
+    Stats = {};
+    if (VertexArrays[0] == 0) { return; }
+
+    // Merge every thread's primitives, then one allocation per vertex type holds both depth
+    // modes back to back.
+    DebugDrawRegistry& Registry = GetRegistry();
+    std::lock_guard Lock(Registry.Mutex);
+    DebugDrawBuffer& Merged = Registry.Merged;
+    for (size_t i = 0; i < Registry.Buffers.size();) {
+        DebugDrawBuffer& Buffer = *Registry.Buffers[i];
+        {
+            std::lock_guard BufferLock(Buffer.Mutex);
+            for (size_t Depth = 0; Depth < DepthModeCount; ++Depth) {
+                Merged.Lines[Depth].insert(Merged.Lines[Depth].end(), Buffer.Lines[Depth].begin(), Buffer.Lines[Depth].end());
+                Merged.Text[Depth].insert(Merged.Text[Depth].end(), Buffer.Text[Depth].begin(), Buffer.Text[Depth].end());
+                Buffer.Lines[Depth].clear();
+                Buffer.Text[Depth].clear();
+            }
+        }
+        // The thread has exited
+        if (Registry.Buffers[i].use_count() == 1) {
+            Registry.Buffers[i] = std::move(Registry.Buffers.back());
+            Registry.Buffers.pop_back();
+        } else {
+            ++i;
+        }
+    }
+    if (Merged.IsEmpty()) { return; }
+
+    const size_t LineCounts[DepthModeCount] = {Merged.Lines[0].size(), Merged.Lines[1].size()};
+    const size_t TextCounts[DepthModeCount] = {Merged.Text[0].size(), Merged.Text[1].size()};
+    UploadAllocation LineData;
+    UploadAllocation TextData;
+    if (LineCounts[0] + LineCounts[1] > 0) {
+        LineData = Uploads.Allocate((LineCounts[0] + LineCounts[1]) * sizeof(LineVertex));
+        if (LineData) {
+            auto* Out = static_cast<LineVertex*>(LineData.Data);
+            std::memcpy(Out, Merged.Lines[0].data(), LineCounts[0] * sizeof(LineVertex));
+            std::memcpy(Out + LineCounts[0], Merged.Lines[1].data(), LineCounts[1] * sizeof(LineVertex));
+        }
+    }
+    if (TextCounts[0] + TextCounts[1] > 0) {
+        TextData = Uploads.Allocate((TextCounts[0] + TextCounts[1]) * sizeof(TextVertex));
+        if (TextData) {
+            auto* Out = static_cast<TextVertex*>(TextData.Data);
+            std::memcpy(Out, Merged.Text[0].data(), TextCounts[0] * sizeof(TextVertex));
+            std::memcpy(Out + TextCounts[0], Merged.Text[1].data(), TextCounts[1] * sizeof(TextVertex));
+        }
+    }
+    Uploads.Flush();
+    for (size_t Depth = 0; Depth < DepthModeCount; ++Depth) {
+        Merged.Lines[Depth].clear();
+        Merged.Text[Depth].clear();
+    }
+    Stats.LineCount = static_cast<uint32_t>((LineCounts[0] + LineCounts[1]) / 2);
+    Stats.TextQuadCount = static_cast<uint32_t>((TextCounts[0] + TextCounts[1]) / 6);
+
+    const GLboolean DepthTest = glIsEnabled(GL_DEPTH_TEST);
+    const GLboolean Blend = glIsEnabled(GL_BLEND);
+    const GLboolean CullFace = glIsEnabled(GL_CULL_FACE);
+    GLboolean DepthMask = GL_TRUE;
+    glGetBooleanv(GL_DEPTH_WRITEMASK, &DepthMask);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glDisable(GL_CULL_FACE);
+    glDepthMask(GL_FALSE);
+
+    // Tested first, then overlay, each one draw
+    const auto DrawRanges = [this](GLenum Mode, const size_t* Counts) {
+        size_t First = 0;
+        for (size_t Depth = 0; Depth < DepthModeCount; ++Depth) {
+            if (Counts[Depth] == 0) { continue; }
+            if (static_cast<DebugDepth>(Depth) == DebugDepth::Tested) {
+                glEnable(GL_DEPTH_TEST);
+            } else {
+                glDisable(GL_DEPTH_TEST);
+            }
+            glDrawArrays(Mode, static_cast<GLint>(First), static_cast<GLsizei>(Counts[Depth]));
+            First += Counts[Depth];
+            ++Stats.DrawCount;
+        }
+    };
+    // Either program is missing only while its files have never compiled
+    const Shader* LineProgram = Shaders.Get(LineShader);
+    const Shader* TextProgram = Shaders.Get(TextShader);
+    if (LineData && LineProgram) {
+        LineProgram->use();
+        LineProgram->setMat4("uViewProjection", View.RelativeViewProjection);
+        LineProgram->setVec3("uViewOrigin", View.Origin);
+        glBindVertexArray(VertexArrays[0]);
+        glBindBuffer(GL_ARRAY_BUFFER, LineData.Buffer);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(LineVertex),
+                              reinterpret_cast<void*>(LineData.Offset + offsetof(LineVertex, Position)));
+        glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(LineVertex),
+                              reinterpret_cast<void*>(LineData.Offset + offsetof(LineVertex, Color)));
+        DrawRanges(GL_LINES, LineCounts);
+    }
+    if (TextData && TextProgram) {
+        GLint Viewport[4] = {0, 0, 1, 1};
+        glGetIntegerv(GL_VIEWPORT, Viewport);
+        TextProgram->use();
+        TextProgram->setMat4("uViewProjection", View.RelativeViewProjection);
+        TextProgram->setVec3("uViewOrigin", View.Origin);
+        TextProgram->setVec2("uPixelToClip", Vec2(2.0f / static_cast<float>(std::max(Viewport[2], 1)),
+                                                  2.0f / static_cast<float>(std::max(Viewport[3], 1))));
+        glBindVertexArray(VertexArrays[1]);
+        glBindBuffer(GL_ARRAY_BUFFER, TextData.Buffer);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(TextVertex),
+                              reinterpret_cast<void*>(TextData.Offset + offsetof(TextVertex, Anchor)));
+        glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(TextVertex),
+                              reinterpret_cast<void*>(TextData.Offset + offsetof(TextVertex, Color)));
+        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(TextVertex),
+                              reinterpret_cast<void*>(TextData.Offset + offsetof(TextVertex, Offset)));
+        DrawRanges(GL_TRIANGLES, TextCounts);
+    }
+    glBindVertexArray(0);
+
+    if (DepthTest) {
+        glEnable(GL_DEPTH_TEST);
+    } else {
+        glDisable(GL_DEPTH_TEST);
+    }
+    if (!Blend) { glDisable(GL_BLEND); }
+    if (CullFace) { glEnable(GL_CULL_FACE); }
+    glDepthMask(DepthMask);
+}
+
+} // namespace Volante
+
+#endif
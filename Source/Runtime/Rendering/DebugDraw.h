@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+#include "Runtime/Core/Math/Bounds.h"
+#include "ShaderLibrary.h"
+
+// Debug drawing is on unless NDEBUG; define VOLANTE_DEBUG_DRAW to 0 or 1 to override. When it
+// is off every DebugDraw call is an empty inline function and no renderer is created.
+#if !defined(VOLANTE_DEBUG_DRAW)
+#if defined(NDEBUG)
+#define VOLANTE_DEBUG_DRAW 0
+#else
+#define VOLANTE_DEBUG_DRAW 1
+#endif
+#endif
+
+namespace Volante {
+
+class UploadRing;
+struct RenderView;
+
+enum class DebugDepth : uint8_t {
+    // Hidden behind scene geometry
+    Tested,
+    // Drawn on top of everything
+    Overlay,
+};
+
+// Immediate-mode debug primitives for the current frame, callable from any thread. Each thread
+// appends to its own buffers; the renderer merges them once per frame into one upload and one
+// draw per primitive type and depth mode.
+//
+// Arguments are still evaluated when debug drawing is compiled out; guard expensive ones with
+// `if constexpr (DebugDraw::Enabled)`.
+class DebugDraw {
+public:
+    static constexpr bool Enabled = VOLANTE_DEBUG_DRAW != 0;
+
+#if VOLANTE_DEBUG_DRAW
+    static void Line(const Vec3& From, const Vec3& To, const Vec4& Color, DebugDepth Depth = DebugDepth::Tested);
+    static void Box(const AABB& Bounds, const Vec4& Color, DebugDepth Depth = DebugDepth::Tested);
+    // Three great circles
+    static void Sphere(const Vec3& Center, float Radius, const Vec4& Color, DebugDepth Depth = DebugDepth::Tested,
+                       uint32_t Segments = 24);
+    // The twelve edges of the frustum ViewProjection maps to clip space
+    static void Frustum(const Mat4& ViewProjection, const Vec4& Color, DebugDepth Depth = DebugDepth::Tested);
+    // Screen-aligned 3x5 pixel glyphs (upper case ASCII; lower case is folded) whose top-left
+    // corner sits at Position. Scale multiplies the glyph pixel size of 2.
+    static void Text(const Vec3& Position, std::string_view String, const Vec4& Color,
+                     DebugDepth Depth = DebugDepth::Overlay, float Scale = 1.0f);
+#else
+    static void Line(const Vec3&, const Vec3&, const Vec4&, DebugDepth = DebugDepth::Tested) {}
+    static void Box(const AABB&, const Vec4&, DebugDepth = DebugDepth::Tested) {}
+    static void Sphere(const Vec3&, float, const Vec4&, DebugDepth = DebugDepth::Tested, uint32_t = 24) {}
+    static void Frustum(const Mat4&, const Vec4&, DebugDepth = DebugDepth::Tested) {}
+    static void Text(const Vec3&, std::string_view, const Vec4&, DebugDepth = DebugDepth::Overlay, float = 1.0f) {}
+#endif
+};
+
+#if VOLANTE_DEBUG_DRAW
+
+struct DebugDrawStats {
+    uint32_t LineCount = 0;
+    uint32_t TextQuadCount = 0;
+    uint32_t DrawCount = 0;
+};
+
+// Draws and clears everything DebugDraw collected since the last Render, with DebugLine.vert,
+// DebugText.vert and DebugColor.frag loaded through Shaders.
+class DebugDrawRenderer {
+public:
+    explicit DebugDrawRenderer(ShaderLibrary& Shaders);
+    ~DebugDrawRenderer();
+
+    DebugDrawRenderer(const DebugDrawRenderer&) = delete;
+    DebugDrawRenderer& operator=(const DebugDrawRenderer&) = delete;
+
+    bool Initialize();
+    void Shutdown();
+
+    // Into the bound framebuffer and viewport, after the scene so depth testing sees it.
+    void Render(const RenderView& View, UploadRing& Uploads);
+
+    [[nodiscard]] const DebugDrawStats& GetStats() const { return Stats; }
+
+private:
+    ShaderLibrary& Shaders;
+    ShaderProgramId LineShader = InvalidShaderProgramId;
+    ShaderProgramId TextShader = InvalidShaderProgramId;
+    unsigned int VertexArrays[2] = {0, 0};
+    DebugDrawStats Stats;
+};
+
+#endif
+
+} // namespace Volante
@@ -0,0 +1,71 @@
+#include "DepthConvention.h"
+
+#include <glad/glad.h>
+
+#include <cmath>
+
+#include "GLCapabilities.h"
+
+namespace Volante {
+
+Mat4 MakeReverseZPerspective(float FovY, float AspectRatio, float Near, float Far) {
+    const float Focal = 1.0f / std::tan(FovY * 0.5f);
+    Mat4 Result(0.0f);
+    Result[0][0] = Focal / AspectRatio;
+    Result[1][1] = Focal;
+    Result[2][3] = -1.0f;
+    if (std::isfinite(Far)) {
+        // Depth Near / d remapped so that Far lands on 0
+        Result[2][2] = Near / (Far - Near);
+        Result[3][2] = Near * Far / (Far - Near);
+    } else {
+        Result[3][2] = Near;
+    }
+    return Result;
+}
+
+Mat4 MakeReverseZOrthographic(float Left, float Right, float Bottom, float Top, float Near, float Far) {
+    Mat4 Result(1.0f);
+    Result[0][0] = 2.0f / (Right - Left);
+    Result[1][1] = 2.0f / (Top - Bottom);
+    Result[2][2] = 1.0f / (Far - Near);
+    Result[3][0] = -(Right + Left) / (Right - Left);
+    Result[3][1] = -(Top + Bottom) / (Top - Bottom);
+    Result[3][2] = Far / (Far - Near);
+    return Result;
+}
+
+void GetProjectionDepthRange(const Mat4& Projection, float& Near, float& Far) {
+    // Both conventions give clip depth B / d - A at distance d
+    const float A = Projection[2][2];
+    const float B = Projection[3][2];
+    if (A >= 0.0f) {
+        // Reverse-Z: Near at 1 and Far at 0
+        Near = B / (A + 1.0f);
+        Far = A > 0.0f ? B / A : std::numeric_limits<float>::infinity();
+    } else {
+        // GL: Near at -1 and Far at 1
+        Near = B / (A - 1.0f);
+        Far = B / (A + 1.0f);
+    }
+    if (!(Far > 0.0f) || !std::isfinite(Far)) { Far = std::numeric_limits<float>::infinity(); }
+}
+
+void ApplyReverseZ() {
+#if defined(GL_VERSION_4_5) || defined(GL_ARB_clip_control)
+    if (GLCapabilities::Get().ClipControl) { glClipControl(GL_LOWER_LEFT, GL_ZERO_TO_ONE); }
+#endif
+    glDepthFunc(GL_GREATER);
+    glClearDepth(FarDepth);
+}
+
+const Mat4& GetClipToTexture() {
+    static const Mat4 ClipToTexture = [] {
+        const float DepthScale = GLCapabilities::Get().ClipControl ? 1.0f : 0.5f;
+        return Mat4(Vec4(0.5f, 0.0f, 0.0f, 0.0f), Vec4(0.0f, 0.5f, 0.0f, 0.0f), Vec4(0.0f, 0.0f, DepthScale, 0.0f),
+                    Vec4(0.5f, 0.5f, 1.0f - DepthScale, 1.0f));
+    }();
+    return ClipToTexture;
+}
+
+} // namespace Volante
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <limits>
+
+#include "Volante.h"
+
+namespace Volante {
+
+// Every pass renders reverse-Z: projections map the near plane to clip depth 1 and the far
+// plane (or infinity) to 0, depth tests pass on GREATER and buffers clear to FarDepth. With a
+// 32-bit float depth buffer the float exponent then cancels the 1/z falloff, so precision is
+// nearly uniform in distance and z-fighting disappears even with an infinite far plane.
+//
+// Projections built here always produce clip depth in [0, w]. ApplyReverseZ switches the
+// context to a [0, 1] clip range (GL 4.5 or ARB_clip_control) so that range reaches the depth
+// buffer unchanged; without it, GL's [-1, 1] range maps it to [0.5, 1], which still orders
+// correctly but with far less precision. GetClipToTexture accounts for either.
+constexpr float FarDepth = 0.0f;
+constexpr float NearDepth = 1.0f;
+
+// Perspective projection with the far plane at infinity unless Far is given.
+[[nodiscard]] Mat4 MakeReverseZPerspective(float FovY, float AspectRatio, float Near,
+                                           float Far = std::numeric_limits<float>::infinity());
+
+[[nodiscard]] Mat4 MakeReverseZOrthographic(float Left, float Right, float Bottom, float Top, float Near, float Far);
+
+// Near and far plane distances of a perspective projection, reverse-Z or GL [-1, 1]. Far is
+// infinity for an infinite projection.
+void GetProjectionDepthRange(const Mat4& Projection, float& Near, float& Far);
+
+// Clip control, depth function and clear depth for the current context.
+void ApplyReverseZ();
+
+// Maps clip space to [0, 1] texture coordinates in x and y and to the depth the buffer holds
+// in z, for sampling depth textures and depth pyramids.
+[[nodiscard]] const Mat4& GetClipToTexture();
+
+} // namespace Volante
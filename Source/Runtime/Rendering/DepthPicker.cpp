@@ -0,0 +1,119 @@
+#include "DepthPicker.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "FrameGraph.h"
+#include "GPUReadback.h"
+#include "PostProcessStack.h"
+
+namespace Volante {
+
+DepthPicker::DepthPicker(GPUReadback& Readback) : Readback(Readback) {}
+
+DepthPicker::~DepthPicker() {
+    Shutdown();
+}
+
+void DepthPicker::Shutdown() {
+    Requests.clear();
+    Issued.clear();
+    if (ResolveTexture != 0) { glDeleteTextures(1, &ResolveTexture); }
+    if (ResolveFramebuffer != 0) { glDeleteFramebuffers(1, &ResolveFramebuffer); }
+    if (SourceFramebuffer != 0) { glDeleteFramebuffers(1, &SourceFramebuffer); }
+    ResolveTexture = 0;
+    ResolveFramebuffer = 0;
+    SourceFramebuffer = 0;
+}
+
+void DepthPicker::Request(int X, int Y, Callback Done) {
+    Requests.push_back({X, Y, std::move(Done)});
+}
+
+void DepthPicker::AddPasses(FrameGraph& Graph, const PostProcessStack& Post, int OutputWidth, int OutputHeight) {
+    const FrameGraphResource Depth = Post.GetSceneDepth();
+    if (Requests.empty() || !Depth || OutputWidth <= 0 || OutputHeight <= 0) { return; }
+
+    const size_t Count = std::min<size_t>(Requests.size(), MaxPicksPerFrame);
+    Issued.assign(std::make_move_iterator(Requests.begin()), std::make_move_iterator(Requests.begin() + Count));
+    Requests.erase(Requests.begin(), Requests.begin() + Count);
+
+    int RenderWidth = 0;
+    int RenderHeight = 0;
+    Post.GetRenderSize(OutputWidth, OutputHeight, RenderWidth, RenderHeight);
+    // Unprojected when the depth arrives, through the view this frame is drawn from
+    const Mat4 TextureToRelative = glm::inverse(GetClipToTexture() * Post.GetViewProjection());
+    const Vec3 Origin = Post.GetViewOrigin();
+
+    Graph.AddPass(
+        "DepthPick",
+        [&](FrameGraphBuilder& Builder) {
+            Builder.Read(Depth);
+            Builder.SetSideEffect();
+        },
+        [this, Depth, OutputWidth, OutputHeight, RenderWidth, RenderHeight, TextureToRelative, Origin](const FrameGraph& Graph) {
+            const bool Multisampled = Graph.GetDesc(Depth).Samples > 1;
+            if (Multisampled) {
+                if (ResolveTexture == 0) { CreateResolveTarget(); }
+                glBindFramebuffer(GL_READ_FRAMEBUFFER, SourceFramebuffer);
+                glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D_MULTISAMPLE, Graph.GetTexture(Depth), 0);
+                glBindFramebuffer(GL_DRAW_FRAMEBUFFER, ResolveFramebuffer);
+            }
+            for (int Index = 0; Index < static_cast<int>(Issued.size()); ++Index) {
+                PickRequest& Pick = Issued[Index];
+                // The scene renders at the render scale into the lower-left of its targets
+                const int X = std::clamp(Pick.X * RenderWidth / OutputWidth, 0, RenderWidth - 1);
+                const int Y = std::clamp(Pick.Y * RenderHeight / OutputHeight, 0, RenderHeight - 1);
+                const Vec2 Texcoord((static_cast<float>(X) + 0.5f) / static_cast<float>(RenderWidth),
+                                    (static_cast<float>(Y) + 0.5f) / static_cast<float>(RenderHeight));
+                auto Done = [Pick = std::move(Pick), Texcoord, TextureToRelative, Origin](std::vector<uint8_t>& Pixels) {
+                    DepthPick Result;
+                    Result.X = Pick.X;
+                    Result.Y = Pick.Y;
+                    if (Pixels.size() == sizeof(float)) { std::memcpy(&Result.Depth, Pixels.data(), sizeof(float)); }
+                    Result.Hit = Result.Depth != FarDepth;
+                    if (Result.Hit) {
+                        const Vec4 Relative = TextureToRelative * Vec4(Texcoord.x, Texcoord.y, Result.Depth, 1.0f);
+                        Result.Position = Origin + Vec3(Relative) / Relative.w;
+                    }
+                    if (Pick.Done) { Pick.Done(Result); }
+                };
+                if (Multisampled) {
+                    glBlitFramebuffer(X, Y, X + 1, Y + 1, Index, 0, Index + 1, 1, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+                    Readback.ReadTexture(ResolveTexture, Index, 0, 1, 1, GL_DEPTH_COMPONENT, GL_FLOAT, std::move(Done));
+                } else {
+                    Readback.ReadTexture(Graph.GetTexture(Depth), X, Y, 1, 1, GL_DEPTH_COMPONENT, GL_FLOAT, std::move(Done));
+                }
+            }
+            Issued.clear();
+            if (Multisampled) {
+                glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D_MULTISAMPLE, 0, 0);
+                glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            }
+        });
+}
+
+void DepthPicker::CreateResolveTarget() {
+    glGenTextures(1, &ResolveTexture);
+    glBindTexture(GL_TEXTURE_2D, ResolveTexture);
+    // The scene's depth format, which a depth blit must match
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT32F, MaxPicksPerFrame, 1, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glGenFramebuffers(1, &ResolveFramebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, ResolveFramebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, ResolveTexture, 0);
+    glDrawBuffer(GL_NONE);
+    glReadBuffer(GL_NONE);
+    glGenFramebuffers(1, &SourceFramebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, SourceFramebuffer);
+    glDrawBuffer(GL_NONE);
+    glReadBuffer(GL_NONE);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+} // namespace Volante
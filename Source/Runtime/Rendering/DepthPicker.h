@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "DepthConvention.h"
+#include "Volante.h"
+
+namespace Volante {
+
+class FrameGraph;
+class GPUReadback;
+class PostProcessStack;
+
+struct DepthPick {
+    // The output pixel asked about, lower-left origin
+    int X = 0;
+    int Y = 0;
+    // Something was drawn there; otherwise Depth is FarDepth and Position meaningless
+    bool Hit = false;
+    // As the depth buffer holds it: reverse-Z, NearDepth to FarDepth
+    float Depth = FarDepth;
+    // World position under the pixel, through the main view
+    Vec3 Position = Vec3(0.0f);
+};
+
+// Depth and world position under output pixels, e.g. for mouse picking, read from the scene's
+// depth target through GPUReadback: a pick never stalls, and its callback runs from the
+// readback's Poll a frame or two after the request. Multisampled depth is first copied out of
+// the target a pixel at a time, taking one sample. Positions assume the pixel lies in the main
+// view; with several views, unproject Depth through the one that covers it.
+class DepthPicker {
+public:
+    using Callback = std::function<void(const DepthPick& Pick)>;
+
+    static constexpr uint32_t MaxPicksPerFrame = 16;
+
+    explicit DepthPicker(GPUReadback& Readback);
+    ~DepthPicker();
+
+    DepthPicker(const DepthPicker&) = delete;
+    DepthPicker& operator=(const DepthPicker&) = delete;
+
+    void Shutdown();
+
+    // Read with the next frame, or a later one past MaxPicksPerFrame.
+    void Request(int X, int Y, Callback Done);
+
+    // After the post stack's passes, for an output of OutputWidth x OutputHeight: reads this
+    // frame's scene depth under the requested pixels.
+    void AddPasses(FrameGraph& Graph, const PostProcessStack& Post, int OutputWidth, int OutputHeight);
+
+    // Requested and not yet read
+    [[nodiscard]] uint32_t GetRequestCount() const { return static_cast<uint32_t>(Requests.size()); }
+
+private:
+    struct PickRequest {
+        int X = 0;
+        int Y = 0;
+        Callback Done;
+    };
+
+    void CreateResolveTarget();
+
+    GPUReadback& Readback;
+    std::vector<PickRequest> Requests;
+    // This frame's, read by its pass
+    std::vector<PickRequest> Issued;
+
+    // Multisampled depth: each pick's pixel is blitted into a texel of a row of its own
+    unsigned int ResolveTexture = 0;
+    unsigned int ResolveFramebuffer = 0;
+    unsigned int SourceFramebuffer = 0;
+};
+
+} // namespace Volante
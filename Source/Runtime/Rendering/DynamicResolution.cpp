@@ -0,0 +1,57 @@
+#include "DynamicResolution.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Volante {
+
+DynamicResolution::DynamicResolution(const DynamicResolutionDesc& Desc) : Desc(Desc) {
+    Scale = Quantize(Desc.MaxScale);
+}
+
+float DynamicResolution::Update(float GpuMs) {
+    if (!Desc.Enabled) {
+        Scale = Quantize(Desc.MaxScale);
+        return Scale;
+    }
+    ++FramesSinceChange;
+    // Frames rendered at the previous scale are still arriving
+    if (FramesSinceChange <= Desc.SettleFrames || GpuMs <= 0.0f) { return Scale; }
+    SmoothedMs = SmoothedMs > 0.0f ? SmoothedMs + (GpuMs - SmoothedMs) * Desc.Smoothing : GpuMs;
+
+    const float Step = std::max(Desc.Step, 1e-3f);
+    float Target = Scale;
+    // Rounded down to whole steps (the epsilon keeps Scale itself from rounding a step under)
+    if (SmoothedMs > Desc.BudgetMs) {
+        const float Fit = Scale * std::sqrt(Desc.BudgetMs / SmoothedMs);
+        Target = std::min(std::floor(Fit / Step + 1e-3f) * Step, Scale - Step);
+    } else if (SmoothedMs < Desc.BudgetMs * Desc.Headroom) {
+        const float Fit = Scale * std::sqrt(Desc.BudgetMs * Desc.Headroom / SmoothedMs);
+        Target = std::max(std::floor(std::min(Fit, Scale + Desc.MaxIncrease) / Step + 1e-3f) * Step, Scale);
+    }
+    Target = Quantize(Target);
+    if (Target == Scale) { return Scale; }
+
+    Scale = Target;
+    Invalidate();
+    return Scale;
+}
+
+void DynamicResolution::Invalidate() {
+    FramesSinceChange = 0;
+    SmoothedMs = 0.0f;
+}
+
+void DynamicResolution::SetDesc(const DynamicResolutionDesc& InDesc) {
+    Desc = InDesc;
+    Scale = Quantize(Scale);
+    Invalidate();
+}
+
+float DynamicResolution::Quantize(float Value) const {
+    const float Step = std::max(Desc.Step, 1e-3f);
+    const float Stepped = std::round(Value / Step) * Step;
+    return std::clamp(Stepped, Desc.MinScale, std::max(Desc.MaxScale, Desc.MinScale));
+}
+
+} // namespace Volante
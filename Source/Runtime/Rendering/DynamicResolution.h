@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Volante {
+
+struct DynamicResolutionDesc {
+    bool Enabled = false;
+    // GPU time per frame the scale steers toward; below a 60 Hz frame, for headroom
+    float BudgetMs = 14.0f;
+    float MinScale = 0.5f;
+    float MaxScale = 1.0f;
+    // The scale only rises once GPU time is under this fraction of the budget, and holds
+    // between that and the budget, so it does not oscillate around it
+    float Headroom = 0.85f;
+    // Scales are whole steps, so small timing noise does not change the target size
+    float Step = 0.025f;
+    // Largest single rise; drops are as large as needed to get back under the budget
+    float MaxIncrease = 0.05f;
+    // Frames after a change before timings are acted on again; covers the GPU timer latency
+    uint32_t SettleFrames = 6;
+    // Weight of each new timing in the smoothed GPU time
+    float Smoothing = 0.25f;
+};
+
+// Picks each frame's render scale from measured GPU frame times. Cost is taken to follow the
+// pixel count, so an over-budget frame scales down by the square root of budget over time in
+// one step; recovery climbs by at most MaxIncrease a step. Disabled, it returns MaxScale.
+class DynamicResolution {
+public:
+    explicit DynamicResolution(const DynamicResolutionDesc& Desc = {});
+
+    // One frame's GPU time in milliseconds, 0 if none arrived; returns the scale to render the
+    // next frame at.
+    float Update(float GpuMs);
+
+    // Ignores timings for SettleFrames frames and restarts the average, e.g. after a resize
+    // changed what each scale costs. The scale is kept.
+    void Invalidate();
+
+    void SetDesc(const DynamicResolutionDesc& InDesc);
+
+    [[nodiscard]] const DynamicResolutionDesc& GetDesc() const { return Desc; }
+
+    [[nodiscard]] float GetScale() const { return Scale; }
+
+    [[nodiscard]] float GetSmoothedMs() const { return SmoothedMs; }
+
+private:
+    [[nodiscard]] float Quantize(float Value) const;
+
+    DynamicResolutionDesc Desc;
+    float Scale = 1.0f;
+    float SmoothedMs = 0.0f;
+    uint32_t FramesSinceChange = 0;
+};
+
+} // namespace Volante
@@ -0,0 +1,212 @@
+#include "FrameCapture.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <iostream>
+
+#include "FrameGraph.h"
+#include "GPUReadback.h"
+#include "Runtime/Core/IO/PngWriter.h"
+
+namespace Volante {
+
+FrameCapture::FrameCapture(GPUReadback& Readback, FrameGraph& Graph) : Readback(Readback), Graph(Graph) {}
+
+FrameCapture::~FrameCapture() {
+    Shutdown();
+}
+
+void FrameCapture::Shutdown() {
+    Close();
+    Screenshot.clear();
+    DestroyTarget();
+}
+
+bool FrameCapture::Open(const FrameCaptureDesc& InDesc) {
+    Close();
+    Desc = InDesc;
+    Desc.MaxQueuedFrames = std::max(Desc.MaxQueuedFrames, 1u);
+    if (Desc.Format == FrameCaptureFormat::Raw) {
+        RawFile.open(Desc.Path, std::ios::binary | std::ios::trunc);
+        if (!RawFile.is_open()) {
+            std::cerr << "ERROR::FRAME_CAPTURE::OPEN_FAILED: " << Desc.Path << std::endl;
+            return false;
+        }
+        RawWidth = 0;
+        RawHeight = 0;
+        RawSizeReported = false;
+    }
+    NextIndex = 0;
+    Opened = true;
+    std::lock_guard Lock(Mutex);
+    Stats = {};
+    return true;
+}
+
+void FrameCapture::Close() {
+    if (Worker.joinable()) {
+        // Every captured frame reaches the queue, then the worker drains it
+        Readback.Flush();
+        {
+            std::lock_guard Lock(Mutex);
+            Stopping = true;
+        }
+        WorkCondition.notify_one();
+        Worker.join();
+        Stopping = false;
+    }
+    if (RawFile.is_open()) { RawFile.close(); }
+    Opened = false;
+}
+
+void FrameCapture::RequestScreenshot(const std::string& Path) {
+    Screenshot = Path;
+}
+
+unsigned int FrameCapture::BeginFrame(int Width, int Height) {
+    if (Target != 0 && Width == TargetWidth && Height == TargetHeight) { return Target; }
+    DestroyTarget();
+    glGenTextures(1, &Target);
+    glBindTexture(GL_TEXTURE_2D, Target);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, Width, Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glGenFramebuffers(1, &TargetFramebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, TargetFramebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, Target, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    TargetWidth = Width;
+    TargetHeight = Height;
+    return Target;
+}
+
+void FrameCapture::EndFrame() {
+    if (Target == 0) { return; }
+    Capture(Target, TargetWidth, TargetHeight);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, TargetFramebuffer);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glBlitFramebuffer(0, 0, TargetWidth, TargetHeight, 0, 0, TargetWidth, TargetHeight, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void FrameCapture::Capture(unsigned int Texture, int Width, int Height) {
+    if (!IsCapturing() || Texture == 0 || Width <= 0 || Height <= 0) { return; }
+    if (!Worker.joinable()) { Worker = std::thread([this] { WorkerLoop(); }); }
+
+    PendingFrame Frame;
+    Frame.Index = Opened ? NextIndex++ : 0;
+    Frame.Width = Width;
+    Frame.Height = Height;
+    Frame.Record = Opened;
+    Frame.Screenshot = std::move(Screenshot);
+    Screenshot.clear();
+    {
+        std::lock_guard Lock(Mutex);
+        ++Stats.CapturedFrames;
+    }
+    Readback.ReadTexture(Texture, 0, 0, Width, Height, GL_RGBA, GL_UNSIGNED_BYTE,
+                         [this, Frame = std::move(Frame)](std::vector<uint8_t>& Pixels) mutable {
+                             std::unique_lock Lock(Mutex);
+                             if (Pixels.empty()) {
+                                 ++Stats.FailedFrames;
+                                 return;
+                             }
+                             // Waiting here would block the main thread on the encoder; a
+                             // screenshot is a single frame and always goes through
+                             if (Queue.size() >= Desc.MaxQueuedFrames && Frame.Screenshot.empty()) {
+                                 ++Stats.DroppedFrames;
+                                 return;
+                             }
+                             // The readback gets a buffer back the worker is done with
+                             Frame.Pixels = std::move(Pixels);
+                             if (!Spare.empty()) {
+                                 Pixels = std::move(Spare.back());
+                                 Spare.pop_back();
+                             }
+                             Queue.push_back(std::move(Frame));
+                             Lock.unlock();
+                             WorkCondition.notify_one();
+                         });
+}
+
+FrameCaptureStats FrameCapture::GetStats() const {
+    std::lock_guard Lock(Mutex);
+    return Stats;
+}
+
+FrameCaptureFormat FrameCapture::GetFormatForPath(const std::string& Path) {
+    const size_t Dot = Path.find_last_of('.');
+    if (Dot == std::string::npos) { return FrameCaptureFormat::Png; }
+    std::string Extension = Path.substr(Dot + 1);
+    for (char& Character : Extension) {
+        Character = static_cast<char>(std::tolower(static_cast<unsigned char>(Character)));
+    }
+    return Extension == "raw" || Extension == "rgba" ? FrameCaptureFormat::Raw : FrameCaptureFormat::Png;
+}
+
+void FrameCapture::WorkerLoop() {
+    for (;;) {
+        PendingFrame Frame;
+        {
+            std::unique_lock Lock(Mutex);
+            WorkCondition.wait(Lock, [this] { return Stopping || !Queue.empty(); });
+            if (Queue.empty()) { break; }
+            Frame = std::move(Queue.front());
+            Queue.pop_front();
+        }
+        Write(Frame);
+    }
+}
+
+void FrameCapture::Write(PendingFrame& Frame) {
+    const auto Width = static_cast<uint32_t>(Frame.Width);
+    const auto Height = static_cast<uint32_t>(Frame.Height);
+    bool Written = true;
+    if (Frame.Record && Desc.Format == FrameCaptureFormat::Png) {
+        char Suffix[32];
+        std::snprintf(Suffix, sizeof(Suffix), "_%06llu.png", static_cast<unsigned long long>(Frame.Index));
+        Written = WritePng(Desc.Path + Suffix, Frame.Pixels.data(), Width, Height, 4, true);
+    } else if (Frame.Record) {
+        if (RawWidth == 0) {
+            RawWidth = Frame.Width;
+            RawHeight = Frame.Height;
+        }
+        if (Frame.Width != RawWidth || Frame.Height != RawHeight) {
+            // A video stream has one size; frames of another are dropped
+            if (!RawSizeReported) { std::cerr << "ERROR::FRAME_CAPTURE::SIZE_CHANGED: " << Desc.Path << std::endl; }
+            RawSizeReported = true;
+            Written = false;
+        } else {
+            // GL reads bottom-up; video is top-down
+            const size_t RowSize = static_cast<size_t>(Width) * 4;
+            for (uint32_t y = Height; y-- > 0;) {
+                RawFile.write(reinterpret_cast<const char*>(Frame.Pixels.data() + RowSize * y), static_cast<std::streamsize>(RowSize));
+            }
+            Written = RawFile.good();
+        }
+    }
+    if (!Frame.Screenshot.empty()) {
+        Written = WritePng(Frame.Screenshot, Frame.Pixels.data(), Width, Height, 4, true) && Written;
+    }
+
+    std::lock_guard Lock(Mutex);
+    ++(Written ? Stats.WrittenFrames : Stats.FailedFrames);
+    Spare.push_back(std::move(Frame.Pixels));
+}
+
+void FrameCapture::DestroyTarget() {
+    if (Target == 0) { return; }
+    Graph.ForgetTexture(Target);
+    glDeleteTextures(1, &Target);
+    glDeleteFramebuffers(1, &TargetFramebuffer);
+    Target = 0;
+    TargetFramebuffer = 0;
+    TargetWidth = 0;
+    TargetHeight = 0;
+}
+
+} // namespace Volante
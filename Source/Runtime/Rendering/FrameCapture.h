@@ -0,0 +1,128 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Volante {
+
+class FrameGraph;
+class GPUReadback;
+
+enum class FrameCaptureFormat : uint8_t {
+    // One file per frame: <Path>_000000.png, <Path>_000001.png, ...
+    Png,
+    // RGBA frames appended to Path, top row first, for a video encoder to read, e.g.
+    // ffmpeg -f rawvideo -pixel_format rgba -video_size <W>x<H> -framerate 60 -i <Path> out.mp4
+    // Path may be a named pipe into the encoder.
+    Raw,
+};
+
+struct FrameCaptureDesc {
+    std::string Path;
+    FrameCaptureFormat Format = FrameCaptureFormat::Png;
+    // Frames read back and not yet written; with the encoder this far behind, further recorded
+    // frames are dropped rather than holding up the frame loop. Screenshots are always kept.
+    uint32_t MaxQueuedFrames = 8;
+};
+
+struct FrameCaptureStats {
+    uint64_t CapturedFrames = 0;
+    uint64_t WrittenFrames = 0;
+    // Frames lost to a failed read, encode or write, or a raw frame of another size
+    uint64_t FailedFrames = 0;
+    // Recorded frames dropped because the encoder had fallen MaxQueuedFrames behind
+    uint64_t DroppedFrames = 0;
+};
+
+// Records frames, every one of them or single screenshots, through GPUReadback and a worker
+// thread that encodes and writes them, so the frame loop neither waits for the GPU nor for
+// PNG compression and disk. A frame is written a few frames after it was rendered.
+//
+// The frame renders into a texture from BeginFrame, which EndFrame reads back and copies to
+// the window; or Capture reads a texture rendered into elsewhere.
+class FrameCapture {
+public:
+    FrameCapture(GPUReadback& Readback, FrameGraph& Graph);
+    ~FrameCapture();
+
+    FrameCapture(const FrameCapture&) = delete;
+    FrameCapture& operator=(const FrameCapture&) = delete;
+
+    // Closes, and deletes the target. Main thread, with the context current.
+    void Shutdown();
+
+    // Captures every frame from now on. Truncates a raw file.
+    bool Open(const FrameCaptureDesc& InDesc);
+    // Waits until every frame captured so far has been read back and written. Other reads
+    // the readback has in flight complete with them.
+    void Close();
+
+    // The next captured frame is also written to Path as a PNG, whether open or not.
+    void RequestScreenshot(const std::string& Path);
+
+    // Open, or a screenshot requested: the frame should go through BeginFrame and EndFrame.
+    [[nodiscard]] bool IsCapturing() const { return Opened || !Screenshot.empty(); }
+
+    [[nodiscard]] bool IsOpen() const { return Opened; }
+
+    // The RGBA8 texture to render this frame into.
+    unsigned int BeginFrame(int Width, int Height);
+    // Captures the frame and copies it into the default framebuffer.
+    void EndFrame();
+
+    // Captures Width x Height of an RGBA8 texture, e.g. a canvas several windows show.
+    void Capture(unsigned int Texture, int Width, int Height);
+
+    [[nodiscard]] FrameCaptureStats GetStats() const;
+
+    // .raw and .rgba select Raw, anything else Png
+    [[nodiscard]] static FrameCaptureFormat GetFormatForPath(const std::string& Path);
+
+private:
+    struct PendingFrame {
+        uint64_t Index = 0;
+        int Width = 0;
+        int Height = 0;
+        std::vector<uint8_t> Pixels;
+        bool Record = false;
+        std::string Screenshot;
+    };
+
+    void WorkerLoop();
+    void Write(PendingFrame& Frame);
+    void DestroyTarget();
+
+    GPUReadback& Readback;
+    FrameGraph& Graph;
+    FrameCaptureDesc Desc;
+    bool Opened = false;
+    std::string Screenshot;
+    uint64_t NextIndex = 0;
+
+    unsigned int Target = 0;
+    unsigned int TargetFramebuffer = 0;
+    int TargetWidth = 0;
+    int TargetHeight = 0;
+
+    // Only the worker touches the file and its frame size while it runs
+    std::thread Worker;
+    std::ofstream RawFile;
+    int RawWidth = 0;
+    int RawHeight = 0;
+    bool RawSizeReported = false;
+    mutable std::mutex Mutex;
+    std::condition_variable WorkCondition;
+    std::deque<PendingFrame> Queue;
+    // Pixel buffers the worker is done with, handed back to the readback
+    std::vector<std::vector<uint8_t>> Spare;
+    FrameCaptureStats Stats;
+    bool Stopping = false;
+};
+
+} // namespace Volante
@@ -0,0 +1,337 @@
+#include "FrameGraph.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <iostream>
+
+namespace Volante {
+
+namespace {
+
+bool IsDepthFormat(unsigned int Format) {
+    switch (Format) {
+    case GL_DEPTH_COMPONENT16:
+    case GL_DEPTH_COMPONENT24:
+    case GL_DEPTH_COMPONENT32F:
+    case GL_DEPTH24_STENCIL8:
+    case GL_DEPTH32F_STENCIL8: return true;
+    default: return false;
+    }
+}
+
+bool HasStencil(unsigned int Format) {
+    return Format == GL_DEPTH24_STENCIL8 || Format == GL_DEPTH32F_STENCIL8;
+}
+
+uint32_t GetBytesPerPixel(unsigned int Format) {
+    switch (Format) {
+    case GL_R8: return 1;
+    case GL_RG8:
+    case GL_R16F:
+    case GL_DEPTH_COMPONENT16: return 2;
+    case GL_RGBA16F:
+    case GL_RG32F:
+    case GL_DEPTH32F_STENCIL8: return 8;
+    case GL_RGBA32F: return 16;
+    default: return 4;
+    }
+}
+
+} // namespace
+
+FrameGraphResource FrameGraphBuilder::Read(FrameGraphResource Resource) {
+    if (Resource) { Graph.Passes[Pass].Reads.push_back(Resource.Index); }
+    return Resource;
+}
+
+FrameGraphResource FrameGraphBuilder::Write(FrameGraphResource Resource) {
+    if (Resource) { Graph.Passes[Pass].Writes.push_back(Resource.Index); }
+    return Resource;
+}
+
+void FrameGraphBuilder::SetSideEffect() {
+    Graph.Passes[Pass].SideEffect = true;
+}
+
+void FrameGraphBuilder::SetViewport(int Width, int Height) {
+    Graph.Passes[Pass].ViewportWidth = Width;
+    Graph.Passes[Pass].ViewportHeight = Height;
+}
+
+FrameGraph::~FrameGraph() {
+    Shutdown();
+}
+
+void FrameGraph::Shutdown() {
+    for (const CachedFramebuffer& Cached : Framebuffers) {
+        glDeleteFramebuffers(1, &Cached.Framebuffer);
+    }
+    for (const PooledTexture& Pooled : Pool) {
+        glDeleteTextures(1, &Pooled.Texture);
+    }
+    Framebuffers.clear();
+    Pool.clear();
+    Reset();
+}
+
+void FrameGraph::Reset() {
+    Resources.clear();
+    for (uint32_t Index = 0; Index < PassCount; ++Index) {
+        PassNode& Pass = Passes[Index];
+        // Drops the pass's captures now rather than when the node is next reused
+        Pass.Execute = nullptr;
+        Pass.Reads.clear();
+        Pass.Writes.clear();
+        Pass.Acquires.clear();
+        Pass.Releases.clear();
+    }
+    PassCount = 0;
+    Compiled = false;
+}
+
+FrameGraphResource FrameGraph::Create(const char* Name, FrameGraphTextureDesc Desc) {
+    FrameGraphResource Result{static_cast<uint32_t>(Resources.size())};
+    auto& Node = Resources.emplace_back();
+    Node.Name = Name;
+    Node.Desc = Desc;
+    Node.Desc.Samples = std::max(Desc.Samples, 1);
+    return Result;
+}
+
+FrameGraphResource FrameGraph::Import(const char* Name, unsigned int Texture, FrameGraphTextureDesc Desc) {
+    FrameGraphResource Result{static_cast<uint32_t>(Resources.size())};
+    auto& Node = Resources.emplace_back();
+    Node.Name = Name;
+    Node.Desc = Desc;
+    Node.Texture = Texture;
+    Node.Imported = true;
+    return Result;
+}
+
+FrameGraphResource FrameGraph::ImportBackbuffer(int Width, int Height) {
+    const FrameGraphResource Result = Import("Backbuffer", 0, {Width, Height, GL_RGBA8, 1});
+    Resources[Result.Index].Backbuffer = true;
+    return Result;
+}
+
+void FrameGraph::AddPass(const char* Name, const std::function<void(FrameGraphBuilder&)>& Setup, ExecuteFunction Execute) {
+    if (PassCount == Passes.size()) { Passes.emplace_back(); }
+    PassNode& Pass = Passes[PassCount];
+    Pass.Name = Name;
+    Pass.Execute = std::move(Execute);
+    Pass.ViewportWidth = 0;
+    Pass.ViewportHeight = 0;
+    Pass.SideEffect = false;
+    Pass.Culled = false;
+    FrameGraphBuilder Builder(*this, PassCount++);
+    Setup(Builder);
+}
+
+void FrameGraph::Compile() {
+    // Walk back from the outputs: a pass lives if it has side effects or writes something a
+    // live pass (or the outside world) consumes, and then everything it touches is consumed
+    for (uint32_t Index = PassCount; Index-- > 0;) {
+        PassNode& Pass = Passes[Index];
+        bool Alive = Pass.SideEffect;
+        for (const uint32_t Write : Pass.Writes) {
+            Alive = Alive || Resources[Write].Imported || Resources[Write].Needed;
+        }
+        Pass.Culled = !Alive;
+        if (!Alive) { continue; }
+        for (const uint32_t Read : Pass.Reads) {
+            Resources[Read].Needed = true;
+        }
+        for (const uint32_t Write : Pass.Writes) {
+            Resources[Write].Needed = true;
+        }
+    }
+
+    Stats = {};
+    Stats.PassCount = PassCount;
+    const auto Touch = [&](uint32_t Resource, uint32_t Pass) {
+        ResourceNode& Node = Resources[Resource];
+        if (!Node.Used) { Node.FirstPass = Pass; }
+        Node.LastPass = Pass;
+        Node.Used = true;
+    };
+    for (uint32_t Index = 0; Index < PassCount; ++Index) {
+        const PassNode& Pass = Passes[Index];
+        if (Pass.Culled) {
+            ++Stats.CulledPassCount;
+            continue;
+        }
+        for (const uint32_t Read : Pass.Reads) {
+            const ResourceNode& Node = Resources[Read];
+            if (!Node.Imported && !Node.Used) {
+                std::cerr << "ERROR::FRAME_GRAPH::READ_BEFORE_WRITE: " << Pass.Name << " reads " << Node.Name << std::endl;
+            }
+            Touch(Read, Index);
+        }
+        for (const uint32_t Write : Pass.Writes) {
+            Touch(Write, Index);
+        }
+    }
+
+    for (uint32_t Index = 0; Index < Resources.size(); ++Index) {
+        const ResourceNode& Node = Resources[Index];
+        if (Node.Imported || !Node.Used) { continue; }
+        Passes[Node.FirstPass].Acquires.push_back(Index);
+        Passes[Node.LastPass].Releases.push_back(Index);
+        ++Stats.TransientCount;
+    }
+    Compiled = true;
+}
+
+void FrameGraph::Execute() {
+    if (!Compiled) { Compile(); }
+
+    for (uint32_t Index = 0; Index < PassCount; ++Index) {
+        const PassNode& Pass = Passes[Index];
+        if (Pass.Culled) { continue; }
+        for (const uint32_t Resource : Pass.Acquires) {
+            ResourceNode& Node = Resources[Resource];
+            Node.PoolIndex = AcquireTexture(Node.Desc);
+            Node.Texture = Pool[Node.PoolIndex].Texture;
+        }
+
+        BindPassTarget(Pass);
+        if (Pass.Execute) { Pass.Execute(*this); }
+
+        // Free for the passes after this one
+        for (const uint32_t Resource : Pass.Releases) {
+            Pool[Resources[Resource].PoolIndex].InUse = false;
+        }
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    ++Frame;
+    CollectIdle();
+    Stats.TextureCount = static_cast<uint32_t>(Pool.size());
+    for (const PooledTexture& Pooled : Pool) {
+        Stats.TextureBytes += static_cast<uint64_t>(Pooled.Desc.Width) * static_cast<uint64_t>(Pooled.Desc.Height) *
+                              GetBytesPerPixel(Pooled.Desc.Format) * static_cast<uint64_t>(Pooled.Desc.Samples);
+    }
+}
+
+unsigned int FrameGraph::GetTexture(FrameGraphResource Resource) const {
+    return Resource ? Resources[Resource.Index].Texture : 0;
+}
+
+const FrameGraphTextureDesc& FrameGraph::GetDesc(FrameGraphResource Resource) const {
+    return Resources[Resource.Index].Desc;
+}
+
+uint32_t FrameGraph::AcquireTexture(const FrameGraphTextureDesc& Desc) {
+    for (uint32_t Index = 0; Index < Pool.size(); ++Index) {
+        PooledTexture& Pooled = Pool[Index];
+        if (Pooled.InUse || !(Pooled.Desc == Desc)) { continue; }
+        Pooled.InUse = true;
+        Pooled.LastUsedFrame = Frame;
+        return Index;
+    }
+
+    PooledTexture& Pooled = Pool.emplace_back();
+    Pooled.Desc = Desc;
+    Pooled.InUse = true;
+    Pooled.LastUsedFrame = Frame;
+    glGenTextures(1, &Pooled.Texture);
+    if (Desc.Samples > 1) {
+        glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, Pooled.Texture);
+        glTexImage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE, Desc.Samples, Desc.Format, Desc.Width, Desc.Height, GL_TRUE);
+        glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, 0);
+    } else {
+        // Only the storage matters; format and type just have to be compatible with it
+        const bool Depth = IsDepthFormat(Desc.Format);
+        const GLenum Format = Depth ? (HasStencil(Desc.Format) ? GL_DEPTH_STENCIL : GL_DEPTH_COMPONENT) : GL_RGBA;
+        const GLenum Type = HasStencil(Desc.Format) ? GL_UNSIGNED_INT_24_8 : GL_FLOAT;
+        const GLint Filter = Depth ? GL_NEAREST : GL_LINEAR;
+        glBindTexture(GL_TEXTURE_2D, Pooled.Texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, static_cast<GLint>(Desc.Format), Desc.Width, Desc.Height, 0, Format,
+                     Desc.Format == GL_DEPTH32F_STENCIL8 ? GL_FLOAT_32_UNSIGNED_INT_24_8_REV : Type, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, Filter);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, Filter);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+    return static_cast<uint32_t>(Pool.size() - 1);
+}
+
+void FrameGraph::BindPassTarget(const PassNode& Pass) {
+    if (Pass.Writes.empty()) { return; }
+
+    const ResourceNode& First = Resources[Pass.Writes.front()];
+    const int ViewportWidth = Pass.ViewportWidth > 0 ? Pass.ViewportWidth : First.Desc.Width;
+    const int ViewportHeight = Pass.ViewportHeight > 0 ? Pass.ViewportHeight : First.Desc.Height;
+    if (First.Backbuffer) {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glViewport(0, 0, ViewportWidth, ViewportHeight);
+        return;
+    }
+
+    AttachmentKey Key = {};
+    uint32_t ColorCount = 0;
+    bool Stencil = false;
+    for (const uint32_t Write : Pass.Writes) {
+        const ResourceNode& Node = Resources[Write];
+        if (IsDepthFormat(Node.Desc.Format)) {
+            Key[MaxColorAttachments] = Node.Texture;
+            Stencil = HasStencil(Node.Desc.Format);
+        } else if (ColorCount < MaxColorAttachments) {
+            Key[ColorCount++] = Node.Texture;
+        }
+    }
+
+    const auto It = std::find_if(Framebuffers.begin(), Framebuffers.end(),
+                                 [&](const CachedFramebuffer& Cached) { return Cached.Attachments == Key; });
+    if (It != Framebuffers.end()) {
+        glBindFramebuffer(GL_FRAMEBUFFER, It->Framebuffer);
+    } else {
+        CachedFramebuffer& Cached = Framebuffers.emplace_back();
+        Cached.Attachments = Key;
+        glGenFramebuffers(1, &Cached.Framebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, Cached.Framebuffer);
+        const GLenum Target = First.Desc.Samples > 1 ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D;
+        GLenum DrawBuffers[MaxColorAttachments] = {};
+        for (uint32_t Index = 0; Index < ColorCount; ++Index) {
+            DrawBuffers[Index] = GL_COLOR_ATTACHMENT0 + Index;
+            glFramebufferTexture2D(GL_FRAMEBUFFER, DrawBuffers[Index], Target, Key[Index], 0);
+        }
+        if (const unsigned int Depth = Key[MaxColorAttachments]; Depth != 0) {
+            glFramebufferTexture2D(GL_FRAMEBUFFER, Stencil ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT, Target, Depth, 0);
+        }
+        if (ColorCount > 0) {
+            glDrawBuffers(static_cast<GLsizei>(ColorCount), DrawBuffers);
+        } else {
+            glDrawBuffer(GL_NONE);
+        }
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            std::cerr << "ERROR::FRAME_GRAPH::FRAMEBUFFER_INCOMPLETE: " << Pass.Name << std::endl;
+        }
+    }
+    glViewport(0, 0, ViewportWidth, ViewportHeight);
+}
+
+void FrameGraph::ForgetTexture(unsigned int Texture) {
+    // A deleted texture stays attached to framebuffers that are not bound, and its name may
+    // come back for a new one
+    std::erase_if(Framebuffers, [&](const CachedFramebuffer& Cached) {
+        const bool Attached = std::ranges::find(Cached.Attachments, Texture) != Cached.Attachments.end();
+        if (Attached) { glDeleteFramebuffers(1, &Cached.Framebuffer); }
+        return Attached;
+    });
+}
+
+void FrameGraph::CollectIdle() {
+    const auto Idle = [&](const PooledTexture& Pooled) { return !Pooled.InUse && Frame - Pooled.LastUsedFrame > IdleFrames; };
+    for (const PooledTexture& Pooled : Pool) {
+        if (!Idle(Pooled)) { continue; }
+        ForgetTexture(Pooled.Texture);
+        glDeleteTextures(1, &Pooled.Texture);
+    }
+    std::erase_if(Pool, Idle);
+}
+
+} // namespace Volante
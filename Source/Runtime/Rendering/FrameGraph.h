@@ -0,0 +1,193 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace Volante {
+
+// A texture declared in a FrameGraph, valid for the frame it was declared in.
+struct FrameGraphResource {
+    static constexpr uint32_t InvalidIndex = ~0u;
+
+    uint32_t Index = InvalidIndex;
+
+    [[nodiscard]] bool IsValid() const { return Index != InvalidIndex; }
+
+    explicit operator bool() const { return IsValid(); }
+};
+
+struct FrameGraphTextureDesc {
+    int Width = 0;
+    int Height = 0;
+    // GL internal format, e.g. GL_RGBA16F or GL_DEPTH_COMPONENT32F
+    unsigned int Format = 0;
+    // Above 1 makes a multisample texture
+    int Samples = 1;
+
+    bool operator==(const FrameGraphTextureDesc&) const = default;
+};
+
+struct FrameGraphStats {
+    uint32_t PassCount = 0;
+    uint32_t CulledPassCount = 0;
+    // Transient textures the frame declared, and the pooled textures that backed them
+    uint32_t TransientCount = 0;
+    uint32_t TextureCount = 0;
+    uint64_t TextureBytes = 0;
+};
+
+class FrameGraph;
+
+// Handed to a pass's setup function to declare what it reads and writes.
+class FrameGraphBuilder {
+public:
+    // The pass samples Resource.
+    FrameGraphResource Read(FrameGraphResource Resource);
+
+    // The pass renders to Resource: colour attachments in the order written, or the depth
+    // attachment for a depth format. Earlier contents are kept, so earlier writers stay alive.
+    FrameGraphResource Write(FrameGraphResource Resource);
+
+    // Never culled, e.g. a pass that only reads back or publishes results.
+    void SetSideEffect();
+
+    // Renders to the lower-left Width x Height of the targets instead of all of them, for
+    // targets allocated larger than this frame needs.
+    void SetViewport(int Width, int Height);
+
+private:
+    friend class FrameGraph;
+
+    FrameGraphBuilder(FrameGraph& Graph, uint32_t Pass) : Graph(Graph), Pass(Pass) {}
+
+    FrameGraph& Graph;
+    uint32_t Pass;
+};
+
+// Per-frame graph of render passes over textures. Passes declare their reads and writes up
+// front; Compile culls every pass whose output nothing alive consumes (only writes to imported
+// textures, like the window, and side effects count as consumed) and works out how long each
+// transient texture lives. Execute then runs the survivors in order, binding a framebuffer for
+// each pass's writes and sizing the viewport to them, or to the part the pass asked for.
+//
+// Transient textures come from a pool kept across frames and go back to it after their last
+// reader, so later passes in the same frame reuse them: a bloom chain's levels and the
+// post-processing ping-pong end up sharing a handful of textures. GL cannot place two textures
+// in the same memory, so only textures with the same description alias; pooled textures idle
+// for IdleFrames frames are deleted, which lets a resize settle without keeping old sizes.
+//
+// Typical frame: Reset, Create and AddPass..., Compile, Execute.
+class FrameGraph {
+public:
+    using ExecuteFunction = std::function<void(const FrameGraph& Graph)>;
+
+    static constexpr uint32_t MaxColorAttachments = 4;
+    static constexpr uint64_t IdleFrames = 8;
+
+    FrameGraph() = default;
+    ~FrameGraph();
+
+    FrameGraph(const FrameGraph&) = delete;
+    FrameGraph& operator=(const FrameGraph&) = delete;
+
+    // Deletes the pooled textures and framebuffers.
+    void Shutdown();
+
+    // Drops last frame's passes and resources; the pool is kept.
+    void Reset();
+
+    // A transient texture, allocated from the pool for the passes that use it. Declared before
+    // the passes, so their execute functions can capture the handle. Desc is taken by value, so
+    // another resource's GetDesc can be passed.
+    FrameGraphResource Create(const char* Name, FrameGraphTextureDesc Desc);
+
+    // A texture owned elsewhere, e.g. a history buffer that outlives the frame.
+    FrameGraphResource Import(const char* Name, unsigned int Texture, FrameGraphTextureDesc Desc);
+
+    // The window's default framebuffer.
+    FrameGraphResource ImportBackbuffer(int Width, int Height);
+
+    // Drops cached framebuffers that attach Texture; call before deleting an imported texture.
+    void ForgetTexture(unsigned int Texture);
+
+    // Setup runs immediately; Execute runs from Execute() unless the pass is culled.
+    void AddPass(const char* Name, const std::function<void(FrameGraphBuilder&)>& Setup, ExecuteFunction Execute);
+
+    void Compile();
+    void Execute();
+
+    // Only while the pass using it executes; transient textures change between frames.
+    [[nodiscard]] unsigned int GetTexture(FrameGraphResource Resource) const;
+
+    // Invalidated by the next Create or Import.
+    [[nodiscard]] const FrameGraphTextureDesc& GetDesc(FrameGraphResource Resource) const;
+
+    [[nodiscard]] const FrameGraphStats& GetStats() const { return Stats; }
+
+private:
+    friend class FrameGraphBuilder;
+
+    struct ResourceNode {
+        const char* Name = nullptr;
+        FrameGraphTextureDesc Desc;
+        unsigned int Texture = 0;
+        bool Imported = false;
+        bool Backbuffer = false;
+        // Alive passes that first and last use it, for transient lifetimes
+        uint32_t FirstPass = 0;
+        uint32_t LastPass = 0;
+        bool Used = false;
+        bool Needed = false;
+        uint32_t PoolIndex = 0;
+    };
+
+    struct PassNode {
+        const char* Name = nullptr;
+        ExecuteFunction Execute;
+        std::vector<uint32_t> Reads;
+        std::vector<uint32_t> Writes;
+        // Transients whose lifetime starts and ends here
+        std::vector<uint32_t> Acquires;
+        std::vector<uint32_t> Releases;
+        // Zero for the whole of the first write
+        int ViewportWidth = 0;
+        int ViewportHeight = 0;
+        bool SideEffect = false;
+        bool Culled = false;
+    };
+
+    struct PooledTexture {
+        FrameGraphTextureDesc Desc;
+        unsigned int Texture = 0;
+        uint64_t LastUsedFrame = 0;
+        bool InUse = false;
+    };
+
+    // Colour attachments, then depth
+    using AttachmentKey = std::array<unsigned int, MaxColorAttachments + 1>;
+
+    struct CachedFramebuffer {
+        AttachmentKey Attachments = {};
+        unsigned int Framebuffer = 0;
+    };
+
+    uint32_t AcquireTexture(const FrameGraphTextureDesc& Desc);
+    void BindPassTarget(const PassNode& Pass);
+    void CollectIdle();
+
+    std::vector<ResourceNode> Resources;
+    std::vector<PassNode> Passes;
+    // Passes are reused between frames so their vectors keep their capacity
+    uint32_t PassCount = 0;
+
+    std::vector<PooledTexture> Pool;
+    std::vector<CachedFramebuffer> Framebuffers;
+    uint64_t Frame = 0;
+    bool Compiled = false;
+
+    FrameGraphStats Stats;
+};
+
+} // namespace Volante
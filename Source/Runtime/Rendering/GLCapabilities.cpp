@@ -0,0 +1,50 @@
+#include "GLCapabilities.h"
+
+#include <glad/glad.h>
+
+namespace Volante {
+
+const GLCapabilities& GLCapabilities::Get() {
+    static const GLCapabilities Caps = [] {
+        GLCapabilities Result;
+        glGetIntegerv(GL_MAJOR_VERSION, &Result.Major);
+        glGetIntegerv(GL_MINOR_VERSION, &Result.Minor);
+        if (const auto* Name = reinterpret_cast<const char*>(glGetString(GL_RENDERER))) { Result.Renderer = Name; }
+
+        // The version check alone is not enough: glad only loads the entry points it was
+        // generated for
+        Result.ComputeShaders = Result.IsAtLeast(4, 3) && GLAD_GL_VERSION_4_3;
+        Result.IndirectCount = Result.IsAtLeast(4, 6) && GLAD_GL_VERSION_4_6;
+        Result.CopyImage = Result.IsAtLeast(4, 3) && GLAD_GL_VERSION_4_3;
+
+        GLint ExtensionCount = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &ExtensionCount);
+        for (GLint i = 0; i < ExtensionCount; ++i) {
+            if (const auto* Name = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i))) { Result.Extensions.insert(Name); }
+        }
+
+        // Only the enums are needed for these, so the extension string is enough
+        Result.TextureS3TC = Result.HasExtension("GL_EXT_texture_compression_s3tc");
+        Result.TextureBPTC = Result.IsAtLeast(4, 2) || Result.HasExtension("GL_ARB_texture_compression_bptc");
+        Result.TextureETC2 = Result.IsAtLeast(4, 3) || Result.HasExtension("GL_ARB_ES3_compatibility");
+        Result.ParallelShaderCompile = Result.HasExtension("GL_KHR_parallel_shader_compile") ||
+                                       Result.HasExtension("GL_ARB_parallel_shader_compile");
+
+        // These need entry points, from either the core version or the extension
+        Result.BufferStorage = Result.IsAtLeast(4, 4) && GLAD_GL_VERSION_4_4;
+#if defined(GL_ARB_buffer_storage)
+        Result.BufferStorage = Result.BufferStorage || (Result.HasExtension("GL_ARB_buffer_storage") && GLAD_GL_ARB_buffer_storage);
+#endif
+        Result.ClipControl = Result.IsAtLeast(4, 5) && GLAD_GL_VERSION_4_5;
+#if defined(GL_ARB_clip_control)
+        Result.ClipControl = Result.ClipControl || (Result.HasExtension("GL_ARB_clip_control") && GLAD_GL_ARB_clip_control);
+#endif
+#if defined(GL_ARB_bindless_texture)
+        Result.BindlessTextures = Result.HasExtension("GL_ARB_bindless_texture") && GLAD_GL_ARB_bindless_texture;
+#endif
+        return Result;
+    }();
+    return Caps;
+}
+
+} // namespace Volante
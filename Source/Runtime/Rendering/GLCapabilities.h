@@ -0,0 +1,46 @@
+#pragma once
+
+#include <string>
+#include <unordered_set>
+
+namespace Volante {
+
+// Context version and the optional features the renderer branches on. Queried once, after the
+// context has been made current and glad has loaded the function pointers.
+struct GLCapabilities {
+    int Major = 0;
+    int Minor = 0;
+    std::string Renderer;
+
+    // GL 4.3: compute shaders, SSBOs, glMultiDrawElementsIndirect
+    bool ComputeShaders = false;
+    // GL 4.6 or ARB_indirect_parameters: the draw count comes from a GPU buffer
+    bool IndirectCount = false;
+    // GL 4.3: glCopyImageSubData
+    bool CopyImage = false;
+    // GL 4.4 or ARB_buffer_storage: immutable storage, persistent mapping
+    bool BufferStorage = false;
+    // GL 4.5 or ARB_clip_control: [0, 1] clip depth for reverse-Z
+    bool ClipControl = false;
+
+    // Compressed texture families. RGTC (BC4/5) is core since 3.0.
+    bool TextureS3TC = false;
+    bool TextureBPTC = false;
+    bool TextureETC2 = false;
+    // ARB_bindless_texture, and glad was generated with it
+    bool BindlessTextures = false;
+    // KHR/ARB_parallel_shader_compile: GL_COMPLETION_STATUS_KHR can be polled without blocking
+    bool ParallelShaderCompile = false;
+
+    std::unordered_set<std::string> Extensions;
+
+    [[nodiscard]] bool IsAtLeast(int InMajor, int InMinor) const {
+        return Major > InMajor || (Major == InMajor && Minor >= InMinor);
+    }
+
+    [[nodiscard]] bool HasExtension(const char* Name) const { return Extensions.count(Name) != 0; }
+
+    static const GLCapabilities& Get();
+};
+
+} // namespace Volante
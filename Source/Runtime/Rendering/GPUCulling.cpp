@@ -0,0 +1,286 @@
+#include "GPUCulling.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+
+#include "ComputeProgram.h"
+#include "DepthConvention.h"
+#include "GLCapabilities.h"
+#include "HiZBuffer.h"
+
+namespace Volante {
+
+namespace {
+
+constexpr uint32_t CullGroupSize = 64;
+
+enum Binding : GLuint {
+    InstanceBinding = 0,
+    MeshBinding = 1,
+    BucketBinding = 2,
+    BucketCountBinding = 3,
+    VisibleRefBinding = 4,
+    CounterBinding = 5,
+    BucketOffsetBinding = 6,
+    CommandBinding = 7,
+    VisibleInstanceBinding = 8,
+    MaterialGroupBinding = 9,
+};
+
+// Layout of CounterBuffer. DispatchX..Z double as the indirect dispatch for Scatter and
+// DrawCount as the parameter buffer for glMultiDrawElementsIndirectCount.
+struct GPUCounters {
+    uint32_t VisibleCount;
+    uint32_t DrawCount;
+    uint32_t DispatchX;
+    uint32_t DispatchY;
+    uint32_t DispatchZ;
+    uint32_t FrustumCulledCount;
+    uint32_t OcclusionCulledCount;
+    uint32_t Pad;
+};
+
+constexpr GLintptr DrawCountOffset = offsetof(GPUCounters, DrawCount);
+constexpr GLintptr DispatchOffset = offsetof(GPUCounters, DispatchX);
+
+void CreateStorage(unsigned int& Buffer, size_t Bytes, GLenum Usage = GL_DYNAMIC_COPY) {
+    if (Buffer != 0) { glDeleteBuffers(1, &Buffer); }
+    glGenBuffers(1, &Buffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, Buffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, static_cast<GLsizeiptr>(Bytes), nullptr, Usage);
+}
+
+void ClearToZero(unsigned int Buffer) {
+    const uint32_t Zero = 0;
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, Buffer);
+    glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, &Zero);
+}
+
+} // namespace
+
+GPUCulling::~GPUCulling() {
+    Shutdown();
+}
+
+bool GPUCulling::Initialize() {
+    if (!GLCapabilities::Get().ComputeShaders) { return false; }
+
+    const std::string& Directory = ShaderLibrary::GetShaderDirectory();
+    CullProgram = Shaders.LoadCompute(Directory + "/Cull.comp");
+    BuildProgram = Shaders.LoadCompute(Directory + "/CullBuildCommands.comp");
+    ScatterProgram = Shaders.LoadCompute(Directory + "/CullScatter.comp");
+    for (const ShaderProgramId Program : {CullProgram, BuildProgram, ScatterProgram}) {
+        if (!Shaders.GetCompute(Program)) {
+            Shutdown();
+            return false;
+        }
+    }
+
+    CreateStorage(CounterBuffer, sizeof(GPUCounters));
+    glGenBuffers(ReadbackFrames, ReadbackBuffers);
+    for (unsigned int Buffer : ReadbackBuffers) {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, Buffer);
+        glBufferData(GL_COPY_WRITE_BUFFER, sizeof(GPUCounters), nullptr, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    return true;
+}
+
+void GPUCulling::Shutdown() {
+    for (ShaderProgramId* Program : {&CullProgram, &BuildProgram, &ScatterProgram}) {
+        Shaders.Unload(*Program);
+        *Program = InvalidShaderProgramId;
+    }
+
+    const unsigned int Buffers[] = {BucketCountBuffer, BucketOffsetBuffer, CommandBuffer, VisibleRefBuffer,
+                                    VisibleInstanceBuffer, CounterBuffer, MaterialGroupBuffer};
+    for (unsigned int Buffer : Buffers) {
+        if (Buffer != 0) { glDeleteBuffers(1, &Buffer); }
+    }
+    BucketCountBuffer = BucketOffsetBuffer = CommandBuffer = VisibleRefBuffer = VisibleInstanceBuffer = CounterBuffer = 0;
+    MaterialGroupBuffer = 0;
+    GroupCount = 1;
+    CulledGroupCount = 1;
+
+    for (uint32_t i = 0; i < ReadbackFrames; ++i) {
+        if (ReadbackFences[i] != nullptr) { glDeleteSync(static_cast<GLsync>(ReadbackFences[i])); }
+        if (ReadbackBuffers[i] != 0) { glDeleteBuffers(1, &ReadbackBuffers[i]); }
+        ReadbackFences[i] = nullptr;
+        ReadbackBuffers[i] = 0;
+    }
+    LastStats = {};
+    InstanceCapacity = 0;
+    BucketCapacity = 0;
+}
+
+void GPUCulling::Cull(const GPUScene& Scene, const RenderView& View, const HiZBuffer* Occlusion, bool CollectStats) {
+    const uint32_t InstanceCount = Scene.GetInstanceCount();
+    const uint32_t BucketCount = Scene.GetBucketCount();
+    CulledGroupCount = GroupCount;
+    EnsureCapacity(InstanceCount, BucketCount * CulledGroupCount);
+
+    ClearToZero(BucketCountBuffer);
+    ClearToZero(CounterBuffer);
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, InstanceBinding, Scene.GetInstanceBuffer());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, MeshBinding, Scene.GetMeshBuffer());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, BucketBinding, Scene.GetBucketBuffer());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, BucketCountBinding, BucketCountBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, VisibleRefBinding, VisibleRefBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, CounterBinding, CounterBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, BucketOffsetBinding, BucketOffsetBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, CommandBinding, CommandBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, VisibleInstanceBinding, VisibleInstanceBuffer);
+    if (CulledGroupCount > 1) { glBindBufferBase(GL_SHADER_STORAGE_BUFFER, MaterialGroupBinding, MaterialGroupBuffer); }
+
+    Vec4 Planes[Frustum::PlaneCount];
+    for (int i = 0; i < Frustum::PlaneCount; ++i) {
+        Planes[i] = Vec4(View.ViewFrustum.Planes[i].Normal, View.ViewFrustum.Planes[i].Distance);
+    }
+
+    // A failed reload keeps the previous program, so each is there once Initialize succeeded
+    const ComputeProgram& CullKernel = *Shaders.GetCompute(CullProgram);
+    CullKernel.Use();
+    CullKernel.SetUInt("uInstanceCount", InstanceCount);
+    CullKernel.SetUInt("uBucketCount", BucketCount);
+    CullKernel.SetUInt("uGroupCount", CulledGroupCount);
+    CullKernel.SetVec4Array("uFrustumPlanes", Planes, Frustum::PlaneCount);
+    CullKernel.SetVec3("uCameraPosition", View.Position);
+    CullKernel.SetFloat("uLODScale", View.LODScale);
+
+    const bool UseOcclusion = Occlusion != nullptr && Occlusion->IsValid();
+    CullKernel.SetInt("uOcclusionEnabled", UseOcclusion ? 1 : 0);
+    if (UseOcclusion) {
+        Occlusion->Bind(0);
+        CullKernel.SetInt("uHiZ", 0);
+        CullKernel.SetMat4("uOcclusionViewProjection", GetClipToTexture() * Occlusion->GetViewProjection());
+        CullKernel.SetVec2("uHiZSize", Occlusion->GetSize());
+        CullKernel.SetFloat("uHiZMaxLevel", static_cast<float>(Occlusion->GetLevelCount() - 1));
+    }
+    CullKernel.Dispatch(ComputeProgram::GetGroupCount(InstanceCount, CullGroupSize));
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+    const ComputeProgram& BuildKernel = *Shaders.GetCompute(BuildProgram);
+    BuildKernel.Use();
+    BuildKernel.SetUInt("uBucketCount", BucketCount);
+    BuildKernel.SetUInt("uGroupCount", CulledGroupCount);
+    BuildKernel.Dispatch(1);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_COMMAND_BARRIER_BIT);
+
+    Shaders.GetCompute(ScatterProgram)->Use();
+    glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, CounterBuffer);
+    glDispatchComputeIndirect(DispatchOffset);
+    glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, 0);
+    glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_COMMAND_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+
+    if (!CollectStats) { return; }
+    PollReadback();
+    QueueReadback();
+    ++FrameNumber;
+}
+
+void GPUCulling::Draw(const GPUScene& Scene) const {
+    const auto MaxDraws = static_cast<GLsizei>(Scene.GetBucketCount());
+    if (MaxDraws == 0) { return; }
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, CommandBuffer);
+    if (CulledGroupCount > 1) {
+        // Every group's range, empty commands included
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, MaxDraws * static_cast<GLsizei>(CulledGroupCount), 0);
+    } else if (GLCapabilities::Get().IndirectCount) {
+        glBindBuffer(GL_PARAMETER_BUFFER, CounterBuffer);
+        glMultiDrawElementsIndirectCount(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, DrawCountOffset, MaxDraws, 0);
+        glBindBuffer(GL_PARAMETER_BUFFER, 0);
+    } else {
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, MaxDraws, 0);
+    }
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+void GPUCulling::Draw(const GPUScene& Scene, uint32_t Group) const {
+    if (CulledGroupCount <= 1) {
+        if (Group == 0) { Draw(Scene); }
+        return;
+    }
+    const uint32_t BucketCount = Scene.GetBucketCount();
+    if (BucketCount == 0 || Group >= CulledGroupCount) { return; }
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, CommandBuffer);
+    const size_t Offset = static_cast<size_t>(Group) * BucketCount * sizeof(DrawElementsIndirectCommand);
+    glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, reinterpret_cast<const void*>(Offset),
+                                static_cast<GLsizei>(BucketCount), 0);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+void GPUCulling::SetMaterialGroups(const std::vector<uint32_t>& Groups, uint32_t InGroupCount) {
+    GroupCount = std::max(InGroupCount, 1u);
+    if (GroupCount == 1) { return; }
+    if (MaterialGroupBuffer == 0) { glGenBuffers(1, &MaterialGroupBuffer); }
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, MaterialGroupBuffer);
+    // Never empty, so the kernel's array has a size to test against
+    const uint32_t Fallback = 0;
+    glBufferData(GL_SHADER_STORAGE_BUFFER, static_cast<GLsizeiptr>(std::max<size_t>(Groups.size(), 1) * sizeof(uint32_t)),
+                 Groups.empty() ? &Fallback : Groups.data(), GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+void GPUCulling::QueueReadback() {
+    const uint32_t Slot = FrameNumber % ReadbackFrames;
+    // Still pending after a full ring: drop it rather than wait
+    if (ReadbackFences[Slot] != nullptr) { glDeleteSync(static_cast<GLsync>(ReadbackFences[Slot])); }
+
+    glBindBuffer(GL_COPY_READ_BUFFER, CounterBuffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, ReadbackBuffers[Slot]);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, sizeof(GPUCounters));
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    ReadbackFences[Slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    ReadbackFrameNumbers[Slot] = FrameNumber;
+}
+
+void GPUCulling::PollReadback() {
+    // Newest completed copy wins; older ones are simply released
+    for (uint32_t Age = ReadbackFrames; Age > 0; --Age) {
+        if (FrameNumber < Age) { continue; }
+        const uint32_t Slot = (FrameNumber - Age) % ReadbackFrames;
+        auto Fence = static_cast<GLsync>(ReadbackFences[Slot]);
+        if (Fence == nullptr) { continue; }
+
+        const GLenum Status = glClientWaitSync(Fence, 0, 0);
+        if (Status != GL_ALREADY_SIGNALED && Status != GL_CONDITION_SATISFIED) { continue; }
+
+        GPUCounters Counters{};
+        glBindBuffer(GL_COPY_READ_BUFFER, ReadbackBuffers[Slot]);
+        glGetBufferSubData(GL_COPY_READ_BUFFER, 0, sizeof(GPUCounters), &Counters);
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+        glDeleteSync(Fence);
+        ReadbackFences[Slot] = nullptr;
+
+        LastStats.VisibleCount = Counters.VisibleCount;
+        LastStats.DrawCount = Counters.DrawCount;
+        LastStats.FrustumCulledCount = Counters.FrustumCulledCount;
+        LastStats.OcclusionCulledCount = Counters.OcclusionCulledCount;
+        LastStats.Latency = static_cast<uint32_t>(FrameNumber - ReadbackFrameNumbers[Slot]);
+    }
+}
+
+void GPUCulling::EnsureCapacity(uint32_t InstanceCount, uint32_t BucketCount) {
+    if (InstanceCount > InstanceCapacity || VisibleRefBuffer == 0) {
+        InstanceCapacity = std::max(InstanceCount, std::max(InstanceCapacity * 2, 1024u));
+        CreateStorage(VisibleRefBuffer, InstanceCapacity * sizeof(uint32_t) * 3);
+        CreateStorage(VisibleInstanceBuffer, InstanceCapacity * sizeof(uint32_t));
+        ++BufferGeneration;
+    }
+    if (BucketCount > BucketCapacity || CommandBuffer == 0) {
+        BucketCapacity = std::max(BucketCount, std::max(BucketCapacity * 2, 64u));
+        CreateStorage(BucketCountBuffer, BucketCapacity * sizeof(uint32_t));
+        CreateStorage(BucketOffsetBuffer, BucketCapacity * sizeof(uint32_t));
+        CreateStorage(CommandBuffer, BucketCapacity * sizeof(DrawElementsIndirectCommand));
+    }
+}
+
+} // namespace Volante
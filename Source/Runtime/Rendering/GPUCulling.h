@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "GPUScene.h"
+#include "RenderView.h"
+#include "ShaderLibrary.h"
+
+namespace Volante {
+
+class HiZBuffer;
+
+// Counters written by the kernels, read back a few frames late.
+struct GPUCullingStats {
+    uint32_t VisibleCount = 0;
+    uint32_t DrawCount = 0;
+    uint32_t FrustumCulledCount = 0;
+    uint32_t OcclusionCulledCount = 0;
+
+    // Frames between the cull these counts describe and the frame that read them.
+    uint32_t Latency = 0;
+};
+
+// GL 4.3 compute path: frustum culls every instance, picks its LOD and writes one compacted
+// DrawElementsIndirectCommand per non-empty (mesh, LOD) bucket, all without a CPU readback.
+//
+//   Cull:    one thread per instance (frustum, distance, then Hi-Z occlusion when a pyramid
+//            is given); visible ones bump their bucket's counter
+//   Build:   one workgroup scans the bucket counters into instance offsets and commands
+//   Scatter: indirect dispatch sized by Build; writes instance ids into their bucket's range
+//
+// The visible instance buffer is bound as a per-instance vertex attribute, so BaseInstance
+// alone selects each command's range (no ARB_shader_draw_parameters needed).
+//
+// Without bindless textures one multi-draw cannot switch textures, so the draws can be split
+// into material groups (SetMaterialGroups): every bucket then gets one command per group, and
+// Draw(Scene, Group) draws one group's range with that group's textures bound.
+//
+// The kernels are Cull.comp, CullBuildCommands.comp and CullScatter.comp, loaded through
+// Shaders, which rebuilds them when they are edited.
+class GPUCulling {
+public:
+    explicit GPUCulling(ShaderLibrary& Shaders) : Shaders(Shaders) {}
+    ~GPUCulling();
+
+    GPUCulling(const GPUCulling&) = delete;
+    GPUCulling& operator=(const GPUCulling&) = delete;
+
+    // False when compute is unavailable or a kernel failed to compile; the caller then falls
+    // back to CPU culling.
+    bool Initialize();
+    void Shutdown();
+
+    // Occlusion may be null or not yet valid, in which case only frustum and distance apply.
+    // Secondary views (shadow cascades) pass CollectStats = false to keep GetLastStats() about
+    // the main view.
+    void Cull(const GPUScene& Scene, const RenderView& View, const HiZBuffer* Occlusion = nullptr, bool CollectStats = true);
+
+    // Issues the multi-draw, every group included. The caller binds the VAO (with
+    // GetVisibleInstanceBuffer() as the instance attribute) and the draw program.
+    void Draw(const GPUScene& Scene) const;
+    // Only the instances whose material is in Group, as of the last Cull.
+    void Draw(const GPUScene& Scene, uint32_t Group) const;
+
+    // Groups[Material] is the material's group, below GroupCount; materials past the end are
+    // in group 0. A GroupCount of 1 (the default) does not split. Applies from the next Cull.
+    void SetMaterialGroups(const std::vector<uint32_t>& Groups, uint32_t GroupCount);
+
+    [[nodiscard]] unsigned int GetVisibleInstanceBuffer() const { return VisibleInstanceBuffer; }
+
+    // Most recent counters whose copy has completed on the GPU. Never waits: the counters are
+    // copied into a small ring each frame and only polled once their fence has signalled.
+    [[nodiscard]] const GPUCullingStats& GetLastStats() const { return LastStats; }
+
+    // Bumped when the visible instance buffer is recreated.
+    [[nodiscard]] uint32_t GetBufferGeneration() const { return BufferGeneration; }
+
+private:
+    static constexpr uint32_t ReadbackFrames = 3;
+
+    void EnsureCapacity(uint32_t InstanceCount, uint32_t BucketCount);
+    void QueueReadback();
+    void PollReadback();
+
+    ShaderLibrary& Shaders;
+    ShaderProgramId CullProgram = InvalidShaderProgramId;
+    ShaderProgramId BuildProgram = InvalidShaderProgramId;
+    ShaderProgramId ScatterProgram = InvalidShaderProgramId;
+
+    unsigned int BucketCountBuffer = 0;
+    unsigned int BucketOffsetBuffer = 0;
+    unsigned int CommandBuffer = 0;
+    unsigned int VisibleRefBuffer = 0;
+    unsigned int VisibleInstanceBuffer = 0;
+    unsigned int CounterBuffer = 0;
+    unsigned int MaterialGroupBuffer = 0;
+
+    uint32_t InstanceCapacity = 0;
+    uint32_t BucketCapacity = 0;
+    uint32_t BufferGeneration = 0;
+    uint32_t GroupCount = 1;
+    // GroupCount when the commands were last built
+    uint32_t CulledGroupCount = 1;
+
+    unsigned int ReadbackBuffers[ReadbackFrames] = {};
+    void* ReadbackFences[ReadbackFrames] = {};
+    uint64_t ReadbackFrameNumbers[ReadbackFrames] = {};
+    uint64_t FrameNumber = 0;
+    GPUCullingStats LastStats;
+};
+
+} // namespace Volante
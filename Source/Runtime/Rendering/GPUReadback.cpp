@@ -0,0 +1,181 @@
+#include "GPUReadback.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#include "Runtime/Core/Misc/Utility.h"
+#include "Runtime/Core/Stats/StatCounters.h"
+
+namespace Volante {
+
+GPUReadback::GPUReadback(const GPUReadbackDesc& Desc) : Desc(Desc) {}
+
+GPUReadback::~GPUReadback() {
+    Shutdown();
+}
+
+bool GPUReadback::Initialize() {
+    if (!Slots.empty()) { return true; }
+    Slots.resize(std::max(Desc.SlotCount, 1u));
+    for (Slot& Entry : Slots) { glGenBuffers(1, &Entry.Buffer); }
+    glGenFramebuffers(1, &ReadFramebuffer);
+    if (Slots.front().Buffer == 0 || ReadFramebuffer == 0) {
+        std::cerr << "ERROR::GPU_READBACK::CREATE_FAILED" << std::endl;
+        Shutdown();
+        return false;
+    }
+    return true;
+}
+
+void GPUReadback::Shutdown() {
+    for (Slot& Entry : Slots) {
+        if (Entry.Fence) { glDeleteSync(static_cast<GLsync>(Entry.Fence)); }
+        if (Entry.Buffer != 0) { glDeleteBuffers(1, &Entry.Buffer); }
+    }
+    Slots.clear();
+    Head = 0;
+    Count = 0;
+    if (ReadFramebuffer != 0) { glDeleteFramebuffers(1, &ReadFramebuffer); }
+    ReadFramebuffer = 0;
+}
+
+bool GPUReadback::Read(int X, int Y, int Width, int Height, unsigned int Format, unsigned int Type, Callback Done) {
+    const size_t PixelSize = GetPixelSize(Format, Type);
+    if (Slots.empty() || Width <= 0 || Height <= 0 || PixelSize == 0) { return false; }
+    // A loop, not an if: a callback run from here may issue a read of its own and refill the ring
+    while (Count == Slots.size()) {
+        ++Stats.Stalls;
+        CompleteOldest(true);
+    }
+
+    Slot& Entry = Slots[(Head + Count) % Slots.size()];
+    Entry.Size = static_cast<size_t>(Width) * static_cast<size_t>(Height) * PixelSize;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, Entry.Buffer);
+    if (Entry.Capacity < Entry.Size) {
+        glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(Entry.Size), nullptr, GL_STREAM_READ);
+        Entry.Capacity = Entry.Size;
+    }
+    GLint Alignment = 4;
+    glGetIntegerv(GL_PACK_ALIGNMENT, &Alignment);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    // Into the buffer: returns once the copy is queued
+    glReadPixels(X, Y, Width, Height, Format, Type, nullptr);
+    glPixelStorei(GL_PACK_ALIGNMENT, Alignment);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    Entry.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    Entry.Done = std::move(Done);
+    ++Count;
+
+    ++Stats.ReadCount;
+    Stats.BytesRead += Entry.Size;
+    StatCounters::Add(StatCounter::ReadbackBytes, static_cast<int64_t>(Entry.Size));
+    return true;
+}
+
+bool GPUReadback::ReadTexture(unsigned int Texture, int X, int Y, int Width, int Height, unsigned int Format,
+                              unsigned int Type, Callback Done) {
+    if (ReadFramebuffer == 0 || Texture == 0) { return false; }
+    GLenum Attachment = GL_COLOR_ATTACHMENT0;
+    if (Format == GL_DEPTH_COMPONENT) {
+        Attachment = GL_DEPTH_ATTACHMENT;
+    } else if (Format == GL_DEPTH_STENCIL) {
+        Attachment = GL_DEPTH_STENCIL_ATTACHMENT;
+    }
+    GLint Previous = 0;
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &Previous);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, ReadFramebuffer);
+    glFramebufferTexture2D(GL_READ_FRAMEBUFFER, Attachment, GL_TEXTURE_2D, Texture, 0);
+    glReadBuffer(Attachment == GL_COLOR_ATTACHMENT0 ? GL_COLOR_ATTACHMENT0 : GL_NONE);
+    const bool Issued = Read(X, Y, Width, Height, Format, Type, std::move(Done));
+    // Detached, so the framebuffer does not keep a deleted texture alive
+    glFramebufferTexture2D(GL_READ_FRAMEBUFFER, Attachment, GL_TEXTURE_2D, 0, 0);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, static_cast<GLuint>(Previous));
+    return Issued;
+}
+
+void GPUReadback::Poll() {
+    while (Count > 0 && CompleteOldest(false)) {}
+}
+
+void GPUReadback::Flush() {
+    while (Count > 0) { CompleteOldest(true); }
+}
+
+bool GPUReadback::CompleteOldest(bool Wait) {
+    Slot& Entry = Slots[Head];
+    const auto Fence = static_cast<GLsync>(Entry.Fence);
+    // Flushing makes sure the fence is on its way, or a frame without a swap would never see it
+    const GLenum Status = glClientWaitSync(Fence, GL_SYNC_FLUSH_COMMANDS_BIT, Wait ? FenceTimeout : 0);
+    if (Status == GL_TIMEOUT_EXPIRED && !Wait) { return false; }
+    glDeleteSync(Fence);
+    Entry.Fence = nullptr;
+
+    // A wait that timed out or failed gives up on the read rather than mapping a buffer the
+    // GPU may still be writing
+    const void* Data = nullptr;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, Entry.Buffer);
+    if (Status == GL_ALREADY_SIGNALED || Status == GL_CONDITION_SATISFIED) {
+        Data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, static_cast<GLsizeiptr>(Entry.Size), GL_MAP_READ_BIT);
+    } else {
+        std::cerr << "ERROR::GPU_READBACK::WAIT_FAILED" << std::endl;
+    }
+    if (Data) {
+        Pixels.resize(Entry.Size);
+        std::memcpy(Pixels.data(), Data, Entry.Size);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    } else {
+        Pixels.clear();
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    // Off the ring first: the callback may issue reads of its own
+    const Callback Done = std::move(Entry.Done);
+    Entry.Done = {};
+    Head = (Head + 1) % static_cast<uint32_t>(Slots.size());
+    --Count;
+    if (Done) { Done(Pixels); }
+    return true;
+}
+
+size_t GPUReadback::GetPixelSize(unsigned int Format, unsigned int Type) {
+    size_t Components = 0;
+    switch (Format) {
+    case GL_RED:
+    case GL_RED_INTEGER:
+    case GL_DEPTH_COMPONENT:
+    case GL_STENCIL_INDEX:
+    case GL_DEPTH_STENCIL: Components = 1; break;
+    case GL_RG:
+    case GL_RG_INTEGER: Components = 2; break;
+    case GL_RGB:
+    case GL_BGR:
+    case GL_RGB_INTEGER: Components = 3; break;
+    case GL_RGBA:
+    case GL_BGRA:
+    case GL_RGBA_INTEGER: Components = 4; break;
+    default: return 0;
+    }
+    // Packed types hold the whole pixel
+    switch (Type) {
+    case GL_UNSIGNED_BYTE:
+    case GL_BYTE: return Components;
+    case GL_UNSIGNED_SHORT:
+    case GL_SHORT:
+    case GL_HALF_FLOAT: return Components * 2;
+    case GL_UNSIGNED_INT:
+    case GL_INT:
+    case GL_FLOAT: return Components * 4;
+    case GL_UNSIGNED_INT_24_8:
+    case GL_UNSIGNED_INT_2_10_10_10_REV:
+    case GL_UNSIGNED_INT_10F_11F_11F_REV:
+    case GL_UNSIGNED_INT_8_8_8_8:
+    case GL_UNSIGNED_INT_8_8_8_8_REV: return 4;
+    case GL_FLOAT_32_UNSIGNED_INT_24_8_REV: return 8;
+    default: return 0;
+    }
+}
+
+} // namespace Volante
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace Volante {
+
+struct GPUReadbackDesc {
+    // Reads in flight. Reads finish within two or three frames, so a few per frame fit.
+    uint32_t SlotCount = 6;
+};
+
+// Totals since Initialize.
+struct GPUReadbackStats {
+    uint64_t ReadCount = 0;
+    uint64_t BytesRead = 0;
+    // A read found every slot in flight and waited for the oldest
+    uint32_t Stalls = 0;
+};
+
+// glReadPixels without the stall: each read goes into a pixel pack buffer from a ring and is
+// fenced, and its callback runs from Poll once the fence has passed, usually a frame or two
+// later. Only then is the buffer mapped, so the map is a copy and never waits on the GPU.
+// Callbacks run in the order reads were issued.
+//
+// A full ring waits for its oldest read rather than dropping the new one, so frame captures
+// stay complete; Stats.Stalls counts those waits. Main thread, with the context current.
+class GPUReadback {
+public:
+    // Pixels are tightly packed rows, bottom row first, or empty if the read was lost: its fence
+    // timed out or failed, or the buffer could not be mapped. The callback may move from them,
+    // e.g. to hand them to another thread.
+    using Callback = std::function<void(std::vector<uint8_t>& Pixels)>;
+
+    explicit GPUReadback(const GPUReadbackDesc& Desc = {});
+    ~GPUReadback();
+
+    GPUReadback(const GPUReadback&) = delete;
+    GPUReadback& operator=(const GPUReadback&) = delete;
+
+    bool Initialize();
+    // Pending reads are dropped without their callbacks; Flush first to keep them.
+    void Shutdown();
+
+    // From the framebuffer bound to GL_READ_FRAMEBUFFER, with glReadPixels' Format and Type.
+    // Returns false for an empty rectangle or a format it cannot size.
+    bool Read(int X, int Y, int Width, int Height, unsigned int Format, unsigned int Type, Callback Done);
+
+    // From level 0 of a single-sample 2D texture, through a framebuffer of its own. Format
+    // GL_DEPTH_COMPONENT reads a depth texture. The read framebuffer binding is kept.
+    bool ReadTexture(unsigned int Texture, int X, int Y, int Width, int Height, unsigned int Format, unsigned int Type,
+                     Callback Done);
+
+    // Once per frame: runs the callbacks of the reads the GPU has finished, without waiting.
+    void Poll();
+
+    // Waits for every read and runs its callback.
+    void Flush();
+
+    [[nodiscard]] uint32_t GetPendingCount() const { return Count; }
+
+    [[nodiscard]] const GPUReadbackStats& GetStats() const { return Stats; }
+
+    // Bytes per pixel glReadPixels writes for Format and Type, or 0 if not a combination it knows.
+    [[nodiscard]] static size_t GetPixelSize(unsigned int Format, unsigned int Type);
+
+private:
+    struct Slot {
+        unsigned int Buffer = 0;
+        size_t Capacity = 0;
+        size_t Size = 0;
+        void* Fence = nullptr;
+        Callback Done;
+    };
+
+    // Maps the oldest read and runs its callback; unless Wait, only if it has finished
+    bool CompleteOldest(bool Wait);
+
+    GPUReadbackDesc Desc;
+    GPUReadbackStats Stats;
+    std::vector<Slot> Slots;
+    // Oldest read in flight, and how many there are
+    uint32_t Head = 0;
+    uint32_t Count = 0;
+    unsigned int ReadFramebuffer = 0;
+    // Handed to callbacks; reused unless one moves from it
+    std::vector<uint8_t> Pixels;
+};
+
+} // namespace Volante
@@ -0,0 +1,203 @@
+#include "GPUScene.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+
+#include "Runtime/Spatial/SpatialIndex.h"
+
+namespace Volante {
+
+namespace {
+
+// (Re)creates Buffer when it is missing or too small; returns true when it was recreated.
+bool EnsureBuffer(unsigned int& Buffer, GLenum Target, size_t Bytes, size_t& Capacity) {
+    if (Buffer != 0 && Bytes <= Capacity) { return false; }
+    if (Buffer != 0) { glDeleteBuffers(1, &Buffer); }
+    Capacity = std::max<size_t>(Bytes, Capacity * 2);
+    glGenBuffers(1, &Buffer);
+    glBindBuffer(Target, Buffer);
+    glBufferData(Target, static_cast<GLsizeiptr>(std::max<size_t>(Capacity, 1)), nullptr, GL_DYNAMIC_DRAW);
+    return true;
+}
+
+void UploadWhole(unsigned int& Buffer, GLenum Target, const void* Data, size_t Bytes) {
+    if (Buffer == 0) { glGenBuffers(1, &Buffer); }
+    glBindBuffer(Target, Buffer);
+    glBufferData(Target, static_cast<GLsizeiptr>(std::max<size_t>(Bytes, 1)), Data, GL_STATIC_DRAW);
+}
+
+} // namespace
+
+GPUScene::~GPUScene() {
+    Release();
+}
+
+RenderMeshId GPUScene::AddMesh(const std::vector<MeshLOD>& Lods) {
+    GPUMeshInfo Info;
+    Info.FirstBucket = static_cast<uint32_t>(Buckets.size());
+    Info.LODCount = static_cast<uint32_t>(std::min<size_t>(Lods.size(), MaxMeshLODs));
+
+    AABB Bounds;
+    for (uint32_t i = 0; i < Info.LODCount; ++i) {
+        const MeshLOD& Lod = Lods[i];
+        GPUDrawBucket Bucket;
+        Bucket.IndexCount = static_cast<uint32_t>(Lod.Indices.size());
+        Bucket.FirstIndex = static_cast<uint32_t>(Indices.size());
+        Bucket.BaseVertex = static_cast<int32_t>(Vertices.size());
+        Buckets.push_back(Bucket);
+
+        Vertices.insert(Vertices.end(), Lod.Vertices.begin(), Lod.Vertices.end());
+        Indices.insert(Indices.end(), Lod.Indices.begin(), Lod.Indices.end());
+        Info.LODDistances[i] = Lod.MaxDistance;
+        for (const Vertex& V : Lod.Vertices) {
+            Bounds.Expand(V.position);
+        }
+    }
+
+    Meshes.push_back(Info);
+    MeshBounds.push_back(Bounds.IsValid() ? Bounds : AABB(Vec3(0.0f), Vec3(0.0f)));
+    GeometryDirty = true;
+    MeshesDirty = true;
+    return static_cast<RenderMeshId>(Meshes.size() - 1);
+}
+
+RenderInstanceId GPUScene::AddInstance(RenderMeshId Mesh, const Mat4& Transform, uint32_t MaterialIndex) {
+    RenderInstanceId Id;
+    if (!FreeIds.empty()) {
+        Id = FreeIds.back();
+        FreeIds.pop_back();
+    } else {
+        Id = static_cast<RenderInstanceId>(Instances.size());
+        Instances.emplace_back();
+    }
+
+    GPUInstance& Instance = Instances[Id];
+    Instance.Model = Transform;
+    Instance.MeshIndex = Mesh;
+    Instance.Flags = InstanceAlive;
+    Instance.MaterialIndex = MaterialIndex;
+    UpdateBounds(Instance);
+    RecordBounds(Instance);
+    MarkDirty(Id);
+    ++MaterialGeneration;
+    if (Spatial) {
+        Proxies.resize(Instances.size(), InvalidSpatialId);
+        Proxies[Id] = Spatial->AddProxy(GetBounds(Instance), Id);
+    }
+    return Id;
+}
+
+void GPUScene::SetTransform(RenderInstanceId Id, const Mat4& Transform) {
+    GPUInstance& Instance = Instances[Id];
+    RecordBounds(Instance);
+    Instance.Model = Transform;
+    UpdateBounds(Instance);
+    RecordBounds(Instance);
+    MarkDirty(Id);
+    if (Spatial) { Spatial->MoveProxy(Proxies[Id], GetBounds(Instance)); }
+}
+
+void GPUScene::SetMaterial(RenderInstanceId Id, uint32_t MaterialIndex) {
+    Instances[Id].MaterialIndex = MaterialIndex;
+    ++MaterialGeneration;
+    MarkDirty(Id);
+}
+
+void GPUScene::RemoveInstance(RenderInstanceId Id) {
+    RecordBounds(Instances[Id]);
+    Instances[Id].Flags = 0;
+    FreeIds.push_back(Id);
+    MarkDirty(Id);
+    if (Spatial) {
+        Spatial->RemoveProxy(Proxies[Id]);
+        Proxies[Id] = InvalidSpatialId;
+    }
+}
+
+void GPUScene::SetOccluder(RenderInstanceId Id, bool Occluder) {
+    GPUInstance& Instance = Instances[Id];
+    Instance.Flags = Occluder ? (Instance.Flags | InstanceOccluder) : (Instance.Flags & ~InstanceOccluder);
+    MarkDirty(Id);
+}
+
+void GPUScene::Sync(bool UseStorageBuffers) {
+    if (GeometryDirty) {
+        UploadWhole(VertexBuffer, GL_ARRAY_BUFFER, Vertices.data(), Vertices.size() * sizeof(Vertex));
+        UploadWhole(IndexBuffer, GL_ELEMENT_ARRAY_BUFFER, Indices.data(), Indices.size() * sizeof(unsigned int));
+        GeometryDirty = false;
+        ++BufferGeneration;
+    }
+
+    if (!UseStorageBuffers) {
+        DirtyBegin = ~0u;
+        DirtyEnd = 0;
+        return;
+    }
+
+    if (MeshesDirty) {
+        UploadWhole(MeshBuffer, GL_SHADER_STORAGE_BUFFER, Meshes.data(), Meshes.size() * sizeof(GPUMeshInfo));
+        UploadWhole(BucketBuffer, GL_SHADER_STORAGE_BUFFER, Buckets.data(), Buckets.size() * sizeof(GPUDrawBucket));
+        MeshesDirty = false;
+    }
+
+    const size_t Bytes = Instances.size() * sizeof(GPUInstance);
+    if (EnsureBuffer(InstanceBuffer, GL_SHADER_STORAGE_BUFFER, Bytes, InstanceCapacity)) {
+        DirtyBegin = 0;
+        DirtyEnd = static_cast<uint32_t>(Instances.size());
+        ++BufferGeneration;
+    }
+
+    if (DirtyBegin < DirtyEnd) {
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, InstanceBuffer);
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, static_cast<GLintptr>(DirtyBegin * sizeof(GPUInstance)),
+                        static_cast<GLsizeiptr>((DirtyEnd - DirtyBegin) * sizeof(GPUInstance)),
+                        Instances.data() + DirtyBegin);
+    }
+    DirtyBegin = ~0u;
+    DirtyEnd = 0;
+}
+
+void GPUScene::Release() {
+    const unsigned int Buffers[] = {VertexBuffer, IndexBuffer, InstanceBuffer, MeshBuffer, BucketBuffer};
+    for (unsigned int Buffer : Buffers) {
+        if (Buffer != 0) { glDeleteBuffers(1, &Buffer); }
+    }
+    VertexBuffer = IndexBuffer = InstanceBuffer = MeshBuffer = BucketBuffer = 0;
+    InstanceCapacity = 0;
+    GeometryDirty = !Vertices.empty();
+    MeshesDirty = !Meshes.empty();
+    DirtyBegin = 0;
+    DirtyEnd = static_cast<uint32_t>(Instances.size());
+}
+
+void GPUScene::SetSpatialIndex(SpatialIndex* Index) {
+    if (Index == Spatial) { return; }
+    if (Spatial) {
+        for (const SpatialId Proxy : Proxies) {
+            if (Proxy != InvalidSpatialId) { Spatial->RemoveProxy(Proxy); }
+        }
+    }
+    Spatial = Index;
+    Proxies.assign(Spatial ? Instances.size() : 0, InvalidSpatialId);
+    for (uint32_t Id = 0; Id < Proxies.size(); ++Id) {
+        if (Instances[Id].Flags & InstanceAlive) { Proxies[Id] = Spatial->AddProxy(GetBounds(Instances[Id]), Id); }
+    }
+}
+
+void GPUScene::UpdateBounds(GPUInstance& Instance) const {
+    const AABB World = MeshBounds[Instance.MeshIndex].Transform(Instance.Model);
+    Instance.BoundsCenter = Vec4(World.GetCenter(), 0.0f);
+    Instance.BoundsExtent = Vec4(World.GetExtent(), 0.0f);
+}
+
+void GPUScene::RecordBounds(const GPUInstance& Instance) {
+    ChangedBounds.push_back(GetBounds(Instance));
+}
+
+void GPUScene::MarkDirty(uint32_t Index) {
+    DirtyBegin = std::min(DirtyBegin, Index);
+    DirtyEnd = std::max(DirtyEnd, Index + 1);
+}
+
+} // namespace Volante
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "Mesh.h"
+#include "Runtime/Core/Math/Bounds.h"
+#include "Runtime/Spatial/SpatialPartition.h"
+
+namespace Volante {
+
+class SpatialIndex;
+
+using RenderMeshId = uint32_t;
+using RenderInstanceId = uint32_t;
+constexpr uint32_t InvalidRenderId = ~0u;
+
+constexpr uint32_t MaxMeshLODs = 4;
+
+struct MeshLOD {
+    std::vector<Vertex> Vertices;
+    std::vector<unsigned int> Indices;
+
+    // Used up to this camera distance; past the last LOD's distance the instance is culled.
+    float MaxDistance = std::numeric_limits<float>::max();
+};
+
+// GPU-side layouts, mirrored by the std430 structs in the culling and draw shaders.
+struct GPUInstance {
+    Mat4 Model = Mat4(1.0f);
+    Vec4 BoundsCenter = Vec4(0.0f);
+    Vec4 BoundsExtent = Vec4(0.0f);
+    uint32_t MeshIndex = 0;
+    uint32_t Flags = 0;
+    // Index into the renderer's MaterialSystem
+    uint32_t MaterialIndex = 0;
+    uint32_t Pad = 0;
+};
+static_assert(sizeof(GPUInstance) == 112);
+
+struct GPUMeshInfo {
+    uint32_t FirstBucket = 0;
+    uint32_t LODCount = 0;
+    uint32_t Pad[2] = {0, 0};
+    float LODDistances[MaxMeshLODs] = {};
+};
+static_assert(sizeof(GPUMeshInfo) == 32);
+
+// One (mesh, LOD) pair: the unit of a multi-draw command.
+struct GPUDrawBucket {
+    uint32_t IndexCount = 0;
+    uint32_t FirstIndex = 0;
+    int32_t BaseVertex = 0;
+    uint32_t Pad = 0;
+};
+static_assert(sizeof(GPUDrawBucket) == 16);
+
+// Matches DrawElementsIndirectCommand.
+struct DrawElementsIndirectCommand {
+    uint32_t Count = 0;
+    uint32_t InstanceCount = 0;
+    uint32_t FirstIndex = 0;
+    int32_t BaseVertex = 0;
+    uint32_t BaseInstance = 0;
+};
+static_assert(sizeof(DrawElementsIndirectCommand) == 20);
+
+enum GPUInstanceFlags : uint32_t {
+    InstanceAlive = 1u << 0,
+    // Rasterized by the CPU path's software occlusion culling
+    InstanceOccluder = 1u << 1,
+};
+
+// Every mesh in one shared vertex/index buffer and every instance in one array, so a whole
+// scene can be drawn from a single VAO with one multi-draw call. Instances are edited on the
+// CPU copy and the dirty range is uploaded by Sync() once per frame.
+class GPUScene {
+public:
+    GPUScene() = default;
+    ~GPUScene();
+
+    GPUScene(const GPUScene&) = delete;
+    GPUScene& operator=(const GPUScene&) = delete;
+
+    RenderMeshId AddMesh(const std::vector<MeshLOD>& Lods);
+    RenderMeshId AddMesh(const Mesh& Source) { return AddMesh(std::vector<MeshLOD>{{Source.vertices, Source.indices}}); }
+    RenderMeshId AddMesh(const MeshData& Source) { return AddMesh(std::vector<MeshLOD>{{Source.Vertices, Source.Indices}}); }
+
+    RenderInstanceId AddInstance(RenderMeshId Mesh, const Mat4& Transform, uint32_t MaterialIndex = 0);
+    void SetTransform(RenderInstanceId Id, const Mat4& Transform);
+    void SetMaterial(RenderInstanceId Id, uint32_t MaterialIndex);
+    void RemoveInstance(RenderInstanceId Id);
+    void SetOccluder(RenderInstanceId Id, bool Occluder);
+
+    // Uploads geometry added since the last call and the dirty instance range. Requires a
+    // current context.
+    void Sync(bool UseStorageBuffers);
+    void Release();
+
+    [[nodiscard]] const std::vector<GPUInstance>& GetInstances() const { return Instances; }
+
+    [[nodiscard]] const std::vector<GPUMeshInfo>& GetMeshes() const { return Meshes; }
+
+    [[nodiscard]] const std::vector<GPUDrawBucket>& GetBuckets() const { return Buckets; }
+
+    [[nodiscard]] const std::vector<Vertex>& GetVertices() const { return Vertices; }
+
+    [[nodiscard]] const std::vector<unsigned int>& GetIndices() const { return Indices; }
+
+    [[nodiscard]] uint32_t GetInstanceCount() const { return static_cast<uint32_t>(Instances.size()); }
+
+    [[nodiscard]] uint32_t GetLiveInstanceCount() const { return GetInstanceCount() - static_cast<uint32_t>(FreeIds.size()); }
+
+    [[nodiscard]] uint32_t GetBucketCount() const { return static_cast<uint32_t>(Buckets.size()); }
+
+    [[nodiscard]] unsigned int GetVertexBuffer() const { return VertexBuffer; }
+
+    [[nodiscard]] unsigned int GetIndexBuffer() const { return IndexBuffer; }
+
+    // Only valid when Sync ran with UseStorageBuffers.
+    [[nodiscard]] unsigned int GetInstanceBuffer() const { return InstanceBuffer; }
+
+    [[nodiscard]] unsigned int GetMeshBuffer() const { return MeshBuffer; }
+
+    [[nodiscard]] unsigned int GetBucketBuffer() const { return BucketBuffer; }
+
+    // Bumped whenever a buffer is recreated, so users can rebuild VAOs that reference it.
+    [[nodiscard]] uint32_t GetBufferGeneration() const { return BufferGeneration; }
+
+    // Bumped when instances are added or change material, so material-sorted orders can be
+    // rebuilt only then.
+    [[nodiscard]] uint32_t GetMaterialGeneration() const { return MaterialGeneration; }
+
+    // World bounds touched since the last ClearChangedBounds(): new bounds of added and moved
+    // instances and old bounds of moved and removed ones. Lets cached views (shadow maps)
+    // refresh only where something changed.
+    [[nodiscard]] const std::vector<AABB>& GetChangedBounds() const { return ChangedBounds; }
+
+    void ClearChangedBounds() { ChangedBounds.clear(); }
+
+    // Keeps a proxy per live instance in Index, with the instance id as its user data, so CPU
+    // passes can query the instances in a region instead of testing them all. Instances already
+    // added get theirs now; null removes them.
+    void SetSpatialIndex(SpatialIndex* Index);
+
+    [[nodiscard]] SpatialIndex* GetSpatialIndex() const { return Spatial; }
+
+    [[nodiscard]] static AABB GetBounds(const GPUInstance& Instance) {
+        return AABB::FromCenterExtent(Vec3(Instance.BoundsCenter), Vec3(Instance.BoundsExtent));
+    }
+
+private:
+    void UpdateBounds(GPUInstance& Instance) const;
+    void MarkDirty(uint32_t Index);
+    void RecordBounds(const GPUInstance& Instance);
+
+    std::vector<Vertex> Vertices;
+    std::vector<unsigned int> Indices;
+    std::vector<GPUMeshInfo> Meshes;
+    std::vector<AABB> MeshBounds;
+    std::vector<GPUDrawBucket> Buckets;
+
+    std::vector<GPUInstance> Instances;
+    std::vector<RenderInstanceId> FreeIds;
+    std::vector<AABB> ChangedBounds;
+
+    SpatialIndex* Spatial = nullptr;
+    // Per instance while Spatial is set
+    std::vector<SpatialId> Proxies;
+
+    uint32_t DirtyBegin = ~0u;
+    uint32_t DirtyEnd = 0;
+    bool GeometryDirty = false;
+    bool MeshesDirty = false;
+
+    unsigned int VertexBuffer = 0;
+    unsigned int IndexBuffer = 0;
+    unsigned int InstanceBuffer = 0;
+    unsigned int MeshBuffer = 0;
+    unsigned int BucketBuffer = 0;
+    size_t InstanceCapacity = 0;
+    uint32_t BufferGeneration = 0;
+    uint32_t MaterialGeneration = 0;
+};
+
+} // namespace Volante
@@ -0,0 +1,94 @@
+#include "GPUTimers.h"
+
+#include <glad/glad.h>
+
+namespace Volante {
+
+namespace {
+
+bool IsAvailable(GLuint Query) {
+    GLint Available = 0;
+    glGetQueryObjectiv(Query, GL_QUERY_RESULT_AVAILABLE, &Available);
+    return Available != 0;
+}
+
+} // namespace
+
+GPUTimers::~GPUTimers() {
+    Shutdown();
+}
+
+void GPUTimers::Initialize() {
+    for (FrameQueries& Queries : Frames) {
+        glGenQueries(StatTimerCount * 2, &Queries.Timestamps[0][0]);
+        glGenQueries(1, &Queries.Primitives);
+    }
+    Initialized = true;
+}
+
+void GPUTimers::Shutdown() {
+    if (!Initialized) { return; }
+    for (FrameQueries& Queries : Frames) {
+        glDeleteQueries(StatTimerCount * 2, &Queries.Timestamps[0][0]);
+        glDeleteQueries(1, &Queries.Primitives);
+        Queries = {};
+    }
+    Initialized = false;
+}
+
+void GPUTimers::BeginFrame() {
+    if (!Initialized) { return; }
+    Frame = (Frame + 1) % FrameLatency;
+    FrameQueries& Queries = Frames[Frame];
+    for (uint32_t i = 0; i < StatTimerCount; ++i) {
+        if (!Owned[i]) { continue; }
+        // A pass that did not run that frame (e.g. cached shadows) took no time
+        if (!Queries.TimerIssued[i]) {
+            StatCounters::SetGpuTime(static_cast<StatTimer>(i), 0);
+            LatestMs[i] = 0.0f;
+            continue;
+        }
+        // The end stamp was issued last, so it finishing implies the start did
+        if (IsAvailable(Queries.Timestamps[i][1])) {
+            GLuint64 Start = 0;
+            GLuint64 End = 0;
+            glGetQueryObjectui64v(Queries.Timestamps[i][0], GL_QUERY_RESULT, &Start);
+            glGetQueryObjectui64v(Queries.Timestamps[i][1], GL_QUERY_RESULT, &End);
+            StatCounters::SetGpuTime(static_cast<StatTimer>(i), static_cast<int64_t>(End - Start));
+            LatestMs[i] = static_cast<float>(End - Start) * 1e-6f;
+        }
+        Queries.TimerIssued[i] = false;
+    }
+    if (Queries.PrimitivesIssued && IsAvailable(Queries.Primitives)) {
+        GLuint64 Count = 0;
+        glGetQueryObjectui64v(Queries.Primitives, GL_QUERY_RESULT, &Count);
+        StatCounters::Set(StatCounter::Triangles, static_cast<int64_t>(Count));
+    }
+    Queries.PrimitivesIssued = false;
+}
+
+void GPUTimers::Begin(StatTimer Timer) {
+    if (!Initialized) { return; }
+    glQueryCounter(Frames[Frame].Timestamps[static_cast<uint32_t>(Timer)][0], GL_TIMESTAMP);
+}
+
+void GPUTimers::End(StatTimer Timer) {
+    if (!Initialized) { return; }
+    FrameQueries& Queries = Frames[Frame];
+    glQueryCounter(Queries.Timestamps[static_cast<uint32_t>(Timer)][1], GL_TIMESTAMP);
+    Queries.TimerIssued[static_cast<uint32_t>(Timer)] = true;
+    Owned[static_cast<uint32_t>(Timer)] = true;
+}
+
+void GPUTimers::BeginPrimitives() {
+    if (!Initialized) { return; }
+    glBeginQuery(GL_PRIMITIVES_GENERATED, Frames[Frame].Primitives);
+}
+
+void GPUTimers::EndPrimitives() {
+    if (!Initialized) { return; }
+    glEndQuery(GL_PRIMITIVES_GENERATED);
+    Frames[Frame].PrimitivesIssued = true;
+}
+
+} // namespace Volante
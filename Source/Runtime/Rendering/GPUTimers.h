@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Runtime/Core/Stats/StatCounters.h"
+
+namespace Volante {
+
+// GPU pass times and the scene's primitive count from GL queries, published to StatCounters
+// (SetGpuTime, StatCounter::Triangles). Queries are read back FrameLatency frames later and
+// only if the GPU has finished them, so they never stall; a late frame is simply dropped.
+//
+// Timers use timestamps, so they may nest; at most one primitive query is open at a time.
+// Several instances can share StatCounters as long as each timer is issued by only one of them.
+class GPUTimers {
+public:
+    static constexpr uint32_t FrameLatency = 4;
+
+    GPUTimers() = default;
+    ~GPUTimers();
+
+    GPUTimers(const GPUTimers&) = delete;
+    GPUTimers& operator=(const GPUTimers&) = delete;
+
+    void Initialize();
+    void Shutdown();
+
+    // Publishes the oldest frame's results, then reuses its queries.
+    void BeginFrame();
+
+    void Begin(StatTimer Timer);
+    void End(StatTimer Timer);
+
+    void BeginPrimitives();
+    void EndPrimitives();
+
+    // Latest published result; 0 before the first arrives.
+    [[nodiscard]] float GetMs(StatTimer Timer) const { return LatestMs[static_cast<uint32_t>(Timer)]; }
+
+private:
+    struct FrameQueries {
+        unsigned int Timestamps[StatTimerCount][2] = {};
+        bool TimerIssued[StatTimerCount] = {};
+        unsigned int Primitives = 0;
+        bool PrimitivesIssued = false;
+    };
+
+    FrameQueries Frames[FrameLatency];
+    // Timers this instance has issued, the only ones it publishes
+    bool Owned[StatTimerCount] = {};
+    float LatestMs[StatTimerCount] = {};
+    uint32_t Frame = 0;
+    bool Initialized = false;
+};
+
+} // namespace Volante
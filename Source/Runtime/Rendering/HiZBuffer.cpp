@@ -0,0 +1,115 @@
+#include "HiZBuffer.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <bit>
+#include <iostream>
+
+#include "DepthConvention.h"
+
+namespace Volante {
+
+HiZBuffer::~HiZBuffer() {
+    Shutdown();
+}
+
+bool HiZBuffer::Initialize(uint32_t InWidth, uint32_t InHeight) {
+    Shutdown();
+
+    ReduceProgram = Shaders.LoadCompute(ShaderLibrary::GetShaderDirectory() + "/HiZReduce.comp");
+    if (!Shaders.GetCompute(ReduceProgram)) {
+        Shutdown();
+        return false;
+    }
+
+    Width = std::bit_ceil(std::max(InWidth, 1u));
+    Height = std::bit_ceil(std::max(InHeight, 1u));
+    LevelCount = static_cast<uint32_t>(std::bit_width(std::max(Width, Height)));
+
+    glGenTextures(1, &Texture);
+    glBindTexture(GL_TEXTURE_2D, Texture);
+    glTexStorage2D(GL_TEXTURE_2D, static_cast<GLsizei>(LevelCount), GL_R32F, static_cast<GLsizei>(Width), static_cast<GLsizei>(Height));
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glGenRenderbuffers(1, &DepthBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, DepthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT32F, static_cast<GLsizei>(Width), static_cast<GLsizei>(Height));
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    GLint Previous = 0;
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &Previous);
+    glGenFramebuffers(1, &Framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, Framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, Texture, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, DepthBuffer);
+    const bool Complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(Previous));
+
+    if (!Complete) {
+        std::cerr << "ERROR::HIZ::FRAMEBUFFER_INCOMPLETE" << std::endl;
+        Shutdown();
+        return false;
+    }
+    return true;
+}
+
+void HiZBuffer::Shutdown() {
+    Shaders.Unload(ReduceProgram);
+    ReduceProgram = InvalidShaderProgramId;
+    if (Framebuffer != 0) { glDeleteFramebuffers(1, &Framebuffer); }
+    if (DepthBuffer != 0) { glDeleteRenderbuffers(1, &DepthBuffer); }
+    if (Texture != 0) { glDeleteTextures(1, &Texture); }
+    Framebuffer = DepthBuffer = Texture = 0;
+    Width = Height = LevelCount = 0;
+    Valid = false;
+}
+
+void HiZBuffer::BeginDepthPass(const Mat4& InViewProjection) {
+    ViewProjection = InViewProjection;
+
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &SavedFramebuffer);
+    glGetIntegerv(GL_VIEWPORT, SavedViewport);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, Framebuffer);
+    glViewport(0, 0, static_cast<GLsizei>(Width), static_cast<GLsizei>(Height));
+    const float Far[4] = {FarDepth, FarDepth, FarDepth, FarDepth};
+    glClearBufferfv(GL_COLOR, 0, Far);
+    glClearBufferfv(GL_DEPTH, 0, &FarDepth);
+}
+
+void HiZBuffer::EndDepthPass() {
+    glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(SavedFramebuffer));
+    glViewport(SavedViewport[0], SavedViewport[1], SavedViewport[2], SavedViewport[3]);
+
+    BuildPyramid();
+    Valid = true;
+}
+
+void HiZBuffer::Bind(uint32_t Unit) const {
+    glActiveTexture(GL_TEXTURE0 + Unit);
+    glBindTexture(GL_TEXTURE_2D, Texture);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+void HiZBuffer::BuildPyramid() const {
+    const ComputeProgram& ReduceKernel = *Shaders.GetCompute(ReduceProgram);
+    ReduceKernel.Use();
+    Bind(0);
+    for (uint32_t Level = 1; Level < LevelCount; ++Level) {
+        const auto LevelWidth = std::max(Width >> Level, 1u);
+        const auto LevelHeight = std::max(Height >> Level, 1u);
+        glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+        glBindImageTexture(0, Texture, static_cast<GLint>(Level), GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+        ReduceKernel.SetInt("uSourceLevel", static_cast<int>(Level - 1));
+        ReduceKernel.SetIVec2("uDestinationSize", static_cast<int>(LevelWidth), static_cast<int>(LevelHeight));
+        ReduceKernel.Dispatch(ComputeProgram::GetGroupCount(LevelWidth, 8), ComputeProgram::GetGroupCount(LevelHeight, 8));
+    }
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+}
+
+} // namespace Volante
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+
+#include "ComputeProgram.h"
+#include "ShaderLibrary.h"
+
+namespace Volante {
+
+// Farthest-depth pyramid for GPU occlusion culling (GL 4.3). The visible set is re-drawn
+// depth-only into a small power-of-two R32F target after the main pass, then reduced level by
+// level, so texel (x, y) of level L holds the farthest (with reverse-Z, smallest) depth under its
+// 2^L x 2^L footprint. Next frame's
+// cull kernel tests instance bounds against it using the view-projection it was rendered with.
+//
+// Rendering its own depth (rather than copying the back buffer's) keeps the pyramid independent
+// of the window's depth format and MSAA, and a low resolution is all the test needs. The
+// reduction kernel is HiZReduce.comp, loaded through Shaders.
+class HiZBuffer {
+public:
+    explicit HiZBuffer(ShaderLibrary& Shaders) : Shaders(Shaders) {}
+    ~HiZBuffer();
+
+    HiZBuffer(const HiZBuffer&) = delete;
+    HiZBuffer& operator=(const HiZBuffer&) = delete;
+
+    // Width and Height are rounded up to powers of two so every level halves exactly.
+    bool Initialize(uint32_t Width, uint32_t Height);
+    void Shutdown();
+
+    // Binds the depth target; the caller draws occluders (with a fragment shader writing
+    // gl_FragCoord.z to location 0) between Begin and End. Framebuffer and viewport are restored.
+    void BeginDepthPass(const Mat4& ViewProjection);
+    void EndDepthPass();
+
+    // Texture unit the cull kernel samples the pyramid from.
+    void Bind(uint32_t Unit) const;
+
+    [[nodiscard]] bool IsValid() const { return Valid; }
+
+    [[nodiscard]] const Mat4& GetViewProjection() const { return ViewProjection; }
+
+    [[nodiscard]] Vec2 GetSize() const { return Vec2(static_cast<float>(Width), static_cast<float>(Height)); }
+
+    [[nodiscard]] uint32_t GetLevelCount() const { return LevelCount; }
+
+    // Drops the pyramid, e.g. after a camera cut when last frame's depth says nothing useful.
+    void Invalidate() { Valid = false; }
+
+private:
+    void BuildPyramid() const;
+
+    ShaderLibrary& Shaders;
+    ShaderProgramId ReduceProgram = InvalidShaderProgramId;
+    unsigned int Texture = 0;
+    unsigned int DepthBuffer = 0;
+    unsigned int Framebuffer = 0;
+
+    uint32_t Width = 0;
+    uint32_t Height = 0;
+    uint32_t LevelCount = 0;
+    Mat4 ViewProjection = Mat4(1.0f);
+    bool Valid = false;
+
+    int SavedFramebuffer = 0;
+    int SavedViewport[4] = {0, 0, 0, 0};
+};
+
+} // namespace Volante
@@ -0,0 +1,256 @@
+#include "LightClusters.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+
+#include "DepthConvention.h"
+#include "Runtime/Core/Async/JobSystem.h"
+#include "Runtime/Core/Math/Simd.h"
+#include "Runtime/Core/Misc/Utility.h"
+
+namespace Volante {
+
+namespace {
+
+uint32_t TileOf(float Ndc, uint32_t TileCount) {
+    const float Tile = std::floor((Ndc * 0.5f + 0.5f) * static_cast<float>(TileCount));
+    return static_cast<uint32_t>(std::clamp(Tile, 0.0f, static_cast<float>(TileCount - 1)));
+}
+
+} // namespace
+
+LightClusters::LightClusters(const LightClusterDesc& InDesc) : Desc(InDesc) {
+    Desc.TilesX = std::max(Desc.TilesX, 1u);
+    Desc.TilesY = std::max(Desc.TilesY, 1u);
+    Desc.Slices = std::max(Desc.Slices, 1u);
+    RowStride = AlignUp(Desc.TilesX, 4);
+
+    const size_t BoundsCount = static_cast<size_t>(RowStride) * Desc.TilesY * Desc.Slices;
+    BoundsMinX.resize(BoundsCount);
+    BoundsMaxX.resize(BoundsCount);
+    BoundsMinY.resize(BoundsCount);
+    BoundsMaxY.resize(BoundsCount);
+    SliceNear.resize(Desc.Slices);
+    SliceFar.resize(Desc.Slices);
+    Scratch.resize(Desc.Slices);
+    ClusterRanges.resize(static_cast<size_t>(GetClusterCount()) * 2);
+}
+
+void LightClusters::Build(const std::vector<PointLight>& Lights, const Mat4& View, const Mat4& Projection, JobSystem* Jobs) {
+    if (Projection != BoundsProjection) { UpdateClusterBounds(Projection); }
+
+    const auto LightCount = static_cast<uint32_t>(Lights.size());
+    Footprints.resize(LightCount);
+    const float ScaleX = Projection[0][0];
+    const float ScaleY = Projection[1][1];
+    const float OffsetX = Projection[2][0];
+    const float OffsetY = Projection[2][1];
+
+    ParallelFor(Jobs, LightCount, 1024, [&](uint32_t Begin, uint32_t End) {
+        for (uint32_t i = Begin; i < End; ++i) {
+            const PointLight& Light = Lights[i];
+            LightFootprint& Footprint = Footprints[i];
+            Footprint.Visible = false;
+            if (Light.Radius <= 0.0f) { continue; }
+
+            const Vec3 Center = Vec3(View * Vec4(Light.Position, 1.0f));
+            const float Depth = -Center.z;
+            const float Radius = Light.Radius;
+            if (Depth + Radius < Near || Depth - Radius > ClusterFar) { continue; }
+
+            // x / d is monotonic in both x and d (d > 0), so the extremes of the sphere's
+            // bounding box over [MinDepth, MaxDepth] bound its projection
+            const float MinDepth = std::max(Depth - Radius, Near);
+            const float MaxDepth = std::min(Depth + Radius, ClusterFar);
+            const float MinX = std::min((Center.x - Radius) / MinDepth, (Center.x - Radius) / MaxDepth) * ScaleX - OffsetX;
+            const float MaxX = std::max((Center.x + Radius) / MinDepth, (Center.x + Radius) / MaxDepth) * ScaleX - OffsetX;
+            const float MinY = std::min((Center.y - Radius) / MinDepth, (Center.y - Radius) / MaxDepth) * ScaleY - OffsetY;
+            const float MaxY = std::max((Center.y + Radius) / MinDepth, (Center.y + Radius) / MaxDepth) * ScaleY - OffsetY;
+            if (MaxX < -1.0f || MinX > 1.0f || MaxY < -1.0f || MinY > 1.0f) { continue; }
+
+            Footprint.ViewSphere = Vec4(Center.x, Center.y, Depth, Radius);
+            Footprint.TileMinX = TileOf(MinX, Desc.TilesX);
+            Footprint.TileMaxX = TileOf(MaxX, Desc.TilesX);
+            Footprint.TileMinY = TileOf(MinY, Desc.TilesY);
+            Footprint.TileMaxY = TileOf(MaxY, Desc.TilesY);
+            Footprint.SliceMin = SliceOf(MinDepth);
+            Footprint.SliceMax = SliceOf(MaxDepth);
+            Footprint.Visible = true;
+        }
+    });
+
+    ParallelFor(Jobs, Desc.Slices, 1, [&](uint32_t Begin, uint32_t End) {
+        for (uint32_t Slice = Begin; Slice < End; ++Slice) {
+            AssignSlice(Slice);
+        }
+    });
+
+    // Concatenate the slices; each one's ranges are relative to its own index block
+    std::vector<uint32_t> SliceOffsets(Desc.Slices + 1, 0);
+    Stats = {};
+    Stats.LightCount = LightCount;
+    for (uint32_t Slice = 0; Slice < Desc.Slices; ++Slice) {
+        const SliceScratch& Block = Scratch[Slice];
+        SliceOffsets[Slice + 1] = SliceOffsets[Slice] + static_cast<uint32_t>(Block.Indices.size());
+        Stats.OverflowCount += Block.Overflow;
+        for (uint32_t Count : Block.Counts) {
+            Stats.MaxClusterLightCount = std::max(Stats.MaxClusterLightCount, Count);
+        }
+    }
+    for (const LightFootprint& Footprint : Footprints) {
+        Stats.VisibleLightCount += Footprint.Visible ? 1 : 0;
+    }
+    Stats.IndexCount = SliceOffsets[Desc.Slices];
+    LightIndices.resize(Stats.IndexCount);
+
+    const uint32_t ClustersPerSlice = Desc.TilesX * Desc.TilesY;
+    ParallelFor(Jobs, Desc.Slices, 1, [&](uint32_t Begin, uint32_t End) {
+        for (uint32_t Slice = Begin; Slice < End; ++Slice) {
+            const SliceScratch& Block = Scratch[Slice];
+            std::copy(Block.Indices.begin(), Block.Indices.end(), LightIndices.begin() + SliceOffsets[Slice]);
+
+            uint32_t Offset = SliceOffsets[Slice];
+            uint32_t* Ranges = ClusterRanges.data() + static_cast<size_t>(Slice) * ClustersPerSlice * 2;
+            for (uint32_t Cluster = 0; Cluster < ClustersPerSlice; ++Cluster) {
+                Ranges[Cluster * 2] = Offset;
+                Ranges[Cluster * 2 + 1] = Block.Counts[Cluster];
+                Offset += Block.Counts[Cluster];
+            }
+        }
+    });
+}
+
+void LightClusters::UpdateClusterBounds(const Mat4& Projection) {
+    BoundsProjection = Projection;
+
+    float ProjectionFar = 0.0f;
+    GetProjectionDepthRange(Projection, Near, ProjectionFar);
+    ClusterFar = std::max(std::min(Desc.Far, ProjectionFar), Near * 1.001f);
+
+    const float LogRatio = std::log(ClusterFar / Near);
+    SliceScale = static_cast<float>(Desc.Slices) / LogRatio;
+    SliceBias = static_cast<float>(Desc.Slices) * std::log(Near) / LogRatio;
+    for (uint32_t Slice = 0; Slice < Desc.Slices; ++Slice) {
+        SliceNear[Slice] = Near * std::pow(ClusterFar / Near, static_cast<float>(Slice) / static_cast<float>(Desc.Slices));
+        SliceFar[Slice] = Near * std::pow(ClusterFar / Near, static_cast<float>(Slice + 1) / static_cast<float>(Desc.Slices));
+    }
+
+    // A tile's view-space x is d * (ndc + OffsetX) / ScaleX, linear in depth, so the box of a
+    // frustum cell spans the values at its near and far depth
+    const float ScaleX = Projection[0][0];
+    const float ScaleY = Projection[1][1];
+    const float OffsetX = Projection[2][0];
+    const float OffsetY = Projection[2][1];
+    const float Unreachable = std::numeric_limits<float>::max();
+    for (uint32_t Slice = 0; Slice < Desc.Slices; ++Slice) {
+        const float Depths[2] = {SliceNear[Slice], SliceFar[Slice]};
+        for (uint32_t Y = 0; Y < Desc.TilesY; ++Y) {
+            const float NdcY[2] = {-1.0f + 2.0f * static_cast<float>(Y) / static_cast<float>(Desc.TilesY),
+                                   -1.0f + 2.0f * static_cast<float>(Y + 1) / static_cast<float>(Desc.TilesY)};
+            const size_t Row = (static_cast<size_t>(Slice) * Desc.TilesY + Y) * RowStride;
+            for (uint32_t X = 0; X < RowStride; ++X) {
+                if (X >= Desc.TilesX) {
+                    // Padding lanes never intersect anything
+                    BoundsMinX[Row + X] = BoundsMinY[Row + X] = Unreachable;
+                    BoundsMaxX[Row + X] = BoundsMaxY[Row + X] = Unreachable;
+                    continue;
+                }
+                const float NdcX[2] = {-1.0f + 2.0f * static_cast<float>(X) / static_cast<float>(Desc.TilesX),
+                                       -1.0f + 2.0f * static_cast<float>(X + 1) / static_cast<float>(Desc.TilesX)};
+                float MinX = Unreachable, MaxX = -Unreachable, MinY = Unreachable, MaxY = -Unreachable;
+                for (float Depth : Depths) {
+                    for (int Edge = 0; Edge < 2; ++Edge) {
+                        const float PointX = Depth * (NdcX[Edge] + OffsetX) / ScaleX;
+                        const float PointY = Depth * (NdcY[Edge] + OffsetY) / ScaleY;
+                        MinX = std::min(MinX, PointX);
+                        MaxX = std::max(MaxX, PointX);
+                        MinY = std::min(MinY, PointY);
+                        MaxY = std::max(MaxY, PointY);
+                    }
+                }
+                BoundsMinX[Row + X] = MinX;
+                BoundsMaxX[Row + X] = MaxX;
+                BoundsMinY[Row + X] = MinY;
+                BoundsMaxY[Row + X] = MaxY;
+            }
+        }
+    }
+}
+
+uint32_t LightClusters::SliceOf(float Depth) const {
+    const float Slice = std::floor(std::log(Depth) * SliceScale - SliceBias);
+    return static_cast<uint32_t>(std::clamp(Slice, 0.0f, static_cast<float>(Desc.Slices - 1)));
+}
+
+void LightClusters::AssignSlice(uint32_t Slice) {
+    SliceScratch& Block = Scratch[Slice];
+    Block.PairClusters.clear();
+    Block.PairLights.clear();
+    Block.Overflow = 0;
+
+    const float DepthMin = SliceNear[Slice];
+    const float DepthMax = SliceFar[Slice];
+    const auto LightCount = static_cast<uint32_t>(Footprints.size());
+    for (uint32_t Light = 0; Light < LightCount; ++Light) {
+        const LightFootprint& Footprint = Footprints[Light];
+        if (!Footprint.Visible || Slice < Footprint.SliceMin || Slice > Footprint.SliceMax) { continue; }
+
+        const Vec4& Sphere = Footprint.ViewSphere;
+        const float RadiusSquared = Sphere.w * Sphere.w;
+        const float DepthGap = std::max({DepthMin - Sphere.z, Sphere.z - DepthMax, 0.0f});
+        const float DepthTerm = DepthGap * DepthGap;
+        const Float4 CenterX = Float4::Splat(Sphere.x);
+        const Float4 CenterY = Float4::Splat(Sphere.y);
+        const Float4 Zero = Float4::Zero();
+
+        for (uint32_t Y = Footprint.TileMinY; Y <= Footprint.TileMaxY; ++Y) {
+            const size_t Row = (static_cast<size_t>(Slice) * Desc.TilesY + Y) * RowStride;
+            for (uint32_t X = Footprint.TileMinX & ~3u; X <= Footprint.TileMaxX; X += 4) {
+                // Squared distance from the sphere centre to four cluster boxes
+                const Float4 GapX = Max(Max(Float4::Load(&BoundsMinX[Row + X]) - CenterX, CenterX - Float4::Load(&BoundsMaxX[Row + X])), Zero);
+                const Float4 GapY = Max(Max(Float4::Load(&BoundsMinY[Row + X]) - CenterY, CenterY - Float4::Load(&BoundsMaxY[Row + X])), Zero);
+                const Float4 DistanceSquared = GapX * GapX + GapY * GapY + Float4::Splat(DepthTerm);
+                int Hits = MoveMask(DistanceSquared <= Float4::Splat(RadiusSquared));
+                while (Hits != 0) {
+                    const int Lane = std::countr_zero(static_cast<unsigned>(Hits));
+                    Hits &= Hits - 1;
+                    Block.PairClusters.push_back(Y * Desc.TilesX + X + static_cast<uint32_t>(Lane));
+                    Block.PairLights.push_back(Light);
+                }
+            }
+        }
+    }
+
+    // Group by cluster (stable, so each list stays in light order), capping every cluster
+    const uint32_t ClustersPerSlice = Desc.TilesX * Desc.TilesY;
+    Block.Counts.assign(ClustersPerSlice, 0);
+    for (uint32_t Cluster : Block.PairClusters) {
+        ++Block.Counts[Cluster];
+    }
+    uint32_t Total = 0;
+    for (uint32_t& Count : Block.Counts) {
+        if (Count > Desc.MaxLightsPerCluster) {
+            Block.Overflow += Count - Desc.MaxLightsPerCluster;
+            Count = Desc.MaxLightsPerCluster;
+        }
+        Total += Count;
+    }
+
+    Block.Indices.resize(Total);
+    Block.Cursors.resize(ClustersPerSlice);
+    uint32_t Offset = 0;
+    for (uint32_t Cluster = 0; Cluster < ClustersPerSlice; ++Cluster) {
+        Block.Cursors[Cluster] = Offset;
+        Offset += Block.Counts[Cluster];
+    }
+    for (size_t Pair = 0; Pair < Block.PairClusters.size(); ++Pair) {
+        const uint32_t Cluster = Block.PairClusters[Pair];
+        const uint32_t End = Cluster + 1 < ClustersPerSlice ? Block.Cursors[Cluster + 1] : Total;
+        uint32_t& Cursor = Block.Cursors[Cluster];
+        if (Cursor < End) { Block.Indices[Cursor++] = Block.PairLights[Pair]; }
+    }
+}
+
+} // namespace Volante
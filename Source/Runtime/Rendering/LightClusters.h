@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Volante.h"
+
+namespace Volante {
+
+class JobSystem;
+
+struct PointLight {
+    Vec3 Position = Vec3(0.0f);
+    // Light reaches zero at this distance; lights with a radius of zero are skipped.
+    float Radius = 0.0f;
+    Vec3 Color = Vec3(1.0f);
+    float Intensity = 1.0f;
+};
+
+struct LightClusterDesc {
+    // Screen tiles across and down, and exponential depth slices between Near and Far.
+    uint32_t TilesX = 16;
+    uint32_t TilesY = 9;
+    uint32_t Slices = 24;
+
+    // Depth range covered by the slices, clamped to the projection's own near/far. Lights past
+    // Far are not assigned; fragments past it use the last slice.
+    float Far = 500.0f;
+
+    // Bounds per-fragment work. Lights beyond this in one cluster are dropped and counted in
+    // LightClusterStats::OverflowCount.
+    uint32_t MaxLightsPerCluster = 256;
+};
+
+struct LightClusterStats {
+    uint32_t LightCount = 0;
+    uint32_t VisibleLightCount = 0;
+    uint32_t IndexCount = 0;
+    uint32_t MaxClusterLightCount = 0;
+    uint32_t OverflowCount = 0;
+};
+
+// Assigns point lights to the clusters of a view frustum split into TilesX x TilesY screen
+// tiles and Slices exponential depth slices, producing the compact lists the shader walks:
+//
+//   ClusterRanges: (offset, count) per cluster, x fastest, then y, then slice
+//   LightIndices:  light indices, grouped by cluster
+//
+// Each light's screen/depth footprint is found conservatively, then the clusters inside it are
+// tested exactly (sphere against the cluster's view-space box), four tiles at a time with Float4.
+// Slices are independent, so they are distributed over the job system and written without
+// locks. No GL calls: ClusteredLighting uploads the result.
+class LightClusters {
+public:
+    explicit LightClusters(const LightClusterDesc& Desc = {});
+
+    // Projection must be a perspective projection, reverse-Z or GL; see GetProjectionDepthRange.
+    void Build(const std::vector<PointLight>& Lights, const Mat4& View, const Mat4& Projection, JobSystem* Jobs);
+
+    [[nodiscard]] const LightClusterDesc& GetDesc() const { return Desc; }
+
+    [[nodiscard]] uint32_t GetClusterCount() const { return Desc.TilesX * Desc.TilesY * Desc.Slices; }
+
+    [[nodiscard]] const std::vector<uint32_t>& GetClusterRanges() const { return ClusterRanges; }
+
+    [[nodiscard]] const std::vector<uint32_t>& GetLightIndices() const { return LightIndices; }
+
+    // Slice of view depth d is floor(log(d) * Scale - Bias).
+    [[nodiscard]] float GetSliceScale() const { return SliceScale; }
+
+    [[nodiscard]] float GetSliceBias() const { return SliceBias; }
+
+    [[nodiscard]] const LightClusterStats& GetStats() const { return Stats; }
+
+private:
+    // Conservative cluster footprint of one light, or an empty range when it is off-screen.
+    struct LightFootprint {
+        Vec4 ViewSphere;
+        uint32_t TileMinX, TileMaxX, TileMinY, TileMaxY, SliceMin, SliceMax;
+        bool Visible;
+    };
+
+    // One slice's assignment, kept between frames so steady-state builds do not allocate.
+    struct SliceScratch {
+        std::vector<uint32_t> PairClusters;
+        std::vector<uint32_t> PairLights;
+        std::vector<uint32_t> Counts;
+        std::vector<uint32_t> Cursors;
+        std::vector<uint32_t> Indices;
+        uint32_t Overflow = 0;
+    };
+
+    void UpdateClusterBounds(const Mat4& Projection);
+    [[nodiscard]] uint32_t SliceOf(float Depth) const;
+    void AssignSlice(uint32_t Slice);
+
+    LightClusterDesc Desc;
+    uint32_t RowStride;
+
+    // View-space cluster boxes (depth as positive distance), structure of arrays with rows
+    // padded to RowStride so four tiles load at once.
+    std::vector<float> BoundsMinX, BoundsMaxX, BoundsMinY, BoundsMaxY;
+    std::vector<float> SliceNear, SliceFar;
+    Mat4 BoundsProjection = Mat4(0.0f);
+    float Near = 0.1f;
+    float ClusterFar = 500.0f;
+    float SliceScale = 0.0f;
+    float SliceBias = 0.0f;
+
+    std::vector<LightFootprint> Footprints;
+    std::vector<SliceScratch> Scratch;
+    std::vector<uint32_t> ClusterRanges;
+    std::vector<uint32_t> LightIndices;
+    LightClusterStats Stats;
+};
+
+} // namespace Volante
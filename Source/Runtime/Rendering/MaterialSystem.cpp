@@ -0,0 +1,336 @@
+#include "MaterialSystem.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#include "ResourceManager.h"
+#include "Shader.h"
+#include "Runtime/Core/Misc/Utility.h"
+
+namespace Volante {
+
+namespace {
+
+uint32_t GetAlignment(MaterialParameterType Type) {
+    switch (Type) {
+    case MaterialParameterType::Vec2:
+    case MaterialParameterType::Texture: return 8;
+    case MaterialParameterType::Vec3:
+    case MaterialParameterType::Vec4: return 16;
+    default: return 4;
+    }
+}
+
+uint32_t GetSize(MaterialParameterType Type) {
+    switch (Type) {
+    case MaterialParameterType::Vec2:
+    case MaterialParameterType::Texture: return 8;
+    case MaterialParameterType::Vec3: return 12;
+    case MaterialParameterType::Vec4: return 16;
+    default: return 4;
+    }
+}
+
+const char* GetGLSLType(MaterialParameterType Type) {
+    switch (Type) {
+    case MaterialParameterType::Float: return "float";
+    case MaterialParameterType::Int: return "int";
+    case MaterialParameterType::UInt: return "uint";
+    case MaterialParameterType::Vec2: return "vec2";
+    case MaterialParameterType::Vec3: return "vec3";
+    case MaterialParameterType::Vec4: return "vec4";
+    case MaterialParameterType::Texture: return "uvec2";
+    }
+    return "float";
+}
+
+} // namespace
+
+MaterialLayout& MaterialLayout::Add(const std::string& Name, MaterialParameterType Type, const Vec4& Default) {
+    MaterialParameter Parameter;
+    Parameter.Name = Name;
+    Parameter.Type = Type;
+    Parameter.Default = Default;
+    Parameters.push_back(Parameter);
+    return *this;
+}
+
+uint32_t MaterialLayout::Pack(MaterialPacking Packing) {
+    uint32_t Cursor = 0;
+    uint32_t MaxAlignment = 4;
+    for (MaterialParameter& Parameter : Parameters) {
+        const uint32_t Alignment = GetAlignment(Parameter.Type);
+        Parameter.Offset = AlignUp(Cursor, Alignment);
+        Cursor = Parameter.Offset + GetSize(Parameter.Type);
+        MaxAlignment = std::max(MaxAlignment, Alignment);
+    }
+    // std140 rounds a struct's alignment up to a vec4; std430 keeps its largest member's
+    const uint32_t StructAlignment = Packing == MaterialPacking::Std140 ? AlignUp(MaxAlignment, 16) : MaxAlignment;
+    return AlignUp(std::max(Cursor, 4u), StructAlignment);
+}
+
+uint32_t MaterialLayout::Find(const std::string& Name) const {
+    for (uint32_t i = 0; i < Parameters.size(); ++i) {
+        if (Parameters[i].Name == Name) { return i; }
+    }
+    return InvalidMaterialParameter;
+}
+
+MaterialSystem::MaterialSystem(ResourceManager& Resources, const MaterialLayout& InLayout, MaterialPacking Packing, uint32_t Binding)
+    : Resources(Resources), Layout(InLayout), Packing(Packing), Binding(Binding) {
+    Stride = Layout.Pack(Packing);
+    for (uint32_t i = 0; i < Layout.GetParameters().size(); ++i) {
+        if (Layout.GetParameters()[i].Type == MaterialParameterType::Texture) { TextureParameters.push_back(i); }
+    }
+}
+
+MaterialSystem::~MaterialSystem() {
+    Shutdown();
+}
+
+bool MaterialSystem::Initialize(bool InBindless) {
+    Shutdown();
+    Bindless = InBindless;
+
+    if (Packing == MaterialPacking::Std140) {
+        GLint MaxBlockSize = 0;
+        glGetIntegerv(GL_MAX_UNIFORM_BLOCK_SIZE, &MaxBlockSize);
+        Capacity = static_cast<uint32_t>(MaxBlockSize) / Stride;
+        // The block is declared at full capacity, so it has to be backed at full size
+        BufferCapacity = static_cast<size_t>(Capacity) * Stride;
+    } else {
+        BufferCapacity = std::max<size_t>(Data.size(), Stride);
+    }
+    Buffer = Resources.CreateDynamicBuffer(BufferCapacity);
+    DirtyBegin = 0;
+    DirtyEnd = GetMaterialCount();
+    TextureGeneration = ~0u;
+    GenerateShaderSource();
+    return true;
+}
+
+void MaterialSystem::Shutdown() {
+    Resources.Release(Buffer);
+    Buffer = {};
+    BufferCapacity = 0;
+    BoundPrograms.clear();
+}
+
+MaterialId MaterialSystem::Create() {
+    MaterialId Id;
+    if (!FreeIds.empty()) {
+        Id = FreeIds.back();
+        FreeIds.pop_back();
+    } else {
+        if (Packing == MaterialPacking::Std140 && Alive.size() >= Capacity) {
+            std::cerr << "ERROR::MATERIAL::CAPACITY_EXCEEDED: " << Capacity << " materials" << std::endl;
+            return InvalidMaterialId;
+        }
+        Id = static_cast<MaterialId>(Alive.size());
+        Alive.push_back(false);
+        Data.resize(Data.size() + Stride);
+        TextureIds.resize(TextureIds.size() + TextureParameters.size());
+    }
+    Alive[Id] = true;
+
+    std::memset(Data.data() + static_cast<size_t>(Id) * Stride, 0, Stride);
+    const std::vector<MaterialParameter>& Parameters = Layout.GetParameters();
+    for (uint32_t i = 0; i < Parameters.size(); ++i) {
+        const Vec4& Default = Parameters[i].Default;
+        switch (Parameters[i].Type) {
+        case MaterialParameterType::Float: SetFloat(Id, i, Default.x); break;
+        case MaterialParameterType::Int: SetInt(Id, i, static_cast<int32_t>(Default.x)); break;
+        case MaterialParameterType::UInt: SetUInt(Id, i, static_cast<uint32_t>(Default.x)); break;
+        case MaterialParameterType::Vec2: SetVec2(Id, i, Vec2(Default.x, Default.y)); break;
+        case MaterialParameterType::Vec3: SetVec3(Id, i, Vec3(Default)); break;
+        case MaterialParameterType::Vec4: SetVec4(Id, i, Default); break;
+        case MaterialParameterType::Texture: SetTexture(Id, i, InvalidTextureId); break;
+        }
+    }
+    DirtyBegin = std::min(DirtyBegin, Id);
+    DirtyEnd = std::max(DirtyEnd, Id + 1);
+    return Id;
+}
+
+void MaterialSystem::Destroy(MaterialId Id) {
+    if (Id >= Alive.size() || !Alive[Id]) { return; }
+    Alive[Id] = false;
+    FreeIds.push_back(Id);
+}
+
+void MaterialSystem::SetFloat(MaterialId Id, uint32_t Parameter, float Value) {
+    Write(Id, Parameter, MaterialParameterType::Float, &Value, sizeof(Value));
+}
+
+void MaterialSystem::SetInt(MaterialId Id, uint32_t Parameter, int32_t Value) {
+    Write(Id, Parameter, MaterialParameterType::Int, &Value, sizeof(Value));
+}
+
+void MaterialSystem::SetUInt(MaterialId Id, uint32_t Parameter, uint32_t Value) {
+    Write(Id, Parameter, MaterialParameterType::UInt, &Value, sizeof(Value));
+}
+
+void MaterialSystem::SetVec2(MaterialId Id, uint32_t Parameter, const Vec2& Value) {
+    Write(Id, Parameter, MaterialParameterType::Vec2, &Value[0], sizeof(float) * 2);
+}
+
+void MaterialSystem::SetVec3(MaterialId Id, uint32_t Parameter, const Vec3& Value) {
+    Write(Id, Parameter, MaterialParameterType::Vec3, &Value[0], sizeof(float) * 3);
+}
+
+void MaterialSystem::SetVec4(MaterialId Id, uint32_t Parameter, const Vec4& Value) {
+    Write(Id, Parameter, MaterialParameterType::Vec4, &Value[0], sizeof(float) * 4);
+}
+
+void MaterialSystem::SetTexture(MaterialId Id, uint32_t Parameter, TextureId Texture) {
+    if (Id >= Alive.size() || Parameter >= Layout.GetParameters().size()) { return; }
+    const auto Slot = std::find(TextureParameters.begin(), TextureParameters.end(), Parameter);
+    if (Slot == TextureParameters.end()) {
+        std::cerr << "ERROR::MATERIAL::TYPE_MISMATCH: " << Layout.GetParameters()[Parameter].Name << std::endl;
+        return;
+    }
+    // The reference itself is written by Update, once the streamer can be asked for it
+    TextureIds[Id * TextureParameters.size() + (Slot - TextureParameters.begin())] = Texture;
+    TexturesChanged = true;
+}
+
+void MaterialSystem::Update(const TextureStreamer& Textures) {
+    if (TexturesChanged || Textures.GetHandleGeneration() != TextureGeneration) {
+        for (MaterialId Id = 0; Id < Alive.size(); ++Id) {
+            if (!Alive[Id]) { continue; }
+            for (uint32_t Slot = 0; Slot < TextureParameters.size(); ++Slot) {
+                WriteTextureReference(Id, Slot, &Textures);
+            }
+        }
+        TextureGeneration = Textures.GetHandleGeneration();
+        TexturesChanged = false;
+    }
+    if (DirtyBegin >= DirtyEnd || !Buffer) { return; }
+
+    if (Data.size() > BufferCapacity) {
+        // Only storage blocks grow
+        BufferCapacity = std::max(Data.size(), BufferCapacity * 2);
+        Resources.Release(Buffer);
+        Buffer = Resources.CreateDynamicBuffer(BufferCapacity);
+        DirtyBegin = 0;
+        DirtyEnd = GetMaterialCount();
+    }
+    const GLenum Target = Packing == MaterialPacking::Std140 ? GL_UNIFORM_BUFFER : GL_SHADER_STORAGE_BUFFER;
+    glBindBuffer(Target, GetBufferId());
+    const size_t Offset = static_cast<size_t>(DirtyBegin) * Stride;
+    glBufferSubData(Target, static_cast<GLintptr>(Offset), static_cast<GLsizeiptr>((DirtyEnd - DirtyBegin) * Stride),
+                    Data.data() + Offset);
+    glBindBuffer(Target, 0);
+    DirtyBegin = ~0u;
+    DirtyEnd = 0;
+}
+
+unsigned int MaterialSystem::GetBufferId() const {
+    const GPUBuffer* Target = Resources.Get(Buffer);
+    return Target ? Target->GetId() : 0;
+}
+
+void MaterialSystem::Bind(const Shader& Program) {
+    if (Packing == MaterialPacking::Std430) {
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, Binding, GetBufferId());
+        return;
+    }
+    if (std::find(BoundPrograms.begin(), BoundPrograms.end(), Program.id) == BoundPrograms.end()) {
+        const GLuint Block = glGetUniformBlockIndex(Program.id, "MaterialBlock");
+        if (Block != GL_INVALID_INDEX) { glUniformBlockBinding(Program.id, Block, Binding); }
+        BoundPrograms.push_back(Program.id);
+    }
+    glBindBufferBase(GL_UNIFORM_BUFFER, Binding, GetBufferId());
+}
+
+void MaterialSystem::ForgetProgram(const Shader& Program) {
+    std::erase(BoundPrograms, Program.id);
+}
+
+bool MaterialSystem::BindTextures(const Shader& Program, const TextureStreamer& Textures, MaterialId Id, int FirstUnit) const {
+    if (!HasTextures(Id)) { return false; }
+    for (uint32_t Slot = 0; Slot < TextureParameters.size(); ++Slot) {
+        const int Unit = FirstUnit + static_cast<int>(Slot);
+        Textures.Bind(GetTexture(Id, Slot), Unit);
+        Program.setInt("u" + Layout.GetParameters()[TextureParameters[Slot]].Name, Unit);
+    }
+    return true;
+}
+
+void MaterialSystem::SetTexturesBound(const Shader& Program, bool Bound) const {
+    if (!Bindless) { Program.setBool("uMaterialTexturesBound", Bound); }
+}
+
+bool MaterialSystem::HasTextures(MaterialId Id) const {
+    if (Id >= Alive.size()) { return false; }
+    for (uint32_t Slot = 0; Slot < TextureParameters.size(); ++Slot) {
+        if (GetTexture(Id, Slot) != InvalidTextureId) { return true; }
+    }
+    return false;
+}
+
+void MaterialSystem::Write(MaterialId Id, uint32_t Parameter, MaterialParameterType Type, const void* Value, size_t Size) {
+    if (Id >= Alive.size() || Parameter >= Layout.GetParameters().size()) { return; }
+    const MaterialParameter& Target = Layout.GetParameters()[Parameter];
+    if (Target.Type != Type) {
+        std::cerr << "ERROR::MATERIAL::TYPE_MISMATCH: " << Target.Name << std::endl;
+        return;
+    }
+    std::memcpy(Data.data() + static_cast<size_t>(Id) * Stride + Target.Offset, Value, Size);
+    DirtyBegin = std::min(DirtyBegin, Id);
+    DirtyEnd = std::max(DirtyEnd, Id + 1);
+}
+
+void MaterialSystem::WriteTextureReference(MaterialId Id, uint32_t TextureSlot, const TextureStreamer* Textures) {
+    // Bindless: the 64-bit handle (0 until resident). Otherwise a set flag; the texture itself
+    // is bound per draw.
+    const TextureId Texture = GetTexture(Id, TextureSlot);
+    uint64_t Reference = 0;
+    if (Texture != InvalidTextureId) { Reference = Bindless ? Textures->GetHandle(Texture) : 1; }
+
+    uint8_t* Destination = Data.data() + static_cast<size_t>(Id) * Stride + Layout.GetParameters()[TextureParameters[TextureSlot]].Offset;
+    uint64_t Previous = 0;
+    std::memcpy(&Previous, Destination, sizeof(Previous));
+    if (Previous == Reference) { return; }
+    std::memcpy(Destination, &Reference, sizeof(Reference));
+    DirtyBegin = std::min(DirtyBegin, Id);
+    DirtyEnd = std::max(DirtyEnd, Id + 1);
+}
+
+void MaterialSystem::GenerateShaderSource() {
+    ShaderExtensions = Bindless ? "#extension GL_ARB_bindless_texture : require\n" : "";
+
+    std::string Source = "\nstruct MaterialData {\n";
+    for (const MaterialParameter& Parameter : Layout.GetParameters()) {
+        Source += std::string("    ") + GetGLSLType(Parameter.Type) + " " + Parameter.Name + ";\n";
+    }
+    Source += "};\n\n";
+    if (Packing == MaterialPacking::Std140) {
+        Source += "layout(std140) uniform MaterialBlock {\n    MaterialData materials[" + std::to_string(Capacity) + "];\n};\n\n";
+    } else {
+        Source += "layout(std430, binding = " + std::to_string(Binding) +
+                  ") readonly buffer MaterialBlock {\n    MaterialData materials[];\n};\n\n";
+    }
+    Source += "MaterialData GetMaterial(uint index) {\n    return materials[index];\n}\n";
+
+    if (!Bindless && !TextureParameters.empty()) { Source += "\nuniform bool uMaterialTexturesBound;\n"; }
+    for (uint32_t Index : TextureParameters) {
+        const std::string& Name = Layout.GetParameters()[Index].Name;
+        if (Bindless) {
+            Source += "\nvec4 Sample" + Name + "(MaterialData material, vec2 uv) {\n"
+                      "    if (material." + Name + " == uvec2(0u)) {\n        return vec4(1.0);\n    }\n"
+                      "    return texture(sampler2D(material." + Name + "), uv);\n}\n";
+        } else {
+            Source += "\nuniform sampler2D u" + Name + ";\n\n"
+                      "vec4 Sample" + Name + "(MaterialData material, vec2 uv) {\n"
+                      "    if (!uMaterialTexturesBound || material." + Name + ".x == 0u) {\n        return vec4(1.0);\n    }\n"
+                      "    return texture(u" + Name + ", uv);\n}\n";
+        }
+    }
+    ShaderSource = std::move(Source);
+}
+
+} // namespace Volante
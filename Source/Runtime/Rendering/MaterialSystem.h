@@ -0,0 +1,178 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Volante.h"
+#include "ResourcePool.h"
+#include "TextureStreamer.h"
+
+namespace Volante {
+
+class GPUBuffer;
+class ResourceManager;
+class Shader;
+
+using MaterialId = uint32_t;
+constexpr MaterialId InvalidMaterialId = ~0u;
+constexpr uint32_t InvalidMaterialParameter = ~0u;
+
+enum class MaterialParameterType : uint8_t {
+    Float,
+    Int,
+    UInt,
+    Vec2,
+    Vec3,
+    Vec4,
+    // A TextureStreamer texture: a bindless handle where supported, otherwise bound per draw
+    Texture,
+};
+
+// Buffer layout rules. Std140 blocks are uniform buffers (GL 3.3); std430 blocks are shader
+// storage buffers (GL 4.3) with tighter array packing and no size limit.
+enum class MaterialPacking : uint8_t {
+    Std140,
+    Std430,
+};
+
+struct MaterialParameter {
+    std::string Name;
+    MaterialParameterType Type = MaterialParameterType::Float;
+    // Value new materials start with; scalars take the x component
+    Vec4 Default = Vec4(0.0f);
+    uint32_t Offset = 0;
+};
+
+// The parameters every material of a MaterialSystem has, in declaration order. Offsets follow
+// the GLSL rules for the packing, so the generated struct and the CPU copy always agree.
+class MaterialLayout {
+public:
+    MaterialLayout& Add(const std::string& Name, MaterialParameterType Type, const Vec4& Default = Vec4(0.0f));
+
+    // Assigns offsets and returns the array stride of one material.
+    uint32_t Pack(MaterialPacking Packing);
+
+    [[nodiscard]] uint32_t Find(const std::string& Name) const;
+
+    [[nodiscard]] const std::vector<MaterialParameter>& GetParameters() const { return Parameters; }
+
+private:
+    std::vector<MaterialParameter> Parameters;
+};
+
+// All materials of one layout, packed into one buffer and bound once per frame. Draws pick
+// their material through a per-instance index, so switching material costs nothing on the CPU
+// side, and edits upload only the dirty range. The buffer is a dynamic one from Resources, so a
+// storage block that grows leaves the old buffer to the frames still reading it.
+//
+// Shaders include GetShaderSource() (after GetShaderExtensions(), right below #version), which
+// declares
+//   struct MaterialData { ... };   with the layout's parameters as members
+//   MaterialData GetMaterial(uint index)
+//   vec4 Sample<Name>(MaterialData material, vec2 uv)   for each texture parameter (white
+//                                                      when unset)
+class MaterialSystem {
+public:
+    MaterialSystem(ResourceManager& Resources, const MaterialLayout& Layout, MaterialPacking Packing, uint32_t Binding);
+    ~MaterialSystem();
+
+    MaterialSystem(const MaterialSystem&) = delete;
+    MaterialSystem& operator=(const MaterialSystem&) = delete;
+
+    // Requires a current context; Bindless selects how texture parameters are stored.
+    bool Initialize(bool Bindless);
+    void Shutdown();
+
+    // A new material with the layout's defaults. Std140 blocks have a fixed capacity; past it,
+    // an error is printed and InvalidMaterialId returned.
+    MaterialId Create();
+    void Destroy(MaterialId Id);
+
+    void SetFloat(MaterialId Id, uint32_t Parameter, float Value);
+    void SetInt(MaterialId Id, uint32_t Parameter, int32_t Value);
+    void SetUInt(MaterialId Id, uint32_t Parameter, uint32_t Value);
+    void SetVec2(MaterialId Id, uint32_t Parameter, const Vec2& Value);
+    void SetVec3(MaterialId Id, uint32_t Parameter, const Vec3& Value);
+    void SetVec4(MaterialId Id, uint32_t Parameter, const Vec4& Value);
+    void SetTexture(MaterialId Id, uint32_t Parameter, TextureId Texture);
+
+    void SetFloat(MaterialId Id, const std::string& Name, float Value) { SetFloat(Id, Layout.Find(Name), Value); }
+    void SetVec4(MaterialId Id, const std::string& Name, const Vec4& Value) { SetVec4(Id, Layout.Find(Name), Value); }
+    void SetTexture(MaterialId Id, const std::string& Name, TextureId Texture) { SetTexture(Id, Layout.Find(Name), Texture); }
+
+    // Refreshes texture references when Textures re-created any, then uploads what changed.
+    void Update(const TextureStreamer& Textures);
+
+    // Binds the buffer to the block binding point. For std140, also points the program's block
+    // at it once (GLSL 330 cannot declare uniform block bindings).
+    void Bind(const Shader& Program);
+
+    // For a program that replaced another, e.g. after a reload: GL may have given it the id of
+    // a destroyed program whose block Bind already pointed, so Bind does that again.
+    void ForgetProgram(const Shader& Program);
+
+    // Without bindless handles: binds the material's textures to units FirstUnit.. and sets
+    // the samplers GetShaderSource() declares. Returns false if the material has none.
+    bool BindTextures(const Shader& Program, const TextureStreamer& Textures, MaterialId Id, int FirstUnit) const;
+
+    // Marks whether BindTextures() is in effect for the coming draws; without bindless
+    // handles, texture parameters read white otherwise.
+    void SetTexturesBound(const Shader& Program, bool Bound) const;
+
+    [[nodiscard]] bool HasTextures(MaterialId Id) const;
+
+    // Texture parameters of a material, e.g. for streaming feedback. InvalidTextureId if unset.
+    [[nodiscard]] TextureId GetTexture(MaterialId Id, uint32_t TextureSlot) const {
+        return TextureIds[Id * TextureParameters.size() + TextureSlot];
+    }
+
+    [[nodiscard]] uint32_t GetTextureParameterCount() const { return static_cast<uint32_t>(TextureParameters.size()); }
+
+    [[nodiscard]] uint32_t GetMaterialCount() const { return static_cast<uint32_t>(Alive.size()); }
+
+    [[nodiscard]] uint32_t GetStride() const { return Stride; }
+
+    [[nodiscard]] bool IsBindless() const { return Bindless; }
+
+    [[nodiscard]] const std::string& GetShaderExtensions() const { return ShaderExtensions; }
+
+    [[nodiscard]] const std::string& GetShaderSource() const { return ShaderSource; }
+
+private:
+    void Write(MaterialId Id, uint32_t Parameter, MaterialParameterType Type, const void* Value, size_t Size);
+    void WriteTextureReference(MaterialId Id, uint32_t TextureSlot, const TextureStreamer* Textures);
+    void GenerateShaderSource();
+    [[nodiscard]] unsigned int GetBufferId() const;
+
+    ResourceManager& Resources;
+    MaterialLayout Layout;
+    MaterialPacking Packing;
+    uint32_t Binding;
+    uint32_t Stride = 0;
+    // Std140 only: the uniform block is a fixed-size array
+    uint32_t Capacity = 0;
+    bool Bindless = false;
+
+    std::vector<uint8_t> Data;
+    std::vector<bool> Alive;
+    std::vector<MaterialId> FreeIds;
+    // Indices of the texture parameters, and per material the texture each one refers to
+    std::vector<uint32_t> TextureParameters;
+    std::vector<TextureId> TextureIds;
+    uint32_t TextureGeneration = ~0u;
+    bool TexturesChanged = false;
+
+    uint32_t DirtyBegin = ~0u;
+    uint32_t DirtyEnd = 0;
+
+    ResourceHandle<GPUBuffer> Buffer;
+    size_t BufferCapacity = 0;
+    // Programs whose uniform block already points at Binding
+    std::vector<unsigned int> BoundPrograms;
+
+    std::string ShaderExtensions;
+    std::string ShaderSource;
+};
+
+} // namespace Volante
@@ -0,0 +1,74 @@
+#include "MeshFile.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace Volante {
+
+namespace {
+
+constexpr char Magic[4] = {'V', 'M', 'S', 'H'};
+
+struct MeshFileHeader {
+    char Magic[4];
+    uint32_t Version;
+    uint32_t VertexCount;
+    uint32_t IndexCount;
+};
+
+static_assert(sizeof(MeshFileHeader) == 16);
+static_assert(sizeof(Vertex) == 32, "The file stores Vertex as eight packed floats");
+
+bool Fail(const std::string& Path, const char* Reason) {
+    std::cerr << "ERROR::MESH_FILE::" << Reason << ": " << Path << std::endl;
+    return false;
+}
+
+} // namespace
+
+bool ReadMeshFile(const std::string& Path, MeshData& Out) {
+    std::ifstream File(Path, std::ios::binary | std::ios::ate);
+    if (!File) { return Fail(Path, "FILE_NOT_FOUND"); }
+    const auto FileSize = static_cast<uint64_t>(File.tellg());
+    File.seekg(0);
+
+    MeshFileHeader Header{};
+    if (!File.read(reinterpret_cast<char*>(&Header), sizeof(Header))) { return Fail(Path, "TRUNCATED"); }
+    if (std::memcmp(Header.Magic, Magic, sizeof(Magic)) != 0) { return Fail(Path, "NOT_A_MESH"); }
+    if (Header.Version != MeshFileVersion) { return Fail(Path, "UNSUPPORTED_VERSION"); }
+
+    const uint64_t VertexBytes = static_cast<uint64_t>(Header.VertexCount) * sizeof(Vertex);
+    const uint64_t IndexBytes = static_cast<uint64_t>(Header.IndexCount) * sizeof(unsigned int);
+    // Checked before allocating, so a corrupt count cannot ask for gigabytes
+    if (FileSize < sizeof(Header) + VertexBytes + IndexBytes) { return Fail(Path, "TRUNCATED"); }
+
+    Out.Vertices.resize(Header.VertexCount);
+    Out.Indices.resize(Header.IndexCount);
+    File.read(reinterpret_cast<char*>(Out.Vertices.data()), static_cast<std::streamsize>(VertexBytes));
+    File.read(reinterpret_cast<char*>(Out.Indices.data()), static_cast<std::streamsize>(IndexBytes));
+    if (!File) { return Fail(Path, "READ_FAILED"); }
+
+    for (const unsigned int Index : Out.Indices) {
+        if (Index >= Header.VertexCount) { return Fail(Path, "INDEX_OUT_OF_RANGE"); }
+    }
+    return true;
+}
+
+bool WriteMeshFile(const std::string& Path, const MeshData& Data) {
+    std::ofstream File(Path, std::ios::binary | std::ios::trunc);
+    if (!File) { return Fail(Path, "OPEN_FAILED"); }
+
+    MeshFileHeader Header{};
+    std::memcpy(Header.Magic, Magic, sizeof(Magic));
+    Header.Version = MeshFileVersion;
+    Header.VertexCount = static_cast<uint32_t>(Data.Vertices.size());
+    Header.IndexCount = static_cast<uint32_t>(Data.Indices.size());
+    File.write(reinterpret_cast<const char*>(&Header), sizeof(Header));
+    File.write(reinterpret_cast<const char*>(Data.Vertices.data()), static_cast<std::streamsize>(Data.Vertices.size() * sizeof(Vertex)));
+    File.write(reinterpret_cast<const char*>(Data.Indices.data()), static_cast<std::streamsize>(Data.Indices.size() * sizeof(unsigned int)));
+    if (!File) { return Fail(Path, "WRITE_FAILED"); }
+    return true;
+}
+
+} // namespace Volante
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+
+#include "ProceduralMesh.h"
+
+namespace Volante {
+
+// Binary mesh asset (.vmesh): a 16-byte header, then the Vertex array and the 32-bit index
+// array exactly as uploaded, so loading is two reads and no parsing.
+//
+//   char     Magic[4] = "VMSH"
+//   uint32_t Version  = MeshFileVersion
+//   uint32_t VertexCount
+//   uint32_t IndexCount
+//
+// Little-endian; Vertex is eight floats (position, normal, texCoord).
+constexpr uint32_t MeshFileVersion = 1;
+
+// Prints the reason and returns false if the file is missing, truncated or not a mesh.
+bool ReadMeshFile(const std::string& Path, MeshData& Out);
+
+bool WriteMeshFile(const std::string& Path, const MeshData& Data);
+
+} // namespace Volante
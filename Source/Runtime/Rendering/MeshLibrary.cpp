@@ -0,0 +1,138 @@
+#include "MeshLibrary.h"
+
+#include <iostream>
+#include <mutex>
+
+#include "Mesh.h"
+#include "MeshFile.h"
+#include "Runtime/Core/Async/JobSystem.h"
+#include "Runtime/Core/IO/FileWatcher.h"
+
+namespace Volante {
+
+struct MeshLibrary::ReadQueue {
+    std::mutex Mutex;
+    std::vector<ReadResult> Finished;
+};
+
+MeshLibrary::MeshLibrary(JobSystem* Jobs) : Jobs(Jobs), Reads(std::make_shared<ReadQueue>()) {}
+
+MeshLibrary::~MeshLibrary() {
+    Shutdown();
+}
+
+void MeshLibrary::Initialize() {
+    Watcher = std::make_unique<FileWatcher>();
+    for (const auto& [Path, Id] : AssetsByPath) {
+        Watcher->Watch(Path);
+    }
+}
+
+void MeshLibrary::Shutdown() {
+    Assets.clear();
+    AssetsByPath.clear();
+    Watcher.reset();
+    // Reads still running finish into the old queue and are dropped with it
+    Reads = std::make_shared<ReadQueue>();
+    ReadyReads.clear();
+    PendingReads = 0;
+    Stats = {};
+}
+
+void MeshLibrary::Update(float DeltaTime) {
+    {
+        std::lock_guard Lock(Reads->Mutex);
+        for (ReadResult& Result : Reads->Finished) {
+            ReadyReads.push_back(std::move(Result));
+        }
+        Reads->Finished.clear();
+    }
+
+    uint64_t UploadedBytes = 0;
+    size_t Applied = 0;
+    for (; Applied < ReadyReads.size(); ++Applied) {
+        ReadResult& Result = ReadyReads[Applied];
+        Asset& Target = Assets[Result.Id];
+        if (Result.Build != Target.Build) {
+            --PendingReads;
+            continue;
+        }
+        if (!Result.Succeeded) {
+            std::cerr << "ERROR::MESH_LIBRARY::RELOAD_FAILED: " << Target.Path << " (keeping the previous mesh)" << std::endl;
+            ++Stats.FailedReloadCount;
+            --PendingReads;
+            continue;
+        }
+
+        const uint64_t Bytes = Result.Data.Vertices.size() * sizeof(Vertex) + Result.Data.Indices.size() * sizeof(uint32_t);
+        // Always at least one, so a mesh larger than the cap still gets through
+        if (UploadedBytes > 0 && UploadedBytes + Bytes > UploadBytesPerFrame) { break; }
+        UploadedBytes += Bytes;
+
+        Target.Current = std::make_unique<Mesh>(std::move(Result.Data));
+        ++Target.Version;
+        ++Stats.ReloadCount;
+        --PendingReads;
+    }
+    ReadyReads.erase(ReadyReads.begin(), ReadyReads.begin() + static_cast<std::ptrdiff_t>(Applied));
+
+    if (Watcher) {
+        for (const std::string& Path : Watcher->PollChanges()) {
+            const auto It = AssetsByPath.find(Path);
+            if (It != AssetsByPath.end()) { QueueReload(It->second); }
+        }
+    }
+
+    Stats.MeshCount = static_cast<uint32_t>(Assets.size());
+    Stats.PendingCount = PendingReads;
+}
+
+MeshAssetId MeshLibrary::Load(const std::string& Path) {
+    const std::string File = FileWatcher::Normalize(Path);
+    if (const auto It = AssetsByPath.find(File); It != AssetsByPath.end()) { return It->second; }
+
+    const auto Id = static_cast<MeshAssetId>(Assets.size());
+    Asset& Target = Assets.emplace_back();
+    Target.Path = File;
+    AssetsByPath.emplace(File, Id);
+    if (Watcher) { Watcher->Watch(File); }
+
+    MeshData Data;
+    if (ReadMeshFile(File, Data)) {
+        Target.Current = std::make_unique<Mesh>(std::move(Data));
+        Target.Version = 1;
+    }
+    Stats.MeshCount = static_cast<uint32_t>(Assets.size());
+    return Id;
+}
+
+const Mesh* MeshLibrary::Get(MeshAssetId Id) const {
+    return Id < Assets.size() ? Assets[Id].Current.get() : nullptr;
+}
+
+uint32_t MeshLibrary::GetVersion(MeshAssetId Id) const {
+    return Id < Assets.size() ? Assets[Id].Version : 0;
+}
+
+void MeshLibrary::QueueReload(MeshAssetId Id) {
+    Asset& Target = Assets[Id];
+    ++Target.Build;
+    ++PendingReads;
+
+    auto Read = [Path = Target.Path, Id, Build = Target.Build, Queue = Reads] {
+        ReadResult Result;
+        Result.Id = Id;
+        Result.Build = Build;
+        Result.Succeeded = ReadMeshFile(Path, Result.Data);
+
+        std::lock_guard Lock(Queue->Mutex);
+        Queue->Finished.push_back(std::move(Result));
+    };
+    if (Jobs) {
+        Jobs->Submit(std::move(Read));
+    } else {
+        Read();
+    }
+}
+
+} // namespace Volante
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Engine.h"
+#include "ProceduralMesh.h"
+
+namespace Volante {
+
+class Mesh;
+class JobSystem;
+class FileWatcher;
+
+using MeshAssetId = uint32_t;
+constexpr MeshAssetId InvalidMeshAssetId = ~0u;
+
+struct MeshLibraryStats {
+    uint32_t MeshCount = 0;
+    // Reloads being read or waiting for upload
+    uint32_t PendingCount = 0;
+    uint32_t ReloadCount = 0;
+    uint32_t FailedReloadCount = 0;
+};
+
+// Binary mesh assets (.vmesh, see MeshFile.h) that reload when their file is rewritten.
+//
+// A changed file is read on the job system; the next Update() uploads it into a new Mesh and
+// swaps it in, so a mesh is never seen half-uploaded. A file that no longer reads keeps the
+// previous mesh. At most UploadBytesPerFrame (but always one mesh) is uploaded per Update, so
+// exporting a batch of assets spreads over a few frames instead of stalling one.
+class MeshLibrary : public IEngineSubsystem {
+public:
+    static constexpr uint64_t UploadBytesPerFrame = 32ull << 20;
+
+    explicit MeshLibrary(JobSystem* Jobs = nullptr);
+    ~MeshLibrary() override;
+
+    MeshLibrary(const MeshLibrary&) = delete;
+    MeshLibrary& operator=(const MeshLibrary&) = delete;
+
+    void Initialize() override;
+    void Shutdown() override;
+    // Uploads finished reloads and starts new ones. Call between frames, with the context current.
+    void Update(float DeltaTime) override;
+
+    // Reads and uploads the mesh now. A mesh whose file cannot be read still gets an id, and
+    // Get() returns null for it until the file is fixed.
+    MeshAssetId Load(const std::string& Path);
+
+    // The mesh swapped in by the last Update. Look it up each frame rather than keeping the
+    // pointer: a reload destroys the previous Mesh.
+    [[nodiscard]] const Mesh* Get(MeshAssetId Id) const;
+
+    // Bumped every time the mesh is swapped.
+    [[nodiscard]] uint32_t GetVersion(MeshAssetId Id) const;
+
+    [[nodiscard]] const MeshLibraryStats& GetStats() const { return Stats; }
+
+private:
+    struct ReadResult {
+        MeshAssetId Id = InvalidMeshAssetId;
+        uint32_t Build = 0;
+        MeshData Data;
+        bool Succeeded = false;
+    };
+
+    struct Asset {
+        std::string Path;
+        std::unique_ptr<Mesh> Current;
+        uint32_t Version = 0;
+        // Bumped per requested reload, so an older read finishing late is dropped
+        uint32_t Build = 0;
+    };
+
+    struct ReadQueue;
+
+    void QueueReload(MeshAssetId Id);
+
+    JobSystem* Jobs;
+    std::unique_ptr<FileWatcher> Watcher;
+    std::vector<Asset> Assets;
+    // Normalized path -> asset
+    std::unordered_map<std::string, MeshAssetId> AssetsByPath;
+    std::shared_ptr<ReadQueue> Reads;
+    std::vector<ReadResult> ReadyReads;
+    uint32_t PendingReads = 0;
+    MeshLibraryStats Stats;
+};
+
+} // namespace Volante
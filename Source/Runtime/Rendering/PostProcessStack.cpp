@@ -0,0 +1,479 @@
+#include "PostProcessStack.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+
+#include "DepthConvention.h"
+#include "Shader.h"
+
+namespace Volante {
+
+namespace {
+
+constexpr uint32_t MaxBloomLevels = 8;
+// Halton (2, 3) points; eight are enough for the history to converge within its blend weight
+constexpr uint32_t JitterSequenceLength = 8;
+// Render targets are allocated in steps of this many pixels, so resizing the window by a few
+// pixels at a time reallocates only when it crosses a step
+constexpr int TargetGranularity = 64;
+// Frames the targets must be mostly unused before they shrink
+constexpr uint32_t TargetShrinkFrames = 120;
+
+float Halton(uint32_t Index, uint32_t Base) {
+    float Result = 0.0f;
+    float Fraction = 1.0f;
+    while (Index > 0) {
+        Fraction /= static_cast<float>(Base);
+        Result += Fraction * static_cast<float>(Index % Base);
+        Index /= Base;
+    }
+    return Result;
+}
+
+void BindTexture(uint32_t Unit, unsigned int Texture, GLenum Target = GL_TEXTURE_2D) {
+    glActiveTexture(GL_TEXTURE0 + Unit);
+    glBindTexture(Target, Texture);
+}
+
+Vec2 GetTexelSize(const FrameGraphTextureDesc& Desc) {
+    return Vec2(1.0f / static_cast<float>(Desc.Width), 1.0f / static_cast<float>(Desc.Height));
+}
+
+// Every pass renders to the lower-left part of its targets that this frame uses, so samplers
+// come with a rect: xy scales the pass's UV onto the used part of the texture and zw is the
+// largest UV whose bilinear footprint stays inside it. This is the rect for the Size pixels of
+// a texture allocated as Desc.
+Vec4 GetSourceRect(const Vec2& Size, const FrameGraphTextureDesc& Desc) {
+    const Vec2 Allocated(static_cast<float>(Desc.Width), static_cast<float>(Desc.Height));
+    return Vec4(Size / Allocated, (Size - 0.5f) / Allocated);
+}
+
+int RoundUpToGranularity(int Value) {
+    return (Value + TargetGranularity - 1) / TargetGranularity * TargetGranularity;
+}
+
+} // namespace
+
+PostProcessStack::PostProcessStack(const PostProcessDesc& Desc, ShaderLibrary* Shaders) : Desc(Desc), Shaders(Shaders) {}
+
+PostProcessStack::~PostProcessStack() {
+    Shutdown();
+}
+
+bool PostProcessStack::Initialize() {
+    Shutdown();
+
+    if (!Shaders) {
+        OwnedShaders = std::make_unique<ShaderLibrary>();
+        OwnedShaders->Initialize();
+        Shaders = OwnedShaders.get();
+    }
+    const std::string& Directory = ShaderLibrary::GetShaderDirectory();
+    const std::string Fullscreen = Directory + "/Fullscreen.vert";
+    ResolveProgram.Id = Shaders->Load({Fullscreen, Directory + "/MSAAResolve.frag"});
+    DownsampleProgram.Id = Shaders->Load({Fullscreen, Directory + "/BloomDownsample.frag"});
+    UpsampleProgram.Id = Shaders->Load({Fullscreen, Directory + "/BloomUpsample.frag"});
+    TemporalProgram.Id = Shaders->Load({Fullscreen, Directory + "/Temporal.frag"});
+    TonemapProgram.Id = Shaders->Load({Fullscreen, Directory + "/Tonemap.frag"});
+    FXAAProgram.Id = Shaders->Load({Fullscreen, Directory + "/FXAA.frag"});
+    PresentProgram.Id = Shaders->Load({Fullscreen, Directory + "/Upscale.frag"});
+    for (const ShaderProgramHandle* Program : GetPrograms()) {
+        if (!Shaders->Get(Program->Id)) {
+            std::cerr << "ERROR::POST_PROCESS::SHADERS_FAILED" << std::endl;
+            Shutdown();
+            return false;
+        }
+    }
+    RefreshPrograms();
+
+    GLint ColorSamples = 1;
+    GLint DepthSamples = 1;
+    glGetIntegerv(GL_MAX_COLOR_TEXTURE_SAMPLES, &ColorSamples);
+    glGetIntegerv(GL_MAX_DEPTH_TEXTURE_SAMPLES, &DepthSamples);
+    MaxSamples = std::max(std::min(ColorSamples, DepthSamples), 1);
+
+    glGenVertexArrays(1, &VertexArray);
+    Valid = true;
+    return true;
+}
+
+void PostProcessStack::Shutdown() {
+    if (Shaders) {
+        for (ShaderProgramHandle* Program : GetPrograms()) {
+            Shaders->Unload(Program->Id);
+            *Program = {};
+        }
+    }
+    if (VertexArray != 0) { glDeleteVertexArrays(1, &VertexArray); }
+    if (History[0] != 0) { glDeleteTextures(2, History); }
+    VertexArray = 0;
+    History[0] = History[1] = 0;
+    HistoryWidth = HistoryHeight = 0;
+    HistoryValid = false;
+    TargetWidth = TargetHeight = 0;
+    ShrinkFrames = 0;
+    Valid = false;
+    if (OwnedShaders) {
+        OwnedShaders->Shutdown();
+        OwnedShaders.reset();
+        Shaders = nullptr;
+    }
+}
+
+AntiAliasingMode PostProcessStack::GetAntiAliasing() const {
+    if (Desc.AntiAliasing == AntiAliasingMode::MSAA && std::min(Desc.MSAASamples, MaxSamples) <= 1) {
+        return AntiAliasingMode::None;
+    }
+    // History reprojection follows one camera
+    if (Desc.AntiAliasing == AntiAliasingMode::TAA && ViewCount > 1) { return AntiAliasingMode::FXAA; }
+    return Desc.AntiAliasing;
+}
+
+Vec2 PostProcessStack::GetJitter() const {
+    if (GetAntiAliasing() != AntiAliasingMode::TAA || RenderWidth == 0) { return Vec2(0.0f); }
+    const uint32_t Index = JitterIndex % JitterSequenceLength + 1;
+    const Vec2 Offset(Halton(Index, 2) - 0.5f, Halton(Index, 3) - 0.5f);
+    return Offset * 2.0f / Vec2(static_cast<float>(RenderWidth), static_cast<float>(RenderHeight));
+}
+
+void PostProcessStack::SetMainView(const RenderView& View, uint32_t InViewCount) {
+    ViewCount = std::max(InViewCount, 1u);
+    Jitter = GetJitter();
+    ViewOrigin = View.Origin;
+    // Reprojection works between pixel centres, so the jitter comes back out
+    ViewProjection = glm::translate(Mat4(1.0f), Vec3(-Jitter, 0.0f)) * View.RelativeViewProjection;
+}
+
+void PostProcessStack::GetRenderSize(int OutputWidth, int OutputHeight, int& Width, int& Height) const {
+    GetScaledSize(OutputWidth, OutputHeight, Desc.RenderScale, Width, Height);
+}
+
+void PostProcessStack::GetScaledSize(int OutputWidth, int OutputHeight, float Scale, int& Width, int& Height) {
+    Scale = std::clamp(Scale, 0.1f, 1.0f);
+    Width = std::max(static_cast<int>(std::lround(static_cast<float>(OutputWidth) * Scale)), 1);
+    Height = std::max(static_cast<int>(std::lround(static_cast<float>(OutputHeight) * Scale)), 1);
+}
+
+void PostProcessStack::UpdateTargetSize(int Width, int Height) {
+    if (Width > TargetWidth || Height > TargetHeight) {
+        TargetWidth = std::max(TargetWidth, RoundUpToGranularity(Width));
+        TargetHeight = std::max(TargetHeight, RoundUpToGranularity(Height));
+        ShrinkFrames = 0;
+        return;
+    }
+    // Under half used for a while, e.g. after the window shrank: give the memory back
+    const bool Oversized = static_cast<int64_t>(Width) * Height * 2 < static_cast<int64_t>(TargetWidth) * TargetHeight;
+    ShrinkFrames = Oversized ? ShrinkFrames + 1 : 0;
+    if (ShrinkFrames > TargetShrinkFrames) {
+        TargetWidth = RoundUpToGranularity(Width);
+        TargetHeight = RoundUpToGranularity(Height);
+        ShrinkFrames = 0;
+    }
+}
+
+void PostProcessStack::UpdateHistory(FrameGraph& Graph) {
+    if (History[0] != 0 && TargetWidth == HistoryWidth && TargetHeight == HistoryHeight) { return; }
+    if (History[0] != 0) {
+        Graph.ForgetTexture(History[0]);
+        Graph.ForgetTexture(History[1]);
+        glDeleteTextures(2, History);
+    }
+    glGenTextures(2, History);
+    for (const unsigned int Texture : History) {
+        glBindTexture(GL_TEXTURE_2D, Texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, TargetWidth, TargetHeight, 0, GL_RGBA, GL_FLOAT, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+    HistoryWidth = TargetWidth;
+    HistoryHeight = TargetHeight;
+    HistoryValid = false;
+}
+
+std::array<ShaderProgramHandle*, 7> PostProcessStack::GetPrograms() {
+    return {&ResolveProgram, &DownsampleProgram, &UpsampleProgram, &TemporalProgram, &TonemapProgram, &FXAAProgram, &PresentProgram};
+}
+
+void PostProcessStack::RefreshPrograms() {
+    // Samplers stay on fixed units: 0 for the main input, then 1 and 2. A reload starts the
+    // program over with none set.
+    for (ShaderProgramHandle* Program : GetPrograms()) {
+        if (!Shaders->Refresh(*Program)) { continue; }
+        const Shader& Current = GetShader(*Program);
+        Current.use();
+        Current.setInt("uSource", 0);
+        Current.setInt("uScene", 0);
+        Current.setInt("uCurrent", 0);
+        Current.setInt("uBase", 1);
+        Current.setInt("uBloom", 1);
+        Current.setInt("uHistory", 1);
+        Current.setInt("uDepth", 2);
+    }
+    glUseProgram(0);
+}
+
+const Shader& PostProcessStack::GetShader(const ShaderProgramHandle& Program) const {
+    return *Shaders->Get(Program.Id);
+}
+
+void PostProcessStack::DrawFullscreen(const Shader& Program) const {
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_CULL_FACE);
+    glDisable(GL_BLEND);
+    Program.use();
+    glBindVertexArray(VertexArray);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+}
+
+void PostProcessStack::AddPasses(FrameGraph& Graph, FrameGraphResource Output, const std::function<void()>& DrawScene) {
+    if (OwnedShaders) { OwnedShaders->Update(0.0f); }
+    RefreshPrograms();
+
+    // A resource and the lower-left Size pixels of it this frame uses
+    struct Target {
+        FrameGraphResource Resource;
+        Vec2 Size;
+    };
+
+    const FrameGraphTextureDesc OutputDesc = Graph.GetDesc(Output);
+    int Width = 0;
+    int Height = 0;
+    GetRenderSize(OutputDesc.Width, OutputDesc.Height, Width, Height);
+    int ReservedWidth = 0;
+    int ReservedHeight = 0;
+    GetScaledSize(OutputDesc.Width, OutputDesc.Height, std::max(Desc.RenderScale, Desc.ReservedScale), ReservedWidth, ReservedHeight);
+    UpdateTargetSize(ReservedWidth, ReservedHeight);
+    RenderWidth = Width;
+    RenderHeight = Height;
+    const Vec2 RenderSize(static_cast<float>(Width), static_cast<float>(Height));
+    const AntiAliasingMode Mode = GetAntiAliasing();
+    const int Samples = Mode == AntiAliasingMode::MSAA ? std::min(Desc.MSAASamples, MaxSamples) : 1;
+
+    const FrameGraphResource SceneColor = Graph.Create("SceneColor", {TargetWidth, TargetHeight, GL_RGBA16F, Samples});
+    SceneDepth = Graph.Create("SceneDepth", {TargetWidth, TargetHeight, GL_DEPTH_COMPONENT32F, Samples});
+    Graph.AddPass(
+        "Scene",
+        [&](FrameGraphBuilder& Builder) {
+            Builder.Write(SceneColor);
+            Builder.Write(SceneDepth);
+            Builder.SetViewport(Width, Height);
+        },
+        [&DrawScene](const FrameGraph&) {
+            glEnable(GL_DEPTH_TEST);
+            glEnable(GL_CULL_FACE);
+            DrawScene();
+        });
+
+    Target Color{SceneColor, RenderSize};
+    if (Samples > 1) {
+        const FrameGraphResource Resolved = Graph.Create("ResolvedColor", {TargetWidth, TargetHeight, GL_RGBA16F});
+        Graph.AddPass(
+            "Resolve",
+            [&](FrameGraphBuilder& Builder) {
+                Builder.Read(SceneColor);
+                Builder.Write(Resolved);
+                Builder.SetViewport(Width, Height);
+            },
+            [this, SceneColor, Samples](const FrameGraph& Graph) {
+                BindTexture(0, Graph.GetTexture(SceneColor), GL_TEXTURE_2D_MULTISAMPLE);
+                const Shader& Program = GetShader(ResolveProgram);
+                Program.use();
+                Program.setInt("uSamples", Samples);
+                DrawFullscreen(Program);
+            });
+        Color = {Resolved, RenderSize};
+    }
+
+    if (Mode == AntiAliasingMode::TAA) {
+        UpdateHistory(Graph);
+        const FrameGraphTextureDesc HistoryDesc{TargetWidth, TargetHeight, GL_RGBA16F};
+        const FrameGraphResource HistoryRead = Graph.Import("TemporalHistory", History[HistoryIndex], HistoryDesc);
+        const FrameGraphResource HistoryWrite = Graph.Import("TemporalOutput", History[HistoryIndex ^ 1], HistoryDesc);
+        // Last frame's (uv, depth) from this frame's, through the positions relative to the
+        // current view origin
+        const Mat4& ClipToTexture = GetClipToTexture();
+        const Mat4 Reprojection = ClipToTexture * PreviousViewProjection * glm::translate(Mat4(1.0f), ViewOrigin - PreviousOrigin) *
+                                  glm::inverse(ClipToTexture * ViewProjection);
+        const Vec4 CurrentRect = GetSourceRect(RenderSize, HistoryDesc);
+        const Vec4 HistoryRect = GetSourceRect(HistorySize, HistoryDesc);
+        const Target Current = Color;
+        Graph.AddPass(
+            "Temporal",
+            [&](FrameGraphBuilder& Builder) {
+                Builder.Read(Current.Resource);
+                Builder.Read(SceneDepth);
+                Builder.Read(HistoryRead);
+                Builder.Write(HistoryWrite);
+                Builder.SetViewport(Width, Height);
+            },
+            [this, Current, HistoryRead, Reprojection, CurrentRect, HistoryRect](const FrameGraph& Graph) {
+                BindTexture(0, Graph.GetTexture(Current.Resource));
+                BindTexture(1, Graph.GetTexture(HistoryRead));
+                BindTexture(2, Graph.GetTexture(SceneDepth));
+                const Shader& Program = GetShader(TemporalProgram);
+                Program.use();
+                Program.setMat4("uReprojection", Reprojection);
+                Program.setVec4("uCurrentRect", CurrentRect);
+                Program.setVec4("uHistoryRect", HistoryRect);
+                Program.setVec2("uTexelSize", GetTexelSize(Graph.GetDesc(Current.Resource)));
+                Program.setFloat("uBlend", std::clamp(Desc.TemporalBlend, 0.01f, 1.0f));
+                Program.setBool("uHistoryValid", HistoryValid);
+                DrawFullscreen(Program);
+                HistoryValid = true;
+            });
+        Color = {HistoryWrite, RenderSize};
+        HistoryIndex ^= 1;
+        HistorySize = RenderSize;
+        ++JitterIndex;
+    } else {
+        HistoryValid = false;
+    }
+    PreviousOrigin = ViewOrigin;
+    PreviousViewProjection = ViewProjection;
+
+    // Declared whenever levels are configured; the graph culls the chain if tonemapping does
+    // not read it
+    Target Bloom;
+    const uint32_t BloomLevels = std::min(Desc.BloomLevels, MaxBloomLevels);
+    if (BloomLevels > 0) {
+        Target Levels[MaxBloomLevels];
+        uint32_t LevelCount = 0;
+        Target Source = Color;
+        for (uint32_t Level = 1; Level <= BloomLevels; ++Level) {
+            const int LevelWidth = Width >> Level;
+            const int LevelHeight = Height >> Level;
+            if (LevelWidth < 2 || LevelHeight < 2) { break; }
+            const FrameGraphTextureDesc LevelDesc{std::max(TargetWidth >> Level, 1), std::max(TargetHeight >> Level, 1), GL_RGBA16F};
+            const Target Destination{Graph.Create("BloomDownsample", LevelDesc),
+                                     Vec2(static_cast<float>(LevelWidth), static_cast<float>(LevelHeight))};
+            Graph.AddPass(
+                "BloomDownsample",
+                [&](FrameGraphBuilder& Builder) {
+                    Builder.Read(Source.Resource);
+                    Builder.Write(Destination.Resource);
+                    Builder.SetViewport(LevelWidth, LevelHeight);
+                },
+                [this, Source, Level](const FrameGraph& Graph) {
+                    const FrameGraphTextureDesc& SourceDesc = Graph.GetDesc(Source.Resource);
+                    BindTexture(0, Graph.GetTexture(Source.Resource));
+                    const Shader& Program = GetShader(DownsampleProgram);
+                    Program.use();
+                    Program.setVec4("uSourceRect", GetSourceRect(Source.Size, SourceDesc));
+                    Program.setVec2("uTexelSize", GetTexelSize(SourceDesc));
+                    Program.setBool("uPrefilter", Level == 1);
+                    Program.setFloat("uThreshold", std::max(Desc.BloomThreshold, 0.0f));
+                    DrawFullscreen(Program);
+                });
+            Levels[LevelCount++] = Destination;
+            Source = Destination;
+        }
+        for (uint32_t Level = LevelCount; Level-- > 1;) {
+            const Target Base = Levels[Level - 1];
+            const Target Destination{Graph.Create("BloomUpsample", Graph.GetDesc(Base.Resource)), Base.Size};
+            Graph.AddPass(
+                "BloomUpsample",
+                [&](FrameGraphBuilder& Builder) {
+                    Builder.Read(Source.Resource);
+                    Builder.Read(Base.Resource);
+                    Builder.Write(Destination.Resource);
+                    Builder.SetViewport(static_cast<int>(Base.Size.x), static_cast<int>(Base.Size.y));
+                },
+                [this, Source, Base](const FrameGraph& Graph) {
+                    const FrameGraphTextureDesc& SourceDesc = Graph.GetDesc(Source.Resource);
+                    BindTexture(0, Graph.GetTexture(Source.Resource));
+                    BindTexture(1, Graph.GetTexture(Base.Resource));
+                    const Shader& Program = GetShader(UpsampleProgram);
+                    Program.use();
+                    Program.setVec4("uSourceRect", GetSourceRect(Source.Size, SourceDesc));
+                    Program.setVec4("uBaseRect", GetSourceRect(Base.Size, Graph.GetDesc(Base.Resource)));
+                    Program.setVec2("uTexelSize", GetTexelSize(SourceDesc));
+                    DrawFullscreen(Program);
+                });
+            Source = Destination;
+        }
+        if (LevelCount > 0) { Bloom = Source; }
+    }
+
+    // The last stage writes the output directly unless it still needs scaling
+    const bool Scaled = Width != OutputDesc.Width || Height != OutputDesc.Height;
+    const bool UseFXAA = Mode == AntiAliasingMode::FXAA;
+    const auto CreateDisplayTarget = [&](bool Last) {
+        const FrameGraphResource Resource =
+            Last && !Scaled ? Output : Graph.Create("DisplayColor", {TargetWidth, TargetHeight, GL_RGBA8});
+        return Target{Resource, RenderSize};
+    };
+
+    const bool ApplyBloom = Desc.Bloom && Desc.BloomIntensity > 0.0f && Bloom.Resource;
+    const Target Tonemapped = CreateDisplayTarget(!UseFXAA);
+    Graph.AddPass(
+        "Tonemap",
+        [&](FrameGraphBuilder& Builder) {
+            Builder.Read(Color.Resource);
+            if (ApplyBloom) { Builder.Read(Bloom.Resource); }
+            Builder.Write(Tonemapped.Resource);
+            Builder.SetViewport(Width, Height);
+        },
+        [this, Color, Bloom, ApplyBloom](const FrameGraph& Graph) {
+            BindTexture(0, Graph.GetTexture(Color.Resource));
+            BindTexture(1, ApplyBloom ? Graph.GetTexture(Bloom.Resource) : 0);
+            const Shader& Program = GetShader(TonemapProgram);
+            Program.use();
+            Program.setVec4("uSceneRect", GetSourceRect(Color.Size, Graph.GetDesc(Color.Resource)));
+            if (ApplyBloom) { Program.setVec4("uBloomRect", GetSourceRect(Bloom.Size, Graph.GetDesc(Bloom.Resource))); }
+            Program.setFloat("uBloomIntensity", ApplyBloom ? Desc.BloomIntensity : 0.0f);
+            Program.setFloat("uExposure", Desc.Exposure);
+            Program.setInt("uOperator", static_cast<int>(Desc.Tonemap));
+            DrawFullscreen(Program);
+        });
+
+    Target Display = Tonemapped;
+    if (UseFXAA) {
+        const Target Smoothed = CreateDisplayTarget(true);
+        Graph.AddPass(
+            "FXAA",
+            [&](FrameGraphBuilder& Builder) {
+                Builder.Read(Tonemapped.Resource);
+                Builder.Write(Smoothed.Resource);
+                Builder.SetViewport(Width, Height);
+            },
+            [this, Tonemapped](const FrameGraph& Graph) {
+                const FrameGraphTextureDesc& SourceDesc = Graph.GetDesc(Tonemapped.Resource);
+                BindTexture(0, Graph.GetTexture(Tonemapped.Resource));
+                const Shader& Program = GetShader(FXAAProgram);
+                Program.use();
+                Program.setVec4("uSourceRect", GetSourceRect(Tonemapped.Size, SourceDesc));
+                Program.setVec2("uTexelSize", GetTexelSize(SourceDesc));
+                DrawFullscreen(Program);
+            });
+        Display = Smoothed;
+    }
+
+    if (Scaled) {
+        Graph.AddPass(
+            "Present",
+            [&](FrameGraphBuilder& Builder) {
+                Builder.Read(Display.Resource);
+                Builder.Write(Output);
+            },
+            [this, Display](const FrameGraph& Graph) {
+                const FrameGraphTextureDesc& SourceDesc = Graph.GetDesc(Display.Resource);
+                BindTexture(0, Graph.GetTexture(Display.Resource));
+                const Shader& Program = GetShader(PresentProgram);
+                Program.use();
+                Program.setVec4("uSourceRect", GetSourceRect(Display.Size, SourceDesc));
+                Program.setVec2("uTexelSize", GetTexelSize(SourceDesc));
+                Program.setFloat("uSharpness", std::clamp(Desc.Sharpness, 0.0f, 1.0f));
+                DrawFullscreen(Program);
+            });
+    }
+}
+
+} // namespace Volante
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+#include "FrameGraph.h"
+#include "RenderView.h"
+#include "ShaderLibrary.h"
+
+namespace Volante {
+
+class Shader;
+
+enum class AntiAliasingMode : uint8_t {
+    None,
+    // Multisampled scene target, resolved before post-processing
+    MSAA,
+    // Post-process edge blur on the tonemapped image; cheapest
+    FXAA,
+    // Jittered projections accumulated over frames; falls back to FXAA with several views
+    TAA,
+};
+
+enum class TonemapOperator : uint8_t {
+    // Clamps; for scenes already lit in display range
+    None,
+    Reinhard,
+    // Narkowicz's fit of the ACES filmic curve
+    ACES,
+};
+
+struct PostProcessDesc {
+    AntiAliasingMode AntiAliasing = AntiAliasingMode::MSAA;
+    int MSAASamples = 4;
+
+    TonemapOperator Tonemap = TonemapOperator::ACES;
+    float Exposure = 1.0f;
+
+    // Light above Threshold (in scene units) spreads through a chain of half-size levels
+    bool Bloom = true;
+    float BloomThreshold = 1.0f;
+    float BloomIntensity = 0.6f;
+    uint32_t BloomLevels = 5;
+
+    // Weight of the new frame in the TAA history
+    float TemporalBlend = 0.1f;
+
+    // The scene and post passes run at this fraction of the output size and are upscaled,
+    // sharpened by Sharpness (0 to 1)
+    float RenderScale = 1.0f;
+    float Sharpness = 0.5f;
+    // Render targets are sized for at least this scale, so a RenderScale that moves below it
+    // (dynamic resolution) renders into part of them instead of reallocating
+    float ReservedScale = 0.0f;
+};
+
+// Renders the scene into an HDR target through a FrameGraph and post-processes it into the
+// output: MSAA resolve, bloom, TAA, tonemapping with sRGB encoding, FXAA, and an upscale
+// when the render scale is below 1. Passes the current settings do not consume are declared
+// anyway and left to the graph to cull, e.g. the bloom chain when its intensity is zero.
+//
+// Render-resolution targets are allocated in 64-pixel steps for the reserved scale and every
+// pass draws to their lower-left part, so the scale can change each frame and a window being
+// resized reallocates only now and then; they shrink once mostly unused for a while.
+//
+// The passes' programs are loaded through Shaders, from Fullscreen.vert and one fragment file
+// each; with none given the stack keeps a library of its own and updates it in AddPasses.
+//
+// Lighting is linear, so the stack is where colours are encoded for display.
+class PostProcessStack {
+public:
+    explicit PostProcessStack(const PostProcessDesc& Desc = {}, ShaderLibrary* Shaders = nullptr);
+    ~PostProcessStack();
+
+    PostProcessStack(const PostProcessStack&) = delete;
+    PostProcessStack& operator=(const PostProcessStack&) = delete;
+
+    bool Initialize();
+    void Shutdown();
+
+    // Sub-pixel offset for this frame's projections, in NDC of a view covering the whole
+    // render target; zero unless TAA is in use.
+    [[nodiscard]] Vec2 GetJitter() const;
+
+    // The main view the scene is about to be drawn from, with GetJitter applied, and how many
+    // views there are; TAA reprojects its history with it.
+    void SetMainView(const RenderView& View, uint32_t ViewCount);
+
+    // Declares the scene pass, which calls DrawScene with the HDR target bound, and the post
+    // passes after it. DrawScene must outlive the graph's Execute.
+    void AddPasses(FrameGraph& Graph, FrameGraphResource Output, const std::function<void()>& DrawScene);
+
+    // Scaled size the scene renders at for an output of OutputWidth x OutputHeight.
+    void GetRenderSize(int OutputWidth, int OutputHeight, int& Width, int& Height) const;
+
+    void SetDesc(const PostProcessDesc& InDesc) { Desc = InDesc; }
+
+    // For the next AddPasses; cheap to change every frame.
+    void SetRenderScale(float Scale) { Desc.RenderScale = Scale; }
+
+    [[nodiscard]] const PostProcessDesc& GetDesc() const { return Desc; }
+
+    // After clamping to what the context supports and to the view count.
+    [[nodiscard]] AntiAliasingMode GetAntiAliasing() const;
+
+    [[nodiscard]] bool IsValid() const { return Valid; }
+
+    // The scene's depth target from the last AddPasses, valid in that frame's graph. Passes
+    // added after AddPasses may read it, e.g. to pick.
+    [[nodiscard]] FrameGraphResource GetSceneDepth() const { return SceneDepth; }
+
+    // The main view from SetMainView without the jitter, projecting positions relative to
+    // GetViewOrigin across the whole render target.
+    [[nodiscard]] const Mat4& GetViewProjection() const { return ViewProjection; }
+
+    [[nodiscard]] const Vec3& GetViewOrigin() const { return ViewOrigin; }
+
+private:
+    static void GetScaledSize(int OutputWidth, int OutputHeight, float Scale, int& Width, int& Height);
+
+    void UpdateTargetSize(int Width, int Height);
+    void UpdateHistory(FrameGraph& Graph);
+    std::array<ShaderProgramHandle*, 7> GetPrograms();
+    // Sets the sampler units of programs that are new since the last call
+    void RefreshPrograms();
+    [[nodiscard]] const Shader& GetShader(const ShaderProgramHandle& Program) const;
+    void DrawFullscreen(const Shader& Program) const;
+
+    PostProcessDesc Desc;
+    bool Valid = false;
+    int MaxSamples = 1;
+
+    ShaderLibrary* Shaders = nullptr;
+    // Created in Initialize when no library was given
+    std::unique_ptr<ShaderLibrary> OwnedShaders;
+    ShaderProgramHandle ResolveProgram;
+    ShaderProgramHandle DownsampleProgram;
+    ShaderProgramHandle UpsampleProgram;
+    ShaderProgramHandle TemporalProgram;
+    ShaderProgramHandle TonemapProgram;
+    ShaderProgramHandle FXAAProgram;
+    ShaderProgramHandle PresentProgram;
+    unsigned int VertexArray = 0;
+    FrameGraphResource SceneDepth;
+
+    // Size of the render-resolution targets, of which this frame uses RenderWidth x RenderHeight
+    int TargetWidth = 0;
+    int TargetHeight = 0;
+    uint32_t ShrinkFrames = 0;
+
+    // TAA: history ping-pong kept across frames, and the views it was rendered from
+    unsigned int History[2] = {};
+    int HistoryWidth = 0;
+    int HistoryHeight = 0;
+    uint32_t HistoryIndex = 0;
+    bool HistoryValid = false;
+    // Part of the history the last frame rendered
+    Vec2 HistorySize = Vec2(0.0f);
+    uint32_t ViewCount = 1;
+    // Last frame's, which the jitter is sized for
+    int RenderWidth = 0;
+    int RenderHeight = 0;
+    uint32_t JitterIndex = 0;
+    Vec2 Jitter = Vec2(0.0f);
+    Vec3 ViewOrigin = Vec3(0.0f);
+    Mat4 ViewProjection = Mat4(1.0f);
+    Vec3 PreviousOrigin = Vec3(0.0f);
+    Mat4 PreviousViewProjection = Mat4(1.0f);
+};
+
+} // namespace Volante
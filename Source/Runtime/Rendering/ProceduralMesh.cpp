@@ -0,0 +1,302 @@
+#include "ProceduralMesh.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Mesh.h"
+#include "ResourceManager.h"
+#include "Runtime/Core/Async/JobSystem.h"
+#include "Runtime/Core/Misc/Utility.h"
+
+namespace Volante {
+
+namespace {
+
+// Below this many vertices a mesh is generated on the calling thread; dispatch would cost more
+constexpr size_t ParallelVertexThreshold = 16384;
+constexpr uint32_t VerticesPerJob = 4096;
+
+// Icosphere vertex counts past this overflow a 32-bit index buffer's practical range
+constexpr uint32_t MaxIcosphereSubdivisions = 10;
+
+JobSystem* GetJobsFor(JobSystem* Jobs, size_t VertexCount) {
+    return VertexCount >= ParallelVertexThreshold ? Jobs : nullptr;
+}
+
+Vec2 GetSphericalUV(const Vec3& Direction) {
+    float U = std::atan2(Direction.y, Direction.x) / TWO_PI;
+    if (U < 0.0f) { U += 1.0f; }
+    return {U, std::acos(std::clamp(Direction.z, -1.0f, 1.0f)) / PI};
+}
+
+// Cube point (each component in [-1, 1]) to the unit sphere. Unlike normalizing, cells near the
+// cube's corners keep roughly the area of those at a face's center.
+Vec3 SpherifyCubePoint(const Vec3& P) {
+    const Vec3 P2 = P * P;
+    return {P.x * std::sqrt(1.0f - P2.y * 0.5f - P2.z * 0.5f + P2.y * P2.z / 3.0f),
+            P.y * std::sqrt(1.0f - P2.z * 0.5f - P2.x * 0.5f + P2.z * P2.x / 3.0f),
+            P.z * std::sqrt(1.0f - P2.x * 0.5f - P2.y * 0.5f + P2.x * P2.y / 3.0f)};
+}
+
+} // namespace
+
+MeshData GenerateCube(float Size) {
+    const float Half = Size * 0.5f;
+    // Per face: normal, then the in-plane axes the four corners step along, counter-clockwise
+    // seen from outside
+    struct Face {
+        Vec3 Normal;
+        Vec3 Right;
+        Vec3 Up;
+    };
+    static const Face Faces[] = {
+        {{0.0f, 0.0f, 1.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}},
+        {{0.0f, 0.0f, -1.0f}, {-1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}},
+        {{0.0f, 1.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, -1.0f}},
+        {{0.0f, -1.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f}},
+        {{1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, -1.0f}, {0.0f, 1.0f, 0.0f}},
+        {{-1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 1.0f, 0.0f}},
+    };
+    static const Vec2 Corners[] = {{0.0f, 0.0f}, {1.0f, 0.0f}, {1.0f, 1.0f}, {0.0f, 1.0f}};
+
+    MeshData Data;
+    Data.Vertices.reserve(24);
+    Data.Indices.reserve(36);
+    for (const Face& F : Faces) {
+        const auto Base = static_cast<unsigned int>(Data.Vertices.size());
+        for (const Vec2& UV : Corners) {
+            const Vec3 Position = (F.Normal + F.Right * (UV.x * 2.0f - 1.0f) + F.Up * (UV.y * 2.0f - 1.0f)) * Half;
+            Data.Vertices.push_back({Position, F.Normal, UV});
+        }
+        for (const unsigned int Corner : {0u, 1u, 2u, 2u, 3u, 0u}) {
+            Data.Indices.push_back(Base + Corner);
+        }
+    }
+    return Data;
+}
+
+MeshData GenerateUVSphere(float Radius, uint32_t Sectors, uint32_t Stacks, JobSystem* Jobs) {
+    MeshData Data;
+    if (Sectors == 0 || Stacks == 0) { return Data; }
+
+    const uint32_t RowLength = Sectors + 1;
+    Data.Vertices.resize(static_cast<size_t>(Stacks + 1) * RowLength);
+    // Pole rows contribute one triangle per sector, the others two
+    Data.Indices.resize(static_cast<size_t>(6) * Sectors * (Stacks - 1));
+
+    // One sin/cos per column and per row instead of per vertex
+    const float SectorStep = TWO_PI / static_cast<float>(Sectors);
+    const float StackStep = PI / static_cast<float>(Stacks);
+    std::vector<Vec2> SectorDirections(RowLength);
+    for (uint32_t j = 0; j < RowLength; ++j) {
+        const float Angle = static_cast<float>(j) * SectorStep;
+        SectorDirections[j] = {std::cos(Angle), std::sin(Angle)};
+    }
+
+    const uint32_t Grain = std::max(1u, VerticesPerJob / RowLength);
+    ParallelFor(GetJobsFor(Jobs, Data.Vertices.size()), Stacks + 1, Grain, [&](uint32_t Begin, uint32_t End) {
+        for (uint32_t i = Begin; i < End; ++i) {
+            const float StackAngle = HALF_PI - static_cast<float>(i) * StackStep;
+            const float RingScale = std::cos(StackAngle);
+            const float Height = std::sin(StackAngle);
+            const float V = static_cast<float>(i) / static_cast<float>(Stacks);
+
+            Vertex* Row = &Data.Vertices[static_cast<size_t>(i) * RowLength];
+            for (uint32_t j = 0; j < RowLength; ++j) {
+                const Vec3 Normal(RingScale * SectorDirections[j].x, RingScale * SectorDirections[j].y, Height);
+                Row[j] = {Normal * Radius, Normal, {static_cast<float>(j) / static_cast<float>(Sectors), V}};
+            }
+
+            if (i == Stacks) { continue; }
+            size_t Offset = i == 0 ? 0 : static_cast<size_t>(3) * Sectors + static_cast<size_t>(i - 1) * 6 * Sectors;
+            unsigned int K1 = i * RowLength;
+            unsigned int K2 = K1 + RowLength;
+            for (uint32_t j = 0; j < Sectors; ++j, ++K1, ++K2) {
+                if (i != 0) {
+                    Data.Indices[Offset++] = K1;
+                    Data.Indices[Offset++] = K2;
+                    Data.Indices[Offset++] = K1 + 1;
+                }
+                if (i != Stacks - 1) {
+                    Data.Indices[Offset++] = K1 + 1;
+                    Data.Indices[Offset++] = K2;
+                    Data.Indices[Offset++] = K2 + 1;
+                }
+            }
+        }
+    });
+    return Data;
+}
+
+MeshData GenerateIcosphere(float Radius, uint32_t Subdivisions) {
+    Subdivisions = std::min(Subdivisions, MaxIcosphereSubdivisions);
+    const uint32_t Scale = 1u << (2 * Subdivisions);
+    const uint32_t FinalVertexCount = 10 * Scale + 2;
+
+    const float T = (1.0f + std::sqrt(5.0f)) * 0.5f;
+    std::vector<Vec3> Points;
+    Points.reserve(FinalVertexCount);
+    for (const Vec3& P : {Vec3(-1, T, 0), Vec3(1, T, 0), Vec3(-1, -T, 0), Vec3(1, -T, 0), Vec3(0, -1, T), Vec3(0, 1, T),
+                          Vec3(0, -1, -T), Vec3(0, 1, -T), Vec3(T, 0, -1), Vec3(T, 0, 1), Vec3(-T, 0, -1), Vec3(-T, 0, 1)}) {
+        Points.push_back(normalize(P));
+    }
+    std::vector<unsigned int> Triangles = {0, 11, 5,  0, 5,  1, 0, 1, 7, 0, 7, 10, 0, 10, 11, 1, 5, 9, 5, 11, 4,
+                                           11, 10, 2, 10, 7, 6, 7, 1, 8, 3, 9, 4,  3, 4,  2,  3, 2, 6, 3, 6,  8,
+                                           3, 8,  9,  4, 9, 5, 2, 4, 11, 6, 2, 10, 8, 6, 7, 9, 8, 1};
+
+    std::vector<unsigned int> Next;
+    std::unordered_map<uint64_t, unsigned int> Midpoints;
+    for (uint32_t Level = 0; Level < Subdivisions; ++Level) {
+        Next.clear();
+        Next.reserve(Triangles.size() * 4);
+        Midpoints.clear();
+        // Every edge is shared by two triangles
+        Midpoints.reserve(Triangles.size() / 2);
+
+        const auto GetMidpoint = [&](unsigned int A, unsigned int B) {
+            const uint64_t Key = (static_cast<uint64_t>(std::min(A, B)) << 32) | std::max(A, B);
+            const auto [It, Inserted] = Midpoints.try_emplace(Key, static_cast<unsigned int>(Points.size()));
+            if (Inserted) { Points.push_back(normalize(Points[A] + Points[B])); }
+            return It->second;
+        };
+
+        for (size_t i = 0; i < Triangles.size(); i += 3) {
+            const unsigned int A = Triangles[i];
+            const unsigned int B = Triangles[i + 1];
+            const unsigned int C = Triangles[i + 2];
+            const unsigned int AB = GetMidpoint(A, B);
+            const unsigned int BC = GetMidpoint(B, C);
+            const unsigned int CA = GetMidpoint(C, A);
+            Next.insert(Next.end(), {A, AB, CA, B, BC, AB, C, CA, BC, AB, BC, CA});
+        }
+        Triangles.swap(Next);
+    }
+
+    MeshData Data;
+    Data.Vertices.reserve(FinalVertexCount);
+    for (const Vec3& Normal : Points) {
+        Data.Vertices.push_back({Normal * Radius, Normal, GetSphericalUV(Normal)});
+    }
+    Data.Indices = std::move(Triangles);
+    return Data;
+}
+
+MeshData GenerateCubeSphere(float Radius, uint32_t Segments, JobSystem* Jobs) {
+    MeshData Data;
+    if (Segments == 0) { return Data; }
+
+    struct Face {
+        Vec3 Normal;
+        Vec3 Right;
+        Vec3 Up;
+    };
+    // Right x Up = Normal, so quads wound right-then-up face outwards
+    static const Face Faces[] = {
+        {{1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, -1.0f}, {0.0f, 1.0f, 0.0f}},
+        {{-1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 1.0f, 0.0f}},
+        {{0.0f, 1.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, -1.0f}},
+        {{0.0f, -1.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f}},
+        {{0.0f, 0.0f, 1.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}},
+        {{0.0f, 0.0f, -1.0f}, {-1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}},
+    };
+    constexpr uint32_t FaceCount = 6;
+
+    const uint32_t RowLength = Segments + 1;
+    const size_t FaceVertexCount = static_cast<size_t>(RowLength) * RowLength;
+    const size_t FaceIndexCount = static_cast<size_t>(Segments) * Segments * 6;
+    Data.Vertices.resize(FaceVertexCount * FaceCount);
+    Data.Indices.resize(FaceIndexCount * FaceCount);
+
+    const float Step = 1.0f / static_cast<float>(Segments);
+    ParallelFor(GetJobsFor(Jobs, Data.Vertices.size()), FaceCount, 1, [&](uint32_t Begin, uint32_t End) {
+        for (uint32_t f = Begin; f < End; ++f) {
+            const Face& F = Faces[f];
+            const auto Base = static_cast<unsigned int>(FaceVertexCount * f);
+            Vertex* Out = &Data.Vertices[Base];
+            for (uint32_t y = 0; y < RowLength; ++y) {
+                const float V = static_cast<float>(y) * Step;
+                for (uint32_t x = 0; x < RowLength; ++x) {
+                    const float U = static_cast<float>(x) * Step;
+                    const Vec3 Normal = SpherifyCubePoint(F.Normal + F.Right * (U * 2.0f - 1.0f) + F.Up * (V * 2.0f - 1.0f));
+                    *Out++ = {Normal * Radius, Normal, {U, V}};
+                }
+            }
+
+            unsigned int* Indices = &Data.Indices[FaceIndexCount * f];
+            for (uint32_t y = 0; y < Segments; ++y) {
+                for (uint32_t x = 0; x < Segments; ++x) {
+                    const unsigned int A = Base + y * RowLength + x;
+                    const unsigned int B = A + 1;
+                    const unsigned int C = B + RowLength;
+                    const unsigned int D = A + RowLength;
+                    *Indices++ = A;
+                    *Indices++ = B;
+                    *Indices++ = C;
+                    *Indices++ = C;
+                    *Indices++ = D;
+                    *Indices++ = A;
+                }
+            }
+        }
+    });
+    return Data;
+}
+
+bool ProceduralMeshKey::operator==(const ProceduralMeshKey& Other) const {
+    return Shape == Other.Shape && Size == Other.Size && Detail[0] == Other.Detail[0] && Detail[1] == Other.Detail[1];
+}
+
+size_t ProceduralMeshKeyHash::operator()(const ProceduralMeshKey& Key) const {
+    ContentHasher Hasher;
+    Hasher.AddValue(Key.Shape);
+    Hasher.AddValue(Key.Size);
+    Hasher.AddValue(Key.Detail);
+    return static_cast<size_t>(Hasher.Get());
+}
+
+ResourceHandle<Mesh> ProceduralMeshCache::GetCube(float Size) {
+    return Get({ProceduralShape::Cube, Size, {0, 0}});
+}
+
+ResourceHandle<Mesh> ProceduralMeshCache::GetUVSphere(float Radius, uint32_t Sectors, uint32_t Stacks) {
+    return Get({ProceduralShape::UVSphere, Radius, {Sectors, Stacks}});
+}
+
+ResourceHandle<Mesh> ProceduralMeshCache::GetIcosphere(float Radius, uint32_t Subdivisions) {
+    return Get({ProceduralShape::Icosphere, Radius, {Subdivisions, 0}});
+}
+
+ResourceHandle<Mesh> ProceduralMeshCache::GetCubeSphere(float Radius, uint32_t Segments) {
+    return Get({ProceduralShape::CubeSphere, Radius, {Segments, 0}});
+}
+
+ResourceHandle<Mesh> ProceduralMeshCache::Get(const ProceduralMeshKey& Key) {
+    ResourceHandle<Mesh>& Entry = Entries[Key];
+    if (Resources.AddRef(Entry)) {
+        ++HitCount;
+        return Entry;
+    }
+    ++MissCount;
+    Entry = Resources.CreateMesh(Generate(Key));
+    return Entry;
+}
+
+void ProceduralMeshCache::Prune() {
+    std::erase_if(Entries, [this](const auto& Entry) { return !Resources.Get(Entry.second); });
+}
+
+MeshData ProceduralMeshCache::Generate(const ProceduralMeshKey& Key) const {
+    switch (Key.Shape) {
+    case ProceduralShape::Cube:
+        return GenerateCube(Key.Size);
+    case ProceduralShape::UVSphere:
+        return GenerateUVSphere(Key.Size, Key.Detail[0], Key.Detail[1], Jobs);
+    case ProceduralShape::Icosphere:
+        return GenerateIcosphere(Key.Size, Key.Detail[0]);
+    case ProceduralShape::CubeSphere:
+        return GenerateCubeSphere(Key.Size, Key.Detail[0], Jobs);
+    }
+    return {};
+}
+
+} // namespace Volante
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "ResourcePool.h"
+#include "Vertex.h"
+
+namespace Volante {
+
+class JobSystem;
+class Mesh;
+class ResourceManager;
+
+// CPU-side geometry, moved into a Mesh (or GPUScene) once generated.
+struct MeshData {
+    std::vector<Vertex> Vertices;
+    std::vector<unsigned int> Indices;
+};
+
+// Generators size their outputs exactly up front and evaluate trigonometry once per row and
+// column rather than per vertex. Given a JobSystem, large meshes are filled in parallel (rows,
+// or cube faces); the output does not depend on whether they were.
+
+// 24 vertices, so every face has its own normals and UVs.
+MeshData GenerateCube(float Size = 1.0f);
+
+// Latitude/longitude sphere around the Z axis.
+// Triangles crowd at the poles, so prefer the icosphere or cube sphere for round silhouettes.
+MeshData GenerateUVSphere(float Radius = 1.0f, uint32_t Sectors = 36, uint32_t Stacks = 18, JobSystem* Jobs = nullptr);
+
+// Subdivided icosahedron: 10 * 4^n + 2 vertices of near-equal spacing. UVs are a spherical
+// projection and stretch along the seam, which vertices are not split across.
+MeshData GenerateIcosphere(float Radius = 1.0f, uint32_t Subdivisions = 3);
+
+// Six Segments x Segments grids pushed onto the sphere with the area-preserving cube mapping;
+// an even distribution that, unlike the icosphere, tiles UVs per face.
+MeshData GenerateCubeSphere(float Radius = 1.0f, uint32_t Segments = 16, JobSystem* Jobs = nullptr);
+
+enum class ProceduralShape : uint32_t { Cube, UVSphere, Icosphere, CubeSphere };
+
+// Everything a generator's output depends on.
+struct ProceduralMeshKey {
+    ProceduralShape Shape = ProceduralShape::Cube;
+    float Size = 1.0f;
+    uint32_t Detail[2] = {};
+
+    bool operator==(const ProceduralMeshKey& Other) const;
+};
+
+struct ProceduralMeshKeyHash {
+    size_t operator()(const ProceduralMeshKey& Key) const;
+};
+
+// Hands out one shared GPU mesh per distinct set of generator parameters, so a thousand unit
+// spheres cost one VAO. Meshes live in Resources, and each Get returns one reference to give
+// back with ResourceManager::Release. Entries are weak; a mesh is freed once its last user lets
+// go, and regenerated on the next request. Main (GL) thread only.
+class ProceduralMeshCache {
+public:
+    explicit ProceduralMeshCache(ResourceManager& Resources, JobSystem* Jobs = nullptr) : Resources(Resources), Jobs(Jobs) {}
+
+    ResourceHandle<Mesh> GetCube(float Size = 1.0f);
+    ResourceHandle<Mesh> GetUVSphere(float Radius = 1.0f, uint32_t Sectors = 36, uint32_t Stacks = 18);
+    ResourceHandle<Mesh> GetIcosphere(float Radius = 1.0f, uint32_t Subdivisions = 3);
+    ResourceHandle<Mesh> GetCubeSphere(float Radius = 1.0f, uint32_t Segments = 16);
+
+    ResourceHandle<Mesh> Get(const ProceduralMeshKey& Key);
+
+    // Drops entries whose mesh has been freed.
+    void Prune();
+
+    [[nodiscard]] uint32_t GetHitCount() const { return HitCount; }
+
+    [[nodiscard]] uint32_t GetMissCount() const { return MissCount; }
+
+private:
+    MeshData Generate(const ProceduralMeshKey& Key) const;
+
+    ResourceManager& Resources;
+    JobSystem* Jobs;
+    // Holds no reference; a stale handle means the mesh was freed
+    std::unordered_map<ProceduralMeshKey, ResourceHandle<Mesh>, ProceduralMeshKeyHash> Entries;
+    uint32_t HitCount = 0;
+    uint32_t MissCount = 0;
+};
+
+} // namespace Volante
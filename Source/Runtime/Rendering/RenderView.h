@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Runtime/Core/Math/Bounds.h"
+
+namespace Volante {
+
+// Everything culling and LOD selection need to know about a camera for one frame.
+//
+// View, ViewProjection, Position and the frustum are in world space, for culling and LOD.
+// Drawing goes through the Relative matrices instead, which take positions relative to Origin:
+// shaders subtract Origin from world positions first, so the large camera translation never
+// enters a float matrix and geometry far from the world origin does not jitter as the camera
+// moves. Views made with Create have their origin at zero.
+struct RenderView {
+    Mat4 View = Mat4(1.0f);
+    Mat4 Projection = Mat4(1.0f);
+    Mat4 ViewProjection = Mat4(1.0f);
+    Vec3 Position = Vec3(0.0f);
+    Frustum ViewFrustum;
+
+    Vec3 Origin = Vec3(0.0f);
+    Mat4 RelativeView = Mat4(1.0f);
+    Mat4 RelativeViewProjection = Mat4(1.0f);
+
+    // Multiplies camera distance before LOD selection; above 1 switches to coarser LODs sooner.
+    float LODScale = 1.0f;
+
+    static RenderView Create(const Mat4& View, const Mat4& Projection, float LODScale = 1.0f) {
+        return CreateRelative(View, Projection, Vec3(0.0f), LODScale);
+    }
+
+    // RelativeView transforms positions relative to Origin, e.g. a camera's rotation and the
+    // part of its position a float Origin could not hold.
+    static RenderView CreateRelative(const Mat4& RelativeView, const Mat4& Projection, const Vec3& Origin,
+                                     float LODScale = 1.0f) {
+        RenderView Result;
+        Result.Origin = Origin;
+        Result.RelativeView = RelativeView;
+        Result.RelativeViewProjection = Projection * RelativeView;
+        Result.View = glm::translate(RelativeView, -Origin);
+        Result.Projection = Projection;
+        Result.ViewProjection = Projection * Result.View;
+        Result.Position = Origin + Vec3(glm::inverse(RelativeView)[3]);
+        Result.ViewFrustum = Frustum::FromMatrix(Result.ViewProjection);
+        Result.LODScale = LODScale;
+        return Result;
+    }
+};
+
+} // namespace Volante
@@ -0,0 +1,138 @@
+#include "ResourceManager.h"
+
+#include <glad/glad.h>
+
+#include <cstring>
+
+#include "Runtime/Core/Misc/Utility.h"
+
+namespace Volante {
+
+GPUBuffer::GPUBuffer(const void* Data, size_t Size, bool Dynamic) : Size(Size) {
+    glGenBuffers(1, &Id);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, Id);
+    glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(Size), Data, Dynamic ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+GPUBuffer::~GPUBuffer() {
+    glDeleteBuffers(1, &Id);
+}
+
+ResourceManager::~ResourceManager() {
+    Shutdown();
+}
+
+void ResourceManager::Shutdown() {
+    if (!FramesInFlight.empty()) { glFinish(); }
+    for (const FrameFence& Frame : FramesInFlight) {
+        glDeleteSync(static_cast<GLsync>(Frame.Fence));
+    }
+    FramesInFlight.clear();
+    Meshes.Clear();
+    Shaders.Clear();
+    Buffers.Clear();
+    ShaderSources.clear();
+    BufferContents.clear();
+}
+
+void ResourceManager::BeginFrame() {
+    Collect();
+}
+
+void ResourceManager::EndFrame() {
+    FramesInFlight.push_back({glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0), FrameIndex});
+    ++FrameIndex;
+}
+
+void ResourceManager::Collect() {
+    // Fences signal in submission order, so stop at the first that has not
+    while (!FramesInFlight.empty()) {
+        const auto Sync = static_cast<GLsync>(FramesInFlight.front().Fence);
+        if (glClientWaitSync(Sync, 0, 0) == GL_TIMEOUT_EXPIRED) { break; }
+        glDeleteSync(Sync);
+        FramesInFlight.pop_front();
+    }
+    // Anything released in a frame older than the oldest one still in flight is unreferenced
+    const uint64_t FirstBusyFrame = FramesInFlight.empty() ? FrameIndex : FramesInFlight.front().Frame;
+    Meshes.Collect(FirstBusyFrame);
+    Shaders.Collect(FirstBusyFrame);
+    Buffers.Collect(FirstBusyFrame);
+}
+
+MeshHandle ResourceManager::CreateMesh(MeshData Data) {
+    ContentHasher Hasher;
+    Hasher.Add(Data.Vertices.data(), Data.Vertices.size() * sizeof(Vertex));
+    Hasher.Add(Data.Indices.data(), Data.Indices.size() * sizeof(unsigned int));
+    const uint64_t Hash = Hasher.Get();
+
+    if (const MeshHandle Existing = Meshes.FindByHash(Hash)) {
+        const Mesh* Candidate = Meshes.Get(Existing);
+        // The CPU copy Mesh keeps makes an exact check cheap next to an upload
+        if (Candidate->indices == Data.Indices && Candidate->vertices.size() == Data.Vertices.size() &&
+            std::memcmp(Candidate->vertices.data(), Data.Vertices.data(), Data.Vertices.size() * sizeof(Vertex)) == 0) {
+            Meshes.AddRef(Existing);
+            ++DeduplicatedCount;
+            return Existing;
+        }
+    }
+    return Meshes.Add(std::make_unique<Mesh>(std::move(Data)), Hash);
+}
+
+ShaderHandle ResourceManager::CreateShader(const std::string& VertexSource, const std::string& FragmentSource) {
+    ContentHasher Hasher;
+    Hasher.Add(VertexSource.data(), VertexSource.size());
+    Hasher.Add(FragmentSource.data(), FragmentSource.size());
+    const uint64_t Hash = Hasher.Get();
+
+    if (const ShaderHandle Existing = Shaders.FindByHash(Hash)) {
+        const auto& [Vertex, Fragment] = ShaderSources[Existing.Index];
+        if (Vertex == VertexSource && Fragment == FragmentSource) {
+            Shaders.AddRef(Existing);
+            ++DeduplicatedCount;
+            return Existing;
+        }
+    }
+    const ShaderHandle Created = Shaders.Add(std::make_unique<Shader>(VertexSource.c_str(), FragmentSource.c_str()), Hash);
+    if (ShaderSources.size() <= Created.Index) { ShaderSources.resize(Created.Index + 1); }
+    ShaderSources[Created.Index] = {VertexSource, FragmentSource};
+    return Created;
+}
+
+BufferHandle ResourceManager::CreateBuffer(const void* Data, size_t Size) {
+    ContentHasher Hasher;
+    Hasher.Add(Data, Size);
+    const uint64_t Hash = Hasher.Get();
+
+    const auto* Bytes = static_cast<const uint8_t*>(Data);
+    if (const BufferHandle Existing = Buffers.FindByHash(Hash)) {
+        const std::vector<uint8_t>& Contents = BufferContents[Existing.Index];
+        if (Contents.size() == Size && (Size == 0 || std::memcmp(Contents.data(), Bytes, Size) == 0)) {
+            Buffers.AddRef(Existing);
+            ++DeduplicatedCount;
+            return Existing;
+        }
+    }
+    const BufferHandle Created = Buffers.Add(std::make_unique<GPUBuffer>(Data, Size), Hash);
+    if (BufferContents.size() <= Created.Index) { BufferContents.resize(Created.Index + 1); }
+    BufferContents[Created.Index].assign(Bytes, Bytes + Size);
+    return Created;
+}
+
+BufferHandle ResourceManager::CreateDynamicBuffer(size_t Size) {
+    const BufferHandle Created = Buffers.AddUnshared(std::make_unique<GPUBuffer>(nullptr, Size, true));
+    if (BufferContents.size() <= Created.Index) { BufferContents.resize(Created.Index + 1); }
+    return Created;
+}
+
+ResourceStats ResourceManager::GetStats() const {
+    ResourceStats Stats;
+    Stats.MeshCount = Meshes.GetLiveCount();
+    Stats.ShaderCount = Shaders.GetLiveCount();
+    Stats.BufferCount = Buffers.GetLiveCount();
+    Stats.PendingDestroyCount = Meshes.GetPendingCount() + Shaders.GetPendingCount() + Buffers.GetPendingCount();
+    Stats.DeduplicatedCount = DeduplicatedCount;
+    return Stats;
+}
+
+} // namespace Volante
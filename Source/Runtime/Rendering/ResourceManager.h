@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Mesh.h"
+#include "ProceduralMesh.h"
+#include "ResourcePool.h"
+#include "Shader.h"
+
+namespace Volante {
+
+// GL buffer of a fixed size. A shared one keeps the contents it was created with; a dynamic
+// one belongs to its creator, who rewrites it with glBufferSubData.
+class GPUBuffer {
+public:
+    GPUBuffer(const void* Data, size_t Size, bool Dynamic = false);
+    ~GPUBuffer();
+
+    GPUBuffer(const GPUBuffer&) = delete;
+    GPUBuffer& operator=(const GPUBuffer&) = delete;
+
+    [[nodiscard]] unsigned int GetId() const { return Id; }
+
+    [[nodiscard]] size_t GetSize() const { return Size; }
+
+private:
+    unsigned int Id = 0;
+    size_t Size = 0;
+};
+
+using MeshHandle = ResourceHandle<Mesh>;
+using ShaderHandle = ResourceHandle<Shader>;
+using BufferHandle = ResourceHandle<GPUBuffer>;
+
+struct ResourceStats {
+    uint32_t MeshCount = 0;
+    uint32_t ShaderCount = 0;
+    uint32_t BufferCount = 0;
+    // Released but possibly still read by frames in flight
+    uint32_t PendingDestroyCount = 0;
+    // Create calls answered with an existing resource
+    uint64_t DeduplicatedCount = 0;
+};
+
+// Owns shared GPU meshes, shaders and buffers behind generational handles. Creating a resource
+// whose contents match a live one returns that one with another reference, so a thousand
+// entities spawning the same rock cost one VAO. Matches are found by hash and confirmed
+// against the contents, which are kept for that (meshes keep theirs anyway). The last Release
+// frees the handle immediately but keeps the GL objects until the fence of every frame that
+// could still draw with them has signalled.
+//
+// BeginFrame/EndFrame bracket each rendered frame (Renderer drives them). Render thread only.
+class ResourceManager {
+public:
+    ResourceManager() = default;
+    ~ResourceManager();
+
+    ResourceManager(const ResourceManager&) = delete;
+    ResourceManager& operator=(const ResourceManager&) = delete;
+
+    // Waits for the GPU and destroys everything; outstanding handles go stale.
+    void Shutdown();
+
+    // Destroys released resources the GPU has finished with.
+    void BeginFrame();
+    // Fences the frame's commands.
+    void EndFrame();
+
+    // Each Create returns one reference, to be given back with Release.
+    MeshHandle CreateMesh(MeshData Data);
+    ShaderHandle CreateShader(const std::string& VertexSource, const std::string& FragmentSource);
+    BufferHandle CreateBuffer(const void* Data, size_t Size);
+    // Never shared, uninitialized, for the caller to fill and refill. To grow it, create a
+    // larger one and release this: frames in flight keep reading the old one until they finish.
+    BufferHandle CreateDynamicBuffer(size_t Size);
+
+    template <typename T>
+    bool AddRef(ResourceHandle<T> Handle) {
+        return GetPool<T>().AddRef(Handle);
+    }
+
+    template <typename T>
+    void Release(ResourceHandle<T> Handle) {
+        if (!GetPool<T>().Release(Handle, FrameIndex)) { return; }
+        if constexpr (std::is_same_v<T, Shader>) {
+            ShaderSources[Handle.Index] = {};
+        } else if constexpr (std::is_same_v<T, GPUBuffer>) {
+            BufferContents[Handle.Index] = {};
+        }
+    }
+
+    // Null once the handle is stale.
+    template <typename T>
+    [[nodiscard]] T* Get(ResourceHandle<T> Handle) const {
+        return const_cast<ResourceManager*>(this)->GetPool<T>().Get(Handle);
+    }
+
+    template <typename T>
+    [[nodiscard]] uint32_t GetRefCount(ResourceHandle<T> Handle) const {
+        return const_cast<ResourceManager*>(this)->GetPool<T>().GetRefCount(Handle);
+    }
+
+    [[nodiscard]] ResourceStats GetStats() const;
+
+private:
+    template <typename T>
+    ResourcePool<T>& GetPool() {
+        if constexpr (std::is_same_v<T, Mesh>) {
+            return Meshes;
+        } else if constexpr (std::is_same_v<T, Shader>) {
+            return Shaders;
+        } else {
+            static_assert(std::is_same_v<T, GPUBuffer>, "Not a managed resource type");
+            return Buffers;
+        }
+    }
+
+    void Collect();
+
+    struct FrameFence {
+        void* Fence = nullptr;
+        uint64_t Frame = 0;
+    };
+
+    ResourcePool<Mesh> Meshes;
+    ResourcePool<Shader> Shaders;
+    ResourcePool<GPUBuffer> Buffers;
+    // By handle index, what a live shader or shared buffer was created from
+    std::vector<std::pair<std::string, std::string>> ShaderSources;
+    std::vector<std::vector<uint8_t>> BufferContents;
+
+    // Frames submitted whose fence has not been seen to signal, oldest first
+    std::deque<FrameFence> FramesInFlight;
+    uint64_t FrameIndex = 0;
+    uint64_t DeduplicatedCount = 0;
+};
+
+} // namespace Volante
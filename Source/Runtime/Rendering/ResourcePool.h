@@ -0,0 +1,152 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace Volante {
+
+// Index plus the generation of the slot it was issued from. A handle to a resource that has
+// since been destroyed (and its slot reused) fails the generation check rather than aliasing
+// the new occupant. Typed by the resource so mesh and shader handles cannot be mixed up.
+template <typename T>
+struct ResourceHandle {
+    static constexpr uint32_t InvalidIndex = ~0u;
+
+    uint32_t Index = InvalidIndex;
+    uint32_t Generation = 0;
+
+    [[nodiscard]] bool IsValid() const { return Index != InvalidIndex; }
+
+    explicit operator bool() const { return IsValid(); }
+
+    bool operator==(const ResourceHandle&) const = default;
+};
+
+// Reference-counted slots for one resource type. Dropping the last reference frees the slot
+// at once, so the handle goes stale, but parks the object itself until Collect is told the
+// frame it was released in has finished on the GPU.
+template <typename T>
+class ResourcePool {
+public:
+    ResourceHandle<T> Add(std::unique_ptr<T> Resource, uint64_t Hash) {
+        const uint32_t Index = Insert(std::move(Resource), Hash);
+        // First come first served; a later object with a colliding hash is simply not shared
+        HashToSlot.try_emplace(Hash, Index);
+        return {Index, Slots[Index].Generation};
+    }
+
+    // For a resource its owner goes on changing: FindByHash never returns it.
+    ResourceHandle<T> AddUnshared(std::unique_ptr<T> Resource) {
+        const uint32_t Index = Insert(std::move(Resource), 0);
+        return {Index, Slots[Index].Generation};
+    }
+
+    [[nodiscard]] T* Get(ResourceHandle<T> Handle) const {
+        const Slot* S = Find(Handle);
+        return S ? S->Resource.get() : nullptr;
+    }
+
+    // Live resource registered under Hash, if any; the caller confirms the contents match.
+    [[nodiscard]] ResourceHandle<T> FindByHash(uint64_t Hash) const {
+        const auto It = HashToSlot.find(Hash);
+        if (It == HashToSlot.end()) { return {}; }
+        return {It->second, Slots[It->second].Generation};
+    }
+
+    bool AddRef(ResourceHandle<T> Handle) {
+        Slot* S = Find(Handle);
+        if (!S) { return false; }
+        ++S->RefCount;
+        return true;
+    }
+
+    // Returns true when this dropped the last reference.
+    bool Release(ResourceHandle<T> Handle, uint64_t Frame) {
+        Slot* S = Find(Handle);
+        if (!S || --S->RefCount > 0) { return false; }
+
+        const auto It = HashToSlot.find(S->Hash);
+        if (It != HashToSlot.end() && It->second == Handle.Index) { HashToSlot.erase(It); }
+        Pending.push_back({std::move(S->Resource), Frame});
+        ++S->Generation;
+        FreeSlots.push_back(Handle.Index);
+        --LiveCount;
+        return true;
+    }
+
+    [[nodiscard]] uint32_t GetRefCount(ResourceHandle<T> Handle) const {
+        const Slot* S = Find(Handle);
+        return S ? S->RefCount : 0;
+    }
+
+    // Destroys parked objects released before FirstBusyFrame.
+    void Collect(uint64_t FirstBusyFrame) {
+        std::erase_if(Pending, [FirstBusyFrame](const PendingResource& P) { return P.Frame < FirstBusyFrame; });
+    }
+
+    // Destroys everything, live or parked. Outstanding handles go stale.
+    void Clear() {
+        Pending.clear();
+        for (uint32_t i = 0; i < Slots.size(); ++i) {
+            if (!Slots[i].Resource) { continue; }
+            Slots[i].Resource.reset();
+            ++Slots[i].Generation;
+            Slots[i].RefCount = 0;
+            FreeSlots.push_back(i);
+        }
+        HashToSlot.clear();
+        LiveCount = 0;
+    }
+
+    [[nodiscard]] uint32_t GetLiveCount() const { return LiveCount; }
+
+    [[nodiscard]] uint32_t GetPendingCount() const { return static_cast<uint32_t>(Pending.size()); }
+
+private:
+    struct Slot {
+        std::unique_ptr<T> Resource;
+        uint64_t Hash = 0;
+        uint32_t Generation = 0;
+        uint32_t RefCount = 0;
+    };
+
+    struct PendingResource {
+        std::unique_ptr<T> Resource;
+        uint64_t Frame = 0;
+    };
+
+    uint32_t Insert(std::unique_ptr<T> Resource, uint64_t Hash) {
+        uint32_t Index;
+        if (!FreeSlots.empty()) {
+            Index = FreeSlots.back();
+            FreeSlots.pop_back();
+        } else {
+            Index = static_cast<uint32_t>(Slots.size());
+            Slots.emplace_back();
+        }
+        Slot& S = Slots[Index];
+        S.Resource = std::move(Resource);
+        S.Hash = Hash;
+        S.RefCount = 1;
+        ++LiveCount;
+        return Index;
+    }
+
+    [[nodiscard]] const Slot* Find(ResourceHandle<T> Handle) const {
+        if (Handle.Index >= Slots.size()) { return nullptr; }
+        const Slot& S = Slots[Handle.Index];
+        return S.Resource && S.Generation == Handle.Generation ? &S : nullptr;
+    }
+
+    Slot* Find(ResourceHandle<T> Handle) { return const_cast<Slot*>(static_cast<const ResourcePool*>(this)->Find(Handle)); }
+
+    std::vector<Slot> Slots;
+    std::vector<uint32_t> FreeSlots;
+    std::unordered_map<uint64_t, uint32_t> HashToSlot;
+    std::vector<PendingResource> Pending;
+    uint32_t LiveCount = 0;
+};
+
+} // namespace Volante
@@ -0,0 +1,788 @@
+#include "SceneRenderer.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <map>
+#include <string>
+
+#include "CascadedShadows.h"
+#include "ClusteredLighting.h"
+#include "GPUCulling.h"
+#include "GPUTimers.h"
+#include "HiZBuffer.h"
+#include "MaterialSystem.h"
+#include "ResourceManager.h"
+#include "ShaderLibrary.h"
+#include "Runtime/Core/Async/JobSystem.h"
+#include "Runtime/Core/Stats/StatCounters.h"
+#include "Runtime/Spatial/SpatialIndex.h"
+#include "Shader.h"
+#include "SoftwareOcclusion.h"
+#include "TextureStreamer.h"
+#include "UploadRing.h"
+
+namespace Volante {
+
+namespace {
+
+// Match the layout locations in Shaders/Scene.vert
+constexpr GLuint PositionLocation = 0;
+constexpr GLuint NormalLocation = 1;
+constexpr GLuint InstanceIdLocation = 2;
+constexpr GLuint ModelLocation = 3;
+// After the four model matrix columns
+constexpr GLuint TexCoordLocation = 7;
+constexpr GLuint MaterialLocation = 8;
+
+// Texture units of the light buffers (three) and the shadow map; unit 0 is left for material
+// textures.
+constexpr int LightingTextureUnit = 1;
+constexpr int ShadowTextureUnit = 4;
+constexpr int MaterialTextureUnit = 0;
+
+// Past the bindings the culling kernels use
+constexpr uint32_t MaterialBlockBinding = 10;
+constexpr uint32_t ViewBlockBinding = 11;
+
+// Matches ViewBlock in the vertex stages
+struct ViewBlockData {
+    Mat4 ViewProjection;
+    Mat4 View;
+    Vec4 Origin;
+};
+
+constexpr uint32_t NotDrawn = ~0u;
+constexpr uint32_t CulledByFrustum = ~0u - 1;
+constexpr uint32_t CulledByOcclusion = ~0u - 2;
+
+// Same tests and LOD rule as the cull kernel. Returns the bucket index or one of the sentinels.
+uint32_t SelectBucket(const GPUInstance& Instance, const std::vector<GPUMeshInfo>& Meshes, const RenderView& View,
+                      const SoftwareOcclusion* Occlusion) {
+    if ((Instance.Flags & InstanceAlive) == 0) { return NotDrawn; }
+
+    const Vec3 Center(Instance.BoundsCenter);
+    const AABB Bounds = AABB::FromCenterExtent(Center, Vec3(Instance.BoundsExtent));
+    if (!View.ViewFrustum.Intersects(Bounds)) { return CulledByFrustum; }
+
+    const GPUMeshInfo& Mesh = Meshes[Instance.MeshIndex];
+    const float ViewDistance = distance(Center, View.Position) * View.LODScale;
+    uint32_t Lod = 0;
+    while (Lod < Mesh.LODCount && ViewDistance > Mesh.LODDistances[Lod]) {
+        ++Lod;
+    }
+    if (Lod == Mesh.LODCount) { return CulledByFrustum; }
+    if (Occlusion && Occlusion->IsOccluded(Bounds)) { return CulledByOcclusion; }
+    return Mesh.FirstBucket + Lod;
+}
+
+// The CPU path's instance stream holds Count transforms followed by Count material indices,
+// starting at Offset in the bound array buffer.
+void SetInstanceAttributes(size_t Offset, size_t FirstInstance, size_t Count) {
+    for (GLuint Column = 0; Column < 4; ++Column) {
+        glVertexAttribPointer(ModelLocation + Column, 4, GL_FLOAT, GL_FALSE, sizeof(Mat4),
+                              reinterpret_cast<void*>(Offset + FirstInstance * sizeof(Mat4) + Column * sizeof(Vec4)));
+    }
+    glVertexAttribIPointer(MaterialLocation, 1, GL_UNSIGNED_INT, sizeof(uint32_t),
+                           reinterpret_cast<void*>(Offset + Count * sizeof(Mat4) + FirstInstance * sizeof(uint32_t)));
+}
+
+void SetViewBlockBinding(const Shader& Program) {
+    const GLuint Index = glGetUniformBlockIndex(Program.id, "ViewBlock");
+    if (Index != GL_INVALID_INDEX) { glUniformBlockBinding(Program.id, Index, ViewBlockBinding); }
+}
+
+} // namespace
+
+SceneRenderer::SceneRenderer(const SceneRendererDesc& Desc, JobSystem* Jobs, UploadRing* Uploads, ResourceManager* Resources,
+                             ShaderLibrary* Shaders)
+    : Desc(Desc), Jobs(Jobs), Uploads(Uploads), Resources(Resources), Shaders(Shaders),
+      Lighting(std::make_unique<ClusteredLighting>(Desc.Lighting)),
+      Textures(std::make_unique<TextureStreamer>(Desc.Textures, Jobs)), Timers(std::make_unique<GPUTimers>()) {
+    Views.resize(1);
+    Views[MainSceneView].Active = true;
+}
+
+SceneRenderer::~SceneRenderer() = default;
+
+void SceneRenderer::Initialize() {
+    if (!Uploads) {
+        OwnedUploads = std::make_unique<UploadRing>();
+        OwnedUploads->Initialize();
+        Uploads = OwnedUploads.get();
+    }
+    if (!Resources) {
+        OwnedResources = std::make_unique<ResourceManager>();
+        Resources = OwnedResources.get();
+    }
+    if (!Shaders) {
+        OwnedShaders = std::make_unique<ShaderLibrary>(Jobs);
+        OwnedShaders->Initialize();
+        Shaders = OwnedShaders.get();
+    }
+    if (Desc.AllowGPUCulling) {
+        GPUCulling = std::make_unique<class GPUCulling>(*Shaders);
+        if (!GPUCulling->Initialize()) { GPUCulling.reset(); }
+    }
+
+    Lighting->Initialize();
+    Textures->Initialize();
+    Visibility = std::make_unique<SpatialIndex>(SpatialIndexDesc{}, Jobs);
+    Scene.SetSpatialIndex(Visibility.get());
+
+    // Storage blocks and bindless handles need GLSL 4.x, which only the GPU path's context has
+    MaterialLayout Layout;
+    Layout.Add("BaseColor", MaterialParameterType::Vec4, Vec4(1.0f)).Add("BaseColorTexture", MaterialParameterType::Texture);
+    Materials = std::make_unique<MaterialSystem>(*Resources, Layout, GPUCulling ? MaterialPacking::Std430 : MaterialPacking::Std140,
+                                                 MaterialBlockBinding);
+    Materials->Initialize(GPUCulling && Textures->IsBindless());
+    Materials->Create();
+
+    // The vertex stage fetches instances from the culling kernels' buffer on the GPU path and
+    // reads them from per-instance attributes on the CPU path
+    const std::string Version = GPUCulling ? "#version 430 core\n" : "#version 330 core\n";
+    const std::vector<std::string> Defines = GPUCulling ? std::vector<std::string>{"GPU_DRIVEN"} : std::vector<std::string>{};
+    const std::string& Directory = ShaderLibrary::GetShaderDirectory();
+    DrawShader.Id = Shaders->Load({Directory + "/Scene.vert", Directory + "/Scene.frag", Defines, Version,
+                                   Version + Materials->GetShaderExtensions() + Materials->GetShaderSource()});
+    if (Desc.CastShadows) {
+        Shadows = std::make_unique<CascadedShadows>(Desc.Shadows);
+        if (Shadows->Initialize()) {
+            ShadowDepthShader.Id = Shaders->Load({Directory + "/Scene.vert", Directory + "/Depth.frag", Defines, Version});
+        } else {
+            Shadows.reset();
+        }
+    }
+    if (Desc.OcclusionCulling && GPUCulling) {
+        HiZBuffer = std::make_unique<class HiZBuffer>(*Shaders);
+        if (HiZBuffer->Initialize(Desc.HiZWidth, Desc.HiZHeight)) {
+            OcclusionDepthShader.Id =
+                Shaders->Load({Directory + "/Scene.vert", Directory + "/OcclusionDepth.frag", Defines, Version});
+        } else {
+            HiZBuffer.reset();
+        }
+    } else if (Desc.OcclusionCulling) {
+        SoftwareOcclusion = std::make_unique<class SoftwareOcclusion>(Desc.SoftwareOcclusionWidth, Desc.SoftwareOcclusionHeight);
+    }
+    glGenVertexArrays(1, &VertexArray);
+    Timers->Initialize();
+#if VOLANTE_DEBUG_DRAW
+    DebugRenderer = std::make_unique<DebugDrawRenderer>(*Shaders);
+    DebugRenderer->Initialize();
+#endif
+}
+
+void SceneRenderer::Shutdown() {
+    if (GPUCulling) {
+        GPUCulling->Shutdown();
+        GPUCulling.reset();
+    }
+    for (ShaderProgramHandle* Program : {&DrawShader, &ShadowDepthShader, &OcclusionDepthShader}) {
+        Shaders->Unload(Program->Id);
+        *Program = {};
+    }
+    Lighting->Shutdown();
+    Materials.reset();
+    Textures->Shutdown();
+    Shadows.reset();
+    if (HiZBuffer) { HiZBuffer->Shutdown(); }
+    HiZBuffer.reset();
+    SoftwareOcclusion.reset();
+    Timers->Shutdown();
+#if VOLANTE_DEBUG_DRAW
+    DebugRenderer.reset();
+#endif
+    if (VertexArray != 0) { glDeleteVertexArrays(1, &VertexArray); }
+    VertexArray = 0;
+    VertexArrayKey = ~0ull;
+    Scene.SetSpatialIndex(nullptr);
+    Visibility.reset();
+    Scene.Release();
+    if (OwnedUploads) {
+        OwnedUploads->Shutdown();
+        OwnedUploads.reset();
+        Uploads = nullptr;
+    }
+    if (OwnedResources) {
+        OwnedResources->Shutdown();
+        OwnedResources.reset();
+        Resources = nullptr;
+    }
+    if (OwnedShaders) {
+        OwnedShaders->Shutdown();
+        OwnedShaders.reset();
+        Shaders = nullptr;
+    }
+}
+
+void SceneRenderer::Update(float DeltaTime) {
+    // Instances are edited directly through GetScene(); uploads happen in Render
+}
+
+void SceneRenderer::SetView(const Mat4& InView, const Mat4& Projection) {
+    Views[MainSceneView].View = RenderView::Create(InView, Projection, Desc.LODScale);
+}
+
+void SceneRenderer::SetView(SceneViewId Id, const RenderView& InView) {
+    if (Id >= Views.size() || !Views[Id].Active) { return; }
+    Views[Id].View = InView;
+    Views[Id].View.LODScale *= Desc.LODScale;
+}
+
+SceneViewId SceneRenderer::AddView(const Vec4& Viewport) {
+    SceneViewId Id = 1;
+    while (Id < Views.size() && Views[Id].Active) {
+        ++Id;
+    }
+    if (Id == Views.size()) { Views.emplace_back(); }
+    Views[Id] = {Views[MainSceneView].View, Viewport, true};
+    return Id;
+}
+
+void SceneRenderer::RemoveView(SceneViewId Id) {
+    if (Id == MainSceneView || Id >= Views.size()) { return; }
+    Views[Id].Active = false;
+}
+
+void SceneRenderer::SetViewport(SceneViewId Id, const Vec4& Viewport) {
+    if (Id < Views.size()) { Views[Id].Viewport = Viewport; }
+}
+
+void SceneRenderer::BindViewport(SceneViewId Id) const {
+    const Vec4& Rect = Views[Id].Viewport;
+    const auto Width = static_cast<float>(FrameViewport[2]);
+    const auto Height = static_cast<float>(FrameViewport[3]);
+    const auto X = static_cast<GLint>(Rect.x * Width);
+    const auto Y = static_cast<GLint>(Rect.y * Height);
+    glViewport(FrameViewport[0] + X, FrameViewport[1] + Y, static_cast<GLint>((Rect.x + Rect.z) * Width) - X,
+               static_cast<GLint>((Rect.y + Rect.w) * Height) - Y);
+}
+
+void SceneRenderer::ForEachView(const std::function<void(const RenderView&)>& Body) const {
+    for (SceneViewId Id = 0; Id < Views.size(); ++Id) {
+        if (!Views[Id].Active) { continue; }
+        BindViewport(Id);
+        Body(Views[Id].View);
+    }
+    glViewport(FrameViewport[0], FrameViewport[1], FrameViewport[2], FrameViewport[3]);
+}
+
+uint32_t SceneRenderer::GetViewCount() const {
+    return static_cast<uint32_t>(std::ranges::count_if(Views, [](const SceneView& View) { return View.Active; }));
+}
+
+void SceneRenderer::GetViews(std::vector<RenderView>& Out) const {
+    Out.clear();
+    for (const SceneView& Target : Views) {
+        if (Target.Active) { Out.push_back(Target.View); }
+    }
+}
+
+void SceneRenderer::InvalidateOcclusion() {
+    if (HiZBuffer) { HiZBuffer->Invalidate(); }
+}
+
+void SceneRenderer::Render() {
+    StatScope Scope(StatTimer::Render);
+    Timers->BeginFrame();
+    Timers->Begin(StatTimer::Render);
+
+    // Usage reported during the previous frame decides what streams in now
+    Textures->Update();
+    StatCounters::Add(StatCounter::UploadBytes, static_cast<int64_t>(Textures->GetStats().UploadedBytes));
+    if (OwnedUploads) { OwnedUploads->BeginFrame(); }
+    if (OwnedResources) { OwnedResources->BeginFrame(); }
+    if (OwnedShaders) { OwnedShaders->Update(0.0f); }
+    glGetIntegerv(GL_VIEWPORT, FrameViewport);
+
+    Stats = {};
+    Stats.InstanceCount = Scene.GetLiveInstanceCount();
+    Stats.GPUDriven = IsGPUDriven();
+    for (const SceneView& Target : Views) {
+        Stats.ViewCount += Target.Active ? 1 : 0;
+    }
+    if (Scene.GetInstanceCount() > 0 && Scene.GetBucketCount() > 0 && RefreshPrograms()) { RenderScene(); }
+    uint32_t DrawCount = Stats.DrawCount + Stats.ShadowDrawCount;
+#if VOLANTE_DEBUG_DRAW
+    if (DebugRenderer) {
+        StatScope DebugScope(StatTimer::DebugDraw);
+        Timers->Begin(StatTimer::DebugDraw);
+        BindViewport(MainSceneView);
+        DebugRenderer->Render(Views[MainSceneView].View, *Uploads);
+        Timers->End(StatTimer::DebugDraw);
+        DrawCount += DebugRenderer->GetStats().DrawCount;
+    }
+#endif
+    glViewport(FrameViewport[0], FrameViewport[1], FrameViewport[2], FrameViewport[3]);
+    if (OwnedUploads) { OwnedUploads->EndFrame(); }
+    if (OwnedResources) { OwnedResources->EndFrame(); }
+
+    Timers->End(StatTimer::Render);
+    StatCounters::Add(StatCounter::DrawCalls, DrawCount);
+    StatCounters::Add(StatCounter::StateChanges, Stats.StateChangeCount);
+    StatCounters::Set(StatCounter::RenderInstances, Stats.InstanceCount);
+}
+
+void SceneRenderer::RenderScene() {
+    Scene.Sync(IsGPUDriven());
+    Visibility->Flush();
+    Materials->Update(*Textures);
+    if (GPUCulling) { UpdateMaterialGroups(); }
+
+    uint32_t DueCount = 0;
+    if (Shadows) {
+        Shadows->MarkChanged(Scene.GetChangedBounds());
+        DueCount = Shadows->Update(Views[MainSceneView].View, Lighting->GetDirectionalLightDirection());
+    }
+    if (!GPUCulling) {
+        if (SoftwareOcclusion) { RasterizeOccluders(); }
+        CullCPU(DueCount);
+    }
+    if (DueCount > 0) { RenderShadows(DueCount); }
+    Scene.ClearChangedBounds();
+
+    StatScope Scope(StatTimer::Scene);
+    Timers->Begin(StatTimer::Scene);
+    Timers->BeginPrimitives();
+    for (SceneViewId Id = 0; Id < Views.size(); ++Id) {
+        if (Views[Id].Active) { RenderSceneView(Id); }
+    }
+    glBindVertexArray(0);
+    Timers->EndPrimitives();
+    Timers->End(StatTimer::Scene);
+    ReportTextureUsage();
+}
+
+void SceneRenderer::RenderSceneView(SceneViewId Id) {
+    const RenderView& DrawView = Views[Id].View;
+    const bool MainView = Id == MainSceneView;
+    BindViewport(Id);
+
+    // Clusters are built in the view's space and looked up by its viewport
+    Lighting->Update(DrawView, Jobs);
+    const Shader& Program = GetShader(DrawShader);
+    Program.use();
+    BindViewBlock(DrawView);
+    Lighting->Bind(Program, LightingTextureUnit);
+    Materials->Bind(Program);
+    // Program, light buffers and material block
+    Stats.StateChangeCount += 3;
+    if (Shadows && MainView) {
+        Shadows->Bind(Program, ShadowTextureUnit);
+        ++Stats.StateChangeCount;
+    } else {
+        // Keep the unused shadow sampler off the units other sampler types use. The cascades
+        // are fitted to the main view, so other views draw unshadowed.
+        Program.setInt("uShadowMap", ShadowTextureUnit);
+        Program.setInt("uShadowCascadeCount", 0);
+    }
+    if (GPUCulling) {
+        RenderGPU(DrawView, MainView);
+    } else {
+        // Cascade results come first
+        const uint32_t ShadowCount = static_cast<uint32_t>(CullResults.size()) - Stats.ViewCount;
+        uint32_t Index = ShadowCount;
+        for (SceneViewId Previous = 0; Previous < Id; ++Previous) {
+            Index += Views[Previous].Active ? 1 : 0;
+        }
+        DrawCPU(CullResults[Index], &Stats, true);
+    }
+}
+
+void SceneRenderer::BindViewBlock(const RenderView& BlockView) {
+    const UploadAllocation Block = Uploads->AllocateUniform(sizeof(ViewBlockData));
+    if (!Block) { return; }
+    ViewBlockData Data;
+    Data.ViewProjection = BlockView.RelativeViewProjection;
+    Data.View = BlockView.RelativeView;
+    Data.Origin = Vec4(BlockView.Origin, 0.0f);
+    std::memcpy(Block.Data, &Data, sizeof(Data));
+    Uploads->Flush();
+    glBindBufferRange(GL_UNIFORM_BUFFER, ViewBlockBinding, Block.Buffer, static_cast<GLintptr>(Block.Offset),
+                      sizeof(ViewBlockData));
+}
+
+void SceneRenderer::RenderGPU(const RenderView& DrawView, bool MainView) {
+    // Only the main view has a pyramid, and only its counts are read back
+    GPUCulling->Cull(Scene, DrawView, MainView ? HiZBuffer.get() : nullptr, MainView);
+    BindGPUVertexArray();
+
+    // Culling re-bound the binding points; the draw only needs the instances and materials.
+    // Without bindless handles each material group is drawn with its textures bound.
+    const Shader& Program = GetShader(DrawShader);
+    Program.use();
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, Scene.GetInstanceBuffer());
+    Materials->Bind(Program);
+    Stats.StateChangeCount += 2;
+    const auto GroupCount = static_cast<uint32_t>(std::max<size_t>(GroupMaterials.size(), 1));
+    for (uint32_t Group = 0; Group < GroupCount; ++Group) {
+        if (Group > 0) {
+            Materials->BindTextures(Program, *Textures, GroupMaterials[Group], MaterialTextureUnit);
+            ++Stats.StateChangeCount;
+        }
+        Materials->SetTexturesBound(Program, Group > 0);
+        GPUCulling->Draw(Scene, Group);
+    }
+    if (!MainView) {
+        Stats.DrawCount += GroupCount;
+        return;
+    }
+
+    // Next frame's occluders: this frame's visible set, redrawn depth-only at low resolution.
+    // Anything culled now is missing from it, so it can only make next frame's test more
+    // permissive; a newly revealed object shows up one frame late at worst.
+    if (HiZBuffer) {
+        HiZBuffer->BeginDepthPass(DrawView.ViewProjection);
+        GetShader(OcclusionDepthShader).use();
+        ++Stats.StateChangeCount;
+        GPUCulling->Draw(Scene);
+        HiZBuffer->EndDepthPass();
+    }
+
+    const GPUCullingStats& Counts = GPUCulling->GetLastStats();
+    Stats.VisibleCount = Counts.VisibleCount;
+    Stats.DrawCount += Counts.DrawCount;
+    Stats.FrustumCulledCount = Counts.FrustumCulledCount;
+    Stats.OcclusionCulledCount = Counts.OcclusionCulledCount;
+    Stats.CountLatency = Counts.Latency;
+}
+
+void SceneRenderer::RenderShadows(uint32_t DueCount) {
+    StatScope Scope(StatTimer::Shadows);
+    Timers->Begin(StatTimer::Shadows);
+    GetShader(ShadowDepthShader).use();
+    ++Stats.StateChangeCount;
+    for (uint32_t i = 0; i < DueCount; ++i) {
+        const uint32_t Cascade = Shadows->GetDueCascade(i);
+        const RenderView& CascadeView = Shadows->GetCascadeView(Cascade);
+        Shadows->BeginCascade(Cascade);
+        BindViewBlock(CascadeView);
+        if (GPUCulling) {
+            GPUCulling->Cull(Scene, CascadeView, nullptr, false);
+            BindGPUVertexArray();
+            GetShader(ShadowDepthShader).use();
+            ++Stats.StateChangeCount;
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, Scene.GetInstanceBuffer());
+            GPUCulling->Draw(Scene);
+            ++Stats.ShadowDrawCount;
+        } else {
+            DrawCPU(CullResults[i], nullptr, false);
+        }
+        Shadows->EndCascade();
+    }
+    glBindVertexArray(0);
+    Timers->End(StatTimer::Shadows);
+}
+
+void SceneRenderer::BindGPUVertexArray() {
+    const uint64_t Key = (static_cast<uint64_t>(Scene.GetBufferGeneration()) << 32) | GPUCulling->GetBufferGeneration();
+    glBindVertexArray(VertexArray);
+    ++Stats.StateChangeCount;
+    if (Key != VertexArrayKey) {
+        SetupVertexArray();
+        glBindBuffer(GL_ARRAY_BUFFER, GPUCulling->GetVisibleInstanceBuffer());
+        glEnableVertexAttribArray(InstanceIdLocation);
+        glVertexAttribIPointer(InstanceIdLocation, 1, GL_UNSIGNED_INT, sizeof(uint32_t), nullptr);
+        glVertexAttribDivisor(InstanceIdLocation, 1);
+        VertexArrayKey = Key;
+    }
+}
+
+void SceneRenderer::CullCPU(uint32_t DueCount) {
+    const std::vector<GPUInstance>& Instances = Scene.GetInstances();
+    const std::vector<GPUMeshInfo>& Meshes = Scene.GetMeshes();
+    const uint32_t InstanceCount = Scene.GetInstanceCount();
+
+    // Results are kept across frames so their arrays keep their capacity
+    const uint32_t ResultCount = DueCount + Stats.ViewCount;
+    if (CullResults.size() != ResultCount) { CullResults.resize(ResultCount); }
+    uint32_t Index = 0;
+    for (; Index < DueCount; ++Index) {
+        CullResults[Index].View = &Shadows->GetCascadeView(Shadows->GetDueCascade(Index));
+        CullResults[Index].Occlusion = nullptr;
+    }
+    for (SceneViewId Id = 0; Id < Views.size(); ++Id) {
+        if (!Views[Id].Active) { continue; }
+        CullResults[Index].View = &Views[Id].View;
+        CullResults[Index].Occlusion = Id == MainSceneView ? SoftwareOcclusion.get() : nullptr;
+        ++Index;
+    }
+    if (MaterialOrder.size() != InstanceCount || MaterialOrderKey != Scene.GetMaterialGeneration()) { SortByMaterial(); }
+
+    // Instances outside the frustum query are never visited and keep NotDrawn
+    ParallelFor(Jobs, ResultCount, 1, [&](uint32_t Begin, uint32_t End) {
+        for (uint32_t i = Begin; i < End; ++i) {
+            CullResult& Result = CullResults[i];
+            Result.InstanceBuckets.assign(InstanceCount, NotDrawn);
+            Result.Candidates.clear();
+            Visibility->QueryFrustum(Result.View->ViewFrustum, Result.Candidates);
+        }
+    });
+
+    // Every (result, candidate range) pair is one item, so the views and cascades share the
+    // workers instead of running one after another
+    constexpr uint32_t CullGrain = 4096;
+    std::vector<uint32_t> RangeStarts(ResultCount + 1, 0);
+    for (uint32_t i = 0; i < ResultCount; ++i) {
+        const auto CandidateCount = static_cast<uint32_t>(CullResults[i].Candidates.size());
+        RangeStarts[i + 1] = RangeStarts[i] + (CandidateCount + CullGrain - 1) / CullGrain;
+    }
+    ParallelFor(Jobs, RangeStarts[ResultCount], 1, [&](uint32_t Begin, uint32_t End) {
+        for (uint32_t Item = Begin; Item < End; ++Item) {
+            const auto Owner = static_cast<uint32_t>(std::upper_bound(RangeStarts.begin(), RangeStarts.end(), Item) - RangeStarts.begin() - 1);
+            CullResult& Result = CullResults[Owner];
+            const uint32_t First = (Item - RangeStarts[Owner]) * CullGrain;
+            const uint32_t Last = std::min(First + CullGrain, static_cast<uint32_t>(Result.Candidates.size()));
+            for (uint32_t i = First; i < Last; ++i) {
+                const auto Id = static_cast<uint32_t>(Visibility->GetUserData(Result.Candidates[i]));
+                Result.InstanceBuckets[Id] = SelectBucket(Instances[Id], Meshes, *Result.View, Result.Occlusion);
+            }
+        }
+    });
+    ParallelFor(Jobs, ResultCount, 1, [&](uint32_t Begin, uint32_t End) {
+        for (uint32_t i = Begin; i < End; ++i) {
+            SortVisible(CullResults[i]);
+        }
+    });
+}
+
+void SceneRenderer::SortVisible(CullResult& Result) const {
+    const std::vector<GPUInstance>& Instances = Scene.GetInstances();
+    const uint32_t BucketCount = Scene.GetBucketCount();
+
+    // Counting sort by bucket so each bucket's transforms are contiguous. Visiting instances in
+    // material order keeps each bucket sorted by material.
+    Result.BucketOffsets.assign(BucketCount + 1, 0);
+    Result.FrustumCulledCount = 0;
+    Result.OcclusionCulledCount = 0;
+    for (uint32_t Bucket : Result.InstanceBuckets) {
+        if (Bucket < BucketCount) {
+            ++Result.BucketOffsets[Bucket + 1];
+        } else if (Bucket == CulledByOcclusion) {
+            ++Result.OcclusionCulledCount;
+        }
+    }
+    for (uint32_t i = 0; i < BucketCount; ++i) {
+        Result.BucketOffsets[i + 1] += Result.BucketOffsets[i];
+    }
+    const uint32_t VisibleCount = Result.BucketOffsets[BucketCount];
+    // Outside the frustum query, or culled by distance after it
+    Result.FrustumCulledCount = Scene.GetLiveInstanceCount() - VisibleCount - Result.OcclusionCulledCount;
+    Result.VisibleTransforms.resize(VisibleCount);
+    Result.VisibleMaterials.resize(VisibleCount);
+    Result.BucketCursors.assign(Result.BucketOffsets.begin(), Result.BucketOffsets.end() - 1);
+    for (uint32_t i : MaterialOrder) {
+        const uint32_t Bucket = Result.InstanceBuckets[i];
+        if (Bucket >= BucketCount) { continue; }
+        const uint32_t Slot = Result.BucketCursors[Bucket]++;
+        Result.VisibleTransforms[Slot] = Instances[i].Model;
+        Result.VisibleMaterials[Slot] = Instances[i].MaterialIndex;
+    }
+}
+
+void SceneRenderer::DrawCPU(const CullResult& Result, SceneRenderStats* CullStats, bool BindMaterials) {
+    const uint32_t BucketCount = Scene.GetBucketCount();
+    const std::vector<uint32_t>& BucketOffsets = Result.BucketOffsets;
+    const std::vector<uint32_t>& VisibleMaterials = Result.VisibleMaterials;
+    const uint32_t VisibleCount = BucketOffsets[BucketCount];
+    if (CullStats) {
+        CullStats->VisibleCount += VisibleCount;
+        CullStats->FrustumCulledCount += Result.FrustumCulledCount;
+        CullStats->OcclusionCulledCount += Result.OcclusionCulledCount;
+    }
+    if (VisibleCount == 0) { return; }
+
+    // Transforms first, then the material indices
+    const size_t TransformBytes = VisibleCount * sizeof(Mat4);
+    const size_t MaterialBytes = VisibleCount * sizeof(uint32_t);
+    const UploadAllocation Stream = Uploads->Allocate(TransformBytes + MaterialBytes);
+    if (!Stream) { return; }
+    auto* StreamData = static_cast<uint8_t*>(Stream.Data);
+    std::memcpy(StreamData, Result.VisibleTransforms.data(), TransformBytes);
+    std::memcpy(StreamData + TransformBytes, VisibleMaterials.data(), MaterialBytes);
+    Uploads->Flush();
+
+    glBindVertexArray(VertexArray);
+    ++Stats.StateChangeCount;
+    if (Scene.GetBufferGeneration() != VertexArrayKey) {
+        SetupVertexArray();
+        for (GLuint Column = 0; Column < 4; ++Column) {
+            glEnableVertexAttribArray(ModelLocation + Column);
+            glVertexAttribDivisor(ModelLocation + Column, 1);
+        }
+        glEnableVertexAttribArray(MaterialLocation);
+        glVertexAttribDivisor(MaterialLocation, 1);
+        VertexArrayKey = Scene.GetBufferGeneration();
+    }
+
+    // Without bindless handles, material textures are bound per run of equal material, which
+    // the sort keeps few; otherwise each bucket is one draw.
+    const bool SplitByMaterial = BindMaterials && Materials->GetTextureParameterCount() > 0 && !Materials->IsBindless();
+    if (BindMaterials) { Materials->SetTexturesBound(GetShader(DrawShader), SplitByMaterial); }
+    uint32_t BoundMaterial = InvalidMaterialId;
+
+    // GL 3.3 has no BaseInstance, so the instance attributes are re-pointed per draw instead
+    glBindBuffer(GL_ARRAY_BUFFER, Stream.Buffer);
+    const std::vector<GPUDrawBucket>& Buckets = Scene.GetBuckets();
+    for (uint32_t Bucket = 0; Bucket < BucketCount; ++Bucket) {
+        uint32_t First = BucketOffsets[Bucket];
+        const uint32_t End = BucketOffsets[Bucket + 1];
+        while (First < End) {
+            uint32_t Last = End;
+            if (SplitByMaterial) {
+                // Untextured materials read white whatever is bound, so they share one run
+                const uint32_t Material = VisibleMaterials[First];
+                const bool Textured = Materials->HasTextures(Material);
+                Last = First + 1;
+                while (Last < End && (VisibleMaterials[Last] == Material ||
+                                      (!Textured && !Materials->HasTextures(VisibleMaterials[Last])))) {
+                    ++Last;
+                }
+                if (Textured && Material != BoundMaterial) {
+                    Materials->BindTextures(GetShader(DrawShader), *Textures, Material, MaterialTextureUnit);
+                    BoundMaterial = Material;
+                    ++Stats.StateChangeCount;
+                }
+            }
+            SetInstanceAttributes(Stream.Offset, First, VisibleCount);
+            glDrawElementsInstancedBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(Buckets[Bucket].IndexCount), GL_UNSIGNED_INT,
+                                              reinterpret_cast<void*>(Buckets[Bucket].FirstIndex * sizeof(unsigned int)),
+                                              static_cast<GLsizei>(Last - First), Buckets[Bucket].BaseVertex);
+            if (CullStats) {
+                ++CullStats->DrawCount;
+            } else {
+                ++Stats.ShadowDrawCount;
+            }
+            First = Last;
+        }
+    }
+}
+
+void SceneRenderer::SortByMaterial() {
+    // Counting sort of instance indices by material index
+    const std::vector<GPUInstance>& Instances = Scene.GetInstances();
+    uint32_t MaterialCount = 1;
+    for (const GPUInstance& Instance : Instances) {
+        MaterialCount = std::max(MaterialCount, Instance.MaterialIndex + 1);
+    }
+    std::vector<uint32_t> Offsets(MaterialCount + 1, 0);
+    for (const GPUInstance& Instance : Instances) {
+        ++Offsets[Instance.MaterialIndex + 1];
+    }
+    for (uint32_t i = 0; i < MaterialCount; ++i) {
+        Offsets[i + 1] += Offsets[i];
+    }
+    MaterialOrder.resize(Instances.size());
+    for (uint32_t i = 0; i < Instances.size(); ++i) {
+        MaterialOrder[Offsets[Instances[i].MaterialIndex]++] = i;
+    }
+    MaterialOrderKey = Scene.GetMaterialGeneration();
+}
+
+void SceneRenderer::UpdateMaterialGroups() {
+    // Bindless materials sample through their handles, so one multi-draw covers them all
+    if (Materials->IsBindless() || Materials->GetTextureParameterCount() == 0) { return; }
+
+    const uint32_t MaterialCount = Materials->GetMaterialCount();
+    const uint32_t SlotCount = Materials->GetTextureParameterCount();
+    std::vector<uint32_t> Groups(MaterialCount, 0);
+    std::vector<uint32_t> Representatives(1, InvalidMaterialId);
+    std::map<std::vector<TextureId>, uint32_t> GroupsByTextures;
+    std::vector<TextureId> Key(SlotCount);
+    for (MaterialId Id = 0; Id < MaterialCount; ++Id) {
+        if (!Materials->HasTextures(Id)) { continue; }
+        for (uint32_t Slot = 0; Slot < SlotCount; ++Slot) {
+            Key[Slot] = Materials->GetTexture(Id, Slot);
+        }
+        const auto [Found, Inserted] = GroupsByTextures.try_emplace(Key, static_cast<uint32_t>(Representatives.size()));
+        if (Inserted) { Representatives.push_back(Id); }
+        Groups[Id] = Found->second;
+    }
+    if (Groups == MaterialGroups && Representatives == GroupMaterials) { return; }
+    MaterialGroups = std::move(Groups);
+    GroupMaterials = std::move(Representatives);
+    GPUCulling->SetMaterialGroups(MaterialGroups, static_cast<uint32_t>(GroupMaterials.size()));
+}
+
+void SceneRenderer::ReportTextureUsage() {
+    if (Textures->GetStats().TextureCount == 0) { return; }
+
+    const std::vector<GPUInstance>& Instances = Scene.GetInstances();
+    for (const SceneView& Target : Views) {
+        if (!Target.Active) { continue; }
+        const float ViewportHeight = static_cast<float>(FrameViewport[3]) * Target.Viewport.w;
+        VisibleProxies.clear();
+        Visibility->QueryFrustum(Target.View.ViewFrustum, VisibleProxies);
+        for (const SpatialId Proxy : VisibleProxies) {
+            const GPUInstance& Instance = Instances[Visibility->GetUserData(Proxy)];
+            if (!Materials->HasTextures(Instance.MaterialIndex)) { continue; }
+            const Vec3 Center(Instance.BoundsCenter);
+            const Vec3 Extent(Instance.BoundsExtent);
+            const float ScreenSize = TextureStreamer::EstimateScreenSize(Target.View, Center, length(Extent), ViewportHeight);
+            for (uint32_t Slot = 0; Slot < Materials->GetTextureParameterCount(); ++Slot) {
+                const TextureId Texture = Materials->GetTexture(Instance.MaterialIndex, Slot);
+                if (Texture != InvalidTextureId) { Textures->ReportUsage(Texture, ScreenSize); }
+            }
+        }
+    }
+}
+
+void SceneRenderer::RasterizeOccluders() {
+    const std::vector<GPUInstance>& Instances = Scene.GetInstances();
+    const std::vector<GPUMeshInfo>& Meshes = Scene.GetMeshes();
+    const std::vector<GPUDrawBucket>& Buckets = Scene.GetBuckets();
+
+    const RenderView& View = Views[MainSceneView].View;
+    SoftwareOcclusion->Begin(View.ViewProjection);
+    VisibleProxies.clear();
+    Visibility->QueryFrustum(View.ViewFrustum, VisibleProxies);
+    for (const SpatialId Proxy : VisibleProxies) {
+        const GPUInstance& Instance = Instances[Visibility->GetUserData(Proxy)];
+        if ((Instance.Flags & InstanceOccluder) == 0) { continue; }
+
+        // The coarsest LOD is plenty for occlusion
+        const GPUMeshInfo& Mesh = Meshes[Instance.MeshIndex];
+        if (Mesh.LODCount == 0) { continue; }
+        const GPUDrawBucket& Lod = Buckets[Mesh.FirstBucket + Mesh.LODCount - 1];
+        SoftwareOcclusion->RasterizeMesh(Instance.Model, Scene.GetVertices().data() + Lod.BaseVertex,
+                                         Scene.GetIndices().data() + Lod.FirstIndex, Lod.IndexCount);
+    }
+    SoftwareOcclusion->Finish();
+    Stats.OccluderTriangleCount = SoftwareOcclusion->GetRasterizedTriangleCount();
+}
+
+bool SceneRenderer::RefreshPrograms() {
+    bool Loaded = true;
+    for (ShaderProgramHandle* Program : {&DrawShader, &ShadowDepthShader, &OcclusionDepthShader}) {
+        if (Program->Id == InvalidShaderProgramId) { continue; }
+        const Shader* Current = Shaders->Get(Program->Id);
+        if (!Current) {
+            Loaded = false;
+            continue;
+        }
+        if (!Shaders->Refresh(*Program)) { continue; }
+        SetViewBlockBinding(*Current);
+        Materials->ForgetProgram(*Current);
+    }
+    return Loaded;
+}
+
+const Shader& SceneRenderer::GetShader(const ShaderProgramHandle& Program) const {
+    return *Shaders->Get(Program.Id);
+}
+
+void SceneRenderer::SetupVertexArray() const {
+    glBindVertexArray(VertexArray);
+    glBindBuffer(GL_ARRAY_BUFFER, Scene.GetVertexBuffer());
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, Scene.GetIndexBuffer());
+    glEnableVertexAttribArray(PositionLocation);
+    glVertexAttribPointer(PositionLocation, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<void*>(offsetof(Vertex, position)));
+    glEnableVertexAttribArray(NormalLocation);
+    glVertexAttribPointer(NormalLocation, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<void*>(offsetof(Vertex, normal)));
+    glEnableVertexAttribArray(TexCoordLocation);
+    glVertexAttribPointer(TexCoordLocation, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<void*>(offsetof(Vertex, texCoord)));
+}
+
+} // namespace Volante
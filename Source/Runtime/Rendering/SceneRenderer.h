@@ -0,0 +1,255 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Engine.h"
+#include "CascadedShadows.h"
+#include "DebugDraw.h"
+#include "GPUScene.h"
+#include "LightClusters.h"
+#include "RenderView.h"
+#include "ShaderLibrary.h"
+#include "TextureStreamer.h"
+
+namespace Volante {
+
+class CascadedShadows;
+class ClusteredLighting;
+class GPUCulling;
+class GPUTimers;
+class HiZBuffer;
+class MaterialSystem;
+class ResourceManager;
+class Shader;
+class ShaderLibrary;
+class SoftwareOcclusion;
+class SpatialIndex;
+class TextureStreamer;
+class UploadRing;
+
+using SceneViewId = uint32_t;
+
+// Always present; SetView(View, Projection) and GetView() refer to it.
+constexpr SceneViewId MainSceneView = 0;
+
+struct SceneRendererDesc {
+    // Use the compute culling path when the context supports it (GL 4.3+). Turning this off
+    // forces the CPU path, e.g. to compare the two.
+    bool AllowGPUCulling = true;
+    float LODScale = 1.0f;
+
+    // GPU path: Hi-Z pyramid of last frame's visible set. CPU path: software-rasterized
+    // occluders (GPUScene::SetOccluder). Sizes are rounded up to powers of two.
+    bool OcclusionCulling = true;
+    uint32_t HiZWidth = 256;
+    uint32_t HiZHeight = 128;
+    uint32_t SoftwareOcclusionWidth = 256;
+    uint32_t SoftwareOcclusionHeight = 128;
+
+    LightClusterDesc Lighting;
+
+    // Cascaded shadow maps for the directional light
+    bool CastShadows = true;
+    CascadedShadowDesc Shadows;
+
+    // Streamed material textures; the budget covers their mip levels only
+    TextureStreamerDesc Textures;
+};
+
+// On the GPU path the culling counts arrive CountLatency frames late, since waiting for them
+// would stall, and cover the main view only; on the CPU path they describe the current frame,
+// summed over all views.
+struct SceneRenderStats {
+    uint32_t InstanceCount = 0;
+    uint32_t ViewCount = 0;
+    uint32_t VisibleCount = 0;
+    uint32_t DrawCount = 0;
+    uint32_t FrustumCulledCount = 0;
+    uint32_t OcclusionCulledCount = 0;
+    uint32_t OccluderTriangleCount = 0;
+    // Shadow cascade draws, on top of DrawCount
+    uint32_t ShadowDrawCount = 0;
+    // Program, vertex array and texture binds across all passes
+    uint32_t StateChangeCount = 0;
+    uint32_t CountLatency = 0;
+    bool GPUDriven = false;
+};
+
+// Draws every instance in its GPUScene. With GL 4.3 culling, LOD selection and command
+// generation run in compute shaders and the scene is submitted with one indirect multi-draw,
+// or without bindless textures one per set of material textures in use; otherwise instances
+// are culled on the job system and drawn with one instanced draw per visible (mesh, LOD)
+// bucket, which only needs GL 3.3.
+//
+// The scene can be drawn from several views, e.g. split screen, each into its own rectangle of
+// the current viewport. Culling is per view: on the CPU path every view and every due shadow
+// cascade is culled in one pass over the job system before anything is drawn, starting from a
+// frustum query of a SpatialIndex over the instances rather than a test of each one. Occlusion culling
+// and shadows follow the main view; other views draw without either.
+//
+// Per-view uniforms and the CPU path's instance streams are sub-allocated from Uploads, and
+// the material buffer comes from Resources; the owner (Renderer) brackets the frames of both.
+// The programs, the culling and debug ones included, are loaded through Shaders, which
+// rebuilds them when their files change. Without any of these, the renderer keeps its own, treats each Render()
+// as a frame and applies shader reloads at its start.
+class SceneRenderer : public IEngineSubsystem {
+public:
+    explicit SceneRenderer(const SceneRendererDesc& Desc = {}, JobSystem* Jobs = nullptr, UploadRing* Uploads = nullptr,
+                           ResourceManager* Resources = nullptr, ShaderLibrary* Shaders = nullptr);
+    ~SceneRenderer() override;
+
+    void Initialize() override;
+    void Shutdown() override;
+    void Update(float DeltaTime) override;
+
+    void SetView(const Mat4& View, const Mat4& Projection);
+    // Desc.LODScale applies on top of the view's own.
+    void SetView(SceneViewId Id, const RenderView& View);
+    void Render();
+
+    // Viewport is the view's rectangle (x, y, width, height) as fractions of the viewport
+    // current when Render is called.
+    SceneViewId AddView(const Vec4& Viewport);
+    void RemoveView(SceneViewId Id);
+    void SetViewport(SceneViewId Id, const Vec4& Viewport);
+
+    // For passes drawn after Render: calls Body once per view with the GL viewport set to the
+    // view's rectangle, then restores it.
+    void ForEachView(const std::function<void(const RenderView&)>& Body) const;
+
+    // Skips occlusion for the next frame, for camera cuts where last frame's depth is stale.
+    void InvalidateOcclusion();
+
+    [[nodiscard]] GPUScene& GetScene() { return Scene; }
+
+    [[nodiscard]] ClusteredLighting& GetLighting() { return *Lighting; }
+
+    [[nodiscard]] TextureStreamer& GetTextures() { return *Textures; }
+
+    // Materials have a BaseColor (vec4, default white) and a BaseColorTexture; instances pick
+    // one with GPUScene::SetMaterial. Material 0 is the default. Valid after Initialize.
+    [[nodiscard]] MaterialSystem& GetMaterials() { return *Materials; }
+
+    // Null when CastShadows is off or the shadow target could not be created.
+    [[nodiscard]] const CascadedShadows* GetShadows() const { return Shadows.get(); }
+
+    [[nodiscard]] const RenderView& GetView(SceneViewId Id = MainSceneView) const { return Views[Id].View; }
+
+    // Active views, the main one included.
+    [[nodiscard]] uint32_t GetViewCount() const;
+
+    // Replaces Out with the active views, the main one first, for work shared by all of them
+    // before any is drawn.
+    void GetViews(std::vector<RenderView>& Out) const;
+
+    [[nodiscard]] bool IsGPUDriven() const { return GPUCulling != nullptr; }
+
+    [[nodiscard]] const SceneRenderStats& GetStats() const { return Stats; }
+
+#if VOLANTE_DEBUG_DRAW
+    // Draws DebugDraw's primitives after the scene each frame
+    [[nodiscard]] const DebugDrawRenderer& GetDebugDraw() const { return *DebugRenderer; }
+#endif
+
+private:
+    struct SceneView {
+        RenderView View;
+        Vec4 Viewport = Vec4(0.0f, 0.0f, 1.0f, 1.0f);
+        bool Active = false;
+    };
+
+    // CPU path: one view's or shadow cascade's bucket per instance, bucket start offsets and
+    // the visible transforms and materials in bucket order.
+    struct CullResult {
+        const RenderView* View = nullptr;
+        const class SoftwareOcclusion* Occlusion = nullptr;
+        // Proxies of the instances in the view's frustum
+        std::vector<SpatialId> Candidates;
+        std::vector<uint32_t> InstanceBuckets;
+        std::vector<uint32_t> BucketOffsets;
+        std::vector<uint32_t> BucketCursors;
+        std::vector<Mat4> VisibleTransforms;
+        std::vector<uint32_t> VisibleMaterials;
+        uint32_t FrustumCulledCount = 0;
+        uint32_t OcclusionCulledCount = 0;
+    };
+
+    void RenderScene();
+    void RenderSceneView(SceneViewId Id);
+    void RenderGPU(const RenderView& DrawView, bool MainView);
+    void RenderShadows(uint32_t DueCount);
+    void BindGPUVertexArray();
+    void BindViewport(SceneViewId Id) const;
+    // Culls the due shadow cascades, then the active views, into CullResults in that order.
+    void CullCPU(uint32_t DueCount);
+    // Buckets one result's visible instances
+    void SortVisible(CullResult& Result) const;
+    // Streams a cull result and draws it with whichever program is bound; CullStats may be
+    // null. BindMaterials binds material textures for DrawShader.
+    void DrawCPU(const CullResult& Result, SceneRenderStats* CullStats, bool BindMaterials);
+    void SortByMaterial();
+    // GPU path without bindless handles: groups the materials by their textures for GPUCulling
+    void UpdateMaterialGroups();
+    // Streams the view's matrices into the ViewBlock binding
+    void BindViewBlock(const RenderView& BlockView);
+    void SetupVertexArray() const;
+    void RasterizeOccluders();
+    // Screen-space feedback for the textures of the instances in view
+    void ReportTextureUsage();
+    // Sets the block bindings of programs a reload replaced. False while a program has yet
+    // to build, in which case the scene is not drawn.
+    bool RefreshPrograms();
+    [[nodiscard]] const Shader& GetShader(const ShaderProgramHandle& Program) const;
+
+    SceneRendererDesc Desc;
+    JobSystem* Jobs;
+    UploadRing* Uploads;
+    std::unique_ptr<UploadRing> OwnedUploads;
+    ResourceManager* Resources;
+    std::unique_ptr<ResourceManager> OwnedResources;
+    ShaderLibrary* Shaders;
+    std::unique_ptr<ShaderLibrary> OwnedShaders;
+    GPUScene Scene;
+    // Indexed by SceneViewId; removed views leave inactive slots for reuse
+    std::vector<SceneView> Views;
+    // Viewport current when Render was called, which views subdivide
+    int FrameViewport[4] = {0, 0, 0, 0};
+    SceneRenderStats Stats;
+
+    std::unique_ptr<ClusteredLighting> Lighting;
+    std::unique_ptr<class GPUCulling> GPUCulling;
+    ShaderProgramHandle DrawShader;
+    std::unique_ptr<HiZBuffer> HiZBuffer;
+    ShaderProgramHandle OcclusionDepthShader;
+    std::unique_ptr<CascadedShadows> Shadows;
+    ShaderProgramHandle ShadowDepthShader;
+    std::unique_ptr<SoftwareOcclusion> SoftwareOcclusion;
+    std::unique_ptr<TextureStreamer> Textures;
+    std::unique_ptr<MaterialSystem> Materials;
+    std::unique_ptr<GPUTimers> Timers;
+    // Instance bounds for the CPU-side frustum queries, flushed at the start of each frame
+    std::unique_ptr<SpatialIndex> Visibility;
+    std::vector<SpatialId> VisibleProxies;
+#if VOLANTE_DEBUG_DRAW
+    std::unique_ptr<DebugDrawRenderer> DebugRenderer;
+#endif
+
+    unsigned int VertexArray = 0;
+    uint64_t VertexArrayKey = ~0ull;
+
+    // CPU path: this frame's cull results, streamed through Uploads as they are drawn.
+    // MaterialOrder lists instances by material and is rebuilt when materials change.
+    std::vector<CullResult> CullResults;
+    std::vector<uint32_t> MaterialOrder;
+    uint32_t MaterialOrderKey = ~0u;
+
+    // GPU path: each material's group, and a material of each group whose textures it binds.
+    // Group 0 holds the untextured materials and has none.
+    std::vector<uint32_t> MaterialGroups;
+    std::vector<uint32_t> GroupMaterials;
+};
+
+} // namespace Volante
@@ -0,0 +1,472 @@
+#include "ShaderLibrary.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <unordered_set>
+
+#include "ComputeProgram.h"
+#include "GLCapabilities.h"
+#include "Runtime/Core/Async/JobSystem.h"
+#include "Runtime/Core/IO/FileWatcher.h"
+#include "Shader.h"
+#include "UploadContext.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__APPLE__)
+#include <mach-o/dyld.h>
+#endif
+
+// Extension enum that glad only defines when it was generated with the extension
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+namespace Volante {
+
+namespace {
+
+// Deeper than any sane include chain, so a cycle fails instead of recursing forever
+constexpr uint32_t MaxIncludeDepth = 32;
+
+bool ReadTextFile(const std::string& Path, std::string& Out) {
+    std::ifstream File(Path, std::ios::binary);
+    if (!File.is_open()) { return false; }
+    std::ostringstream Stream;
+    Stream << File.rdbuf();
+    Out = Stream.str();
+    return true;
+}
+
+bool ExpandIncludes(const std::string& Path, std::string& Out, std::vector<std::string>& Dependencies, uint32_t Depth) {
+    const std::string File = FileWatcher::Normalize(Path);
+    if (Depth > MaxIncludeDepth) {
+        std::cerr << "ERROR::SHADER_LIBRARY::INCLUDE_TOO_DEEP: " << File << std::endl;
+        return false;
+    }
+    // Recorded before reading, so creating a missing include also triggers a rebuild
+    Dependencies.push_back(File);
+
+    std::string Source;
+    if (!ReadTextFile(File, Source)) {
+        std::cerr << "ERROR::SHADER_LIBRARY::FILE_NOT_READ: " << File << std::endl;
+        return false;
+    }
+
+    const std::filesystem::path Directory = std::filesystem::path(File).parent_path();
+    std::istringstream Lines(Source);
+    std::string Line;
+    while (std::getline(Lines, Line)) {
+        const size_t First = Line.find_first_not_of(" \t");
+        if (First != std::string::npos && Line.compare(First, 8, "#include") == 0) {
+            const size_t Open = Line.find('"', First + 8);
+            const size_t Close = Open == std::string::npos ? std::string::npos : Line.find('"', Open + 1);
+            if (Close == std::string::npos) {
+                std::cerr << "ERROR::SHADER_LIBRARY::BAD_INCLUDE: " << File << ": " << Line << std::endl;
+                return false;
+            }
+            const std::string Include = Line.substr(Open + 1, Close - Open - 1);
+            if (!ExpandIncludes((Directory / Include).string(), Out, Dependencies, Depth + 1)) { return false; }
+            continue;
+        }
+        Out += Line;
+        Out += '\n';
+    }
+    return true;
+}
+
+// The files a program is built from, for messages
+std::string DescribeProgram(const ShaderProgramDesc& Desc) {
+    return Desc.ComputePath.empty() ? Desc.VertexPath + ", " + Desc.FragmentPath : Desc.ComputePath;
+}
+
+void PrintShaderLog(unsigned int Handle, const char* Stage, const std::string& Path) {
+    if (Handle == 0) { return; }
+    GLint Compiled = GL_FALSE;
+    glGetShaderiv(Handle, GL_COMPILE_STATUS, &Compiled);
+    if (Compiled) { return; }
+    GLint Length = 0;
+    glGetShaderiv(Handle, GL_INFO_LOG_LENGTH, &Length);
+    std::string Log(static_cast<size_t>(std::max(Length, 1)), '\0');
+    glGetShaderInfoLog(Handle, Length, nullptr, Log.data());
+    std::cerr << "ERROR::SHADER_LIBRARY::" << Stage << "::COMPILATION_FAILED: " << Path << '\n' << Log.c_str() << std::endl;
+}
+
+// Empty when the platform cannot say
+std::filesystem::path GetExecutablePath() {
+#if defined(_WIN32)
+    std::wstring Path(MAX_PATH, L'\0');
+    for (;;) {
+        const DWORD Length = GetModuleFileNameW(nullptr, Path.data(), static_cast<DWORD>(Path.size()));
+        if (Length == 0) { return {}; }
+        if (Length < Path.size()) {
+            Path.resize(Length);
+            return Path;
+        }
+        Path.resize(Path.size() * 2);
+    }
+#elif defined(__APPLE__)
+    uint32_t Size = 0;
+    _NSGetExecutablePath(nullptr, &Size);
+    std::string Path(Size, '\0');
+    if (_NSGetExecutablePath(Path.data(), &Size) != 0) { return {}; }
+    std::error_code Error;
+    return std::filesystem::canonical(Path.c_str(), Error);
+#else
+    std::error_code Error;
+    return std::filesystem::read_symlink("/proc/self/exe", Error);
+#endif
+}
+
+} // namespace
+
+struct ShaderLibrary::ReadyQueue {
+    std::mutex Mutex;
+    std::vector<PreparedSources> Finished;
+};
+
+ShaderLibrary::ShaderLibrary(JobSystem* Jobs) : Jobs(Jobs), Ready(std::make_shared<ReadyQueue>()) {}
+
+ShaderLibrary::~ShaderLibrary() {
+    Shutdown();
+}
+
+void ShaderLibrary::Initialize() {
+    ParallelCompile = GLCapabilities::Get().ParallelShaderCompile;
+    Watcher = std::make_unique<FileWatcher>();
+    for (const auto& [File, Ids] : Dependents) {
+        Watcher->Watch(File);
+    }
+}
+
+void ShaderLibrary::Shutdown() {
+    // Their completions swap into Programs, so they land before it is torn down
+    if (Offloaded > 0 && Uploader) { Uploader->Flush(); }
+    Offloaded = 0;
+    for (PendingProgram& Pending : Compiling) {
+        glDeleteShader(Pending.VertexShader);
+        glDeleteShader(Pending.FragmentShader);
+        glDeleteShader(Pending.ComputeShader);
+        glDeleteProgram(Pending.Program);
+    }
+    Compiling.clear();
+    Programs.clear();
+    Dependents.clear();
+    Watcher.reset();
+    // Reads still running finish into the old queue and are dropped with it
+    Ready = std::make_shared<ReadyQueue>();
+    Reading = 0;
+    Stats = {};
+}
+
+void ShaderLibrary::Update(float DeltaTime) {
+    std::vector<PreparedSources> Finished;
+    {
+        std::lock_guard Lock(Ready->Mutex);
+        Finished.swap(Ready->Finished);
+    }
+    for (PreparedSources& Sources : Finished) {
+        --Reading;
+        Program& Target = Programs[Sources.Id];
+        if (Sources.Build != Target.Build) { continue; }
+        if (!Sources.Succeeded) {
+            // Keep watching what was watched before too, so fixing the file retries
+            Sources.Dependencies.insert(Sources.Dependencies.end(), Target.Dependencies.begin(), Target.Dependencies.end());
+            SetDependencies(Sources.Id, std::move(Sources.Dependencies));
+            std::cerr << "ERROR::SHADER_LIBRARY::RELOAD_FAILED: " << DescribeProgram(Target.Desc)
+                      << " (keeping the previous program)" << std::endl;
+            ++Stats.FailedReloadCount;
+            continue;
+        }
+        SetDependencies(Sources.Id, std::move(Sources.Dependencies));
+        if (!ParallelCompile && Uploader && Uploader->IsRunning()) {
+            CompileOnWorker(std::move(Sources));
+        } else {
+            StartCompile(Sources);
+        }
+    }
+
+    // Without parallel compile the status query would block anyway, so finish them now
+    for (size_t i = 0; i < Compiling.size();) {
+        const CompileStatus Status = FinishCompile(Compiling[i], !ParallelCompile);
+        if (Status == CompileStatus::Compiling) {
+            ++i;
+            continue;
+        }
+        CountReload(Compiling[i].Id, Status);
+        Compiling[i] = std::move(Compiling.back());
+        Compiling.pop_back();
+    }
+
+    if (Watcher) {
+        std::unordered_set<ShaderProgramId> Affected;
+        for (const std::string& File : Watcher->PollChanges()) {
+            const auto It = Dependents.find(File);
+            if (It == Dependents.end()) { continue; }
+            Affected.insert(It->second.begin(), It->second.end());
+        }
+        for (const ShaderProgramId Id : Affected) {
+            QueueRebuild(Id);
+        }
+    }
+
+    Stats.ProgramCount = static_cast<uint32_t>(Programs.size());
+    Stats.PendingCount = Reading + Offloaded + static_cast<uint32_t>(Compiling.size());
+}
+
+ShaderProgramId ShaderLibrary::Load(const ShaderProgramDesc& Desc) {
+    const auto Id = static_cast<ShaderProgramId>(Programs.size());
+    Programs.push_back({Desc});
+
+    PreparedSources Sources = Prepare(Id, 0, Desc);
+    SetDependencies(Id, std::move(Sources.Dependencies));
+    if (Sources.Succeeded) {
+        PendingProgram Pending = Compile(Sources);
+        FinishCompile(Pending, true);
+    }
+    if (!Programs[Id].Current && !Programs[Id].CurrentCompute) {
+        std::cerr << "ERROR::SHADER_LIBRARY::LOAD_FAILED: " << DescribeProgram(Desc) << std::endl;
+    }
+    Stats.ProgramCount = static_cast<uint32_t>(Programs.size());
+    return Id;
+}
+
+ShaderProgramId ShaderLibrary::LoadCompute(const std::string& Path) {
+    ShaderProgramDesc Desc;
+    Desc.ComputePath = Path;
+    return Load(Desc);
+}
+
+void ShaderLibrary::Unload(ShaderProgramId Id) {
+    if (Id >= Programs.size()) { return; }
+    SetDependencies(Id, {});
+    Program& Target = Programs[Id];
+    Target.Current.reset();
+    Target.CurrentCompute.reset();
+    // Rebuilds still reading or compiling are dropped when they finish
+    ++Target.Build;
+}
+
+const Shader* ShaderLibrary::Get(ShaderProgramId Id) const {
+    return Id < Programs.size() ? Programs[Id].Current.get() : nullptr;
+}
+
+const ComputeProgram* ShaderLibrary::GetCompute(ShaderProgramId Id) const {
+    return Id < Programs.size() ? Programs[Id].CurrentCompute.get() : nullptr;
+}
+
+uint32_t ShaderLibrary::GetVersion(ShaderProgramId Id) const {
+    return Id < Programs.size() ? Programs[Id].Version : 0;
+}
+
+bool ShaderLibrary::Refresh(ShaderProgramHandle& Handle) const {
+    const uint32_t Version = GetVersion(Handle.Id);
+    if (Version == Handle.Version) { return false; }
+    Handle.Version = Version;
+    return true;
+}
+
+const std::string& ShaderLibrary::GetShaderDirectory() {
+    static const std::string Directory = [] {
+        std::error_code Error;
+#ifdef VOLANTE_SHADER_SOURCE_DIR
+        if (std::filesystem::is_directory(VOLANTE_SHADER_SOURCE_DIR, Error)) {
+            return std::string(VOLANTE_SHADER_SOURCE_DIR);
+        }
+#endif
+        const std::filesystem::path Executable = GetExecutablePath();
+        const std::filesystem::path Installed = Executable.parent_path() / "Shaders";
+        if (!Executable.empty() && std::filesystem::is_directory(Installed, Error)) { return Installed.string(); }
+        // Last resort: the working directory, as when running from the build directory by hand
+        return std::string("Shaders");
+    }();
+    return Directory;
+}
+
+bool ShaderLibrary::Preprocess(const std::string& Path, const std::string& Header, const std::vector<std::string>& Defines,
+                               std::string& Out, std::vector<std::string>& Dependencies) {
+    std::string Body;
+    if (!ExpandIncludes(Path, Body, Dependencies, 0)) { return false; }
+
+    std::string DefineLines;
+    for (const std::string& Define : Defines) {
+        DefineLines += "#define " + Define + '\n';
+    }
+    if (!Header.empty()) {
+        Out = Header + DefineLines + Body;
+        return true;
+    }
+
+    // #version must stay the first directive, so the defines go right after it
+    size_t Insert = 0;
+    const size_t Version = Body.find("#version");
+    if (Version != std::string::npos && Body.find_first_not_of(" \t\r\n") == Version) {
+        const size_t LineEnd = Body.find('\n', Version);
+        Insert = LineEnd == std::string::npos ? Body.size() : LineEnd + 1;
+    }
+    Out = Body.substr(0, Insert) + DefineLines + Body.substr(Insert);
+    return true;
+}
+
+void ShaderLibrary::QueueRebuild(ShaderProgramId Id) {
+    Program& Target = Programs[Id];
+    ++Target.Build;
+    ++Reading;
+
+    auto Read = [Desc = Target.Desc, Id, Build = Target.Build, Queue = Ready] {
+        PreparedSources Sources = Prepare(Id, Build, Desc);
+        std::lock_guard Lock(Queue->Mutex);
+        Queue->Finished.push_back(std::move(Sources));
+    };
+    if (Jobs) {
+        Jobs->Submit(std::move(Read));
+    } else {
+        Read();
+    }
+}
+
+ShaderLibrary::PreparedSources ShaderLibrary::Prepare(ShaderProgramId Id, uint32_t Build, const ShaderProgramDesc& Desc) {
+    PreparedSources Sources;
+    Sources.Id = Id;
+    Sources.Build = Build;
+    if (!Desc.ComputePath.empty()) {
+        Sources.Succeeded = Preprocess(Desc.ComputePath, {}, Desc.Defines, Sources.Compute, Sources.Dependencies);
+        return Sources;
+    }
+    Sources.Succeeded =
+        Preprocess(Desc.VertexPath, Desc.VertexHeader, Desc.Defines, Sources.Vertex, Sources.Dependencies) &&
+        Preprocess(Desc.FragmentPath, Desc.FragmentHeader, Desc.Defines, Sources.Fragment, Sources.Dependencies);
+    return Sources;
+}
+
+ShaderLibrary::PendingProgram ShaderLibrary::Compile(const PreparedSources& Sources) {
+    PendingProgram Pending;
+    Pending.Id = Sources.Id;
+    Pending.Build = Sources.Build;
+    Pending.Program = glCreateProgram();
+
+    const auto CompileStage = [&Pending](GLenum Stage, const std::string& Source) {
+        const char* Text = Source.c_str();
+        const unsigned int Handle = glCreateShader(Stage);
+        glShaderSource(Handle, 1, &Text, nullptr);
+        glCompileShader(Handle);
+        glAttachShader(Pending.Program, Handle);
+        return Handle;
+    };
+    if (!Sources.Compute.empty()) {
+        Pending.ComputeShader = CompileStage(GL_COMPUTE_SHADER, Sources.Compute);
+    } else {
+        Pending.VertexShader = CompileStage(GL_VERTEX_SHADER, Sources.Vertex);
+        Pending.FragmentShader = CompileStage(GL_FRAGMENT_SHADER, Sources.Fragment);
+    }
+
+    // Linking straight away lets a parallel-compiling driver carry on through the link too
+    glLinkProgram(Pending.Program);
+    return Pending;
+}
+
+void ShaderLibrary::StartCompile(PreparedSources& Sources) {
+    Compiling.push_back(Compile(Sources));
+}
+
+void ShaderLibrary::CompileOnWorker(PreparedSources Sources) {
+    ++Offloaded;
+    auto Shared = std::make_shared<PreparedSources>(std::move(Sources));
+    auto Pending = std::make_shared<PendingProgram>();
+    Uploader->Submit(
+        [Shared, Pending] {
+            *Pending = Compile(*Shared);
+            // Blocks the worker rather than the frame until the link is done
+            GLint Linked = GL_FALSE;
+            glGetProgramiv(Pending->Program, GL_LINK_STATUS, &Linked);
+        },
+        [this, Pending] {
+            --Offloaded;
+            CountReload(Pending->Id, FinishCompile(*Pending, true));
+        });
+}
+
+ShaderLibrary::CompileStatus ShaderLibrary::FinishCompile(PendingProgram& Pending, bool Wait) {
+    if (!Wait) {
+        GLint Completed = GL_FALSE;
+        glGetProgramiv(Pending.Program, GL_COMPLETION_STATUS_KHR, &Completed);
+        if (!Completed) { return CompileStatus::Compiling; }
+    }
+
+    Program& Target = Programs[Pending.Id];
+    const bool Superseded = Pending.Build != Target.Build;
+    GLint Linked = GL_FALSE;
+    if (!Superseded) {
+        glGetProgramiv(Pending.Program, GL_LINK_STATUS, &Linked);
+        if (!Linked) {
+            PrintShaderLog(Pending.VertexShader, "VERTEX", Target.Desc.VertexPath);
+            PrintShaderLog(Pending.FragmentShader, "FRAGMENT", Target.Desc.FragmentPath);
+            PrintShaderLog(Pending.ComputeShader, "COMPUTE", Target.Desc.ComputePath);
+            GLint Length = 0;
+            glGetProgramiv(Pending.Program, GL_INFO_LOG_LENGTH, &Length);
+            std::string Log(static_cast<size_t>(std::max(Length, 1)), '\0');
+            glGetProgramInfoLog(Pending.Program, Length, nullptr, Log.data());
+            std::cerr << "ERROR::SHADER_LIBRARY::PROGRAM::LINKING_FAILED: " << Log.c_str() << std::endl;
+        }
+    }
+
+    for (const unsigned int Stage : {Pending.VertexShader, Pending.FragmentShader, Pending.ComputeShader}) {
+        if (Stage == 0) { continue; }
+        glDetachShader(Pending.Program, Stage);
+        glDeleteShader(Stage);
+    }
+    if (Superseded || !Linked) {
+        glDeleteProgram(Pending.Program);
+        return Superseded ? CompileStatus::Superseded : CompileStatus::Failed;
+    }
+
+    // Draws already queued with the old program keep it alive in the driver until they finish
+    if (Pending.ComputeShader != 0) {
+        Target.CurrentCompute = std::make_unique<ComputeProgram>(Pending.Program);
+    } else {
+        Target.Current = std::make_unique<Shader>(Pending.Program);
+    }
+    ++Target.Version;
+    return CompileStatus::Succeeded;
+}
+
+void ShaderLibrary::CountReload(ShaderProgramId Id, CompileStatus Status) {
+    if (Status == CompileStatus::Succeeded) { ++Stats.ReloadCount; }
+    if (Status == CompileStatus::Failed) {
+        const Program& Target = Programs[Id];
+        std::cerr << "ERROR::SHADER_LIBRARY::RELOAD_FAILED: " << DescribeProgram(Target.Desc)
+                  << " (keeping the previous program)" << std::endl;
+        ++Stats.FailedReloadCount;
+    }
+}
+
+void ShaderLibrary::SetDependencies(ShaderProgramId Id, std::vector<std::string> Dependencies) {
+    std::sort(Dependencies.begin(), Dependencies.end());
+    Dependencies.erase(std::unique(Dependencies.begin(), Dependencies.end()), Dependencies.end());
+
+    Program& Target = Programs[Id];
+    for (const std::string& File : Target.Dependencies) {
+        std::vector<ShaderProgramId>& Ids = Dependents[File];
+        Ids.erase(std::remove(Ids.begin(), Ids.end(), Id), Ids.end());
+        if (Ids.empty() && !std::binary_search(Dependencies.begin(), Dependencies.end(), File)) {
+            Dependents.erase(File);
+            if (Watcher) { Watcher->Unwatch(File); }
+        }
+    }
+    for (const std::string& File : Dependencies) {
+        std::vector<ShaderProgramId>& Ids = Dependents[File];
+        if (Ids.empty() && Watcher) { Watcher->Watch(File); }
+        Ids.push_back(Id);
+    }
+    Target.Dependencies = std::move(Dependencies);
+}
+
+} // namespace Volante
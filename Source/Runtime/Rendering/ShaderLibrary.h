@@ -0,0 +1,188 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Engine.h"
+
+namespace Volante {
+
+class Shader;
+class ComputeProgram;
+class JobSystem;
+class FileWatcher;
+class UploadContext;
+
+using ShaderProgramId = uint32_t;
+constexpr ShaderProgramId InvalidShaderProgramId = ~0u;
+
+// A program built from a vertex and a fragment shader file, or from a compute shader file
+// alone. Loading the same files with different Defines makes a separate permutation; each is
+// rebuilt on its own when a file it reads changes.
+struct ShaderProgramDesc {
+    std::string VertexPath;
+    std::string FragmentPath;
+    // "NAME" or "NAME VALUE", inserted as #define lines after #version
+    std::vector<std::string> Defines;
+    // Put first in each stage, ahead of the defines: the #version line, extensions and source
+    // generated at runtime. A file read with a header has no #version of its own.
+    std::string VertexHeader;
+    std::string FragmentHeader;
+    // Set instead of the stage paths and headers for a compute program; Defines still apply
+    std::string ComputePath;
+};
+
+// A program as one user of it sees it: the version it last set up per-program state for
+// (sampler units, block bindings), which a reload leaves behind.
+struct ShaderProgramHandle {
+    ShaderProgramId Id = InvalidShaderProgramId;
+    uint32_t Version = 0;
+};
+
+struct ShaderLibraryStats {
+    uint32_t ProgramCount = 0;
+    // Rebuilds read or compiling, not yet swapped in
+    uint32_t PendingCount = 0;
+    uint32_t ReloadCount = 0;
+    uint32_t FailedReloadCount = 0;
+};
+
+// Loads shader programs from files and rebuilds them when those files, or any file they
+// #include, are saved.
+//
+// A change is picked up by Update(): the affected programs' sources are re-read and
+// preprocessed on the job system, and compiled on the next Update. With
+// KHR_parallel_shader_compile the driver compiles in the background and later Updates only
+// poll for completion. Without it the compile and link run on an upload context's worker
+// (SetUploadContext), and the program is swapped in from the completion once it has linked;
+// with no worker either, they run inline, one frame's worth at a time. A program that built is
+// swapped in whole between frames, so Get() never returns a half-built program; one that fails
+// prints its log and the previous program stays in use.
+class ShaderLibrary : public IEngineSubsystem {
+public:
+    explicit ShaderLibrary(JobSystem* Jobs = nullptr);
+    ~ShaderLibrary() override;
+
+    ShaderLibrary(const ShaderLibrary&) = delete;
+    ShaderLibrary& operator=(const ShaderLibrary&) = delete;
+
+    void Initialize() override;
+    void Shutdown() override;
+    // Applies finished rebuilds and starts new ones. Call between frames, with the context current.
+    void Update(float DeltaTime) override;
+
+    // Compiles reloads on Context's worker when the driver cannot compile in parallel; null
+    // compiles them in Update. Context must be polled on this thread, and outlive this library
+    // or be unset first.
+    void SetUploadContext(UploadContext* Context) { Uploader = Context; }
+
+    // Builds the program now. A program whose first build fails still gets an id, and Get()
+    // returns null for it until a reload succeeds.
+    ShaderProgramId Load(const ShaderProgramDesc& Desc);
+    // Load() of a compute program from the one file.
+    ShaderProgramId LoadCompute(const std::string& Path);
+
+    // Destroys the program and stops watching its files. The id is not reused; Get() returns
+    // null for it from now on.
+    void Unload(ShaderProgramId Id);
+
+    // The program swapped in by the last Update. Look it up each frame rather than keeping the
+    // pointer: a reload destroys the previous Shader.
+    [[nodiscard]] const Shader* Get(ShaderProgramId Id) const;
+
+    // Get() for a program loaded with a ComputePath.
+    [[nodiscard]] const ComputeProgram* GetCompute(ShaderProgramId Id) const;
+
+    // Bumped every time the program is swapped; uniform locations cached against an older
+    // version are stale.
+    [[nodiscard]] uint32_t GetVersion(ShaderProgramId Id) const;
+
+    // True once per swap of Handle's program, bringing Handle up to date; the caller then sets
+    // up again whatever it had set on the previous program.
+    bool Refresh(ShaderProgramHandle& Handle) const;
+
+    [[nodiscard]] const ShaderLibraryStats& GetStats() const { return Stats; }
+
+    // Where the engine's GLSL files are: Shaders/ in the source tree when the build enabled
+    // VOLANTE_SHADER_HOT_RELOAD and that tree is still there, so edits to the checked-in files
+    // reload; otherwise the copy the build puts next to the executable.
+    [[nodiscard]] static const std::string& GetShaderDirectory();
+
+    // Reads Path, expanding #include "file" (relative to the including file) and inserting
+    // Defines after the #version line, or after Header when there is one. Every file read is
+    // appended to Dependencies.
+    static bool Preprocess(const std::string& Path, const std::string& Header, const std::vector<std::string>& Defines,
+                           std::string& Out, std::vector<std::string>& Dependencies);
+
+private:
+    // Sources read by a job, waiting for the GL thread
+    struct PreparedSources {
+        ShaderProgramId Id = InvalidShaderProgramId;
+        uint32_t Build = 0;
+        std::string Vertex;
+        std::string Fragment;
+        std::string Compute;
+        std::vector<std::string> Dependencies;
+        bool Succeeded = false;
+    };
+
+    // A program the driver is still compiling
+    struct PendingProgram {
+        ShaderProgramId Id = InvalidShaderProgramId;
+        uint32_t Build = 0;
+        unsigned int Program = 0;
+        unsigned int VertexShader = 0;
+        unsigned int FragmentShader = 0;
+        unsigned int ComputeShader = 0;
+    };
+
+    enum class CompileStatus {
+        Compiling,
+        Succeeded,
+        Failed,
+        // A newer rebuild was requested meanwhile; this result was dropped
+        Superseded,
+    };
+
+    struct Program {
+        ShaderProgramDesc Desc;
+        std::unique_ptr<Shader> Current;
+        std::unique_ptr<ComputeProgram> CurrentCompute;
+        std::vector<std::string> Dependencies;
+        uint32_t Version = 0;
+        // Bumped per requested rebuild, so a slower, older rebuild never replaces a newer one
+        uint32_t Build = 0;
+    };
+
+    struct ReadyQueue;
+
+    void QueueRebuild(ShaderProgramId Id);
+    [[nodiscard]] static PreparedSources Prepare(ShaderProgramId Id, uint32_t Build, const ShaderProgramDesc& Desc);
+    // Issues the compiles and the link without waiting for them
+    [[nodiscard]] static PendingProgram Compile(const PreparedSources& Sources);
+    void StartCompile(PreparedSources& Sources);
+    void CompileOnWorker(PreparedSources Sources);
+    // Without Wait, returns Compiling while the driver is still busy.
+    CompileStatus FinishCompile(PendingProgram& Pending, bool Wait);
+    void CountReload(ShaderProgramId Id, CompileStatus Status);
+    void SetDependencies(ShaderProgramId Id, std::vector<std::string> Dependencies);
+
+    JobSystem* Jobs;
+    UploadContext* Uploader = nullptr;
+    std::unique_ptr<FileWatcher> Watcher;
+    std::vector<Program> Programs;
+    // Normalized file path -> programs reading it
+    std::unordered_map<std::string, std::vector<ShaderProgramId>> Dependents;
+    std::shared_ptr<ReadyQueue> Ready;
+    std::vector<PendingProgram> Compiling;
+    uint32_t Reading = 0;
+    // Compiling on the upload worker
+    uint32_t Offloaded = 0;
+    bool ParallelCompile = false;
+    ShaderLibraryStats Stats;
+};
+
+} // namespace Volante
@@ -0,0 +1,147 @@
+#include "SoftwareOcclusion.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+
+#include "DepthConvention.h"
+
+namespace Volante {
+
+namespace {
+
+// Clip-space w below this is treated as touching the near plane.
+constexpr float NearW = 1e-5f;
+
+} // namespace
+
+SoftwareOcclusion::SoftwareOcclusion(uint32_t InWidth, uint32_t InHeight)
+    : Width(std::bit_ceil(std::max(InWidth, 1u))), Height(std::bit_ceil(std::max(InHeight, 1u))) {
+    const auto LevelCount = static_cast<uint32_t>(std::bit_width(std::max(Width, Height)));
+    Levels.resize(LevelCount);
+    for (uint32_t Level = 0; Level < LevelCount; ++Level) {
+        Levels[Level].resize(static_cast<size_t>(std::max(Width >> Level, 1u)) * std::max(Height >> Level, 1u));
+    }
+}
+
+void SoftwareOcclusion::Begin(const Mat4& InViewProjection) {
+    ViewProjection = InViewProjection;
+    std::fill(Levels[0].begin(), Levels[0].end(), FarDepth);
+    TriangleCount = 0;
+}
+
+void SoftwareOcclusion::RasterizeMesh(const Mat4& Model, const Vertex* Vertices, const unsigned int* Indices,
+                                      uint32_t IndexCount) {
+    const Mat4 ModelViewProjection = ViewProjection * Model;
+    const Vec2 Scale(static_cast<float>(Width) * 0.5f, static_cast<float>(Height) * 0.5f);
+
+    for (uint32_t i = 0; i + 2 < IndexCount; i += 3) {
+        Vec3 Screen[3];
+        bool Clipped = false;
+        for (int Corner = 0; Corner < 3; ++Corner) {
+            const Vec4 Clip = ModelViewProjection * Vec4(Vertices[Indices[i + Corner]].position, 1.0f);
+            if (Clip.w < NearW || Clip.z > Clip.w) {
+                Clipped = true;
+                break;
+            }
+            const Vec3 Ndc = Vec3(Clip) / Clip.w;
+            Screen[Corner] = Vec3((Ndc.x + 1.0f) * Scale.x, (Ndc.y + 1.0f) * Scale.y, Ndc.z);
+        }
+        if (!Clipped) { RasterizeTriangle(Screen[0], Screen[1], Screen[2]); }
+    }
+}
+
+void SoftwareOcclusion::RasterizeTriangle(const Vec3& A, const Vec3& B, const Vec3& C) {
+    const float Area = (B.x - A.x) * (C.y - A.y) - (B.y - A.y) * (C.x - A.x);
+    if (std::abs(Area) < 1e-8f) { return; }
+    const float InvArea = 1.0f / Area;
+
+    const int MinX = std::max(static_cast<int>(std::floor(std::min({A.x, B.x, C.x}))), 0);
+    const int MaxX = std::min(static_cast<int>(std::ceil(std::max({A.x, B.x, C.x}))), static_cast<int>(Width) - 1);
+    const int MinY = std::max(static_cast<int>(std::floor(std::min({A.y, B.y, C.y}))), 0);
+    const int MaxY = std::min(static_cast<int>(std::ceil(std::max({A.y, B.y, C.y}))), static_cast<int>(Height) - 1);
+    if (MinX > MaxX || MinY > MaxY) { return; }
+    ++TriangleCount;
+
+    std::vector<float>& Depth = Levels[0];
+    for (int Y = MinY; Y <= MaxY; ++Y) {
+        const float PY = static_cast<float>(Y) + 0.5f;
+        for (int X = MinX; X <= MaxX; ++X) {
+            const float PX = static_cast<float>(X) + 0.5f;
+            // Barycentrics from edge functions; normalising by the signed area accepts either winding
+            const float W0 = ((B.x - PX) * (C.y - PY) - (B.y - PY) * (C.x - PX)) * InvArea;
+            const float W1 = ((C.x - PX) * (A.y - PY) - (C.y - PY) * (A.x - PX)) * InvArea;
+            const float W2 = 1.0f - W0 - W1;
+            if (W0 < 0.0f || W1 < 0.0f || W2 < 0.0f) { continue; }
+
+            float& Texel = Depth[static_cast<size_t>(Y) * Width + X];
+            Texel = std::max(Texel, W0 * A.z + W1 * B.z + W2 * C.z);
+        }
+    }
+}
+
+void SoftwareOcclusion::Finish() {
+    for (size_t Level = 1; Level < Levels.size(); ++Level) {
+        const uint32_t SourceWidth = std::max(Width >> (Level - 1), 1u);
+        const uint32_t SourceHeight = std::max(Height >> (Level - 1), 1u);
+        const uint32_t LevelWidth = std::max(Width >> Level, 1u);
+        const uint32_t LevelHeight = std::max(Height >> Level, 1u);
+        const std::vector<float>& Source = Levels[Level - 1];
+        std::vector<float>& Destination = Levels[Level];
+
+        for (uint32_t Y = 0; Y < LevelHeight; ++Y) {
+            const uint32_t Y0 = Y * 2;
+            const uint32_t Y1 = std::min(Y0 + 1, SourceHeight - 1);
+            for (uint32_t X = 0; X < LevelWidth; ++X) {
+                const uint32_t X0 = X * 2;
+                const uint32_t X1 = std::min(X0 + 1, SourceWidth - 1);
+                Destination[static_cast<size_t>(Y) * LevelWidth + X] =
+                    std::min(std::min(Source[Y0 * SourceWidth + X0], Source[Y0 * SourceWidth + X1]),
+                             std::min(Source[Y1 * SourceWidth + X0], Source[Y1 * SourceWidth + X1]));
+            }
+        }
+    }
+}
+
+bool SoftwareOcclusion::IsOccluded(const AABB& Bounds) const {
+    Vec3 Min(std::numeric_limits<float>::max());
+    Vec3 Max(-std::numeric_limits<float>::max());
+    for (int Corner = 0; Corner < 8; ++Corner) {
+        const Vec3 Point((Corner & 1) ? Bounds.Max.x : Bounds.Min.x, (Corner & 2) ? Bounds.Max.y : Bounds.Min.y,
+                         (Corner & 4) ? Bounds.Max.z : Bounds.Min.z);
+        const Vec4 Clip = ViewProjection * Vec4(Point, 1.0f);
+        if (Clip.w < NearW) { return false; }
+        const Vec3 Ndc = Vec3(Clip) / Clip.w;
+        Min = glm::min(Min, Ndc);
+        Max = glm::max(Max, Ndc);
+    }
+
+    // Pixel rectangle, grown by one texel because occluder edges were sampled at pixel centres
+    const float ScaleX = static_cast<float>(Width) * 0.5f;
+    const float ScaleY = static_cast<float>(Height) * 0.5f;
+    const int X0 = std::max(static_cast<int>(std::floor((Min.x + 1.0f) * ScaleX)) - 1, 0);
+    const int X1 = std::min(static_cast<int>(std::floor((Max.x + 1.0f) * ScaleX)) + 1, static_cast<int>(Width) - 1);
+    const int Y0 = std::max(static_cast<int>(std::floor((Min.y + 1.0f) * ScaleY)) - 1, 0);
+    const int Y1 = std::min(static_cast<int>(std::floor((Max.y + 1.0f) * ScaleY)) + 1, static_cast<int>(Height) - 1);
+    if (X0 > X1 || Y0 > Y1) { return false; }
+
+    // The level at which the rectangle spans at most two texels per axis
+    const auto Extent = static_cast<uint32_t>(std::max(X1 - X0, Y1 - Y0) + 1);
+    const uint32_t Level = std::min(static_cast<uint32_t>(std::bit_width(Extent - 1)), static_cast<uint32_t>(Levels.size() - 1));
+
+    float FarthestOccluder = NearDepth;
+    for (int Y = Y0 >> Level; Y <= (Y1 >> Level); ++Y) {
+        for (int X = X0 >> Level; X <= (X1 >> Level); ++X) {
+            FarthestOccluder = std::min(FarthestOccluder, SampleLevel(Level, X, Y));
+        }
+    }
+    return Max.z < FarthestOccluder;
+}
+
+float SoftwareOcclusion::SampleLevel(uint32_t Level, int X, int Y) const {
+    const uint32_t LevelWidth = std::max(Width >> Level, 1u);
+    return Levels[Level][static_cast<size_t>(Y) * LevelWidth + static_cast<size_t>(X)];
+}
+
+} // namespace Volante
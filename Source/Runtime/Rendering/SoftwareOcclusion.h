@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Mesh.h"
+#include "Runtime/Core/Math/Bounds.h"
+
+namespace Volante {
+
+// CPU occlusion culling for the fallback path: designated occluder meshes are rasterized into a
+// small depth buffer for the current view, reduced into a farthest-depth pyramid, and bounds are
+// tested against it. No GPU round trip, so there is no frame of latency, but only occluders
+// contribute: pick large, cheap geometry (walls, terrain blocks, building shells).
+class SoftwareOcclusion {
+public:
+    explicit SoftwareOcclusion(uint32_t Width = 256, uint32_t Height = 128);
+
+    void Begin(const Mat4& ViewProjection);
+
+    // Triangles crossing the near plane are skipped, which can only lose occlusion, never
+    // hide something visible.
+    void RasterizeMesh(const Mat4& Model, const Vertex* Vertices, const unsigned int* Indices, uint32_t IndexCount);
+
+    // Builds the pyramid; call after the last occluder and before testing.
+    void Finish();
+
+    // Safe to call concurrently after Finish.
+    [[nodiscard]] bool IsOccluded(const AABB& Bounds) const;
+
+    [[nodiscard]] uint32_t GetRasterizedTriangleCount() const { return TriangleCount; }
+
+private:
+    void RasterizeTriangle(const Vec3& A, const Vec3& B, const Vec3& C);
+    [[nodiscard]] float SampleLevel(uint32_t Level, int X, int Y) const;
+
+    uint32_t Width;
+    uint32_t Height;
+    Mat4 ViewProjection = Mat4(1.0f);
+
+    // Level 0 is the rasterized clip depth (reverse-Z, so nearer is larger); level L + 1 is the
+    // min of 2x2 texels of level L.
+    std::vector<std::vector<float>> Levels;
+    uint32_t TriangleCount = 0;
+};
+
+} // namespace Volante
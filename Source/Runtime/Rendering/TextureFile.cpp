@@ -0,0 +1,275 @@
+#include "TextureFile.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace Volante {
+
+namespace {
+
+constexpr uint8_t KTX2Identifier[12] = {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+constexpr size_t KTX2HeaderSize = 80;
+constexpr size_t KTX2LevelEntrySize = 24;
+
+constexpr size_t DDSHeaderSize = 128;
+constexpr size_t DDSDX10HeaderSize = 20;
+constexpr uint32_t DDSMipMapCountFlag = 0x20000;
+constexpr uint32_t DDSFourCCFlag = 0x4;
+constexpr uint32_t DDSRGBFlag = 0x40;
+constexpr uint32_t DDSCubeMapFlag = 0x200;
+constexpr uint32_t DDSVolumeFlag = 0x200000;
+constexpr uint32_t DXGIResourceTexture2D = 3;
+constexpr uint32_t DXGITextureCubeFlag = 0x4;
+
+// Every level has to fit in GL's limits anyway; this just bounds what a corrupt file can ask for.
+constexpr uint32_t MaxLevels = 16;
+
+uint32_t ReadU32(const uint8_t* Bytes) {
+    return static_cast<uint32_t>(Bytes[0]) | static_cast<uint32_t>(Bytes[1]) << 8 |
+           static_cast<uint32_t>(Bytes[2]) << 16 | static_cast<uint32_t>(Bytes[3]) << 24;
+}
+
+uint64_t ReadU64(const uint8_t* Bytes) {
+    return static_cast<uint64_t>(ReadU32(Bytes)) | static_cast<uint64_t>(ReadU32(Bytes + 4)) << 32;
+}
+
+constexpr uint32_t FourCC(char A, char B, char C, char D) {
+    return static_cast<uint32_t>(A) | static_cast<uint32_t>(B) << 8 | static_cast<uint32_t>(C) << 16 |
+           static_cast<uint32_t>(D) << 24;
+}
+
+TextureFormat FromVkFormat(uint32_t VkFormat) {
+    switch (VkFormat) {
+    case 37: return TextureFormat::RGBA8;
+    case 43: return TextureFormat::RGBA8Srgb;
+    case 131: return TextureFormat::BC1;
+    case 132: return TextureFormat::BC1Srgb;
+    case 133: return TextureFormat::BC1Alpha;
+    case 134: return TextureFormat::BC1AlphaSrgb;
+    case 135: return TextureFormat::BC2;
+    case 136: return TextureFormat::BC2Srgb;
+    case 137: return TextureFormat::BC3;
+    case 138: return TextureFormat::BC3Srgb;
+    case 139: return TextureFormat::BC4;
+    case 140: return TextureFormat::BC4Signed;
+    case 141: return TextureFormat::BC5;
+    case 142: return TextureFormat::BC5Signed;
+    case 143: return TextureFormat::BC6H;
+    case 144: return TextureFormat::BC6HSigned;
+    case 145: return TextureFormat::BC7;
+    case 146: return TextureFormat::BC7Srgb;
+    case 147: return TextureFormat::ETC2RGB;
+    case 148: return TextureFormat::ETC2RGBSrgb;
+    case 149: return TextureFormat::ETC2RGBA1;
+    case 150: return TextureFormat::ETC2RGBA1Srgb;
+    case 151: return TextureFormat::ETC2RGBA;
+    case 152: return TextureFormat::ETC2RGBASrgb;
+    case 153: return TextureFormat::EACR11;
+    case 154: return TextureFormat::EACR11Signed;
+    case 155: return TextureFormat::EACRG11;
+    case 156: return TextureFormat::EACRG11Signed;
+    default: return TextureFormat::Unknown;
+    }
+}
+
+TextureFormat FromDXGIFormat(uint32_t DXGIFormat) {
+    switch (DXGIFormat) {
+    case 28: return TextureFormat::RGBA8;
+    case 29: return TextureFormat::RGBA8Srgb;
+    case 71: return TextureFormat::BC1Alpha;
+    case 72: return TextureFormat::BC1AlphaSrgb;
+    case 74: return TextureFormat::BC2;
+    case 75: return TextureFormat::BC2Srgb;
+    case 77: return TextureFormat::BC3;
+    case 78: return TextureFormat::BC3Srgb;
+    case 80: return TextureFormat::BC4;
+    case 81: return TextureFormat::BC4Signed;
+    case 83: return TextureFormat::BC5;
+    case 84: return TextureFormat::BC5Signed;
+    case 95: return TextureFormat::BC6H;
+    case 96: return TextureFormat::BC6HSigned;
+    case 98: return TextureFormat::BC7;
+    case 99: return TextureFormat::BC7Srgb;
+    default: return TextureFormat::Unknown;
+    }
+}
+
+// Legacy DDS pixel formats: the FourCC codes for BC1-5 and 32-bit RGBA masks.
+TextureFormat FromDDSPixelFormat(const uint8_t* PixelFormat) {
+    const uint32_t Flags = ReadU32(PixelFormat + 4);
+    if (Flags & DDSFourCCFlag) {
+        switch (ReadU32(PixelFormat + 8)) {
+        case FourCC('D', 'X', 'T', '1'): return TextureFormat::BC1Alpha;
+        case FourCC('D', 'X', 'T', '3'): return TextureFormat::BC2;
+        case FourCC('D', 'X', 'T', '5'): return TextureFormat::BC3;
+        case FourCC('A', 'T', 'I', '1'):
+        case FourCC('B', 'C', '4', 'U'): return TextureFormat::BC4;
+        case FourCC('B', 'C', '4', 'S'): return TextureFormat::BC4Signed;
+        case FourCC('A', 'T', 'I', '2'):
+        case FourCC('B', 'C', '5', 'U'): return TextureFormat::BC5;
+        case FourCC('B', 'C', '5', 'S'): return TextureFormat::BC5Signed;
+        default: return TextureFormat::Unknown;
+        }
+    }
+    if ((Flags & DDSRGBFlag) && ReadU32(PixelFormat + 12) == 32 && ReadU32(PixelFormat + 16) == 0x000000FF &&
+        ReadU32(PixelFormat + 20) == 0x0000FF00 && ReadU32(PixelFormat + 24) == 0x00FF0000) {
+        return TextureFormat::RGBA8;
+    }
+    return TextureFormat::Unknown;
+}
+
+bool Fail(const std::string& Path, const char* Reason) {
+    std::cerr << "ERROR::TEXTURE::" << Reason << ": " << Path << std::endl;
+    return false;
+}
+
+bool ReadBytes(std::ifstream& File, uint64_t Offset, void* Destination, uint64_t Size) {
+    File.seekg(static_cast<std::streamoff>(Offset));
+    File.read(static_cast<char*>(Destination), static_cast<std::streamsize>(Size));
+    return static_cast<bool>(File);
+}
+
+uint64_t GetFileSize(std::ifstream& File) {
+    File.seekg(0, std::ios::end);
+    return static_cast<uint64_t>(File.tellg());
+}
+
+bool ReadKTX2(std::ifstream& File, TextureFile& Out) {
+    uint8_t Header[KTX2HeaderSize];
+    if (!ReadBytes(File, 0, Header, sizeof(Header))) { return Fail(Out.Path, "KTX2_TRUNCATED"); }
+
+    Out.Format = FromVkFormat(ReadU32(Header + 12));
+    Out.Width = ReadU32(Header + 20);
+    Out.Height = ReadU32(Header + 24);
+    const uint32_t Depth = ReadU32(Header + 28);
+    Out.LayerCount = std::max(ReadU32(Header + 32), 1u);
+    const uint32_t FaceCount = ReadU32(Header + 36);
+    // Zero asks the loader to generate mips, which would mean decoding; take the base level only
+    const uint32_t LevelCount = std::max(ReadU32(Header + 40), 1u);
+    const uint32_t Supercompression = ReadU32(Header + 44);
+
+    if (Out.Format == TextureFormat::Unknown) { return Fail(Out.Path, "KTX2_UNSUPPORTED_FORMAT"); }
+    if (Depth > 1 || FaceCount != 1) { return Fail(Out.Path, "KTX2_NOT_2D"); }
+    if (Supercompression != 0) { return Fail(Out.Path, "KTX2_SUPERCOMPRESSED"); }
+    if (LevelCount > MaxLevels) { return Fail(Out.Path, "KTX2_TOO_MANY_LEVELS"); }
+
+    std::vector<uint8_t> Index(LevelCount * KTX2LevelEntrySize);
+    if (!ReadBytes(File, KTX2HeaderSize, Index.data(), Index.size())) { return Fail(Out.Path, "KTX2_TRUNCATED"); }
+
+    const uint64_t FileSize = GetFileSize(File);
+    for (uint32_t Level = 0; Level < LevelCount; ++Level) {
+        TextureFileLevel Entry;
+        Entry.Width = std::max(Out.Width >> Level, 1u);
+        Entry.Height = std::max(Out.Height >> Level, 1u);
+        Entry.Offset = ReadU64(Index.data() + Level * KTX2LevelEntrySize);
+        Entry.LayerSize = GetTextureImageSize(Out.Format, Entry.Width, Entry.Height);
+        Entry.LayerStride = Entry.LayerSize;
+        const uint64_t ByteLength = ReadU64(Index.data() + Level * KTX2LevelEntrySize + 8);
+        if (ByteLength < Entry.LayerSize * Out.LayerCount) { return Fail(Out.Path, "KTX2_LEVEL_SIZE"); }
+        // Checked here, so a cut-off file fails to open rather than partway through the upload
+        if (ByteLength > FileSize || Entry.Offset > FileSize - ByteLength) { return Fail(Out.Path, "KTX2_TRUNCATED"); }
+        Out.Levels.push_back(Entry);
+    }
+    return true;
+}
+
+bool ReadDDS(std::ifstream& File, TextureFile& Out) {
+    uint8_t Header[DDSHeaderSize];
+    if (!ReadBytes(File, 0, Header, sizeof(Header))) { return Fail(Out.Path, "DDS_TRUNCATED"); }
+
+    const uint32_t Flags = ReadU32(Header + 8);
+    Out.Height = ReadU32(Header + 12);
+    Out.Width = ReadU32(Header + 16);
+    const uint32_t LevelCount = (Flags & DDSMipMapCountFlag) ? std::max(ReadU32(Header + 28), 1u) : 1u;
+    const uint32_t Caps2 = ReadU32(Header + 112);
+    if (Caps2 & (DDSCubeMapFlag | DDSVolumeFlag)) { return Fail(Out.Path, "DDS_NOT_2D"); }
+    if (LevelCount > MaxLevels) { return Fail(Out.Path, "DDS_TOO_MANY_LEVELS"); }
+
+    uint64_t DataOffset = DDSHeaderSize;
+    const uint8_t* PixelFormat = Header + 76;
+    if ((ReadU32(PixelFormat + 4) & DDSFourCCFlag) && ReadU32(PixelFormat + 8) == FourCC('D', 'X', '1', '0')) {
+        uint8_t Extension[DDSDX10HeaderSize];
+        if (!ReadBytes(File, DDSHeaderSize, Extension, sizeof(Extension))) { return Fail(Out.Path, "DDS_TRUNCATED"); }
+        Out.Format = FromDXGIFormat(ReadU32(Extension));
+        if (ReadU32(Extension + 4) != DXGIResourceTexture2D || (ReadU32(Extension + 8) & DXGITextureCubeFlag)) {
+            return Fail(Out.Path, "DDS_NOT_2D");
+        }
+        Out.LayerCount = std::max(ReadU32(Extension + 12), 1u);
+        DataOffset += DDSDX10HeaderSize;
+    } else {
+        Out.Format = FromDDSPixelFormat(PixelFormat);
+    }
+    if (Out.Format == TextureFormat::Unknown) { return Fail(Out.Path, "DDS_UNSUPPORTED_FORMAT"); }
+
+    uint64_t ChainSize = 0;
+    for (uint32_t Level = 0; Level < LevelCount; ++Level) {
+        TextureFileLevel Entry;
+        Entry.Width = std::max(Out.Width >> Level, 1u);
+        Entry.Height = std::max(Out.Height >> Level, 1u);
+        Entry.Offset = DataOffset + ChainSize;
+        Entry.LayerSize = GetTextureImageSize(Out.Format, Entry.Width, Entry.Height);
+        ChainSize += Entry.LayerSize;
+        Out.Levels.push_back(Entry);
+    }
+    for (TextureFileLevel& Entry : Out.Levels) {
+        Entry.LayerStride = ChainSize;
+    }
+    if (GetFileSize(File) < DataOffset + ChainSize * Out.LayerCount) { return Fail(Out.Path, "DDS_TRUNCATED"); }
+    return true;
+}
+
+} // namespace
+
+bool TextureFile::ReadHeader(const std::string& Path, TextureFile& Out) {
+    Out = TextureFile();
+    Out.Path = Path;
+
+    std::ifstream File(Path, std::ios::binary);
+    if (!File) { return Fail(Path, "FILE_NOT_FOUND"); }
+
+    uint8_t Magic[12] = {};
+    if (!ReadBytes(File, 0, Magic, sizeof(Magic))) { return Fail(Path, "UNKNOWN_CONTAINER"); }
+
+    bool Parsed;
+    if (std::memcmp(Magic, KTX2Identifier, sizeof(KTX2Identifier)) == 0) {
+        Parsed = ReadKTX2(File, Out);
+    } else if (ReadU32(Magic) == FourCC('D', 'D', 'S', ' ')) {
+        Parsed = ReadDDS(File, Out);
+    } else {
+        return Fail(Path, "UNKNOWN_CONTAINER");
+    }
+    if (Parsed && (Out.Width == 0 || Out.Height == 0)) { return Fail(Path, "EMPTY_IMAGE"); }
+    return Parsed;
+}
+
+bool TextureFile::ReadLevels(uint32_t FirstLevel, uint32_t EndLevel, std::vector<uint8_t>& Out) const {
+    std::ifstream File(Path, std::ios::binary);
+    if (!File) { return Fail(Path, "FILE_NOT_FOUND"); }
+
+    uint64_t Size = 0;
+    for (uint32_t Level = FirstLevel; Level < EndLevel; ++Level) {
+        Size += GetLevelSize(Level);
+    }
+    Out.resize(Size);
+
+    uint8_t* Destination = Out.data();
+    for (uint32_t Level = FirstLevel; Level < EndLevel; ++Level) {
+        const TextureFileLevel& Entry = Levels[Level];
+        if (Entry.LayerStride == Entry.LayerSize) {
+            if (!ReadBytes(File, Entry.Offset, Destination, GetLevelSize(Level))) { return Fail(Path, "READ_FAILED"); }
+            Destination += GetLevelSize(Level);
+            continue;
+        }
+        for (uint32_t Layer = 0; Layer < LayerCount; ++Layer) {
+            if (!ReadBytes(File, Entry.Offset + Layer * Entry.LayerStride, Destination, Entry.LayerSize)) {
+                return Fail(Path, "READ_FAILED");
+            }
+            Destination += Entry.LayerSize;
+        }
+    }
+    return true;
+}
+
+} // namespace Volante
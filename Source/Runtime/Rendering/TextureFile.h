@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "TextureFormat.h"
+
+namespace Volante {
+
+// Where one mip level sits in the file. KTX2 stores a level's layers back to back; DDS stores
+// each layer's whole mip chain in turn, so there the layers of a level are LayerStride apart.
+struct TextureFileLevel {
+    uint32_t Width = 0;
+    uint32_t Height = 0;
+    uint64_t Offset = 0;
+    uint64_t LayerSize = 0;
+    uint64_t LayerStride = 0;
+};
+
+// Header and level index of a KTX2 or DDS file (2D textures and 2D arrays). Only the index is
+// read up front; level data is read on demand so mips can be streamed.
+struct TextureFile {
+    std::string Path;
+    TextureFormat Format = TextureFormat::Unknown;
+    uint32_t Width = 0;
+    uint32_t Height = 0;
+    uint32_t LayerCount = 1;
+    // Level 0 is the full-resolution image
+    std::vector<TextureFileLevel> Levels;
+
+    // Parses the header of Path, picking the container from its magic bytes. Prints the reason
+    // and returns false for anything unsupported (cube maps, volumes, supercompressed KTX2,
+    // formats without a GL equivalent).
+    static bool ReadHeader(const std::string& Path, TextureFile& Out);
+
+    // Reads levels [FirstLevel, EndLevel) into Out, each level with all its layers contiguous
+    // (the layout glCompressedTexImage3D expects), finer levels first.
+    bool ReadLevels(uint32_t FirstLevel, uint32_t EndLevel, std::vector<uint8_t>& Out) const;
+
+    [[nodiscard]] uint32_t GetLevelCount() const { return static_cast<uint32_t>(Levels.size()); }
+
+    // All layers of one level
+    [[nodiscard]] uint64_t GetLevelSize(uint32_t Level) const { return Levels[Level].LayerSize * LayerCount; }
+};
+
+} // namespace Volante
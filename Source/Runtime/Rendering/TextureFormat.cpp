@@ -0,0 +1,50 @@
+#include "TextureFormat.h"
+
+#include <cstddef>
+
+namespace Volante {
+
+const TextureFormatInfo& GetTextureFormatInfo(TextureFormat Format) {
+    static const TextureFormatInfo Infos[] = {
+        {"Unknown", 1, 0},
+        {"RGBA8", 1, 4},
+        {"RGBA8 sRGB", 1, 4},
+        {"BC1", 4, 8},
+        {"BC1 sRGB", 4, 8},
+        {"BC1 alpha", 4, 8},
+        {"BC1 alpha sRGB", 4, 8},
+        {"BC2", 4, 16},
+        {"BC2 sRGB", 4, 16},
+        {"BC3", 4, 16},
+        {"BC3 sRGB", 4, 16},
+        {"BC4", 4, 8},
+        {"BC4 signed", 4, 8},
+        {"BC5", 4, 16},
+        {"BC5 signed", 4, 16},
+        {"BC6H", 4, 16},
+        {"BC6H signed", 4, 16},
+        {"BC7", 4, 16},
+        {"BC7 sRGB", 4, 16},
+        {"ETC2 RGB", 4, 8},
+        {"ETC2 RGB sRGB", 4, 8},
+        {"ETC2 RGBA1", 4, 8},
+        {"ETC2 RGBA1 sRGB", 4, 8},
+        {"ETC2 RGBA", 4, 16},
+        {"ETC2 RGBA sRGB", 4, 16},
+        {"EAC R11", 4, 8},
+        {"EAC R11 signed", 4, 8},
+        {"EAC RG11", 4, 16},
+        {"EAC RG11 signed", 4, 16},
+    };
+    static_assert(sizeof(Infos) / sizeof(Infos[0]) == static_cast<std::size_t>(TextureFormat::EACRG11Signed) + 1);
+    return Infos[static_cast<std::size_t>(Format)];
+}
+
+uint64_t GetTextureImageSize(TextureFormat Format, uint32_t Width, uint32_t Height) {
+    const TextureFormatInfo& Info = GetTextureFormatInfo(Format);
+    const uint64_t BlocksX = (Width + Info.BlockSize - 1) / Info.BlockSize;
+    const uint64_t BlocksY = (Height + Info.BlockSize - 1) / Info.BlockSize;
+    return BlocksX * BlocksY * Info.BytesPerBlock;
+}
+
+} // namespace Volante
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Volante {
+
+// Pixel formats the texture loader hands to GL as-is. Block-compressed data is never decoded on
+// the CPU; a format the context cannot sample is rejected instead.
+enum class TextureFormat : uint8_t {
+    Unknown,
+    RGBA8,
+    RGBA8Srgb,
+    BC1,
+    BC1Srgb,
+    BC1Alpha,
+    BC1AlphaSrgb,
+    BC2,
+    BC2Srgb,
+    BC3,
+    BC3Srgb,
+    BC4,
+    BC4Signed,
+    BC5,
+    BC5Signed,
+    BC6H,
+    BC6HSigned,
+    BC7,
+    BC7Srgb,
+    ETC2RGB,
+    ETC2RGBSrgb,
+    ETC2RGBA1,
+    ETC2RGBA1Srgb,
+    ETC2RGBA,
+    ETC2RGBASrgb,
+    EACR11,
+    EACR11Signed,
+    EACRG11,
+    EACRG11Signed,
+};
+
+struct TextureFormatInfo {
+    const char* Name = "Unknown";
+    // 4 for the block-compressed formats, 1 for plain pixels
+    uint32_t BlockSize = 1;
+    uint32_t BytesPerBlock = 0;
+};
+
+[[nodiscard]] const TextureFormatInfo& GetTextureFormatInfo(TextureFormat Format);
+
+[[nodiscard]] inline bool IsCompressed(TextureFormat Format) { return GetTextureFormatInfo(Format).BlockSize > 1; }
+
+// Bytes of one Width x Height image (one layer of one mip level).
+[[nodiscard]] uint64_t GetTextureImageSize(TextureFormat Format, uint32_t Width, uint32_t Height);
+
+} // namespace Volante
@@ -0,0 +1,562 @@
+#include "TextureStreamer.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <mutex>
+
+#include "GLCapabilities.h"
+#include "Runtime/Core/Async/JobSystem.h"
+#include "UploadContext.h"
+
+// Extension enums that glad only defines when it was generated with the extension
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#define GL_COMPRESSED_RGBA_S3TC_DXT3_EXT 0x83F2
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+#ifndef GL_COMPRESSED_SRGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_SRGB_S3TC_DXT1_EXT 0x8C4C
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT 0x8C4D
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT 0x8C4E
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT 0x8C4F
+#endif
+
+namespace Volante {
+
+namespace {
+
+GLenum GetInternalFormat(TextureFormat Format) {
+    switch (Format) {
+    case TextureFormat::RGBA8: return GL_RGBA8;
+    case TextureFormat::RGBA8Srgb: return GL_SRGB8_ALPHA8;
+    case TextureFormat::BC1: return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+    case TextureFormat::BC1Srgb: return GL_COMPRESSED_SRGB_S3TC_DXT1_EXT;
+    case TextureFormat::BC1Alpha: return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+    case TextureFormat::BC1AlphaSrgb: return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT;
+    case TextureFormat::BC2: return GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;
+    case TextureFormat::BC2Srgb: return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT;
+    case TextureFormat::BC3: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    case TextureFormat::BC3Srgb: return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT;
+    case TextureFormat::BC4: return GL_COMPRESSED_RED_RGTC1;
+    case TextureFormat::BC4Signed: return GL_COMPRESSED_SIGNED_RED_RGTC1;
+    case TextureFormat::BC5: return GL_COMPRESSED_RG_RGTC2;
+    case TextureFormat::BC5Signed: return GL_COMPRESSED_SIGNED_RG_RGTC2;
+    case TextureFormat::BC6H: return GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT;
+    case TextureFormat::BC6HSigned: return GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT;
+    case TextureFormat::BC7: return GL_COMPRESSED_RGBA_BPTC_UNORM;
+    case TextureFormat::BC7Srgb: return GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM;
+    case TextureFormat::ETC2RGB: return GL_COMPRESSED_RGB8_ETC2;
+    case TextureFormat::ETC2RGBSrgb: return GL_COMPRESSED_SRGB8_ETC2;
+    case TextureFormat::ETC2RGBA1: return GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2;
+    case TextureFormat::ETC2RGBA1Srgb: return GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2;
+    case TextureFormat::ETC2RGBA: return GL_COMPRESSED_RGBA8_ETC2_EAC;
+    case TextureFormat::ETC2RGBASrgb: return GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC;
+    case TextureFormat::EACR11: return GL_COMPRESSED_R11_EAC;
+    case TextureFormat::EACR11Signed: return GL_COMPRESSED_SIGNED_R11_EAC;
+    case TextureFormat::EACRG11: return GL_COMPRESSED_RG11_EAC;
+    case TextureFormat::EACRG11Signed: return GL_COMPRESSED_SIGNED_RG11_EAC;
+    default: return GL_NONE;
+    }
+}
+
+bool IsSupported(TextureFormat Format, const GLCapabilities& Caps) {
+    switch (Format) {
+    case TextureFormat::RGBA8:
+    case TextureFormat::RGBA8Srgb:
+    case TextureFormat::BC4:
+    case TextureFormat::BC4Signed:
+    case TextureFormat::BC5:
+    case TextureFormat::BC5Signed:
+        return true;
+    case TextureFormat::BC1:
+    case TextureFormat::BC1Alpha:
+    case TextureFormat::BC2:
+    case TextureFormat::BC3:
+        return Caps.TextureS3TC;
+    case TextureFormat::BC1Srgb:
+    case TextureFormat::BC1AlphaSrgb:
+    case TextureFormat::BC2Srgb:
+    case TextureFormat::BC3Srgb:
+        return Caps.TextureS3TC &&
+               (Caps.HasExtension("GL_EXT_texture_sRGB") || Caps.HasExtension("GL_EXT_texture_compression_s3tc_srgb"));
+    case TextureFormat::BC6H:
+    case TextureFormat::BC6HSigned:
+    case TextureFormat::BC7:
+    case TextureFormat::BC7Srgb:
+        return Caps.TextureBPTC;
+    case TextureFormat::Unknown:
+        return false;
+    default:
+        return Caps.TextureETC2;
+    }
+}
+
+// Defines one level of a 2D texture or of every layer of a 2D array. Pixels may be null.
+void DefineLevel(GLenum Target, const TextureFile& File, uint32_t FileLevel, GLint Level, const void* Pixels) {
+    const GLenum InternalFormat = GetInternalFormat(File.Format);
+    const auto Width = static_cast<GLsizei>(File.Levels[FileLevel].Width);
+    const auto Height = static_cast<GLsizei>(File.Levels[FileLevel].Height);
+    const auto Layers = static_cast<GLsizei>(File.LayerCount);
+    const auto Size = static_cast<GLsizei>(File.GetLevelSize(FileLevel));
+    if (IsCompressed(File.Format)) {
+        if (Target == GL_TEXTURE_2D_ARRAY) {
+            glCompressedTexImage3D(Target, Level, InternalFormat, Width, Height, Layers, 0, Size, Pixels);
+        } else {
+            glCompressedTexImage2D(Target, Level, InternalFormat, Width, Height, 0, Size, Pixels);
+        }
+    } else if (Target == GL_TEXTURE_2D_ARRAY) {
+        glTexImage3D(Target, Level, static_cast<GLint>(InternalFormat), Width, Height, Layers, 0, GL_RGBA, GL_UNSIGNED_BYTE, Pixels);
+    } else {
+        glTexImage2D(Target, Level, static_cast<GLint>(InternalFormat), Width, Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, Pixels);
+    }
+}
+
+// A texture object with levels [FirstLevel, chain end) of File defined; Data holds the levels up
+// to DataEndLevel, the rest are left undefined for copies. Only touches the object it creates,
+// so it can run on the upload context.
+GLuint CreateChain(GLenum Target, const TextureFile& File, uint32_t FirstLevel, const uint8_t* Data, uint32_t DataEndLevel) {
+    const uint32_t LevelCount = File.GetLevelCount();
+
+    GLuint Handle = 0;
+    glGenTextures(1, &Handle);
+    glBindTexture(Target, Handle);
+    glTexParameteri(Target, GL_TEXTURE_BASE_LEVEL, 0);
+    glTexParameteri(Target, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(LevelCount - FirstLevel - 1));
+    glTexParameteri(Target, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(Target, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(Target, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(Target, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+    for (uint32_t Level = FirstLevel; Level < LevelCount; ++Level) {
+        const bool HasData = Level < DataEndLevel;
+        DefineLevel(Target, File, Level, static_cast<GLint>(Level - FirstLevel), HasData ? Data : nullptr);
+        if (HasData) { Data += File.GetLevelSize(Level); }
+    }
+    glBindTexture(Target, 0);
+    return Handle;
+}
+
+} // namespace
+
+// Filled by reads on worker threads, drained by Update(). Shared with the jobs so a read that
+// finishes after Shutdown has somewhere harmless to land.
+struct TextureStreamer::ReadQueue {
+    std::mutex Mutex;
+    std::vector<ReadResult> Finished;
+};
+
+TextureStreamer::TextureStreamer(const TextureStreamerDesc& Desc, JobSystem* Jobs)
+    : Desc(Desc), Jobs(Jobs), Reads(std::make_shared<ReadQueue>()) {}
+
+TextureStreamer::~TextureStreamer() {
+    Shutdown();
+}
+
+bool TextureStreamer::Initialize() {
+    Shutdown();
+
+    const GLCapabilities& Caps = GLCapabilities::Get();
+    Bindless = Caps.BindlessTextures;
+    CopyImage = Caps.CopyImage;
+
+    const uint8_t Grey[4] = {128, 128, 128, 255};
+    glGenTextures(1, &Placeholder);
+    glBindTexture(GL_TEXTURE_2D, Placeholder);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, Grey);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return true;
+}
+
+void TextureStreamer::Shutdown() {
+    // Their completions adopt into Textures, so they land before it is torn down
+    if (Uploader) { Uploader->Flush(); }
+    for (Texture& Target : Textures) {
+        if (Target.Alive) { RetireHandle(Target.Handle, Target.BindlessHandle); }
+    }
+    // Nothing will draw with them any more
+    for (RetiredTexture& Entry : Retired) {
+        glDeleteSync(static_cast<GLsync>(Entry.Fence));
+#if defined(GL_ARB_bindless_texture)
+        glMakeTextureHandleNonResidentARB(Entry.BindlessHandle);
+#endif
+        glDeleteTextures(1, &Entry.Handle);
+    }
+    Retired.clear();
+    if (Placeholder != 0) { glDeleteTextures(1, &Placeholder); }
+    Placeholder = 0;
+
+    Textures.clear();
+    FreeIds.clear();
+    // Reads still in flight finish into the old queue and are dropped with it
+    Reads = std::make_shared<ReadQueue>();
+    ReadyReads.clear();
+    PendingReads = 0;
+    ResidentBytes = PendingBytes = 0;
+}
+
+TextureId TextureStreamer::Load(const std::string& Path) {
+    TextureFile File;
+    if (!TextureFile::ReadHeader(Path, File)) { return InvalidTextureId; }
+    if (!IsSupported(File.Format, GLCapabilities::Get())) {
+        std::cerr << "ERROR::TEXTURE::FORMAT_NOT_SUPPORTED: " << GetTextureFormatInfo(File.Format).Name << " in " << Path
+                  << std::endl;
+        return InvalidTextureId;
+    }
+
+    TextureId Id;
+    if (!FreeIds.empty()) {
+        Id = FreeIds.back();
+        FreeIds.pop_back();
+    } else {
+        Id = static_cast<TextureId>(Textures.size());
+        Textures.emplace_back();
+    }
+
+    Texture& Target = Textures[Id];
+    const uint32_t Generation = Target.Generation;
+    Target = Texture();
+    Target.Generation = Generation;
+    Target.File = std::move(File);
+    Target.Target = Target.File.LayerCount > 1 ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_2D;
+    Target.Alive = true;
+
+    const uint32_t LevelCount = Target.File.GetLevelCount();
+    Target.TailLevel = LevelCount - 1;
+    for (uint32_t Level = 0; Level < LevelCount; ++Level) {
+        const TextureFileLevel& Entry = Target.File.Levels[Level];
+        if (std::max(Entry.Width, Entry.Height) <= Desc.ResidentTailSize) {
+            Target.TailLevel = Level;
+            break;
+        }
+    }
+    Target.ResidentLevel = LevelCount;
+    Target.WantedLevel = Target.TailLevel;
+    Target.LastUsedFrame = FrameNumber;
+
+    // Tails stay outside the budget: they are small and a texture is useless without one
+    QueueRead(Id, Target.TailLevel, LevelCount);
+    return Id;
+}
+
+void TextureStreamer::Release(TextureId Id) {
+    if (Id >= Textures.size() || !Textures[Id].Alive) { return; }
+
+    Texture& Target = Textures[Id];
+    RetireHandle(Target.Handle, Target.BindlessHandle);
+    ResidentBytes -= Target.ResidentBytes;
+    PendingBytes -= Target.PendingBytes;
+    ++Target.Generation;
+    Target.Alive = false;
+    Target.Handle = 0;
+    Target.BindlessHandle = 0;
+    Target.File = TextureFile();
+    FreeIds.push_back(Id);
+    ++HandleGeneration;
+}
+
+void TextureStreamer::ReportUsage(TextureId Id, float ScreenSize) {
+    if (Id >= Textures.size() || !Textures[Id].Alive) { return; }
+
+    Texture& Target = Textures[Id];
+    // The coarsest level that still has a texel per covered pixel
+    const float Ratio = static_cast<float>(Target.File.Width) / std::max(ScreenSize, 1.0f);
+    const auto Level = static_cast<uint32_t>(std::clamp(std::floor(std::log2(std::max(Ratio, 1.0f))), 0.0f,
+                                                        static_cast<float>(Target.TailLevel)));
+    if (Target.LastUsedFrame != FrameNumber) {
+        Target.LastUsedFrame = FrameNumber;
+        Target.WantedLevel = Level;
+    } else {
+        Target.WantedLevel = std::min(Target.WantedLevel, Level);
+    }
+}
+
+float TextureStreamer::EstimateScreenSize(const RenderView& View, const Vec3& Center, float Radius, float ViewportHeight,
+                                          float UVScale) {
+    const float Distance = distance(Center, View.Position);
+    if (Distance <= Radius) { return std::numeric_limits<float>::max(); }
+    // Projected diameter: 2 * Radius * Projection[1][1] / Distance in NDC, which spans 2
+    return Radius * View.Projection[1][1] / Distance * ViewportHeight * UVScale;
+}
+
+void TextureStreamer::Update() {
+    Stats.UploadedBytes = 0;
+    Stats.LevelsStreamedIn = 0;
+    Stats.LevelsEvicted = 0;
+
+    CollectRetired();
+
+    {
+        std::lock_guard Lock(Reads->Mutex);
+        for (ReadResult& Result : Reads->Finished) {
+            ReadyReads.push_back(std::move(Result));
+        }
+        Reads->Finished.clear();
+    }
+
+    // Always at least one, so a level larger than the cap still gets through
+    size_t Applied = 0;
+    while (Applied < ReadyReads.size() && (Applied == 0 || Stats.UploadedBytes < Desc.UploadBytesPerFrame)) {
+        --PendingReads;
+        ApplyRead(ReadyReads[Applied++]);
+    }
+    ReadyReads.erase(ReadyReads.begin(), ReadyReads.begin() + static_cast<ptrdiff_t>(Applied));
+
+    // Textures seen since the last Update that want a finer level than they have; the furthest
+    // behind go first, then the cheapest
+    std::vector<TextureId> Candidates;
+    for (TextureId Id = 0; Id < Textures.size(); ++Id) {
+        const Texture& Target = Textures[Id];
+        if (!Target.Alive || Target.PendingRead || Target.ReadFailed || Target.ResidentLevel > Target.TailLevel) {
+            continue;
+        }
+        if (Target.LastUsedFrame == FrameNumber && Target.WantedLevel < Target.ResidentLevel) { Candidates.push_back(Id); }
+    }
+    std::sort(Candidates.begin(), Candidates.end(), [this](TextureId A, TextureId B) {
+        const Texture& First = Textures[A];
+        const Texture& Second = Textures[B];
+        const uint32_t GapA = First.ResidentLevel - First.WantedLevel;
+        const uint32_t GapB = Second.ResidentLevel - Second.WantedLevel;
+        if (GapA != GapB) { return GapA > GapB; }
+        return First.File.GetLevelSize(First.ResidentLevel - 1) < Second.File.GetLevelSize(Second.ResidentLevel - 1);
+    });
+
+    for (TextureId Id : Candidates) {
+        if (PendingReads >= Desc.MaxPendingReads) { break; }
+        Texture& Target = Textures[Id];
+        if (Target.PendingRead) { continue; }
+        const uint32_t Level = Target.ResidentLevel - 1;
+        const uint64_t Bytes = Target.File.GetLevelSize(Level);
+        if (!MakeRoom(Bytes, Id)) { break; }
+
+        Target.PendingBytes = Bytes;
+        PendingBytes += Bytes;
+        // With GPU copies only the new level is read; otherwise the whole chain below it
+        QueueRead(Id, Level, CopyImage ? Level + 1 : Target.File.GetLevelCount());
+    }
+
+    // The budget may have been lowered, or tails pushed the total over it
+    MakeRoom(0, InvalidTextureId);
+
+    Stats.TextureCount = static_cast<uint32_t>(Textures.size() - FreeIds.size());
+    Stats.PendingReads = PendingReads;
+    Stats.ResidentBytes = ResidentBytes;
+    Stats.BudgetBytes = Desc.BudgetBytes;
+    Stats.Bindless = Bindless;
+    ++FrameNumber;
+}
+
+void TextureStreamer::Bind(TextureId Id, int Unit) const {
+    glActiveTexture(GL_TEXTURE0 + Unit);
+    if (Id < Textures.size() && Textures[Id].Handle != 0) {
+        glBindTexture(Textures[Id].Target, Textures[Id].Handle);
+    } else {
+        glBindTexture(GL_TEXTURE_2D, Placeholder);
+    }
+}
+
+uint64_t TextureStreamer::GetHandle(TextureId Id) const {
+    return Id < Textures.size() ? Textures[Id].BindlessHandle : 0;
+}
+
+void TextureStreamer::QueueRead(TextureId Id, uint32_t FirstLevel, uint32_t EndLevel) {
+    Texture& Target = Textures[Id];
+    Target.PendingRead = true;
+    ++PendingReads;
+
+    auto Read = [File = Target.File, Id, Generation = Target.Generation, FirstLevel, EndLevel, Queue = Reads] {
+        ReadResult Result;
+        Result.Id = Id;
+        Result.Generation = Generation;
+        Result.FirstLevel = FirstLevel;
+        Result.EndLevel = EndLevel;
+        Result.Succeeded = File.ReadLevels(FirstLevel, EndLevel, Result.Data);
+
+        std::lock_guard Lock(Queue->Mutex);
+        Queue->Finished.push_back(std::move(Result));
+    };
+    if (Jobs) {
+        Jobs->Submit(std::move(Read));
+    } else {
+        Read();
+    }
+}
+
+void TextureStreamer::ApplyRead(ReadResult& Result) {
+    Texture& Target = Textures[Result.Id];
+    if (!Target.Alive || Target.Generation != Result.Generation) { return; }
+
+    if (!Result.Succeeded) {
+        // Stop asking; whatever is resident stays
+        FinishRead(Target);
+        Target.ReadFailed = true;
+        return;
+    }
+    Stats.UploadedBytes += Result.Data.size();
+
+    if (!Uploader || !Uploader->IsRunning()) {
+        FinishRead(Target);
+        const uint32_t PreviousLevel = Target.ResidentLevel;
+        Recreate(Target, Result.FirstLevel, Result.Data.data(), Result.EndLevel);
+        if (Result.FirstLevel < PreviousLevel) { Stats.LevelsStreamedIn += PreviousLevel - Result.FirstLevel; }
+        return;
+    }
+
+    // The texture keeps its pending read until the upload is adopted, so nothing trims or
+    // re-reads it meanwhile and its resident levels are still there to copy from
+    auto Upload = std::make_shared<ReadResult>(std::move(Result));
+    auto Handle = std::make_shared<GLuint>(0);
+    Uploader->Submit(
+        [Upload, Handle, File = Target.File, GLTarget = static_cast<GLenum>(Target.Target)] {
+            *Handle = CreateChain(GLTarget, File, Upload->FirstLevel, Upload->Data.data(), Upload->EndLevel);
+        },
+        [this, Upload, Handle] {
+            Texture& Uploaded = Textures[Upload->Id];
+            if (!Uploaded.Alive || Uploaded.Generation != Upload->Generation) {
+                glDeleteTextures(1, Handle.get());
+                return;
+            }
+            FinishRead(Uploaded);
+            const uint32_t PreviousLevel = Uploaded.ResidentLevel;
+            Adopt(Uploaded, *Handle, Upload->FirstLevel, Upload->EndLevel);
+            if (Upload->FirstLevel < PreviousLevel) { Stats.LevelsStreamedIn += PreviousLevel - Upload->FirstLevel; }
+        });
+}
+
+void TextureStreamer::FinishRead(Texture& Target) {
+    Target.PendingRead = false;
+    PendingBytes -= Target.PendingBytes;
+    Target.PendingBytes = 0;
+}
+
+void TextureStreamer::Recreate(Texture& Target, uint32_t FirstLevel, const uint8_t* Data, uint32_t DataEndLevel) {
+    Adopt(Target, CreateChain(Target.Target, Target.File, FirstLevel, Data, DataEndLevel), FirstLevel, DataEndLevel);
+}
+
+void TextureStreamer::Adopt(Texture& Target, unsigned int Handle, uint32_t FirstLevel, uint32_t DataEndLevel) {
+    const TextureFile& File = Target.File;
+    const uint32_t LevelCount = File.GetLevelCount();
+
+    // Levels already resident are copied instead of read again. Copies need both textures
+    // complete, so this waits until every level is defined.
+    for (uint32_t Level = std::max(DataEndLevel, FirstLevel); Level < LevelCount; ++Level) {
+        const TextureFileLevel& Entry = File.Levels[Level];
+        glCopyImageSubData(Target.Handle, Target.Target, static_cast<GLint>(Level - Target.ResidentLevel), 0, 0, 0, Handle,
+                           Target.Target, static_cast<GLint>(Level - FirstLevel), 0, 0, 0, static_cast<GLsizei>(Entry.Width),
+                           static_cast<GLsizei>(Entry.Height), static_cast<GLsizei>(File.LayerCount));
+    }
+
+    uint64_t BindlessHandle = 0;
+#if defined(GL_ARB_bindless_texture)
+    // Residency is per context, and this is the one that draws
+    if (Bindless) {
+        BindlessHandle = glGetTextureHandleARB(Handle);
+        glMakeTextureHandleResidentARB(BindlessHandle);
+    }
+#endif
+    RetireHandle(Target.Handle, Target.BindlessHandle);
+    Target.Handle = Handle;
+    Target.BindlessHandle = BindlessHandle;
+    ++HandleGeneration;
+
+    const uint64_t Bytes = GetChainSize(Target, FirstLevel);
+    ResidentBytes = ResidentBytes - Target.ResidentBytes + Bytes;
+    Target.ResidentBytes = Bytes;
+    Target.ResidentLevel = FirstLevel;
+}
+
+void TextureStreamer::Trim(TextureId Id) {
+    Texture& Target = Textures[Id];
+    const uint32_t Level = Target.ResidentLevel + 1;
+    ++Stats.LevelsEvicted;
+    if (CopyImage) {
+        Recreate(Target, Level, nullptr, Level);
+        return;
+    }
+
+    // Without GPU copies the smaller chain comes from the file. The budget counts the level as
+    // gone now; the memory follows when the re-read is applied.
+    const uint64_t Freed = Target.File.GetLevelSize(Target.ResidentLevel);
+    Target.ResidentBytes -= Freed;
+    ResidentBytes -= Freed;
+    QueueRead(Id, Level, Target.File.GetLevelCount());
+}
+
+bool TextureStreamer::MakeRoom(uint64_t Bytes, TextureId Requester) {
+    // Least recently used first. Textures drawn this frame only give up levels finer than they
+    // asked for, and tails are never trimmed.
+    auto CanTrim = [this, Requester](TextureId Id) {
+        const Texture& Target = Textures[Id];
+        if (Id == Requester || !Target.Alive || Target.PendingRead || Target.ResidentLevel >= Target.TailLevel) {
+            return false;
+        }
+        return Target.LastUsedFrame != FrameNumber || Target.ResidentLevel < Target.WantedLevel;
+    };
+
+    // Trimming is not undone if it cannot make enough room, so check first
+    if (ResidentBytes + PendingBytes + Bytes <= Desc.BudgetBytes) { return true; }
+    if (Bytes > 0) {
+        uint64_t Reclaimable = 0;
+        for (TextureId Id = 0; Id < Textures.size(); ++Id) {
+            if (CanTrim(Id)) { Reclaimable += Textures[Id].ResidentBytes - GetChainSize(Textures[Id], Textures[Id].TailLevel); }
+        }
+        if (ResidentBytes + PendingBytes + Bytes > Desc.BudgetBytes + Reclaimable) { return false; }
+    }
+
+    while (ResidentBytes + PendingBytes + Bytes > Desc.BudgetBytes) {
+        TextureId Victim = InvalidTextureId;
+        for (TextureId Id = 0; Id < Textures.size(); ++Id) {
+            if (!CanTrim(Id)) { continue; }
+            const Texture& Target = Textures[Id];
+            if (Victim == InvalidTextureId || Target.LastUsedFrame < Textures[Victim].LastUsedFrame ||
+                (Target.LastUsedFrame == Textures[Victim].LastUsedFrame &&
+                 Target.ResidentBytes > Textures[Victim].ResidentBytes)) {
+                Victim = Id;
+            }
+        }
+        if (Victim == InvalidTextureId) { return false; }
+        Trim(Victim);
+    }
+    return true;
+}
+
+void TextureStreamer::RetireHandle(unsigned int Handle, uint64_t BindlessHandle) {
+    if (Handle == 0) { return; }
+    // GL keeps a deleted texture alive while queued commands use it, but not a handle it has
+    // been told is no longer resident
+    if (BindlessHandle == 0) {
+        glDeleteTextures(1, &Handle);
+        return;
+    }
+    Retired.push_back({Handle, BindlessHandle, glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0)});
+}
+
+void TextureStreamer::CollectRetired() {
+    auto Done = [](RetiredTexture& Entry) {
+        const GLenum Status = glClientWaitSync(static_cast<GLsync>(Entry.Fence), 0, 0);
+        if (Status != GL_ALREADY_SIGNALED && Status != GL_CONDITION_SATISFIED) { return false; }
+        glDeleteSync(static_cast<GLsync>(Entry.Fence));
+#if defined(GL_ARB_bindless_texture)
+        glMakeTextureHandleNonResidentARB(Entry.BindlessHandle);
+#endif
+        glDeleteTextures(1, &Entry.Handle);
+        return true;
+    };
+    Retired.erase(std::remove_if(Retired.begin(), Retired.end(), Done), Retired.end());
+}
+
+uint64_t TextureStreamer::GetChainSize(const Texture& Target, uint32_t FirstLevel) const {
+    uint64_t Bytes = 0;
+    for (uint32_t Level = FirstLevel; Level < Target.File.GetLevelCount(); ++Level) {
+        Bytes += Target.File.GetLevelSize(Level);
+    }
+    return Bytes;
+}
+
+} // namespace Volante
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "RenderView.h"
+#include "TextureFile.h"
+
+namespace Volante {
+
+class JobSystem;
+class UploadContext;
+
+using TextureId = uint32_t;
+constexpr TextureId InvalidTextureId = ~0u;
+
+struct TextureStreamerDesc {
+    // GPU memory the streamed mip levels may occupy. Least recently used textures give up their
+    // finest levels to stay under it.
+    uint64_t BudgetBytes = 256ull << 20;
+
+    // Levels whose larger side is at most this are loaded with the texture and never evicted,
+    // so every texture can be sampled, blurry, within a frame or two of Load().
+    uint32_t ResidentTailSize = 64;
+
+    // Caps on the file reads in flight and on the level bytes uploaded in one Update.
+    uint32_t MaxPendingReads = 8;
+    uint64_t UploadBytesPerFrame = 16ull << 20;
+};
+
+struct TextureStreamerStats {
+    uint32_t TextureCount = 0;
+    uint32_t PendingReads = 0;
+    uint64_t ResidentBytes = 0;
+    uint64_t BudgetBytes = 0;
+    // This Update
+    uint64_t UploadedBytes = 0;
+    uint32_t LevelsStreamedIn = 0;
+    uint32_t LevelsEvicted = 0;
+    bool Bindless = false;
+};
+
+// Streams KTX2/DDS textures into GL without decoding them.
+//
+// A texture starts with its small tail levels resident and is refined one level at a time,
+// coarse to fine, towards the level its on-screen size asks for (ReportUsage). Reads run on the
+// job system; Update() uploads what finished, or hands it to an upload context's worker and
+// adopts the new texture once the GPU has it (SetUploadContext). When a refinement would exceed
+// the budget, the least recently used textures, and those holding finer levels than their last
+// reported size needs, are trimmed first. Changing the resident range re-creates the GL texture
+// (its level 0 is always the finest resident level) with the still-needed levels copied on the
+// GPU when glCopyImageSubData is available, or re-read from the file otherwise.
+//
+// With ARB_bindless_texture every texture also has a resident 64-bit handle, so materials can
+// reference textures from buffer data instead of binding units. Handles change whenever the
+// texture is re-created; GetHandleGeneration() tells when to refresh them.
+class TextureStreamer {
+public:
+    explicit TextureStreamer(const TextureStreamerDesc& Desc = {}, JobSystem* Jobs = nullptr);
+    ~TextureStreamer();
+
+    TextureStreamer(const TextureStreamer&) = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+    bool Initialize();
+    void Shutdown();
+
+    // Uploads finished reads on Context's worker instead of in Update; null uploads in Update.
+    // Context must be polled on this thread, and outlive this streamer or be unset first.
+    void SetUploadContext(UploadContext* Context) { Uploader = Context; }
+
+    // Reads the header and queues the tail levels. Returns InvalidTextureId if the file cannot
+    // be used (the reason is printed).
+    TextureId Load(const std::string& Path);
+    void Release(TextureId Id);
+
+    // Screen-space usage feedback for the current frame: ScreenSize is how many pixels the
+    // texture's width covers where it is drawn. The largest report of a frame wins.
+    void ReportUsage(TextureId Id, float ScreenSize);
+
+    // Pixel span of a texture repeated UVScale times across a sphere of Radius at Center, for
+    // ReportUsage.
+    [[nodiscard]] static float EstimateScreenSize(const RenderView& View, const Vec3& Center, float Radius,
+                                                  float ViewportHeight, float UVScale = 1.0f);
+
+    // Once per frame, with the context current: uploads finished reads, applies the budget and
+    // issues the next reads.
+    void Update();
+
+    // Binds the texture (or a grey placeholder until its tail arrives) to texture unit Unit.
+    void Bind(TextureId Id, int Unit) const;
+
+    // Resident bindless handle, or 0 without bindless support or before the tail arrived.
+    [[nodiscard]] uint64_t GetHandle(TextureId Id) const;
+
+    [[nodiscard]] uint32_t GetHandleGeneration() const { return HandleGeneration; }
+
+    [[nodiscard]] bool IsBindless() const { return Bindless; }
+
+    // Finest resident level, or the level count while nothing is resident.
+    [[nodiscard]] uint32_t GetResidentLevel(TextureId Id) const { return Textures[Id].ResidentLevel; }
+
+    [[nodiscard]] const TextureFile& GetFile(TextureId Id) const { return Textures[Id].File; }
+
+    [[nodiscard]] const TextureStreamerStats& GetStats() const { return Stats; }
+
+private:
+    struct Texture {
+        TextureFile File;
+        unsigned int Target = 0;
+        unsigned int Handle = 0;
+        uint64_t BindlessHandle = 0;
+        // Resident levels are [ResidentLevel, TailLevel's chain end); TailLevel never leaves
+        uint32_t ResidentLevel = 0;
+        uint32_t TailLevel = 0;
+        uint32_t WantedLevel = 0;
+        uint64_t ResidentBytes = 0;
+        // Budget reserved for the level being read
+        uint64_t PendingBytes = 0;
+        uint64_t LastUsedFrame = 0;
+        // Bumped on Release so reads finishing afterwards are dropped
+        uint32_t Generation = 0;
+        bool PendingRead = false;
+        bool ReadFailed = false;
+        bool Alive = false;
+    };
+
+    // A finished read: levels [FirstLevel, EndLevel) of a texture, finer first
+    struct ReadResult {
+        TextureId Id = InvalidTextureId;
+        uint32_t Generation = 0;
+        uint32_t FirstLevel = 0;
+        uint32_t EndLevel = 0;
+        std::vector<uint8_t> Data;
+        bool Succeeded = false;
+    };
+
+    struct ReadQueue;
+
+    void QueueRead(TextureId Id, uint32_t FirstLevel, uint32_t EndLevel);
+    void ApplyRead(ReadResult& Result);
+    // Clears the pending read and releases its reserved budget
+    void FinishRead(Texture& Target);
+    // Re-creates the texture with levels [FirstLevel, chain end). Data holds the levels from
+    // FirstLevel up to DataEndLevel; the rest are copied from the current texture.
+    void Recreate(Texture& Target, uint32_t FirstLevel, const uint8_t* Data, uint32_t DataEndLevel);
+    // Makes Handle, holding levels [FirstLevel, DataEndLevel) already, the texture, after
+    // copying the rest of the chain into it from the current one
+    void Adopt(Texture& Target, unsigned int Handle, uint32_t FirstLevel, uint32_t DataEndLevel);
+    void Trim(TextureId Id);
+    bool MakeRoom(uint64_t Bytes, TextureId Requester);
+    void RetireHandle(unsigned int Handle, uint64_t BindlessHandle);
+    void CollectRetired();
+
+    [[nodiscard]] uint64_t GetChainSize(const Texture& Target, uint32_t FirstLevel) const;
+
+    TextureStreamerDesc Desc;
+    JobSystem* Jobs;
+    UploadContext* Uploader = nullptr;
+    std::vector<Texture> Textures;
+    std::vector<TextureId> FreeIds;
+    std::shared_ptr<ReadQueue> Reads;
+    std::vector<ReadResult> ReadyReads;
+    uint32_t PendingReads = 0;
+    uint64_t FrameNumber = 1;
+    uint64_t ResidentBytes = 0;
+    uint64_t PendingBytes = 0;
+    uint32_t HandleGeneration = 0;
+    bool Bindless = false;
+    bool CopyImage = false;
+    TextureStreamerStats Stats;
+
+    // Bindless textures may still be read by queued draws, so they are released behind a fence
+    struct RetiredTexture {
+        unsigned int Handle = 0;
+        uint64_t BindlessHandle = 0;
+        void* Fence = nullptr;
+    };
+    std::vector<RetiredTexture> Retired;
+
+    unsigned int Placeholder = 0;
+};
+
+} // namespace Volante
@@ -0,0 +1,113 @@
+#include "UploadContext.h"
+
+#include <glad/glad.h>
+
+#include <iostream>
+
+namespace Volante {
+
+UploadContext::UploadContext(std::unique_ptr<IGraphicsContext> Context) : Context(std::move(Context)) {}
+
+UploadContext::~UploadContext() {
+    Shutdown();
+}
+
+bool UploadContext::Initialize() {
+    if (!Context) {
+        std::cerr << "ERROR::UPLOAD_CONTEXT::NO_CONTEXT" << std::endl;
+        return false;
+    }
+    if (IsRunning()) { return true; }
+    Stopping = false;
+    Worker = std::thread([this] { WorkerLoop(); });
+    return true;
+}
+
+void UploadContext::Shutdown() {
+    if (!IsRunning()) { return; }
+    Flush();
+    {
+        std::lock_guard Lock(Mutex);
+        Stopping = true;
+    }
+    WorkCondition.notify_one();
+    Worker.join();
+}
+
+void UploadContext::Submit(Task Upload, Task Complete) {
+    if (!IsRunning()) {
+        Upload();
+        if (Complete) { Complete(); }
+        return;
+    }
+    {
+        std::lock_guard Lock(Mutex);
+        Queue.push_back({std::move(Upload), std::move(Complete)});
+    }
+    ++PendingCount;
+    WorkCondition.notify_one();
+}
+
+void UploadContext::Poll() {
+    while (CompleteNext(false)) {}
+}
+
+void UploadContext::Flush() {
+    while (PendingCount > 0) { CompleteNext(true); }
+}
+
+bool UploadContext::CompleteNext(bool Wait) {
+    void* Fence = nullptr;
+    {
+        std::unique_lock Lock(Mutex);
+        if (Wait) { FinishedCondition.wait(Lock, [this] { return !Finished.empty(); }); }
+        if (Finished.empty()) { return false; }
+        Fence = Finished.front().Fence;
+    }
+
+    // The worker flushed after each fence, so waiting here cannot hang on an unsent one
+    const auto Sync = static_cast<GLsync>(Fence);
+    GLenum Status = glClientWaitSync(Sync, 0, 0);
+    while (Wait && Status == GL_TIMEOUT_EXPIRED) { Status = glClientWaitSync(Sync, 0, 1000000); }
+    if (Status == GL_TIMEOUT_EXPIRED) { return false; }
+
+    FinishedUpload Entry;
+    {
+        std::lock_guard Lock(Mutex);
+        Entry = std::move(Finished.front());
+        Finished.pop_front();
+    }
+    glDeleteSync(Sync);
+    --PendingCount;
+    // GL_WAIT_FAILED only with a broken context; the completion still runs so nothing waits on it
+    if (Entry.Complete) { Entry.Complete(); }
+    return true;
+}
+
+void UploadContext::WorkerLoop() {
+    Context->MakeCurrent();
+    for (;;) {
+        PendingUpload Next;
+        {
+            std::unique_lock Lock(Mutex);
+            WorkCondition.wait(Lock, [this] { return Stopping || !Queue.empty(); });
+            if (Queue.empty()) { break; }
+            Next = std::move(Queue.front());
+            Queue.pop_front();
+        }
+
+        Next.Upload();
+        GLsync Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        // Submits the upload; a fence still sitting in this context's queue would never signal
+        glFlush();
+
+        {
+            std::lock_guard Lock(Mutex);
+            Finished.push_back({Fence, std::move(Next.Complete)});
+        }
+        FinishedCondition.notify_one();
+    }
+    Context->ReleaseCurrent();
+}
+
+} // namespace Volante
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "Runtime/Core/HAL/IWindow.h"
+
+namespace Volante {
+
+// A worker thread with a GL context of its own, sharing objects with the main one, for uploads
+// that would otherwise stall the frame: texture levels, buffer contents. Upload functions run
+// in submission order on the worker and may only touch objects nothing on the main context is
+// using, typically ones they create. Each is followed by a fence; its completion runs on the
+// main thread from Poll once the GPU has finished the upload, and from then on the main context
+// may use what it filled. Bind those objects afresh there: a binding made before the upload
+// finished is not guaranteed to see it.
+class UploadContext {
+public:
+    using Task = std::function<void()>;
+
+    // Context must share objects with the main context and not be current anywhere.
+    explicit UploadContext(std::unique_ptr<IGraphicsContext> Context);
+    ~UploadContext();
+
+    UploadContext(const UploadContext&) = delete;
+    UploadContext& operator=(const UploadContext&) = delete;
+
+    // Starts the worker, which makes the context current for good.
+    bool Initialize();
+    // Finishes everything submitted, completions included, and stops the worker. Main thread.
+    void Shutdown();
+
+    // Complete, if set, runs on the main thread from Poll or Flush after the GPU finished
+    // Upload's commands. Without a worker running, both run right away.
+    void Submit(Task Upload, Task Complete = {});
+
+    // Once per frame on the main thread, with its context current: runs the completions of the
+    // uploads the GPU has finished, in submission order, without waiting for the others.
+    void Poll();
+
+    // Blocks until everything submitted so far has completed.
+    void Flush();
+
+    [[nodiscard]] bool IsRunning() const { return Worker.joinable(); }
+
+    // Submitted but not yet completed
+    [[nodiscard]] uint32_t GetPendingCount() const { return PendingCount; }
+
+private:
+    struct PendingUpload {
+        Task Upload;
+        Task Complete;
+    };
+
+    struct FinishedUpload {
+        void* Fence = nullptr;
+        Task Complete;
+    };
+
+    void WorkerLoop();
+    // Runs the oldest finished upload's completion; with Wait, blocks until there is one
+    bool CompleteNext(bool Wait);
+
+    std::unique_ptr<IGraphicsContext> Context;
+    std::thread Worker;
+    std::mutex Mutex;
+    std::condition_variable WorkCondition;
+    std::condition_variable FinishedCondition;
+    std::deque<PendingUpload> Queue;
+    std::deque<FinishedUpload> Finished;
+    uint32_t PendingCount = 0;
+    bool Stopping = false;
+};
+
+} // namespace Volante
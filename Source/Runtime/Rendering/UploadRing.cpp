@@ -0,0 +1,212 @@
+#include "UploadRing.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <iostream>
+
+#include "GLCapabilities.h"
+#include "Runtime/Core/Misc/Utility.h"
+#include "Runtime/Core/Stats/StatCounters.h"
+
+namespace Volante {
+
+UploadRing::UploadRing(const UploadRingDesc& Desc) : Desc(Desc) {}
+
+UploadRing::~UploadRing() {
+    Shutdown();
+}
+
+bool UploadRing::Initialize() {
+    const GLCapabilities& Caps = GLCapabilities::Get();
+    Persistent = Desc.AllowPersistentMapping && Caps.BufferStorage;
+    GLint Alignment = 256;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &Alignment);
+    UniformAlignment = std::max<size_t>(static_cast<size_t>(Alignment), 16);
+    Desc.FrameCount = std::max(Desc.FrameCount, 1u);
+    Desc.FrameSize = AlignUp(std::max<size_t>(Desc.FrameSize, UniformAlignment), UniformAlignment);
+    Fences.assign(Desc.FrameCount, nullptr);
+    CreateBuffer();
+    if (Buffer == 0) {
+        std::cerr << "ERROR::UPLOAD_RING::CREATE_FAILED" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void UploadRing::Shutdown() {
+    DestroyBuffer();
+    for (Spill& Entry : Spills) {
+        if (Entry.Buffer != 0) { glDeleteBuffers(1, &Entry.Buffer); }
+    }
+    Spills.clear();
+    SpillCount = 0;
+    FlushedSpills = 0;
+    InFrame = false;
+}
+
+void UploadRing::CreateBuffer() {
+    const size_t Total = Desc.FrameSize * Desc.FrameCount;
+    glGenBuffers(1, &Buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, Buffer);
+    if (Persistent) {
+        const GLbitfield Flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(Total), nullptr, Flags);
+        PersistentData = static_cast<uint8_t*>(glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, static_cast<GLsizeiptr>(Total), Flags));
+        if (!PersistentData) {
+            // Fall back to mapping per frame rather than failing
+            std::cerr << "ERROR::UPLOAD_RING::PERSISTENT_MAP_FAILED" << std::endl;
+            glDeleteBuffers(1, &Buffer);
+            glGenBuffers(1, &Buffer);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, Buffer);
+            Persistent = false;
+        }
+    }
+    if (!Persistent) { glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(Total), nullptr, GL_STREAM_DRAW); }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    Region = 0;
+    RegionBegin = 0;
+    Cursor = 0;
+}
+
+void UploadRing::DestroyBuffer() {
+    Unmap();
+    for (void*& Fence : Fences) {
+        if (Fence) { glDeleteSync(static_cast<GLsync>(Fence)); }
+        Fence = nullptr;
+    }
+    // Deleting a buffer the GPU still reads is fine: GL keeps its storage until it is done.
+    // A persistent mapping goes with it.
+    if (Buffer != 0) { glDeleteBuffers(1, &Buffer); }
+    Buffer = 0;
+    PersistentData = nullptr;
+}
+
+void UploadRing::BeginFrame() {
+    if (Buffer == 0) { return; }
+    if (InFrame) { EndFrame(); }
+    Stats = {};
+    SpillCount = 0;
+    FlushedSpills = 0;
+
+    // Last frame spilled: reallocate with room for it. The old buffer is released lazily.
+    if (GrowTo > 0) {
+        DestroyBuffer();
+        Desc.FrameSize = AlignUp(GrowTo, UniformAlignment);
+        GrowTo = 0;
+        CreateBuffer();
+    } else {
+        Region = (Region + 1) % Desc.FrameCount;
+        RegionBegin = Region * Desc.FrameSize;
+        Cursor = RegionBegin;
+    }
+
+    if (void* Fence = Fences[Region]) {
+        const auto Sync = static_cast<GLsync>(Fence);
+        if (glClientWaitSync(Sync, 0, 0) == GL_TIMEOUT_EXPIRED) {
+            ++Stats.Stalls;
+            if (Persistent) {
+                glClientWaitSync(Sync, GL_SYNC_FLUSH_COMMANDS_BIT, FenceTimeout);
+            } else {
+                // Fresh storage instead of a wait; every region's fence is moot after this
+                glBindBuffer(GL_COPY_WRITE_BUFFER, Buffer);
+                glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(Desc.FrameSize * Desc.FrameCount), nullptr,
+                             GL_STREAM_DRAW);
+                glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+                ++Stats.Orphans;
+                for (uint32_t i = 0; i < Fences.size(); ++i) {
+                    if (i == Region || !Fences[i]) { continue; }
+                    glDeleteSync(static_cast<GLsync>(Fences[i]));
+                    Fences[i] = nullptr;
+                }
+            }
+        }
+        glDeleteSync(Sync);
+        Fences[Region] = nullptr;
+    }
+    InFrame = true;
+}
+
+void UploadRing::EndFrame() {
+    if (Buffer == 0 || !InFrame) { return; }
+    Flush();
+    Fences[Region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    InFrame = false;
+    StatCounters::Add(StatCounter::UploadBytes, static_cast<int64_t>(Stats.BytesUploaded));
+}
+
+UploadAllocation UploadRing::Allocate(size_t Size, size_t Alignment) {
+    UploadAllocation Result;
+    if (Buffer == 0) { return Result; }
+    Size = std::max<size_t>(Size, 1);
+    ++Stats.AllocationCount;
+    Stats.BytesUploaded += Size;
+
+    const size_t Offset = AlignUp(Cursor, Alignment);
+    const size_t RegionEnd = RegionBegin + Desc.FrameSize;
+    if (Offset + Size <= RegionEnd) {
+        if (Persistent) {
+            Result.Data = PersistentData + Offset;
+        } else {
+            if (!MappedData) { Map(); }
+            Result.Data = MappedData ? MappedData + (Offset - MappedBegin) : nullptr;
+        }
+        if (Result.Data) {
+            Cursor = Offset + Size;
+            Result.Offset = Offset;
+            Result.Size = Size;
+            Result.Buffer = Buffer;
+            return Result;
+        }
+    }
+
+    // Region full: this allocation gets a buffer of its own, and the ring grows next frame
+    // to fit the whole frame.
+    if (SpillCount == Spills.size()) { Spills.emplace_back(); }
+    Spill& Entry = Spills[SpillCount++];
+    if (Entry.Buffer == 0) { glGenBuffers(1, &Entry.Buffer); }
+    Entry.Data.resize(Size);
+    Stats.BytesSpilled += Size;
+    GrowTo = std::max({GrowTo, Desc.FrameSize * 2, Desc.FrameSize + Stats.BytesSpilled + SpillCount * Alignment});
+    Result.Data = Entry.Data.data();
+    Result.Offset = 0;
+    Result.Size = Size;
+    Result.Buffer = Entry.Buffer;
+    return Result;
+}
+
+void UploadRing::Flush() {
+    Unmap();
+    for (; FlushedSpills < SpillCount; ++FlushedSpills) {
+        const Spill& Entry = Spills[FlushedSpills];
+        glBindBuffer(GL_COPY_WRITE_BUFFER, Entry.Buffer);
+        glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(Entry.Data.size()), Entry.Data.data(), GL_STREAM_DRAW);
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+void UploadRing::Map() {
+    // Nothing the GPU may still read lies past the cursor: the region's fence has passed (or
+    // the buffer was orphaned), so the map needs no synchronization.
+    const size_t RegionEnd = RegionBegin + Desc.FrameSize;
+    if (Cursor >= RegionEnd) { return; }
+    MappedBegin = Cursor;
+    glBindBuffer(GL_COPY_WRITE_BUFFER, Buffer);
+    MappedData = static_cast<uint8_t*>(glMapBufferRange(
+        GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(MappedBegin), static_cast<GLsizeiptr>(RegionEnd - MappedBegin),
+        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_FLUSH_EXPLICIT_BIT));
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+void UploadRing::Unmap() {
+    if (!MappedData) { return; }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, Buffer);
+    if (Cursor > MappedBegin) {
+        glFlushMappedBufferRange(GL_COPY_WRITE_BUFFER, 0, static_cast<GLsizeiptr>(Cursor - MappedBegin));
+    }
+    glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    MappedData = nullptr;
+}
+
+} // namespace Volante
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Volante {
+
+struct UploadRingDesc {
+    // Bytes one frame can sub-allocate; the buffer holds FrameCount of these. A frame that
+    // needs more spills into separate buffers and the ring grows at the next BeginFrame.
+    size_t FrameSize = 4 * 1024 * 1024;
+    uint32_t FrameCount = 3;
+
+    // Turn off to use the GL 3.3 mapping path even where buffer storage is available
+    bool AllowPersistentMapping = true;
+};
+
+// Per-frame counts; reset by BeginFrame.
+struct UploadRingStats {
+    size_t BytesUploaded = 0;
+    size_t BytesSpilled = 0;
+    uint32_t AllocationCount = 0;
+    // BeginFrame found the GPU still reading the region: waited (persistent) or orphaned
+    uint32_t Stalls = 0;
+    uint32_t Orphans = 0;
+};
+
+// Where an allocation lives: bind Buffer and read at Offset. Data is write-only memory that
+// stays valid until the next Flush or EndFrame.
+struct UploadAllocation {
+    void* Data = nullptr;
+    size_t Offset = 0;
+    size_t Size = 0;
+    unsigned int Buffer = 0;
+
+    explicit operator bool() const { return Data != nullptr; }
+};
+
+// Streaming memory for data written once per frame (instance streams, per-view uniforms,
+// debug geometry). One buffer is split into FrameCount regions used in turn; a fence placed
+// at EndFrame tells BeginFrame when the GPU is done with the region it is about to reuse, so
+// with three regions the CPU never waits in practice.
+//
+// With GL 4.4 or ARB_buffer_storage the buffer is mapped once, persistent and coherent, and
+// allocations point straight into it. On GL 3.3 the free part of the region is mapped
+// unsynchronized on demand and Flush() unmaps it; a region the GPU still reads is orphaned
+// instead of waited on.
+//
+// Allocations are only safe to draw from after Flush() (a no-op when persistent). Not thread
+// safe: fill from jobs, allocate on the render thread.
+class UploadRing {
+public:
+    explicit UploadRing(const UploadRingDesc& Desc = {});
+    ~UploadRing();
+
+    UploadRing(const UploadRing&) = delete;
+    UploadRing& operator=(const UploadRing&) = delete;
+
+    bool Initialize();
+    void Shutdown();
+
+    // Starts the next region, waiting for (or orphaning) it if the GPU is still behind.
+    void BeginFrame();
+    // Flushes and fences the region.
+    void EndFrame();
+
+    // Alignment must be a power of two. Never fails: a full region spills.
+    UploadAllocation Allocate(size_t Size, size_t Alignment = 16);
+
+    // Aligned for glBindBufferRange(GL_UNIFORM_BUFFER, ...)
+    UploadAllocation AllocateUniform(size_t Size) { return Allocate(Size, UniformAlignment); }
+
+    // Makes everything allocated so far visible to GL commands issued after it.
+    void Flush();
+
+    [[nodiscard]] bool IsPersistent() const { return Persistent; }
+
+    [[nodiscard]] size_t GetFrameSize() const { return Desc.FrameSize; }
+
+    [[nodiscard]] const UploadRingStats& GetStats() const { return Stats; }
+
+private:
+    void CreateBuffer();
+    void DestroyBuffer();
+    void Map();
+    void Unmap();
+
+    struct Spill {
+        unsigned int Buffer = 0;
+        std::vector<uint8_t> Data;
+    };
+
+    UploadRingDesc Desc;
+    UploadRingStats Stats;
+    size_t UniformAlignment = 256;
+    bool Persistent = false;
+    bool InFrame = false;
+
+    unsigned int Buffer = 0;
+    uint8_t* PersistentData = nullptr;
+    std::vector<void*> Fences;
+    uint32_t Region = 0;
+    size_t RegionBegin = 0;
+    size_t Cursor = 0;
+
+    // GL 3.3 path: the mapped span [MappedBegin, RegionBegin + FrameSize)
+    uint8_t* MappedData = nullptr;
+    size_t MappedBegin = 0;
+
+    // Overflow of the current frame, uploaded on Flush; buffers are reused (orphaned) later
+    std::vector<Spill> Spills;
+    uint32_t SpillCount = 0;
+    uint32_t FlushedSpills = 0;
+    size_t GrowTo = 0;
+};
+
+} // namespace Volante
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "Volante.h"
+
+namespace Volante {
+
+struct Vertex {
+    Vec3 position;
+    Vec3 normal;
+    Vec2 texCoord;
+};
+
+} // namespace Volante
@@ -0,0 +1,296 @@
+#include "WindowPresenter.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+
+#include "FrameGraph.h"
+#include "Shader.h"
+#include "ShaderLibrary.h"
+
+namespace Volante {
+
+WindowPresenter::WindowPresenter(FrameGraph& Graph) : Graph(Graph) {
+    Surfaces.push_back(std::make_unique<Surface>());
+    Surfaces[0]->Active = true;
+}
+
+WindowPresenter::~WindowPresenter() {
+    Shutdown();
+}
+
+void WindowPresenter::Shutdown() {
+    for (uint32_t Index = 1; Index < Surfaces.size(); ++Index) {
+        RemoveWindow(Index);
+    }
+    Surfaces.resize(1);
+    LayoutChanged = false;
+}
+
+void WindowPresenter::SetMainSize(int Width, int Height) {
+    Surface& Main = *Surfaces[0];
+    if (Width <= 0 || Height <= 0 || (Width == Main.Width && Height == Main.Height)) { return; }
+    Main.Width = Width;
+    Main.Height = Height;
+    Layout();
+}
+
+uint32_t WindowPresenter::AddWindow(std::unique_ptr<IWindow> Window) {
+    const auto Index = static_cast<uint32_t>(Surfaces.size());
+    auto& Target = *Surfaces.emplace_back(std::make_unique<Surface>());
+    Target.Window = std::move(Window);
+    Target.Window->GetFramebufferSize(Target.Width, Target.Height);
+    Target.Active = true;
+    ++WindowCount;
+    // Events arrive on the main thread, from PollEvents
+    Target.Window->SetResizeCallback([this, &Target](int Width, int Height) {
+        if (Width <= 0 || Height <= 0) { return; }
+        Target.Width = Width;
+        Target.Height = Height;
+        Layout();
+    });
+    Target.Thread = std::thread([this, &Target] { PresentLoop(Target); });
+    Layout();
+    return Index;
+}
+
+void WindowPresenter::RemoveWindow(uint32_t Index) {
+    if (Index == 0 || Index >= Surfaces.size() || !Surfaces[Index]->Active) { return; }
+    Surface& Target = *Surfaces[Index];
+    {
+        std::lock_guard Lock(Mutex);
+        Target.Stop = true;
+    }
+    FrameCondition.notify_all();
+    Target.Thread.join();
+    // Windows are destroyed on the thread that created them
+    Target.Window.reset();
+    Target = Surface();
+    // The last one leaves the canvas unused, and frames go straight to the main window again
+    if (--WindowCount == 0) { DestroyCanvas(); }
+    Layout();
+}
+
+bool WindowPresenter::UpdateLayout() {
+    const bool Changed = LayoutChanged;
+    LayoutChanged = false;
+    return Changed;
+}
+
+uint32_t WindowPresenter::FindClosingWindow() const {
+    for (uint32_t Index = 1; Index < Surfaces.size(); ++Index) {
+        if (Surfaces[Index]->Active && Surfaces[Index]->Window->ShouldClose()) { return Index; }
+    }
+    return 0;
+}
+
+Vec4 WindowPresenter::GetSurfaceRect(uint32_t Index) const {
+    if (Index >= Surfaces.size() || !Surfaces[Index]->Active || CanvasWidth <= 0 || CanvasHeight <= 0) { return Vec4(0.0f); }
+    const Surface& Target = *Surfaces[Index];
+    const auto Width = static_cast<float>(CanvasWidth);
+    const auto Height = static_cast<float>(CanvasHeight);
+    return Vec4(static_cast<float>(Target.X) / Width, 0.0f, static_cast<float>(Target.Width) / Width,
+                static_cast<float>(Target.Height) / Height);
+}
+
+void WindowPresenter::GetCanvasSize(int& Width, int& Height) const {
+    Width = CanvasWidth;
+    Height = CanvasHeight;
+}
+
+unsigned int WindowPresenter::BeginFrame() {
+    const uint32_t Next = (PublishedCanvas + 1) % CanvasCount;
+    const bool Reallocate = CanvasWidth != AllocatedWidth || CanvasHeight != AllocatedHeight;
+
+    std::vector<void*> Fences;
+    void* Rendered[CanvasCount] = {};
+    {
+        std::unique_lock Lock(Mutex);
+        // Readers only hold a canvas between picking it and fencing their draw, which is short
+        ReaderCondition.wait(Lock, [&] {
+            if (!Reallocate) { return Readers[Next] == 0; }
+            return std::all_of(std::begin(Readers), std::end(Readers), [](uint32_t Count) { return Count == 0; });
+        });
+        for (uint32_t Index = 0; Index < CanvasCount; ++Index) {
+            if (!Reallocate && Index != Next) { continue; }
+            Fences.insert(Fences.end(), ReadFences[Index].begin(), ReadFences[Index].end());
+            ReadFences[Index].clear();
+            Rendered[Index] = RenderedFences[Index];
+            RenderedFences[Index] = nullptr;
+        }
+        // No thread may pick up the old canvas once its readers are done
+        if (Reallocate) { PublishedTexture = 0; }
+    }
+    for (void* Fence : Rendered) {
+        if (Fence) { glDeleteSync(static_cast<GLsync>(Fence)); }
+    }
+
+    if (Reallocate) {
+        // GL frees the old canvases once the present threads' queued draws are done with them
+        for (void* Fence : Fences) { glDeleteSync(static_cast<GLsync>(Fence)); }
+        DestroyCanvas();
+        glGenTextures(CanvasCount, Canvas);
+        glGenFramebuffers(CanvasCount, ReadFramebuffers);
+        for (uint32_t Index = 0; Index < CanvasCount; ++Index) {
+            glBindTexture(GL_TEXTURE_2D, Canvas[Index]);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, CanvasWidth, CanvasHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, ReadFramebuffers[Index]);
+            glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, Canvas[Index], 0);
+        }
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+        AllocatedWidth = CanvasWidth;
+        AllocatedHeight = CanvasHeight;
+    } else {
+        // The GPU, not this thread, waits for the windows still drawing from the canvas
+        for (void* Fence : Fences) {
+            glWaitSync(static_cast<GLsync>(Fence), 0, GL_TIMEOUT_IGNORED);
+            glDeleteSync(static_cast<GLsync>(Fence));
+        }
+    }
+
+    CurrentCanvas = Next;
+    return Canvas[Next];
+}
+
+void WindowPresenter::EndFrame() {
+    GLsync Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    // Other contexts only see the fence once it has been submitted
+    glFlush();
+    {
+        std::lock_guard Lock(Mutex);
+        RenderedFences[CurrentCanvas] = Fence;
+        PublishedCanvas = CurrentCanvas;
+        PublishedTexture = Canvas[CurrentCanvas];
+        ++PublishedFrame;
+        for (const auto& Target : Surfaces) {
+            Target->RegionX = Target->X;
+            Target->RegionWidth = Target->Active ? Target->Width : 0;
+            Target->RegionHeight = Target->Active ? Target->Height : 0;
+        }
+    }
+    FrameCondition.notify_all();
+
+    const Surface& Main = *Surfaces[0];
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, ReadFramebuffers[CurrentCanvas]);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glBlitFramebuffer(0, 0, Main.Width, Main.Height, 0, 0, Main.Width, Main.Height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void WindowPresenter::PresentLoop(Surface& Target) {
+    IGraphicsContext* Context = Target.Window->GetGraphicsContext();
+    Context->MakeCurrent();
+
+    GLuint VertexArray = 0;
+    glGenVertexArrays(1, &VertexArray);
+    // Programs are shared, but their uniforms would be too. The files are read once per
+    // thread, outside ShaderLibrary, so edits to them apply to windows added afterwards.
+    const std::string& Directory = ShaderLibrary::GetShaderDirectory();
+    std::string VertexSource;
+    std::string FragmentSource;
+    std::vector<std::string> Dependencies;
+    if (!ShaderLibrary::Preprocess(Directory + "/WindowPresent.vert", {}, {}, VertexSource, Dependencies) ||
+        !ShaderLibrary::Preprocess(Directory + "/WindowPresent.frag", {}, {}, FragmentSource, Dependencies)) {
+        std::cerr << "ERROR::WINDOW_PRESENTER::SHADER_READ_FAILED: " << Directory << std::endl;
+    }
+    auto Program = std::make_unique<Shader>(VertexSource.c_str(), FragmentSource.c_str());
+    Program->use();
+    Program->setInt("uCanvas", 0);
+    const GLint OriginLocation = glGetUniformLocation(Program->id, "uOrigin");
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_CULL_FACE);
+    glDisable(GL_BLEND);
+
+    uint64_t Presented = 0;
+    for (;;) {
+        uint32_t Index = 0;
+        unsigned int Texture = 0;
+        GLsync Rendered = nullptr;
+        int X = 0;
+        int Width = 0;
+        int Height = 0;
+        {
+            std::unique_lock Lock(Mutex);
+            FrameCondition.wait(Lock, [&] { return Target.Stop || PublishedFrame != Presented; });
+            if (Target.Stop) { break; }
+            // Always the newest frame; ones finished while this window was swapping are skipped
+            Presented = PublishedFrame;
+            if (PublishedTexture == 0 || Target.RegionWidth <= 0 || Target.RegionHeight <= 0) { continue; }
+            Index = PublishedCanvas;
+            Texture = PublishedTexture;
+            Rendered = static_cast<GLsync>(RenderedFences[Index]);
+            X = Target.RegionX;
+            Width = Target.RegionWidth;
+            Height = Target.RegionHeight;
+            ++Readers[Index];
+        }
+
+        glWaitSync(Rendered, 0, GL_TIMEOUT_IGNORED);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glViewport(0, 0, Width, Height);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, Texture);
+        glUniform2f(OriginLocation, static_cast<float>(X), 0.0f);
+        glBindVertexArray(VertexArray);
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+        // A reallocated canvas is freed only once no context has it bound
+        glBindTexture(GL_TEXTURE_2D, 0);
+        GLsync Read = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        glFlush();
+        {
+            std::lock_guard Lock(Mutex);
+            --Readers[Index];
+            ReadFences[Index].push_back(Read);
+        }
+        ReaderCondition.notify_all();
+
+        Context->SwapBuffers();
+    }
+
+    glDeleteVertexArrays(1, &VertexArray);
+    Program.reset();
+    Context->ReleaseCurrent();
+}
+
+void WindowPresenter::Layout() {
+    int X = 0;
+    int Height = 0;
+    for (const auto& Target : Surfaces) {
+        if (!Target->Active) { continue; }
+        Target->X = X;
+        X += Target->Width;
+        Height = std::max(Height, Target->Height);
+    }
+    CanvasWidth = X;
+    CanvasHeight = Height;
+    LayoutChanged = true;
+}
+
+void WindowPresenter::DestroyCanvas() {
+    {
+        // A window added later must not find the last frame published
+        std::lock_guard Lock(Mutex);
+        PublishedTexture = 0;
+        for (uint32_t Index = 0; Index < CanvasCount; ++Index) {
+            for (void* Fence : ReadFences[Index]) { glDeleteSync(static_cast<GLsync>(Fence)); }
+            ReadFences[Index].clear();
+            if (RenderedFences[Index]) { glDeleteSync(static_cast<GLsync>(RenderedFences[Index])); }
+            RenderedFences[Index] = nullptr;
+        }
+    }
+    for (const unsigned int Texture : Canvas) {
+        if (Texture != 0) { Graph.ForgetTexture(Texture); }
+    }
+    if (Canvas[0] != 0) { glDeleteTextures(CanvasCount, Canvas); }
+    if (ReadFramebuffers[0] != 0) { glDeleteFramebuffers(CanvasCount, ReadFramebuffers); }
+    std::fill(std::begin(Canvas), std::end(Canvas), 0u);
+    std::fill(std::begin(ReadFramebuffers), std::end(ReadFramebuffers), 0u);
+    AllocatedWidth = AllocatedHeight = 0;
+}
+
+} // namespace Volante
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Runtime/Core/HAL/IWindow.h"
+#include "Volante.h"
+
+namespace Volante {
+
+class FrameGraph;
+
+// Shows one rendered frame across several windows, e.g. one per monitor. Surface 0 is the main
+// window; the others are laid out to its right in a canvas texture, each window's region the
+// size of its framebuffer, and the scene renders into the canvas once for all of them, with
+// each window's cameras in its region (CameraSystem::SetSurfaceRect).
+//
+// The main window's region is blitted to its backbuffer on the main context. Every other window
+// has a present thread that keeps the window's context current and draws its region with a
+// vertex array and program of its own, since those are not shared between contexts, then swaps
+// at the window's own swap interval: a monitor's vertical blank holds up neither another
+// monitor nor the frame loop, and a window always shows the newest finished frame. Fences order
+// the contexts on the GPU, and the canvas is double buffered, so the next frame renders while
+// the last is still being presented.
+//
+// Without extra windows, none of this is used and frames go straight to the main window.
+class WindowPresenter {
+public:
+    // The graph frames are rendered with, whose framebuffers for the canvas are dropped with it.
+    explicit WindowPresenter(FrameGraph& Graph);
+    ~WindowPresenter();
+
+    WindowPresenter(const WindowPresenter&) = delete;
+    WindowPresenter& operator=(const WindowPresenter&) = delete;
+
+    // Stops the present threads and destroys the windows and the canvas. Main context current.
+    void Shutdown();
+
+    // The main window's framebuffer size. A minimized window keeps its last size.
+    void SetMainSize(int Width, int Height);
+
+    // Window's context must share the main one's objects (WindowDesc::share) and not be current
+    // anywhere. Returns its surface. Input and UI stay with the main window.
+    uint32_t AddWindow(std::unique_ptr<IWindow> Window);
+    void RemoveWindow(uint32_t Surface);
+
+    // Between frames: true once after windows were added, removed or resized, when the canvas
+    // size and surface rects should be handed on again.
+    bool UpdateLayout();
+
+    // The first extra window asked to close, or 0 for none.
+    [[nodiscard]] uint32_t FindClosingWindow() const;
+
+    [[nodiscard]] bool HasWindows() const { return WindowCount > 0; }
+
+    // Slots of removed windows stay empty; their rects are zero
+    [[nodiscard]] uint32_t GetSurfaceCount() const { return static_cast<uint32_t>(Surfaces.size()); }
+
+    // The region of the canvas the surface shows, as fractions of it.
+    [[nodiscard]] Vec4 GetSurfaceRect(uint32_t Surface) const;
+
+    // The main window's size without extra windows.
+    void GetCanvasSize(int& Width, int& Height) const;
+
+    // The texture to render this frame into. Reallocates the canvas if the layout changed, and
+    // makes the GPU wait for the present threads still reading it.
+    unsigned int BeginFrame();
+
+    // After the frame's commands: hands the canvas to the present threads, and blits the main
+    // window's region into the default framebuffer.
+    void EndFrame();
+
+private:
+    struct Surface {
+        std::unique_ptr<IWindow> Window;
+        std::thread Thread;
+        // Framebuffer size and place in the canvas, kept by the main thread
+        int Width = 0;
+        int Height = 0;
+        int X = 0;
+        // The same for the frame last handed out; guarded by Mutex
+        int RegionX = 0;
+        int RegionWidth = 0;
+        int RegionHeight = 0;
+        bool Stop = false;
+        bool Active = false;
+    };
+
+    static constexpr uint32_t CanvasCount = 2;
+
+    void PresentLoop(Surface& Target);
+    void Layout();
+    // With no present thread left reading it
+    void DestroyCanvas();
+
+    FrameGraph& Graph;
+    std::vector<std::unique_ptr<Surface>> Surfaces;
+    uint32_t WindowCount = 0;
+    int CanvasWidth = 0;
+    int CanvasHeight = 0;
+    bool LayoutChanged = false;
+
+    unsigned int Canvas[CanvasCount] = {};
+    unsigned int ReadFramebuffers[CanvasCount] = {};
+    int AllocatedWidth = 0;
+    int AllocatedHeight = 0;
+    uint32_t CurrentCanvas = 0;
+
+    // Shared with the present threads
+    std::mutex Mutex;
+    std::condition_variable FrameCondition;
+    std::condition_variable ReaderCondition;
+    uint64_t PublishedFrame = 0;
+    uint32_t PublishedCanvas = CanvasCount - 1;
+    // Zero while the canvas is being reallocated: nothing to present
+    unsigned int PublishedTexture = 0;
+    // Signalled when the frame in each canvas has rendered; deleted when the canvas is reused
+    void* RenderedFences[CanvasCount] = {};
+    // Present threads between picking a canvas and fencing their reads of it
+    uint32_t Readers[CanvasCount] = {};
+    // Signalled when a present thread's draw from the canvas has finished
+    std::vector<void*> ReadFences[CanvasCount];
+};
+
+} // namespace Volante
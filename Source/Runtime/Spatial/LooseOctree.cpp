@@ -0,0 +1,460 @@
+#include "LooseOctree.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <queue>
+
+#include "Runtime/Core/Async/JobSystem.h"
+
+namespace Volante {
+
+namespace {
+
+constexpr uint32_t BuildGrain = 4096;
+
+} // namespace
+
+LooseOctree::LooseOctree(const AABB& WorldBounds, uint32_t InMaxDepth)
+    : Origin(WorldBounds.Min), MaxDepth(std::min(InMaxDepth, MaxSupportedDepth)) {
+    const Vec3 Size = WorldBounds.Max - WorldBounds.Min;
+    RootSize = std::max(std::max(Size.x, Size.y), std::max(Size.z, 1e-3f));
+
+    uint32_t Total = 0;
+    for (uint32_t Depth = 0; Depth <= MaxDepth; ++Depth) {
+        LevelOffsets.push_back(Total);
+        Total += 1u << (3 * Depth);
+    }
+    Nodes.resize(Total);
+}
+
+template <typename NodeTestFn, typename ItemFn>
+void LooseOctree::Traverse(const NodeTestFn& NodeTest, const ItemFn& OnItem) const {
+    if (Count == 0) { return; }
+
+    NodeCoord Stack[8 * MaxSupportedDepth + 1];
+    uint32_t StackSize = 0;
+
+    // The root also holds items outside the world bounds, so it is never culled as a whole.
+    for (int32_t Id = Nodes[0].FirstItem; Id >= 0; Id = Next[Id]) {
+        OnItem(static_cast<SpatialId>(Id), false);
+    }
+    if (MaxDepth == 0) { return; }
+    for (uint32_t Child = 0; Child < 8; ++Child) {
+        Stack[StackSize++] = GetChildCoord({0, 0, 0, 0}, Child);
+    }
+
+    while (StackSize > 0) {
+        const NodeCoord Coord = Stack[--StackSize];
+        const Node& Current = Nodes[GetNodeIndex(Coord)];
+        if (Current.SubtreeCount == 0) { continue; }
+
+        const Containment Result = NodeTest(GetLooseBounds(Coord));
+        if (Result == Containment::Outside) { continue; }
+        if (Result == Containment::Inside) {
+            VisitSubtree(Coord, OnItem);
+            continue;
+        }
+
+        for (int32_t Id = Current.FirstItem; Id >= 0; Id = Next[Id]) {
+            OnItem(static_cast<SpatialId>(Id), false);
+        }
+        if (Coord.Depth == MaxDepth) { continue; }
+        for (uint32_t Child = 0; Child < 8; ++Child) {
+            Stack[StackSize++] = GetChildCoord(Coord, Child);
+        }
+    }
+}
+
+template <typename ItemFn>
+void LooseOctree::VisitSubtree(const NodeCoord& Root, const ItemFn& OnItem) const {
+    NodeCoord Stack[8 * MaxSupportedDepth + 1];
+    uint32_t StackSize = 0;
+    Stack[StackSize++] = Root;
+
+    while (StackSize > 0) {
+        const NodeCoord Coord = Stack[--StackSize];
+        const Node& Current = Nodes[GetNodeIndex(Coord)];
+        if (Current.SubtreeCount == 0) { continue; }
+
+        for (int32_t Id = Current.FirstItem; Id >= 0; Id = Next[Id]) {
+            OnItem(static_cast<SpatialId>(Id), true);
+        }
+        if (Coord.Depth == MaxDepth) { continue; }
+        for (uint32_t Child = 0; Child < 8; ++Child) {
+            Stack[StackSize++] = GetChildCoord(Coord, Child);
+        }
+    }
+}
+
+template <typename ItemFn>
+bool LooseOctree::VisitNodesOverlapping(const AABB& Box, const ItemFn& OnItem) const {
+    // Per level, an item's loose cell overlaps Box only if its cell lies in Box grown by half a
+    // cell. Large boxes would touch too many cells this way and go through Traverse instead.
+    const Vec3 Size = Box.Max - Box.Min;
+    const float LeafSize = RootSize / static_cast<float>(1u << MaxDepth);
+    if (std::max(std::max(Size.x, Size.y), Size.z) > LeafSize * DirectQueryCells) { return false; }
+
+    for (int32_t Id = Nodes[0].FirstItem; Id >= 0; Id = Next[Id]) {
+        OnItem(static_cast<SpatialId>(Id));
+    }
+
+    for (uint32_t Depth = 1; Depth <= MaxDepth; ++Depth) {
+        const uint32_t Side = 1u << Depth;
+        const float CellSize = RootSize / static_cast<float>(Side);
+        const Vec3 Lo = glm::floor((Box.Min - Origin - Vec3(CellSize * 0.5f)) / CellSize);
+        const Vec3 Hi = glm::floor((Box.Max - Origin + Vec3(CellSize * 0.5f)) / CellSize);
+        const float Limit = static_cast<float>(Side - 1);
+        if (Hi.x < 0.0f || Hi.y < 0.0f || Hi.z < 0.0f || Lo.x > Limit || Lo.y > Limit || Lo.z > Limit) {
+            continue;
+        }
+
+        const auto ToCell = [Limit](float Value) {
+            return static_cast<uint32_t>(std::clamp(Value, 0.0f, Limit));
+        };
+        for (uint32_t Z = ToCell(Lo.z); Z <= ToCell(Hi.z); ++Z) {
+            for (uint32_t Y = ToCell(Lo.y); Y <= ToCell(Hi.y); ++Y) {
+                for (uint32_t X = ToCell(Lo.x); X <= ToCell(Hi.x); ++X) {
+                    const Node& Current = Nodes[GetNodeIndex({Depth, X, Y, Z})];
+                    for (int32_t Id = Current.FirstItem; Id >= 0; Id = Next[Id]) {
+                        OnItem(static_cast<SpatialId>(Id));
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+
+void LooseOctree::Build(std::span<const SpatialItem> Items, JobSystem* Jobs) {
+    Clear();
+    if (Items.empty()) { return; }
+
+    SpatialId MaxId = 0;
+    for (const SpatialItem& Item : Items) {
+        MaxId = std::max(MaxId, Item.Id);
+    }
+    EnsureCapacity(MaxId);
+
+    const auto ItemCount = static_cast<uint32_t>(Items.size());
+
+    ParallelFor(Jobs, ItemCount, BuildGrain, [&](uint32_t Begin, uint32_t End) {
+        for (uint32_t i = Begin; i < End; ++i) {
+            const SpatialItem& Item = Items[i];
+            ItemBounds[Item.Id] = Item.Bounds;
+            ItemNode[Item.Id] = LocateNode(Item.Bounds);
+            Prev[Item.Id] = -1;
+        }
+    });
+
+    // Lock-free linking: every item swaps itself in as the head of its node's list.
+    ParallelFor(Jobs, ItemCount, BuildGrain, [&](uint32_t Begin, uint32_t End) {
+        for (uint32_t i = Begin; i < End; ++i) {
+            const SpatialId Id = Items[i].Id;
+            Node& Target = Nodes[ItemNode[Id]];
+            Next[Id] = std::atomic_ref(Target.FirstItem).exchange(static_cast<int32_t>(Id));
+            std::atomic_ref(Target.ItemCount).fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+
+    ParallelFor(Jobs, ItemCount, BuildGrain, [&](uint32_t Begin, uint32_t End) {
+        for (uint32_t i = Begin; i < End; ++i) {
+            const SpatialId Id = Items[i].Id;
+            if (Next[Id] >= 0) { Prev[Next[Id]] = static_cast<int32_t>(Id); }
+        }
+    });
+
+    // Subtree counts bottom-up, one level at a time.
+    for (uint32_t Depth = MaxDepth + 1; Depth-- > 0;) {
+        const uint32_t Side = 1u << Depth;
+        const uint32_t LevelCount = Side * Side * Side;
+        ParallelFor(Jobs, LevelCount, BuildGrain, [&](uint32_t Begin, uint32_t End) {
+            for (uint32_t i = Begin; i < End; ++i) {
+                Node& Current = Nodes[LevelOffsets[Depth] + i];
+                uint32_t Sum = Current.ItemCount;
+                if (Depth < MaxDepth) {
+                    const NodeCoord Coord = GetNodeCoord(LevelOffsets[Depth] + i);
+                    for (uint32_t Child = 0; Child < 8; ++Child) {
+                        Sum += Nodes[GetNodeIndex(GetChildCoord(Coord, Child))].SubtreeCount;
+                    }
+                }
+                Current.SubtreeCount = Sum;
+            }
+        });
+    }
+
+    Count = ItemCount;
+}
+
+void LooseOctree::Clear() {
+    std::fill(Nodes.begin(), Nodes.end(), Node{});
+    std::fill(ItemNode.begin(), ItemNode.end(), InvalidNode);
+    Count = 0;
+}
+
+void LooseOctree::Insert(SpatialId Id, const AABB& Bounds) {
+    EnsureCapacity(Id);
+    if (ItemNode[Id] != InvalidNode) {
+        Update(Id, Bounds);
+        return;
+    }
+
+    ItemBounds[Id] = Bounds;
+    Link(Id, LocateNode(Bounds));
+    ++Count;
+}
+
+void LooseOctree::Update(SpatialId Id, const AABB& Bounds) {
+    if (Id >= ItemNode.size() || ItemNode[Id] == InvalidNode) {
+        Insert(Id, Bounds);
+        return;
+    }
+
+    ItemBounds[Id] = Bounds;
+    const uint32_t NewNode = LocateNode(Bounds);
+    if (NewNode != ItemNode[Id]) {
+        Unlink(Id);
+        Link(Id, NewNode);
+    }
+}
+
+void LooseOctree::Remove(SpatialId Id) {
+    if (Id >= ItemNode.size() || ItemNode[Id] == InvalidNode) { return; }
+
+    Unlink(Id);
+    --Count;
+}
+
+void LooseOctree::QueryAABB(const AABB& Box, std::vector<SpatialId>& OutIds) const {
+    if (Count == 0) { return; }
+
+    const bool Direct = VisitNodesOverlapping(Box, [&](SpatialId Id) {
+        if (ItemBounds[Id].Intersects(Box)) { OutIds.push_back(Id); }
+    });
+    if (Direct) { return; }
+
+    Traverse([&](const AABB& Loose) {
+        if (!Loose.Intersects(Box)) { return Containment::Outside; }
+        const bool Inside = Box.Contains(Loose.Min) && Box.Contains(Loose.Max);
+        return Inside ? Containment::Inside : Containment::Intersects;
+    },
+             [&](SpatialId Id, bool Contained) {
+                 if (Contained || ItemBounds[Id].Intersects(Box)) { OutIds.push_back(Id); }
+             });
+}
+
+void LooseOctree::QuerySphere(const Vec3& Center, float Radius, std::vector<SpatialId>& OutIds) const {
+    if (Count == 0) { return; }
+
+    const float RadiusSq = Radius * Radius;
+    const bool Direct = VisitNodesOverlapping(AABB::FromCenterExtent(Center, Vec3(Radius)), [&](SpatialId Id) {
+        if (ItemBounds[Id].DistanceSquared(Center) <= RadiusSq) { OutIds.push_back(Id); }
+    });
+    if (Direct) { return; }
+
+    Traverse([&](const AABB& Loose) {
+        if (Loose.DistanceSquared(Center) > RadiusSq) { return Containment::Outside; }
+        const Vec3 Far = glm::max(glm::abs(Loose.Min - Center), glm::abs(Loose.Max - Center));
+        return dot(Far, Far) <= RadiusSq ? Containment::Inside : Containment::Intersects;
+    },
+             [&](SpatialId Id, bool Contained) {
+                 if (Contained || ItemBounds[Id].DistanceSquared(Center) <= RadiusSq) {
+                     OutIds.push_back(Id);
+                 }
+             });
+}
+
+void LooseOctree::QueryFrustum(const Frustum& View, std::vector<SpatialId>& OutIds) const {
+    Traverse([&](const AABB& Loose) { return View.Classify(Loose); },
+             [&](SpatialId Id, bool Contained) {
+                 if (Contained || View.Intersects(ItemBounds[Id])) { OutIds.push_back(Id); }
+             });
+}
+
+bool LooseOctree::Raycast(const Ray& InRay, float MaxDistance, SpatialHit& OutHit) const {
+    const Vec3 InvDir = InRay.GetInverseDirection();
+    float Best = MaxDistance;
+    SpatialId BestId = InvalidSpatialId;
+
+    Traverse([&](const AABB& Loose) {
+        float T;
+        return IntersectRayAABB(InRay.Origin, InvDir, Loose, Best, T) ? Containment::Intersects
+                                                                       : Containment::Outside;
+    },
+             [&](SpatialId Id, bool) {
+                 float T;
+                 if (IntersectRayAABB(InRay.Origin, InvDir, ItemBounds[Id], Best, T) && T <= Best) {
+                     Best = T;
+                     BestId = Id;
+                 }
+             });
+
+    if (BestId == InvalidSpatialId) { return false; }
+    OutHit = {BestId, Best};
+    return true;
+}
+
+void LooseOctree::QueryNearest(const Vec3& Point, uint32_t K, float MaxDistance,
+                               std::vector<SpatialHit>& OutHits) const {
+    OutHits.clear();
+    if (K == 0 || Count == 0) { return; }
+
+    struct Candidate {
+        float DistanceSq;
+        uint32_t NodeIndex;
+        bool operator>(const Candidate& Other) const { return DistanceSq > Other.DistanceSq; }
+    };
+
+    const float MaxDistanceSq = MaxDistance * MaxDistance;
+    std::priority_queue<Candidate, std::vector<Candidate>, std::greater<>> Open;
+    Open.push({0.0f, 0});
+
+    // OutHits is used as a max-heap on squared distance while searching.
+    while (!Open.empty()) {
+        const Candidate Current = Open.top();
+        Open.pop();
+
+        if (Current.DistanceSq > MaxDistanceSq) { break; }
+        if (OutHits.size() == K && Current.DistanceSq >= OutHits.front().Distance) { break; }
+
+        const Node& N = Nodes[Current.NodeIndex];
+        for (int32_t Id = N.FirstItem; Id >= 0; Id = Next[Id]) {
+            const float DistanceSq = ItemBounds[Id].DistanceSquared(Point);
+            if (DistanceSq <= MaxDistanceSq) {
+                SpatialDetail::PushNearest(OutHits, K, static_cast<SpatialId>(Id), DistanceSq);
+            }
+        }
+
+        const NodeCoord Coord = GetNodeCoord(Current.NodeIndex);
+        if (Coord.Depth == MaxDepth) { continue; }
+        for (uint32_t Child = 0; Child < 8; ++Child) {
+            const NodeCoord ChildCoord = GetChildCoord(Coord, Child);
+            const uint32_t ChildIndex = GetNodeIndex(ChildCoord);
+            if (Nodes[ChildIndex].SubtreeCount == 0) { continue; }
+            const float DistanceSq = GetLooseBounds(ChildCoord).DistanceSquared(Point);
+            if (DistanceSq > MaxDistanceSq) { continue; }
+            if (OutHits.size() == K && DistanceSq >= OutHits.front().Distance) { continue; }
+            Open.push({DistanceSq, ChildIndex});
+        }
+    }
+
+    SpatialDetail::FinishNearest(OutHits);
+}
+
+uint32_t LooseOctree::LocateNode(const AABB& Bounds) const {
+    const Vec3 Center = Bounds.GetCenter();
+    const Vec3 Local = (Center - Origin) / RootSize;
+    if (Local.x < 0.0f || Local.y < 0.0f || Local.z < 0.0f || Local.x >= 1.0f || Local.y >= 1.0f ||
+        Local.z >= 1.0f) {
+        return 0;
+    }
+
+    const Vec3 Size = Bounds.Max - Bounds.Min;
+    const float Largest = std::max(std::max(Size.x, Size.y), Size.z);
+
+    uint32_t Depth = MaxDepth;
+    if (Largest > 0.0f) {
+        const float Fit = std::floor(std::log2(RootSize / Largest));
+        Depth = static_cast<uint32_t>(std::clamp(Fit, 0.0f, static_cast<float>(MaxDepth)));
+        while (Depth > 0 && RootSize / static_cast<float>(1u << Depth) < Largest) {
+            --Depth;
+        }
+    }
+
+    const auto Side = static_cast<float>(1u << Depth);
+    const uint32_t Limit = (1u << Depth) - 1;
+    return GetNodeIndex({Depth, std::min(static_cast<uint32_t>(Local.x * Side), Limit),
+                         std::min(static_cast<uint32_t>(Local.y * Side), Limit),
+                         std::min(static_cast<uint32_t>(Local.z * Side), Limit)});
+}
+
+uint32_t LooseOctree::GetNodeIndex(const NodeCoord& Coord) const {
+    return LevelOffsets[Coord.Depth] + (SpreadBits(Coord.X) | (SpreadBits(Coord.Y) << 1) | (SpreadBits(Coord.Z) << 2));
+}
+
+LooseOctree::NodeCoord LooseOctree::GetNodeCoord(uint32_t Index) const {
+    uint32_t Depth = MaxDepth;
+    while (LevelOffsets[Depth] > Index) {
+        --Depth;
+    }
+
+    const uint32_t Local = Index - LevelOffsets[Depth];
+    return {Depth, CompactBits(Local), CompactBits(Local >> 1), CompactBits(Local >> 2)};
+}
+
+LooseOctree::NodeCoord LooseOctree::GetChildCoord(const NodeCoord& Coord, uint32_t Child) {
+    return {Coord.Depth + 1, Coord.X * 2 + (Child & 1), Coord.Y * 2 + ((Child >> 1) & 1),
+            Coord.Z * 2 + (Child >> 2)};
+}
+
+uint32_t LooseOctree::SpreadBits(uint32_t Value) {
+    Value &= 0x3FF;
+    Value = (Value | (Value << 16)) & 0x030000FF;
+    Value = (Value | (Value << 8)) & 0x0300F00F;
+    Value = (Value | (Value << 4)) & 0x030C30C3;
+    Value = (Value | (Value << 2)) & 0x09249249;
+    return Value;
+}
+
+uint32_t LooseOctree::CompactBits(uint32_t Value) {
+    Value &= 0x09249249;
+    Value = (Value | (Value >> 2)) & 0x030C30C3;
+    Value = (Value | (Value >> 4)) & 0x0300F00F;
+    Value = (Value | (Value >> 8)) & 0x030000FF;
+    Value = (Value | (Value >> 16)) & 0x3FF;
+    return Value;
+}
+
+AABB LooseOctree::GetLooseBounds(const NodeCoord& Coord) const {
+    const float CellSize = RootSize / static_cast<float>(1u << Coord.Depth);
+    const Vec3 Min = Origin + Vec3(static_cast<float>(Coord.X), static_cast<float>(Coord.Y),
+                                   static_cast<float>(Coord.Z)) * CellSize;
+    const float Half = CellSize * 0.5f;
+    return {Min - Vec3(Half), Min + Vec3(CellSize + Half)};
+}
+
+void LooseOctree::EnsureCapacity(SpatialId Id) {
+    if (Id < ItemNode.size()) { return; }
+
+    const size_t NewSize = std::max<size_t>(static_cast<size_t>(Id) + 1, ItemNode.size() * 2);
+    ItemBounds.resize(NewSize);
+    ItemNode.resize(NewSize, InvalidNode);
+    Next.resize(NewSize, -1);
+    Prev.resize(NewSize, -1);
+}
+
+void LooseOctree::Link(SpatialId Id, uint32_t NodeIndex) {
+    Node& Target = Nodes[NodeIndex];
+    Next[Id] = Target.FirstItem;
+    Prev[Id] = -1;
+    if (Target.FirstItem >= 0) { Prev[Target.FirstItem] = static_cast<int32_t>(Id); }
+    Target.FirstItem = static_cast<int32_t>(Id);
+    ++Target.ItemCount;
+    ItemNode[Id] = NodeIndex;
+    AdjustSubtreeCounts(NodeIndex, 1);
+}
+
+void LooseOctree::Unlink(SpatialId Id) {
+    const uint32_t NodeIndex = ItemNode[Id];
+    Node& Owner = Nodes[NodeIndex];
+    if (Prev[Id] >= 0) {
+        Next[Prev[Id]] = Next[Id];
+    } else {
+        Owner.FirstItem = Next[Id];
+    }
+    if (Next[Id] >= 0) { Prev[Next[Id]] = Prev[Id]; }
+    --Owner.ItemCount;
+    ItemNode[Id] = InvalidNode;
+    AdjustSubtreeCounts(NodeIndex, -1);
+}
+
+void LooseOctree::AdjustSubtreeCounts(uint32_t NodeIndex, int32_t Delta) {
+    NodeCoord Coord = GetNodeCoord(NodeIndex);
+    for (;;) {
+        Nodes[GetNodeIndex(Coord)].SubtreeCount += Delta;
+        if (Coord.Depth == 0) { break; }
+        Coord = {Coord.Depth - 1, Coord.X >> 1, Coord.Y >> 1, Coord.Z >> 1};
+    }
+}
+
+} // namespace Volante
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "SpatialPartition.h"
+
+namespace Volante {
+
+// Loose octree (looseness 2) stored as dense per-level node arrays in Morton order, so the eight
+// children of a node are adjacent in memory. An item lives in exactly one node, chosen from its
+// size and center, so moving an item that stays in its cell is O(1).
+// Items whose center leaves the world bounds are kept in the root, which is always visited.
+class LooseOctree final : public ISpatialPartition {
+public:
+    static constexpr uint32_t MaxSupportedDepth = 7;
+
+    explicit LooseOctree(const AABB& WorldBounds, uint32_t MaxDepth = 6);
+
+    void Build(std::span<const SpatialItem> Items, JobSystem* Jobs) override;
+    void Clear() override;
+
+    void Insert(SpatialId Id, const AABB& Bounds) override;
+    void Update(SpatialId Id, const AABB& Bounds) override;
+    void Remove(SpatialId Id) override;
+
+    void QueryAABB(const AABB& Box, std::vector<SpatialId>& OutIds) const override;
+    void QuerySphere(const Vec3& Center, float Radius, std::vector<SpatialId>& OutIds) const override;
+    void QueryFrustum(const Frustum& View, std::vector<SpatialId>& OutIds) const override;
+    bool Raycast(const Ray& InRay, float MaxDistance, SpatialHit& OutHit) const override;
+    void QueryNearest(const Vec3& Point, uint32_t K, float MaxDistance,
+                      std::vector<SpatialHit>& OutHits) const override;
+
+    [[nodiscard]] uint32_t GetCount() const override { return Count; }
+
+    [[nodiscard]] uint32_t GetMaxDepth() const { return MaxDepth; }
+
+private:
+    static constexpr uint32_t InvalidNode = ~0u;
+    static constexpr float DirectQueryCells = 4.0f;
+
+    struct Node {
+        int32_t FirstItem = -1;
+        uint32_t ItemCount = 0;
+        uint32_t SubtreeCount = 0;
+    };
+
+    struct NodeCoord {
+        uint32_t Depth;
+        uint32_t X, Y, Z;
+    };
+
+    [[nodiscard]] uint32_t LocateNode(const AABB& Bounds) const;
+    [[nodiscard]] uint32_t GetNodeIndex(const NodeCoord& Coord) const;
+    [[nodiscard]] NodeCoord GetNodeCoord(uint32_t Index) const;
+    [[nodiscard]] AABB GetLooseBounds(const NodeCoord& Coord) const;
+    [[nodiscard]] static NodeCoord GetChildCoord(const NodeCoord& Coord, uint32_t Child);
+    [[nodiscard]] static uint32_t SpreadBits(uint32_t Value);
+    [[nodiscard]] static uint32_t CompactBits(uint32_t Value);
+
+    void EnsureCapacity(SpatialId Id);
+    void Link(SpatialId Id, uint32_t NodeIndex);
+    void Unlink(SpatialId Id);
+    void AdjustSubtreeCounts(uint32_t NodeIndex, int32_t Delta);
+
+    // Visits every non-empty node whose loose bounds pass NodeTest; NodeTest returns
+    // Containment so fully contained subtrees skip per-item tests.
+    template <typename NodeTestFn, typename ItemFn>
+    void Traverse(const NodeTestFn& NodeTest, const ItemFn& OnItem) const;
+
+    template <typename ItemFn>
+    void VisitSubtree(const NodeCoord& Coord, const ItemFn& OnItem) const;
+
+    // Small-box fast path: walks the overlapping cell range of every level directly instead of
+    // descending from the root. Returns false when Box is too large for that to pay off.
+    template <typename ItemFn>
+    bool VisitNodesOverlapping(const AABB& Box, const ItemFn& OnItem) const;
+
+    Vec3 Origin;
+    float RootSize;
+    uint32_t MaxDepth;
+
+    std::vector<uint32_t> LevelOffsets;
+    std::vector<Node> Nodes;
+
+    std::vector<AABB> ItemBounds;
+    std::vector<uint32_t> ItemNode;
+    std::vector<int32_t> Next;
+    std::vector<int32_t> Prev;
+    uint32_t Count = 0;
+};
+
+} // namespace Volante
@@ -0,0 +1,531 @@
+#include "SpatialHashGrid.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <mutex>
+
+#include "Runtime/Core/Async/JobSystem.h"
+
+namespace Volante {
+
+namespace {
+
+constexpr uint32_t BuildGrain = 4096;
+constexpr uint32_t MinCapacity = 64;
+constexpr int32_t KeyBias = 1 << 20;
+constexpr uint64_t KeyMask = (1ull << 21) - 1;
+
+uint32_t CapacityFor(uint32_t CellCount) {
+    return std::bit_ceil(std::max(MinCapacity, CellCount * 2));
+}
+
+} // namespace
+
+SpatialHashGrid::SpatialHashGrid(float InCellSize)
+    : CellSize(std::max(InCellSize, 1e-3f)), InvCellSize(1.0f / CellSize) {
+    Rehash(MinCapacity);
+}
+
+template <typename CellFn>
+void SpatialHashGrid::ForEachCellInRange(const CellCoord& Min, const CellCoord& Max,
+                                         const CellFn& Fn) const {
+    const CellCoord Lo = {std::max(Min.X, OccupiedMin.X), std::max(Min.Y, OccupiedMin.Y),
+                          std::max(Min.Z, OccupiedMin.Z)};
+    const CellCoord Hi = {std::min(Max.X, OccupiedMax.X), std::min(Max.Y, OccupiedMax.Y),
+                          std::min(Max.Z, OccupiedMax.Z)};
+    if (Lo.X > Hi.X || Lo.Y > Hi.Y || Lo.Z > Hi.Z) { return; }
+
+    const uint64_t RangeCells = static_cast<uint64_t>(Hi.X - Lo.X + 1) *
+                                static_cast<uint64_t>(Hi.Y - Lo.Y + 1) *
+                                static_cast<uint64_t>(Hi.Z - Lo.Z + 1);
+
+    if (RangeCells > UsedCells) {
+        for (const Cell& Current : Cells) {
+            if (Current.Key == EmptyKey || Current.ItemCount == 0) { continue; }
+            const CellCoord Coord = UnpackKey(Current.Key);
+            if (Coord.X < Lo.X || Coord.X > Hi.X || Coord.Y < Lo.Y || Coord.Y > Hi.Y ||
+                Coord.Z < Lo.Z || Coord.Z > Hi.Z) {
+                continue;
+            }
+            Fn(Current);
+        }
+        return;
+    }
+
+    for (int32_t Z = Lo.Z; Z <= Hi.Z; ++Z) {
+        for (int32_t Y = Lo.Y; Y <= Hi.Y; ++Y) {
+            for (int32_t X = Lo.X; X <= Hi.X; ++X) {
+                const uint32_t Index = FindCell({X, Y, Z});
+                if (Index != InvalidCell && Cells[Index].ItemCount > 0) { Fn(Cells[Index]); }
+            }
+        }
+    }
+}
+
+void SpatialHashGrid::Build(std::span<const SpatialItem> Items, JobSystem* Jobs) {
+    Clear();
+    if (Items.empty()) { return; }
+
+    SpatialId MaxId = 0;
+    for (const SpatialItem& Item : Items) {
+        MaxId = std::max(MaxId, Item.Id);
+    }
+    EnsureCapacity(MaxId);
+
+    const auto ItemCount = static_cast<uint32_t>(Items.size());
+
+    // Every item could land in its own cell, so size the table for that up front; the parallel
+    // insert below never has to grow it.
+    Cells.assign(CapacityFor(ItemCount), Cell{});
+    CellShift = 64 - std::countr_zero(static_cast<uint32_t>(Cells.size()));
+
+    std::mutex MergeMutex;
+    std::atomic<uint32_t> NewCells{0};
+
+    ParallelFor(Jobs, ItemCount, BuildGrain, [&](uint32_t Begin, uint32_t End) {
+        float LocalExtent = 0.0f;
+        CellCoord LocalMin = {std::numeric_limits<int32_t>::max(), std::numeric_limits<int32_t>::max(),
+                              std::numeric_limits<int32_t>::max()};
+        CellCoord LocalMax = {std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::min(),
+                              std::numeric_limits<int32_t>::min()};
+        uint32_t LocalNewCells = 0;
+        const uint32_t Mask = static_cast<uint32_t>(Cells.size()) - 1;
+
+        for (uint32_t i = Begin; i < End; ++i) {
+            const SpatialItem& Item = Items[i];
+            const CellCoord Coord = GetCellCoord(Item.Bounds.GetCenter());
+            const uint64_t Key = PackKey(Coord);
+
+            uint32_t Slot = HashKey(Key);
+            for (;;) {
+                std::atomic_ref SlotKey(Cells[Slot].Key);
+                uint64_t Expected = SlotKey.load(std::memory_order_acquire);
+                if (Expected == EmptyKey && SlotKey.compare_exchange_strong(Expected, Key)) {
+                    ++LocalNewCells;
+                    break;
+                }
+                if (Expected == Key) { break; }
+                Slot = (Slot + 1) & Mask;
+            }
+
+            ItemBounds[Item.Id] = Item.Bounds;
+            ItemCell[Item.Id] = Slot;
+            Prev[Item.Id] = -1;
+            Next[Item.Id] = std::atomic_ref(Cells[Slot].FirstItem).exchange(static_cast<int32_t>(Item.Id));
+            std::atomic_ref(Cells[Slot].ItemCount).fetch_add(1, std::memory_order_relaxed);
+
+            const Vec3 Extent = Item.Bounds.GetExtent();
+            LocalExtent = std::max(LocalExtent, std::max(std::max(Extent.x, Extent.y), Extent.z));
+            LocalMin = {std::min(LocalMin.X, Coord.X), std::min(LocalMin.Y, Coord.Y),
+                        std::min(LocalMin.Z, Coord.Z)};
+            LocalMax = {std::max(LocalMax.X, Coord.X), std::max(LocalMax.Y, Coord.Y),
+                        std::max(LocalMax.Z, Coord.Z)};
+        }
+
+        NewCells.fetch_add(LocalNewCells, std::memory_order_relaxed);
+        std::lock_guard Lock(MergeMutex);
+        MaxExtent = std::max(MaxExtent, LocalExtent);
+        GrowOccupiedRange(LocalMin);
+        GrowOccupiedRange(LocalMax);
+    });
+
+    ParallelFor(Jobs, ItemCount, BuildGrain, [&](uint32_t Begin, uint32_t End) {
+        for (uint32_t i = Begin; i < End; ++i) {
+            const SpatialId Id = Items[i].Id;
+            if (Next[Id] >= 0) { Prev[Next[Id]] = static_cast<int32_t>(Id); }
+        }
+    });
+
+    UsedCells = NewCells.load();
+    Count = ItemCount;
+}
+
+void SpatialHashGrid::Clear() {
+    std::fill(Cells.begin(), Cells.end(), Cell{});
+    std::fill(ItemCell.begin(), ItemCell.end(), InvalidCell);
+    UsedCells = 0;
+    Count = 0;
+    MaxExtent = 0.0f;
+    OccupiedMin = {0, 0, 0};
+    OccupiedMax = {-1, -1, -1};
+}
+
+void SpatialHashGrid::Insert(SpatialId Id, const AABB& Bounds) {
+    EnsureCapacity(Id);
+    if (ItemCell[Id] != InvalidCell) {
+        Update(Id, Bounds);
+        return;
+    }
+
+    const CellCoord Coord = GetCellCoord(Bounds.GetCenter());
+    const Vec3 Extent = Bounds.GetExtent();
+    MaxExtent = std::max(MaxExtent, std::max(std::max(Extent.x, Extent.y), Extent.z));
+    GrowOccupiedRange(Coord);
+
+    ItemBounds[Id] = Bounds;
+    Link(Id, FindOrAddCell(PackKey(Coord)));
+    ++Count;
+}
+
+void SpatialHashGrid::Update(SpatialId Id, const AABB& Bounds) {
+    if (Id >= ItemCell.size() || ItemCell[Id] == InvalidCell) {
+        Insert(Id, Bounds);
+        return;
+    }
+
+    const CellCoord Coord = GetCellCoord(Bounds.GetCenter());
+    const uint64_t Key = PackKey(Coord);
+    const Vec3 Extent = Bounds.GetExtent();
+    MaxExtent = std::max(MaxExtent, std::max(std::max(Extent.x, Extent.y), Extent.z));
+    ItemBounds[Id] = Bounds;
+
+    if (Cells[ItemCell[Id]].Key == Key) { return; }
+
+    GrowOccupiedRange(Coord);
+    Unlink(Id);
+    Link(Id, FindOrAddCell(Key));
+}
+
+void SpatialHashGrid::Remove(SpatialId Id) {
+    if (Id >= ItemCell.size() || ItemCell[Id] == InvalidCell) { return; }
+
+    Unlink(Id);
+    --Count;
+}
+
+void SpatialHashGrid::QueryAABB(const AABB& Box, std::vector<SpatialId>& OutIds) const {
+    if (Count == 0) { return; }
+
+    const Vec3 Pad(MaxExtent);
+    ForEachCellInRange(GetCellCoord(Box.Min - Pad), GetCellCoord(Box.Max + Pad), [&](const Cell& Current) {
+        for (int32_t Id = Current.FirstItem; Id >= 0; Id = Next[Id]) {
+            if (ItemBounds[Id].Intersects(Box)) { OutIds.push_back(static_cast<SpatialId>(Id)); }
+        }
+    });
+}
+
+void SpatialHashGrid::QuerySphere(const Vec3& Center, float Radius, std::vector<SpatialId>& OutIds) const {
+    if (Count == 0) { return; }
+
+    const Vec3 Pad(Radius + MaxExtent);
+    const float RadiusSq = Radius * Radius;
+    ForEachCellInRange(GetCellCoord(Center - Pad), GetCellCoord(Center + Pad), [&](const Cell& Current) {
+        for (int32_t Id = Current.FirstItem; Id >= 0; Id = Next[Id]) {
+            if (ItemBounds[Id].DistanceSquared(Center) <= RadiusSq) {
+                OutIds.push_back(static_cast<SpatialId>(Id));
+            }
+        }
+    });
+}
+
+void SpatialHashGrid::QueryFrustum(const Frustum& View, std::vector<SpatialId>& OutIds) const {
+    if (Count == 0) { return; }
+
+    // Without a far plane the frustum is unbounded; the occupied range bounds the search instead
+    CellCoord Min = OccupiedMin;
+    CellCoord Max = OccupiedMax;
+    if (View.HasFarPlane()) {
+        const AABB Bounds = View.GetBounds();
+        const Vec3 Pad(MaxExtent);
+        Min = GetCellCoord(Bounds.Min - Pad);
+        Max = GetCellCoord(Bounds.Max + Pad);
+    }
+    ForEachCellInRange(Min, Max, [&](const Cell& Current) {
+        const Containment Result = View.Classify(GetPaddedCellBounds(UnpackKey(Current.Key)));
+        if (Result == Containment::Outside) { return; }
+
+        for (int32_t Id = Current.FirstItem; Id >= 0; Id = Next[Id]) {
+            if (Result == Containment::Inside || View.Intersects(ItemBounds[Id])) {
+                OutIds.push_back(static_cast<SpatialId>(Id));
+            }
+        }
+    });
+}
+
+bool SpatialHashGrid::Raycast(const Ray& InRay, float MaxDistance, SpatialHit& OutHit) const {
+    if (Count == 0) { return false; }
+
+    const Vec3 InvDir = InRay.GetInverseDirection();
+    const int32_t Radius = GetSearchRadius();
+
+    // Clip the ray to the occupied region first so rays from far away do not walk empty cells.
+    const AABB Occupied(Vec3(static_cast<float>(OccupiedMin.X - Radius), static_cast<float>(OccupiedMin.Y - Radius),
+                             static_cast<float>(OccupiedMin.Z - Radius)) * CellSize,
+                        Vec3(static_cast<float>(OccupiedMax.X + Radius + 1), static_cast<float>(OccupiedMax.Y + Radius + 1),
+                             static_cast<float>(OccupiedMax.Z + Radius + 1)) * CellSize);
+    float T;
+    if (!IntersectRayAABB(InRay.Origin, InvDir, Occupied, MaxDistance, T)) { return false; }
+
+    int32_t C[3];
+    int32_t Step[3];
+    float TMax[3];
+    float TDelta[3];
+    {
+        const CellCoord Start = GetCellCoord(InRay.At(T));
+        C[0] = Start.X;
+        C[1] = Start.Y;
+        C[2] = Start.Z;
+    }
+    for (int Axis = 0; Axis < 3; ++Axis) {
+        if (InRay.Direction[Axis] == 0.0f) {
+            Step[Axis] = 0;
+            TMax[Axis] = std::numeric_limits<float>::infinity();
+            TDelta[Axis] = std::numeric_limits<float>::infinity();
+            continue;
+        }
+        Step[Axis] = InRay.Direction[Axis] > 0.0f ? 1 : -1;
+        const float Boundary = static_cast<float>(C[Axis] + (Step[Axis] > 0 ? 1 : 0)) * CellSize;
+        TMax[Axis] = (Boundary - InRay.Origin[Axis]) * InvDir[Axis];
+        TDelta[Axis] = CellSize * std::abs(InvDir[Axis]);
+    }
+
+    const int32_t RangeMin[3] = {OccupiedMin.X - Radius, OccupiedMin.Y - Radius, OccupiedMin.Z - Radius};
+    const int32_t RangeMax[3] = {OccupiedMax.X + Radius, OccupiedMax.Y + Radius, OccupiedMax.Z + Radius};
+
+    float Best = MaxDistance;
+    SpatialId BestId = InvalidSpatialId;
+
+    auto TestCell = [&](int32_t X, int32_t Y, int32_t Z) {
+        const uint32_t Index = FindCell({X, Y, Z});
+        if (Index == InvalidCell) { return; }
+        for (int32_t Id = Cells[Index].FirstItem; Id >= 0; Id = Next[Id]) {
+            float HitT;
+            if (IntersectRayAABB(InRay.Origin, InvDir, ItemBounds[Id], Best, HitT) && HitT <= Best) {
+                Best = HitT;
+                BestId = static_cast<SpatialId>(Id);
+            }
+        }
+    };
+
+    // Any item touching the ray inside the current cell is stored within Radius cells of it.
+    // The first cell tests the whole neighbourhood; each step only adds the slab that entered it.
+    for (int32_t Z = -Radius; Z <= Radius; ++Z) {
+        for (int32_t Y = -Radius; Y <= Radius; ++Y) {
+            for (int32_t X = -Radius; X <= Radius; ++X) {
+                TestCell(C[0] + X, C[1] + Y, C[2] + Z);
+            }
+        }
+    }
+
+    for (;;) {
+        int Axis = 0;
+        if (TMax[1] < TMax[Axis]) { Axis = 1; }
+        if (TMax[2] < TMax[Axis]) { Axis = 2; }
+
+        const float Enter = TMax[Axis];
+        if (Enter > Best || Step[Axis] == 0) { break; }
+
+        C[Axis] += Step[Axis];
+        TMax[Axis] += TDelta[Axis];
+
+        if ((Step[Axis] > 0 && C[Axis] > RangeMax[Axis]) || (Step[Axis] < 0 && C[Axis] < RangeMin[Axis])) {
+            break;
+        }
+
+        const int U = (Axis + 1) % 3;
+        const int V = (Axis + 2) % 3;
+        int32_t Cell[3];
+        Cell[Axis] = C[Axis] + Step[Axis] * Radius;
+        for (int32_t A = -Radius; A <= Radius; ++A) {
+            for (int32_t B = -Radius; B <= Radius; ++B) {
+                Cell[U] = C[U] + A;
+                Cell[V] = C[V] + B;
+                TestCell(Cell[0], Cell[1], Cell[2]);
+            }
+        }
+    }
+
+    if (BestId == InvalidSpatialId) { return false; }
+    OutHit = {BestId, Best};
+    return true;
+}
+
+void SpatialHashGrid::QueryNearest(const Vec3& Point, uint32_t K, float MaxDistance,
+                                   std::vector<SpatialHit>& OutHits) const {
+    OutHits.clear();
+    if (K == 0 || Count == 0) { return; }
+
+    const CellCoord C = GetCellCoord(Point);
+    const float MaxDistanceSq = MaxDistance * MaxDistance;
+
+    auto VisitCell = [&](int32_t X, int32_t Y, int32_t Z) {
+        if (X < OccupiedMin.X || X > OccupiedMax.X || Y < OccupiedMin.Y || Y > OccupiedMax.Y ||
+            Z < OccupiedMin.Z || Z > OccupiedMax.Z) {
+            return;
+        }
+        const uint32_t Index = FindCell({X, Y, Z});
+        if (Index == InvalidCell) { return; }
+        for (int32_t Id = Cells[Index].FirstItem; Id >= 0; Id = Next[Id]) {
+            const float DistanceSq = ItemBounds[Id].DistanceSquared(Point);
+            if (DistanceSq <= MaxDistanceSq) {
+                SpatialDetail::PushNearest(OutHits, K, static_cast<SpatialId>(Id), DistanceSq);
+            }
+        }
+    };
+
+    // Rings closer than the occupied region hold nothing, so start at its Chebyshev distance.
+    const int32_t Gap = std::max({OccupiedMin.X - C.X, C.X - OccupiedMax.X, OccupiedMin.Y - C.Y,
+                                  C.Y - OccupiedMax.Y, OccupiedMin.Z - C.Z, C.Z - OccupiedMax.Z, 0});
+    const int32_t LastRing = std::max({C.X - OccupiedMin.X, OccupiedMax.X - C.X, C.Y - OccupiedMin.Y,
+                                       OccupiedMax.Y - C.Y, C.Z - OccupiedMin.Z, OccupiedMax.Z - C.Z});
+
+    for (int32_t Ring = Gap; Ring <= LastRing; ++Ring) {
+        const int32_t XMin = std::max(C.X - Ring, OccupiedMin.X);
+        const int32_t XMax = std::min(C.X + Ring, OccupiedMax.X);
+        const int32_t YMin = std::max(C.Y - Ring, OccupiedMin.Y);
+        const int32_t YMax = std::min(C.Y + Ring, OccupiedMax.Y);
+        for (int32_t X = XMin; X <= XMax; ++X) {
+            for (int32_t Y = YMin; Y <= YMax; ++Y) {
+                if (Ring == 0 || std::abs(X - C.X) == Ring || std::abs(Y - C.Y) == Ring) {
+                    const int32_t ZMin = std::max(C.Z - Ring, OccupiedMin.Z);
+                    const int32_t ZMax = std::min(C.Z + Ring, OccupiedMax.Z);
+                    for (int32_t Z = ZMin; Z <= ZMax; ++Z) {
+                        VisitCell(X, Y, Z);
+                    }
+                } else {
+                    VisitCell(X, Y, C.Z - Ring);
+                    VisitCell(X, Y, C.Z + Ring);
+                }
+            }
+        }
+
+        // Unvisited items sit in cells at least Ring whole cells away.
+        const float Reach = static_cast<float>(Ring) * CellSize - MaxExtent;
+        if (Reach > MaxDistance) { break; }
+        if (OutHits.size() == K && Reach > 0.0f && OutHits.front().Distance <= Reach * Reach) { break; }
+    }
+
+    SpatialDetail::FinishNearest(OutHits);
+}
+
+SpatialHashGrid::CellCoord SpatialHashGrid::GetCellCoord(const Vec3& Point) const {
+    const Vec3 Scaled = glm::floor(Point * InvCellSize);
+    return {static_cast<int32_t>(Scaled.x), static_cast<int32_t>(Scaled.y), static_cast<int32_t>(Scaled.z)};
+}
+
+uint64_t SpatialHashGrid::PackKey(const CellCoord& Coord) {
+    return (static_cast<uint64_t>(Coord.X + KeyBias) & KeyMask) |
+           ((static_cast<uint64_t>(Coord.Y + KeyBias) & KeyMask) << 21) |
+           ((static_cast<uint64_t>(Coord.Z + KeyBias) & KeyMask) << 42);
+}
+
+SpatialHashGrid::CellCoord SpatialHashGrid::UnpackKey(uint64_t Key) {
+    return {static_cast<int32_t>(Key & KeyMask) - KeyBias,
+            static_cast<int32_t>((Key >> 21) & KeyMask) - KeyBias,
+            static_cast<int32_t>((Key >> 42) & KeyMask) - KeyBias};
+}
+
+uint32_t SpatialHashGrid::HashKey(uint64_t Key) const {
+    return static_cast<uint32_t>((Key * 0x9E3779B97F4A7C15ull) >> CellShift);
+}
+
+uint32_t SpatialHashGrid::FindCell(const CellCoord& Coord) const {
+    const uint64_t Key = PackKey(Coord);
+    const uint32_t Mask = static_cast<uint32_t>(Cells.size()) - 1;
+    for (uint32_t Slot = HashKey(Key);; Slot = (Slot + 1) & Mask) {
+        if (Cells[Slot].Key == Key) { return Slot; }
+        if (Cells[Slot].Key == EmptyKey) { return InvalidCell; }
+    }
+}
+
+AABB SpatialHashGrid::GetPaddedCellBounds(const CellCoord& Coord) const {
+    const Vec3 Min = Vec3(static_cast<float>(Coord.X), static_cast<float>(Coord.Y),
+                          static_cast<float>(Coord.Z)) * CellSize;
+    return {Min - Vec3(MaxExtent), Min + Vec3(CellSize + MaxExtent)};
+}
+
+int32_t SpatialHashGrid::GetSearchRadius() const {
+    return static_cast<int32_t>(std::ceil(MaxExtent * InvCellSize));
+}
+
+uint32_t SpatialHashGrid::FindOrAddCell(uint64_t Key) {
+    // Emptied cells stay in the table until the next rehash, which also drops them.
+    if ((UsedCells + 1) * 2 > Cells.size()) {
+        uint32_t LiveCells = 1;
+        for (const Cell& Current : Cells) {
+            LiveCells += Current.ItemCount > 0 ? 1 : 0;
+        }
+        Rehash(CapacityFor(LiveCells * 2));
+    }
+
+    const uint32_t Mask = static_cast<uint32_t>(Cells.size()) - 1;
+    for (uint32_t Slot = HashKey(Key);; Slot = (Slot + 1) & Mask) {
+        if (Cells[Slot].Key == Key) { return Slot; }
+        if (Cells[Slot].Key == EmptyKey) {
+            Cells[Slot].Key = Key;
+            ++UsedCells;
+            return Slot;
+        }
+    }
+}
+
+void SpatialHashGrid::Rehash(uint32_t NewCapacity) {
+    std::vector<Cell> OldCells = std::move(Cells);
+    Cells.assign(NewCapacity, Cell{});
+    CellShift = 64 - std::countr_zero(NewCapacity);
+    UsedCells = 0;
+
+    const uint32_t Mask = NewCapacity - 1;
+    for (const Cell& Old : OldCells) {
+        if (Old.ItemCount == 0) { continue; }
+
+        uint32_t Slot = HashKey(Old.Key);
+        while (Cells[Slot].Key != EmptyKey) {
+            Slot = (Slot + 1) & Mask;
+        }
+        Cells[Slot] = Old;
+        ++UsedCells;
+        for (int32_t Id = Old.FirstItem; Id >= 0; Id = Next[Id]) {
+            ItemCell[Id] = Slot;
+        }
+    }
+}
+
+void SpatialHashGrid::EnsureCapacity(SpatialId Id) {
+    if (Id < ItemCell.size()) { return; }
+
+    const size_t NewSize = std::max<size_t>(static_cast<size_t>(Id) + 1, ItemCell.size() * 2);
+    ItemBounds.resize(NewSize);
+    ItemCell.resize(NewSize, InvalidCell);
+    Next.resize(NewSize, -1);
+    Prev.resize(NewSize, -1);
+}
+
+void SpatialHashGrid::Link(SpatialId Id, uint32_t CellIndex) {
+    Cell& Target = Cells[CellIndex];
+    Next[Id] = Target.FirstItem;
+    Prev[Id] = -1;
+    if (Target.FirstItem >= 0) { Prev[Target.FirstItem] = static_cast<int32_t>(Id); }
+    Target.FirstItem = static_cast<int32_t>(Id);
+    ++Target.ItemCount;
+    ItemCell[Id] = CellIndex;
+}
+
+void SpatialHashGrid::Unlink(SpatialId Id) {
+    Cell& Owner = Cells[ItemCell[Id]];
+    if (Prev[Id] >= 0) {
+        Next[Prev[Id]] = Next[Id];
+    } else {
+        Owner.FirstItem = Next[Id];
+    }
+    if (Next[Id] >= 0) { Prev[Next[Id]] = Prev[Id]; }
+    --Owner.ItemCount;
+    ItemCell[Id] = InvalidCell;
+}
+
+void SpatialHashGrid::GrowOccupiedRange(const CellCoord& Coord) {
+    if (OccupiedMin.X > OccupiedMax.X) {
+        OccupiedMin = Coord;
+        OccupiedMax = Coord;
+        return;
+    }
+    OccupiedMin = {std::min(OccupiedMin.X, Coord.X), std::min(OccupiedMin.Y, Coord.Y),
+                   std::min(OccupiedMin.Z, Coord.Z)};
+    OccupiedMax = {std::max(OccupiedMax.X, Coord.X), std::max(OccupiedMax.Y, Coord.Y),
+                   std::max(OccupiedMax.Z, Coord.Z)};
+}
+
+} // namespace Volante
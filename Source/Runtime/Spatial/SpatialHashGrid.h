@@ -0,0 +1,84 @@
+#pragma once
+
+#include "SpatialPartition.h"
+
+namespace Volante {
+
+// Unbounded uniform grid hashed into an open-addressing table. Items are bucketed by the cell
+// containing their center and queries are padded by the largest extent seen, so the grid works
+// best when CellSize is about twice the typical object size. Large or static geometry belongs
+// in the LooseOctree instead.
+class SpatialHashGrid final : public ISpatialPartition {
+public:
+    explicit SpatialHashGrid(float CellSize);
+
+    void Build(std::span<const SpatialItem> Items, JobSystem* Jobs) override;
+    void Clear() override;
+
+    void Insert(SpatialId Id, const AABB& Bounds) override;
+    void Update(SpatialId Id, const AABB& Bounds) override;
+    void Remove(SpatialId Id) override;
+
+    void QueryAABB(const AABB& Box, std::vector<SpatialId>& OutIds) const override;
+    void QuerySphere(const Vec3& Center, float Radius, std::vector<SpatialId>& OutIds) const override;
+    void QueryFrustum(const Frustum& View, std::vector<SpatialId>& OutIds) const override;
+    bool Raycast(const Ray& InRay, float MaxDistance, SpatialHit& OutHit) const override;
+    void QueryNearest(const Vec3& Point, uint32_t K, float MaxDistance,
+                      std::vector<SpatialHit>& OutHits) const override;
+
+    [[nodiscard]] uint32_t GetCount() const override { return Count; }
+
+    [[nodiscard]] float GetCellSize() const { return CellSize; }
+
+private:
+    static constexpr uint64_t EmptyKey = ~0ull;
+    static constexpr uint32_t InvalidCell = ~0u;
+
+    struct Cell {
+        uint64_t Key = EmptyKey;
+        int32_t FirstItem = -1;
+        uint32_t ItemCount = 0;
+    };
+
+    struct CellCoord {
+        int32_t X, Y, Z;
+    };
+
+    [[nodiscard]] CellCoord GetCellCoord(const Vec3& Point) const;
+    [[nodiscard]] static uint64_t PackKey(const CellCoord& Coord);
+    [[nodiscard]] static CellCoord UnpackKey(uint64_t Key);
+    [[nodiscard]] uint32_t HashKey(uint64_t Key) const;
+    [[nodiscard]] uint32_t FindCell(const CellCoord& Coord) const;
+    [[nodiscard]] AABB GetPaddedCellBounds(const CellCoord& Coord) const;
+    [[nodiscard]] int32_t GetSearchRadius() const;
+
+    uint32_t FindOrAddCell(uint64_t Key);
+    void Rehash(uint32_t NewCapacity);
+    void EnsureCapacity(SpatialId Id);
+    void Link(SpatialId Id, uint32_t CellIndex);
+    void Unlink(SpatialId Id);
+    void GrowOccupiedRange(const CellCoord& Coord);
+
+    // Calls Fn for every occupied cell in [Min, Max], scanning the table instead when the range
+    // covers more cells than are in use.
+    template <typename CellFn>
+    void ForEachCellInRange(const CellCoord& Min, const CellCoord& Max, const CellFn& Fn) const;
+
+    float CellSize;
+    float InvCellSize;
+    float MaxExtent = 0.0f;
+
+    std::vector<Cell> Cells;
+    uint32_t CellShift = 0;
+    uint32_t UsedCells = 0;
+    CellCoord OccupiedMin = {0, 0, 0};
+    CellCoord OccupiedMax = {-1, -1, -1};
+
+    std::vector<AABB> ItemBounds;
+    std::vector<uint32_t> ItemCell;
+    std::vector<int32_t> Next;
+    std::vector<int32_t> Prev;
+    uint32_t Count = 0;
+};
+
+} // namespace Volante
@@ -0,0 +1,123 @@
+#include "SpatialIndex.h"
+
+#include "LooseOctree.h"
+#include "SpatialHashGrid.h"
+
+namespace Volante {
+
+SpatialIndex::SpatialIndex(const SpatialIndexDesc& Desc, JobSystem* Jobs) : Desc(Desc), Jobs(Jobs) {
+    if (Desc.Type == SpatialPartitionType::HashGrid) {
+        Partition = std::make_unique<SpatialHashGrid>(Desc.CellSize);
+    } else {
+        Partition = std::make_unique<LooseOctree>(Desc.WorldBounds, Desc.MaxDepth);
+    }
+}
+
+SpatialIndex::~SpatialIndex() = default;
+
+void SpatialIndex::Initialize() {
+    // Nothing to set up; proxies are added by the world as entities spawn
+}
+
+void SpatialIndex::Shutdown() {
+    Partition->Clear();
+    Proxies.clear();
+    FreeIds.clear();
+    DirtyIds.clear();
+}
+
+void SpatialIndex::Update(float DeltaTime) {
+    // Flushed by the engine after the world update, once gameplay and physics have moved
+}
+
+SpatialId SpatialIndex::AddProxy(const AABB& Bounds, uint64_t UserData) {
+    SpatialId Id;
+    if (!FreeIds.empty()) {
+        Id = FreeIds.back();
+        FreeIds.pop_back();
+    } else {
+        Id = static_cast<SpatialId>(Proxies.size());
+        Proxies.emplace_back();
+    }
+
+    Proxy& Entry = Proxies[Id];
+    Entry.Bounds = Bounds;
+    Entry.UserData = UserData;
+    Entry.Alive = true;
+    Entry.Dirty = true;
+    DirtyIds.push_back(Id);
+    return Id;
+}
+
+void SpatialIndex::MoveProxy(SpatialId Id, const AABB& Bounds) {
+    Proxy& Entry = Proxies[Id];
+    Entry.Bounds = Bounds;
+    if (!Entry.Dirty) {
+        Entry.Dirty = true;
+        DirtyIds.push_back(Id);
+    }
+}
+
+void SpatialIndex::RemoveProxy(SpatialId Id) {
+    Proxy& Entry = Proxies[Id];
+    if (!Entry.Alive) { return; }
+
+    Partition->Remove(Id);
+    Entry.Alive = false;
+    Entry.Dirty = false;
+    FreeIds.push_back(Id);
+}
+
+void SpatialIndex::Flush() {
+    if (DirtyIds.empty()) { return; }
+
+    const auto AliveCount = static_cast<float>(Proxies.size() - FreeIds.size());
+    if (static_cast<float>(DirtyIds.size()) > AliveCount * Desc.RebuildThreshold) {
+        Rebuild();
+        return;
+    }
+
+    for (const SpatialId Id : DirtyIds) {
+        Proxy& Entry = Proxies[Id];
+        if (!Entry.Dirty) { continue; }
+        Entry.Dirty = false;
+        Partition->Update(Id, Entry.Bounds);
+    }
+    DirtyIds.clear();
+}
+
+void SpatialIndex::Rebuild() {
+    std::vector<SpatialItem> Items;
+    Items.reserve(Proxies.size() - FreeIds.size());
+    for (SpatialId Id = 0; Id < Proxies.size(); ++Id) {
+        Proxy& Entry = Proxies[Id];
+        Entry.Dirty = false;
+        if (Entry.Alive) { Items.push_back({Id, Entry.Bounds}); }
+    }
+    DirtyIds.clear();
+
+    Partition->Build(Items, Jobs);
+}
+
+void SpatialIndex::QueryAABB(const AABB& Box, std::vector<SpatialId>& OutIds) const {
+    Partition->QueryAABB(Box, OutIds);
+}
+
+void SpatialIndex::QuerySphere(const Vec3& Center, float Radius, std::vector<SpatialId>& OutIds) const {
+    Partition->QuerySphere(Center, Radius, OutIds);
+}
+
+void SpatialIndex::QueryFrustum(const Frustum& View, std::vector<SpatialId>& OutIds) const {
+    Partition->QueryFrustum(View, OutIds);
+}
+
+bool SpatialIndex::Raycast(const Ray& InRay, float MaxDistance, SpatialHit& OutHit) const {
+    return Partition->Raycast(InRay, MaxDistance, OutHit);
+}
+
+void SpatialIndex::QueryNearest(const Vec3& Point, uint32_t K, float MaxDistance,
+                                std::vector<SpatialHit>& OutHits) const {
+    Partition->QueryNearest(Point, K, MaxDistance, OutHits);
+}
+
+} // namespace Volante
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <memory>
+
+#include "Engine.h"
+#include "SpatialPartition.h"
+
+namespace Volante {
+
+enum class SpatialPartitionType {
+    LooseOctree,
+    HashGrid,
+};
+
+struct SpatialIndexDesc {
+    SpatialPartitionType Type = SpatialPartitionType::LooseOctree;
+    AABB WorldBounds = {Vec3(-4096.0f), Vec3(4096.0f)};
+    uint32_t MaxDepth = 6;
+    float CellSize = 16.0f;
+
+    // Flushing more dirty proxies than this fraction of the total triggers a parallel rebuild
+    // instead of incremental updates.
+    float RebuildThreshold = 0.25f;
+};
+
+// Owns proxy ids and bounds for everything that takes part in gameplay queries or visibility.
+// Moves are buffered and applied in Flush(), which the engine calls once per frame after the
+// world update; Update() does not flush. Queries are const and safe to run concurrently between
+// flushes.
+class SpatialIndex : public IEngineSubsystem {
+public:
+    explicit SpatialIndex(const SpatialIndexDesc& Desc = {}, JobSystem* Jobs = nullptr);
+    ~SpatialIndex() override;
+
+    void Initialize() override;
+    void Shutdown() override;
+    void Update(float DeltaTime) override;
+
+    SpatialId AddProxy(const AABB& Bounds, uint64_t UserData = 0);
+    void MoveProxy(SpatialId Id, const AABB& Bounds);
+    void RemoveProxy(SpatialId Id);
+
+    void Flush();
+    void Rebuild();
+
+    void QueryAABB(const AABB& Box, std::vector<SpatialId>& OutIds) const;
+    void QuerySphere(const Vec3& Center, float Radius, std::vector<SpatialId>& OutIds) const;
+    void QueryFrustum(const Frustum& View, std::vector<SpatialId>& OutIds) const;
+    bool Raycast(const Ray& InRay, float MaxDistance, SpatialHit& OutHit) const;
+    void QueryNearest(const Vec3& Point, uint32_t K, float MaxDistance, std::vector<SpatialHit>& OutHits) const;
+
+    [[nodiscard]] const AABB& GetBounds(SpatialId Id) const { return Proxies[Id].Bounds; }
+
+    [[nodiscard]] uint64_t GetUserData(SpatialId Id) const { return Proxies[Id].UserData; }
+
+    [[nodiscard]] uint32_t GetProxyCount() const { return Partition->GetCount(); }
+
+    [[nodiscard]] ISpatialPartition* GetPartition() const { return Partition.get(); }
+
+private:
+    struct Proxy {
+        AABB Bounds;
+        uint64_t UserData = 0;
+        bool Alive = false;
+        bool Dirty = false;
+    };
+
+    SpatialIndexDesc Desc;
+    JobSystem* Jobs;
+    std::unique_ptr<ISpatialPartition> Partition;
+
+    std::vector<Proxy> Proxies;
+    std::vector<SpatialId> FreeIds;
+    std::vector<SpatialId> DirtyIds;
+};
+
+} // namespace Volante
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Runtime/Core/Math/Bounds.h"
+
+namespace Volante {
+
+class JobSystem;
+
+using SpatialId = uint32_t;
+
+constexpr SpatialId InvalidSpatialId = ~0u;
+
+struct SpatialHit {
+    SpatialId Id = InvalidSpatialId;
+    float Distance = 0.0f;
+};
+
+struct SpatialItem {
+    SpatialId Id = InvalidSpatialId;
+    AABB Bounds;
+};
+
+// Common interface of the broad-phase structures. Ids are dense indices owned by the caller
+// (see SpatialIndex); const queries may run concurrently from any number of threads.
+class ISpatialPartition {
+public:
+    virtual ~ISpatialPartition() = default;
+
+    // Drops the current contents and inserts Items, using Jobs for the bulk work when given.
+    virtual void Build(std::span<const SpatialItem> Items, JobSystem* Jobs) = 0;
+    virtual void Clear() = 0;
+
+    virtual void Insert(SpatialId Id, const AABB& Bounds) = 0;
+    virtual void Update(SpatialId Id, const AABB& Bounds) = 0;
+    virtual void Remove(SpatialId Id) = 0;
+
+    virtual void QueryAABB(const AABB& Box, std::vector<SpatialId>& OutIds) const = 0;
+    virtual void QuerySphere(const Vec3& Center, float Radius, std::vector<SpatialId>& OutIds) const = 0;
+    virtual void QueryFrustum(const Frustum& View, std::vector<SpatialId>& OutIds) const = 0;
+    virtual bool Raycast(const Ray& InRay, float MaxDistance, SpatialHit& OutHit) const = 0;
+
+    // K closest items by distance from Point to their bounds, nearest first.
+    virtual void QueryNearest(const Vec3& Point, uint32_t K, float MaxDistance,
+                              std::vector<SpatialHit>& OutHits) const = 0;
+
+    [[nodiscard]] virtual uint32_t GetCount() const = 0;
+};
+
+namespace SpatialDetail {
+
+// K-nearest bookkeeping shared by the partitions: Heap is a max-heap on squared distance.
+inline void PushNearest(std::vector<SpatialHit>& Heap, uint32_t K, SpatialId Id, float DistanceSq) {
+    auto Less = [](const SpatialHit& A, const SpatialHit& B) { return A.Distance < B.Distance; };
+    if (Heap.size() < K) {
+        Heap.push_back({Id, DistanceSq});
+        std::push_heap(Heap.begin(), Heap.end(), Less);
+    } else if (DistanceSq < Heap.front().Distance) {
+        std::pop_heap(Heap.begin(), Heap.end(), Less);
+        Heap.back() = {Id, DistanceSq};
+        std::push_heap(Heap.begin(), Heap.end(), Less);
+    }
+}
+
+// Turns the heap into a nearest-first list of real distances.
+inline void FinishNearest(std::vector<SpatialHit>& Heap) {
+    std::sort_heap(Heap.begin(), Heap.end(),
+                   [](const SpatialHit& A, const SpatialHit& B) { return A.Distance < B.Distance; });
+    for (SpatialHit& Hit : Heap) {
+        Hit.Distance = std::sqrt(Hit.Distance);
+    }
+}
+
+} // namespace SpatialDetail
+
+} // namespace Volante
@@ -0,0 +1,127 @@
+#include "TerrainHeightSource.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace Volante {
+
+namespace {
+
+uint32_t Hash(int32_t X, int32_t Z, uint32_t Seed) {
+    uint32_t State = static_cast<uint32_t>(X) * 0x8DA6B343u ^ static_cast<uint32_t>(Z) * 0xD8163841u ^ Seed * 0xCB1AB31Fu;
+    State = State * 747796405u + 2891336453u;
+    const uint32_t Word = ((State >> ((State >> 28u) + 4u)) ^ State) * 277803737u;
+    return (Word >> 22u) ^ Word;
+}
+
+float Lattice(int32_t X, int32_t Z, uint32_t Seed) {
+    return static_cast<float>(Hash(X, Z, Seed) >> 8) * (2.0f / 16777215.0f) - 1.0f;
+}
+
+// -1..1, smooth between integer lattice points
+float ValueNoise(float X, float Z, uint32_t Seed) {
+    const float FloorX = std::floor(X);
+    const float FloorZ = std::floor(Z);
+    const auto CellX = static_cast<int32_t>(FloorX);
+    const auto CellZ = static_cast<int32_t>(FloorZ);
+    float U = X - FloorX;
+    float V = Z - FloorZ;
+    U = U * U * (3.0f - 2.0f * U);
+    V = V * V * (3.0f - 2.0f * V);
+    const float Bottom = Lattice(CellX, CellZ, Seed) + (Lattice(CellX + 1, CellZ, Seed) - Lattice(CellX, CellZ, Seed)) * U;
+    const float Top = Lattice(CellX, CellZ + 1, Seed) + (Lattice(CellX + 1, CellZ + 1, Seed) - Lattice(CellX, CellZ + 1, Seed)) * U;
+    return Bottom + (Top - Bottom) * V;
+}
+
+} // namespace
+
+float ProceduralTerrainSource::GetHeight(float X, float Z) const {
+    float Sum = 0.0f;
+    float Amplitude = 1.0f;
+    float Total = 0.0f;
+    float Frequency = 1.0f / Desc.Wavelength;
+    for (uint32_t Octave = 0; Octave < Desc.Octaves; ++Octave) {
+        const float Noise = ValueNoise(X * Frequency, Z * Frequency, Desc.Seed + Octave);
+        const float Ridge = 1.0f - std::abs(Noise);
+        Sum += (Noise + (Ridge * Ridge * 2.0f - 1.0f - Noise) * Desc.Ridging) * Amplitude;
+        Total += Amplitude;
+        Amplitude *= 0.5f;
+        Frequency *= 2.0f;
+    }
+    return Desc.BaseHeight + Desc.Amplitude * (Sum / Total * 0.5f + 0.5f);
+}
+
+bool ProceduralTerrainSource::Sample(const Vec2& Min, float Size, uint32_t Resolution, float* Heights) {
+    const float Spacing = Resolution > 1 ? Size / static_cast<float>(Resolution - 1) : 0.0f;
+    for (uint32_t Row = 0; Row < Resolution; ++Row) {
+        for (uint32_t Column = 0; Column < Resolution; ++Column) {
+            Heights[Row * Resolution + Column] = GetHeight(Min.x + Column * Spacing, Min.y + Row * Spacing);
+        }
+    }
+    return true;
+}
+
+RawHeightmapSource::RawHeightmapSource(std::string Path, uint32_t Resolution, const Vec2& Origin, float Size, float MinHeight,
+                                       float MaxHeight)
+    : Path(std::move(Path)), FileResolution(Resolution), Origin(Origin), WorldSize(Size), MinHeight(MinHeight),
+      HeightScale((MaxHeight - MinHeight) / 65535.0f) {}
+
+bool RawHeightmapSource::Sample(const Vec2& Min, float Size, uint32_t Resolution, float* Heights) {
+    // A stream per call, so concurrent tiles do not share a file position
+    std::ifstream File(Path, std::ios::binary);
+    if (!File || FileResolution < 2) {
+        std::cerr << "ERROR::TERRAIN::HEIGHTMAP_UNREADABLE: " << Path << std::endl;
+        return false;
+    }
+    const float TexelsPerUnit = static_cast<float>(FileResolution - 1) / WorldSize;
+    const float Spacing = Resolution > 1 ? Size / static_cast<float>(Resolution - 1) : 0.0f;
+    const float Last = static_cast<float>(FileResolution - 1);
+    // The columns any output row touches
+    const float BeginX = std::clamp((Min.x - Origin.x) * TexelsPerUnit, 0.0f, Last);
+    const float EndX = std::clamp((Min.x + Size - Origin.x) * TexelsPerUnit, 0.0f, Last);
+    const auto FirstColumn = static_cast<uint32_t>(BeginX);
+    const uint32_t ColumnCount = std::min(static_cast<uint32_t>(EndX) + 2, FileResolution) - FirstColumn;
+
+    // The two file rows the current output row blends, kept while consecutive rows share them
+    std::vector<uint16_t> Rows[2] = {std::vector<uint16_t>(ColumnCount), std::vector<uint16_t>(ColumnCount)};
+    uint32_t LoadedRows[2] = {~0u, ~0u};
+    const auto LoadRow = [&](uint32_t FileRow, uint32_t Slot) {
+        if (LoadedRows[Slot] == FileRow) { return true; }
+        if (LoadedRows[Slot ^ 1] == FileRow) {
+            Rows[Slot] = Rows[Slot ^ 1];
+        } else {
+            File.seekg(static_cast<std::streamoff>((static_cast<uint64_t>(FileRow) * FileResolution + FirstColumn) * sizeof(uint16_t)));
+            if (!File.read(reinterpret_cast<char*>(Rows[Slot].data()), static_cast<std::streamsize>(ColumnCount * sizeof(uint16_t)))) {
+                return false;
+            }
+        }
+        LoadedRows[Slot] = FileRow;
+        return true;
+    };
+
+    for (uint32_t Row = 0; Row < Resolution; ++Row) {
+        const float FileZ = std::clamp((Min.y + Row * Spacing - Origin.y) * TexelsPerUnit, 0.0f, Last);
+        const auto Z0 = static_cast<uint32_t>(FileZ);
+        const uint32_t Z1 = std::min(Z0 + 1, FileResolution - 1);
+        if (!LoadRow(Z0, 0) || !LoadRow(Z1, 1)) {
+            std::cerr << "ERROR::TERRAIN::HEIGHTMAP_TRUNCATED: " << Path << std::endl;
+            return false;
+        }
+        const float V = FileZ - static_cast<float>(Z0);
+        for (uint32_t Column = 0; Column < Resolution; ++Column) {
+            const float FileX = std::clamp((Min.x + Column * Spacing - Origin.x) * TexelsPerUnit, 0.0f, Last);
+            const uint32_t X0 = static_cast<uint32_t>(FileX) - FirstColumn;
+            const uint32_t X1 = std::min(X0 + 1, ColumnCount - 1);
+            const float U = FileX - std::floor(FileX);
+            const float Bottom = Rows[0][X0] + (Rows[0][X1] - static_cast<float>(Rows[0][X0])) * U;
+            const float Top = Rows[1][X0] + (Rows[1][X1] - static_cast<float>(Rows[1][X0])) * U;
+            Heights[Row * Resolution + Column] = MinHeight + (Bottom + (Top - Bottom) * V) * HeightScale;
+        }
+    }
+    return true;
+}
+
+} // namespace Volante
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "Volante.h"
+
+namespace Volante {
+
+// Heights, in world units, for square regions of a terrain. Called from job threads, possibly
+// several at once.
+class ITerrainHeightSource {
+public:
+    virtual ~ITerrainHeightSource() = default;
+
+    // Fills Resolution x Resolution samples, row by row along +Z, spread evenly over the square
+    // from Min to Min + Size with both edges included. Returns false if the region cannot be
+    // read.
+    virtual bool Sample(const Vec2& Min, float Size, uint32_t Resolution, float* Heights) = 0;
+};
+
+struct ProceduralTerrainDesc {
+    uint32_t Seed = 1;
+    float BaseHeight = 0.0f;
+    // Height of the largest features
+    float Amplitude = 600.0f;
+    // Size of the largest features
+    float Wavelength = 4096.0f;
+    uint32_t Octaves = 10;
+    // Sharpens crests into ridges, from 0 (rolling hills) to 1
+    float Ridging = 0.6f;
+};
+
+// Fractal value noise. Any region can be sampled at any resolution, so it stands in for a
+// world of any size without data on disk.
+class ProceduralTerrainSource : public ITerrainHeightSource {
+public:
+    explicit ProceduralTerrainSource(const ProceduralTerrainDesc& Desc = {}) : Desc(Desc) {}
+
+    bool Sample(const Vec2& Min, float Size, uint32_t Resolution, float* Heights) override;
+
+    [[nodiscard]] float GetHeight(float X, float Z) const;
+
+private:
+    ProceduralTerrainDesc Desc;
+};
+
+// A square 16-bit little-endian RAW heightmap, as terrain tools export it, read region by
+// region from disk. Samples between file texels are bilinear.
+class RawHeightmapSource : public ITerrainHeightSource {
+public:
+    // The file holds Resolution x Resolution samples covering Size world units from Origin,
+    // mapping 0..65535 to MinHeight..MaxHeight.
+    RawHeightmapSource(std::string Path, uint32_t Resolution, const Vec2& Origin, float Size, float MinHeight, float MaxHeight);
+
+    bool Sample(const Vec2& Min, float Size, uint32_t Resolution, float* Heights) override;
+
+private:
+    std::string Path;
+    uint32_t FileResolution;
+    Vec2 Origin;
+    float WorldSize;
+    float MinHeight;
+    float HeightScale;
+};
+
+} // namespace Volante
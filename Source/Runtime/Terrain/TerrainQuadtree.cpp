@@ -0,0 +1,152 @@
+#include "TerrainQuadtree.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <iostream>
+
+namespace Volante {
+
+void TerrainQuadtree::Build(const TerrainQuadtreeDesc& InDesc, const float* Samples, uint32_t Resolution, float Margin) {
+    Desc = InDesc;
+    const auto LeafCount = static_cast<uint32_t>(std::lround(Desc.WorldSize / Desc.LeafNodeSize));
+    if (!std::has_single_bit(LeafCount) || Resolution < 2) {
+        std::cerr << "ERROR::TERRAIN::INVALID_QUADTREE: world size " << Desc.WorldSize << " over leaf size "
+                  << Desc.LeafNodeSize << std::endl;
+        LeafNodesPerSide = 0;
+        Ranges.clear();
+        Heights.clear();
+        Bounds = {};
+        return;
+    }
+    LeafNodesPerSide = LeafCount;
+
+    const uint32_t LevelCount = std::clamp(Desc.LevelCount, 1u, static_cast<uint32_t>(std::countr_zero(LeafCount)) + 1);
+    Ranges.resize(LevelCount);
+    for (uint32_t Level = 0; Level < LevelCount; ++Level) { Ranges[Level] = Desc.RangeScale * GetNodeSize(Level); }
+
+    // Leaves scan the samples they overlap, edges included; each level above merges four
+    Heights.assign(LevelCount, {});
+    std::vector<HeightRange>& Leaves = Heights[0];
+    Leaves.resize(static_cast<size_t>(LeafCount) * LeafCount);
+    const float SamplesPerLeaf = static_cast<float>(Resolution - 1) / static_cast<float>(LeafCount);
+    for (uint32_t Z = 0; Z < LeafCount; ++Z) {
+        const auto Row0 = static_cast<uint32_t>(std::floor(Z * SamplesPerLeaf));
+        const uint32_t Row1 = std::min(static_cast<uint32_t>(std::ceil((Z + 1) * SamplesPerLeaf)), Resolution - 1);
+        for (uint32_t X = 0; X < LeafCount; ++X) {
+            const auto Column0 = static_cast<uint32_t>(std::floor(X * SamplesPerLeaf));
+            const uint32_t Column1 = std::min(static_cast<uint32_t>(std::ceil((X + 1) * SamplesPerLeaf)), Resolution - 1);
+            HeightRange Range{Samples[Row0 * Resolution + Column0], Samples[Row0 * Resolution + Column0]};
+            for (uint32_t Row = Row0; Row <= Row1; ++Row) {
+                for (uint32_t Column = Column0; Column <= Column1; ++Column) {
+                    Range.Min = std::min(Range.Min, Samples[Row * Resolution + Column]);
+                    Range.Max = std::max(Range.Max, Samples[Row * Resolution + Column]);
+                }
+            }
+            Leaves[Z * LeafCount + X] = {Range.Min - Margin, Range.Max + Margin};
+        }
+    }
+    for (uint32_t Level = 1; Level < LevelCount; ++Level) {
+        const std::vector<HeightRange>& Children = Heights[Level - 1];
+        std::vector<HeightRange>& Parents = Heights[Level];
+        const uint32_t PerSide = GetNodesPerSide(Level);
+        Parents.resize(static_cast<size_t>(PerSide) * PerSide);
+        for (uint32_t Z = 0; Z < PerSide; ++Z) {
+            for (uint32_t X = 0; X < PerSide; ++X) {
+                HeightRange& Parent = Parents[Z * PerSide + X];
+                Parent = Children[(Z * 2) * PerSide * 2 + X * 2];
+                for (uint32_t Quadrant = 1; Quadrant < 4; ++Quadrant) {
+                    const HeightRange& Child = Children[(Z * 2 + (Quadrant >> 1)) * PerSide * 2 + X * 2 + (Quadrant & 1)];
+                    Parent.Min = std::min(Parent.Min, Child.Min);
+                    Parent.Max = std::max(Parent.Max, Child.Max);
+                }
+            }
+        }
+    }
+
+    float MinHeight = Leaves[0].Min;
+    float MaxHeight = Leaves[0].Max;
+    for (const HeightRange& Range : Heights.back()) {
+        MinHeight = std::min(MinHeight, Range.Min);
+        MaxHeight = std::max(MaxHeight, Range.Max);
+    }
+    Bounds = AABB(Vec3(Desc.Origin.x, MinHeight, Desc.Origin.y),
+                  Vec3(Desc.Origin.x + Desc.WorldSize, MaxHeight, Desc.Origin.y + Desc.WorldSize));
+}
+
+void TerrainQuadtree::ExpandHeights(const Vec2& Min, float Size, float MinHeight, float MaxHeight) {
+    if (LeafNodesPerSide == 0) { return; }
+    const auto ToLeaf = [this](float Offset) {
+        return static_cast<int>(std::floor(Offset / Desc.LeafNodeSize));
+    };
+    // Nodes only touching the square share its edge samples, so they widen too
+    const int Last = static_cast<int>(LeafNodesPerSide) - 1;
+    const uint32_t X0 = std::clamp(ToLeaf(Min.x - Desc.Origin.x) - 1, 0, Last);
+    const uint32_t X1 = std::clamp(ToLeaf(Min.x + Size - Desc.Origin.x), 0, Last);
+    const uint32_t Z0 = std::clamp(ToLeaf(Min.y - Desc.Origin.y) - 1, 0, Last);
+    const uint32_t Z1 = std::clamp(ToLeaf(Min.y + Size - Desc.Origin.y), 0, Last);
+    for (uint32_t Level = 0; Level < Heights.size(); ++Level) {
+        const uint32_t PerSide = GetNodesPerSide(Level);
+        for (uint32_t Z = Z0 >> Level; Z <= Z1 >> Level; ++Z) {
+            for (uint32_t X = X0 >> Level; X <= X1 >> Level; ++X) {
+                HeightRange& Range = Heights[Level][Z * PerSide + X];
+                Range.Min = std::min(Range.Min, MinHeight);
+                Range.Max = std::max(Range.Max, MaxHeight);
+            }
+        }
+    }
+    Bounds.Min.y = std::min(Bounds.Min.y, MinHeight);
+    Bounds.Max.y = std::max(Bounds.Max.y, MaxHeight);
+}
+
+float TerrainQuadtree::GetMorphStart(uint32_t Level) const {
+    const float Previous = Level > 0 ? Ranges[Level - 1] : 0.0f;
+    return Previous + (Ranges[Level] - Previous) * Desc.MorphStart;
+}
+
+AABB TerrainQuadtree::GetNodeBounds(uint32_t Level, uint32_t X, uint32_t Z) const {
+    const float Size = GetNodeSize(Level);
+    const HeightRange& Range = Heights[Level][Z * GetNodesPerSide(Level) + X];
+    const Vec3 Min(Desc.Origin.x + X * Size, Range.Min, Desc.Origin.y + Z * Size);
+    return {Min, Vec3(Min.x + Size, Range.Max, Min.z + Size)};
+}
+
+void TerrainQuadtree::Select(const RenderView& View, std::vector<TerrainNode>& Out) const {
+    Out.clear();
+    if (Ranges.empty()) { return; }
+    const uint32_t Top = static_cast<uint32_t>(Ranges.size()) - 1;
+    const uint32_t PerSide = GetNodesPerSide(Top);
+    for (uint32_t Z = 0; Z < PerSide; ++Z) {
+        for (uint32_t X = 0; X < PerSide; ++X) { SelectNode(View, Top, X, Z, false, Out); }
+    }
+}
+
+bool TerrainQuadtree::SelectNode(const RenderView& View, uint32_t Level, uint32_t X, uint32_t Z, bool Inside,
+                                 std::vector<TerrainNode>& Out) const {
+    const AABB Box = GetNodeBounds(Level, X, Z);
+    if (!Box.IntersectsSphere(View.Position, Ranges[Level] / View.LODScale)) { return false; }
+    if (!Inside) {
+        const Containment Visibility = View.ViewFrustum.Classify(Box);
+        // Culled, but within range: nothing for the parent to cover
+        if (Visibility == Containment::Outside) { return true; }
+        Inside = Visibility == Containment::Inside;
+    }
+
+    TerrainNode Node;
+    Node.Min = Vec2(Box.Min.x, Box.Min.z);
+    Node.Size = GetNodeSize(Level);
+    Node.Level = Level;
+    if (Level == 0 || !Box.IntersectsSphere(View.Position, Ranges[Level - 1] / View.LODScale)) {
+        Node.Quadrants = 0xF;
+    } else {
+        for (uint32_t Quadrant = 0; Quadrant < 4; ++Quadrant) {
+            if (!SelectNode(View, Level - 1, X * 2 + (Quadrant & 1), Z * 2 + (Quadrant >> 1), Inside, Out)) {
+                Node.Quadrants |= 1u << Quadrant;
+            }
+        }
+    }
+    if (Node.Quadrants != 0) { Out.push_back(Node); }
+    return true;
+}
+
+} // namespace Volante
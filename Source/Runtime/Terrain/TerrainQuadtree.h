@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Runtime/Rendering/RenderView.h"
+
+namespace Volante {
+
+struct TerrainQuadtreeDesc {
+    // Corner of the square the terrain covers, on the XZ plane
+    Vec2 Origin = Vec2(0.0f);
+    // Must be LeafNodeSize times a power of two
+    float WorldSize = 16384.0f;
+    float LeafNodeSize = 64.0f;
+    // Levels used, finest first. Areas beyond the coarsest level's range are not drawn, which
+    // is what keeps the selection bounded however large the world is.
+    uint32_t LevelCount = 8;
+    // A level is used up to this many of its node sizes from the camera; each level doubles
+    // the previous one's range
+    float RangeScale = 2.5f;
+    // Fraction of a level's band after which vertices start morphing to the next level
+    float MorphStart = 0.66f;
+};
+
+// A selected node: the part of the grid mesh given by Quadrants (bit i for quadrant i, X
+// first), placed over the square from Min to Min + Size and morphing at Level.
+struct TerrainNode {
+    Vec2 Min = Vec2(0.0f);
+    float Size = 0.0f;
+    uint32_t Level = 0;
+    uint32_t Quadrants = 0;
+};
+
+// CDLOD (continuous distance-dependent level of detail) selection. Every node draws the same
+// grid; a node is split while its children are within their level's range of the camera, so
+// detail falls off with distance while nodes stay a fixed number of grid cells. A parent whose
+// children are only partly in range draws the remaining quadrants itself. Level ranges are
+// spheres around the camera, the same distances the vertex shader morphs by, so a node has
+// fully morphed into its parent's grid wherever it meets a coarser neighbour.
+//
+// Culling needs the height range of each node, kept as a min/max pyramid built from a coarse
+// sampling of the heightmap and widened as finer data arrives.
+class TerrainQuadtree {
+public:
+    // Samples are Resolution x Resolution heights over the whole world, both edges included.
+    // Margin pads every node's height range, covering detail the samples miss.
+    void Build(const TerrainQuadtreeDesc& InDesc, const float* Samples, uint32_t Resolution, float Margin);
+
+    // Widens the height range of the nodes over the square from Min to Min + Size.
+    void ExpandHeights(const Vec2& Min, float Size, float MinHeight, float MaxHeight);
+
+    // Replaces Out with the nodes to draw from View.
+    void Select(const RenderView& View, std::vector<TerrainNode>& Out) const;
+
+    [[nodiscard]] const TerrainQuadtreeDesc& GetDesc() const { return Desc; }
+
+    [[nodiscard]] uint32_t GetLevelCount() const { return static_cast<uint32_t>(Ranges.size()); }
+
+    // How far from the camera Level is drawn
+    [[nodiscard]] float GetRange(uint32_t Level) const { return Ranges[Level]; }
+
+    // Distance at which Level's vertices start morphing towards Level + 1
+    [[nodiscard]] float GetMorphStart(uint32_t Level) const;
+
+    [[nodiscard]] AABB GetBounds() const { return Bounds; }
+
+private:
+    struct HeightRange {
+        float Min = 0.0f;
+        float Max = 0.0f;
+    };
+
+    // Returns false if the node is beyond its level's range, so the parent must cover it
+    bool SelectNode(const RenderView& View, uint32_t Level, uint32_t X, uint32_t Z, bool Inside,
+                    std::vector<TerrainNode>& Out) const;
+
+    [[nodiscard]] AABB GetNodeBounds(uint32_t Level, uint32_t X, uint32_t Z) const;
+
+    [[nodiscard]] float GetNodeSize(uint32_t Level) const { return Desc.LeafNodeSize * static_cast<float>(1u << Level); }
+
+    [[nodiscard]] uint32_t GetNodesPerSide(uint32_t Level) const { return LeafNodesPerSide >> Level; }
+
+    TerrainQuadtreeDesc Desc;
+    uint32_t LeafNodesPerSide = 0;
+    std::vector<float> Ranges;
+    // Per level, NodesPerSide^2 ranges row by row along +Z
+    std::vector<std::vector<HeightRange>> Heights;
+    AABB Bounds;
+};
+
+} // namespace Volante
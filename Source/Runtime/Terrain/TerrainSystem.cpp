@@ -0,0 +1,536 @@
+#include "TerrainSystem.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <mutex>
+#include <string>
+
+#include "Runtime/Core/Async/JobSystem.h"
+#include "Runtime/Core/Stats/StatCounters.h"
+#include "Runtime/Rendering/UploadRing.h"
+#include "Shader.h"
+
+namespace Volante {
+
+namespace {
+
+constexpr int NodeUnit = 0;
+constexpr int OverviewUnit = 1;
+constexpr int TileUnit = 2;
+constexpr int TileTableUnit = 3;
+constexpr size_t TexelSize = 16;
+constexpr uint32_t MaxLevels = 16;
+// The overview is sampled in blocks of this many cells, one job each
+constexpr uint32_t OverviewBlockCells = 64;
+
+uint16_t QuantizeHeight(float Height, float MinHeight, float InverseScale) {
+    return static_cast<uint16_t>(std::clamp(std::lround((Height - MinHeight) * InverseScale), 0l, 65535l));
+}
+
+} // namespace
+
+// Filled by loads on worker threads, drained by Update(). Replaced when the source changes, so
+// loads still running land somewhere harmless.
+struct TerrainSystem::TileQueue {
+    std::mutex Mutex;
+    std::vector<TileResult> Finished;
+};
+
+TerrainSystem::TerrainSystem(const TerrainDesc& Desc, JobSystem* Jobs, ShaderLibrary* Shaders)
+    : Desc(Desc), Jobs(Jobs), Shaders(Shaders), Loads(std::make_shared<TileQueue>()) {}
+
+TerrainSystem::~TerrainSystem() {
+    Shutdown();
+}
+
+void TerrainSystem::Initialize() {
+    const auto Tiles = static_cast<uint32_t>(std::lround(Desc.WorldSize / Desc.TileSize));
+    if (Desc.GridResolution < 2 || Desc.GridResolution % 2 != 0 || Desc.LevelCount > MaxLevels || Tiles == 0 ||
+        Desc.OverviewResolution < 2 || Desc.TileResolution == 0 ||
+        std::abs(Tiles * Desc.TileSize - Desc.WorldSize) > 0.5f || Desc.MaxResidentTiles > 32767) {
+        std::cerr << "ERROR::TERRAIN::INVALID_DESC: grid, level, tile or overview settings out of range"
+                  << std::endl;
+        return;
+    }
+    TilesPerSide = Tiles;
+    HeightScale = (Desc.MaxHeight - Desc.MinHeight) / 65535.0f;
+
+    if (!Shaders) {
+        OwnedShaders = std::make_unique<ShaderLibrary>(Jobs);
+        OwnedShaders->Initialize();
+        Shaders = OwnedShaders.get();
+    }
+    const std::string& Directory = ShaderLibrary::GetShaderDirectory();
+    TerrainProgram.Id = Shaders->Load({Directory + "/Terrain.vert", Directory + "/Terrain.frag"});
+    if (!Shaders->Get(TerrainProgram.Id)) {
+        Shaders->Unload(TerrainProgram.Id);
+        TerrainProgram = {};
+    }
+
+    CreateGrid();
+    glGenTextures(1, &InstanceTexture);
+
+    glGenTextures(1, &OverviewTexture);
+    glBindTexture(GL_TEXTURE_2D, OverviewTexture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    const auto TileSamples = static_cast<GLsizei>(Desc.TileResolution + 1);
+    glGenTextures(1, &TileArray);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, TileArray);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_R16, TileSamples, TileSamples, static_cast<GLsizei>(std::max(Desc.MaxResidentTiles, 1u)),
+                 0, GL_RED, GL_UNSIGNED_SHORT, nullptr);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    TileLayers.assign(static_cast<size_t>(TilesPerSide) * TilesPerSide, -1);
+    glGenTextures(1, &TileTable);
+    glBindTexture(GL_TEXTURE_2D, TileTable);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R16I, static_cast<GLsizei>(TilesPerSide), static_cast<GLsizei>(TilesPerSide), 0,
+                 GL_RED_INTEGER, GL_SHORT, TileLayers.data());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void TerrainSystem::Shutdown() {
+    SetHeightSource(nullptr);
+    if (Shaders) { Shaders->Unload(TerrainProgram.Id); }
+    TerrainProgram = {};
+    ReleaseTextures();
+    if (VertexArray != 0) {
+        glDeleteVertexArrays(1, &VertexArray);
+        glDeleteBuffers(1, &VertexBuffer);
+        glDeleteBuffers(1, &IndexBuffer);
+    }
+    VertexArray = VertexBuffer = IndexBuffer = 0;
+    TileLayers.clear();
+    TilesPerSide = 0;
+    Stats = {};
+    if (OwnedShaders) {
+        OwnedShaders->Shutdown();
+        OwnedShaders.reset();
+        Shaders = nullptr;
+    }
+}
+
+void TerrainSystem::SetupProgram(const Shader& Program) const {
+    Program.use();
+    Program.setInt("uNodes", NodeUnit);
+    Program.setInt("uOverview", OverviewUnit);
+    Program.setInt("uTiles", TileUnit);
+    Program.setInt("uTileTable", TileTableUnit);
+    Program.setFloat("uGridResolution", static_cast<float>(Desc.GridResolution));
+    Program.setVec2("uOrigin", Desc.Origin);
+    Program.setFloat("uWorldSize", Desc.WorldSize);
+    Program.setVec2("uHeightRange", Vec2(Desc.MinHeight, Desc.MaxHeight - Desc.MinHeight));
+    Program.setFloat("uOverviewResolution", static_cast<float>(Desc.OverviewResolution));
+    Program.setFloat("uTileSize", Desc.TileSize);
+    Program.setFloat("uTileResolution", static_cast<float>(Desc.TileResolution));
+    Program.setInt("uTilesPerSide", static_cast<int>(TilesPerSide));
+}
+
+void TerrainSystem::ReleaseTextures() {
+    const unsigned int Textures[] = {InstanceTexture, OverviewTexture, TileArray, TileTable};
+    for (const unsigned int Texture : Textures) {
+        if (Texture != 0) { glDeleteTextures(1, &Texture); }
+    }
+    InstanceTexture = OverviewTexture = TileArray = TileTable = 0;
+}
+
+void TerrainSystem::CreateGrid() {
+    const uint32_t Resolution = Desc.GridResolution;
+    std::vector<float> Vertices;
+    Vertices.reserve(static_cast<size_t>(Resolution + 1) * (Resolution + 1) * 2);
+    for (uint32_t Z = 0; Z <= Resolution; ++Z) {
+        for (uint32_t X = 0; X <= Resolution; ++X) {
+            Vertices.push_back(static_cast<float>(X));
+            Vertices.push_back(static_cast<float>(Z));
+        }
+    }
+
+    // Quadrant by quadrant, X first, so a partly drawn node is an index range per quadrant
+    const uint32_t Half = Resolution / 2;
+    std::vector<uint32_t> Indices;
+    Indices.reserve(static_cast<size_t>(Resolution) * Resolution * 6);
+    for (uint32_t Quadrant = 0; Quadrant < 4; ++Quadrant) {
+        const uint32_t FirstX = (Quadrant & 1) * Half;
+        const uint32_t FirstZ = (Quadrant >> 1) * Half;
+        for (uint32_t Z = FirstZ; Z < FirstZ + Half; ++Z) {
+            for (uint32_t X = FirstX; X < FirstX + Half; ++X) {
+                const uint32_t Corner = Z * (Resolution + 1) + X;
+                const uint32_t Above = Corner + Resolution + 1;
+                Indices.insert(Indices.end(), {Corner, Above, Corner + 1, Corner + 1, Above, Above + 1});
+            }
+        }
+    }
+    QuadrantIndexCount = Half * Half * 6;
+
+    glGenVertexArrays(1, &VertexArray);
+    glGenBuffers(1, &VertexBuffer);
+    glGenBuffers(1, &IndexBuffer);
+    glBindVertexArray(VertexArray);
+    glBindBuffer(GL_ARRAY_BUFFER, VertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(Vertices.size() * sizeof(float)), Vertices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IndexBuffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(Indices.size() * sizeof(uint32_t)), Indices.data(),
+                 GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), nullptr);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void TerrainSystem::SetHeightSource(std::shared_ptr<ITerrainHeightSource> InSource) {
+    // Loads of the previous source finish into the old queue and are dropped with it
+    Loads = std::make_shared<TileQueue>();
+    ReadyTiles.clear();
+    PendingLoads = 0;
+    ++Generation;
+    Tiles.assign(static_cast<size_t>(TilesPerSide) * TilesPerSide, TileState::Absent);
+    TileSlots.assign(Desc.MaxResidentTiles, {});
+    FreeSlots.clear();
+    for (uint32_t Slot = Desc.MaxResidentTiles; Slot-- > 0;) { FreeSlots.push_back(Slot); }
+    if (TileTable != 0) {
+        std::fill(TileLayers.begin(), TileLayers.end(), -1);
+        glBindTexture(GL_TEXTURE_2D, TileTable);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, static_cast<GLsizei>(TilesPerSide), static_cast<GLsizei>(TilesPerSide),
+                        GL_RED_INTEGER, GL_SHORT, TileLayers.data());
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+    Selection.clear();
+    Overview.clear();
+    Source = std::move(InSource);
+    if (!Source || TilesPerSide == 0) {
+        Source.reset();
+        return;
+    }
+
+    // The overview in blocks sharing their edge samples; the last ones may reach past the world
+    const uint32_t Resolution = Desc.OverviewResolution;
+    const float Spacing = Desc.WorldSize / static_cast<float>(Resolution - 1);
+    const uint32_t BlocksPerSide = (Resolution - 2) / OverviewBlockCells + 1;
+    std::vector<float> Samples(static_cast<size_t>(Resolution) * Resolution);
+    ParallelFor(Jobs, BlocksPerSide * BlocksPerSide, 1, [&](uint32_t Begin, uint32_t End) {
+        constexpr uint32_t BlockSamples = OverviewBlockCells + 1;
+        std::vector<float> Block(BlockSamples * BlockSamples);
+        for (uint32_t Index = Begin; Index < End; ++Index) {
+            const uint32_t FirstX = Index % BlocksPerSide * OverviewBlockCells;
+            const uint32_t FirstZ = Index / BlocksPerSide * OverviewBlockCells;
+            const Vec2 Min = Desc.Origin + Vec2(static_cast<float>(FirstX), static_cast<float>(FirstZ)) * Spacing;
+            if (!Source->Sample(Min, OverviewBlockCells * Spacing, BlockSamples, Block.data())) {
+                std::fill(Block.begin(), Block.end(), Desc.MinHeight);
+            }
+            for (uint32_t Z = 0; Z < BlockSamples && FirstZ + Z < Resolution; ++Z) {
+                for (uint32_t X = 0; X < BlockSamples && FirstX + X < Resolution; ++X) {
+                    Samples[(FirstZ + Z) * Resolution + FirstX + X] = Block[Z * BlockSamples + X];
+                }
+            }
+        }
+    });
+
+    // Heights are stored quantized, so the bounds come from what will be drawn
+    Overview.resize(Samples.size());
+    for (size_t i = 0; i < Samples.size(); ++i) {
+        Overview[i] = QuantizeHeight(Samples[i], Desc.MinHeight, 1.0f / HeightScale);
+        Samples[i] = Dequantize(Overview[i]);
+    }
+    TerrainQuadtreeDesc TreeDesc;
+    TreeDesc.Origin = Desc.Origin;
+    TreeDesc.WorldSize = Desc.WorldSize;
+    TreeDesc.LeafNodeSize = Desc.LeafNodeSize;
+    TreeDesc.LevelCount = Desc.LevelCount;
+    TreeDesc.RangeScale = Desc.RangeScale;
+    TreeDesc.MorphStart = Desc.MorphStart;
+    // Bilinear filtering never leaves the samples' range; the margin is for precision only
+    Quadtree.Build(TreeDesc, Samples.data(), Resolution, HeightScale * 4.0f);
+
+    glBindTexture(GL_TEXTURE_2D, OverviewTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R16, static_cast<GLsizei>(Resolution), static_cast<GLsizei>(Resolution), 0, GL_RED,
+                 GL_UNSIGNED_SHORT, Overview.data());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void TerrainSystem::Update(float DeltaTime) {
+    if (OwnedShaders) { OwnedShaders->Update(DeltaTime); }
+    Stats.TilesLoaded = 0;
+    Stats.TilesEvicted = 0;
+    if (!Source) { return; }
+
+    {
+        std::lock_guard Lock(Loads->Mutex);
+        for (TileResult& Result : Loads->Finished) {
+            ReadyTiles.push_back(std::move(Result));
+        }
+        Loads->Finished.clear();
+    }
+    const size_t Applied = std::min<size_t>(ReadyTiles.size(), Desc.TileUploadsPerFrame);
+    for (size_t i = 0; i < Applied; ++i) {
+        --PendingLoads;
+        ApplyTile(ReadyTiles[i]);
+    }
+    ReadyTiles.erase(ReadyTiles.begin(), ReadyTiles.begin() + static_cast<ptrdiff_t>(Applied));
+
+    // Missing tiles in the stream radius, nearest first. One that a full pool could only take
+    // by evicting a nearer tile waits for the camera to move.
+    if (PendingLoads < Desc.MaxPendingLoads) {
+        const Vec2 Local = Vec2(Focus.x, Focus.z) - Desc.Origin;
+        const int Last = static_cast<int>(TilesPerSide) - 1;
+        const auto ToTile = [this, Last](float Offset) {
+            return std::clamp(static_cast<int>(std::floor(Offset / Desc.TileSize)), 0, Last);
+        };
+        std::vector<std::pair<float, uint32_t>> Candidates;
+        for (int Z = ToTile(Local.y - Desc.StreamRadius); Z <= ToTile(Local.y + Desc.StreamRadius); ++Z) {
+            for (int X = ToTile(Local.x - Desc.StreamRadius); X <= ToTile(Local.x + Desc.StreamRadius); ++X) {
+                const uint32_t Tile = Z * TilesPerSide + X;
+                if (Tiles[Tile] != TileState::Absent) { continue; }
+                const float Distance = GetTileDistance(Tile);
+                if (Distance <= Desc.StreamRadius) { Candidates.emplace_back(Distance, Tile); }
+            }
+        }
+        std::sort(Candidates.begin(), Candidates.end());
+
+        float Farthest = -1.0f;
+        if (FreeSlots.size() < Candidates.size()) {
+            for (const TileSlot& Slot : TileSlots) {
+                if (Slot.Tile != ~0u) { Farthest = std::max(Farthest, GetTileDistance(Slot.Tile)); }
+            }
+        }
+        uint32_t FreeCount = static_cast<uint32_t>(FreeSlots.size());
+        for (const auto& [Distance, Tile] : Candidates) {
+            if (PendingLoads >= Desc.MaxPendingLoads) { break; }
+            if (FreeCount == 0 && Distance >= Farthest) { break; }
+            FreeCount -= FreeCount > 0 ? 1 : 0;
+            RequestTile(Tile);
+        }
+    }
+
+    Stats.ResidentTiles = Desc.MaxResidentTiles - static_cast<uint32_t>(FreeSlots.size());
+    Stats.PendingLoads = PendingLoads;
+}
+
+void TerrainSystem::RequestTile(uint32_t Tile) {
+    Tiles[Tile] = TileState::Pending;
+    ++PendingLoads;
+
+    const Vec2 Min = Desc.Origin + Vec2(static_cast<float>(Tile % TilesPerSide), static_cast<float>(Tile / TilesPerSide)) * Desc.TileSize;
+    auto Load = [Source = Source, Queue = Loads, Tile, Generation = Generation, Min, Size = Desc.TileSize,
+                 Resolution = Desc.TileResolution + 1, MinHeight = Desc.MinHeight, InverseScale = 1.0f / HeightScale] {
+        TileResult Result;
+        Result.Tile = Tile;
+        Result.Generation = Generation;
+        std::vector<float> Samples(static_cast<size_t>(Resolution) * Resolution);
+        Result.Succeeded = Source->Sample(Min, Size, Resolution, Samples.data());
+        if (Result.Succeeded) {
+            Result.Heights.resize(Samples.size());
+            Result.MinHeight = 65535;
+            for (size_t i = 0; i < Samples.size(); ++i) {
+                Result.Heights[i] = QuantizeHeight(Samples[i], MinHeight, InverseScale);
+                Result.MinHeight = std::min(Result.MinHeight, Result.Heights[i]);
+                Result.MaxHeight = std::max(Result.MaxHeight, Result.Heights[i]);
+            }
+        }
+
+        std::lock_guard Lock(Queue->Mutex);
+        Queue->Finished.push_back(std::move(Result));
+    };
+    if (Jobs) {
+        Jobs->Submit(std::move(Load));
+    } else {
+        Load();
+    }
+}
+
+void TerrainSystem::ApplyTile(TileResult& Result) {
+    if (Result.Generation != Generation) { return; }
+    if (!Result.Succeeded) {
+        Tiles[Result.Tile] = TileState::Failed;
+        return;
+    }
+
+    uint32_t Slot;
+    if (!FreeSlots.empty()) {
+        Slot = FreeSlots.back();
+        FreeSlots.pop_back();
+    } else {
+        // The camera may have moved on since the request: evict the farthest tile, unless
+        // this one is farther still
+        Slot = 0;
+        float Farthest = -1.0f;
+        for (uint32_t Candidate = 0; Candidate < TileSlots.size(); ++Candidate) {
+            const float Distance = GetTileDistance(TileSlots[Candidate].Tile);
+            if (Distance > Farthest) {
+                Farthest = Distance;
+                Slot = Candidate;
+            }
+        }
+        if (TileSlots.empty() || Farthest <= GetTileDistance(Result.Tile)) {
+            Tiles[Result.Tile] = TileState::Absent;
+            return;
+        }
+        const uint32_t Evicted = TileSlots[Slot].Tile;
+        Tiles[Evicted] = TileState::Absent;
+        TileLayers[Evicted] = -1;
+        UploadTableEntry(Evicted);
+        ++Stats.TilesEvicted;
+    }
+
+    const auto Samples = static_cast<GLsizei>(Desc.TileResolution + 1);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, TileArray);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+    glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, static_cast<GLint>(Slot), Samples, Samples, 1, GL_RED, GL_UNSIGNED_SHORT,
+                    Result.Heights.data());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    StatCounters::Add(StatCounter::UploadBytes, static_cast<int64_t>(Result.Heights.size() * sizeof(uint16_t)));
+
+    Tiles[Result.Tile] = TileState::Resident;
+    TileLayers[Result.Tile] = static_cast<int16_t>(Slot);
+    UploadTableEntry(Result.Tile);
+    TileSlots[Slot].Tile = Result.Tile;
+    TileSlots[Slot].Heights = std::move(Result.Heights);
+    ++Stats.TilesLoaded;
+
+    const Vec2 Min = Desc.Origin + Vec2(static_cast<float>(Result.Tile % TilesPerSide),
+                                        static_cast<float>(Result.Tile / TilesPerSide)) * Desc.TileSize;
+    Quadtree.ExpandHeights(Min, Desc.TileSize, Dequantize(Result.MinHeight) - HeightScale * 4.0f,
+                           Dequantize(Result.MaxHeight) + HeightScale * 4.0f);
+}
+
+void TerrainSystem::UploadTableEntry(uint32_t Tile) const {
+    glBindTexture(GL_TEXTURE_2D, TileTable);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, static_cast<GLint>(Tile % TilesPerSide), static_cast<GLint>(Tile / TilesPerSide), 1, 1,
+                    GL_RED_INTEGER, GL_SHORT, &TileLayers[Tile]);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+float TerrainSystem::GetTileDistance(uint32_t Tile) const {
+    const Vec2 Min = Desc.Origin + Vec2(static_cast<float>(Tile % TilesPerSide), static_cast<float>(Tile / TilesPerSide)) * Desc.TileSize;
+    const Vec2 Point(Focus.x, Focus.z);
+    const Vec2 Delta = glm::max(glm::max(Min - Point, Point - (Min + Vec2(Desc.TileSize))), Vec2(0.0f));
+    return length(Delta);
+}
+
+float TerrainSystem::SampleHeights(const uint16_t* Heights, uint32_t Resolution, float U, float V) const {
+    const float Last = static_cast<float>(Resolution - 1);
+    U = std::clamp(U, 0.0f, Last);
+    V = std::clamp(V, 0.0f, Last);
+    const uint32_t X0 = std::min(static_cast<uint32_t>(U), Resolution - 2);
+    const uint32_t Z0 = std::min(static_cast<uint32_t>(V), Resolution - 2);
+    const float FractionX = U - static_cast<float>(X0);
+    const float FractionZ = V - static_cast<float>(Z0);
+    const uint16_t* Row = Heights + static_cast<size_t>(Z0) * Resolution + X0;
+    const float Bottom = Row[0] + (Row[1] - static_cast<float>(Row[0])) * FractionX;
+    const float Top = Row[Resolution] + (Row[Resolution + 1] - static_cast<float>(Row[Resolution])) * FractionX;
+    return Dequantize(Bottom + (Top - Bottom) * FractionZ);
+}
+
+float TerrainSystem::GetHeight(float X, float Z) const {
+    if (Overview.empty()) { return 0.0f; }
+    const Vec2 Local = Vec2(X, Z) - Desc.Origin;
+    const int Last = static_cast<int>(TilesPerSide) - 1;
+    const int TileX = std::clamp(static_cast<int>(std::floor(Local.x / Desc.TileSize)), 0, Last);
+    const int TileZ = std::clamp(static_cast<int>(std::floor(Local.y / Desc.TileSize)), 0, Last);
+    if (const int16_t Layer = TileLayers[TileZ * TilesPerSide + TileX]; Layer >= 0) {
+        const float Scale = static_cast<float>(Desc.TileResolution) / Desc.TileSize;
+        return SampleHeights(TileSlots[Layer].Heights.data(), Desc.TileResolution + 1, (Local.x - TileX * Desc.TileSize) * Scale,
+                             (Local.y - TileZ * Desc.TileSize) * Scale);
+    }
+    const float Scale = static_cast<float>(Desc.OverviewResolution - 1) / Desc.WorldSize;
+    return SampleHeights(Overview.data(), Desc.OverviewResolution, Local.x * Scale, Local.y * Scale);
+}
+
+void TerrainSystem::Render(const RenderView& View, UploadRing& Uploads, const Vec3& LightDirection) {
+    StatScope Scope(StatTimer::Terrain);
+    Stats.NodeCount = 0;
+    Stats.DrawCount = 0;
+    Stats.TriangleCount = 0;
+    Focus = View.Position;
+    if (!Source || TerrainProgram.Id == InvalidShaderProgramId) { return; }
+
+    Quadtree.Select(View, Selection);
+    Stats.NodeCount = static_cast<uint32_t>(Selection.size());
+    if (Selection.empty()) { return; }
+
+    // One list of nodes per quadrant, back to back
+    uint32_t Counts[4] = {};
+    for (const TerrainNode& Node : Selection) {
+        for (uint32_t Quadrant = 0; Quadrant < 4; ++Quadrant) { Counts[Quadrant] += (Node.Quadrants >> Quadrant) & 1; }
+    }
+    uint32_t Offsets[4] = {0, Counts[0], Counts[0] + Counts[1], Counts[0] + Counts[1] + Counts[2]};
+    const uint32_t Total = Offsets[3] + Counts[3];
+    const UploadAllocation Nodes = Uploads.Allocate(Total * sizeof(Vec4), TexelSize);
+    auto* NodeData = static_cast<Vec4*>(Nodes.Data);
+    uint32_t Cursors[4] = {Offsets[0], Offsets[1], Offsets[2], Offsets[3]};
+    for (const TerrainNode& Node : Selection) {
+        const Vec4 Packed(Node.Min.x, Node.Min.y, Node.Size, static_cast<float>(Node.Level));
+        for (uint32_t Quadrant = 0; Quadrant < 4; ++Quadrant) {
+            if ((Node.Quadrants >> Quadrant) & 1) { NodeData[Cursors[Quadrant]++] = Packed; }
+        }
+    }
+    Uploads.Flush();
+
+    // A failed reload keeps the previous program, so there is one once Initialize loaded it
+    const Shader& Program = *Shaders->Get(TerrainProgram.Id);
+    if (Shaders->Refresh(TerrainProgram)) { SetupProgram(Program); }
+    Program.use();
+    Program.setMat4("uViewProjection", View.RelativeViewProjection);
+    Program.setVec3("uViewOrigin", View.Origin);
+    Program.setVec3("uCameraPosition", View.Position);
+    Program.setVec3("uLightDirection", normalize(LightDirection));
+    // The shader morphs by the distances selection used, LOD scale included
+    for (uint32_t Level = 0; Level < Quadtree.GetLevelCount(); ++Level) {
+        const float Start = Quadtree.GetMorphStart(Level) / View.LODScale;
+        const float End = Quadtree.GetRange(Level) / View.LODScale;
+        Program.setVec2("uMorph[" + std::to_string(Level) + "]", Vec2(Start, 1.0f / std::max(End - Start, 1e-3f)));
+    }
+
+    glActiveTexture(GL_TEXTURE0 + NodeUnit);
+    glBindTexture(GL_TEXTURE_BUFFER, InstanceTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, Nodes.Buffer);
+    glActiveTexture(GL_TEXTURE0 + OverviewUnit);
+    glBindTexture(GL_TEXTURE_2D, OverviewTexture);
+    glActiveTexture(GL_TEXTURE0 + TileUnit);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, TileArray);
+    glActiveTexture(GL_TEXTURE0 + TileTableUnit);
+    glBindTexture(GL_TEXTURE_2D, TileTable);
+    const auto FirstTexel = static_cast<int>(Nodes.Offset / TexelSize);
+
+    glBindVertexArray(VertexArray);
+    for (uint32_t Quadrant = 0; Quadrant < 4; ++Quadrant) {
+        if (Counts[Quadrant] == 0) { continue; }
+        Program.setInt("uNodeBase", FirstTexel + static_cast<int>(Offsets[Quadrant]));
+        const auto* FirstIndex = reinterpret_cast<const void*>(static_cast<uintptr_t>(Quadrant) * QuadrantIndexCount * sizeof(uint32_t));
+        glDrawElementsInstanced(GL_TRIANGLES, static_cast<GLsizei>(QuadrantIndexCount), GL_UNSIGNED_INT, FirstIndex,
+                                static_cast<GLsizei>(Counts[Quadrant]));
+        ++Stats.DrawCount;
+        Stats.TriangleCount += static_cast<uint64_t>(QuadrantIndexCount / 3) * Counts[Quadrant];
+    }
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE0 + TileUnit);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    glActiveTexture(GL_TEXTURE0 + OverviewUnit);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE0 + NodeUnit);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    StatCounters::Add(StatCounter::DrawCalls, Stats.DrawCount);
+}
+
+} // namespace Volante
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Engine.h"
+#include "TerrainHeightSource.h"
+#include "TerrainQuadtree.h"
+#include "Runtime/Rendering/RenderView.h"
+#include "Runtime/Rendering/ShaderLibrary.h"
+
+namespace Volante {
+
+class JobSystem;
+class Shader;
+class UploadRing;
+
+struct TerrainDesc {
+    // The terrain covers the square from Origin to Origin + WorldSize on the XZ plane. Both
+    // LeafNodeSize and TileSize must divide WorldSize, LeafNodeSize by a power of two.
+    Vec2 Origin = Vec2(-8192.0f);
+    float WorldSize = 16384.0f;
+    // Heights are stored as 16 bits over this range; nothing outside it can be drawn
+    float MinHeight = -100.0f;
+    float MaxHeight = 1000.0f;
+
+    // Grid cells along a node's side; even, so every other vertex can morph away
+    uint32_t GridResolution = 32;
+    float LeafNodeSize = 64.0f;
+    uint32_t LevelCount = 8;
+    float RangeScale = 2.5f;
+    float MorphStart = 0.66f;
+
+    // The whole world at this many samples per side, loaded up front. Drawn where no tile is
+    // resident, and the source of the culling bounds.
+    uint32_t OverviewResolution = 1025;
+    // Detail is streamed in square tiles of TileSize world units and TileResolution + 1
+    // samples per side, the edges shared with neighbours
+    float TileSize = 512.0f;
+    uint32_t TileResolution = 256;
+    // Tiles within this distance of the camera are kept resident, nearest first
+    float StreamRadius = 2048.0f;
+    uint32_t MaxResidentTiles = 128;
+    uint32_t MaxPendingLoads = 4;
+    uint32_t TileUploadsPerFrame = 4;
+};
+
+// Describes the last Update and Render.
+struct TerrainStats {
+    uint32_t NodeCount = 0;
+    uint32_t DrawCount = 0;
+    uint64_t TriangleCount = 0;
+    uint32_t ResidentTiles = 0;
+    uint32_t PendingLoads = 0;
+    uint32_t TilesLoaded = 0;
+    uint32_t TilesEvicted = 0;
+};
+
+// Heightmap terrain drawn with CDLOD (see TerrainQuadtree).
+//
+// There is one grid mesh, (GridResolution + 1)^2 vertices, shared by every node: its indices
+// are ordered by quadrant, and the selected nodes go to the vertex shader through a texture
+// buffer, so a frame is four instanced draws, one per quadrant. The vertex shader places the
+// grid over the node, morphs it towards the parent's grid as the camera distance approaches
+// the end of the node's range, and reads the height. Since nodes are a fixed number of cells
+// and the level ranges are fixed multiples of node size, the triangle count depends on the
+// view only, not on the size of the world.
+//
+// Heights come from a 16-bit overview of the whole world and from detail tiles streamed
+// around the camera: the height source is sampled on the job system, Update() uploads what
+// finished into a texture array and a small table maps each tile to its layer. Tiles furthest
+// from the camera make room for nearer ones.
+//
+// The program is loaded from Terrain.vert and Terrain.frag through Shaders, or through a
+// library of the system's own, updated in Update(), when none is given.
+class TerrainSystem : public IEngineSubsystem {
+public:
+    explicit TerrainSystem(const TerrainDesc& Desc = {}, JobSystem* Jobs = nullptr, ShaderLibrary* Shaders = nullptr);
+    ~TerrainSystem() override;
+
+    TerrainSystem(const TerrainSystem&) = delete;
+    TerrainSystem& operator=(const TerrainSystem&) = delete;
+
+    void Initialize() override;
+    void Shutdown() override;
+    // Uploads finished tiles and requests the next ones around the last rendered view.
+    void Update(float DeltaTime) override;
+
+    // Samples the overview (on the job system, blocking) and starts streaming tiles from
+    // Source. Null removes the terrain.
+    void SetHeightSource(std::shared_ptr<ITerrainHeightSource> Source);
+
+    // Selects nodes for View and draws them into the bound framebuffer. LightDirection points
+    // towards the light.
+    void Render(const RenderView& View, UploadRing& Uploads, const Vec3& LightDirection);
+
+    // Height at X, Z from the finest data resident, as the terrain is drawn at its finest level.
+    [[nodiscard]] float GetHeight(float X, float Z) const;
+
+    [[nodiscard]] bool HasTerrain() const { return Source != nullptr; }
+
+    [[nodiscard]] const TerrainQuadtree& GetQuadtree() const { return Quadtree; }
+
+    [[nodiscard]] const std::vector<TerrainNode>& GetSelection() const { return Selection; }
+
+    [[nodiscard]] const TerrainStats& GetStats() const { return Stats; }
+
+private:
+    // Failed tiles are not retried until the source changes
+    enum class TileState : uint8_t { Absent, Pending, Resident, Failed };
+
+    struct TileSlot {
+        uint32_t Tile = ~0u;
+        // Kept for GetHeight
+        std::vector<uint16_t> Heights;
+    };
+
+    // A finished tile read, already quantized
+    struct TileResult {
+        uint32_t Tile = 0;
+        uint32_t Generation = 0;
+        std::vector<uint16_t> Heights;
+        uint16_t MinHeight = 0;
+        uint16_t MaxHeight = 0;
+        bool Succeeded = false;
+    };
+
+    struct TileQueue;
+
+    void CreateGrid();
+    void ApplyTile(TileResult& Result);
+    void RequestTile(uint32_t Tile);
+    void ReleaseTextures();
+    // Sampler units and the uniforms the desc fixes, once per program version
+    void SetupProgram(const Shader& Program) const;
+
+    [[nodiscard]] float Dequantize(float Value) const { return Desc.MinHeight + Value * HeightScale; }
+
+    void UploadTableEntry(uint32_t Tile) const;
+
+    // Distance on the XZ plane from the focus to the tile's square
+    [[nodiscard]] float GetTileDistance(uint32_t Tile) const;
+
+    // Bilinear height from Resolution x Resolution samples at fractional sample position U, V
+    [[nodiscard]] float SampleHeights(const uint16_t* Heights, uint32_t Resolution, float U, float V) const;
+
+    TerrainDesc Desc;
+    JobSystem* Jobs;
+    ShaderLibrary* Shaders;
+    std::unique_ptr<ShaderLibrary> OwnedShaders;
+    std::shared_ptr<ITerrainHeightSource> Source;
+    TerrainQuadtree Quadtree;
+    std::vector<TerrainNode> Selection;
+    TerrainStats Stats;
+    float HeightScale = 0.0f;
+
+    std::vector<uint16_t> Overview;
+    uint32_t TilesPerSide = 0;
+    std::vector<TileState> Tiles;
+    // Per tile, its slot in TileSlots or -1; mirrored in TileTable
+    std::vector<int16_t> TileLayers;
+    std::vector<TileSlot> TileSlots;
+    std::vector<uint32_t> FreeSlots;
+    std::shared_ptr<TileQueue> Loads;
+    std::vector<TileResult> ReadyTiles;
+    uint32_t PendingLoads = 0;
+    // Bumped when the source changes so loads of the old one are dropped
+    uint32_t Generation = 0;
+    Vec3 Focus = Vec3(0.0f);
+
+    ShaderProgramHandle TerrainProgram;
+    unsigned int VertexArray = 0;
+    unsigned int VertexBuffer = 0;
+    unsigned int IndexBuffer = 0;
+    uint32_t QuadrantIndexCount = 0;
+    unsigned int InstanceTexture = 0;
+    unsigned int OverviewTexture = 0;
+    unsigned int TileArray = 0;
+    unsigned int TileTable = 0;
+};
+
+} // namespace Volante
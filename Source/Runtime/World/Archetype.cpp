@@ -0,0 +1,92 @@
+#include "Archetype.h"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+#include "Runtime/Core/Misc/Utility.h"
+
+namespace Volante {
+
+void ChunkDeleter::operator()(uint8_t* Data) const {
+    ::operator delete[](Data, std::align_val_t(ArchetypeChunkAlignment));
+}
+
+Archetype::Archetype(ComponentMask InMask, const std::vector<uint32_t>& ComponentSizes, const std::vector<uint32_t>& Alignments)
+    : Mask(InMask) {
+    std::fill(std::begin(ColumnOf), std::end(ColumnOf), static_cast<int8_t>(-1));
+    std::vector<uint32_t> ColumnAlignments;
+    for (ComponentTypeId Type = 0; Type < MaxComponentTypes; ++Type) {
+        if ((Mask & (ComponentMask(1) << Type)) == 0) { continue; }
+        ColumnOf[Type] = static_cast<int8_t>(Types.size());
+        Types.push_back(Type);
+        Sizes.push_back(ComponentSizes[Type]);
+        // Columns start 16-byte aligned so SIMD loops over them need no peeling
+        ColumnAlignments.push_back(std::max<uint32_t>(Alignments[Type], 16));
+    }
+    Offsets.resize(Types.size());
+
+    const auto Layout = [&](uint32_t Rows) {
+        size_t Offset = sizeof(Entity) * Rows;
+        for (size_t Column = 0; Column < Types.size(); ++Column) {
+            Offset = AlignUp(Offset, ColumnAlignments[Column]);
+            Offsets[Column] = static_cast<uint32_t>(Offset);
+            Offset += static_cast<size_t>(Sizes[Column]) * Rows;
+        }
+        return Offset;
+    };
+
+    size_t RowBytes = sizeof(Entity);
+    for (const uint32_t Size : Sizes) { RowBytes += Size; }
+    Capacity = static_cast<uint32_t>(ArchetypeChunkSize / RowBytes);
+    while (Capacity > 1 && Layout(Capacity) > ArchetypeChunkSize) { --Capacity; }
+    // A row too large for a chunk gets a chunk of its own size
+    Capacity = std::max(Capacity, 1u);
+    ChunkBytes = std::max(ArchetypeChunkSize, AlignUp(Layout(Capacity), ArchetypeChunkAlignment));
+}
+
+uint32_t Archetype::AddRows(uint32_t Count) {
+    const uint32_t First = EntityCount;
+    uint32_t Remaining = Count;
+    while (Remaining > 0) {
+        if (Chunks.empty() || Chunks.back().Count == Capacity) {
+            ArchetypeChunk& Chunk = Chunks.emplace_back();
+            Chunk.Data.reset(static_cast<uint8_t*>(::operator new[](ChunkBytes, std::align_val_t(ArchetypeChunkAlignment))));
+        }
+        ArchetypeChunk& Chunk = Chunks.back();
+        const uint32_t Taken = std::min(Remaining, Capacity - Chunk.Count);
+        Chunk.Count += Taken;
+        Remaining -= Taken;
+    }
+    EntityCount += Count;
+    return First;
+}
+
+Entity Archetype::RemoveRow(uint32_t Row) {
+    const uint32_t Last = EntityCount - 1;
+    Entity Moved = InvalidEntity;
+    if (Row != Last) {
+        Moved = GetEntity(Last);
+        GetEntity(Row) = Moved;
+        for (uint32_t Column = 0; Column < Types.size(); ++Column) {
+            std::memcpy(GetElement(Row, Column), GetElement(Last, Column), Sizes[Column]);
+        }
+    }
+    --EntityCount;
+    if (--Chunks.back().Count == 0) { Chunks.pop_back(); }
+    return Moved;
+}
+
+void Archetype::Truncate(uint32_t Count) {
+    if (Count >= EntityCount) { return; }
+    EntityCount = Count;
+    Chunks.resize((Count + Capacity - 1) / Capacity);
+    if (!Chunks.empty()) { Chunks.back().Count = Count - (static_cast<uint32_t>(Chunks.size()) - 1) * Capacity; }
+}
+
+void Archetype::Clear() {
+    Chunks.clear();
+    EntityCount = 0;
+}
+
+} // namespace Volante
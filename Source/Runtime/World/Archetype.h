@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Entity.h"
+
+namespace Volante {
+
+constexpr size_t ArchetypeChunkSize = 16 * 1024;
+constexpr size_t ArchetypeChunkAlignment = 64;
+
+struct ChunkDeleter {
+    void operator()(uint8_t* Data) const;
+};
+
+// Up to the archetype's capacity of entities. Each column (the entities, then one per
+// component) is a contiguous array, so a column of a chunk is one memcpy to save or load.
+struct ArchetypeChunk {
+    std::unique_ptr<uint8_t[], ChunkDeleter> Data;
+    uint32_t Count = 0;
+};
+
+// Every entity with exactly one set of components. Rows are numbered across chunks (row R is
+// in chunk R / capacity) and kept dense: all chunks but the last are full, and removing a row
+// moves the last row into the hole.
+class Archetype {
+public:
+    // Sizes and Alignments are indexed by ComponentTypeId.
+    Archetype(ComponentMask Mask, const std::vector<uint32_t>& Sizes, const std::vector<uint32_t>& Alignments);
+
+    [[nodiscard]] ComponentMask GetMask() const { return Mask; }
+
+    // Ascending, one per column after the entity column
+    [[nodiscard]] const std::vector<ComponentTypeId>& GetTypes() const { return Types; }
+
+    // Column of Type, or -1. Columns count from 0 over the components; the entities are apart.
+    [[nodiscard]] int GetColumn(ComponentTypeId Type) const { return ColumnOf[Type]; }
+
+    [[nodiscard]] uint32_t GetColumnCount() const { return static_cast<uint32_t>(Types.size()); }
+
+    [[nodiscard]] uint32_t GetColumnSize(uint32_t Column) const { return Sizes[Column]; }
+
+    [[nodiscard]] uint32_t GetCapacity() const { return Capacity; }
+
+    [[nodiscard]] uint32_t GetEntityCount() const { return EntityCount; }
+
+    [[nodiscard]] uint32_t GetChunkCount() const { return static_cast<uint32_t>(Chunks.size()); }
+
+    [[nodiscard]] uint32_t GetChunkEntityCount(uint32_t Chunk) const { return Chunks[Chunk].Count; }
+
+    [[nodiscard]] Entity* GetEntities(uint32_t Chunk) const { return reinterpret_cast<Entity*>(Chunks[Chunk].Data.get()); }
+
+    [[nodiscard]] uint8_t* GetColumnData(uint32_t Chunk, uint32_t Column) const { return Chunks[Chunk].Data.get() + Offsets[Column]; }
+
+    // Address of Row's element of Column
+    [[nodiscard]] uint8_t* GetElement(uint32_t Row, uint32_t Column) const {
+        return GetColumnData(Row / Capacity, Column) + static_cast<size_t>(Row % Capacity) * Sizes[Column];
+    }
+
+    [[nodiscard]] Entity& GetEntity(uint32_t Row) const { return GetEntities(Row / Capacity)[Row % Capacity]; }
+
+    // Appends Count rows, allocating chunks as needed, and returns the first. Their contents
+    // are left for the caller to fill.
+    uint32_t AddRows(uint32_t Count);
+
+    // Moves the last row into Row and shrinks by one. Returns the entity moved, or
+    // InvalidEntity when Row was the last row.
+    Entity RemoveRow(uint32_t Row);
+
+    // Drops rows from the end down to Count, freeing emptied chunks.
+    void Truncate(uint32_t Count);
+
+    void Clear();
+
+private:
+    ComponentMask Mask;
+    std::vector<ComponentTypeId> Types;
+    std::vector<uint32_t> Sizes;
+    // Byte offset of each column in a chunk
+    std::vector<uint32_t> Offsets;
+    int8_t ColumnOf[MaxComponentTypes];
+    uint32_t Capacity = 0;
+    size_t ChunkBytes = ArchetypeChunkSize;
+    std::vector<ArchetypeChunk> Chunks;
+    uint32_t EntityCount = 0;
+};
+
+} // namespace Volante
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Volante {
+
+// Handle to an entity of a World. The generation is bumped each time the index is reused, so a
+// handle to a destroyed entity stays invalid.
+struct Entity {
+    uint32_t Index = ~0u;
+    uint32_t Generation = 0;
+
+    [[nodiscard]] bool IsValid() const { return Index != ~0u; }
+
+    friend bool operator==(const Entity& A, const Entity& B) = default;
+};
+
+constexpr Entity InvalidEntity{};
+
+using ComponentTypeId = uint32_t;
+constexpr ComponentTypeId InvalidComponentTypeId = ~0u;
+constexpr uint32_t MaxComponentTypes = 64;
+
+// One bit per ComponentTypeId
+using ComponentMask = uint64_t;
+
+} // namespace Volante
@@ -0,0 +1,237 @@
+#include "World.h"
+
+#include <iostream>
+
+#include "Runtime/Spatial/SpatialIndex.h"
+
+namespace Volante {
+
+namespace {
+
+// Proxy user data: the entity's index and generation
+uint64_t PackEntity(Entity Target) {
+    return static_cast<uint64_t>(Target.Generation) << 32 | Target.Index;
+}
+
+Entity UnpackEntity(uint64_t UserData) {
+    return {static_cast<uint32_t>(UserData), static_cast<uint32_t>(UserData >> 32)};
+}
+
+} // namespace
+
+void World::Update(float DeltaTime) {
+    // Update all entities/actors
+}
+
+void World::Render(Renderer* Renderer) {
+    // Render all entities/actors
+}
+
+ComponentTypeId World::RegisterComponent(std::type_index Type, ComponentTypeInfo Info) {
+    if (const auto Found = TypeIds.find(Type); Found != TypeIds.end()) { return Found->second; }
+    if (ComponentTypes.size() >= MaxComponentTypes) {
+        std::cerr << "ERROR::WORLD::TOO_MANY_COMPONENT_TYPES: " << Info.Name << std::endl;
+        return InvalidComponentTypeId;
+    }
+    for (const ComponentTypeInfo& Existing : ComponentTypes) {
+        if (Existing.Name == Info.Name) {
+            std::cerr << "ERROR::WORLD::DUPLICATE_COMPONENT_NAME: " << Info.Name << std::endl;
+            return InvalidComponentTypeId;
+        }
+    }
+    const ComponentTypeId Id = static_cast<ComponentTypeId>(ComponentTypes.size());
+    ComponentSizes[Id] = Info.Size;
+    ComponentAlignments[Id] = Info.Alignment;
+    ComponentTypes.push_back(std::move(Info));
+    TypeIds.emplace(Type, Id);
+    return Id;
+}
+
+uint32_t World::FindOrCreateArchetype(ComponentMask Mask) {
+    if (const auto Found = ArchetypeIndices.find(Mask); Found != ArchetypeIndices.end()) { return Found->second; }
+    const uint32_t Index = static_cast<uint32_t>(Archetypes.size());
+    Archetypes.push_back(std::make_unique<Archetype>(Mask, ComponentSizes, ComponentAlignments));
+    ArchetypeIndices.emplace(Mask, Index);
+    return Index;
+}
+
+Entity World::AllocateEntity() {
+    uint32_t Index;
+    if (!FreeIndices.empty()) {
+        Index = FreeIndices.back();
+        FreeIndices.pop_back();
+    } else {
+        Index = static_cast<uint32_t>(Records.size());
+        Records.emplace_back();
+    }
+    ++EntityCount;
+    return {Index, Records[Index].Generation};
+}
+
+Entity World::CreateEntityIn(uint32_t ArchetypeIndex) {
+    const Entity Created = AllocateEntity();
+    Archetype& Owner = *Archetypes[ArchetypeIndex];
+    const uint32_t Row = Owner.AddRows(1);
+    Owner.GetEntity(Row) = Created;
+    for (uint32_t Column = 0; Column < Owner.GetColumnCount(); ++Column) {
+        std::memset(Owner.GetElement(Row, Column), 0, Owner.GetColumnSize(Column));
+    }
+    EntityRecord& Record = Records[Created.Index];
+    Record.Archetype = ArchetypeIndex;
+    Record.Row = Row;
+    return Created;
+}
+
+Entity World::CreateEntity() {
+    return CreateEntityIn(FindOrCreateArchetype(0));
+}
+
+const World::EntityRecord* World::FindRecord(Entity Target) const {
+    if (Target.Index >= Records.size()) { return nullptr; }
+    const EntityRecord& Record = Records[Target.Index];
+    if (Record.Generation != Target.Generation || Record.Archetype == ~0u) { return nullptr; }
+    return &Record;
+}
+
+bool World::IsAlive(Entity Target) const {
+    return FindRecord(Target) != nullptr;
+}
+
+void World::DestroyEntity(Entity Target) {
+    if (!FindRecord(Target)) { return; }
+    EntityRecord& Record = Records[Target.Index];
+    const Entity Moved = Archetypes[Record.Archetype]->RemoveRow(Record.Row);
+    if (Moved.IsValid()) { Records[Moved.Index].Row = Record.Row; }
+    RemoveProxy(Record);
+    Record.Archetype = ~0u;
+    ++Record.Generation;
+    FreeIndices.push_back(Target.Index);
+    --EntityCount;
+}
+
+void World::Clear() {
+    for (const std::unique_ptr<Archetype>& Owner : Archetypes) {
+        for (uint32_t Row = 0; Row < Owner->GetEntityCount(); ++Row) {
+            const Entity Target = Owner->GetEntity(Row);
+            RemoveProxy(Records[Target.Index]);
+            Records[Target.Index].Archetype = ~0u;
+            ++Records[Target.Index].Generation;
+            FreeIndices.push_back(Target.Index);
+        }
+        Owner->Clear();
+    }
+    EntityCount = 0;
+}
+
+uint32_t World::MoveEntity(Entity Target, ComponentMask Mask) {
+    EntityRecord& Record = Records[Target.Index];
+    const uint32_t ToIndex = FindOrCreateArchetype(Mask);
+    // FindOrCreateArchetype may have grown Archetypes
+    Archetype& From = *Archetypes[Record.Archetype];
+    Archetype& To = *Archetypes[ToIndex];
+    const uint32_t Row = To.AddRows(1);
+    To.GetEntity(Row) = Target;
+    for (uint32_t Column = 0; Column < To.GetColumnCount(); ++Column) {
+        const int FromColumn = From.GetColumn(To.GetTypes()[Column]);
+        if (FromColumn >= 0) {
+            std::memcpy(To.GetElement(Row, Column), From.GetElement(Record.Row, FromColumn), To.GetColumnSize(Column));
+        } else {
+            std::memset(To.GetElement(Row, Column), 0, To.GetColumnSize(Column));
+        }
+    }
+    const Entity Moved = From.RemoveRow(Record.Row);
+    if (Moved.IsValid()) { Records[Moved.Index].Row = Record.Row; }
+    Record.Archetype = ToIndex;
+    Record.Row = Row;
+    return Row;
+}
+
+void* World::AddComponent(Entity Target, ComponentTypeId Type) {
+    if (Type == InvalidComponentTypeId || !FindRecord(Target)) { return nullptr; }
+    const EntityRecord& Record = Records[Target.Index];
+    const Archetype* Current = Archetypes[Record.Archetype].get();
+    if (const int Column = Current->GetColumn(Type); Column >= 0) { return Current->GetElement(Record.Row, Column); }
+    const uint32_t Row = MoveEntity(Target, Current->GetMask() | (ComponentMask(1) << Type));
+    const Archetype& Owner = *Archetypes[Record.Archetype];
+    return Owner.GetElement(Row, Owner.GetColumn(Type));
+}
+
+void World::RemoveComponent(Entity Target, ComponentTypeId Type) {
+    if (Type == InvalidComponentTypeId || !FindRecord(Target)) { return; }
+    const ComponentMask Mask = Archetypes[Records[Target.Index].Archetype]->GetMask();
+    if ((Mask & (ComponentMask(1) << Type)) == 0) { return; }
+    MoveEntity(Target, Mask & ~(ComponentMask(1) << Type));
+}
+
+void* World::GetComponent(Entity Target, ComponentTypeId Type) {
+    const EntityRecord* Record = FindRecord(Target);
+    if (!Record || Type == InvalidComponentTypeId) { return nullptr; }
+    const Archetype& Owner = *Archetypes[Record->Archetype];
+    const int Column = Owner.GetColumn(Type);
+    return Column >= 0 ? Owner.GetElement(Record->Row, Column) : nullptr;
+}
+
+void World::SetSpatialIndex(SpatialIndex* Index) {
+    if (Index == Spatial) { return; }
+    for (uint32_t i = 0; i < Records.size(); ++i) {
+        EntityRecord& Record = Records[i];
+        if (Record.Proxy == InvalidSpatialId) { continue; }
+        const AABB Bounds = Spatial->GetBounds(Record.Proxy);
+        Spatial->RemoveProxy(Record.Proxy);
+        Record.Proxy = Index ? Index->AddProxy(Bounds, PackEntity({i, Record.Generation})) : InvalidSpatialId;
+    }
+    Spatial = Index;
+}
+
+void World::SetBounds(Entity Target, const AABB& Bounds) {
+    if (!Spatial || !FindRecord(Target)) { return; }
+    EntityRecord& Record = Records[Target.Index];
+    if (Record.Proxy == InvalidSpatialId) {
+        Record.Proxy = Spatial->AddProxy(Bounds, PackEntity(Target));
+    } else {
+        Spatial->MoveProxy(Record.Proxy, Bounds);
+    }
+}
+
+void World::ClearBounds(Entity Target) {
+    if (FindRecord(Target)) { RemoveProxy(Records[Target.Index]); }
+}
+
+void World::RemoveProxy(EntityRecord& Record) {
+    if (Record.Proxy == InvalidSpatialId) { return; }
+    Spatial->RemoveProxy(Record.Proxy);
+    Record.Proxy = InvalidSpatialId;
+}
+
+void World::QueryBox(const AABB& Box, std::vector<Entity>& OutEntities) const {
+    if (!Spatial) { return; }
+    thread_local std::vector<SpatialId> Ids;
+    Ids.clear();
+    Spatial->QueryAABB(Box, Ids);
+    for (const SpatialId Id : Ids) { OutEntities.push_back(UnpackEntity(Spatial->GetUserData(Id))); }
+}
+
+void World::QuerySphere(const Vec3& Center, float Radius, std::vector<Entity>& OutEntities) const {
+    if (!Spatial) { return; }
+    thread_local std::vector<SpatialId> Ids;
+    Ids.clear();
+    Spatial->QuerySphere(Center, Radius, Ids);
+    for (const SpatialId Id : Ids) { OutEntities.push_back(UnpackEntity(Spatial->GetUserData(Id))); }
+}
+
+void World::QueryNearest(const Vec3& Point, uint32_t K, float MaxDistance, std::vector<Entity>& OutEntities) const {
+    if (!Spatial) { return; }
+    thread_local std::vector<SpatialHit> Hits;
+    Hits.clear();
+    Spatial->QueryNearest(Point, K, MaxDistance, Hits);
+    for (const SpatialHit& Hit : Hits) { OutEntities.push_back(UnpackEntity(Spatial->GetUserData(Hit.Id))); }
+}
+
+Entity World::Raycast(const Ray& InRay, float MaxDistance, float* OutDistance) const {
+    SpatialHit Hit;
+    if (!Spatial || !Spatial->Raycast(InRay, MaxDistance, Hit)) { return InvalidEntity; }
+    if (OutDistance) { *OutDistance = Hit.Distance; }
+    return UnpackEntity(Spatial->GetUserData(Hit.Id));
+}
+
+} // namespace Volante
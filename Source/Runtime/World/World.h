@@ -0,0 +1,295 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <typeindex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Archetype.h"
+#include "Entity.h"
+#include "Runtime/Core/Async/JobSystem.h"
+#include "Runtime/Spatial/SpatialPartition.h"
+
+namespace Volante {
+
+class Renderer;
+class SpatialIndex;
+
+// Converts one element saved by an older version of a component into the current layout,
+// writing into zeroed memory. Returns false if it cannot. Called from job threads.
+using ComponentMigration = std::function<bool(uint32_t FromVersion, const void* Old, uint32_t OldSize, void* New)>;
+
+struct ComponentTypeInfo {
+    // Identifies the component in snapshots
+    std::string Name;
+    uint32_t Size = 0;
+    uint32_t Alignment = 0;
+    // Bumped when the layout changes; snapshots of another version go through Migrate
+    uint32_t Version = 1;
+    // Byte offsets of the component's Entity members, remapped when a snapshot is appended
+    std::vector<uint32_t> EntityFields;
+    ComponentMigration Migrate;
+};
+
+// Entities and their components, stored by archetype: every entity with the same set of
+// components shares an Archetype, whose chunks hold each component as a contiguous column.
+// Iteration walks whole columns and snapshots (WorldSerializer) copy them as blobs.
+//
+// Components must be trivially copyable; they are moved between archetypes, and saved, as
+// bytes. Adding or removing a component moves the entity to another archetype, and removing
+// an entity moves another into its row, so component pointers only last until the next
+// structural change.
+class World {
+public:
+    World() = default;
+    ~World() = default;
+
+    World(const World&) = delete;
+    World& operator=(const World&) = delete;
+
+    void Update(float DeltaTime);
+    void Render(Renderer* Renderer);
+
+    // Registering the same type again returns its existing id.
+    template <typename T>
+    ComponentTypeId RegisterComponent(std::string Name, uint32_t Version = 1, std::vector<uint32_t> EntityFields = {},
+                                      ComponentMigration Migrate = {});
+
+    // InvalidComponentTypeId if T was never registered.
+    template <typename T>
+    [[nodiscard]] ComponentTypeId GetComponentType() const;
+
+    [[nodiscard]] const std::vector<ComponentTypeInfo>& GetComponentTypes() const { return ComponentTypes; }
+
+    Entity CreateEntity();
+    template <typename... Ts>
+    Entity CreateEntity(const Ts&... Components);
+    void DestroyEntity(Entity Target);
+    [[nodiscard]] bool IsAlive(Entity Target) const;
+
+    // Destroys every entity; registrations stay.
+    void Clear();
+
+    // T must be registered and Target alive.
+    template <typename T>
+    T& AddComponent(Entity Target, const T& Component = {});
+    template <typename T>
+    void RemoveComponent(Entity Target);
+    // Null if the entity is dead or lacks the component.
+    template <typename T>
+    [[nodiscard]] T* GetComponent(Entity Target);
+    template <typename T>
+    [[nodiscard]] bool HasComponent(Entity Target) const;
+
+    // Type-erased forms. The added component is zeroed.
+    void* AddComponent(Entity Target, ComponentTypeId Type);
+    void RemoveComponent(Entity Target, ComponentTypeId Type);
+    [[nodiscard]] void* GetComponent(Entity Target, ComponentTypeId Type);
+
+    // Body(Entity, Ts&...) for every entity that has all of Ts, column by column.
+    template <typename... Ts, typename Fn>
+    void ForEach(Fn&& Body);
+
+    // Body(Count, const Entity*, Ts*...) once per chunk of every matching archetype, chunks
+    // spread over the job system. Body must not change the world's structure.
+    template <typename... Ts, typename Fn>
+    void ParallelForEachChunk(JobSystem* Jobs, Fn&& Body);
+
+    // Proximity queries run on Index, over the entities given bounds with SetBounds. Changes
+    // reach the queries when the index is flushed, which the engine does once per frame after
+    // Update. Entities already given bounds move over to the new index.
+    void SetSpatialIndex(SpatialIndex* Index);
+
+    [[nodiscard]] SpatialIndex* GetSpatialIndex() const { return Spatial; }
+
+    // Adds Target to the spatial index or moves it there; ignored without an index or when
+    // Target is dead. Destroying the entity takes it out.
+    void SetBounds(Entity Target, const AABB& Bounds);
+    void ClearBounds(Entity Target);
+
+    // Entities whose bounds overlap the region, appended to OutEntities in no particular order.
+    void QueryBox(const AABB& Box, std::vector<Entity>& OutEntities) const;
+    void QuerySphere(const Vec3& Center, float Radius, std::vector<Entity>& OutEntities) const;
+    // Up to K entities by distance to their bounds, nearest first.
+    void QueryNearest(const Vec3& Point, uint32_t K, float MaxDistance, std::vector<Entity>& OutEntities) const;
+    // First entity whose bounds the ray enters within MaxDistance, or InvalidEntity.
+    Entity Raycast(const Ray& InRay, float MaxDistance, float* OutDistance = nullptr) const;
+
+    [[nodiscard]] uint32_t GetEntityCount() const { return EntityCount; }
+
+    [[nodiscard]] uint32_t GetArchetypeCount() const { return static_cast<uint32_t>(Archetypes.size()); }
+
+private:
+    friend class WorldSerializer;
+
+    struct EntityRecord {
+        uint32_t Archetype = ~0u;
+        // Row within the archetype
+        uint32_t Row = 0;
+        uint32_t Generation = 0;
+        SpatialId Proxy = InvalidSpatialId;
+    };
+
+    template <typename... Ts>
+    struct ChunkView {
+        Archetype* Owner = nullptr;
+        uint32_t Chunk = 0;
+        int Columns[sizeof...(Ts)] = {};
+    };
+
+    ComponentTypeId RegisterComponent(std::type_index Type, ComponentTypeInfo Info);
+    uint32_t FindOrCreateArchetype(ComponentMask Mask);
+    Entity CreateEntityIn(uint32_t ArchetypeIndex);
+    // Moves Target to the archetype with Mask, keeping the components both have and zeroing
+    // the rest. Returns the new row.
+    uint32_t MoveEntity(Entity Target, ComponentMask Mask);
+    Entity AllocateEntity();
+    [[nodiscard]] const EntityRecord* FindRecord(Entity Target) const;
+    void RemoveProxy(EntityRecord& Record);
+
+    template <typename... Ts>
+    bool GetMask(ComponentTypeId (&Types)[sizeof...(Ts)], ComponentMask& Mask) const;
+
+    template <typename... Ts, typename Fn>
+    void CollectChunks(Fn&& Visit);
+
+    std::vector<ComponentTypeInfo> ComponentTypes;
+    std::unordered_map<std::type_index, ComponentTypeId> TypeIds;
+    // Per ComponentTypeId, for Archetype
+    std::vector<uint32_t> ComponentSizes = std::vector<uint32_t>(MaxComponentTypes, 0);
+    std::vector<uint32_t> ComponentAlignments = std::vector<uint32_t>(MaxComponentTypes, 1);
+
+    std::vector<std::unique_ptr<Archetype>> Archetypes;
+    std::unordered_map<ComponentMask, uint32_t> ArchetypeIndices;
+    std::vector<EntityRecord> Records;
+    // Reused last-in first-out
+    std::vector<uint32_t> FreeIndices;
+    uint32_t EntityCount = 0;
+
+    SpatialIndex* Spatial = nullptr;
+};
+
+template <typename T>
+ComponentTypeId World::RegisterComponent(std::string Name, uint32_t Version, std::vector<uint32_t> EntityFields,
+                                         ComponentMigration Migrate) {
+    static_assert(std::is_trivially_copyable_v<T>, "components are copied as bytes");
+    ComponentTypeInfo Info;
+    Info.Name = std::move(Name);
+    Info.Size = sizeof(T);
+    Info.Alignment = alignof(T);
+    Info.Version = Version;
+    Info.EntityFields = std::move(EntityFields);
+    Info.Migrate = std::move(Migrate);
+    return RegisterComponent(std::type_index(typeid(T)), std::move(Info));
+}
+
+template <typename T>
+ComponentTypeId World::GetComponentType() const {
+    const auto Found = TypeIds.find(std::type_index(typeid(T)));
+    return Found != TypeIds.end() ? Found->second : InvalidComponentTypeId;
+}
+
+template <typename... Ts>
+bool World::GetMask(ComponentTypeId (&Types)[sizeof...(Ts)], ComponentMask& Mask) const {
+    uint32_t i = 0;
+    ((Types[i++] = GetComponentType<Ts>()), ...);
+    Mask = 0;
+    for (const ComponentTypeId Type : Types) {
+        if (Type == InvalidComponentTypeId) { return false; }
+        Mask |= ComponentMask(1) << Type;
+    }
+    return true;
+}
+
+template <typename... Ts>
+Entity World::CreateEntity(const Ts&... Components) {
+    static_assert(sizeof...(Ts) > 0);
+    ComponentTypeId Types[sizeof...(Ts)];
+    ComponentMask Mask = 0;
+    if (!GetMask<Ts...>(Types, Mask)) { return InvalidEntity; }
+    const Entity Created = CreateEntityIn(FindOrCreateArchetype(Mask));
+    const EntityRecord& Record = Records[Created.Index];
+    const Archetype& Owner = *Archetypes[Record.Archetype];
+    uint32_t i = 0;
+    ((std::memcpy(Owner.GetElement(Record.Row, Owner.GetColumn(Types[i++])), &Components, sizeof(Ts))), ...);
+    return Created;
+}
+
+template <typename T>
+T& World::AddComponent(Entity Target, const T& Component) {
+    void* Data = AddComponent(Target, GetComponentType<T>());
+    std::memcpy(Data, &Component, sizeof(T));
+    return *static_cast<T*>(Data);
+}
+
+template <typename T>
+void World::RemoveComponent(Entity Target) {
+    RemoveComponent(Target, GetComponentType<T>());
+}
+
+template <typename T>
+T* World::GetComponent(Entity Target) {
+    const ComponentTypeId Type = GetComponentType<T>();
+    return Type == InvalidComponentTypeId ? nullptr : static_cast<T*>(GetComponent(Target, Type));
+}
+
+template <typename T>
+bool World::HasComponent(Entity Target) const {
+    const ComponentTypeId Type = GetComponentType<T>();
+    const EntityRecord* Record = FindRecord(Target);
+    return Record != nullptr && Type != InvalidComponentTypeId && Archetypes[Record->Archetype]->GetColumn(Type) >= 0;
+}
+
+template <typename... Ts, typename Fn>
+void World::CollectChunks(Fn&& Visit) {
+    static_assert(sizeof...(Ts) > 0);
+    ComponentTypeId Types[sizeof...(Ts)];
+    ComponentMask Mask = 0;
+    if (!GetMask<Ts...>(Types, Mask)) { return; }
+    for (const std::unique_ptr<Archetype>& Owner : Archetypes) {
+        if ((Owner->GetMask() & Mask) != Mask || Owner->GetEntityCount() == 0) { continue; }
+        ChunkView<Ts...> View;
+        View.Owner = Owner.get();
+        for (uint32_t i = 0; i < sizeof...(Ts); ++i) { View.Columns[i] = Owner->GetColumn(Types[i]); }
+        for (uint32_t Chunk = 0; Chunk < Owner->GetChunkCount(); ++Chunk) {
+            View.Chunk = Chunk;
+            Visit(View);
+        }
+    }
+}
+
+template <typename... Ts, typename Fn>
+void World::ForEach(Fn&& Body) {
+    CollectChunks<Ts...>([&](const ChunkView<Ts...>& View) {
+        const uint32_t Count = View.Owner->GetChunkEntityCount(View.Chunk);
+        const Entity* Entities = View.Owner->GetEntities(View.Chunk);
+        [&]<size_t... Is>(std::index_sequence<Is...>) {
+            const std::tuple<Ts*...> Columns{reinterpret_cast<Ts*>(View.Owner->GetColumnData(View.Chunk, View.Columns[Is]))...};
+            for (uint32_t Row = 0; Row < Count; ++Row) { Body(Entities[Row], std::get<Is>(Columns)[Row]...); }
+        }(std::index_sequence_for<Ts...>{});
+    });
+}
+
+template <typename... Ts, typename Fn>
+void World::ParallelForEachChunk(JobSystem* Jobs, Fn&& Body) {
+    std::vector<ChunkView<Ts...>> Views;
+    CollectChunks<Ts...>([&](const ChunkView<Ts...>& View) { Views.push_back(View); });
+    Volante::ParallelFor(Jobs, static_cast<uint32_t>(Views.size()), 1, [&](uint32_t Begin, uint32_t End) {
+        for (uint32_t i = Begin; i < End; ++i) {
+            const ChunkView<Ts...>& View = Views[i];
+            [&]<size_t... Is>(std::index_sequence<Is...>) {
+                Body(View.Owner->GetChunkEntityCount(View.Chunk), View.Owner->GetEntities(View.Chunk),
+                     reinterpret_cast<Ts*>(View.Owner->GetColumnData(View.Chunk, View.Columns[Is]))...);
+            }(std::index_sequence_for<Ts...>{});
+        }
+    });
+}
+
+} // namespace Volante
@@ -0,0 +1,51 @@
+#include "WorldHistory.h"
+
+#include <algorithm>
+
+namespace Volante {
+
+WorldHistory::WorldHistory(uint32_t Capacity, const WorldSaveOptions& InOptions)
+    : Options(InOptions), Snapshots(std::max(Capacity, 1u)) {}
+
+void WorldHistory::Record(const World& Source, uint64_t Frame, JobSystem* Jobs) {
+    while (Count > 0 && At(0).Frame >= Frame) {
+        Newest = static_cast<uint32_t>((Newest + Snapshots.size() - 1) % Snapshots.size());
+        --Count;
+    }
+    Newest = static_cast<uint32_t>((Newest + 1) % Snapshots.size());
+    Count = std::min<uint32_t>(Count + 1, static_cast<uint32_t>(Snapshots.size()));
+    Snapshot& Slot = Snapshots[Newest];
+    Slot.Frame = Frame;
+    WorldSerializer::Save(Source, Slot.Data, Options, Jobs);
+}
+
+bool WorldHistory::Rewind(World& Target, uint64_t Frame, JobSystem* Jobs, uint64_t* RestoredFrame) {
+    while (Count > 0 && At(0).Frame > Frame) {
+        Newest = static_cast<uint32_t>((Newest + Snapshots.size() - 1) % Snapshots.size());
+        --Count;
+    }
+    if (Count == 0) { return false; }
+    const Snapshot& Restored = At(0);
+    if (RestoredFrame) { *RestoredFrame = Restored.Frame; }
+    return WorldSerializer::Load(Target, Restored.Data.data(), Restored.Data.size(), WorldLoadMode::Replace, Jobs);
+}
+
+void WorldHistory::Clear() {
+    Count = 0;
+}
+
+uint64_t WorldHistory::GetOldestFrame() const {
+    return Count > 0 ? At(Count - 1).Frame : 0;
+}
+
+uint64_t WorldHistory::GetNewestFrame() const {
+    return Count > 0 ? At(0).Frame : 0;
+}
+
+size_t WorldHistory::GetMemoryUsage() const {
+    size_t Bytes = 0;
+    for (const Snapshot& Slot : Snapshots) { Bytes += Slot.Data.capacity(); }
+    return Bytes;
+}
+
+} // namespace Volante
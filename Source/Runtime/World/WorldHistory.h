@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "WorldSerializer.h"
+
+namespace Volante {
+
+class JobSystem;
+class World;
+
+// The last Capacity snapshots of a world, one per recorded frame, for rewinding to an earlier
+// frame and replaying from there. Snapshot buffers are reused as the ring wraps, so recording
+// every frame settles into no allocation.
+class WorldHistory {
+public:
+    explicit WorldHistory(uint32_t Capacity = 64, const WorldSaveOptions& Options = {});
+
+    // Frames must increase; recording a frame at or before the newest drops the newer ones.
+    void Record(const World& Source, uint64_t Frame, JobSystem* Jobs = nullptr);
+
+    // Restores the newest snapshot at or before Frame and drops those after it, since the world
+    // moves on from there. Returns false if there is none. RestoredFrame receives its frame.
+    bool Rewind(World& Target, uint64_t Frame, JobSystem* Jobs = nullptr, uint64_t* RestoredFrame = nullptr);
+
+    void Clear();
+
+    [[nodiscard]] uint32_t GetCount() const { return Count; }
+
+    [[nodiscard]] uint64_t GetOldestFrame() const;
+
+    [[nodiscard]] uint64_t GetNewestFrame() const;
+
+    // Bytes held by snapshots, counting reserved capacity
+    [[nodiscard]] size_t GetMemoryUsage() const;
+
+private:
+    struct Snapshot {
+        uint64_t Frame = 0;
+        std::vector<uint8_t> Data;
+    };
+
+    [[nodiscard]] Snapshot& At(uint32_t Age) { return Snapshots[(Newest + Snapshots.size() - Age) % Snapshots.size()]; }
+
+    [[nodiscard]] const Snapshot& At(uint32_t Age) const { return Snapshots[(Newest + Snapshots.size() - Age) % Snapshots.size()]; }
+
+    WorldSaveOptions Options;
+    std::vector<Snapshot> Snapshots;
+    // Slot of the newest snapshot
+    uint32_t Newest = 0;
+    uint32_t Count = 0;
+};
+
+} // namespace Volante
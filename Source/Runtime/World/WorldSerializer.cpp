@@ -0,0 +1,502 @@
+#include "WorldSerializer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include "World.h"
+#include "Runtime/Core/Async/JobSystem.h"
+#include "Runtime/Core/IO/Compression.h"
+#include "Runtime/Core/IO/MappedFile.h"
+#include "Runtime/Core/Misc/Utility.h"
+
+namespace Volante {
+
+namespace {
+
+// "VWLD", little-endian
+constexpr uint32_t WorldMagic = 0x444C5756;
+constexpr uint32_t WorldFormatVersion = 1;
+constexpr uint32_t WorldFileCompressed = 1;
+constexpr size_t BlobAlignment = 64;
+// Columns inside a blob, so a mapped uncompressed column is as aligned as a chunk's
+constexpr size_t ColumnAlignment = 16;
+
+struct FileHeader {
+    uint32_t Magic;
+    uint32_t Version;
+    uint32_t Flags;
+    uint32_t TypeCount;
+    uint32_t ArchetypeCount;
+    uint32_t RecordCount;
+    uint32_t FreeCount;
+    uint32_t BlockCount;
+    uint64_t FileSize;
+};
+static_assert(sizeof(FileHeader) == 40);
+
+// Followed by EntityFieldCount offsets, then the name, padded to 4 bytes
+struct FileType {
+    uint32_t NameLength;
+    uint32_t Size;
+    uint32_t Alignment;
+    uint32_t Version;
+    uint32_t EntityFieldCount;
+};
+static_assert(sizeof(FileType) == 20);
+
+// Followed by BlockCount FileBlocks. Mask bits are indices into the file's type table.
+struct FileArchetype {
+    uint64_t Mask;
+    uint32_t EntityCount;
+    uint32_t BlockCount;
+};
+static_assert(sizeof(FileArchetype) == 16);
+
+// Stored compressed when StoredSize < RawSize
+struct FileBlock {
+    uint64_t Offset;
+    uint32_t Count;
+    uint32_t RawSize;
+    uint32_t StoredSize;
+    uint32_t Reserved;
+};
+static_assert(sizeof(FileBlock) == 24);
+
+// Offsets of each column in a blob of Count rows, the entity column at 0. Returns the size.
+uint64_t LayoutBlock(uint64_t Count, const uint32_t* Sizes, size_t ColumnCount, uint64_t* Offsets) {
+    uint64_t Offset = Count * sizeof(Entity);
+    for (size_t Column = 0; Column < ColumnCount; ++Column) {
+        Offset = AlignUp(Offset, ColumnAlignment);
+        Offsets[Column] = Offset;
+        Offset += Count * Sizes[Column];
+    }
+    return Offset;
+}
+
+class Writer {
+public:
+    explicit Writer(uint8_t* InCursor) : Cursor(InCursor) {}
+
+    template <typename T>
+    void Write(const T& Value) { WriteBytes(&Value, sizeof(T)); }
+
+    void WriteBytes(const void* Data, size_t Size) {
+        if (Size > 0) { std::memcpy(Cursor, Data, Size); }
+        Cursor += Size;
+    }
+
+    // The output starts zeroed, so padding is skipped
+    void Pad(size_t Size) { Cursor += Size; }
+
+private:
+    uint8_t* Cursor;
+};
+
+class Reader {
+public:
+    Reader(const uint8_t* InData, size_t InSize) : Data(InData), Size(InSize) {}
+
+    template <typename T>
+    bool Read(T& Value) { return ReadBytes(&Value, sizeof(T)); }
+
+    bool ReadBytes(void* Out, size_t Count) {
+        if (Count > Size - Position) { return false; }
+        if (Count > 0) { std::memcpy(Out, Data + Position, Count); }
+        Position += Count;
+        return true;
+    }
+
+    bool Skip(size_t Count) {
+        if (Count > Size - Position) { return false; }
+        Position += Count;
+        return true;
+    }
+
+private:
+    const uint8_t* Data;
+    size_t Size;
+    size_t Position = 0;
+};
+
+struct SaveBlock {
+    const Archetype* Owner = nullptr;
+    uint32_t Chunk = 0;
+    uint32_t RawSize = 0;
+    uint64_t Offset = 0;
+    // Empty when stored raw
+    std::vector<uint8_t> Compressed;
+};
+
+void GatherBlock(const SaveBlock& Block, uint8_t* Out) {
+    const Archetype& Owner = *Block.Owner;
+    const uint32_t Count = Owner.GetChunkEntityCount(Block.Chunk);
+    uint32_t Sizes[MaxComponentTypes];
+    uint64_t Offsets[MaxComponentTypes];
+    for (uint32_t Column = 0; Column < Owner.GetColumnCount(); ++Column) { Sizes[Column] = Owner.GetColumnSize(Column); }
+    LayoutBlock(Count, Sizes, Owner.GetColumnCount(), Offsets);
+    uint64_t End = uint64_t(Count) * sizeof(Entity);
+    std::memcpy(Out, Owner.GetEntities(Block.Chunk), End);
+    for (uint32_t Column = 0; Column < Owner.GetColumnCount(); ++Column) {
+        std::memset(Out + End, 0, Offsets[Column] - End);
+        const uint64_t Bytes = uint64_t(Count) * Sizes[Column];
+        std::memcpy(Out + Offsets[Column], Owner.GetColumnData(Block.Chunk, Column), Bytes);
+        End = Offsets[Column] + Bytes;
+    }
+}
+
+struct LoadType {
+    ComponentTypeId Runtime = InvalidComponentTypeId;
+    uint32_t Size = 0;
+    uint32_t Version = 0;
+    bool Migrate = false;
+};
+
+struct LoadArchetype {
+    uint32_t Index = 0;
+    uint32_t FirstRow = 0;
+    uint32_t EntityCount = 0;
+    // File type of each column, ascending
+    std::vector<uint32_t> Types;
+};
+
+struct LoadBlock {
+    FileBlock Block{};
+    uint32_t Archetype = 0;
+    // Within the runtime archetype
+    uint32_t FirstRow = 0;
+};
+
+} // namespace
+
+void WorldSerializer::Save(const World& Source, std::vector<uint8_t>& Out, const WorldSaveOptions& Options, JobSystem* Jobs) {
+    std::vector<SaveBlock> Blocks;
+    uint32_t ArchetypeCount = 0;
+    size_t TableSize = sizeof(FileHeader);
+    for (const ComponentTypeInfo& Type : Source.ComponentTypes) {
+        TableSize += sizeof(FileType) + AlignUp(Type.EntityFields.size() * sizeof(uint32_t) + Type.Name.size(), 4);
+    }
+    TableSize += (Source.Records.size() + Source.FreeIndices.size()) * sizeof(uint32_t);
+    for (const std::unique_ptr<Archetype>& Owner : Source.Archetypes) {
+        if (Owner->GetEntityCount() == 0) { continue; }
+        ++ArchetypeCount;
+        TableSize += sizeof(FileArchetype) + Owner->GetChunkCount() * sizeof(FileBlock);
+        for (uint32_t Chunk = 0; Chunk < Owner->GetChunkCount(); ++Chunk) {
+            SaveBlock& Block = Blocks.emplace_back();
+            Block.Owner = Owner.get();
+            Block.Chunk = Chunk;
+            uint32_t Sizes[MaxComponentTypes];
+            uint64_t Offsets[MaxComponentTypes];
+            for (uint32_t Column = 0; Column < Owner->GetColumnCount(); ++Column) { Sizes[Column] = Owner->GetColumnSize(Column); }
+            Block.RawSize = static_cast<uint32_t>(LayoutBlock(Owner->GetChunkEntityCount(Chunk), Sizes, Owner->GetColumnCount(), Offsets));
+        }
+    }
+
+    if (Options.Compress) {
+        ParallelFor(Jobs, static_cast<uint32_t>(Blocks.size()), 1, [&](uint32_t Begin, uint32_t End) {
+            thread_local std::vector<uint8_t> Scratch;
+            for (uint32_t i = Begin; i < End; ++i) {
+                SaveBlock& Block = Blocks[i];
+                Scratch.resize(Block.RawSize);
+                GatherBlock(Block, Scratch.data());
+                Block.Compressed.resize(GetMaxCompressedSize(Block.RawSize));
+                const size_t Size = CompressBlock(Scratch.data(), Block.RawSize, Block.Compressed.data(), Block.Compressed.size());
+                Block.Compressed.resize(Size > 0 && Size < Block.RawSize ? Size : 0);
+            }
+        });
+    }
+
+    uint64_t Offset = AlignUp(TableSize, BlobAlignment);
+    for (SaveBlock& Block : Blocks) {
+        Block.Offset = Offset;
+        Offset = AlignUp(Offset + (Block.Compressed.empty() ? Block.RawSize : Block.Compressed.size()), ColumnAlignment);
+    }
+    Out.assign(Offset, 0);
+
+    Writer Tables(Out.data());
+    FileHeader Header{};
+    Header.Magic = WorldMagic;
+    Header.Version = WorldFormatVersion;
+    Header.Flags = Options.Compress ? WorldFileCompressed : 0;
+    Header.TypeCount = static_cast<uint32_t>(Source.ComponentTypes.size());
+    Header.ArchetypeCount = ArchetypeCount;
+    Header.RecordCount = static_cast<uint32_t>(Source.Records.size());
+    Header.FreeCount = static_cast<uint32_t>(Source.FreeIndices.size());
+    Header.BlockCount = static_cast<uint32_t>(Blocks.size());
+    Header.FileSize = Offset;
+    Tables.Write(Header);
+    for (const ComponentTypeInfo& Type : Source.ComponentTypes) {
+        const FileType Entry{static_cast<uint32_t>(Type.Name.size()), Type.Size, Type.Alignment, Type.Version,
+                             static_cast<uint32_t>(Type.EntityFields.size())};
+        Tables.Write(Entry);
+        Tables.WriteBytes(Type.EntityFields.data(), Type.EntityFields.size() * sizeof(uint32_t));
+        Tables.WriteBytes(Type.Name.data(), Type.Name.size());
+        Tables.Pad(AlignUp(Type.Name.size(), 4) - Type.Name.size());
+    }
+    for (const World::EntityRecord& Record : Source.Records) { Tables.Write(Record.Generation); }
+    Tables.WriteBytes(Source.FreeIndices.data(), Source.FreeIndices.size() * sizeof(uint32_t));
+    size_t BlockIndex = 0;
+    for (const std::unique_ptr<Archetype>& Owner : Source.Archetypes) {
+        if (Owner->GetEntityCount() == 0) { continue; }
+        Tables.Write(FileArchetype{Owner->GetMask(), Owner->GetEntityCount(), Owner->GetChunkCount()});
+        for (uint32_t Chunk = 0; Chunk < Owner->GetChunkCount(); ++Chunk) {
+            const SaveBlock& Block = Blocks[BlockIndex++];
+            const uint32_t Stored = Block.Compressed.empty() ? Block.RawSize : static_cast<uint32_t>(Block.Compressed.size());
+            Tables.Write(FileBlock{Block.Offset, Owner->GetChunkEntityCount(Chunk), Block.RawSize, Stored, 0});
+        }
+    }
+
+    ParallelFor(Jobs, static_cast<uint32_t>(Blocks.size()), 1, [&](uint32_t Begin, uint32_t End) {
+        for (uint32_t i = Begin; i < End; ++i) {
+            const SaveBlock& Block = Blocks[i];
+            if (Block.Compressed.empty()) {
+                GatherBlock(Block, Out.data() + Block.Offset);
+            } else {
+                std::memcpy(Out.data() + Block.Offset, Block.Compressed.data(), Block.Compressed.size());
+            }
+        }
+    });
+}
+
+bool WorldSerializer::SaveToFile(const World& Source, const std::string& Path, const WorldSaveOptions& Options, JobSystem* Jobs) {
+    std::vector<uint8_t> Data;
+    Save(Source, Data, Options, Jobs);
+    std::ofstream File(Path, std::ios::binary | std::ios::trunc);
+    if (!File.write(reinterpret_cast<const char*>(Data.data()), static_cast<std::streamsize>(Data.size()))) {
+        std::cerr << "ERROR::WORLD_SERIALIZER::WRITE_FAILED: " << Path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool WorldSerializer::Load(World& Target, const uint8_t* Data, size_t Size, WorldLoadMode Mode, JobSystem* Jobs) {
+    const auto Fail = [](const char* Reason) {
+        std::cerr << "ERROR::WORLD_SERIALIZER::" << Reason << std::endl;
+        return false;
+    };
+
+    Reader Tables(Data, Size);
+    FileHeader Header{};
+    if (!Tables.Read(Header) || Header.Magic != WorldMagic) { return Fail("NOT_A_SNAPSHOT"); }
+    if (Header.Version != WorldFormatVersion) { return Fail("UNSUPPORTED_VERSION"); }
+    if (Header.FileSize != Size) { return Fail("TRUNCATED"); }
+    // Bound the counts by the size before allocating anything from them
+    const uint64_t TableSize = (uint64_t(Header.RecordCount) + Header.FreeCount) * sizeof(uint32_t) +
+                               uint64_t(Header.ArchetypeCount) * sizeof(FileArchetype) + uint64_t(Header.BlockCount) * sizeof(FileBlock);
+    if (Header.TypeCount > MaxComponentTypes || Header.FreeCount > Header.RecordCount || TableSize > Size) {
+        return Fail("CORRUPT_HEADER");
+    }
+
+    std::vector<LoadType> Types(Header.TypeCount);
+    for (LoadType& Type : Types) {
+        FileType Entry{};
+        std::string Name;
+        if (!Tables.Read(Entry) || !Tables.Skip(size_t(Entry.EntityFieldCount) * sizeof(uint32_t))) { return Fail("CORRUPT_SCHEMA"); }
+        Name.resize(Entry.NameLength);
+        if (!Tables.ReadBytes(Name.data(), Name.size()) || !Tables.Skip(AlignUp(Name.size(), 4) - Name.size())) {
+            return Fail("CORRUPT_SCHEMA");
+        }
+        const auto Found = std::find_if(Target.ComponentTypes.begin(), Target.ComponentTypes.end(),
+                                        [&](const ComponentTypeInfo& Info) { return Info.Name == Name; });
+        if (Found == Target.ComponentTypes.end()) {
+            std::cerr << "ERROR::WORLD_SERIALIZER::UNKNOWN_COMPONENT: " << Name << std::endl;
+            return false;
+        }
+        Type.Runtime = static_cast<ComponentTypeId>(Found - Target.ComponentTypes.begin());
+        Type.Size = Entry.Size;
+        Type.Version = Entry.Version;
+        Type.Migrate = Entry.Version != Found->Version || Entry.Size != Found->Size;
+        if (Type.Migrate && !Found->Migrate) {
+            std::cerr << "ERROR::WORLD_SERIALIZER::NO_MIGRATION: " << Name << " version " << Entry.Version << std::endl;
+            return false;
+        }
+    }
+
+    std::vector<uint32_t> Generations(Header.RecordCount);
+    std::vector<uint32_t> FreeIndices(Header.FreeCount);
+    if (!Tables.ReadBytes(Generations.data(), Generations.size() * sizeof(uint32_t)) ||
+        !Tables.ReadBytes(FreeIndices.data(), FreeIndices.size() * sizeof(uint32_t))) {
+        return Fail("CORRUPT_ENTITIES");
+    }
+    std::vector<uint8_t> IsFree(Header.RecordCount, 0);
+    for (const uint32_t Index : FreeIndices) {
+        if (Index >= Header.RecordCount || IsFree[Index]) { return Fail("CORRUPT_ENTITIES"); }
+        IsFree[Index] = 1;
+    }
+
+    std::vector<LoadArchetype> Archetypes(Header.ArchetypeCount);
+    std::vector<LoadBlock> Blocks;
+    Blocks.reserve(Header.BlockCount);
+    uint64_t EntityTotal = 0;
+    for (uint32_t ArchetypeIndex = 0; ArchetypeIndex < Header.ArchetypeCount; ++ArchetypeIndex) {
+        LoadArchetype& Loaded = Archetypes[ArchetypeIndex];
+        FileArchetype Entry{};
+        if (!Tables.Read(Entry)) { return Fail("CORRUPT_ARCHETYPES"); }
+        uint32_t Sizes[MaxComponentTypes];
+        for (uint32_t Type = 0; Type < MaxComponentTypes; ++Type) {
+            if ((Entry.Mask & (uint64_t(1) << Type)) == 0) { continue; }
+            if (Type >= Header.TypeCount) { return Fail("CORRUPT_ARCHETYPES"); }
+            Sizes[Loaded.Types.size()] = Types[Type].Size;
+            Loaded.Types.push_back(Type);
+        }
+        Loaded.EntityCount = Entry.EntityCount;
+        uint64_t Rows = 0;
+        for (uint32_t Block = 0; Block < Entry.BlockCount; ++Block) {
+            LoadBlock& Loading = Blocks.emplace_back();
+            uint64_t Offsets[MaxComponentTypes];
+            if (!Tables.Read(Loading.Block)) { return Fail("CORRUPT_ARCHETYPES"); }
+            const FileBlock& Stored = Loading.Block;
+            if (Stored.Count == 0 || Stored.StoredSize > Stored.RawSize || Stored.Offset > Size ||
+                Stored.StoredSize > Size - Stored.Offset ||
+                LayoutBlock(Stored.Count, Sizes, Loaded.Types.size(), Offsets) != Stored.RawSize) {
+                return Fail("CORRUPT_BLOCKS");
+            }
+            Loading.Archetype = ArchetypeIndex;
+            Loading.FirstRow = static_cast<uint32_t>(Rows);
+            Rows += Stored.Count;
+        }
+        if (Rows != Entry.EntityCount) { return Fail("CORRUPT_BLOCKS"); }
+        EntityTotal += Rows;
+    }
+    if (Blocks.size() != Header.BlockCount || EntityTotal != Header.RecordCount - Header.FreeCount) {
+        return Fail("CORRUPT_ARCHETYPES");
+    }
+
+    // Everything below can be undone
+    if (Mode == WorldLoadMode::Replace) { Target.Clear(); }
+    const std::vector<World::EntityRecord> PreviousRecords = Target.Records;
+    const std::vector<uint32_t> PreviousFree = Target.FreeIndices;
+    const uint32_t PreviousEntityCount = Target.EntityCount;
+    std::vector<uint32_t> PreviousRows;
+    for (const std::unique_ptr<Archetype>& Owner : Target.Archetypes) { PreviousRows.push_back(Owner->GetEntityCount()); }
+    const auto Undo = [&](const char* Reason) {
+        for (size_t i = 0; i < Target.Archetypes.size(); ++i) { Target.Archetypes[i]->Truncate(i < PreviousRows.size() ? PreviousRows[i] : 0); }
+        Target.Records = PreviousRecords;
+        Target.FreeIndices = PreviousFree;
+        Target.EntityCount = PreviousEntityCount;
+        return Fail(Reason);
+    };
+
+    // Snapshot index to handle in the world
+    std::vector<Entity> Remap;
+    if (Mode == WorldLoadMode::Replace) {
+        Target.Records.assign(Header.RecordCount, {});
+        for (uint32_t Index = 0; Index < Header.RecordCount; ++Index) { Target.Records[Index].Generation = Generations[Index]; }
+        Target.FreeIndices = FreeIndices;
+        Target.EntityCount = static_cast<uint32_t>(EntityTotal);
+    } else {
+        Remap.assign(Header.RecordCount, InvalidEntity);
+        for (uint32_t Index = 0; Index < Header.RecordCount; ++Index) {
+            if (!IsFree[Index]) { Remap[Index] = Target.AllocateEntity(); }
+        }
+    }
+    for (LoadArchetype& Loaded : Archetypes) {
+        ComponentMask Mask = 0;
+        for (const uint32_t Type : Loaded.Types) { Mask |= ComponentMask(1) << Types[Type].Runtime; }
+        Loaded.Index = Target.FindOrCreateArchetype(Mask);
+        Loaded.FirstRow = Target.Archetypes[Loaded.Index]->AddRows(Loaded.EntityCount);
+    }
+
+    const auto IsLive = [&](Entity Reference) {
+        return Reference.Index < Header.RecordCount && !IsFree[Reference.Index] && Generations[Reference.Index] == Reference.Generation;
+    };
+    std::atomic<bool> Damaged{false};
+    ParallelFor(Jobs, static_cast<uint32_t>(Blocks.size()), 1, [&](uint32_t Begin, uint32_t End) {
+        thread_local std::vector<uint8_t> Scratch;
+        for (uint32_t i = Begin; i < End && !Damaged.load(std::memory_order_relaxed); ++i) {
+            const LoadBlock& Loading = Blocks[i];
+            const FileBlock& Stored = Loading.Block;
+            const LoadArchetype& Loaded = Archetypes[Loading.Archetype];
+            const Archetype& Owner = *Target.Archetypes[Loaded.Index];
+
+            const uint8_t* Blob = Data + Stored.Offset;
+            if (Stored.StoredSize < Stored.RawSize) {
+                Scratch.resize(Stored.RawSize);
+                if (!DecompressBlock(Blob, Stored.StoredSize, Scratch.data(), Stored.RawSize)) {
+                    Damaged = true;
+                    return;
+                }
+                Blob = Scratch.data();
+            }
+            uint32_t Sizes[MaxComponentTypes];
+            uint64_t Offsets[MaxComponentTypes];
+            int Columns[MaxComponentTypes];
+            for (size_t Column = 0; Column < Loaded.Types.size(); ++Column) {
+                Sizes[Column] = Types[Loaded.Types[Column]].Size;
+                Columns[Column] = Owner.GetColumn(Types[Loaded.Types[Column]].Runtime);
+            }
+            LayoutBlock(Stored.Count, Sizes, Loaded.Types.size(), Offsets);
+
+            // The runtime chunks may be split differently if a size changed
+            uint32_t Done = 0;
+            while (Done < Stored.Count) {
+                const uint32_t Row = Loaded.FirstRow + Loading.FirstRow + Done;
+                const uint32_t Count = std::min(Stored.Count - Done, Owner.GetCapacity() - Row % Owner.GetCapacity());
+                const uint32_t Chunk = Row / Owner.GetCapacity();
+                Entity* Entities = Owner.GetEntities(Chunk) + Row % Owner.GetCapacity();
+                for (uint32_t Element = 0; Element < Count; ++Element) {
+                    Entity Saved;
+                    std::memcpy(&Saved, Blob + size_t(Done + Element) * sizeof(Entity), sizeof(Entity));
+                    if (!IsLive(Saved)) {
+                        Damaged = true;
+                        return;
+                    }
+                    Entities[Element] = Mode == WorldLoadMode::Replace ? Saved : Remap[Saved.Index];
+                }
+                for (size_t Column = 0; Column < Loaded.Types.size(); ++Column) {
+                    const LoadType& Type = Types[Loaded.Types[Column]];
+                    const ComponentTypeInfo& Info = Target.ComponentTypes[Type.Runtime];
+                    const uint8_t* Source = Blob + Offsets[Column] + size_t(Done) * Type.Size;
+                    uint8_t* Destination = Owner.GetElement(Row, Columns[Column]);
+                    if (!Type.Migrate) {
+                        std::memcpy(Destination, Source, size_t(Count) * Type.Size);
+                    } else {
+                        std::memset(Destination, 0, size_t(Count) * Info.Size);
+                        for (uint32_t Element = 0; Element < Count; ++Element) {
+                            if (!Info.Migrate(Type.Version, Source + size_t(Element) * Type.Size, Type.Size,
+                                              Destination + size_t(Element) * Info.Size)) {
+                                Damaged = true;
+                                return;
+                            }
+                        }
+                    }
+                    if (Mode != WorldLoadMode::Append) { continue; }
+                    for (const uint32_t Field : Info.EntityFields) {
+                        for (uint32_t Element = 0; Element < Count; ++Element) {
+                            uint8_t* Address = Destination + size_t(Element) * Info.Size + Field;
+                            Entity Reference;
+                            std::memcpy(&Reference, Address, sizeof(Entity));
+                            if (!Reference.IsValid()) { continue; }
+                            Reference = IsLive(Reference) ? Remap[Reference.Index] : InvalidEntity;
+                            std::memcpy(Address, &Reference, sizeof(Entity));
+                        }
+                    }
+                }
+                Done += Count;
+            }
+        }
+    });
+    if (Damaged) { return Undo("CORRUPT_BLOCK_DATA"); }
+
+    // Point the records at the rows; a snapshot index seen twice is damage IsLive cannot catch
+    for (const LoadArchetype& Loaded : Archetypes) {
+        const Archetype& Owner = *Target.Archetypes[Loaded.Index];
+        for (uint32_t Row = Loaded.FirstRow; Row < Loaded.FirstRow + Loaded.EntityCount; ++Row) {
+            World::EntityRecord& Record = Target.Records[Owner.GetEntity(Row).Index];
+            if (Record.Archetype != ~0u) { return Undo("DUPLICATE_ENTITY"); }
+            Record.Archetype = Loaded.Index;
+            Record.Row = Row;
+        }
+    }
+    return true;
+}
+
+bool WorldSerializer::LoadFromFile(World& Target, const std::string& Path, WorldLoadMode Mode, JobSystem* Jobs) {
+    MappedFile File;
+    if (!File.Open(Path)) { return false; }
+    return Load(Target, File.GetData(), File.GetSize(), Mode, Jobs);
+}
+
+} // namespace Volante
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Volante {
+
+class JobSystem;
+class World;
+
+struct WorldSaveOptions {
+    // LZ4 each chunk's blob; blobs that do not shrink are kept raw
+    bool Compress = false;
+};
+
+enum class WorldLoadMode {
+    // Clear the world and restore the snapshot's entities with their exact handles, free list
+    // included, so the world continues as if it had never moved on. For rewind and replay.
+    Replace,
+    // Add the snapshot's entities to the world under new handles. Entity references inside
+    // components (ComponentTypeInfo::EntityFields) are remapped; references to entities
+    // outside the snapshot become InvalidEntity.
+    Append,
+};
+
+// Binary snapshots of a World. The same world always saves to the same bytes.
+//
+// A snapshot is a header, the component schema (name, size, version and entity fields of
+// each type), the entity generations and free list, then per archetype a table of blocks.
+// A block is one chunk: its entity column and each component column, contiguous and
+// optionally compressed, so saving and loading are memcpy per column and run in parallel
+// over blocks. Components are matched by name on load; a type whose version or size
+// changed goes through its Migrate function, one element at a time.
+//
+// Loading checks the header and tables before touching the world. Damage found in the
+// blocks themselves undoes an Append and leaves a Replace with an empty world.
+class WorldSerializer {
+public:
+    static void Save(const World& Source, std::vector<uint8_t>& Out, const WorldSaveOptions& Options = {},
+                     JobSystem* Jobs = nullptr);
+    static bool SaveToFile(const World& Source, const std::string& Path, const WorldSaveOptions& Options = {},
+                           JobSystem* Jobs = nullptr);
+
+    static bool Load(World& Target, const uint8_t* Data, size_t Size, WorldLoadMode Mode = WorldLoadMode::Replace,
+                     JobSystem* Jobs = nullptr);
+    // Maps the file instead of reading it, so uncompressed blocks are copied straight from the
+    // page cache into chunks.
+    static bool LoadFromFile(World& Target, const std::string& Path, WorldLoadMode Mode = WorldLoadMode::Replace,
+                             JobSystem* Jobs = nullptr);
+};
+
+} // namespace Volante
@@ -0,0 +1,247 @@
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Runtime/Core/IO/Compression.h"
+#include "Test.h"
+
+namespace Volante::Test {
+
+namespace {
+
+std::vector<uint8_t> MakeRandom(size_t Size, uint32_t Seed) {
+    std::mt19937 Rng(Seed);
+    std::vector<uint8_t> Data(Size);
+    for (uint8_t& Byte : Data) { Byte = static_cast<uint8_t>(Rng()); }
+    return Data;
+}
+
+// Text-like: words from a small vocabulary, so there are matches at every distance
+std::vector<uint8_t> MakeText(size_t Size, uint32_t Seed) {
+    static const char* Words[] = {"entity ", "archetype ", "chunk ", "column ", "snapshot ", "world ", "the ", "a "};
+    std::mt19937 Rng(Seed);
+    std::vector<uint8_t> Data;
+    while (Data.size() < Size) {
+        for (const char* Letter = Words[Rng() % std::size(Words)]; *Letter != 0 && Data.size() < Size; ++Letter) {
+            Data.push_back(static_cast<uint8_t>(*Letter));
+        }
+    }
+    return Data;
+}
+
+std::vector<std::vector<uint8_t>> MakeInputs() {
+    std::vector<std::vector<uint8_t>> Inputs;
+    Inputs.push_back({});
+    Inputs.push_back({42});
+    Inputs.push_back(std::vector<uint8_t>(13, 7));
+    Inputs.push_back(std::vector<uint8_t>(200'000, 0));
+    Inputs.push_back(MakeRandom(100'000, 1));
+    Inputs.push_back(MakeText(300'000, 2));
+    // Long run, then noise, then the run again: matches far back and past the LZ4 window
+    std::vector<uint8_t> Mixed = MakeText(70'000, 3);
+    const std::vector<uint8_t> Noise = MakeRandom(5'000, 4);
+    Mixed.insert(Mixed.end(), Noise.begin(), Noise.end());
+    Mixed.insert(Mixed.end(), Mixed.begin(), Mixed.begin() + 70'000);
+    Inputs.push_back(std::move(Mixed));
+    return Inputs;
+}
+
+void TestLZ4RoundTrip(TestContext& Context) {
+    for (const std::vector<uint8_t>& Input : MakeInputs()) {
+        std::vector<uint8_t> Compressed(GetMaxCompressedSize(Input.size()));
+        const size_t Size = CompressBlock(Input.data(), Input.size(), Compressed.data(), Compressed.size());
+        if (!VOLANTE_CHECK(Context, Size > 0 || Input.empty())) { continue; }
+
+        std::vector<uint8_t> Output(Input.size());
+        VOLANTE_CHECK(Context, DecompressBlock(Compressed.data(), Size, Output.data(), Output.size()));
+        VOLANTE_CHECK(Context, Output == Input);
+    }
+}
+
+void TestLZ4Shrinks(TestContext& Context) {
+    const std::vector<uint8_t> Text = MakeText(100'000, 5);
+    std::vector<uint8_t> Compressed(GetMaxCompressedSize(Text.size()));
+    const size_t Size = CompressBlock(Text.data(), Text.size(), Compressed.data(), Compressed.size());
+    VOLANTE_CHECK(Context, Size > 0 && Size < Text.size() / 2);
+}
+
+void TestLZ4RejectsSmallDestination(TestContext& Context) {
+    const std::vector<uint8_t> Noise = MakeRandom(10'000, 6);
+    std::vector<uint8_t> Compressed(Noise.size() / 2);
+    VOLANTE_CHECK(Context, CompressBlock(Noise.data(), Noise.size(), Compressed.data(), Compressed.size()) == 0);
+}
+
+// Decoding checks the size it was promised and never runs off either buffer
+void TestLZ4RejectsDamage(TestContext& Context) {
+    const std::vector<uint8_t> Text = MakeText(50'000, 7);
+    std::vector<uint8_t> Compressed(GetMaxCompressedSize(Text.size()));
+    const size_t Size = CompressBlock(Text.data(), Text.size(), Compressed.data(), Compressed.size());
+    Compressed.resize(Size);
+
+    std::vector<uint8_t> Output(Text.size() + 1);
+    VOLANTE_CHECK(Context, !DecompressBlock(Compressed.data(), Size, Output.data(), Text.size() + 1));
+    VOLANTE_CHECK(Context, !DecompressBlock(Compressed.data(), Size, Output.data(), Text.size() - 1));
+    VOLANTE_CHECK(Context, !DecompressBlock(Compressed.data(), Size / 2, Output.data(), Text.size()));
+
+    std::mt19937 Rng(8);
+    for (int Round = 0; Round < 200; ++Round) {
+        std::vector<uint8_t> Damaged = Compressed;
+        for (int Flip = 0; Flip < 4; ++Flip) { Damaged[Rng() % Damaged.size()] ^= static_cast<uint8_t>(1u << (Rng() % 8)); }
+        // Either outcome is fine; this is here for the bounds checks
+        (void)DecompressBlock(Damaged.data(), Damaged.size(), Output.data(), Text.size());
+    }
+    const std::vector<uint8_t> Garbage = MakeRandom(4'000, 9);
+    (void)DecompressBlock(Garbage.data(), Garbage.size(), Output.data(), Output.size());
+}
+
+// A decoder for the subset of RFC 1950/1951 CompressZlib writes (stored and fixed-Huffman
+// blocks), to round-trip the encoder without an external zlib.
+class Inflater {
+public:
+    Inflater(const uint8_t* Data, size_t Size) : Data(Data), Size(Size) {}
+
+    bool Inflate(std::vector<uint8_t>& Out) {
+        if (Size < 6 || (Data[0] & 0x0F) != 8 || ((Data[0] << 8) | Data[1]) % 31 != 0) { return false; }
+        Position = 2;
+        bool Final = false;
+        while (!Final) {
+            Final = ReadBits(1) == 1;
+            const uint32_t Type = ReadBits(2);
+            if (Type == 0) {
+                if (!ReadStored(Out)) { return false; }
+            } else if (Type == 1) {
+                if (!ReadFixed(Out)) { return false; }
+            } else {
+                return false;
+            }
+            if (Overrun) { return false; }
+        }
+        // Adler-32 of the output, big-endian, on a byte boundary
+        BitCount = 0;
+        if (Position + 4 != Size) { return false; }
+        const uint32_t Stored = (uint32_t(Data[Position]) << 24) | (uint32_t(Data[Position + 1]) << 16) |
+                                (uint32_t(Data[Position + 2]) << 8) | Data[Position + 3];
+        uint32_t A = 1;
+        uint32_t B = 0;
+        for (const uint8_t Byte : Out) {
+            A = (A + Byte) % 65521;
+            B = (B + A) % 65521;
+        }
+        return Stored == ((B << 16) | A);
+    }
+
+private:
+    uint32_t ReadBits(uint32_t Count) {
+        uint32_t Value = 0;
+        for (uint32_t i = 0; i < Count; ++i) {
+            if (BitCount == 0) {
+                if (Position >= Size) {
+                    Overrun = true;
+                    return 0;
+                }
+                Bits = Data[Position++];
+                BitCount = 8;
+            }
+            Value |= (Bits & 1u) << i;
+            Bits >>= 1;
+            --BitCount;
+        }
+        return Value;
+    }
+
+    // Huffman codes are packed most significant bit first
+    uint32_t ReadCode(uint32_t Count) {
+        uint32_t Code = 0;
+        for (uint32_t i = 0; i < Count; ++i) { Code = (Code << 1) | ReadBits(1); }
+        return Code;
+    }
+
+    bool ReadStored(std::vector<uint8_t>& Out) {
+        BitCount = 0;
+        if (Position + 4 > Size) { return false; }
+        const uint32_t Length = Data[Position] | (Data[Position + 1] << 8);
+        const uint32_t Complement = Data[Position + 2] | (Data[Position + 3] << 8);
+        Position += 4;
+        if ((Length ^ 0xFFFF) != Complement || Position + Length > Size) { return false; }
+        Out.insert(Out.end(), Data + Position, Data + Position + Length);
+        Position += Length;
+        return true;
+    }
+
+    uint32_t ReadLiteralOrLength() {
+        uint32_t Code = ReadCode(7);
+        if (Code <= 0x17) { return 256 + Code; }
+        Code = (Code << 1) | ReadBits(1);
+        if (Code >= 0x30 && Code <= 0xBF) { return Code - 0x30; }
+        if (Code >= 0xC0 && Code <= 0xC7) { return 280 + Code - 0xC0; }
+        Code = (Code << 1) | ReadBits(1);
+        return 144 + Code - 0x190;
+    }
+
+    bool ReadFixed(std::vector<uint8_t>& Out) {
+        static constexpr uint16_t LengthBase[] = {3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+                                                  31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+        static constexpr uint8_t LengthExtra[] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                                  2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+        static constexpr uint16_t DistanceBase[] = {1,   2,   3,   4,   5,   7,    9,    13,   17,   25,   33,   49,   65,    97,    129,
+                                                    193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+        static constexpr uint8_t DistanceExtra[] = {0, 0, 0, 0, 1, 1, 2, 2,  3,  3,  4,  4,  5,  5,  6,
+                                                    6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+        for (;;) {
+            const uint32_t Symbol = ReadLiteralOrLength();
+            if (Overrun) { return false; }
+            if (Symbol < 256) {
+                Out.push_back(static_cast<uint8_t>(Symbol));
+                continue;
+            }
+            if (Symbol == 256) { return true; }
+            if (Symbol > 285) { return false; }
+            const uint32_t Length = LengthBase[Symbol - 257] + ReadBits(LengthExtra[Symbol - 257]);
+            const uint32_t DistanceCode = ReadCode(5);
+            if (DistanceCode >= 30) { return false; }
+            const uint32_t Distance = DistanceBase[DistanceCode] + ReadBits(DistanceExtra[DistanceCode]);
+            if (Distance > Out.size()) { return false; }
+            for (uint32_t i = 0; i < Length; ++i) { Out.push_back(Out[Out.size() - Distance]); }
+        }
+    }
+
+    const uint8_t* Data;
+    size_t Size;
+    size_t Position = 0;
+    uint32_t Bits = 0;
+    uint32_t BitCount = 0;
+    bool Overrun = false;
+};
+
+void TestZlibRoundTrip(TestContext& Context) {
+    for (const std::vector<uint8_t>& Input : MakeInputs()) {
+        std::vector<uint8_t> Compressed(GetMaxZlibSize(Input.size()));
+        const size_t Size = CompressZlib(Input.data(), Input.size(), Compressed.data(), Compressed.size());
+        if (!VOLANTE_CHECK(Context, Size > 0)) { continue; }
+
+        std::vector<uint8_t> Output;
+        VOLANTE_CHECK(Context, Inflater(Compressed.data(), Size).Inflate(Output));
+        VOLANTE_CHECK(Context, Output == Input);
+    }
+}
+
+void TestZlibRejectsSmallDestination(TestContext& Context) {
+    const std::vector<uint8_t> Noise = MakeRandom(10'000, 10);
+    std::vector<uint8_t> Compressed(Noise.size() / 2);
+    VOLANTE_CHECK(Context, CompressZlib(Noise.data(), Noise.size(), Compressed.data(), Compressed.size()) == 0);
+}
+
+const bool Registered = [] {
+    TestRegistration("Compression/LZ4RoundTrip", TestLZ4RoundTrip);
+    TestRegistration("Compression/LZ4Shrinks", TestLZ4Shrinks);
+    TestRegistration("Compression/LZ4RejectsSmallDestination", TestLZ4RejectsSmallDestination);
+    TestRegistration("Compression/LZ4RejectsDamage", TestLZ4RejectsDamage);
+    TestRegistration("Compression/ZlibRoundTrip", TestZlibRoundTrip);
+    TestRegistration("Compression/ZlibRejectsSmallDestination", TestZlibRejectsSmallDestination);
+    return true;
+}();
+
+} // namespace
+
+} // namespace Volante::Test
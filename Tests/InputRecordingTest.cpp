@@ -0,0 +1,164 @@
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "Runtime/Core/Input/InputRecording.h"
+#include "Test.h"
+
+namespace Volante::Test {
+
+namespace {
+
+std::string GetTempPath(const char* Name) {
+    return (std::filesystem::temp_directory_path() / Name).string();
+}
+
+bool SameEvent(const InputEvent& A, const InputEvent& B) {
+    if (A.Type != B.Type) { return false; }
+    switch (A.Type) {
+    case InputEventType::Key:
+    case InputEventType::MouseButton:
+        return A.Code == B.Code && A.Action == B.Action;
+    case InputEventType::CursorPos:
+        return A.X == B.X && A.Y == B.Y;
+    case InputEventType::Resize:
+        return A.Width == B.Width && A.Height == B.Height;
+    }
+    return false;
+}
+
+struct RecordedFrame {
+    float DeltaTime = 0.0f;
+    std::vector<InputEvent> Events;
+};
+
+std::vector<RecordedFrame> MakeSession() {
+    std::vector<RecordedFrame> Frames(200);
+    for (size_t i = 0; i < Frames.size(); ++i) {
+        RecordedFrame& Frame = Frames[i];
+        Frame.DeltaTime = 1.0f / 60.0f + static_cast<float>(i) * 1e-5f;
+        // Most frames carry no input at all
+        if (i % 7 != 0) { continue; }
+        InputEvent Key;
+        Key.Type = InputEventType::Key;
+        Key.Code = static_cast<int32_t>(KeyCode::W) + static_cast<int32_t>(i % 5);
+        Key.Action = i % 2 ? InputAction::Press : InputAction::Release;
+        Frame.Events.push_back(Key);
+
+        InputEvent Cursor;
+        Cursor.Type = InputEventType::CursorPos;
+        Cursor.X = 0.1 * static_cast<double>(i) + 1.0 / 3.0;
+        Cursor.Y = -2.5e3 + static_cast<double>(i);
+        Frame.Events.push_back(Cursor);
+    }
+    InputEvent Button;
+    Button.Type = InputEventType::MouseButton;
+    Button.Code = static_cast<int32_t>(MouseButton::None);
+    Button.Action = InputAction::Repeat;
+    Frames[3].Events.push_back(Button);
+
+    InputEvent Resize;
+    Resize.Type = InputEventType::Resize;
+    Resize.Width = 3840;
+    Resize.Height = 2160;
+    Frames[50].Events.push_back(Resize);
+    return Frames;
+}
+
+bool Record(const std::string& Path, const std::vector<RecordedFrame>& Frames, const InputRecordingHeader& Header) {
+    InputRecorder Recorder;
+    if (!Recorder.Open(Path, Header)) { return false; }
+    for (const RecordedFrame& Frame : Frames) { Recorder.WriteFrame(Frame.DeltaTime, Frame.Events); }
+    Recorder.Close();
+    return true;
+}
+
+void TestRoundTrip(TestContext& Context) {
+    const std::string Path = GetTempPath("VolanteInputRoundTrip.vinp");
+    const std::vector<RecordedFrame> Frames = MakeSession();
+    const InputRecordingHeader Header{1280, 720, 640.5, 360.25};
+    if (!VOLANTE_CHECK(Context, Record(Path, Frames, Header))) { return; }
+
+    InputPlayback Playback;
+    if (VOLANTE_CHECK(Context, Playback.Open(Path))) {
+        VOLANTE_CHECK(Context, Playback.GetHeader().FramebufferWidth == 1280);
+        VOLANTE_CHECK(Context, Playback.GetHeader().FramebufferHeight == 720);
+        VOLANTE_CHECK(Context, Playback.GetHeader().CursorX == 640.5 && Playback.GetHeader().CursorY == 360.25);
+
+        float DeltaTime = 0.0f;
+        std::vector<InputEvent> Events;
+        for (const RecordedFrame& Frame : Frames) {
+            if (!VOLANTE_CHECK(Context, Playback.ReadFrame(DeltaTime, Events))) { break; }
+            VOLANTE_CHECK(Context, DeltaTime == Frame.DeltaTime);
+            if (!VOLANTE_CHECK(Context, Events.size() == Frame.Events.size())) { continue; }
+            for (size_t i = 0; i < Events.size(); ++i) { VOLANTE_CHECK(Context, SameEvent(Events[i], Frame.Events[i])); }
+        }
+        VOLANTE_CHECK(Context, !Playback.ReadFrame(DeltaTime, Events));
+        VOLANTE_CHECK(Context, Playback.GetFrameCount() == Frames.size());
+    }
+    std::filesystem::remove(Path);
+}
+
+// A recording cut off mid-frame, as after a crash, plays back every whole frame and then ends
+void TestTruncatedRecording(TestContext& Context) {
+    const std::string Path = GetTempPath("VolanteInputTruncated.vinp");
+    const std::vector<RecordedFrame> Frames = MakeSession();
+    if (!VOLANTE_CHECK(Context, Record(Path, Frames, {}))) { return; }
+    // The last frame is empty (five bytes), so cutting three leaves all the others whole
+    std::filesystem::resize_file(Path, std::filesystem::file_size(Path) - 3);
+
+    InputPlayback Playback;
+    if (VOLANTE_CHECK(Context, Playback.Open(Path))) {
+        float DeltaTime = 0.0f;
+        std::vector<InputEvent> Events;
+        uint64_t Read = 0;
+        while (Playback.ReadFrame(DeltaTime, Events)) { ++Read; }
+        VOLANTE_CHECK(Context, Read == Frames.size() - 1);
+    }
+    std::filesystem::remove(Path);
+}
+
+// A recorder that goes away without Close(), as when the engine exits early, still saves the session
+void TestDestructionSaves(TestContext& Context) {
+    const std::string Path = GetTempPath("VolanteInputDestroyed.vinp");
+    const std::vector<RecordedFrame> Frames = MakeSession();
+    {
+        InputRecorder Recorder;
+        if (!VOLANTE_CHECK(Context, Recorder.Open(Path, {}))) { return; }
+        for (const RecordedFrame& Frame : Frames) { Recorder.WriteFrame(Frame.DeltaTime, Frame.Events); }
+    }
+
+    InputPlayback Playback;
+    if (VOLANTE_CHECK(Context, Playback.Open(Path))) {
+        float DeltaTime = 0.0f;
+        std::vector<InputEvent> Events;
+        while (Playback.ReadFrame(DeltaTime, Events)) {}
+        VOLANTE_CHECK(Context, Playback.GetFrameCount() == Frames.size());
+    }
+    std::filesystem::remove(Path);
+}
+
+void TestRejectsOtherFiles(TestContext& Context) {
+    const std::string Path = GetTempPath("VolanteInputNotARecording.vinp");
+    {
+        std::ofstream File(Path, std::ios::binary);
+        File << "definitely not an input recording";
+    }
+    InputPlayback Playback;
+    VOLANTE_CHECK(Context, !Playback.Open(Path));
+    std::filesystem::remove(Path);
+    VOLANTE_CHECK(Context, !Playback.Open(Path));
+}
+
+const bool Registered = [] {
+    TestRegistration("InputRecording/RoundTrip", TestRoundTrip);
+    TestRegistration("InputRecording/TruncatedRecording", TestTruncatedRecording);
+    TestRegistration("InputRecording/DestructionSaves", TestDestructionSaves);
+    TestRegistration("InputRecording/RejectsOtherFiles", TestRejectsOtherFiles);
+    return true;
+}();
+
+} // namespace
+
+} // namespace Volante::Test
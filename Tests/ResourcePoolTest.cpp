@@ -0,0 +1,156 @@
+#include <memory>
+
+#include "Runtime/Rendering/ResourcePool.h"
+#include "Test.h"
+
+namespace Volante::Test {
+
+namespace {
+
+// Counts destructions, to see when the pool really lets go of an object
+struct TrackedResource {
+    explicit TrackedResource(int& InDestroyed) : Destroyed(InDestroyed) {}
+    ~TrackedResource() { ++Destroyed; }
+
+    int& Destroyed;
+};
+
+using TrackedPool = ResourcePool<TrackedResource>;
+
+void TestAddAndGet(TestContext& Context) {
+    int Destroyed = 0;
+    TrackedPool Pool;
+    auto First = std::make_unique<TrackedResource>(Destroyed);
+    TrackedResource* FirstPointer = First.get();
+    const ResourceHandle<TrackedResource> A = Pool.Add(std::move(First), 1);
+    const ResourceHandle<TrackedResource> B = Pool.Add(std::make_unique<TrackedResource>(Destroyed), 2);
+
+    VOLANTE_CHECK(Context, A.IsValid() && B.IsValid() && A != B);
+    VOLANTE_CHECK(Context, Pool.Get(A) == FirstPointer);
+    VOLANTE_CHECK(Context, Pool.FindByHash(1) == A);
+    VOLANTE_CHECK(Context, Pool.FindByHash(2) == B);
+    VOLANTE_CHECK(Context, !Pool.FindByHash(3).IsValid());
+    VOLANTE_CHECK(Context, Pool.Get({}) == nullptr);
+    VOLANTE_CHECK(Context, Pool.GetLiveCount() == 2);
+}
+
+void TestReferenceCounting(TestContext& Context) {
+    int Destroyed = 0;
+    TrackedPool Pool;
+    const ResourceHandle<TrackedResource> Handle = Pool.Add(std::make_unique<TrackedResource>(Destroyed), 7);
+    VOLANTE_CHECK(Context, Pool.AddRef(Handle));
+    VOLANTE_CHECK(Context, Pool.GetRefCount(Handle) == 2);
+
+    VOLANTE_CHECK(Context, !Pool.Release(Handle, 10));
+    VOLANTE_CHECK(Context, Pool.Get(Handle) != nullptr);
+    VOLANTE_CHECK(Context, Pool.Release(Handle, 10));
+    VOLANTE_CHECK(Context, Pool.Get(Handle) == nullptr);
+    VOLANTE_CHECK(Context, Pool.GetRefCount(Handle) == 0);
+    VOLANTE_CHECK(Context, !Pool.FindByHash(7).IsValid());
+    VOLANTE_CHECK(Context, Pool.GetLiveCount() == 0);
+
+    // A stale handle cannot take the count below zero or resurrect the slot
+    VOLANTE_CHECK(Context, !Pool.Release(Handle, 11));
+    VOLANTE_CHECK(Context, !Pool.AddRef(Handle));
+}
+
+void TestGenerations(TestContext& Context) {
+    int Destroyed = 0;
+    TrackedPool Pool;
+    const ResourceHandle<TrackedResource> Old = Pool.Add(std::make_unique<TrackedResource>(Destroyed), 1);
+    Pool.Release(Old, 0);
+
+    const ResourceHandle<TrackedResource> New = Pool.Add(std::make_unique<TrackedResource>(Destroyed), 2);
+    VOLANTE_CHECK(Context, New.Index == Old.Index);
+    VOLANTE_CHECK(Context, New.Generation != Old.Generation);
+    VOLANTE_CHECK(Context, Pool.Get(Old) == nullptr);
+    VOLANTE_CHECK(Context, Pool.Get(New) != nullptr);
+    VOLANTE_CHECK(Context, !Pool.Release(Old, 0));
+    VOLANTE_CHECK(Context, Pool.GetRefCount(New) == 1);
+}
+
+// Released objects are parked until the frame they were released in is no longer in flight
+void TestDeferredDestruction(TestContext& Context) {
+    int Destroyed = 0;
+    TrackedPool Pool;
+    const ResourceHandle<TrackedResource> A = Pool.Add(std::make_unique<TrackedResource>(Destroyed), 1);
+    const ResourceHandle<TrackedResource> B = Pool.Add(std::make_unique<TrackedResource>(Destroyed), 2);
+    Pool.Release(A, 5);
+    Pool.Release(B, 6);
+    VOLANTE_CHECK(Context, Destroyed == 0);
+    VOLANTE_CHECK(Context, Pool.GetPendingCount() == 2);
+
+    Pool.Collect(5);
+    VOLANTE_CHECK(Context, Destroyed == 0);
+    Pool.Collect(6);
+    VOLANTE_CHECK(Context, Destroyed == 1);
+    VOLANTE_CHECK(Context, Pool.GetPendingCount() == 1);
+    Pool.Collect(7);
+    VOLANTE_CHECK(Context, Destroyed == 2);
+    VOLANTE_CHECK(Context, Pool.GetPendingCount() == 0);
+}
+
+void TestHashCollision(TestContext& Context) {
+    int Destroyed = 0;
+    TrackedPool Pool;
+    const ResourceHandle<TrackedResource> First = Pool.Add(std::make_unique<TrackedResource>(Destroyed), 9);
+    const ResourceHandle<TrackedResource> Second = Pool.Add(std::make_unique<TrackedResource>(Destroyed), 9);
+    VOLANTE_CHECK(Context, Pool.FindByHash(9) == First);
+
+    // Dropping the one that is not registered leaves the registration alone
+    Pool.Release(Second, 0);
+    VOLANTE_CHECK(Context, Pool.FindByHash(9) == First);
+    Pool.Release(First, 0);
+    VOLANTE_CHECK(Context, !Pool.FindByHash(9).IsValid());
+}
+
+// An unshared resource is never handed out by hash, and its release leaves a shared one with
+// the same hash registered
+void TestUnshared(TestContext& Context) {
+    int Destroyed = 0;
+    TrackedPool Pool;
+    const ResourceHandle<TrackedResource> Shared = Pool.Add(std::make_unique<TrackedResource>(Destroyed), 0);
+    const ResourceHandle<TrackedResource> Unshared = Pool.AddUnshared(std::make_unique<TrackedResource>(Destroyed));
+    VOLANTE_CHECK(Context, Unshared.IsValid() && Unshared != Shared);
+    VOLANTE_CHECK(Context, Pool.FindByHash(0) == Shared);
+    VOLANTE_CHECK(Context, Pool.GetLiveCount() == 2);
+
+    VOLANTE_CHECK(Context, Pool.Release(Unshared, 0));
+    VOLANTE_CHECK(Context, Pool.FindByHash(0) == Shared);
+    Pool.Release(Shared, 0);
+    VOLANTE_CHECK(Context, !Pool.FindByHash(0).IsValid());
+}
+
+void TestClear(TestContext& Context) {
+    int Destroyed = 0;
+    TrackedPool Pool;
+    const ResourceHandle<TrackedResource> Live = Pool.Add(std::make_unique<TrackedResource>(Destroyed), 1);
+    const ResourceHandle<TrackedResource> Parked = Pool.Add(std::make_unique<TrackedResource>(Destroyed), 2);
+    Pool.Release(Parked, 100);
+
+    Pool.Clear();
+    VOLANTE_CHECK(Context, Destroyed == 2);
+    VOLANTE_CHECK(Context, Pool.Get(Live) == nullptr);
+    VOLANTE_CHECK(Context, Pool.GetLiveCount() == 0);
+    VOLANTE_CHECK(Context, Pool.GetPendingCount() == 0);
+    VOLANTE_CHECK(Context, !Pool.FindByHash(1).IsValid());
+
+    const ResourceHandle<TrackedResource> Again = Pool.Add(std::make_unique<TrackedResource>(Destroyed), 1);
+    VOLANTE_CHECK(Context, Again != Live && Again != Parked);
+    VOLANTE_CHECK(Context, Pool.Get(Again) != nullptr);
+}
+
+const bool Registered = [] {
+    TestRegistration("ResourcePool/AddAndGet", TestAddAndGet);
+    TestRegistration("ResourcePool/ReferenceCounting", TestReferenceCounting);
+    TestRegistration("ResourcePool/Generations", TestGenerations);
+    TestRegistration("ResourcePool/DeferredDestruction", TestDeferredDestruction);
+    TestRegistration("ResourcePool/HashCollision", TestHashCollision);
+    TestRegistration("ResourcePool/Unshared", TestUnshared);
+    TestRegistration("ResourcePool/Clear", TestClear);
+    return true;
+}();
+
+} // namespace
+
+} // namespace Volante::Test
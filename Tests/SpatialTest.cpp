@@ -0,0 +1,266 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Runtime/Core/Async/JobSystem.h"
+#include "Runtime/Rendering/DepthConvention.h"
+#include "Runtime/Spatial/LooseOctree.h"
+#include "Runtime/Spatial/SpatialHashGrid.h"
+#include "Runtime/Spatial/SpatialIndex.h"
+#include "Runtime/World/World.h"
+#include "Test.h"
+
+namespace Volante::Test {
+
+namespace {
+
+constexpr float WorldHalfSize = 256.0f;
+constexpr uint32_t ItemCount = 20'000;
+constexpr uint32_t QueryCount = 64;
+
+// What the partition should hold, for brute-force answers
+using Contents = std::vector<std::optional<AABB>>;
+
+AABB MakeBox(std::mt19937& Rng, float HalfSize) {
+    std::uniform_real_distribution<float> Position(-HalfSize, HalfSize);
+    std::uniform_real_distribution<float> Size(0.1f, 3.0f);
+    // An occasional large item, which the octree keeps near the root and the grid in many cells
+    const float Scale = Rng() % 100 == 0 ? 20.0f : 1.0f;
+    return AABB::FromCenterExtent(Vec3(Position(Rng), Position(Rng), Position(Rng)),
+                                  Vec3(Size(Rng), Size(Rng), Size(Rng)) * Scale);
+}
+
+std::vector<SpatialId> Scan(const Contents& Items, const auto& Overlaps) {
+    std::vector<SpatialId> Ids;
+    for (SpatialId Id = 0; Id < Items.size(); ++Id) {
+        if (Items[Id] && Overlaps(*Items[Id])) { Ids.push_back(Id); }
+    }
+    return Ids;
+}
+
+bool SameIds(std::vector<SpatialId> Found, const std::vector<SpatialId>& Expected) {
+    std::sort(Found.begin(), Found.end());
+    return Found == Expected;
+}
+
+// Every query kind against a scan of Items, at random points including outside the bounds
+void CheckQueries(TestContext& Context, const ISpatialPartition& Partition, const Contents& Items, uint32_t Seed) {
+    const uint32_t Live = static_cast<uint32_t>(std::count_if(Items.begin(), Items.end(), [](const auto& Item) { return Item.has_value(); }));
+    VOLANTE_CHECK(Context, Partition.GetCount() == Live);
+
+    std::mt19937 Rng(Seed);
+    std::uniform_real_distribution<float> Position(-WorldHalfSize * 1.2f, WorldHalfSize * 1.2f);
+    std::uniform_real_distribution<float> Radius(1.0f, 40.0f);
+    std::vector<SpatialId> Ids;
+    std::vector<SpatialHit> Hits;
+    uint32_t Wrong[5] = {};
+    for (uint32_t Query = 0; Query < QueryCount; ++Query) {
+        const Vec3 Point(Position(Rng), Position(Rng), Position(Rng));
+        const float Extent = Radius(Rng);
+
+        const AABB Box = AABB::FromCenterExtent(Point, Vec3(Extent, Extent * 0.5f, Extent * 2.0f));
+        Ids.clear();
+        Partition.QueryAABB(Box, Ids);
+        Wrong[0] += !SameIds(Ids, Scan(Items, [&](const AABB& Bounds) { return Bounds.Intersects(Box); }));
+
+        Ids.clear();
+        Partition.QuerySphere(Point, Extent, Ids);
+        Wrong[1] += !SameIds(Ids, Scan(Items, [&](const AABB& Bounds) { return Bounds.IntersectsSphere(Point, Extent); }));
+
+        const Vec3 Target(Position(Rng), Position(Rng), Position(Rng));
+        const Mat4 ViewProjection = MakeReverseZPerspective(glm::radians(30.0f + Extent), 16.0f / 9.0f, 0.1f, 150.0f) *
+                                    glm::lookAt(Point, Target, Vec3(0.0f, 1.0f, 0.0f));
+        const Frustum View = Frustum::FromMatrix(ViewProjection);
+        // The plane test passes some large boxes that miss the frustum near its corners; a
+        // partition may drop those, but nothing that also overlaps the frustum's bounds
+        const AABB ViewBounds = View.GetBounds();
+        Ids.clear();
+        Partition.QueryFrustum(View, Ids);
+        std::sort(Ids.begin(), Ids.end());
+        const std::vector<SpatialId> Loose = Scan(Items, [&](const AABB& Bounds) { return View.Intersects(Bounds); });
+        const std::vector<SpatialId> Tight =
+            Scan(Items, [&](const AABB& Bounds) { return View.Intersects(Bounds) && Bounds.Intersects(ViewBounds); });
+        Wrong[2] += !std::includes(Ids.begin(), Ids.end(), Tight.begin(), Tight.end()) ||
+                    !std::includes(Loose.begin(), Loose.end(), Ids.begin(), Ids.end()) ||
+                    std::adjacent_find(Ids.begin(), Ids.end()) != Ids.end();
+
+        // Nearest hit of the ray; ties between overlapping boxes may pick either, so only the
+        // distance is compared
+        const Ray Cast(Point, normalize(Target - Point));
+        float Nearest = std::numeric_limits<float>::max();
+        for (const std::optional<AABB>& Item : Items) {
+            float T = 0.0f;
+            if (Item && IntersectRayAABB(Cast.Origin, Cast.GetInverseDirection(), *Item, 300.0f, T)) { Nearest = std::min(Nearest, T); }
+        }
+        SpatialHit Hit;
+        const bool Struck = Partition.Raycast(Cast, 300.0f, Hit);
+        if (Struck != (Nearest != std::numeric_limits<float>::max()) ||
+            (Struck && (std::abs(Hit.Distance - Nearest) > 1e-3f || !Items[Hit.Id]))) {
+            ++Wrong[3];
+        }
+
+        std::vector<float> Distances;
+        for (const std::optional<AABB>& Item : Items) {
+            if (Item) { Distances.push_back(std::sqrt(Item->DistanceSquared(Point))); }
+        }
+        std::sort(Distances.begin(), Distances.end());
+        Hits.clear();
+        Partition.QueryNearest(Point, 8, std::numeric_limits<float>::max(), Hits);
+        bool NearestMatches = Hits.size() == std::min<size_t>(8, Distances.size());
+        for (size_t i = 0; NearestMatches && i < Hits.size(); ++i) {
+            NearestMatches = std::abs(Hits[i].Distance - Distances[i]) <= 1e-3f && Items[Hits[i].Id] &&
+                             std::abs(std::sqrt(Items[Hits[i].Id]->DistanceSquared(Point)) - Hits[i].Distance) <= 1e-3f;
+        }
+        Wrong[4] += !NearestMatches;
+    }
+    VOLANTE_CHECK(Context, Wrong[0] == 0);
+    VOLANTE_CHECK(Context, Wrong[1] == 0);
+    VOLANTE_CHECK(Context, Wrong[2] == 0);
+    VOLANTE_CHECK(Context, Wrong[3] == 0);
+    VOLANTE_CHECK(Context, Wrong[4] == 0);
+}
+
+using PartitionFactory = std::unique_ptr<ISpatialPartition> (*)();
+
+std::unique_ptr<ISpatialPartition> MakeOctree() {
+    return std::make_unique<LooseOctree>(AABB(Vec3(-WorldHalfSize), Vec3(WorldHalfSize)), 5);
+}
+
+std::unique_ptr<ISpatialPartition> MakeHashGrid() {
+    return std::make_unique<SpatialHashGrid>(8.0f);
+}
+
+void TestBuild(TestContext& Context, PartitionFactory Factory) {
+    std::mt19937 Rng(11);
+    Contents Items(ItemCount);
+    std::vector<SpatialItem> Built;
+    for (SpatialId Id = 0; Id < ItemCount; ++Id) {
+        Items[Id] = MakeBox(Rng, WorldHalfSize);
+        Built.push_back({Id, *Items[Id]});
+    }
+    JobSystem Jobs(3);
+    auto Partition = Factory();
+    Partition->Build(Built, &Jobs);
+    CheckQueries(Context, *Partition, Items, 1);
+
+    // Building again replaces what was there
+    Built.resize(ItemCount / 2);
+    Items.resize(ItemCount / 2);
+    Partition->Build(Built, nullptr);
+    CheckQueries(Context, *Partition, Items, 2);
+}
+
+// Incremental changes: small moves, moves across the world and out of its bounds, removals and
+// fresh inserts into freed ids
+void TestIncremental(TestContext& Context, PartitionFactory Factory) {
+    std::mt19937 Rng(12);
+    Contents Items(ItemCount);
+    auto Partition = Factory();
+    for (SpatialId Id = 0; Id < ItemCount; ++Id) {
+        Items[Id] = MakeBox(Rng, WorldHalfSize);
+        Partition->Insert(Id, *Items[Id]);
+    }
+    CheckQueries(Context, *Partition, Items, 3);
+
+    std::uniform_real_distribution<float> Nudge(-1.0f, 1.0f);
+    for (int Round = 0; Round < 3; ++Round) {
+        for (SpatialId Id = 0; Id < ItemCount; ++Id) {
+            if (!Items[Id]) { continue; }
+            switch (Rng() % 8) {
+            case 0:
+                Items[Id] = MakeBox(Rng, WorldHalfSize * 1.5f);
+                Partition->Update(Id, *Items[Id]);
+                break;
+            case 1:
+                Items[Id].reset();
+                Partition->Remove(Id);
+                break;
+            default: {
+                const Vec3 Offset(Nudge(Rng), Nudge(Rng), Nudge(Rng));
+                Items[Id] = AABB(Items[Id]->Min + Offset, Items[Id]->Max + Offset);
+                Partition->Update(Id, *Items[Id]);
+                break;
+            }
+            }
+        }
+        for (SpatialId Id = 0; Id < ItemCount; Id += 5) {
+            if (Items[Id]) { continue; }
+            Items[Id] = MakeBox(Rng, WorldHalfSize);
+            Partition->Insert(Id, *Items[Id]);
+        }
+        CheckQueries(Context, *Partition, Items, 4 + Round);
+    }
+
+    Partition->Clear();
+    CheckQueries(Context, *Partition, Contents(ItemCount), 10);
+}
+
+// Gameplay queries through World: entities in a row along x, two units apart
+void TestWorldProximity(TestContext& Context) {
+    World Target;
+    SpatialIndex Index;
+    Target.SetSpatialIndex(&Index);
+    std::vector<Entity> Row;
+    for (int i = 0; i < 100; ++i) {
+        Row.push_back(Target.CreateEntity());
+        Target.SetBounds(Row.back(), AABB::FromCenterExtent(Vec3(static_cast<float>(i) * 2.0f, 0.0f, 0.0f), Vec3(0.5f)));
+    }
+    Index.Flush();
+
+    std::vector<Entity> Found;
+    Target.QuerySphere(Vec3(10.0f, 0.0f, 0.0f), 1.0f, Found);
+    VOLANTE_CHECK(Context, Found.size() == 1 && Found[0] == Row[5]);
+    Found.clear();
+    Target.QueryBox(AABB(Vec3(3.0f, -1.0f, -1.0f), Vec3(9.0f, 1.0f, 1.0f)), Found);
+    VOLANTE_CHECK(Context, Found.size() == 3);
+    Found.clear();
+    Target.QueryNearest(Vec3(10.2f, 0.0f, 0.0f), 3, std::numeric_limits<float>::max(), Found);
+    VOLANTE_CHECK(Context, Found.size() == 3 && Found[0] == Row[5]);
+    float Distance = 0.0f;
+    VOLANTE_CHECK(Context, Target.Raycast(Ray(Vec3(-5.0f, 0.0f, 0.0f), Vec3(1.0f, 0.0f, 0.0f)), 100.0f, &Distance) == Row[0]);
+    VOLANTE_CHECK(Context, std::abs(Distance - 4.5f) < 1e-4f);
+
+    // Destroyed entities leave the index; their reused index is not found until given bounds
+    Target.DestroyEntity(Row[5]);
+    const Entity Reused = Target.CreateEntity();
+    Target.SetBounds(Row[6], AABB::FromCenterExtent(Vec3(10.0f, 0.0f, 0.0f), Vec3(0.5f)));
+    Index.Flush();
+    Found.clear();
+    Target.QuerySphere(Vec3(10.0f, 0.0f, 0.0f), 1.0f, Found);
+    VOLANTE_CHECK(Context, Reused.Index == Row[5].Index && Found.size() == 1 && Found[0] == Row[6]);
+
+    // Moving to another index carries the bounds over
+    SpatialIndex Other;
+    Target.SetSpatialIndex(&Other);
+    Other.Flush();
+    VOLANTE_CHECK(Context, Index.GetProxyCount() == 0 && Other.GetProxyCount() == 99);
+    Target.ClearBounds(Row[6]);
+    Found.clear();
+    Target.QuerySphere(Vec3(10.0f, 0.0f, 0.0f), 1.0f, Found);
+    VOLANTE_CHECK(Context, Found.empty());
+
+    Target.Clear();
+    VOLANTE_CHECK(Context, Other.GetProxyCount() == 0);
+}
+
+void RegisterPartitionTests(const char* Prefix, PartitionFactory Factory) {
+    const std::string Name = std::string("Spatial/") + Prefix;
+    TestRegistration(std::string(Name + "/Build").c_str(), [Factory](TestContext& Context) { TestBuild(Context, Factory); });
+    TestRegistration(std::string(Name + "/Incremental").c_str(), [Factory](TestContext& Context) { TestIncremental(Context, Factory); });
+}
+
+const bool Registered = [] {
+    RegisterPartitionTests("LooseOctree", MakeOctree);
+    RegisterPartitionTests("HashGrid", MakeHashGrid);
+    TestRegistration("Spatial/WorldProximity", TestWorldProximity);
+    return true;
+}();
+
+} // namespace
+
+} // namespace Volante::Test
@@ -0,0 +1,81 @@
+#include "Test.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <string_view>
+
+namespace Volante::Test {
+
+namespace {
+
+struct RegisteredTest {
+    std::string Name;
+    TestFunction Function;
+};
+
+std::vector<RegisteredTest>& GetRegistry() {
+    static std::vector<RegisteredTest> Registry;
+    return Registry;
+}
+
+} // namespace
+
+bool TestContext::Check(bool Condition, const char* Expression, const char* File, int Line) {
+    if (!Condition) {
+        const std::string_view Path(File);
+        const size_t Slash = Path.find_last_of("/\\");
+        Failures.push_back(std::string(Slash == std::string_view::npos ? Path : Path.substr(Slash + 1)) + ":" +
+                           std::to_string(Line) + ": " + Expression);
+    }
+    return Condition;
+}
+
+TestRegistration::TestRegistration(const char* Name, TestFunction Function) {
+    GetRegistry().push_back({Name, std::move(Function)});
+}
+
+} // namespace Volante::Test
+
+// Usage: VolanteTests [--filter=<substring>]
+int main(int argc, char** argv) {
+    using namespace Volante::Test;
+
+    std::string Filter;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view Arg = argv[i];
+        if (Arg.starts_with("--filter=")) {
+            Filter = Arg.substr(9);
+        } else {
+            std::cerr << "Unknown argument: " << Arg << std::endl;
+            return -1;
+        }
+    }
+
+    uint32_t RunCount = 0;
+    uint32_t FailedCount = 0;
+    for (const auto& Test : GetRegistry()) {
+        if (!Filter.empty() && Test.Name.find(Filter) == std::string::npos) { continue; }
+
+        TestContext Context(Test.Name);
+        Test.Function(Context);
+        ++RunCount;
+        if (!Context.HasFailed()) {
+            std::printf("%-48s passed\n", Test.Name.c_str());
+            continue;
+        }
+        ++FailedCount;
+        std::printf("%-48s FAILED\n", Test.Name.c_str());
+        for (const std::string& Failure : Context.GetFailures()) {
+            std::printf("    %s\n", Failure.c_str());
+        }
+    }
+    std::fflush(stdout);
+
+    if (RunCount == 0) {
+        std::cerr << "No tests match " << Filter << std::endl;
+        return 1;
+    }
+    std::printf("%u of %u tests passed\n", RunCount - FailedCount, RunCount);
+    return FailedCount > 0 ? 1 : 0;
+}
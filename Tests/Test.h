@@ -0,0 +1,38 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Volante::Test {
+
+// Handed to every test. A failed check is recorded and the test carries on, so one run
+// reports every broken expectation rather than the first.
+class TestContext {
+public:
+    explicit TestContext(std::string Name) : Name(std::move(Name)) {}
+
+    // Returns Condition, so a test can stop early when the rest depends on it.
+    bool Check(bool Condition, const char* Expression, const char* File, int Line);
+
+    [[nodiscard]] bool HasFailed() const { return !Failures.empty(); }
+
+    [[nodiscard]] const std::string& GetName() const { return Name; }
+
+    [[nodiscard]] const std::vector<std::string>& GetFailures() const { return Failures; }
+
+private:
+    std::string Name;
+    std::vector<std::string> Failures;
+};
+
+using TestFunction = std::function<void(TestContext&)>;
+
+struct TestRegistration {
+    TestRegistration(const char* Name, TestFunction Function);
+};
+
+} // namespace Volante::Test
+
+#define VOLANTE_CHECK(Context, Expression) (Context).Check(static_cast<bool>(Expression), #Expression, __FILE__, __LINE__)
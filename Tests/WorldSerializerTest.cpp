@@ -0,0 +1,270 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+#include "Runtime/World/World.h"
+#include "Runtime/World/WorldSerializer.h"
+#include "Test.h"
+#include "Volante.h"
+
+namespace Volante::Test {
+
+namespace {
+
+struct Transform {
+    Vec3 Position;
+    float Scale;
+};
+
+struct Velocity {
+    Vec3 Linear;
+};
+
+// Tag identifies an entity across worlds, whatever handle it ends up with
+struct Link {
+    Entity Target;
+    uint32_t Tag;
+};
+
+struct HealthV1 {
+    float Current;
+};
+
+struct HealthV2 {
+    float Current;
+    float Maximum;
+};
+
+constexpr uint32_t EntityCount = 5'000;
+
+void RegisterComponents(World& Target) {
+    Target.RegisterComponent<Transform>("Transform");
+    Target.RegisterComponent<Velocity>("Velocity");
+    Target.RegisterComponent<Link>("Link", 1, {static_cast<uint32_t>(offsetof(Link, Target))});
+    Target.RegisterComponent<HealthV1>("Health");
+}
+
+// Several archetypes, links between entities, and holes in the index space so the free list
+// is not empty. Every entity has a Link, whose Tag is its creation order.
+std::vector<Entity> Populate(World& Target) {
+    std::vector<Entity> Entities;
+    for (uint32_t i = 0; i < EntityCount; ++i) {
+        const Transform Placed{Vec3(float(i), float(i % 17), -float(i)), 1.0f + float(i % 3)};
+        const Link Linked{InvalidEntity, i};
+        switch (i % 3) {
+        case 0:
+            Entities.push_back(Target.CreateEntity(Placed, Linked));
+            break;
+        case 1:
+            Entities.push_back(Target.CreateEntity(Placed, Velocity{Vec3(0.5f * float(i))}, Linked));
+            break;
+        default:
+            Entities.push_back(Target.CreateEntity(Linked, HealthV1{float(i)}));
+            break;
+        }
+    }
+    // Each links to an entity created 7 earlier, some of which are destroyed below
+    for (uint32_t i = 7; i < EntityCount; ++i) { Target.GetComponent<Link>(Entities[i])->Target = Entities[i - 7]; }
+    for (uint32_t i = 0; i < EntityCount; i += 11) { Target.DestroyEntity(Entities[i]); }
+    return Entities;
+}
+
+bool SameComponents(World& A, Entity InA, World& B, Entity InB) {
+    const auto Same = [&]<typename T>(T*) {
+        const T* Left = A.GetComponent<T>(InA);
+        const T* Right = B.GetComponent<T>(InB);
+        if (!Left || !Right) { return Left == Right; }
+        return std::memcmp(Left, Right, sizeof(T)) == 0;
+    };
+    return Same((Transform*)nullptr) && Same((Velocity*)nullptr) && Same((HealthV1*)nullptr);
+}
+
+void TestReplaceRoundTrip(TestContext& Context) {
+    World Source;
+    RegisterComponents(Source);
+    const std::vector<Entity> Entities = Populate(Source);
+    std::vector<uint8_t> Snapshot;
+    WorldSerializer::Save(Source, Snapshot);
+
+    World Loaded;
+    RegisterComponents(Loaded);
+    if (!VOLANTE_CHECK(Context, WorldSerializer::Load(Loaded, Snapshot.data(), Snapshot.size()))) { return; }
+    VOLANTE_CHECK(Context, Loaded.GetEntityCount() == Source.GetEntityCount());
+
+    // Handles survive as they are, dead ones included
+    uint32_t Mismatches = 0;
+    for (const Entity Handle : Entities) {
+        if (Loaded.IsAlive(Handle) != Source.IsAlive(Handle)) { ++Mismatches; }
+        if (!Source.IsAlive(Handle)) { continue; }
+        if (!SameComponents(Source, Handle, Loaded, Handle)) { ++Mismatches; }
+        const Link* Linked = Loaded.GetComponent<Link>(Handle);
+        if (!Linked || Linked->Target != Source.GetComponent<Link>(Handle)->Target) { ++Mismatches; }
+    }
+    VOLANTE_CHECK(Context, Mismatches == 0);
+
+    // The free list came along, so both worlds hand out the same handles next
+    for (int i = 0; i < 20; ++i) {
+        const Entity Expected = Source.CreateEntity(Velocity{});
+        VOLANTE_CHECK(Context, Loaded.CreateEntity(Velocity{}) == Expected);
+    }
+}
+
+void TestDeterministicBytes(TestContext& Context) {
+    World Source;
+    RegisterComponents(Source);
+    Populate(Source);
+    std::vector<uint8_t> First;
+    std::vector<uint8_t> Second;
+    WorldSerializer::Save(Source, First);
+    WorldSerializer::Save(Source, Second);
+    VOLANTE_CHECK(Context, First == Second);
+
+    World Loaded;
+    RegisterComponents(Loaded);
+    if (!VOLANTE_CHECK(Context, WorldSerializer::Load(Loaded, First.data(), First.size()))) { return; }
+    std::vector<uint8_t> Resaved;
+    WorldSerializer::Save(Loaded, Resaved);
+    VOLANTE_CHECK(Context, Resaved == First);
+}
+
+void TestCompressedRoundTrip(TestContext& Context) {
+    World Source;
+    RegisterComponents(Source);
+    Populate(Source);
+    std::vector<uint8_t> Raw;
+    std::vector<uint8_t> Compressed;
+    WorldSerializer::Save(Source, Raw);
+    WorldSaveOptions Options;
+    Options.Compress = true;
+    JobSystem Jobs(2);
+    WorldSerializer::Save(Source, Compressed, Options, &Jobs);
+    VOLANTE_CHECK(Context, Compressed.size() < Raw.size());
+
+    World Loaded;
+    RegisterComponents(Loaded);
+    if (!VOLANTE_CHECK(Context, WorldSerializer::Load(Loaded, Compressed.data(), Compressed.size(), WorldLoadMode::Replace, &Jobs))) {
+        return;
+    }
+    std::vector<uint8_t> Resaved;
+    WorldSerializer::Save(Loaded, Resaved);
+    VOLANTE_CHECK(Context, Resaved == Raw);
+}
+
+// Appended entities get new handles; links between them follow, links out of the snapshot
+// are cut, and what was in the world before is untouched
+void TestAppendRemap(TestContext& Context) {
+    World Source;
+    RegisterComponents(Source);
+    const std::vector<Entity> Entities = Populate(Source);
+    std::vector<uint8_t> Snapshot;
+    WorldSerializer::Save(Source, Snapshot);
+
+    World Target;
+    RegisterComponents(Target);
+    std::vector<Entity> Existing;
+    for (uint32_t i = 0; i < 100; ++i) { Existing.push_back(Target.CreateEntity(Link{InvalidEntity, 1'000'000 + i})); }
+    if (!VOLANTE_CHECK(Context, WorldSerializer::Load(Target, Snapshot.data(), Snapshot.size(), WorldLoadMode::Append))) {
+        return;
+    }
+    VOLANTE_CHECK(Context, Target.GetEntityCount() == Existing.size() + Source.GetEntityCount());
+
+    std::unordered_map<uint32_t, Entity> ByTag;
+    Target.ForEach<Link>([&](Entity Handle, Link& Linked) { ByTag.emplace(Linked.Tag, Handle); });
+    for (uint32_t i = 0; i < Existing.size(); ++i) { VOLANTE_CHECK(Context, ByTag[1'000'000 + i] == Existing[i]); }
+
+    uint32_t Mismatches = 0;
+    for (uint32_t i = 0; i < EntityCount; ++i) {
+        const auto Found = ByTag.find(i);
+        if (!Source.IsAlive(Entities[i])) {
+            Mismatches += Found != ByTag.end();
+            continue;
+        }
+        if (Found == ByTag.end() || !SameComponents(Source, Entities[i], Target, Found->second)) {
+            ++Mismatches;
+            continue;
+        }
+        const Entity Linked = Target.GetComponent<Link>(Found->second)->Target;
+        if (i < 7 || !Source.IsAlive(Entities[i - 7])) {
+            Mismatches += Linked != InvalidEntity;
+        } else {
+            const Link* Other = Target.GetComponent<Link>(Linked);
+            Mismatches += !Other || Other->Tag != i - 7;
+        }
+    }
+    VOLANTE_CHECK(Context, Mismatches == 0);
+}
+
+void TestMigration(TestContext& Context) {
+    World Source;
+    RegisterComponents(Source);
+    Populate(Source);
+    std::vector<uint8_t> Snapshot;
+    WorldSerializer::Save(Source, Snapshot);
+
+    World Upgraded;
+    Upgraded.RegisterComponent<Transform>("Transform");
+    Upgraded.RegisterComponent<Velocity>("Velocity");
+    Upgraded.RegisterComponent<Link>("Link", 1, {static_cast<uint32_t>(offsetof(Link, Target))});
+    Upgraded.RegisterComponent<HealthV2>("Health", 2, {}, [](uint32_t FromVersion, const void* Old, uint32_t OldSize, void* New) {
+        if (FromVersion != 1 || OldSize != sizeof(HealthV1)) { return false; }
+        HealthV2& Result = *static_cast<HealthV2*>(New);
+        Result.Current = static_cast<const HealthV1*>(Old)->Current;
+        Result.Maximum = 100.0f;
+        return true;
+    });
+    if (!VOLANTE_CHECK(Context, WorldSerializer::Load(Upgraded, Snapshot.data(), Snapshot.size()))) { return; }
+
+    uint32_t Migrated = 0;
+    uint32_t Wrong = 0;
+    Upgraded.ForEach<Link, HealthV2>([&](Entity, Link& Linked, HealthV2& Health) {
+        ++Migrated;
+        Wrong += Health.Current != float(Linked.Tag) || Health.Maximum != 100.0f;
+    });
+    VOLANTE_CHECK(Context, Migrated > 0 && Wrong == 0);
+
+    // Without a migration the snapshot is refused
+    World Unmigratable;
+    Unmigratable.RegisterComponent<Transform>("Transform");
+    Unmigratable.RegisterComponent<Velocity>("Velocity");
+    Unmigratable.RegisterComponent<Link>("Link", 1, {static_cast<uint32_t>(offsetof(Link, Target))});
+    Unmigratable.RegisterComponent<HealthV2>("Health", 2);
+    VOLANTE_CHECK(Context, !WorldSerializer::Load(Unmigratable, Snapshot.data(), Snapshot.size()));
+}
+
+void TestRejectsDamage(TestContext& Context) {
+    World Source;
+    RegisterComponents(Source);
+    Populate(Source);
+    std::vector<uint8_t> Snapshot;
+    WorldSerializer::Save(Source, Snapshot);
+
+    World Target;
+    RegisterComponents(Target);
+    VOLANTE_CHECK(Context, !WorldSerializer::Load(Target, Snapshot.data(), Snapshot.size() / 2));
+    VOLANTE_CHECK(Context, !WorldSerializer::Load(Target, Snapshot.data(), 16));
+
+    std::vector<uint8_t> BadMagic = Snapshot;
+    BadMagic[0] ^= 0xFF;
+    VOLANTE_CHECK(Context, !WorldSerializer::Load(Target, BadMagic.data(), BadMagic.size()));
+
+    // A failed Append leaves the world as it was
+    const Entity Kept = Target.CreateEntity(Velocity{Vec3(1.0f)});
+    VOLANTE_CHECK(Context, !WorldSerializer::Load(Target, Snapshot.data(), Snapshot.size() - 1, WorldLoadMode::Append));
+    VOLANTE_CHECK(Context, Target.GetEntityCount() == 1 && Target.IsAlive(Kept));
+}
+
+const bool Registered = [] {
+    TestRegistration("WorldSerializer/ReplaceRoundTrip", TestReplaceRoundTrip);
+    TestRegistration("WorldSerializer/DeterministicBytes", TestDeterministicBytes);
+    TestRegistration("WorldSerializer/CompressedRoundTrip", TestCompressedRoundTrip);
+    TestRegistration("WorldSerializer/AppendRemap", TestAppendRemap);
+    TestRegistration("WorldSerializer/Migration", TestMigration);
+    TestRegistration("WorldSerializer/RejectsDamage", TestRejectsDamage);
+    return true;
+}();
+
+} // namespace
+
+} // namespace Volante::Test
@@ -9,6 +9,8 @@ namespace Volante {
 using Vec2 = glm::vec2;
 using Vec3 = glm::vec3;
 using Vec4 = glm::vec4;
+// World positions that must stay exact far from the origin, e.g. cameras in large worlds
+using DVec3 = glm::dvec3;
 using Mat2 = glm::mat2;
 using Mat3 = glm::mat3;
 using Mat4 = glm::mat4;